@@ -1,25 +1,11 @@
 #include "elizaos/agentaction.hpp"
 #include <algorithm>
 #include <sstream>
-#include <random>
 
 namespace elizaos {
 
-// Simple UUID generator
 std::string generateSimpleUUID() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    
-    std::string uuid = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
-    for (auto& c : uuid) {
-        if (c == 'x') {
-            c = "0123456789abcdef"[dis(gen)];
-        } else if (c == 'y') {
-            c = "89ab"[dis(gen) % 4];
-        }
-    }
-    return uuid;
+    return Uuid::v4().toString();
 }
 
 AgentAction::AgentAction() {
@@ -46,7 +32,7 @@ void AgentAction::addAction(const std::string& name, const ManagedAction& action
     
     MemoryMetadata metadata = customMeta;
     
-    auto memory = std::make_shared<Memory>(memoryId, content, entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, content, entityId, agentId, metadata);
     
     memory_->createMemory(memory, "actions");
 }
@@ -150,14 +136,16 @@ void AgentAction::addToActionHistory(const std::string& action_name, const JsonV
     CustomMetadata customMeta;
     customMeta.customData["success"] = success ? "true" : "false";
     
-    // Convert JsonValue arguments to string metadata (simplified)
-    for (const auto& arg : arguments) {
-        customMeta.customData[arg.first] = "value"; // Simplified serialization
+    // Record each argument as its compact JSON text
+    if (arguments.isObject()) {
+        for (const auto& arg : arguments.asObject()) {
+            customMeta.customData[std::string(arg.key)] = json::write(arg.value);
+        }
     }
     
     MemoryMetadata metadata = customMeta;
     
-    auto memory = std::make_shared<Memory>(memoryId, action_name, entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, action_name, entityId, agentId, metadata);
     
     memory_->createMemory(memory, "action_history");
 }
@@ -224,12 +212,7 @@ JsonValue AgentAction::getFormattedActions(const std::string& search_text) {
     formatted_actions << "Available actions for me to choose from:\n";
     
     for (const auto& action : available_actions) {
-        std::string document;
-        if (action.count("document")) {
-            try {
-                document = std::any_cast<std::string>(action.at("document"));
-            } catch (const std::bad_any_cast&) {}
-        }
+        std::string document = action.getString("document");
         
         formatted_actions << document << "\n";
     }
@@ -242,13 +225,8 @@ JsonValue AgentAction::getFormattedActions(const std::string& search_text) {
         if (i > 0) short_actions << ", ";
         
         std::string name;
-        if (available_actions[i].count("metadata")) {
-            try {
-                auto metadata = std::any_cast<JsonValue>(available_actions[i].at("metadata"));
-                if (metadata.count("name")) {
-                    name = std::any_cast<std::string>(metadata.at("name"));
-                }
-            } catch (const std::bad_any_cast&) {}
+        if (const JsonValue* metadata = available_actions[i].find("metadata")) {
+            name = metadata->getString("name");
         }
         
         short_actions << name;
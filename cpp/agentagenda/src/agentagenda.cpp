@@ -1,27 +1,13 @@
 #include "elizaos/agentagenda.hpp"
 #include <sstream>
-#include <random>
 #include <algorithm>
 #include <iomanip>
 #include <variant>
 
 namespace elizaos {
 
-// Simple UUID generator
 std::string AgentAgenda::generateSimpleUUID() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    
-    std::string uuid = "xxxxxxxx-xxxx-4xxx-yxxx-xxxxxxxxxxxx";
-    for (auto& c : uuid) {
-        if (c == 'x') {
-            c = "0123456789abcdef"[dis(gen)];
-        } else if (c == 'y') {
-            c = "89ab"[dis(gen) % 4];
-        }
-    }
-    return uuid;
+    return Uuid::v4().toString();
 }
 
 AgentAgenda::AgentAgenda() {
@@ -61,44 +47,35 @@ std::chrono::system_clock::time_point AgentAgenda::stringToTimestamp(const std::
 }
 
 std::string AgentAgenda::serializeSteps(const std::vector<AgendaTaskStep>& steps) {
-    std::stringstream json;
-    json << "[";
-    for (size_t i = 0; i < steps.size(); ++i) {
-        if (i > 0) json << ",";
-        json << "{\"content\":\"" << steps[i].content << "\",\"completed\":" 
-             << (steps[i].completed ? "true" : "false") << "}";
-    }
-    json << "]";
-    return json.str();
+    std::string out;
+    json::Writer writer(out);
+    writer.startArray();
+    for (const auto& step : steps) {
+        writer.startObject();
+        writer.key("content");
+        writer.string(step.content);
+        writer.key("completed");
+        writer.boolean(step.completed);
+        writer.endObject();
+    }
+    writer.endArray();
+    return out;
 }
 
 std::vector<AgendaTaskStep> AgentAgenda::deserializeSteps(const std::string& steps_json) {
-    // Simple JSON parsing - in a real implementation, use a proper JSON library
     std::vector<AgendaTaskStep> steps;
-    
-    // Very basic parsing for our simple JSON format
-    size_t pos = 0;
-    while ((pos = steps_json.find("\"content\":\"", pos)) != std::string::npos) {
-        pos += 11; // length of "content":"
-        size_t end_pos = steps_json.find("\"", pos);
-        if (end_pos != std::string::npos) {
-            std::string content = steps_json.substr(pos, end_pos - pos);
-            
-            // Find completed status
-            size_t comp_pos = steps_json.find("\"completed\":", end_pos);
-            bool completed = false;
-            if (comp_pos != std::string::npos) {
-                comp_pos += 12; // length of "completed":
-                completed = (steps_json.substr(comp_pos, 4) == "true");
-            }
-            
-            steps.emplace_back(content, completed);
-            pos = end_pos;
-        } else {
-            break;
+
+    auto parsed = json::parse(steps_json);
+    if (!parsed || !parsed->isArray()) {
+        return steps;
+    }
+
+    for (const auto& step : parsed->asArray()) {
+        if (step.isObject()) {
+            steps.emplace_back(step.getString("content"), step.getBool("completed"));
         }
     }
-    
+
     return steps;
 }
 
@@ -122,7 +99,7 @@ void AgentAgenda::saveTaskToMemory(const AgendaTask& task) {
     
     MemoryMetadata metadata = customMeta;
     
-    auto memory = std::make_shared<Memory>(memoryId, content, entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, content, entityId, agentId, metadata);
     memory_->createMemory(memory, "task");
 }
 
@@ -0,0 +1,1264 @@
+#include "elizaos/html.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+
+namespace elizaos {
+
+namespace {
+
+constexpr size_t MIN_ARENA_CHUNK = 16 * 1024;
+constexpr size_t MAX_ARENA_CHUNK = 1024 * 1024;
+
+const std::vector<const HtmlNode*> NO_NODES;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+char toLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+bool isOneOf(std::string_view name, std::initializer_list<std::string_view> names) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (toLower(a[i]) != toLower(b[i])) return false;
+    }
+    return true;
+}
+
+bool isVoidElement(std::string_view name) {
+    return isOneOf(name, {"area", "base", "br", "col", "embed", "hr", "img", "input", "link", "meta", "param",
+                          "source", "track", "wbr"});
+}
+
+// Contents are text up to the matching end tag; only the escapable ones
+// decode character references
+bool isRawTextElement(std::string_view name) {
+    return isOneOf(name, {"script", "style", "xmp", "iframe", "noembed", "noframes"});
+}
+
+bool isEscapableRawTextElement(std::string_view name) {
+    return name == "title" || name == "textarea";
+}
+
+bool closesParagraph(std::string_view name) {
+    return isOneOf(name, {"address", "article", "aside", "blockquote", "details", "dialog", "div", "dl", "dd", "dt",
+                          "fieldset", "figcaption", "figure", "footer", "form", "h1", "h2", "h3", "h4", "h5", "h6",
+                          "header", "hgroup", "hr", "li", "main", "menu", "nav", "ol", "p", "pre", "section",
+                          "table", "ul"});
+}
+
+bool isBlockElement(std::string_view name) {
+    return closesParagraph(name) || isOneOf(name, {"body", "br", "caption", "tr", "option", "title"});
+}
+
+bool isSkippedForText(std::string_view name) {
+    return isOneOf(name, {"head", "script", "style", "noscript", "template"});
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint == 0 || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) codepoint = 0xFFFD;
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+struct NamedEntity {
+    std::string_view name;
+    uint32_t codepoint;
+};
+
+// Sorted by name for binary search
+constexpr NamedEntity NAMED_ENTITIES[] = {
+    {"AElig", 0xC6}, {"Aacute", 0xC1}, {"Eacute", 0xC9}, {"Ntilde", 0xD1}, {"Ouml", 0xD6}, {"Uuml", 0xDC},
+    {"aacute", 0xE1}, {"acute", 0xB4}, {"aelig", 0xE6}, {"agrave", 0xE0}, {"amp", 0x26}, {"apos", 0x27},
+    {"auml", 0xE4}, {"bull", 0x2022}, {"ccedil", 0xE7}, {"cent", 0xA2}, {"copy", 0xA9}, {"deg", 0xB0},
+    {"divide", 0xF7}, {"eacute", 0xE9}, {"egrave", 0xE8}, {"euro", 0x20AC}, {"frac12", 0xBD}, {"gt", 0x3E},
+    {"hellip", 0x2026}, {"iacute", 0xED}, {"iexcl", 0xA1}, {"iquest", 0xBF}, {"laquo", 0xAB}, {"ldquo", 0x201C},
+    {"lsquo", 0x2018}, {"lt", 0x3C}, {"mdash", 0x2014}, {"middot", 0xB7}, {"nbsp", 0xA0}, {"ndash", 0x2013},
+    {"ntilde", 0xF1}, {"oacute", 0xF3}, {"ouml", 0xF6}, {"para", 0xB6}, {"plusmn", 0xB1}, {"pound", 0xA3},
+    {"quot", 0x22}, {"raquo", 0xBB}, {"rdquo", 0x201D}, {"reg", 0xAE}, {"rsquo", 0x2019}, {"sect", 0xA7},
+    {"szlig", 0xDF}, {"times", 0xD7}, {"trade", 0x2122}, {"uacute", 0xFA}, {"uuml", 0xFC}, {"yen", 0xA5}};
+
+std::optional<uint32_t> lookupEntity(std::string_view name) {
+    auto it = std::lower_bound(std::begin(NAMED_ENTITIES), std::end(NAMED_ENTITIES), name,
+                               [](const NamedEntity& entity, std::string_view key) { return entity.name < key; });
+    if (it == std::end(NAMED_ENTITIES) || it->name != name) return std::nullopt;
+    return it->codepoint;
+}
+
+// Walks the subtree under root without recursion; enter returns whether to
+// descend into the node's children
+template <typename Enter, typename Leave>
+void walk(const HtmlNode& root, Enter&& enter, Leave&& leave) {
+    const HtmlNode* node = &root;
+    bool entering = true;
+    while (node) {
+        if (entering && enter(*node) && node->firstChild) {
+            node = node->firstChild;
+            continue;
+        }
+        leave(*node);
+        if (node == &root) break;
+        if (node->nextSibling) {
+            node = node->nextSibling;
+            entering = true;
+        } else {
+            node = node->parent;
+            entering = false;
+        }
+    }
+}
+
+void appendEscaped(std::string& out, std::string_view text, bool attribute) {
+    for (char c : text) {
+        switch (c) {
+            case '&': out += "&amp;"; break;
+            case '<': out += attribute ? "<" : "&lt;"; break;
+            case '>': out += attribute ? ">" : "&gt;"; break;
+            case '"': out += attribute ? "&quot;" : "\""; break;
+            default: out += c;
+        }
+    }
+}
+
+void serialize(std::string& out, const HtmlNode& root, bool includeRoot) {
+    walk(root,
+         [&](const HtmlNode& node) {
+             if (&node == &root && !includeRoot) return true;
+             switch (node.type) {
+                 case HtmlNodeType::TEXT: {
+                     bool raw = node.parent && isRawTextElement(node.parent->name);
+                     if (raw) {
+                         out += node.text;
+                     } else {
+                         appendEscaped(out, node.text, false);
+                     }
+                     return false;
+                 }
+                 case HtmlNodeType::COMMENT:
+                     out += "<!--";
+                     out += node.text;
+                     out += "-->";
+                     return false;
+                 case HtmlNodeType::ELEMENT:
+                     out += '<';
+                     out += node.name;
+                     for (uint32_t i = 0; i < node.attributeCount; ++i) {
+                         out += ' ';
+                         out += node.attributes[i].name;
+                         out += "=\"";
+                         appendEscaped(out, node.attributes[i].value, true);
+                         out += '"';
+                     }
+                     out += '>';
+                     return true;
+                 case HtmlNodeType::DOCUMENT:
+                     return true;
+             }
+             return true;
+         },
+         [&](const HtmlNode& node) {
+             if (&node == &root && !includeRoot) return;
+             if (node.isElement() && !isVoidElement(node.name)) {
+                 out += "</";
+                 out += node.name;
+                 out += '>';
+             }
+         });
+}
+
+std::string ownText(const HtmlNode& element) {
+    std::string text;
+    for (const HtmlNode* child = element.firstChild; child; child = child->nextSibling) {
+        if (child->type == HtmlNodeType::TEXT) text += child->text;
+    }
+    return text;
+}
+
+bool containsWord(std::string_view list, std::string_view word) {
+    size_t i = 0;
+    while (i < list.size()) {
+        while (i < list.size() && isSpace(list[i])) ++i;
+        size_t start = i;
+        while (i < list.size() && !isSpace(list[i])) ++i;
+        if (i > start && list.substr(start, i - start) == word) return true;
+    }
+    return false;
+}
+
+bool matchesNth(int a, int b, int position) {
+    if (a == 0) return position == b;
+    int offset = position - b;
+    return offset % a == 0 && offset / a >= 0;
+}
+
+// 1-based position among element siblings, optionally of the same name, from the front or back
+int siblingPosition(const HtmlNode& element, bool sameName, bool fromEnd) {
+    int position = 1;
+    for (const HtmlNode* sibling = fromEnd ? element.nextSibling : element.previousSibling; sibling;
+         sibling = fromEnd ? sibling->nextSibling : sibling->previousSibling) {
+        if (sibling->isElement() && (!sameName || sibling->name == element.name)) ++position;
+    }
+    return position;
+}
+
+} // anonymous namespace
+
+std::string decodeHtmlEntities(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    size_t i = 0;
+    while (i < text.size()) {
+        size_t amp = text.find('&', i);
+        if (amp == std::string_view::npos) {
+            out.append(text.substr(i));
+            break;
+        }
+        out.append(text.substr(i, amp - i));
+        i = amp + 1;
+
+        size_t semicolon = text.find(';', i);
+        if (semicolon == std::string_view::npos || semicolon - i > 32 || semicolon == i) {
+            out += '&';
+            continue;
+        }
+        std::string_view reference = text.substr(i, semicolon - i);
+        std::optional<uint32_t> codepoint;
+        if (reference[0] == '#' && reference.size() > 1) {
+            bool hex = reference[1] == 'x' || reference[1] == 'X';
+            std::string_view digits = reference.substr(hex ? 2 : 1);
+            uint32_t value = 0;
+            bool valid = !digits.empty();
+            for (char c : digits) {
+                int digit = std::isdigit(static_cast<unsigned char>(c)) ? c - '0'
+                            : hex && std::isxdigit(static_cast<unsigned char>(c)) ? toLower(c) - 'a' + 10
+                                                                                   : -1;
+                if (digit < 0) {
+                    valid = false;
+                    break;
+                }
+                value = std::min<uint32_t>(value * (hex ? 16 : 10) + static_cast<uint32_t>(digit), 0x110000);
+            }
+            if (valid) codepoint = value;
+        } else {
+            codepoint = lookupEntity(reference);
+        }
+
+        if (codepoint) {
+            appendUtf8(out, *codepoint);
+            i = semicolon + 1;
+        } else {
+            out += '&';
+        }
+    }
+    return out;
+}
+
+// HtmlNode implementation
+const HtmlAttribute* HtmlNode::findAttribute(std::string_view attributeName) const {
+    for (uint32_t i = 0; i < attributeCount; ++i) {
+        if (attributes[i].name == attributeName) return &attributes[i];
+    }
+    return nullptr;
+}
+
+std::string_view HtmlNode::getAttribute(std::string_view attributeName) const {
+    const HtmlAttribute* attribute = findAttribute(attributeName);
+    return attribute ? attribute->value : std::string_view();
+}
+
+bool HtmlNode::hasClass(std::string_view className) const {
+    const HtmlAttribute* attribute = findAttribute("class");
+    return attribute && containsWord(attribute->value, className);
+}
+
+const HtmlNode* HtmlNode::firstElementChild() const {
+    const HtmlNode* child = firstChild;
+    while (child && !child->isElement()) child = child->nextSibling;
+    return child;
+}
+
+const HtmlNode* HtmlNode::nextElementSibling() const {
+    const HtmlNode* sibling = nextSibling;
+    while (sibling && !sibling->isElement()) sibling = sibling->nextSibling;
+    return sibling;
+}
+
+const HtmlNode* HtmlNode::previousElementSibling() const {
+    const HtmlNode* sibling = previousSibling;
+    while (sibling && !sibling->isElement()) sibling = sibling->previousSibling;
+    return sibling;
+}
+
+// Tree construction; receives tokens from the tokenizer as they are read
+class HtmlTreeBuilder {
+public:
+    explicit HtmlTreeBuilder(HtmlDocument& document) : document_(document) {
+        document_.root_ = newNode(HtmlNodeType::DOCUMENT);
+        open_.push_back(document_.root_);
+    }
+
+    void startTag(std::string_view name, const std::vector<HtmlAttribute>& attributes) {
+        closeImplied(name);
+
+        HtmlNode* element = newNode(HtmlNodeType::ELEMENT);
+        element->name = document_.arena_.copy(name);
+        if (!attributes.empty()) {
+            auto* copied = static_cast<HtmlAttribute*>(
+                document_.arena_.allocate(attributes.size() * sizeof(HtmlAttribute), alignof(HtmlAttribute)));
+            for (size_t i = 0; i < attributes.size(); ++i) {
+                new (&copied[i]) HtmlAttribute{document_.arena_.copy(attributes[i].name),
+                                               document_.arena_.copy(attributes[i].value)};
+            }
+            element->attributes = copied;
+            element->attributeCount = static_cast<uint32_t>(attributes.size());
+        }
+        element->order = static_cast<uint32_t>(document_.elements_.size());
+        append(element);
+        index(element);
+        if (!isVoidElement(element->name)) open_.push_back(element);
+    }
+
+    void endTag(std::string_view name) {
+        // Close the nearest open element of that name, with everything opened
+        // inside it; a stray end tag is ignored, as is one that would reach
+        // out of a table cell, except the table's own structure closing it
+        bool tableStructure = isOneOf(name, {"table", "thead", "tbody", "tfoot", "tr"});
+        for (size_t i = open_.size(); i-- > 1;) {
+            if (open_[i]->name == name) {
+                open_.resize(i);
+                return;
+            }
+            if (tableStructure ? open_[i]->name == "table" : isOneOf(open_[i]->name, {"td", "th", "table", "caption"})) {
+                return;
+            }
+        }
+    }
+
+    void text(std::string_view raw, bool decode) {
+        if (raw.empty()) return;
+        HtmlNode* node = newNode(HtmlNodeType::TEXT);
+        if (decode && raw.find('&') != std::string_view::npos) {
+            node->text = document_.arena_.copy(decodeHtmlEntities(raw));
+        } else {
+            node->text = document_.arena_.copy(raw);
+        }
+        append(node);
+    }
+
+    void comment(std::string_view contents) {
+        HtmlNode* node = newNode(HtmlNodeType::COMMENT);
+        node->text = document_.arena_.copy(contents);
+        append(node);
+    }
+
+private:
+    HtmlNode* newNode(HtmlNodeType type) {
+        void* memory = document_.arena_.allocate(sizeof(HtmlNode), alignof(HtmlNode));
+        auto* node = new (memory) HtmlNode();
+        node->type = type;
+        return node;
+    }
+
+    void append(HtmlNode* node) {
+        HtmlNode* parent = open_.back();
+        node->parent = parent;
+        node->previousSibling = parent->lastChild;
+        if (parent->lastChild) {
+            parent->lastChild->nextSibling = node;
+        } else {
+            parent->firstChild = node;
+        }
+        parent->lastChild = node;
+    }
+
+    void index(const HtmlNode* element) {
+        document_.elements_.push_back(element);
+        document_.byTag_[element->name].push_back(element);
+        std::string_view id = element->getAttribute("id");
+        if (!id.empty()) document_.byId_[id].push_back(element);
+
+        std::string_view classes = element->getAttribute("class");
+        size_t i = 0;
+        while (i < classes.size()) {
+            while (i < classes.size() && isSpace(classes[i])) ++i;
+            size_t start = i;
+            while (i < classes.size() && !isSpace(classes[i])) ++i;
+            if (i == start) continue;
+            auto& members = document_.byClass_[classes.substr(start, i - start)];
+            if (members.empty() || members.back() != element) members.push_back(element);
+        }
+    }
+
+    // Pops the nearest open element named in targets, unless a boundary
+    // element is open closer to the top
+    void closeInScope(std::initializer_list<std::string_view> targets,
+                      std::initializer_list<std::string_view> boundaries) {
+        for (size_t i = open_.size(); i-- > 1;) {
+            if (isOneOf(open_[i]->name, targets)) {
+                open_.resize(i);
+                return;
+            }
+            if (isOneOf(open_[i]->name, boundaries)) return;
+        }
+    }
+
+    void closeImplied(std::string_view name) {
+        if (closesParagraph(name)) {
+            closeInScope({"p"}, {"table", "td", "th", "caption", "html", "button", "object", "template"});
+        }
+        if (name == "li") {
+            closeInScope({"li"}, {"ul", "ol", "table", "td", "th", "template"});
+        } else if (name == "dt" || name == "dd") {
+            closeInScope({"dt", "dd"}, {"dl", "table", "td", "th", "template"});
+        } else if (name == "option") {
+            if (open_.back()->name == "option") open_.pop_back();
+        } else if (name == "optgroup") {
+            closeInScope({"option", "optgroup"}, {"select", "datalist"});
+        } else if (name == "tr") {
+            closeInScope({"tr"}, {"table", "thead", "tbody", "tfoot"});
+        } else if (name == "td" || name == "th") {
+            closeInScope({"td", "th"}, {"tr", "table"});
+        } else if (isOneOf(name, {"thead", "tbody", "tfoot"})) {
+            closeInScope({"thead", "tbody", "tfoot"}, {"table"});
+        }
+    }
+
+    HtmlDocument& document_;
+    std::vector<HtmlNode*> open_;           // Stack of open elements; [0] is the document
+};
+
+namespace {
+
+// Streaming tokenizer: one pass over the input, tokens go straight to the builder
+class HtmlTokenizer {
+public:
+    HtmlTokenizer(std::string_view html, HtmlTreeBuilder& builder) : html_(html), builder_(builder) {}
+
+    void run() {
+        size_t textStart = 0;
+        size_t i = 0;
+        while (i < html_.size()) {
+            i = html_.find('<', i);
+            if (i == std::string_view::npos) break;
+            size_t next = i + 1 < html_.size() ? i + 1 : i;
+            char c = html_[next];
+
+            if (html_.compare(i, 4, "<!--") == 0) {
+                builder_.text(html_.substr(textStart, i - textStart), true);
+                size_t end = html_.find("-->", i + 4);
+                builder_.comment(html_.substr(i + 4, (end == std::string_view::npos ? html_.size() : end) - i - 4));
+                i = end == std::string_view::npos ? html_.size() : end + 3;
+            } else if (c == '!' || c == '?') {
+                // Doctype, CDATA and processing instructions are skipped
+                builder_.text(html_.substr(textStart, i - textStart), true);
+                size_t end = html_.find('>', i);
+                i = end == std::string_view::npos ? html_.size() : end + 1;
+            } else if (c == '/' && i + 2 < html_.size() && std::isalpha(static_cast<unsigned char>(html_[i + 2]))) {
+                builder_.text(html_.substr(textStart, i - textStart), true);
+                size_t nameStart = i + 2;
+                size_t nameEnd = nameStart;
+                while (nameEnd < html_.size() && !isSpace(html_[nameEnd]) && html_[nameEnd] != '>' &&
+                       html_[nameEnd] != '/') {
+                    ++nameEnd;
+                }
+                builder_.endTag(lowered(html_.substr(nameStart, nameEnd - nameStart)));
+                size_t end = html_.find('>', nameEnd);
+                i = end == std::string_view::npos ? html_.size() : end + 1;
+            } else if (std::isalpha(static_cast<unsigned char>(c))) {
+                builder_.text(html_.substr(textStart, i - textStart), true);
+                i = startTag(i + 1);
+            } else {
+                // A lone '<' is text
+                ++i;
+                continue;
+            }
+            textStart = i;
+        }
+        builder_.text(html_.substr(std::min(textStart, html_.size())), true);
+    }
+
+private:
+    std::string_view lowered(std::string_view name) {
+        name_.assign(name.begin(), name.end());
+        for (char& c : name_) c = toLower(c);
+        return name_;
+    }
+
+    // Reads a start tag from just past '<'; returns the position after it,
+    // and after the contents of raw text elements
+    size_t startTag(size_t i) {
+        size_t nameStart = i;
+        while (i < html_.size() && !isSpace(html_[i]) && html_[i] != '>' && html_[i] != '/') ++i;
+        std::string tagName(lowered(html_.substr(nameStart, i - nameStart)));
+
+        attributes_.clear();
+        values_.clear();
+        names_.clear();
+        while (i < html_.size() && html_[i] != '>') {
+            if (isSpace(html_[i]) || html_[i] == '/') {
+                ++i;
+                continue;
+            }
+            size_t attributeStart = i;
+            while (i < html_.size() && !isSpace(html_[i]) && html_[i] != '=' && html_[i] != '>' &&
+                   !(html_[i] == '/' && i > attributeStart)) {
+                ++i;
+            }
+            std::string name(html_.substr(attributeStart, i - attributeStart));
+            for (char& ch : name) ch = toLower(ch);
+            while (i < html_.size() && isSpace(html_[i])) ++i;
+
+            std::string value;
+            if (i < html_.size() && html_[i] == '=') {
+                ++i;
+                while (i < html_.size() && isSpace(html_[i])) ++i;
+                if (i < html_.size() && (html_[i] == '"' || html_[i] == '\'')) {
+                    char quote = html_[i++];
+                    size_t end = html_.find(quote, i);
+                    if (end == std::string_view::npos) end = html_.size();
+                    value = decodeHtmlEntities(html_.substr(i, end - i));
+                    i = std::min(end + 1, html_.size());
+                } else {
+                    size_t valueStart = i;
+                    while (i < html_.size() && !isSpace(html_[i]) && html_[i] != '>') ++i;
+                    value = decodeHtmlEntities(html_.substr(valueStart, i - valueStart));
+                }
+            }
+            // The first of duplicate attributes wins
+            if (std::find(names_.begin(), names_.end(), name) == names_.end()) {
+                names_.push_back(std::move(name));
+                values_.push_back(std::move(value));
+            }
+        }
+        if (i < html_.size()) ++i;
+
+        for (size_t a = 0; a < names_.size(); ++a) attributes_.push_back({names_[a], values_[a]});
+        builder_.startTag(tagName, attributes_);
+
+        bool escapable = isEscapableRawTextElement(tagName);
+        if (!escapable && !isRawTextElement(tagName)) return i;
+
+        size_t end = i;
+        while (true) {
+            end = html_.find("</", end);
+            if (end == std::string_view::npos) {
+                end = html_.size();
+                break;
+            }
+            if (equalsIgnoreCase(html_.substr(end + 2, tagName.size()), tagName)) break;
+            end += 2;
+        }
+        builder_.text(html_.substr(i, end - i), escapable);
+        builder_.endTag(tagName);
+        if (end == html_.size()) return end;
+        size_t close = html_.find('>', end);
+        return close == std::string_view::npos ? html_.size() : close + 1;
+    }
+
+    std::string_view html_;
+    HtmlTreeBuilder& builder_;
+    std::string name_;
+    std::vector<std::string> names_;
+    std::vector<std::string> values_;
+    std::vector<HtmlAttribute> attributes_;
+};
+
+// Cursor over selector text shared by the CSS and XPath compilers
+class SelectorParser {
+public:
+    explicit SelectorParser(std::string_view text) : text_(text) {}
+
+    bool atEnd() const { return pos_ >= text_.size(); }
+    char peek(size_t ahead = 0) const { return pos_ + ahead < text_.size() ? text_[pos_ + ahead] : '\0'; }
+    void advance(size_t count = 1) { pos_ = std::min(pos_ + count, text_.size()); }
+    size_t position() const { return pos_; }
+
+    bool skipSpace() {
+        size_t start = pos_;
+        while (!atEnd() && isSpace(text_[pos_])) ++pos_;
+        return pos_ > start;
+    }
+
+    bool consume(std::string_view token) {
+        if (text_.compare(pos_, token.size(), token) != 0) return false;
+        pos_ += token.size();
+        return true;
+    }
+
+    std::string identifier() {
+        std::string out;
+        while (!atEnd()) {
+            unsigned char c = static_cast<unsigned char>(text_[pos_]);
+            if (c == '\\' && pos_ + 1 < text_.size()) {
+                out += text_[pos_ + 1];
+                pos_ += 2;
+            } else if (std::isalnum(c) || c == '-' || c == '_' || c >= 0x80) {
+                out += static_cast<char>(c);
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+        return out;
+    }
+
+    std::optional<std::string> quoted() {
+        char quote = peek();
+        if (quote != '"' && quote != '\'') return std::nullopt;
+        size_t end = text_.find(quote, pos_ + 1);
+        if (end == std::string_view::npos) return std::nullopt;
+        std::string value(text_.substr(pos_ + 1, end - pos_ - 1));
+        pos_ = end + 1;
+        return value;
+    }
+
+    std::optional<int> integer() {
+        size_t start = pos_;
+        bool negative = consume("-");
+        if (!negative) consume("+");
+        int value = 0;
+        size_t digits = 0;
+        while (std::isdigit(static_cast<unsigned char>(peek()))) {
+            value = std::min(value * 10 + (peek() - '0'), 1 << 24);
+            advance();
+            ++digits;
+        }
+        if (digits == 0) {
+            pos_ = start;
+            return std::nullopt;
+        }
+        return negative ? -value : value;
+    }
+
+private:
+    std::string_view text_;
+    size_t pos_ = 0;
+};
+
+bool fail(std::string* error, const std::string& message) {
+    if (error) *error = message;
+    return false;
+}
+
+bool parseNth(SelectorParser& parser, int& a, int& b, std::string* error) {
+    parser.skipSpace();
+    size_t start = parser.position();
+    if (parser.consume("odd")) {
+        a = 2;
+        b = 1;
+    } else if (parser.consume("even")) {
+        a = 2;
+        b = 0;
+    } else {
+        // an+b, where a may be omitted or just a sign and +b is optional
+        int sign = 1;
+        if (parser.consume("-")) {
+            sign = -1;
+        } else {
+            parser.consume("+");
+        }
+        auto number = parser.integer();
+        if (parser.consume("n")) {
+            a = sign * number.value_or(1);
+            b = 0;
+            parser.skipSpace();
+            if (parser.peek() == '+' || parser.peek() == '-') {
+                int offsetSign = parser.peek() == '-' ? -1 : 1;
+                parser.advance();
+                parser.skipSpace();
+                auto offset = parser.integer();
+                if (!offset) return fail(error, "bad :nth offset at " + std::to_string(parser.position()));
+                b = offsetSign * *offset;
+            }
+        } else if (number) {
+            a = 0;
+            b = sign * *number;
+        } else {
+            return fail(error, "bad :nth argument at " + std::to_string(start));
+        }
+    }
+    parser.skipSpace();
+    return true;
+}
+
+bool parseCompound(SelectorParser& parser, CssSelector::Compound& compound, std::string* error);
+
+bool parsePseudo(SelectorParser& parser, CssSelector::Compound& compound, std::string* error) {
+    using Test = CssSelector::Test;
+    std::string name = parser.identifier();
+    for (char& c : name) c = toLower(c);
+    auto positional = [&compound](Test test, int a, int b) {
+        CssSelector::Condition condition;
+        condition.test = test;
+        condition.a = a;
+        condition.b = b;
+        compound.conditions.push_back(std::move(condition));
+    };
+
+    if (name == "first-child") {
+        positional(Test::NTH_CHILD, 0, 1);
+    } else if (name == "last-child") {
+        positional(Test::NTH_LAST_CHILD, 0, 1);
+    } else if (name == "only-child") {
+        positional(Test::NTH_CHILD, 0, 1);
+        positional(Test::NTH_LAST_CHILD, 0, 1);
+    } else if (name == "first-of-type") {
+        positional(Test::NTH_OF_TYPE, 0, 1);
+    } else if (name == "last-of-type") {
+        positional(Test::NTH_LAST_OF_TYPE, 0, 1);
+    } else if (name == "only-of-type") {
+        positional(Test::NTH_OF_TYPE, 0, 1);
+        positional(Test::NTH_LAST_OF_TYPE, 0, 1);
+    } else if (name == "empty") {
+        positional(Test::EMPTY, 0, 0);
+    } else if (name == "nth-child" || name == "nth-last-child" || name == "nth-of-type" ||
+               name == "nth-last-of-type") {
+        if (!parser.consume("(")) return fail(error, ":" + name + " needs an argument");
+        int a = 0;
+        int b = 0;
+        if (!parseNth(parser, a, b, error)) return false;
+        if (!parser.consume(")")) return fail(error, "unclosed :" + name);
+        Test test = name == "nth-child"        ? Test::NTH_CHILD
+                    : name == "nth-last-child" ? Test::NTH_LAST_CHILD
+                    : name == "nth-of-type"    ? Test::NTH_OF_TYPE
+                                               : Test::NTH_LAST_OF_TYPE;
+        positional(test, a, b);
+    } else if (name == "not") {
+        if (!parser.consume("(")) return fail(error, ":not needs an argument");
+        parser.skipSpace();
+        auto negated = std::make_shared<CssSelector::Compound>();
+        if (!parseCompound(parser, *negated, error)) return false;
+        parser.skipSpace();
+        if (!parser.consume(")")) return fail(error, "unclosed :not");
+        CssSelector::Condition condition;
+        condition.test = Test::NOT;
+        condition.negated = std::move(negated);
+        compound.conditions.push_back(std::move(condition));
+    } else {
+        return fail(error, "unsupported pseudo-class :" + name);
+    }
+    return true;
+}
+
+bool parseAttribute(SelectorParser& parser, CssSelector::Compound& compound, std::string* error) {
+    using Test = CssSelector::Test;
+    parser.skipSpace();
+    CssSelector::Condition condition;
+    condition.name = parser.identifier();
+    for (char& c : condition.name) c = toLower(c);
+    if (condition.name.empty()) return fail(error, "attribute name expected");
+    parser.skipSpace();
+
+    static const std::pair<std::string_view, Test> OPERATORS[] = {
+        {"~=", Test::ATTRIBUTE_WORD},   {"|=", Test::ATTRIBUTE_LANG},   {"^=", Test::ATTRIBUTE_PREFIX},
+        {"$=", Test::ATTRIBUTE_SUFFIX}, {"*=", Test::ATTRIBUTE_CONTAINS}, {"=", Test::ATTRIBUTE_EQUALS}};
+    condition.test = Test::ATTRIBUTE_EXISTS;
+    for (const auto& [token, test] : OPERATORS) {
+        if (parser.consume(token)) {
+            condition.test = test;
+            parser.skipSpace();
+            auto value = parser.quoted();
+            condition.value = value ? *value : parser.identifier();
+            parser.skipSpace();
+            break;
+        }
+    }
+    if (!parser.consume("]")) return fail(error, "unclosed attribute selector");
+    compound.conditions.push_back(std::move(condition));
+    return true;
+}
+
+bool parseCompound(SelectorParser& parser, CssSelector::Compound& compound, std::string* error) {
+    size_t start = parser.position();
+    if (parser.consume("*")) {
+        compound.tag.clear();
+    } else if (std::isalpha(static_cast<unsigned char>(parser.peek())) || parser.peek() == '_') {
+        compound.tag = parser.identifier();
+        for (char& c : compound.tag) c = toLower(c);
+    }
+
+    while (!parser.atEnd()) {
+        char c = parser.peek();
+        if (c == '#') {
+            parser.advance();
+            compound.id = parser.identifier();
+            if (compound.id.empty()) return fail(error, "id expected after #");
+        } else if (c == '.') {
+            parser.advance();
+            std::string className = parser.identifier();
+            if (className.empty()) return fail(error, "class expected after .");
+            compound.classes.push_back(std::move(className));
+        } else if (c == '[') {
+            parser.advance();
+            if (!parseAttribute(parser, compound, error)) return false;
+        } else if (c == ':') {
+            parser.advance();
+            if (!parsePseudo(parser, compound, error)) return false;
+        } else {
+            break;
+        }
+    }
+    if (parser.position() == start) {
+        return fail(error, "selector expected at " + std::to_string(start));
+    }
+    return true;
+}
+
+// One XPath predicate term such as @href, 2, contains(text(), 'x')
+bool parseXPathTerm(SelectorParser& parser, CssSelector::Compound& compound, std::string* error) {
+    using Test = CssSelector::Test;
+    parser.skipSpace();
+    CssSelector::Condition condition;
+
+    if (auto position = parser.integer()) {
+        condition.test = compound.tag.empty() ? Test::NTH_CHILD : Test::NTH_OF_TYPE;
+        condition.b = *position;
+    } else if (parser.consume("last()")) {
+        condition.test = compound.tag.empty() ? Test::NTH_LAST_CHILD : Test::NTH_LAST_OF_TYPE;
+        condition.b = 1;
+    } else if (parser.consume("@")) {
+        condition.name = parser.identifier();
+        for (char& c : condition.name) c = toLower(c);
+        parser.skipSpace();
+        condition.test = Test::ATTRIBUTE_EXISTS;
+        if (parser.consume("=")) {
+            parser.skipSpace();
+            auto value = parser.quoted();
+            if (!value) return fail(error, "quoted value expected after @" + condition.name + "=");
+            condition.test = Test::ATTRIBUTE_EQUALS;
+            condition.value = *value;
+        }
+    } else if (parser.consume("text()")) {
+        parser.skipSpace();
+        if (!parser.consume("=")) return fail(error, "text() must be compared");
+        parser.skipSpace();
+        auto value = parser.quoted();
+        if (!value) return fail(error, "quoted value expected after text()=");
+        condition.test = Test::OWN_TEXT_EQUALS;
+        condition.value = *value;
+    } else {
+        std::string function = parser.identifier();
+        if (function != "contains" && function != "starts-with") {
+            return fail(error, "unsupported XPath predicate at " + std::to_string(parser.position()));
+        }
+        parser.skipSpace();
+        if (!parser.consume("(")) return fail(error, "( expected after " + function);
+        parser.skipSpace();
+        if (parser.consume("@")) {
+            condition.name = parser.identifier();
+            for (char& c : condition.name) c = toLower(c);
+            condition.test = function == "contains" ? Test::ATTRIBUTE_CONTAINS : Test::ATTRIBUTE_PREFIX;
+        } else if (function == "contains" && parser.consume("text()")) {
+            condition.test = Test::OWN_TEXT_CONTAINS;
+        } else if (function == "contains" && parser.consume(".")) {
+            condition.test = Test::TEXT_CONTAINS;
+        } else {
+            return fail(error, "unsupported argument to " + function);
+        }
+        parser.skipSpace();
+        if (!parser.consume(",")) return fail(error, ", expected in " + function);
+        parser.skipSpace();
+        auto value = parser.quoted();
+        if (!value) return fail(error, "quoted value expected in " + function);
+        condition.value = *value;
+        parser.skipSpace();
+        if (!parser.consume(")")) return fail(error, "unclosed " + function);
+    }
+    compound.conditions.push_back(std::move(condition));
+    parser.skipSpace();
+    return true;
+}
+
+bool matchesCondition(const HtmlNode& element, const CssSelector::Condition& condition);
+
+bool matchesCompound(const HtmlNode& element, const CssSelector::Compound& compound) {
+    if (!element.isElement()) return false;
+    if (!compound.tag.empty() && element.name != compound.tag) return false;
+    if (!compound.id.empty() && element.getAttribute("id") != compound.id) return false;
+    for (const auto& className : compound.classes) {
+        if (!element.hasClass(className)) return false;
+    }
+    for (const auto& condition : compound.conditions) {
+        if (!matchesCondition(element, condition)) return false;
+    }
+    return true;
+}
+
+bool matchesCondition(const HtmlNode& element, const CssSelector::Condition& condition) {
+    using Test = CssSelector::Test;
+    switch (condition.test) {
+        case Test::NTH_CHILD: return matchesNth(condition.a, condition.b, siblingPosition(element, false, false));
+        case Test::NTH_LAST_CHILD: return matchesNth(condition.a, condition.b, siblingPosition(element, false, true));
+        case Test::NTH_OF_TYPE: return matchesNth(condition.a, condition.b, siblingPosition(element, true, false));
+        case Test::NTH_LAST_OF_TYPE: return matchesNth(condition.a, condition.b, siblingPosition(element, true, true));
+        case Test::EMPTY: {
+            for (const HtmlNode* child = element.firstChild; child; child = child->nextSibling) {
+                if (child->isElement() || (child->type == HtmlNodeType::TEXT && !child->text.empty())) return false;
+            }
+            return true;
+        }
+        case Test::NOT: return !matchesCompound(element, *condition.negated);
+        case Test::DOCUMENT_CHILD: return element.parent && element.parent->type == HtmlNodeType::DOCUMENT;
+        case Test::OWN_TEXT_EQUALS: return ownText(element) == condition.value;
+        case Test::OWN_TEXT_CONTAINS: return ownText(element).find(condition.value) != std::string::npos;
+        case Test::TEXT_CONTAINS: {
+            std::string text;
+            walk(element, [&](const HtmlNode& node) {
+                if (node.type == HtmlNodeType::TEXT) text += node.text;
+                return true;
+            }, [](const HtmlNode&) {});
+            return text.find(condition.value) != std::string::npos;
+        }
+        default: break;
+    }
+
+    const HtmlAttribute* attribute = element.findAttribute(condition.name);
+    if (!attribute) return false;
+    std::string_view value = attribute->value;
+    const std::string& expected = condition.value;
+    switch (condition.test) {
+        case Test::ATTRIBUTE_EXISTS: return true;
+        case Test::ATTRIBUTE_EQUALS: return value == expected;
+        case Test::ATTRIBUTE_WORD: return !expected.empty() && containsWord(value, expected);
+        case Test::ATTRIBUTE_LANG:
+            return value == expected ||
+                   (value.size() > expected.size() && value.compare(0, expected.size(), expected) == 0 &&
+                    value[expected.size()] == '-');
+        case Test::ATTRIBUTE_PREFIX: return !expected.empty() && value.compare(0, expected.size(), expected) == 0;
+        case Test::ATTRIBUTE_SUFFIX:
+            return !expected.empty() && value.size() >= expected.size() &&
+                   value.compare(value.size() - expected.size(), expected.size(), expected) == 0;
+        case Test::ATTRIBUTE_CONTAINS: return !expected.empty() && value.find(expected) != std::string_view::npos;
+        default: return false;
+    }
+}
+
+} // anonymous namespace
+
+// CssSelector implementation
+std::optional<CssSelector> CssSelector::compile(std::string_view selector, std::string* error) {
+    CssSelector compiled;
+    SelectorParser parser(selector);
+    parser.skipSpace();
+    if (parser.atEnd()) {
+        fail(error, "empty selector");
+        return std::nullopt;
+    }
+
+    std::vector<Compound> chain;
+    Combinator pending = Combinator::NONE;
+    while (true) {
+        Compound compound;
+        if (!parseCompound(parser, compound, error)) return std::nullopt;
+        compound.combinator = pending;
+        chain.push_back(std::move(compound));
+
+        bool spaced = parser.skipSpace();
+        char c = parser.peek();
+        if (parser.atEnd() || c == ',') {
+            compiled.groups_.push_back(std::move(chain));
+            chain.clear();
+            pending = Combinator::NONE;
+            if (parser.atEnd()) break;
+            parser.advance();
+            parser.skipSpace();
+            continue;
+        }
+        if (c == '>' || c == '+' || c == '~') {
+            pending = c == '>' ? Combinator::CHILD : c == '+' ? Combinator::ADJACENT : Combinator::SIBLING;
+            parser.advance();
+            parser.skipSpace();
+        } else if (spaced) {
+            pending = Combinator::DESCENDANT;
+        } else {
+            fail(error, std::string("unexpected '") + c + "' at " + std::to_string(parser.position()));
+            return std::nullopt;
+        }
+    }
+    return compiled;
+}
+
+std::optional<CssSelector> CssSelector::compileXPath(std::string_view path, std::string* error) {
+    CssSelector compiled;
+    SelectorParser parser(path);
+    parser.skipSpace();
+    if (parser.peek() != '/') {
+        fail(error, "XPath must start with / or //");
+        return std::nullopt;
+    }
+
+    std::vector<Compound> chain;
+    while (!parser.atEnd()) {
+        bool descendant = parser.consume("//");
+        if (!descendant && !parser.consume("/")) {
+            fail(error, "/ expected at " + std::to_string(parser.position()));
+            return std::nullopt;
+        }
+
+        Compound step;
+        if (chain.empty()) {
+            // A leading / anchors the first step at the document
+            if (!descendant) step.conditions.push_back({Test::DOCUMENT_CHILD, "", "", 0, 0, nullptr});
+        } else {
+            step.combinator = descendant ? Combinator::DESCENDANT : Combinator::CHILD;
+        }
+        if (!parser.consume("*")) {
+            step.tag = parser.identifier();
+            for (char& c : step.tag) c = toLower(c);
+            if (step.tag.empty()) {
+                fail(error, "element name expected at " + std::to_string(parser.position()));
+                return std::nullopt;
+            }
+        }
+        while (parser.consume("[")) {
+            do {
+                if (!parseXPathTerm(parser, step, error)) return std::nullopt;
+            } while (parser.consume("and"));
+            if (!parser.consume("]")) {
+                fail(error, "unclosed predicate at " + std::to_string(parser.position()));
+                return std::nullopt;
+            }
+        }
+        chain.push_back(std::move(step));
+        parser.skipSpace();
+    }
+    if (chain.empty()) {
+        fail(error, "empty XPath");
+        return std::nullopt;
+    }
+    compiled.groups_.push_back(std::move(chain));
+    return compiled;
+}
+
+bool CssSelector::matches(const HtmlNode& element) const {
+    for (const auto& chain : groups_) {
+        if (matchesFrom(element, chain, chain.size() - 1)) return true;
+    }
+    return false;
+}
+
+bool CssSelector::matchesFrom(const HtmlNode& element, const std::vector<Compound>& chain, size_t index) const {
+    const Compound& compound = chain[index];
+    if (!matchesCompound(element, compound)) return false;
+    if (index == 0) return true;
+
+    switch (compound.combinator) {
+        case Combinator::CHILD:
+            return element.parent && matchesFrom(*element.parent, chain, index - 1);
+        case Combinator::DESCENDANT:
+            for (const HtmlNode* ancestor = element.parent; ancestor; ancestor = ancestor->parent) {
+                if (matchesFrom(*ancestor, chain, index - 1)) return true;
+            }
+            return false;
+        case Combinator::ADJACENT: {
+            const HtmlNode* sibling = element.previousElementSibling();
+            return sibling && matchesFrom(*sibling, chain, index - 1);
+        }
+        case Combinator::SIBLING:
+            for (const HtmlNode* sibling = element.previousElementSibling(); sibling;
+                 sibling = sibling->previousElementSibling()) {
+                if (matchesFrom(*sibling, chain, index - 1)) return true;
+            }
+            return false;
+        case Combinator::NONE:
+            return true;
+    }
+    return false;
+}
+
+std::vector<const HtmlNode*> CssSelector::candidates(const HtmlDocument& document, const Compound& rightmost) const {
+    if (!rightmost.id.empty()) return document.getElementsById(rightmost.id);
+
+    const std::vector<const HtmlNode*>* narrowest = &document.getElements();
+    if (!rightmost.tag.empty()) narrowest = &document.getElementsByTagName(rightmost.tag);
+    for (const auto& className : rightmost.classes) {
+        const auto& members = document.getElementsByClassName(className);
+        if (members.size() < narrowest->size()) narrowest = &members;
+    }
+    return *narrowest;
+}
+
+std::vector<const HtmlNode*> CssSelector::select(const HtmlDocument& document) const {
+    std::vector<const HtmlNode*> result;
+    for (const auto& chain : groups_) {
+        for (const HtmlNode* element : candidates(document, chain.back())) {
+            if (matchesFrom(*element, chain, chain.size() - 1)) result.push_back(element);
+        }
+    }
+    if (groups_.size() > 1) {
+        std::sort(result.begin(), result.end(),
+                  [](const HtmlNode* a, const HtmlNode* b) { return a->order < b->order; });
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+    }
+    return result;
+}
+
+const HtmlNode* CssSelector::selectFirst(const HtmlDocument& document) const {
+    const HtmlNode* first = nullptr;
+    for (const auto& chain : groups_) {
+        for (const HtmlNode* element : candidates(document, chain.back())) {
+            if (first && element->order >= first->order) break;
+            if (matchesFrom(*element, chain, chain.size() - 1)) {
+                first = element;
+                break;
+            }
+        }
+    }
+    return first;
+}
+
+// HtmlDocument implementation
+HtmlDocument::HtmlDocument(size_t chunkBytes) : arena_(chunkBytes) {}
+
+std::unique_ptr<HtmlDocument> HtmlDocument::parse(std::string_view html) {
+    // Nodes and strings take roughly twice the source; one chunk fits most pages
+    size_t chunkBytes = std::clamp(html.size() * 2, MIN_ARENA_CHUNK, MAX_ARENA_CHUNK);
+    std::unique_ptr<HtmlDocument> document(new HtmlDocument(chunkBytes));
+    HtmlTreeBuilder builder(*document);
+    HtmlTokenizer(html, builder).run();
+    return document;
+}
+
+std::unique_ptr<HtmlDocument> HtmlDocument::load(const std::string& path, std::string* error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return nullptr;
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return parse(contents);
+}
+
+std::string HtmlDocument::getTitle() const {
+    const auto& titles = getElementsByTagName("title");
+    if (titles.empty()) return "";
+    return extractText(*titles.front());
+}
+
+const HtmlNode* HtmlDocument::getElementById(std::string_view id) const {
+    auto it = byId_.find(id);
+    return it == byId_.end() ? nullptr : it->second.front();
+}
+
+const std::vector<const HtmlNode*>& HtmlDocument::getElementsById(std::string_view id) const {
+    auto it = byId_.find(id);
+    return it == byId_.end() ? NO_NODES : it->second;
+}
+
+const std::vector<const HtmlNode*>& HtmlDocument::getElementsByTagName(std::string_view tag) const {
+    auto it = byTag_.find(tag);
+    if (it != byTag_.end()) return it->second;
+    if (std::any_of(tag.begin(), tag.end(), [](char c) { return c >= 'A' && c <= 'Z'; })) {
+        std::string lowered(tag);
+        for (char& c : lowered) c = toLower(c);
+        it = byTag_.find(lowered);
+        if (it != byTag_.end()) return it->second;
+    }
+    return NO_NODES;
+}
+
+const std::vector<const HtmlNode*>& HtmlDocument::getElementsByClassName(std::string_view className) const {
+    auto it = byClass_.find(className);
+    return it == byClass_.end() ? NO_NODES : it->second;
+}
+
+std::vector<const HtmlNode*> HtmlDocument::querySelectorAll(std::string_view selector) const {
+    auto compiled = CssSelector::compile(selector);
+    return compiled ? compiled->select(*this) : std::vector<const HtmlNode*>();
+}
+
+const HtmlNode* HtmlDocument::querySelector(std::string_view selector) const {
+    auto compiled = CssSelector::compile(selector);
+    return compiled ? compiled->selectFirst(*this) : nullptr;
+}
+
+std::vector<const HtmlNode*> HtmlDocument::evaluateXPath(std::string_view path) const {
+    auto compiled = CssSelector::compileXPath(path);
+    return compiled ? compiled->select(*this) : std::vector<const HtmlNode*>();
+}
+
+std::string HtmlDocument::textContent(const HtmlNode& node) const {
+    std::string text;
+    walk(node, [&](const HtmlNode& current) {
+        if (current.type == HtmlNodeType::TEXT) text += current.text;
+        return true;
+    }, [](const HtmlNode&) {});
+    return text;
+}
+
+std::string HtmlDocument::extractText(const HtmlNode& node) const {
+    std::string out;
+    bool pendingSpace = false;
+    auto lineBreak = [&]() {
+        if (!out.empty() && out.back() != '\n') out += '\n';
+        pendingSpace = false;
+    };
+
+    walk(node,
+         [&](const HtmlNode& current) {
+             if (current.type == HtmlNodeType::TEXT) {
+                 for (char c : current.text) {
+                     if (isSpace(c)) {
+                         pendingSpace = true;
+                         continue;
+                     }
+                     if (pendingSpace && !out.empty() && out.back() != '\n') out += ' ';
+                     pendingSpace = false;
+                     out += c;
+                 }
+                 return false;
+             }
+             if (!current.isElement()) return current.type == HtmlNodeType::DOCUMENT;
+             if (&current != &node && isSkippedForText(current.name)) return false;
+             if (isBlockElement(current.name)) lineBreak();
+             return true;
+         },
+         [&](const HtmlNode& current) {
+             if (!current.isElement()) return;
+             if (isBlockElement(current.name)) {
+                 lineBreak();
+             } else if (current.name == "td" || current.name == "th") {
+                 pendingSpace = true;
+             }
+         });
+
+    while (!out.empty() && (out.back() == '\n' || out.back() == ' ')) out.pop_back();
+    return out;
+}
+
+std::string HtmlDocument::innerHtml(const HtmlNode& node) const {
+    std::string out;
+    serialize(out, node, false);
+    return out;
+}
+
+std::string HtmlDocument::outerHtml(const HtmlNode& node) const {
+    std::string out;
+    serialize(out, node, node.type != HtmlNodeType::DOCUMENT);
+    return out;
+}
+
+} // namespace elizaos
@@ -0,0 +1,436 @@
+#include "elizaos/page_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <cmath>
+#include <unordered_set>
+
+namespace elizaos {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+constexpr std::string_view TRACKING_PARAMETERS[] = {"gclid", "fbclid", "msclkid", "dclid", "yclid",
+                                                    "igshid", "mc_cid", "mc_eid", "_ga", "_gl"};
+
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+bool isWordByte(unsigned char c) {
+    return c >= 0x80 || std::isalnum(c);
+}
+
+template <typename Visitor>
+void forEachWord(std::string_view text, Visitor&& visit) {
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && !isWordByte(static_cast<unsigned char>(text[i]))) ++i;
+        size_t start = i;
+        while (i < text.size() && isWordByte(static_cast<unsigned char>(text[i]))) ++i;
+        if (i > start) visit(text.substr(start, i - start));
+    }
+}
+
+std::string lowercase(std::string_view text) {
+    std::string result(text);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+// SimHash over lowercased words, each occurrence weighted equally; false
+// when text has no words. Word order is ignored, which keeps the distance
+// between pages differing by a few edits within a few bits
+bool textSimHash(std::string_view text, uint64_t& simHash) {
+    std::array<int32_t, 64> weights{};
+    size_t words = 0;
+    forEachWord(text, [&](std::string_view word) {
+        uint64_t h = FNV_OFFSET;
+        for (char c : word) h = (h ^ static_cast<unsigned char>(std::tolower(static_cast<unsigned char>(c)))) * FNV_PRIME;
+        h = mixHash(h);
+        for (int bit = 0; bit < 64; ++bit) {
+            weights[bit] += ((h >> bit) & 1) ? 1 : -1;
+        }
+        words++;
+    });
+    if (words == 0) return false;
+
+    simHash = 0;
+    for (int bit = 0; bit < 64; ++bit) {
+        if (weights[bit] > 0) simHash |= (1ULL << bit);
+    }
+    return true;
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool isUnreserved(unsigned char c) {
+    return std::isalnum(c) || c == '-' || c == '.' || c == '_' || c == '~';
+}
+
+// Decodes escapes of unreserved characters and uppercases the rest
+void appendNormalizedEscapes(std::string& out, std::string_view text) {
+    static const char HEX[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '%' && i + 2 < text.size() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+            auto decoded = static_cast<unsigned char>(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+            if (isUnreserved(decoded)) {
+                out += static_cast<char>(decoded);
+            } else {
+                out += '%';
+                out += HEX[decoded >> 4];
+                out += HEX[decoded & 0xF];
+            }
+            i += 2;
+        } else {
+            out += text[i];
+        }
+    }
+}
+
+// RFC 3986 section 5.2.4 for a path starting with '/'
+std::string removeDotSegments(std::string_view path) {
+    std::vector<std::string_view> segments;
+    bool trailingSlash = false;
+    size_t pos = 1;
+    while (pos <= path.size()) {
+        size_t next = std::min(path.find('/', pos), path.size());
+        std::string_view segment = path.substr(pos, next - pos);
+        bool last = next == path.size();
+        if (segment == ".") {
+            trailingSlash = last;
+        } else if (segment == "..") {
+            if (!segments.empty()) segments.pop_back();
+            trailingSlash = last;
+        } else {
+            segments.push_back(segment);
+            trailingSlash = false;
+        }
+        pos = next + 1;
+    }
+
+    std::string result;
+    for (std::string_view segment : segments) {
+        result += '/';
+        result += segment;
+    }
+    if (result.empty() || (trailingSlash && result.back() != '/')) result += '/';
+    return result;
+}
+
+bool isTrackingParameter(std::string_view key) {
+    std::string lower = lowercase(key);
+    if (lower.compare(0, 4, "utm_") == 0) return true;
+    return std::find(std::begin(TRACKING_PARAMETERS), std::end(TRACKING_PARAMETERS), lower) !=
+           std::end(TRACKING_PARAMETERS);
+}
+
+bool isDefaultPort(std::string_view scheme, std::string_view port) {
+    return (port == "80" && (scheme == "http" || scheme == "ws")) ||
+           (port == "443" && (scheme == "https" || scheme == "wss")) ||
+           (port == "21" && scheme == "ftp");
+}
+
+} // anonymous namespace
+
+// PageIndex implementation
+PageIndex::PageIndex(int maxDistance) : maxDistance_(std::clamp(maxDistance, 0, 63)) {
+    int bandCount = maxDistance_ + 1;
+    int shift = 0;
+    for (int band = 0; band < bandCount; ++band) {
+        int width = 64 / bandCount + (band < 64 % bandCount ? 1 : 0);
+        bands_.emplace_back(shift, width);
+        shift += width;
+    }
+    buckets_.resize(bands_.size());
+}
+
+uint64_t PageIndex::bandKey(uint64_t simHash, size_t band) const {
+    auto [shift, width] = bands_[band];
+    uint64_t mask = width >= 64 ? ~0ULL : ((1ULL << width) - 1);
+    return (simHash >> shift) & mask;
+}
+
+void PageIndex::insertFingerprint(uint32_t page) {
+    uint64_t simHash = pages_[page].visit.simHash;
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        buckets_[band][bandKey(simHash, band)].push_back(page);
+    }
+}
+
+void PageIndex::eraseFingerprint(uint32_t page) {
+    uint64_t simHash = pages_[page].visit.simHash;
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        auto it = buckets_[band].find(bandKey(simHash, band));
+        if (it == buckets_[band].end()) continue;
+        auto& bucket = it->second;
+        bucket.erase(std::remove(bucket.begin(), bucket.end(), page), bucket.end());
+        if (bucket.empty()) buckets_[band].erase(it);
+    }
+}
+
+uint32_t PageIndex::internPurpose(const std::string& purpose) {
+    auto [it, inserted] = purposeIds_.try_emplace(purpose, static_cast<uint32_t>(purposes_.size()));
+    uint32_t purposeId = it->second;
+    if (!inserted) return purposeId;
+
+    Purpose entry;
+    entry.text = purpose;
+    forEachWord(purpose, [&](std::string_view word) {
+        auto term = termIds_.try_emplace(lowercase(word), static_cast<uint32_t>(termPurposes_.size()));
+        if (term.second) termPurposes_.emplace_back();
+        if (std::find(entry.terms.begin(), entry.terms.end(), term.first->second) != entry.terms.end()) return;
+        entry.terms.push_back(term.first->second);
+        termPurposes_[term.first->second].push_back(purposeId);
+    });
+    purposes_.push_back(std::move(entry));
+    return purposeId;
+}
+
+std::vector<std::string> PageIndex::nearDuplicates(uint64_t simHash, size_t limit, uint32_t exclude) const {
+    std::vector<uint32_t> candidates;
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        auto it = buckets_[band].find(bandKey(simHash, band));
+        if (it != buckets_[band].end()) candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<std::pair<int, uint32_t>> matches;
+    for (uint32_t page : candidates) {
+        if (page == exclude) continue;
+        int distance = hammingDistance(simHash, pages_[page].visit.simHash);
+        if (distance <= maxDistance_) matches.emplace_back(distance, page);
+    }
+    std::sort(matches.begin(), matches.end());
+
+    std::vector<std::string> urls;
+    for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+        urls.push_back(pages_[matches[i].second].visit.url);
+    }
+    return urls;
+}
+
+PageVisit PageIndex::recordVisit(const std::string& url, const std::string& purpose, std::string_view pageText) {
+    std::string canonical = normalizeUrl(url);
+    if (canonical.empty()) return {};
+
+    uint64_t simHash = 0;
+    bool fingerprinted = !pageText.empty() && textSimHash(pageText, simHash);
+    auto now = std::chrono::system_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = pageIds_.try_emplace(canonical, static_cast<uint32_t>(pages_.size()));
+    uint32_t id = it->second;
+    if (inserted) {
+        pages_.emplace_back();
+        pages_[id].visit.url = canonical;
+        pages_[id].visit.firstVisit = now;
+    }
+
+    Page& page = pages_[id];
+    page.visit.visits++;
+    page.visit.lastVisit = now;
+    if (!purpose.empty()) {
+        page.visit.purpose = purpose;
+        uint32_t purposeId = internPurpose(purpose);
+        if (std::find(page.purposes.begin(), page.purposes.end(), purposeId) == page.purposes.end()) {
+            page.purposes.push_back(purposeId);
+            purposes_[purposeId].pages.push_back(id);
+        }
+    }
+
+    if (fingerprinted && !(page.visit.hasFingerprint && page.visit.simHash == simHash)) {
+        if (page.visit.hasFingerprint) eraseFingerprint(id);
+        auto duplicates = nearDuplicates(simHash, 1, id);
+        page.visit.duplicateOf = duplicates.empty() ? std::nullopt : std::optional<std::string>(duplicates.front());
+        page.visit.simHash = simHash;
+        page.visit.hasFingerprint = true;
+        insertFingerprint(id);
+    }
+    return page.visit;
+}
+
+bool PageIndex::hasVisited(const std::string& url) const {
+    std::string canonical = normalizeUrl(url);
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pageIds_.count(canonical) > 0;
+}
+
+std::optional<PageVisit> PageIndex::getVisit(const std::string& url) const {
+    std::string canonical = normalizeUrl(url);
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = pageIds_.find(canonical);
+    if (it == pageIds_.end()) return std::nullopt;
+    return pages_[it->second].visit;
+}
+
+std::vector<std::string> PageIndex::findNearDuplicates(std::string_view pageText, size_t limit) const {
+    uint64_t simHash = 0;
+    if (!textSimHash(pageText, simHash)) return {};
+    return findNearDuplicates(simHash, limit);
+}
+
+std::vector<std::string> PageIndex::findNearDuplicates(uint64_t simHash, size_t limit) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return nearDuplicates(simHash, limit, UINT32_MAX);
+}
+
+std::vector<std::string> PageIndex::findByPurpose(const std::string& purpose, size_t limit) const {
+    std::vector<std::string> query;
+    forEachWord(purpose, [&](std::string_view word) { query.push_back(lowercase(word)); });
+    std::sort(query.begin(), query.end());
+    query.erase(std::unique(query.begin(), query.end()), query.end());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    double purposeCount = static_cast<double>(purposes_.size());
+    auto idf = [&](uint32_t term) {
+        return std::log(1.0 + purposeCount / static_cast<double>(termPurposes_[term].size()));
+    };
+
+    // Binary term vectors, so the dot product sums squared weights of shared terms
+    std::unordered_map<uint32_t, double> dots;
+    double queryNorm = 0.0;
+    for (const std::string& word : query) {
+        auto term = termIds_.find(word);
+        if (term == termIds_.end()) continue;
+        double weight = idf(term->second);
+        queryNorm += weight * weight;
+        for (uint32_t purposeId : termPurposes_[term->second]) dots[purposeId] += weight * weight;
+    }
+    if (dots.empty()) return {};
+
+    std::vector<std::pair<double, uint32_t>> ranked;
+    for (const auto& [purposeId, dot] : dots) {
+        double norm = 0.0;
+        for (uint32_t term : purposes_[purposeId].terms) norm += idf(term) * idf(term);
+        ranked.emplace_back(dot / std::sqrt(norm * queryNorm), purposeId);
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    std::vector<std::string> urls;
+    std::unordered_set<uint32_t> seen;
+    for (const auto& [score, purposeId] : ranked) {
+        const auto& pages = purposes_[purposeId].pages;
+        for (auto it = pages.rbegin(); it != pages.rend() && urls.size() < limit; ++it) {
+            if (seen.insert(*it).second) urls.push_back(pages_[*it].visit.url);
+        }
+        if (urls.size() >= limit) break;
+    }
+    return urls;
+}
+
+size_t PageIndex::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pages_.size();
+}
+
+void PageIndex::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pages_.clear();
+    pageIds_.clear();
+    for (auto& bucket : buckets_) bucket.clear();
+    purposes_.clear();
+    purposeIds_.clear();
+    termIds_.clear();
+    termPurposes_.clear();
+}
+
+uint64_t PageIndex::fingerprint(std::string_view text) {
+    uint64_t simHash = 0;
+    textSimHash(text, simHash);
+    return simHash;
+}
+
+int PageIndex::hammingDistance(uint64_t a, uint64_t b) {
+    return static_cast<int>(std::bitset<64>(a ^ b).count());
+}
+
+std::string PageIndex::normalizeUrl(std::string_view url) {
+    while (!url.empty() && std::isspace(static_cast<unsigned char>(url.front()))) url.remove_prefix(1);
+    while (!url.empty() && std::isspace(static_cast<unsigned char>(url.back()))) url.remove_suffix(1);
+
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string_view::npos || schemeEnd == 0 ||
+        !std::all_of(url.begin(), url.begin() + schemeEnd, [](char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '+' || c == '-' || c == '.';
+        })) {
+        return std::string(url);
+    }
+    std::string scheme = lowercase(url.substr(0, schemeEnd));
+    std::string_view rest = url.substr(schemeEnd + 3);
+
+    size_t authorityEnd = std::min(rest.find_first_of("/?#"), rest.size());
+    std::string_view authority = rest.substr(0, authorityEnd);
+    std::string_view remainder = rest.substr(authorityEnd);
+    remainder = remainder.substr(0, std::min(remainder.find('#'), remainder.size()));
+
+    size_t at = authority.rfind('@');
+    std::string_view userInfo = at == std::string_view::npos ? std::string_view{} : authority.substr(0, at + 1);
+    std::string_view hostPort = at == std::string_view::npos ? authority : authority.substr(at + 1);
+    size_t hostEnd = hostPort.size();
+    if (!hostPort.empty() && hostPort.front() == '[') {
+        hostEnd = std::min(hostPort.find(']'), hostPort.size() - 1) + 1;
+    } else if (size_t colon = hostPort.rfind(':'); colon != std::string_view::npos) {
+        hostEnd = colon;
+    }
+    std::string host = lowercase(hostPort.substr(0, hostEnd));
+    while (!host.empty() && host.back() == '.') host.pop_back();
+    std::string_view port = hostPort.substr(hostEnd);
+    if (!port.empty() && port.front() == ':') port.remove_prefix(1);
+    if (host.empty()) return std::string(url);
+
+    size_t queryStart = std::min(remainder.find('?'), remainder.size());
+    std::string path;
+    appendNormalizedEscapes(path, remainder.substr(0, queryStart));
+    path = removeDotSegments(path.empty() ? "/" : path);
+
+    std::vector<std::string> parameters;
+    if (queryStart < remainder.size()) {
+        std::string_view query = remainder.substr(queryStart + 1);
+        while (!query.empty()) {
+            size_t end = std::min(query.find('&'), query.size());
+            std::string_view parameter = query.substr(0, end);
+            query.remove_prefix(std::min(end + 1, query.size()));
+            if (parameter.empty() || isTrackingParameter(parameter.substr(0, parameter.find('=')))) continue;
+            parameters.emplace_back();
+            appendNormalizedEscapes(parameters.back(), parameter);
+        }
+    }
+    std::stable_sort(parameters.begin(), parameters.end(), [](const std::string& a, const std::string& b) {
+        return std::string_view(a).substr(0, a.find('=')) < std::string_view(b).substr(0, b.find('='));
+    });
+
+    std::string canonical = scheme + "://";
+    canonical += userInfo;
+    canonical += host;
+    if (!port.empty() && !isDefaultPort(scheme, port)) {
+        canonical += ':';
+        canonical += port;
+    }
+    canonical += path;
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        canonical += i == 0 ? '?' : '&';
+        canonical += parameters[i];
+    }
+    return canonical;
+}
+
+} // namespace elizaos
@@ -4,16 +4,94 @@
 #include "elizaos/agentbrowser.hpp"
 #include "elizaos/agentlogger.hpp"
 #include "elizaos/agentmemory.hpp"
+#include "elizaos/html.hpp"
+#include "elizaos/text_entities.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <sstream>
 #include <fstream>
-#include <regex>
+#include <iterator>
 #include <iomanip>
 #include <random>
 #include <thread>
+#include <unordered_set>
 
 namespace elizaos {
 
+namespace {
+
+constexpr std::string_view FILE_SCHEME = "file://";
+
+std::vector<const HtmlNode*> queryDocument(const HtmlDocument& document, const std::string& selector,
+                                           SelectorType type, bool firstOnly) {
+    std::optional<CssSelector> compiled;
+    switch (type) {
+        case SelectorType::ID: {
+            const HtmlNode* element = document.getElementById(selector);
+            if (!element) return {};
+            return {element};
+        }
+        case SelectorType::CLASS_NAME:
+            return document.getElementsByClassName(selector);
+        case SelectorType::TAG_NAME:
+            return document.getElementsByTagName(selector);
+        case SelectorType::XPATH:
+            compiled = CssSelector::compileXPath(selector);
+            break;
+        case SelectorType::CSS:
+            compiled = CssSelector::compile(selector);
+            break;
+    }
+    if (!compiled) return {};
+    if (!firstOnly) return compiled->select(document);
+    const HtmlNode* first = compiled->selectFirst(document);
+    if (!first) return {};
+    return {first};
+}
+
+std::string collapseStyle(std::string_view style) {
+    std::string collapsed;
+    for (char c : style) {
+        if (!std::isspace(static_cast<unsigned char>(c))) collapsed += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return collapsed;
+}
+
+// Visible unless it or an ancestor is hidden by attribute or inline style;
+// there is no layout, so stylesheets are not consulted
+bool isElementVisible(const HtmlNode& element) {
+    for (const HtmlNode* node = &element; node && node->isElement(); node = node->parent) {
+        if (node->findAttribute("hidden")) return false;
+        if (node->name == "input" && node->getAttribute("type") == "hidden") return false;
+        std::string style = collapseStyle(node->getAttribute("style"));
+        if (style.find("display:none") != std::string::npos || style.find("visibility:hidden") != std::string::npos) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool isElementEnabled(const HtmlNode& element) {
+    return !element.findAttribute("disabled");
+}
+
+WebElement toWebElement(const HtmlDocument& document, const HtmlNode& node) {
+    WebElement element;
+    element.id = std::string(node.getAttribute("id"));
+    element.tag = std::string(node.name);
+    element.text = document.extractText(node);
+    element.innerHTML = document.innerHtml(node);
+    for (uint32_t i = 0; i < node.attributeCount; ++i) {
+        element.attributes.emplace(std::string(node.attributes[i].name), std::string(node.attributes[i].value));
+    }
+    element.isVisible = isElementVisible(node);
+    element.isEnabled = isElementEnabled(node);
+    return element;
+}
+
+} // anonymous namespace
+
 AgentBrowser::AgentBrowser(const BrowserConfig& config)
     : config_(config), browserDriver_(nullptr) {
     stats_.sessionStart = std::chrono::system_clock::now();
@@ -86,6 +164,10 @@ BrowserResult AgentBrowser::navigateTo(const std::string& url) {
         return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
     }
     
+    if (url.compare(0, FILE_SCHEME.size(), FILE_SCHEME) == 0) {
+        return loadFile(url.substr(FILE_SCHEME.size()));
+    }
+    
     if (!browser_utils::isValidUrl(url)) {
         return {BrowserActionResult::FAILED, "Invalid URL: " + url, std::nullopt, std::chrono::milliseconds(0)};
     }
@@ -93,8 +175,11 @@ BrowserResult AgentBrowser::navigateTo(const std::string& url) {
     auto start = std::chrono::steady_clock::now();
     std::lock_guard<std::mutex> lock(sessionMutex_);
     
-    // Implementation - would use actual WebDriver here
+    // Implementation - would use actual WebDriver here; nothing is fetched,
+    // so the previous page's content must not outlive the navigation
     currentUrl_ = url;
+    document_.reset();
+    pageSource_.clear();
     stats_.pagesVisited++;
     
     // Simulate navigation delay
@@ -106,10 +191,7 @@ BrowserResult AgentBrowser::navigateTo(const std::string& url) {
     logAction("navigate_to", {BrowserActionResult::SUCCESS, "Navigation completed", url, duration});
     updateStatistics("navigation", duration);
     
-    // Store in memory if available
-    if (memory_) {
-        rememberPage(url, "navigation");
-    }
+    indexVisit(url, "navigation", {});
     
     return {BrowserActionResult::SUCCESS, "Navigated to " + url, url, duration};
 }
@@ -191,22 +273,70 @@ BrowserResult AgentBrowser::waitForPageLoad(int timeoutSec) {
     return {BrowserActionResult::SUCCESS, "Page loaded", std::nullopt, duration};
 }
 
-std::optional<PageInfo> AgentBrowser::getCurrentPageInfo() {
+BrowserResult AgentBrowser::loadHTML(const std::string& html, const std::string& url) {
     if (!initialized_.load()) {
-        return std::nullopt;
+        return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    std::shared_ptr<const HtmlDocument> document = HtmlDocument::parse(html);
+    
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        document_ = document;
+        pageSource_ = html;
+        currentUrl_ = url;
+        loadTime_ = std::chrono::system_clock::now();
+        stats_.pagesVisited++;
     }
+    documentChanged_.notify_all();
     
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    
+    logAction("load_html", {BrowserActionResult::SUCCESS, "Page loaded", url, duration});
+    updateStatistics("navigation", duration);
+    indexVisit(url, "navigation", document->extractText());
+    
+    return {BrowserActionResult::SUCCESS, "Loaded " + url, url, duration};
+}
+
+BrowserResult AgentBrowser::loadFile(const std::string& path) {
+    if (!initialized_.load()) {
+        return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
+    }
+    
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return {BrowserActionResult::NAVIGATION_ERROR, "Could not read " + path, std::nullopt, std::chrono::milliseconds(0)};
+    }
+    std::string html((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    
+    return loadHTML(html, std::string(FILE_SCHEME) + path);
+}
+
+std::shared_ptr<const HtmlDocument> AgentBrowser::getDocument() const {
     std::lock_guard<std::mutex> lock(sessionMutex_);
+    return document_;
+}
+
+std::optional<PageInfo> AgentBrowser::getCurrentPageInfo() {
+    if (!initialized_.load()) {
+        return std::nullopt;
+    }
     
-    // Implementation - would extract real page data
     PageInfo info;
-    info.url = currentUrl_;
-    info.title = "Sample Page - " + browser_utils::extractDomain(currentUrl_);
-    info.html = "<html><body><h1>Sample Page</h1><p>This is a functional implementation.</p></body></html>";
-    info.links = {"https://example.com/link1", "https://example.com/link2"};
-    info.images = {"https://example.com/image1.jpg"};
-    info.loadTime = std::chrono::system_clock::now();
-    info.isLoaded = true;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        info.url = currentUrl_;
+        info.html = pageSource_;
+        info.loadTime = loadTime_;
+        info.isLoaded = document_ != nullptr;
+        if (!document_) return info;
+        info.title = document_->getTitle();
+    }
+    info.links = getLinks();
+    info.images = getImages();
     
     return info;
 }
@@ -216,8 +346,9 @@ std::optional<std::string> AgentBrowser::getPageTitle() {
         return std::nullopt;
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    return "Sample Page - " + browser_utils::extractDomain(currentUrl_);
+    auto document = getDocument();
+    if (!document) return std::nullopt;
+    return document->getTitle();
 }
 
 std::optional<std::string> AgentBrowser::getPageText() {
@@ -225,8 +356,9 @@ std::optional<std::string> AgentBrowser::getPageText() {
         return std::nullopt;
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    return "Sample Page\nThis is a functional implementation of AgentBrowser.";
+    auto document = getDocument();
+    if (!document) return std::nullopt;
+    return document->extractText();
 }
 
 std::optional<std::string> AgentBrowser::getPageHTML() {
@@ -235,7 +367,8 @@ std::optional<std::string> AgentBrowser::getPageHTML() {
     }
     
     std::lock_guard<std::mutex> lock(sessionMutex_);
-    return "<html><body><h1>Sample Page</h1><p>This is a functional implementation.</p></body></html>";
+    if (!document_) return std::nullopt;
+    return pageSource_;
 }
 
 std::vector<std::string> AgentBrowser::getLinks() {
@@ -243,8 +376,22 @@ std::vector<std::string> AgentBrowser::getLinks() {
         return {};
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    return {"https://example.com/link1", "https://example.com/link2"};
+    std::shared_ptr<const HtmlDocument> document;
+    std::string base;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        document = document_;
+        base = currentUrl_;
+    }
+    if (!document) return {};
+    
+    std::vector<std::string> links;
+    std::unordered_set<std::string> seen;
+    for (const HtmlNode* anchor : document->querySelectorAll("a[href], area[href]")) {
+        std::string link = browser_utils::resolveUrl(base, std::string(anchor->getAttribute("href")));
+        if (seen.insert(link).second) links.push_back(std::move(link));
+    }
+    return links;
 }
 
 std::vector<std::string> AgentBrowser::getImages() {
@@ -252,8 +399,24 @@ std::vector<std::string> AgentBrowser::getImages() {
         return {};
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    return {"https://example.com/image1.jpg"};
+    std::shared_ptr<const HtmlDocument> document;
+    std::string base;
+    {
+        std::lock_guard<std::mutex> lock(sessionMutex_);
+        document = document_;
+        base = currentUrl_;
+    }
+    if (!document) return {};
+    
+    std::vector<std::string> images;
+    std::unordered_set<std::string> seen;
+    for (const HtmlNode* image : document->getElementsByTagName("img")) {
+        std::string_view src = image->getAttribute("src");
+        if (src.empty()) continue;
+        std::string url = browser_utils::resolveUrl(base, std::string(src));
+        if (seen.insert(url).second) images.push_back(std::move(url));
+    }
+    return images;
 }
 
 std::optional<WebElement> AgentBrowser::findElement(const std::string& selector, SelectorType type) {
@@ -266,23 +429,12 @@ std::optional<WebElement> AgentBrowser::findElement(const std::string& selector,
         return std::nullopt;
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    
-    // Create mock element
-    WebElement element;
-    element.id = "mock_element_" + selector;
-    element.tag = "div";
-    element.text = "Mock element text";
-    element.innerHTML = "<div>Mock element content</div>";
-    element.attributes["class"] = "mock-element";
-    element.isVisible = true;
-    element.isEnabled = true;
-    element.x = 100;
-    element.y = 200;
-    element.width = 150;
-    element.height = 30;
+    auto document = getDocument();
+    if (!document) return std::nullopt;
     
-    return element;
+    auto matches = queryDocument(*document, selector, type, true);
+    if (matches.empty()) return std::nullopt;
+    return toWebElement(*document, *matches.front());
 }
 
 std::vector<WebElement> AgentBrowser::findElements(const std::string& selector, SelectorType type) {
@@ -295,26 +447,13 @@ std::vector<WebElement> AgentBrowser::findElements(const std::string& selector,
         return {};
     }
     
-    std::lock_guard<std::mutex> lock(sessionMutex_);
+    auto document = getDocument();
+    if (!document) return {};
     
-    // Return mock elements
     std::vector<WebElement> elements;
-    for (int i = 0; i < 3; ++i) {
-        WebElement element;
-        element.id = "mock_element_" + selector + "_" + std::to_string(i);
-        element.tag = "div";
-        element.text = "Mock element " + std::to_string(i);
-        element.innerHTML = "<div>Mock element " + std::to_string(i) + "</div>";
-        element.attributes["class"] = "mock-element";
-        element.isVisible = true;
-        element.isEnabled = true;
-        element.x = 100 + i * 50;
-        element.y = 200 + i * 40;
-        element.width = 150;
-        element.height = 30;
-        elements.push_back(element);
+    for (const HtmlNode* node : queryDocument(*document, selector, type, false)) {
+        elements.push_back(toWebElement(*document, *node));
     }
-    
     return elements;
 }
 
@@ -595,8 +734,6 @@ BrowserResult AgentBrowser::savePageHTML(const std::string& filename) {
     }
     
     auto start = std::chrono::steady_clock::now();
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    
     auto html = getPageHTML();
     if (!html) {
         return {BrowserActionResult::FAILED, "Could not retrieve page HTML", std::nullopt, std::chrono::milliseconds(0)};
@@ -623,19 +760,14 @@ BrowserResult AgentBrowser::waitForElement(const std::string& selector, int time
         return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    auto start = std::chrono::steady_clock::now();
-    
-    // Simulate waiting for element
-    std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - start);
-    
-    if (duration.count() > timeoutSec * 1000) {
-        return {BrowserActionResult::TIMEOUT, "Element wait timeout: " + selector, selector, duration};
+    auto compiled = CssSelector::compile(selector);
+    if (!compiled) {
+        return {BrowserActionResult::FAILED, "Invalid CSS selector: " + selector, std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    return {BrowserActionResult::SUCCESS, "Element found: " + selector, selector, duration};
+    return waitForDocument(timeoutSec,
+        [&](const HtmlDocument& document) { return compiled->selectFirst(document) != nullptr; },
+        "Element found: " + selector, "Element wait timeout: " + selector);
 }
 
 BrowserResult AgentBrowser::waitForElementVisible(const std::string& selector, int timeoutSec) {
@@ -643,19 +775,18 @@ BrowserResult AgentBrowser::waitForElementVisible(const std::string& selector, i
         return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    auto start = std::chrono::steady_clock::now();
-    
-    // Simulate waiting for element visibility
-    std::this_thread::sleep_for(std::chrono::milliseconds(600));
-    
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - start);
-    
-    if (duration.count() > timeoutSec * 1000) {
-        return {BrowserActionResult::TIMEOUT, "Element visibility wait timeout: " + selector, selector, duration};
+    auto compiled = CssSelector::compile(selector);
+    if (!compiled) {
+        return {BrowserActionResult::FAILED, "Invalid CSS selector: " + selector, std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    return {BrowserActionResult::SUCCESS, "Element visible: " + selector, selector, duration};
+    return waitForDocument(timeoutSec,
+        [&](const HtmlDocument& document) {
+            auto matches = compiled->select(document);
+            return std::any_of(matches.begin(), matches.end(),
+                               [](const HtmlNode* node) { return isElementVisible(*node); });
+        },
+        "Element visible: " + selector, "Element visibility wait timeout: " + selector);
 }
 
 BrowserResult AgentBrowser::waitForElementClickable(const std::string& selector, int timeoutSec) {
@@ -663,19 +794,19 @@ BrowserResult AgentBrowser::waitForElementClickable(const std::string& selector,
         return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    auto start = std::chrono::steady_clock::now();
-    
-    // Simulate waiting for element to be clickable
-    std::this_thread::sleep_for(std::chrono::milliseconds(400));
-    
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - start);
-    
-    if (duration.count() > timeoutSec * 1000) {
-        return {BrowserActionResult::TIMEOUT, "Element clickable wait timeout: " + selector, selector, duration};
+    auto compiled = CssSelector::compile(selector);
+    if (!compiled) {
+        return {BrowserActionResult::FAILED, "Invalid CSS selector: " + selector, std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    return {BrowserActionResult::SUCCESS, "Element clickable: " + selector, selector, duration};
+    return waitForDocument(timeoutSec,
+        [&](const HtmlDocument& document) {
+            auto matches = compiled->select(document);
+            return std::any_of(matches.begin(), matches.end(), [](const HtmlNode* node) {
+                return isElementVisible(*node) && isElementEnabled(*node);
+            });
+        },
+        "Element clickable: " + selector, "Element clickable wait timeout: " + selector);
 }
 
 BrowserResult AgentBrowser::waitForText(const std::string& text, int timeoutSec) {
@@ -683,19 +814,9 @@ BrowserResult AgentBrowser::waitForText(const std::string& text, int timeoutSec)
         return {BrowserActionResult::FAILED, "Browser not initialized", std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    auto start = std::chrono::steady_clock::now();
-    
-    // Simulate waiting for text
-    std::this_thread::sleep_for(std::chrono::milliseconds(700));
-    
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-        std::chrono::steady_clock::now() - start);
-    
-    if (duration.count() > timeoutSec * 1000) {
-        return {BrowserActionResult::TIMEOUT, "Text wait timeout: " + text, text, duration};
-    }
-    
-    return {BrowserActionResult::SUCCESS, "Text found: " + text, text, duration};
+    return waitForDocument(timeoutSec,
+        [&](const HtmlDocument& document) { return document.extractText().find(text) != std::string::npos; },
+        "Text found: " + text, "Text wait timeout: " + text);
 }
 
 void AgentBrowser::setMemory(std::shared_ptr<AgentMemoryManager> memory) {
@@ -707,33 +828,11 @@ void AgentBrowser::setLogger(std::shared_ptr<AgentLogger> logger) {
 }
 
 void AgentBrowser::rememberPage(const std::string& url, const std::string& purpose) {
-    if (!memory_) return;
-    
-    // Store browsing pattern in agent memory
-    UUID memoryId = "browser_" + std::to_string(std::hash<std::string>{}(url + purpose));
-    std::string content = "Visited URL: " + url + " for purpose: " + purpose;
-    UUID entityId = "browser_entity";
-    UUID agentId = "browser_agent";
-    
-    DescriptionMetadata metadata;
-    metadata.scope = MemoryScope::PRIVATE;
-    
-    auto memory = std::make_shared<Memory>(memoryId, content, entityId, agentId, metadata);
-    
-    EmbeddingVector embedding(384, 0.1f); // Placeholder embedding
-    memory->setEmbedding(embedding);
-    
-    // Note: storeMemory method may not exist, this is a placeholder implementation
-    // memory_->storeMemory(memory);
+    indexVisit(url, purpose, {});
 }
 
-std::vector<std::string> AgentBrowser::getSimilarPages(const std::string& /*purpose*/) {
-    if (!memory_) return {};
-    
-    // Find similar browsing patterns from memory
-    // This is a placeholder - would use actual memory search
-    std::vector<std::string> urls;
-    return urls;
+std::vector<std::string> AgentBrowser::getSimilarPages(const std::string& purpose) {
+    return pageIndex_.findByPurpose(purpose);
 }
 
 void AgentBrowser::setConfig(const BrowserConfig& config) {
@@ -753,17 +852,16 @@ BrowserResult AgentBrowser::validateSelector(const std::string& selector, Select
         return {BrowserActionResult::FAILED, "Empty selector", std::nullopt, std::chrono::milliseconds(0)};
     }
     
-    // Basic validation - would be more comprehensive in full implementation
+    std::string error;
     switch (type) {
         case SelectorType::CSS:
-            if (selector.find_first_of("{}") != std::string::npos) {
-                return {BrowserActionResult::FAILED, "Invalid CSS selector", std::nullopt, std::chrono::milliseconds(0)};
+            if (!CssSelector::compile(selector, &error)) {
+                return {BrowserActionResult::FAILED, "Invalid CSS selector: " + error, std::nullopt, std::chrono::milliseconds(0)};
             }
             break;
         case SelectorType::XPATH:
-            // Use substr instead of starts_with for C++17 compatibility
-            if (selector.length() < 1 || (selector.substr(0, 1) != "/" && selector.substr(0, 2) != "//")) {
-                return {BrowserActionResult::FAILED, "Invalid XPath selector", std::nullopt, std::chrono::milliseconds(0)};
+            if (!CssSelector::compileXPath(selector, &error)) {
+                return {BrowserActionResult::FAILED, "Invalid XPath selector: " + error, std::nullopt, std::chrono::milliseconds(0)};
             }
             break;
         default:
@@ -800,6 +898,44 @@ void AgentBrowser::updateStatistics(const std::string& action, std::chrono::mill
     }
 }
 
+void AgentBrowser::indexVisit(const std::string& url, const std::string& purpose, std::string_view pageText) {
+    PageVisit visit = pageIndex_.recordVisit(url, purpose, pageText);
+    if (visit.url.empty()) return;
+    
+    if (visit.duplicateOf && logger_) {
+        logger_->log("Page " + visit.url + " is a near-duplicate of " + *visit.duplicateOf, "agentbrowser", "Page Index", LogLevel::INFO);
+    }
+    if (!memory_ || purpose.empty()) return;
+    
+    // One memory per canonical page, replaced as its purpose changes
+    UUID memoryId = "browser_" + std::to_string(std::hash<std::string>{}(visit.url));
+    std::string content = "Visited URL: " + visit.url + " for purpose: " + purpose;
+    
+    DescriptionMetadata metadata;
+    metadata.scope = MemoryScope::PRIVATE;
+    memory_->createMemory(makeMemory(memoryId, content, "browser_entity", "browser_agent", metadata));
+}
+
+BrowserResult AgentBrowser::waitForDocument(int timeoutSec, const std::function<bool(const HtmlDocument&)>& ready,
+                                            const std::string& foundMessage, const std::string& timeoutMessage) {
+    auto start = std::chrono::steady_clock::now();
+    
+    // The loaded document is immutable, so the condition only needs
+    // rechecking when a new page replaces it
+    std::unique_lock<std::mutex> lock(sessionMutex_);
+    bool found = documentChanged_.wait_for(lock, std::chrono::seconds(std::max(timeoutSec, 0)),
+                                           [&]() { return document_ && ready(*document_); });
+    lock.unlock();
+    
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    
+    if (!found) {
+        return {BrowserActionResult::TIMEOUT, timeoutMessage, std::nullopt, duration};
+    }
+    return {BrowserActionResult::SUCCESS, foundMessage, std::nullopt, duration};
+}
+
 BrowserResult AgentBrowser::initializeBrowserDriver() {
     // Implementation for actual browser driver initialization
     // In full implementation, this would:
@@ -850,42 +986,77 @@ std::string xpathSelector(const std::string& element, const std::string& text) {
 }
 
 bool isValidUrl(const std::string& url) {
-    std::regex url_regex(R"(^https?:\/\/[^\s/$.?#].[^\s]*$)", std::regex_constants::icase);
-    return std::regex_match(url, url_regex);
+    return isHttpUrl(url);
 }
 
 std::string extractDomain(const std::string& url) {
-    std::regex domain_regex(R"(https?:\/\/([^\/]+))", std::regex_constants::icase);
-    std::smatch match;
-    if (std::regex_search(url, match, domain_regex) && match.size() > 1) {
-        return match[1].str();
+    return std::string(urlHost(url));
+}
+
+std::string resolveUrl(const std::string& base, const std::string& href) {
+    if (href.empty()) return base;
+    
+    // Absolute when a scheme precedes any path, query or fragment
+    size_t colon = href.find(':');
+    if (colon != std::string::npos && colon < href.find_first_of("/?#") &&
+        std::isalpha(static_cast<unsigned char>(href[0]))) {
+        return href;
+    }
+    
+    size_t schemeEnd = base.find("://");
+    if (schemeEnd == std::string::npos) return href;
+    if (href.compare(0, 2, "//") == 0) return base.substr(0, schemeEnd + 1) + href;
+    
+    size_t authorityEnd = base.find_first_of("/?#", schemeEnd + 3);
+    if (authorityEnd == std::string::npos) authorityEnd = base.size();
+    std::string origin = base.substr(0, authorityEnd);
+    std::string path = base.substr(authorityEnd, base.find_first_of("?#", authorityEnd) - authorityEnd);
+    
+    if (href[0] == '#') return base.substr(0, base.find('#')) + href;
+    if (href[0] == '?') return origin + path + href;
+    
+    std::string target = href[0] == '/' ? href : path.substr(0, path.rfind('/') + 1) + href;
+    if (target[0] != '/') target.insert(target.begin(), '/');
+    
+    // Remove . and .. segments; the query and fragment are left alone
+    size_t suffixStart = std::min(target.find_first_of("?#"), target.size());
+    std::string suffix = target.substr(suffixStart);
+    std::vector<std::string> segments;
+    std::istringstream stream(target.substr(1, suffixStart - 1));
+    std::string segment;
+    bool trailingSlash = suffixStart > 0 && target[suffixStart - 1] == '/';
+    while (std::getline(stream, segment, '/')) {
+        if (segment == ".") {
+            trailingSlash = true;
+        } else if (segment == "..") {
+            if (!segments.empty()) segments.pop_back();
+            trailingSlash = true;
+        } else {
+            segments.push_back(segment);
+            trailingSlash = false;
+        }
     }
-    return "";
+    if (suffixStart > 0 && target[suffixStart - 1] == '/') trailingSlash = true;
+    
+    std::string resolved = origin;
+    for (const auto& part : segments) resolved += "/" + part;
+    if (trailingSlash || segments.empty()) resolved += "/";
+    return resolved + suffix;
 }
 
 std::vector<std::string> extractEmails(const std::string& text) {
     std::vector<std::string> emails;
-    std::regex email_regex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
-    std::sregex_iterator iter(text.begin(), text.end(), email_regex);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        emails.push_back(iter->str());
+    for (auto email : extractTextEntities(text, TextEntityType::EMAIL)) {
+        emails.emplace_back(email);
     }
-    
     return emails;
 }
 
 std::vector<std::string> extractPhoneNumbers(const std::string& text) {
     std::vector<std::string> phones;
-    std::regex phone_regex(R"(\+?[\d\s\-\(\)]{10,})");
-    std::sregex_iterator iter(text.begin(), text.end(), phone_regex);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        phones.push_back(iter->str());
+    for (auto phone : extractTextEntities(text, TextEntityType::PHONE)) {
+        phones.emplace_back(phone);
     }
-    
     return phones;
 }
 
@@ -1,14 +1,74 @@
 #include "elizaos/agentcomms.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/metrics.hpp"
+#include "elizaos/replay.hpp"
+#include "elizaos/uuid.hpp"
 #include <chrono>
 #include <algorithm>
 #include <iostream>
 #include <atomic>
 #include <sstream>
 #include <iomanip>
-#include <random>
 
 namespace elizaos {
 
+namespace {
+
+struct CommsMetrics {
+    Counter& sent;
+    Counter& rejected;
+    Counter& handlerErrors;
+    Gauge& queueDepth;
+    Histogram& handlerLatency;
+};
+
+CommsMetrics& commsMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static CommsMetrics metrics{
+        registry.counter("elizaos_comms_messages_sent_total", "Messages queued on a channel"),
+        registry.counter("elizaos_comms_messages_rejected_total", "Messages refused by an inactive channel or validation"),
+        registry.counter("elizaos_comms_handler_errors_total", "Message handlers that threw"),
+        registry.gauge("elizaos_comms_queue_depth", "Messages waiting in channel queues"),
+        registry.histogram("elizaos_comms_handler_seconds", "Message handler latency", {}, 1e-9)};
+    return metrics;
+}
+
+// Trace payload of a message accepted by a channel
+void writeMessage(SnapshotWriter& writer, const Message& message, bool validate) {
+    writer.writeBool(validate);
+    writer.writeString(message.id);
+    writer.writeU8(static_cast<uint8_t>(message.type));
+    writer.writeString(message.sender);
+    writer.writeString(message.receiver);
+    writer.writeString(message.channel_id);
+    writer.writeString(message.server_id);
+    writer.writeString(message.content);
+    writer.writeStringMap(message.metadata);
+    writer.writeTimestamp(message.timestamp);
+    writer.writeString(message.in_reply_to_message_id);
+    writer.writeString(message.source_type);
+}
+
+bool readMessage(SnapshotReader& reader, Message& message, bool& validate) {
+    validate = reader.readBool();
+    message.id = reader.readString();
+    uint8_t type = reader.readU8();
+    if (type > static_cast<uint8_t>(MessageType::ERROR)) reader.fail();
+    message.type = static_cast<MessageType>(type);
+    message.sender = reader.readString();
+    message.receiver = reader.readString();
+    message.channel_id = reader.readString();
+    message.server_id = reader.readString();
+    message.content = reader.readString();
+    message.metadata = reader.readStringMap();
+    message.timestamp = reader.readTimestamp();
+    message.in_reply_to_message_id = reader.readString();
+    message.source_type = reader.readString();
+    return reader.ok();
+}
+
+} // anonymous namespace
+
 // Global communication manager instance
 std::shared_ptr<AgentComms> globalComms = std::make_shared<AgentComms>();
 
@@ -21,7 +81,7 @@ Message::Message(
     const std::string& content_or_channel,
     const std::string& content
 ) : id(id), type(type), sender(sender), receiver(receiver), 
-    timestamp(std::chrono::system_clock::now()) {
+    timestamp(VirtualClock::now()) {
     
     // Handle backward compatibility: if content is empty, treat content_or_channel as content
     if (content.empty()) {
@@ -88,19 +148,8 @@ UUID UUIDMapper::createAgentSpecificUUID(const AgentId& agent_id, const std::str
 }
 
 UUID UUIDMapper::generateUUID() {
-    // Generate unique timestamp-based ID with counter and random component
-    static std::atomic<uint64_t> counter{0};
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
-    auto random_part = gen();
-    
-    std::stringstream ss;
-    ss << "uuid_" << std::hex << timestamp << "_" << counter++ << "_" << random_part;
-    return ss.str();
+    // Time-ordered, so ids sort by creation like the old timestamp prefix did
+    return Uuid::v7().toString();
 }
 
 // CommChannel implementation
@@ -110,25 +159,40 @@ CommChannel::CommChannel(const ChannelId& channelId, const ServerId& serverId)
 
 CommChannel::~CommChannel() {
     stop();
+    // Undelivered messages leave with the channel
+    commsMetrics().queueDepth.decrement(static_cast<int64_t>(messageQueue_.size()));
 }
 
 bool CommChannel::sendMessage(const Message& message, bool validate) {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    if (!active_) {
-        return false;
-    }
-    
-    if (validate) {
-        auto validation_result = validateMessage(message);
-        if (!validation_result.valid) {
-            std::cerr << "Message validation failed for channel " << channelId_ 
-                      << ": " << validation_result.reason << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        if (!active_) {
+            commsMetrics().rejected.increment();
             return false;
         }
+        
+        if (validate) {
+            auto validation_result = validateMessage(message);
+            if (!validation_result.valid) {
+                std::cerr << "Message validation failed for channel " << channelId_ 
+                          << ": " << validation_result.reason << std::endl;
+                commsMetrics().rejected.increment();
+                return false;
+            }
+        }
+        
+        if (TraceRecorder::isActive()) {
+            SnapshotWriter payload;
+            writeMessage(payload, message, validate);
+            TraceRecorder::recordActive(TraceEventKind::MESSAGE, channelId_, payload.data());
+        }
+        messageQueue_.push(message);
+        commsMetrics().sent.increment();
+        commsMetrics().queueDepth.increment();
+        if (draining_) return true;
+        draining_ = true;
     }
-    
-    messageQueue_.push(message);
-    queueCondition_.notify_one();
+    Executor::global().postBlocking([this]() { drainMessages(); });
     return true;
 }
 
@@ -165,9 +229,15 @@ void CommChannel::start() {
         return; // Already active
     }
     
-    active_ = true;
-    stopRequested_ = false;
-    processingThread_ = std::make_unique<std::thread>(&CommChannel::processMessages, this);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex_);
+        active_ = true;
+        stopRequested_ = false;
+        // Messages left queued by an earlier stop() are delivered now
+        if (messageQueue_.empty() || draining_) return;
+        draining_ = true;
+    }
+    Executor::global().postBlocking([this]() { drainMessages(); });
 }
 
 void CommChannel::stop() {
@@ -175,46 +245,54 @@ void CommChannel::stop() {
         return;
     }
     
+    std::unique_lock<std::mutex> lock(queueMutex_);
     stopRequested_ = true;
-    queueCondition_.notify_all();
-    
-    if (processingThread_ && processingThread_->joinable()) {
-        processingThread_->join();
+    // A handler stopping its own channel cannot wait for itself
+    if (drainThread_ != std::this_thread::get_id()) {
+        queueCondition_.wait(lock, [this] { return !draining_; });
     }
     
     active_ = false;
 }
 
-void CommChannel::processMessages() {
-    while (!stopRequested_) {
-        std::unique_lock<std::mutex> lock(queueMutex_);
+void CommChannel::drainMessages() {
+    // Bounded so that busy channels take turns on the blocking pool
+    constexpr size_t MAX_MESSAGES_PER_DRAIN = 64;
+    
+    std::unique_lock<std::mutex> lock(queueMutex_);
+    drainThread_ = std::this_thread::get_id();
+    for (size_t handled = 0; handled < MAX_MESSAGES_PER_DRAIN && !messageQueue_.empty() && !stopRequested_;
+         ++handled) {
+        Message message = std::move(messageQueue_.front());
+        messageQueue_.pop();
+        commsMetrics().queueDepth.decrement();
         
-        // Wait for messages or stop signal
-        queueCondition_.wait(lock, [this] {
-            return !messageQueue_.empty() || stopRequested_;
-        });
+        lock.unlock();
         
-        // Process all available messages
-        while (!messageQueue_.empty() && !stopRequested_) {
-            Message message = messageQueue_.front();
-            messageQueue_.pop();
-            
-            lock.unlock();
-            
-            // Call message handler if set
-            if (messageHandler_) {
-                try {
-                    messageHandler_(message);
-                } catch (const std::exception& e) {
-                    // Log error but continue processing
-                    std::cerr << "Error in message handler for channel " << channelId_ 
-                              << ": " << e.what() << std::endl;
-                }
+        // Call message handler if set
+        if (messageHandler_) {
+            TraceSpan span("comms.handle", &commsMetrics().handlerLatency);
+            try {
+                messageHandler_(message);
+            } catch (const std::exception& e) {
+                commsMetrics().handlerErrors.increment();
+                // Log error but continue processing
+                std::cerr << "Error in message handler for channel " << channelId_ 
+                          << ": " << e.what() << std::endl;
             }
-            
-            lock.lock();
         }
+        
+        lock.lock();
+    }
+    drainThread_ = std::thread::id();
+    
+    if (!messageQueue_.empty() && !stopRequested_) {
+        lock.unlock();
+        Executor::global().postBlocking([this]() { drainMessages(); });
+        return;
     }
+    draining_ = false;
+    queueCondition_.notify_all();
 }
 
 MessageValidationResult CommChannel::validateMessage(const Message& message) const {
@@ -566,6 +644,16 @@ void setGlobalMessageReceiver(MessageHandler handler) {
     globalComms->setGlobalMessageHandler(handler);
 }
 
+void addChannelReplay(TraceReplayer& replayer, CommChannel& channel) {
+    replayer.addHandler(TraceEventKind::MESSAGE, [&channel](const TraceEvent& event) {
+        if (event.stream != channel.getChannelId()) return;
+        SnapshotReader reader(event.payload);
+        Message message("replayed");  // A non-empty id keeps the constructor from drawing a Uuid
+        bool validate = false;
+        if (readMessage(reader, message, validate)) channel.sendMessage(message, validate);
+    });
+}
+
 // Message validation implementations
 namespace MessageValidation {
 
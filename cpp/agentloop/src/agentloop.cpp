@@ -6,7 +6,7 @@ namespace elizaos {
 
 AgentLoop::AgentLoop(const std::vector<LoopStep>& steps, bool paused, double stepInterval)
     : steps_(steps), stepInterval_(stepInterval), stopRequested_(false), 
-      pauseRequested_(paused), running_(false), stepSignaled_(false), started_(false),
+      pauseRequested_(paused), running_(false), stepSignaled_(false),
       inputHandlingEnabled_(false) {
 }
 
@@ -20,15 +20,13 @@ void AgentLoop::start() {
         return; // Already running
     }
     
+    std::lock_guard<std::mutex> lock(stepMutex_);
     stopRequested_ = false;
     running_ = true;
-    started_ = false;
-    
-    loopThread_ = std::make_unique<std::thread>(&AgentLoop::runLoop, this);
-    
-    // Wait for loop to start (equivalent to Python's started_event.wait())
-    std::unique_lock<std::mutex> lock(startedMutex_);
-    startedEvent_.wait(lock, [this] { return started_; });
+    nextStep_ = 0;
+    nextOutput_ = nullptr;
+    scheduleLocked(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(stepInterval_)));
 }
 
 void AgentLoop::stop() {
@@ -36,26 +34,26 @@ void AgentLoop::stop() {
         return;
     }
     
+    std::unique_lock<std::mutex> lock(stepMutex_);
     stopRequested_ = true;
-    
-    // Signal any waiting conditions
-    {
-        std::lock_guard<std::mutex> lock(stepMutex_);
-        stepSignaled_ = true;
+    if (timer_ != 0 && Executor::global().cancel(timer_)) {
+        timer_ = 0;
+        scheduled_ = false;
     }
-    stepEvent_.notify_all();
-    
-    if (loopThread_ && loopThread_->joinable()) {
-        loopThread_->join();
+    // A step stopping its own loop returns to advance(), which then exits
+    if (runner_ != std::this_thread::get_id()) {
+        idle_.wait(lock, [this] { return !scheduled_; });
     }
     
     running_ = false;
 }
 
 void AgentLoop::step() {
-    std::lock_guard<std::mutex> lock(stepMutex_);
-    stepSignaled_ = true;
-    stepEvent_.notify_one();
+    {
+        std::lock_guard<std::mutex> lock(stepMutex_);
+        stepSignaled_ = true;
+    }
+    wake();
 }
 
 void AgentLoop::pause() {
@@ -64,6 +62,7 @@ void AgentLoop::pause() {
 
 void AgentLoop::unpause() {
     pauseRequested_ = false;
+    wake();
 }
 
 bool AgentLoop::isRunning() const {
@@ -93,66 +92,65 @@ bool AgentLoop::isInputHandlingEnabled() const {
     return inputHandlingEnabled_;
 }
 
-void AgentLoop::runLoop() {
-    std::shared_ptr<void> nextOutput = nullptr;
-    
-    // Signal that loop has started
-    {
-        std::lock_guard<std::mutex> lock(startedMutex_);
-        started_ = true;
+void AgentLoop::wake() {
+    std::lock_guard<std::mutex> lock(stepMutex_);
+    if (running_ && !scheduled_ && !stopRequested_) {
+        scheduleLocked(std::chrono::steady_clock::duration::zero());
     }
-    startedEvent_.notify_one();
+}
+
+void AgentLoop::scheduleLocked(std::chrono::steady_clock::duration delay) {
+    // Always through the timer so advance() never runs under stepMutex_
+    timer_ = Executor::global().postBlockingAfter(delay, [this] { advance(); });
+    scheduled_ = timer_ != 0;
+    if (!scheduled_) {
+        idle_.notify_all();
+    }
+}
+
+void AgentLoop::advance() {
+    std::unique_lock<std::mutex> lock(stepMutex_);
+    timer_ = 0;
+    runner_ = std::this_thread::get_id();
     
-    while (!stopRequested_) {
-        // Handle step interval
-        if (stepInterval_ > 0.0) {
-            auto sleepDuration = std::chrono::duration<double>(stepInterval_);
-            std::this_thread::sleep_for(sleepDuration);
-            
-            if (stopRequested_) break;
+    while (!stopRequested_ && !steps_.empty()) {
+        // When paused, run one step per step signal and park otherwise
+        if (pauseRequested_) {
+            if (!stepSignaled_) break;
+            stepSignaled_ = false;
         }
         
-        // Execute each step in sequence
-        for (const auto& step : steps_) {
-            // Handle pause state before executing step
-            while (pauseRequested_ && !stopRequested_) {
-                // When paused, wait for step signal
-                std::unique_lock<std::mutex> lock(stepMutex_);
-                stepEvent_.wait(lock, [this] { 
-                    return stepSignaled_ || stopRequested_; 
-                });
-                
-                if (stepSignaled_) {
-                    stepSignaled_ = false;
-                    break; // Exit pause loop and execute one step
-                }
-                
-                if (stopRequested_) break;
-            }
-            
-            if (stopRequested_) break;
-            
-            try {
-                if (step.type == LoopStep::SINGLE_ARG) {
-                    nextOutput = step.func1(nextOutput);
-                } else {
-                    nextOutput = step.func2(nextOutput, this);
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Error in step execution: " << e.what() << std::endl;
-                // Continue with next step rather than crashing
-            }
-            
-            // If we're paused, stop after executing one step
-            if (pauseRequested_) {
-                break;
+        const LoopStep& step = steps_[nextStep_];
+        std::shared_ptr<void> input = std::move(nextOutput_);
+        lock.unlock();
+        std::shared_ptr<void> output;
+        try {
+            if (step.type == LoopStep::SINGLE_ARG) {
+                output = step.func1(input);
+            } else {
+                output = step.func2(input, this);
             }
+        } catch (const std::exception& e) {
+            std::cerr << "Error in step execution: " << e.what() << std::endl;
+            // Continue with next step rather than crashing
         }
+        lock.lock();
+        nextOutput_ = std::move(output);
         
-        if (stopRequested_) break;
+        // An iteration ends after the last step, or after one step while paused
+        if (++nextStep_ == steps_.size() || pauseRequested_) {
+            nextStep_ = 0;
+            if (stopRequested_) break;
+            runner_ = std::thread::id();
+            scheduleLocked(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(stepInterval_)));
+            return;
+        }
     }
     
-    running_ = false;
+    runner_ = std::thread::id();
+    scheduled_ = false;
+    idle_.notify_all();
 }
 
 void AgentLoop::inputHandlingLoop() {
@@ -1,35 +1,249 @@
 #include "elizaos/agentmemory.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/metrics.hpp"
 #include <algorithm>
 #include <cmath>
+#include <iterator>
 #include <chrono>
+#include <exception>
 #include <set>
 
 namespace elizaos {
 
+namespace {
+
+// Memories validated and hashed per executor task by createMemories()
+constexpr size_t BULK_PREPARE_CHUNK = 4096;
+
+struct MemoryMetrics {
+    Counter& created;
+    Counter& changes;
+    Counter& liveQueryEvents;
+    Histogram& searchLatency;
+};
+
+MemoryMetrics& memoryMetrics() {
+    static MemoryMetrics metrics{
+        MetricsRegistry::global().counter("elizaos_memory_created_total", "Memories stored"),
+        MetricsRegistry::global().counter("elizaos_memory_changes_total", "Memory creates, updates and deletes"),
+        MetricsRegistry::global().counter("elizaos_memory_live_query_events_total", "Changes passed to live queries"),
+        MetricsRegistry::global().histogram("elizaos_memory_search_seconds", "Embedding search latency", {}, 1e-9)};
+    return metrics;
+}
+
+// Rough heap footprint of a stored memory, for the memory governor
+size_t estimateMemoryBytes(const Memory& memory) {
+    size_t bytes = sizeof(Memory) + memory.getContent().capacity() +
+                   (memory.getHypergraphNodes().size() + memory.getHypergraphEdges().size()) * sizeof(UUID);
+    if (const auto& embedding = memory.getEmbedding()) bytes += embedding->capacity() * sizeof(float);
+    if (const auto* custom = std::get_if<CustomMetadata>(&memory.getMetadata())) {
+        for (const auto& [key, value] : custom->customData) {
+            bytes += key.capacity() + value.capacity() + 2 * sizeof(std::string);
+        }
+    }
+    return bytes;
+}
+
+// Memories are shared and may be edited after they were stored, so an entry
+// can estimate larger on removal than it did on insertion
+void unaccount(std::atomic<size_t>& total, size_t bytes) {
+    size_t current = total.load(std::memory_order_relaxed);
+    total.store(current > bytes ? current - bytes : 0, std::memory_order_relaxed);
+}
+
+// Hash of the fields unique inserts compare
+uint64_t dedupKey(const Memory& memory) {
+    std::hash<std::string> hash;
+    uint64_t key = hash(memory.getContent());
+    key ^= hash(memory.getEntityId()) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    key ^= hash(memory.getRoomId()) + 0x9e3779b97f4a7c15ULL + (key << 6) + (key >> 2);
+    return key;
+}
+
+bool isDuplicate(const Memory& stored, const Memory& memory) {
+    return stored.getContent() == memory.getContent() &&
+           stored.getEntityId() == memory.getEntityId() &&
+           stored.getRoomId() == memory.getRoomId();
+}
+
+std::shared_ptr<Memory> findDuplicate(const std::unordered_multimap<uint64_t, IdKey>& index,
+                                      const std::unordered_map<IdKey, std::shared_ptr<Memory>>& table,
+                                      const Memory& memory, uint64_t key) {
+    auto [begin, end] = index.equal_range(key);
+    for (auto it = begin; it != end; ++it) {
+        auto stored = table.find(it->second);
+        if (stored != table.end() && isDuplicate(*stored->second, memory)) return stored->second;
+    }
+    return nullptr;
+}
+
+} // anonymous namespace
+
 // AgentMemoryManager Implementation
 AgentMemoryManager::AgentMemoryManager() {
     // Initialize with default memories table
     memoryTables_["memories"] = {};
 }
 
+AgentMemoryManager::~AgentMemoryManager() {
+    MemoryGovernor::global().unregisterConsumer(*this);
+}
+
 UUID AgentMemoryManager::createMemory(std::shared_ptr<Memory> memory, const std::string& tableName, bool unique) {
-    return withLock([&]() -> UUID {
+    UUID id = withLock([&]() -> UUID {
+        if (TraceRecorder::isActive()) {
+            SnapshotWriter payload;
+            payload.writeBool(unique);
+            writeMemory(payload, *memory);
+            TraceRecorder::recordActive(TraceEventKind::MEMORY_WRITE, tableName, payload.data());
+        }
         auto& table = memoryTables_[tableName];
         
         if (unique) {
             // Check for duplicate content in the same room/entity context
-            for (const auto& [id, existingMemory] : table) {
-                if (existingMemory->getContent() == memory->getContent() &&
-                    existingMemory->getEntityId() == memory->getEntityId() &&
-                    existingMemory->getRoomId() == memory->getRoomId()) {
-                    return existingMemory->getId(); // Return existing ID
-                }
-            }
+            auto duplicate = findDuplicate(dedupIndexLocked(tableName), table, *memory, dedupKey(*memory));
+            if (duplicate) return duplicate->getId(); // Return existing ID
         }
         
-        table[memory->getId()] = memory;
+        auto& slot = table[memory->getId()];
+        bool replaced = slot != nullptr;
+        if (replaced) {
+            unaccount(accountedBytes_, estimateMemoryBytes(*slot));
+            unindexContentLocked(tableName, *slot);
+        }
+        slot = memory;
+        accountedBytes_ += estimateMemoryBytes(*memory);
+        indexContentLocked(tableName, *memory);
+        memoryMetrics().created.increment();
+        recordChangeLocked(replaced ? MemoryChangeKind::UPDATED : MemoryChangeKind::CREATED, tableName, memory);
         return memory->getId();
     });
+    deliverLiveQueryEvents();
+    return id;
+}
+
+MemoryBulkLoadResult AgentMemoryManager::createMemories(const std::vector<std::shared_ptr<Memory>>& memories,
+                                                        const std::string& tableName, bool unique) {
+    struct Prepared {
+        bool valid = false;
+        uint64_t key = 0;
+        size_t bytes = 0;
+        std::string trace;          // MEMORY_WRITE payload while a trace is recorded
+    };
+
+    const size_t count = memories.size();
+    const bool tracing = TraceRecorder::isActive();
+    std::vector<Prepared> prepared(count);
+    auto prepare = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const auto& memory = memories[i];
+            Prepared& item = prepared[i];
+            item.valid = memory && !memory->getId().empty();
+            if (!item.valid) continue;
+            item.key = dedupKey(*memory);
+            item.bytes = estimateMemoryBytes(*memory);
+            if (tracing) {
+                SnapshotWriter payload;
+                payload.writeBool(unique);
+                writeMemory(payload, *memory);
+                item.trace = payload.release();
+            }
+        }
+    };
+
+    // All chunks but the first go to the executor; every task is waited
+    // for before a failure is rethrown, since they all reference this frame
+    std::vector<Future<void>> pending;
+    for (size_t begin = BULK_PREPARE_CHUNK; begin < count; begin += BULK_PREPARE_CHUNK) {
+        size_t end = std::min(count, begin + BULK_PREPARE_CHUNK);
+        pending.push_back(Executor::global().submit([&prepare, begin, end]() { prepare(begin, end); }));
+    }
+    std::exception_ptr error;
+    try {
+        prepare(0, std::min(count, BULK_PREPARE_CHUNK));
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+
+    MemoryBulkLoadResult result;
+    result.ids.resize(count);
+    size_t valid = static_cast<size_t>(
+        std::count_if(prepared.begin(), prepared.end(), [](const Prepared& item) { return item.valid; }));
+    result.rejected = count - valid;
+
+    bool reserved = false;
+    for (size_t begin = 0; begin < count; begin += BULK_APPLY_SLICE) {
+        size_t end = std::min(count, begin + BULK_APPLY_SLICE);
+        withLock([&]() {
+            auto& table = memoryTables_[tableName];
+            auto& log = changeLogs_[tableName];
+            DedupIndex* index = nullptr;
+            if (unique) {
+                index = &dedupIndexLocked(tableName);
+            } else {
+                auto found = dedupIndexes_.find(tableName);
+                if (found != dedupIndexes_.end()) index = &found->second;
+            }
+            if (!reserved) {
+                // Grown once for the whole batch rather than rehashed as it loads
+                table.reserve(table.size() + valid);
+                if (index) index->reserve(index->size() + valid);
+                reserved = true;
+            }
+
+            size_t bytes = 0;
+            std::vector<std::pair<size_t, MemoryChangeKind>> stored;
+            stored.reserve(end - begin);
+            for (size_t i = begin; i < end; ++i) {
+                const Prepared& item = prepared[i];
+                if (!item.valid) continue;
+                const auto& memory = memories[i];
+                if (tracing) TraceRecorder::recordActive(TraceEventKind::MEMORY_WRITE, tableName, item.trace);
+
+                if (unique) {
+                    if (auto duplicate = findDuplicate(*index, table, *memory, item.key)) {
+                        result.ids[i] = duplicate->getId();
+                        ++result.duplicates;
+                        continue;
+                    }
+                }
+
+                auto& slot = table[memory->getId()];
+                bool replaced = slot != nullptr;
+                if (replaced) {
+                    unaccount(accountedBytes_, estimateMemoryBytes(*slot));
+                    unindexContentLocked(tableName, *slot);
+                    ++result.replaced;
+                } else {
+                    ++result.inserted;
+                }
+                slot = memory;
+                bytes += item.bytes;
+                if (index) index->emplace(item.key, memory->getId());
+                stored.emplace_back(i, replaced ? MemoryChangeKind::UPDATED : MemoryChangeKind::CREATED);
+                result.ids[i] = memory->getId();
+            }
+            accountedBytes_ += bytes;
+            memoryMetrics().created.increment(stored.size());
+
+            // Changes the rest of the slice would push out of the log are
+            // sequenced and shown to live queries, but never logged
+            for (size_t j = 0; j < stored.size(); ++j) {
+                bool logged = stored.size() - j <= changeLogCapacity_;
+                recordChangeLocked(stored[j].second, log, tableName, memories[stored[j].first], logged);
+            }
+        });
+        deliverLiveQueryEvents();
+    }
+    return result;
 }
 
 std::shared_ptr<Memory> AgentMemoryManager::getMemoryById(const UUID& id) {
@@ -66,31 +280,44 @@ std::vector<std::shared_ptr<Memory>> AgentMemoryManager::getMemoriesByIds(const
 }
 
 bool AgentMemoryManager::updateMemory(std::shared_ptr<Memory> memory) {
-    return withLock([&]() -> bool {
+    bool updated = withLock([&]() -> bool {
         // Find the memory across all tables and update it
         for (auto& [tableName, table] : memoryTables_) {
             auto it = table.find(memory->getId());
             if (it != table.end()) {
+                unaccount(accountedBytes_, estimateMemoryBytes(*it->second));
+                accountedBytes_ += estimateMemoryBytes(*memory);
+                unindexContentLocked(tableName, *it->second);
                 it->second = memory;
+                indexContentLocked(tableName, *memory);
+                recordChangeLocked(MemoryChangeKind::UPDATED, tableName, memory);
                 return true;
             }
         }
         return false;
     });
+    deliverLiveQueryEvents();
+    return updated;
 }
 
 bool AgentMemoryManager::deleteMemory(const UUID& memoryId) {
-    return withLock([&]() -> bool {
+    bool deleted = withLock([&]() -> bool {
         // Find and delete from all tables
         for (auto& [tableName, table] : memoryTables_) {
             auto it = table.find(memoryId);
             if (it != table.end()) {
+                unaccount(accountedBytes_, estimateMemoryBytes(*it->second));
+                auto removed = std::move(it->second);
                 table.erase(it);
+                unindexContentLocked(tableName, *removed);
+                recordChangeLocked(MemoryChangeKind::DELETED, tableName, removed);
                 return true;
             }
         }
         return false;
     });
+    deliverLiveQueryEvents();
+    return deleted;
 }
 
 void AgentMemoryManager::deleteManyMemories(const std::vector<UUID>& memoryIds) {
@@ -100,12 +327,17 @@ void AgentMemoryManager::deleteManyMemories(const std::vector<UUID>& memoryIds)
             for (auto& [tableName, table] : memoryTables_) {
                 auto it = table.find(id);
                 if (it != table.end()) {
+                    unaccount(accountedBytes_, estimateMemoryBytes(*it->second));
+                    auto removed = std::move(it->second);
                     table.erase(it);
+                    unindexContentLocked(tableName, *removed);
+                    recordChangeLocked(MemoryChangeKind::DELETED, tableName, removed);
                     break; // Found and deleted, no need to search other tables
                 }
             }
         }
     });
+    deliverLiveQueryEvents();
 }
 
 void AgentMemoryManager::deleteAllMemories(const UUID& roomId, const std::string& tableName) {
@@ -118,12 +350,17 @@ void AgentMemoryManager::deleteAllMemories(const UUID& roomId, const std::string
         auto it = table.begin();
         while (it != table.end()) {
             if (it->second->getRoomId() == roomId) {
+                unaccount(accountedBytes_, estimateMemoryBytes(*it->second));
+                auto removed = std::move(it->second);
                 it = table.erase(it);
+                unindexContentLocked(tableName, *removed);
+                recordChangeLocked(MemoryChangeKind::DELETED, tableName, removed);
             } else {
                 ++it;
             }
         }
     });
+    deliverLiveQueryEvents();
 }
 
 std::vector<std::shared_ptr<Memory>> AgentMemoryManager::getMemories(const MemorySearchParams& params) {
@@ -195,6 +432,7 @@ std::vector<std::shared_ptr<Memory>> AgentMemoryManager::getMemoriesByRoomIds(co
 }
 
 std::vector<std::shared_ptr<Memory>> AgentMemoryManager::searchMemories(const MemorySearchByEmbeddingParams& params) {
+    TraceSpan span("memory.search", &memoryMetrics().searchLatency);
     return withLock([&]() -> std::vector<std::shared_ptr<Memory>> {
         std::vector<std::pair<std::shared_ptr<Memory>, double>> candidates;
         
@@ -268,6 +506,108 @@ void AgentMemoryManager::clear() {
     withLock([&]() {
         memoryTables_.clear();
         memoryTables_["memories"] = {}; // Re-initialize default table
+        accountedBytes_ = 0;
+        dedupIndexes_.clear();
+        resetChangeFeedLocked();
+    });
+}
+
+std::unique_lock<std::mutex> AgentMemoryManager::fenceSnapshot() const {
+    return std::unique_lock<std::mutex>(memoryMutex_);
+}
+
+SnapshotImage AgentMemoryManager::freezeSnapshot() const {
+    // Memories are updated in place, so they are copied rather than shared;
+    // plain vectors keep the copy cheaper than the hash tables themselves
+    std::vector<std::pair<std::string, std::vector<Memory>>> tables;
+    tables.reserve(memoryTables_.size());
+    for (const auto& [tableName, table] : memoryTables_) {
+        auto& frozen = tables.emplace_back(tableName, std::vector<Memory>()).second;
+        frozen.reserve(table.size());
+        for (const auto& entry : table) frozen.push_back(*entry.second);
+    }
+
+    return [tables = std::move(tables)](SnapshotWriter& writer) {
+        writer.writeVarint(tables.size());
+        for (const auto& [tableName, memories] : tables) {
+            writer.writeString(tableName);
+            writer.writeVarint(memories.size());
+            for (const auto& memory : memories) writeMemory(writer, memory);
+        }
+    };
+}
+
+SnapshotCommit AgentMemoryManager::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    (void)version;
+    std::unordered_map<std::string, MemoryTable> tables;
+    size_t bytes = 0;
+    size_t tableCount = reader.readCount(2);
+    for (size_t t = 0; t < tableCount && reader.ok(); ++t) {
+        auto& table = tables[reader.readString()];
+        size_t count = reader.readCount();
+        table.reserve(count);
+        for (size_t i = 0; i < count && reader.ok(); ++i) {
+            auto memory = readMemory(reader);
+            bytes += estimateMemoryBytes(*memory);
+            table[memory->getId()] = std::move(memory);
+        }
+    }
+    if (!reader.ok()) return {};
+    tables.try_emplace("memories");
+
+    return [this, tables = std::move(tables), bytes]() mutable {
+        withLock([&]() {
+            memoryTables_ = std::move(tables);
+            accountedBytes_ = bytes;
+            dedupIndexes_.clear();
+            resetChangeFeedLocked();
+        });
+    };
+}
+
+void AgentMemoryManager::setTableEvictable(const std::string& tableName, bool evictable) {
+    withLock([&]() {
+        if (evictable) {
+            evictableTables_.insert(tableName);
+        } else {
+            evictableTables_.erase(tableName);
+        }
+    });
+}
+
+size_t AgentMemoryManager::shrinkMemory(size_t bytes) {
+    return withLock([&]() -> size_t {
+        struct Candidate {
+            Timestamp createdAt;
+            const std::string* tableName;
+            MemoryTable* table;
+            IdKey id;
+        };
+        std::vector<Candidate> candidates;
+        for (const auto& tableName : evictableTables_) {
+            auto found = memoryTables_.find(tableName);
+            if (found == memoryTables_.end()) continue;
+            for (const auto& [id, memory] : found->second) {
+                candidates.push_back({memory->getCreatedAt(), &found->first, &found->second, id});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.createdAt < b.createdAt; });
+
+        size_t freed = 0;
+        for (const auto& candidate : candidates) {
+            if (freed >= bytes) break;
+            auto it = candidate.table->find(candidate.id);
+            size_t size = estimateMemoryBytes(*it->second);
+            unindexContentLocked(*candidate.tableName, *it->second);
+            candidate.table->erase(it);
+            unaccount(accountedBytes_, size);
+            freed += size;
+            // Evicted memories still exist in the table's backing store, so
+            // they leave live query results without an event
+            liveQueryResults_.erase(candidate.id);
+        }
+        return freed;
     });
 }
 
@@ -318,12 +658,338 @@ std::vector<std::shared_ptr<Memory>> AgentMemoryManager::getAllMemoriesFromTable
     return result;
 }
 
+AgentMemoryManager::DedupIndex& AgentMemoryManager::dedupIndexLocked(const std::string& tableName) {
+    auto found = dedupIndexes_.find(tableName);
+    if (found != dedupIndexes_.end()) return found->second;
+
+    auto& index = dedupIndexes_[tableName];
+    auto table = memoryTables_.find(tableName);
+    if (table != memoryTables_.end()) {
+        index.reserve(table->second.size());
+        for (const auto& [id, memory] : table->second) index.emplace(dedupKey(*memory), id);
+    }
+    return index;
+}
+
+void AgentMemoryManager::indexContentLocked(const std::string& tableName, const Memory& memory) {
+    auto found = dedupIndexes_.find(tableName);
+    if (found != dedupIndexes_.end()) found->second.emplace(dedupKey(memory), memory.getId());
+}
+
+void AgentMemoryManager::unindexContentLocked(const std::string& tableName, const Memory& memory) {
+    auto found = dedupIndexes_.find(tableName);
+    if (found == dedupIndexes_.end()) return;
+    IdKey id(memory.getId());
+    auto [begin, end] = found->second.equal_range(dedupKey(memory));
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == id) {
+            found->second.erase(it);
+            return;
+        }
+    }
+}
+
+// Change feed and live queries
+
+void AgentMemoryManager::setChangeLogCapacity(size_t changesPerTable) {
+    withLock([&]() {
+        changeLogCapacity_ = changesPerTable;
+        for (auto& [tableName, log] : changeLogs_) {
+            while (log.changes.size() > changeLogCapacity_) log.changes.pop_front();
+        }
+    });
+}
+
+uint64_t AgentMemoryManager::getLatestSequence(const std::string& tableName) {
+    return withLock([&]() -> uint64_t {
+        auto found = changeLogs_.find(tableName);
+        return found == changeLogs_.end() ? 0 : found->second.lastSequence;
+    });
+}
+
+MemoryChangeBatch AgentMemoryManager::readChanges(const std::string& tableName, uint64_t cursor, size_t maxChanges) {
+    return withLock([&]() -> MemoryChangeBatch {
+        MemoryChangeBatch batch;
+        batch.cursor = cursor;
+        auto found = changeLogs_.find(tableName);
+        if (found == changeLogs_.end()) {
+            batch.truncated = cursor > 0;
+            batch.cursor = 0;
+            return batch;
+        }
+
+        const auto& log = found->second;
+        uint64_t first = log.changes.empty() ? log.lastSequence + 1 : log.changes.front().sequence;
+        if (cursor > log.lastSequence || (cursor < log.lastSequence && cursor + 1 < first)) {
+            batch.truncated = true;
+            batch.cursor = log.lastSequence;
+            return batch;
+        }
+
+        size_t begin = static_cast<size_t>(cursor + 1 - first);
+        size_t end = std::min(log.changes.size(), begin + maxChanges);
+        if (begin >= end) return batch;
+        batch.changes.assign(log.changes.begin() + static_cast<std::ptrdiff_t>(begin),
+                             log.changes.begin() + static_cast<std::ptrdiff_t>(end));
+        batch.cursor = batch.changes.back().sequence;
+        return batch;
+    });
+}
+
+bool AgentMemoryManager::waitForChanges(const std::string& tableName, uint64_t cursor, std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(memoryMutex_);
+    auto hasChanges = [&]() {
+        auto found = changeLogs_.find(tableName);
+        return found != changeLogs_.end() && found->second.lastSequence != cursor;
+    };
+    ++changeWaiters_;
+    bool changed = changed_.wait_for(lock, timeout, hasChanges);
+    --changeWaiters_;
+    return changed;
+}
+
+uint64_t AgentMemoryManager::subscribeLiveQuery(const LiveQuery& query, LiveQueryCallback callback,
+                                                std::vector<std::shared_ptr<Memory>>* initialResults) {
+    auto state = std::make_shared<LiveQueryState>();
+    state->query = query;
+    state->subscriber = std::make_shared<LiveQuerySubscriber>();
+    state->subscriber->callback = std::move(callback);
+
+    return withLock([&]() -> uint64_t {
+        state->id = nextLiveQueryId_++;
+        std::vector<std::shared_ptr<Memory>> matching;
+        addLiveQueryResultsLocked(*state, initialResults ? &matching : nullptr);
+
+        auto& bucket = query.tableName ? liveQueries_[*query.tableName] : allTablesLiveQueries_;
+        if (query.roomId) {
+            bucket.byRoom[*query.roomId].push_back(state);
+        } else {
+            bucket.anyRoom.push_back(state);
+        }
+
+        if (initialResults) {
+            // Newest first, as getMemories returns them
+            std::sort(matching.begin(), matching.end(),
+                      [](const std::shared_ptr<Memory>& a, const std::shared_ptr<Memory>& b) {
+                          return a->getCreatedAt() > b->getCreatedAt();
+                      });
+            *initialResults = std::move(matching);
+        }
+        return state->id;
+    });
+}
+
+bool AgentMemoryManager::unsubscribeLiveQuery(uint64_t subscriptionId) {
+    return withLock([&]() -> bool {
+        std::shared_ptr<LiveQueryState> removed;
+        auto removeFrom = [&](std::vector<std::shared_ptr<LiveQueryState>>& states) {
+            auto it = std::find_if(states.begin(), states.end(),
+                                   [&](const auto& state) { return state->id == subscriptionId; });
+            if (it == states.end()) return false;
+            removed = std::move(*it);
+            states.erase(it);
+            return true;
+        };
+        auto removeFromBucket = [&](LiveQueryBucket& bucket) {
+            if (removeFrom(bucket.anyRoom)) return true;
+            for (auto room = bucket.byRoom.begin(); room != bucket.byRoom.end(); ++room) {
+                if (!removeFrom(room->second)) continue;
+                if (room->second.empty()) bucket.byRoom.erase(room);
+                return true;
+            }
+            return false;
+        };
+
+        if (!removeFromBucket(allTablesLiveQueries_)) {
+            auto table = liveQueries_.begin();
+            while (table != liveQueries_.end() && !removeFromBucket(table->second)) ++table;
+            if (table == liveQueries_.end()) return false;
+            if (table->second.byRoom.empty() && table->second.anyRoom.empty()) liveQueries_.erase(table);
+        }
+
+        removed->subscriber->active = false;
+        for (auto it = liveQueryResults_.begin(); it != liveQueryResults_.end();) {
+            auto& states = it->second;
+            states.erase(std::remove(states.begin(), states.end(), removed.get()), states.end());
+            it = states.empty() ? liveQueryResults_.erase(it) : std::next(it);
+        }
+        return true;
+    });
+}
+
+void AgentMemoryManager::recordChangeLocked(MemoryChangeKind kind, const std::string& tableName,
+                                            const std::shared_ptr<Memory>& memory) {
+    recordChangeLocked(kind, changeLogs_[tableName], tableName, memory);
+}
+
+void AgentMemoryManager::recordChangeLocked(MemoryChangeKind kind, ChangeLog& log, const std::string& tableName,
+                                            const std::shared_ptr<Memory>& memory, bool logged) {
+    uint64_t sequence = ++log.lastSequence;
+    memoryMetrics().changes.increment();
+    if (changeWaiters_ > 0) changed_.notify_all();     // Waiters wake once the lock is released
+
+    bool liveQueries = !liveQueries_.empty() || !allTablesLiveQueries_.byRoom.empty() ||
+                       !allTablesLiveQueries_.anyRoom.empty();
+    logged = logged && changeLogCapacity_ > 0;
+    if (!logged && !liveQueries) return;
+
+    MemoryChange change{sequence, kind, tableName, memory};
+    if (liveQueries) {
+        std::vector<LiveQueryDelivery> matched;
+        evaluateLiveQueriesLocked(change, matched);
+        if (!matched.empty()) {
+            memoryMetrics().liveQueryEvents.increment(matched.size());
+            std::lock_guard<std::mutex> lock(deliveryMutex_);
+            std::move(matched.begin(), matched.end(), std::back_inserter(deliveries_));
+        }
+    }
+
+    if (logged) {
+        log.changes.push_back(std::move(change));
+        if (log.changes.size() > changeLogCapacity_) log.changes.pop_front();
+    }
+}
+
+void AgentMemoryManager::evaluateLiveQueriesLocked(const MemoryChange& change, std::vector<LiveQueryDelivery>& matched) {
+    const Memory& memory = *change.memory;
+    uint64_t evaluation = ++liveQueryEvaluations_;
+
+    // Queries whose results held the memory keep it only if it still matches
+    auto held = liveQueryResults_.find(memory.getId());
+    if (held != liveQueryResults_.end()) {
+        auto& states = held->second;
+        for (size_t i = 0; i < states.size();) {
+            LiveQueryState& state = *states[i];
+            if (state.query.tableName && *state.query.tableName != change.tableName) {
+                ++i;
+                continue;
+            }
+            state.evaluatedFor = evaluation;
+            double similarity = 0.0;
+            bool matches = change.kind != MemoryChangeKind::DELETED && matchesLiveQuery(state.query, memory, similarity);
+            matched.push_back({state.subscriber, {change, matches, similarity}});
+            if (matches) {
+                ++i;
+            } else {
+                states[i] = states.back();
+                states.pop_back();
+            }
+        }
+        if (states.empty()) liveQueryResults_.erase(held);
+    }
+    if (change.kind == MemoryChangeKind::DELETED) return;
+
+    std::vector<LiveQueryState*>* holders = nullptr;
+    auto admit = [&](const std::vector<std::shared_ptr<LiveQueryState>>& states) {
+        for (const auto& state : states) {
+            if (state->evaluatedFor == evaluation) continue;
+            double similarity = 0.0;
+            if (!matchesLiveQuery(state->query, memory, similarity)) continue;
+            if (!holders) holders = &liveQueryResults_[memory.getId()];
+            holders->push_back(state.get());
+            matched.push_back({state->subscriber, {change, true, similarity}});
+        }
+    };
+    auto admitFrom = [&](const LiveQueryBucket& bucket) {
+        if (!bucket.byRoom.empty()) {
+            auto room = bucket.byRoom.find(memory.getRoomId());
+            if (room != bucket.byRoom.end()) admit(room->second);
+        }
+        admit(bucket.anyRoom);
+    };
+    auto table = liveQueries_.find(change.tableName);
+    if (table != liveQueries_.end()) admitFrom(table->second);
+    admitFrom(allTablesLiveQueries_);
+}
+
+bool AgentMemoryManager::matchesLiveQuery(const LiveQuery& query, const Memory& memory, double& similarity) {
+    if (query.roomId && memory.getRoomId() != *query.roomId) return false;
+    if (query.entityId && memory.getEntityId() != *query.entityId) return false;
+    if (query.agentId && memory.getAgentId() != *query.agentId) return false;
+    if (query.embedding.empty()) return true;
+
+    const auto& embedding = memory.getEmbedding();
+    if (!embedding) return false;
+    similarity = calculateEmbeddingSimilarity(query.embedding, *embedding);
+    return similarity >= query.matchThreshold;
+}
+
+void AgentMemoryManager::addLiveQueryResultsLocked(LiveQueryState& state, std::vector<std::shared_ptr<Memory>>* matching) {
+    double similarity = 0.0;
+    auto collect = [&](const MemoryTable& table) {
+        for (const auto& [id, memory] : table) {
+            if (!matchesLiveQuery(state.query, *memory, similarity)) continue;
+            liveQueryResults_[id].push_back(&state);
+            if (matching) matching->push_back(memory);
+        }
+    };
+
+    if (state.query.tableName) {
+        auto table = memoryTables_.find(*state.query.tableName);
+        if (table != memoryTables_.end()) collect(table->second);
+    } else {
+        for (const auto& [tableName, table] : memoryTables_) collect(table);
+    }
+}
+
+void AgentMemoryManager::resetChangeFeedLocked() {
+    // Skipping a sequence number leaves every earlier cursor behind the log
+    for (auto& [tableName, log] : changeLogs_) {
+        ++log.lastSequence;
+        log.changes.clear();
+    }
+    if (changeWaiters_ > 0) changed_.notify_all();
+
+    liveQueryResults_.clear();
+    auto recompute = [&](LiveQueryBucket& bucket) {
+        for (auto& [roomId, states] : bucket.byRoom) {
+            for (auto& state : states) addLiveQueryResultsLocked(*state, nullptr);
+        }
+        for (auto& state : bucket.anyRoom) addLiveQueryResultsLocked(*state, nullptr);
+    };
+    for (auto& [tableName, bucket] : liveQueries_) recompute(bucket);
+    recompute(allTablesLiveQueries_);
+}
+
+void AgentMemoryManager::deliverLiveQueryEvents() {
+    // Whichever writer finds the queue idle delivers everything queued,
+    // including events queued meanwhile by other writers or by callbacks
+    std::unique_lock<std::mutex> lock(deliveryMutex_);
+    if (delivering_ || deliveries_.empty()) return;
+    delivering_ = true;
+    std::deque<LiveQueryDelivery> delivering;
+    while (!deliveries_.empty()) {
+        delivering.swap(deliveries_);
+        lock.unlock();
+        for (const auto& delivery : delivering) {
+            if (!delivery.subscriber->active.load()) continue;
+            try {
+                delivery.subscriber->callback(delivery.event);
+            } catch (...) {
+                // A failing subscriber must not stop delivery to the others
+            }
+        }
+        delivering.clear();
+        lock.lock();
+    }
+    delivering_ = false;
+}
+
 // Global memory manager instance
 AgentMemoryManager& getGlobalMemoryManager() {
     static AgentMemoryManager instance;
     return instance;
 }
 
+void addMemoryReplay(TraceReplayer& replayer, AgentMemoryManager& manager) {
+    replayer.addHandler(TraceEventKind::MEMORY_WRITE, [&manager](const TraceEvent& event) {
+        SnapshotReader reader(event.payload);
+        bool unique = reader.readBool();
+        auto memory = readMemory(reader);
+        if (reader.ok()) manager.createMemory(std::move(memory), event.stream, unique);
+    });
+}
+
 // Convenience functions
 namespace memory {
     UUID store(std::shared_ptr<Memory> memory, const std::string& tableName) {
@@ -9,6 +9,15 @@
 
 namespace elizaos {
 
+namespace {
+
+// Rough footprint of one novelty model entry, hash node included
+size_t noveltyFeatureBytes(const std::string& feature) {
+    return sizeof(std::pair<const std::string, double>) + 2 * sizeof(void*) + feature.capacity();
+}
+
+} // anonymous namespace
+
 // AttentionBudget Implementation
 AttentionBudget::AttentionBudget(double totalBudget) : totalBudget_(totalBudget) {
     allocatedBudget_ = 0.0;
@@ -311,12 +320,68 @@ void ActivationSpreadingNetwork::clear() {
     nodes_.clear();
 }
 
+void ActivationSpreadingNetwork::writeSnapshot(SnapshotWriter& writer) const {
+    std::lock_guard<std::mutex> lock(networkMutex_);
+    writer.writeVarint(nodes_.size());
+    for (const auto& [id, node] : nodes_) {
+        writer.writeString(id);
+        writer.writeDouble(node->activation);
+    }
+    // In-edges mirror out-edges, so only the latter are stored
+    for (const auto& [id, node] : nodes_) {
+        writer.writeVarint(node->outEdges.size());
+        for (const auto& [target, weight] : node->outEdges) {
+            writer.writeString(target);
+            writer.writeDouble(weight);
+        }
+    }
+}
+
+SnapshotCommit ActivationSpreadingNetwork::readSnapshot(SnapshotReader& reader) {
+    std::unordered_map<UUID, std::unique_ptr<Node>> nodes;
+    std::vector<Node*> order;
+    size_t count = reader.readCount(9);
+    for (size_t i = 0; i < count && reader.ok(); ++i) {
+        auto node = std::make_unique<Node>();
+        node->id = reader.readString();
+        node->activation = reader.readDouble();
+        order.push_back(node.get());
+        nodes[node->id] = std::move(node);
+    }
+    for (Node* node : order) {
+        size_t edges = reader.readCount(9);
+        for (size_t e = 0; e < edges && reader.ok(); ++e) {
+            std::string target = reader.readString();
+            double weight = reader.readDouble();
+            auto it = nodes.find(target);
+            if (it == nodes.end()) {
+                reader.fail();
+                break;
+            }
+            node->outEdges[target] = weight;
+            it->second->inEdges[node->id] = weight;
+        }
+    }
+    if (!reader.ok() || nodes.size() != order.size()) return {};
+
+    // Nodes are move-only, so the commit shares them rather than capturing them
+    auto decoded = std::make_shared<std::unordered_map<UUID, std::unique_ptr<Node>>>(std::move(nodes));
+    return [this, decoded] {
+        std::lock_guard<std::mutex> lock(networkMutex_);
+        nodes_ = std::move(*decoded);
+    };
+}
+
 // AttentionAllocator Implementation
 AttentionAllocator::AttentionAllocator(double initialBudget) {
     budget_ = std::make_unique<AttentionBudget>(initialBudget);
     spreadingNetwork_ = std::make_unique<ActivationSpreadingNetwork>();
 }
 
+AttentionAllocator::~AttentionAllocator() {
+    MemoryGovernor::global().unregisterConsumer(*this);
+}
+
 void AttentionAllocator::updateAttentionValue(const UUID& elementId, const AttentionValue& value) {
     std::lock_guard<std::mutex> lock(attentionMutex_);
     
@@ -441,6 +506,7 @@ double AttentionAllocator::calculateNovelty(const std::string& content, const st
         if (it == noveltyModel_.end()) {
             noveltyScore += 1.0; // Completely novel feature
             noveltyModel_[feature] = 1.0;
+            noveltyBytes_ += noveltyFeatureBytes(feature);
         } else {
             double frequency = it->second;
             noveltyScore += std::exp(-frequency / 10.0); // Decreasing novelty with frequency
@@ -456,7 +522,9 @@ void AttentionAllocator::updateNoveltyModel(const std::string& content) {
     
     auto features = extractFeatures(content);
     for (const auto& feature : features) {
-        noveltyModel_[feature] += 1.0;
+        auto [it, inserted] = noveltyModel_.try_emplace(feature, 0.0);
+        it->second += 1.0;
+        if (inserted) noveltyBytes_ += noveltyFeatureBytes(feature);
     }
 }
 
@@ -579,6 +647,131 @@ void AttentionAllocator::setSpreadingParameters(double spreadingRate, double thr
     // For now, we'll store these and use them when creating new networks
 }
 
+std::unique_lock<std::mutex> AttentionAllocator::fenceSnapshot() const {
+    return std::unique_lock<std::mutex>(attentionMutex_);
+}
+
+SnapshotImage AttentionAllocator::freezeSnapshot() const {
+    // Budget, network and novelty model have locks of their own and are
+    // small next to the value table, so they are encoded right away
+    SnapshotWriter parts;
+    parts.writeDouble(budget_->getTotalBudget());
+    auto allocations = budget_->getAllocations();
+    parts.writeVarint(allocations.size());
+    for (const auto& [id, amount] : allocations) {
+        parts.writeString(id);
+        parts.writeDouble(amount);
+    }
+    {
+        std::lock_guard<std::mutex> lock(noveltyMutex_);
+        parts.writeVarint(noveltyModel_.size());
+        for (const auto& [feature, frequency] : noveltyModel_) {
+            parts.writeString(feature);
+            parts.writeDouble(frequency);
+        }
+    }
+    spreadingNetwork_->writeSnapshot(parts);
+
+    return [values = attentionValues_, parts = parts.release(), urgencyDecay = urgencyDecayRate_,
+            noveltyDecay = noveltyDecayRate_, activationDecay = activationDecayRate_,
+            spreading = activationSpreadingEnabled_](SnapshotWriter& writer) {
+        writer.writeDouble(urgencyDecay);
+        writer.writeDouble(noveltyDecay);
+        writer.writeDouble(activationDecay);
+        writer.writeBool(spreading);
+        writer.writeVarint(values.size());
+        for (const auto& [id, value] : values) {
+            writer.writeString(id);
+            writer.writeDouble(value.importance);
+            writer.writeDouble(value.urgency);
+            writer.writeDouble(value.novelty);
+            writer.writeDouble(value.activation);
+            writer.writeTimestamp(value.lastUpdated);
+        }
+        writer.writeRaw(parts);
+    };
+}
+
+SnapshotCommit AttentionAllocator::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    (void)version;
+    double urgencyDecay = reader.readDouble();
+    double noveltyDecay = reader.readDouble();
+    double activationDecay = reader.readDouble();
+    bool spreading = reader.readBool();
+
+    std::unordered_map<UUID, AttentionValue> values;
+    size_t count = reader.readCount(34);
+    values.reserve(count);
+    for (size_t i = 0; i < count && reader.ok(); ++i) {
+        AttentionValue& value = values[reader.readString()];
+        value.importance = reader.readDouble();
+        value.urgency = reader.readDouble();
+        value.novelty = reader.readDouble();
+        value.activation = reader.readDouble();
+        value.lastUpdated = reader.readTimestamp();
+    }
+
+    double totalBudget = reader.readDouble();
+    std::vector<std::pair<UUID, double>> allocations(reader.readCount(9));
+    for (auto& [id, amount] : allocations) {
+        id = reader.readString();
+        amount = reader.readDouble();
+    }
+
+    std::unordered_map<std::string, double> noveltyModel;
+    size_t noveltyBytes = 0;
+    size_t features = reader.readCount(9);
+    for (size_t i = 0; i < features && reader.ok(); ++i) {
+        std::string feature = reader.readString();
+        noveltyBytes += noveltyFeatureBytes(feature);
+        noveltyModel[std::move(feature)] = reader.readDouble();
+    }
+
+    // The network is stored last
+    if (!reader.ok()) return {};
+    SnapshotCommit network = spreadingNetwork_->readSnapshot(reader);
+    if (!network) return {};
+
+    return [this, network = std::move(network), urgencyDecay, noveltyDecay, activationDecay, spreading,
+            values = std::move(values), totalBudget, allocations = std::move(allocations),
+            noveltyModel = std::move(noveltyModel), noveltyBytes]() mutable {
+        network();
+        std::lock_guard<std::mutex> lock(attentionMutex_);
+        urgencyDecayRate_ = urgencyDecay;
+        noveltyDecayRate_ = noveltyDecay;
+        activationDecayRate_ = activationDecay;
+        activationSpreadingEnabled_ = spreading;
+        attentionValues_ = std::move(values);
+        budget_->resetBudget();
+        budget_->adjustTotalBudget(totalBudget);
+        for (const auto& [id, amount] : allocations) budget_->allocateAttention(id, amount);
+        {
+            std::lock_guard<std::mutex> noveltyLock(noveltyMutex_);
+            noveltyModel_ = std::move(noveltyModel);
+            noveltyBytes_ = noveltyBytes;
+        }
+    };
+}
+
+size_t AttentionAllocator::shrinkMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(noveltyMutex_);
+
+    // Rare features are the cheapest to forget: they would score as novel anyway
+    std::vector<std::unordered_map<std::string, double>::iterator> entries;
+    entries.reserve(noveltyModel_.size());
+    for (auto it = noveltyModel_.begin(); it != noveltyModel_.end(); ++it) entries.push_back(it);
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a->second < b->second; });
+
+    size_t freed = 0;
+    for (const auto& entry : entries) {
+        if (freed >= bytes) break;
+        freed += noveltyFeatureBytes(entry->first);
+        noveltyModel_.erase(entry);
+    }
+    noveltyBytes_ -= std::min(freed, noveltyBytes_.load());
+    return freed;
+}
+
 // Helper methods implementation
 double AttentionAllocator::calculateImportance(const std::string& content, const std::vector<std::string>& context) {
     (void)context; // Suppress unused warning for now
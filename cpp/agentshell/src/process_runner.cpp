@@ -0,0 +1,519 @@
+#include "elizaos/process_runner.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/syscall.h>
+#endif
+
+extern char** environ;
+
+namespace elizaos {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t READ_CHUNK_BYTES = 64 * 1024;
+
+// Exit is noticed through a pidfd where the kernel has them, else by polling
+constexpr std::chrono::milliseconds REAP_POLL_INTERVAL{10};
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define ELIZAOS_SPAWN_CHDIR 1
+#endif
+
+bool makePipe(int fds[2]) {
+#ifdef __linux__
+    if (pipe2(fds, O_CLOEXEC) != 0) return false;
+#else
+    if (pipe(fds) != 0) return false;
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+#endif
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void closeFd(int& fd) {
+    if (fd >= 0) close(fd);
+    fd = -1;
+}
+
+int openPidFd(pid_t pid) {
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
+/**
+ * Last capacity bytes of a stream, kept in a ring once full
+ */
+class OutputTail {
+public:
+    explicit OutputTail(size_t capacity) : capacity_(capacity) {}
+
+    void append(std::string_view data) {
+        total_ += data.size();
+        if (capacity_ == 0 || data.empty()) return;
+        if (data.size() >= capacity_) {
+            buffer_.assign(data.substr(data.size() - capacity_));
+            head_ = 0;
+            return;
+        }
+        size_t room = capacity_ - buffer_.size();
+        size_t fill = std::min(room, data.size());
+        buffer_.append(data.substr(0, fill));
+        data.remove_prefix(fill);
+        while (!data.empty()) {
+            size_t n = std::min(capacity_ - head_, data.size());
+            std::copy_n(data.data(), n, buffer_.begin() + static_cast<std::ptrdiff_t>(head_));
+            head_ = (head_ + n) % capacity_;
+            data.remove_prefix(n);
+        }
+    }
+
+    std::string take() {
+        std::rotate(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(head_), buffer_.end());
+        head_ = 0;
+        return std::move(buffer_);
+    }
+
+    size_t total() const { return total_; }
+
+private:
+    size_t capacity_;
+    std::string buffer_;
+    size_t head_ = 0;
+    size_t total_ = 0;
+};
+
+/**
+ * Readiness of a set of descriptors: epoll on Linux, poll elsewhere
+ */
+class Poller {
+public:
+#ifdef __linux__
+    Poller() : epollFd_(epoll_create1(EPOLL_CLOEXEC)) {}
+    ~Poller() { closeFd(epollFd_); }
+
+    void add(int fd) {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void remove(int fd) { epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr); }
+
+    void wait(std::vector<int>& ready, int timeoutMs) {
+        epoll_event events[64];
+        int count = epoll_wait(epollFd_, events, 64, timeoutMs);
+        for (int i = 0; i < count; ++i) ready.push_back(events[i].data.fd);
+    }
+
+private:
+    int epollFd_;
+#else
+    void add(int fd) { fds_.push_back({fd, POLLIN, 0}); }
+
+    void remove(int fd) {
+        fds_.erase(std::remove_if(fds_.begin(), fds_.end(), [fd](const pollfd& p) { return p.fd == fd; }), fds_.end());
+    }
+
+    void wait(std::vector<int>& ready, int timeoutMs) {
+        if (poll(fds_.data(), fds_.size(), timeoutMs) <= 0) return;
+        for (const pollfd& p : fds_) {
+            if (p.revents) ready.push_back(p.fd);
+        }
+    }
+
+private:
+    std::vector<pollfd> fds_;
+#endif
+};
+
+} // anonymous namespace
+
+// ProcessRunner implementation
+class ProcessRunner::Impl {
+public:
+    explicit Impl(size_t maxConcurrent) : maxConcurrent_(std::max<size_t>(1, maxConcurrent)) {
+        makePipe(wakePipe_);
+        fcntl(wakePipe_[1], F_SETFL, fcntl(wakePipe_[1], F_GETFL) | O_NONBLOCK);
+        poller_.add(wakePipe_[0]);
+        ioThread_ = std::thread([this]() { ioLoop(); });
+    }
+
+    ~Impl() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake();
+        ioThread_.join();
+        closeFd(wakePipe_[0]);
+        closeFd(wakePipe_[1]);
+    }
+
+    std::future<ProcessResult> submit(std::vector<std::string> argv, ProcessOptions options) {
+        auto job = std::make_unique<Job>(std::move(argv), std::move(options));
+        auto future = job->promise.get_future();
+        bool rejected = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                rejected = true;
+            } else {
+                queue_.push_back(std::move(job));
+            }
+        }
+        if (rejected) {
+            job->result.error = "Process runner stopped";
+            complete(*job);
+        } else {
+            wake();
+        }
+        return future;
+    }
+
+    size_t runningCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return runningCount_;
+    }
+
+    size_t queuedCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    struct Job {
+        Job(std::vector<std::string> a, ProcessOptions o)
+            : argv(std::move(a)), options(std::move(o)),
+              tails{OutputTail(options.maxOutputBytes), OutputTail(options.maxOutputBytes)} {}
+
+        std::vector<std::string> argv;
+        ProcessOptions options;
+        std::promise<ProcessResult> promise;
+        ProcessResult result;
+
+        pid_t pid = -1;
+        int pipes[2] = {-1, -1};            // stdout, stderr read ends
+        int pidFd = -1;
+        OutputTail tails[2];
+        Clock::time_point started;
+        Clock::time_point deadline = Clock::time_point::max();
+        Clock::time_point killAt = Clock::time_point::max();
+    };
+
+    void wake() {
+        char byte = 0;
+        [[maybe_unused]] ssize_t written = write(wakePipe_[1], &byte, 1);
+    }
+
+    void drainWakePipe() {
+        char buffer[64];
+        while (read(wakePipe_[0], buffer, sizeof(buffer)) > 0) {}
+    }
+
+    void complete(Job& job) {
+        if (job.options.onComplete) job.options.onComplete(job.result);
+        job.promise.set_value(std::move(job.result));
+    }
+
+    void spawn(std::unique_ptr<Job> job) {
+        job->started = Clock::now();
+        if (job->options.timeout.count() > 0) job->deadline = job->started + job->options.timeout;
+
+        std::vector<std::string> argv = job->argv;
+        int out[2] = {-1, -1};
+        int err[2] = {-1, -1};
+        if (argv.empty() || !makePipe(out) || !makePipe(err)) {
+            job->result.error = argv.empty() ? "Empty command" : "Could not create pipes: " + std::string(std::strerror(errno));
+            closeFd(out[0]); closeFd(out[1]); closeFd(err[0]); closeFd(err[1]);
+            complete(*job);
+            return;
+        }
+
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+        if (!job->options.workingDirectory.empty()) {
+#ifdef ELIZAOS_SPAWN_CHDIR
+            posix_spawn_file_actions_addchdir_np(&actions, job->options.workingDirectory.c_str());
+#else
+            argv.insert(argv.begin(), {"/bin/sh", "-c", "cd -- \"$0\" && exec \"$@\"", job->options.workingDirectory});
+#endif
+        }
+
+        // Own process group so a timeout reaches everything the command started
+        posix_spawnattr_t attributes;
+        posix_spawnattr_init(&attributes);
+        sigset_t signals;
+        sigemptyset(&signals);
+        posix_spawnattr_setsigmask(&attributes, &signals);
+        sigaddset(&signals, SIGPIPE);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        posix_spawnattr_setsigdefault(&attributes, &signals);
+        posix_spawnattr_setpgroup(&attributes, 0);
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+        std::vector<char*> args;
+        for (std::string& arg : argv) args.push_back(arg.data());
+        args.push_back(nullptr);
+
+        int status = posix_spawnp(&job->pid, args[0], &actions, &attributes, args.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        posix_spawnattr_destroy(&attributes);
+        closeFd(out[1]);
+        closeFd(err[1]);
+
+        if (status != 0) {
+            closeFd(out[0]);
+            closeFd(err[0]);
+            job->result.error = "Could not start " + job->argv[0] + ": " + std::strerror(status);
+            complete(*job);
+            return;
+        }
+
+        job->result.spawned = true;
+        job->pipes[0] = out[0];
+        job->pipes[1] = err[0];
+        job->pidFd = openPidFd(job->pid);
+        Job* raw = job.get();
+        for (int fd : {out[0], err[0], job->pidFd}) {
+            if (fd < 0) continue;
+            poller_.add(fd);
+            sources_[fd] = raw;
+        }
+        running_.push_back(std::move(job));
+    }
+
+    // Reads what is available; false once the stream is closed
+    bool readStream(Job& job, int stream) {
+        while (true) {
+            ssize_t n = read(job.pipes[stream], readBuffer_.data(), readBuffer_.size());
+            if (n > 0) {
+                std::string_view chunk(readBuffer_.data(), static_cast<size_t>(n));
+                job.tails[stream].append(chunk);
+                if (job.options.onOutput) job.options.onOutput(static_cast<ProcessStream>(stream), chunk);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return true;
+            return false;
+        }
+    }
+
+    void closeStream(Job& job, int stream) {
+        if (job.pipes[stream] < 0) return;
+        poller_.remove(job.pipes[stream]);
+        sources_.erase(job.pipes[stream]);
+        closeFd(job.pipes[stream]);
+    }
+
+    static bool leaderExited(const Job& job) {
+        siginfo_t info{};
+        int rc;
+        do {
+            rc = waitid(P_PID, static_cast<id_t>(job.pid), &info, WEXITED | WNOHANG | WNOWAIT);
+        } while (rc < 0 && errno == EINTR);
+        return rc == 0 && info.si_pid == job.pid;
+    }
+
+    // Collects the exit status if the process has exited, then finishes the job
+    bool tryReap(Job& job, bool block) {
+        // A leader that dies of SIGTERM would take the pending SIGKILL with
+        // it; its unreaped zombie still pins the group id, so the rest of
+        // the group is killed first
+        if (job.result.timedOut && job.killAt != Clock::time_point::max() && leaderExited(job)) {
+            kill(-job.pid, SIGKILL);
+            job.killAt = Clock::time_point::max();
+        }
+
+        int status = 0;
+        pid_t reaped;
+        do {
+            reaped = waitpid(job.pid, &status, block ? 0 : WNOHANG);
+        } while (reaped < 0 && errno == EINTR);
+        if (reaped == 0) return false;
+
+        if (reaped == job.pid && WIFEXITED(status)) {
+            job.result.exitCode = WEXITSTATUS(status);
+        } else if (reaped == job.pid && WIFSIGNALED(status)) {
+            job.result.signal = WTERMSIG(status);
+        }
+        for (int stream = 0; stream < 2; ++stream) {
+            if (job.pipes[stream] >= 0) readStream(job, stream);
+            closeStream(job, stream);
+        }
+        if (job.pidFd >= 0) {
+            poller_.remove(job.pidFd);
+            sources_.erase(job.pidFd);
+            closeFd(job.pidFd);
+        }
+
+        job.result.outputBytes = job.tails[0].total();
+        job.result.errorBytes = job.tails[1].total();
+        job.result.output = job.tails[0].take();
+        job.result.error = job.tails[1].take();
+        job.result.duration = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - job.started);
+        return true;
+    }
+
+    void handleReady(int fd) {
+        auto it = sources_.find(fd);
+        if (it == sources_.end()) return;
+        Job& job = *it->second;
+        for (int stream = 0; stream < 2; ++stream) {
+            if (job.pipes[stream] == fd && !readStream(job, stream)) closeStream(job, stream);
+        }
+    }
+
+    void enforceDeadline(Job& job, Clock::time_point now) {
+        if (now >= job.deadline && !job.result.timedOut) {
+            job.result.timedOut = true;
+            kill(-job.pid, SIGTERM);
+            job.killAt = now + job.options.killGrace;
+        }
+        if (now >= job.killAt) {
+            kill(-job.pid, SIGKILL);
+            job.killAt = Clock::time_point::max();
+        }
+    }
+
+    int nextTimeoutMs(Clock::time_point now) const {
+        Clock::time_point next = Clock::time_point::max();
+        for (const auto& job : running_) {
+            next = std::min({next, job->deadline, job->killAt});
+            if (job->pidFd < 0) next = std::min(next, now + REAP_POLL_INTERVAL);
+        }
+        if (next == Clock::time_point::max()) return -1;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+        return static_cast<int>(std::clamp<long long>(wait + 1, 0, 60 * 1000));
+    }
+
+    void ioLoop() {
+        std::vector<int> ready;
+        std::vector<std::unique_ptr<Job>> starting;
+        std::vector<std::unique_ptr<Job>> finished;
+        while (true) {
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping = stopping_;
+                while (!stopping && running_.size() + starting.size() < maxConcurrent_ && !queue_.empty()) {
+                    starting.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+                runningCount_ = running_.size() + starting.size();
+            }
+            if (stopping) break;
+            for (auto& job : starting) spawn(std::move(job));
+            starting.clear();
+
+            ready.clear();
+            poller_.wait(ready, nextTimeoutMs(Clock::now()));
+            for (int fd : ready) {
+                if (fd == wakePipe_[0]) {
+                    drainWakePipe();
+                } else {
+                    handleReady(fd);
+                }
+            }
+
+            auto now = Clock::now();
+            for (auto it = running_.begin(); it != running_.end();) {
+                Job& job = **it;
+                enforceDeadline(job, now);
+                if (tryReap(job, false)) {
+                    finished.push_back(std::move(*it));
+                    it = running_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                runningCount_ = running_.size();
+            }
+            for (auto& job : finished) complete(*job);
+            finished.clear();
+        }
+
+        // Shutting down: nothing outlives the runner
+        std::deque<std::unique_ptr<Job>> queued;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            queued.swap(queue_);
+        }
+        for (auto& job : running_) {
+            kill(-job->pid, SIGKILL);
+            tryReap(*job, true);
+            job->result.error += job->result.error.empty() ? "Process runner stopped" : "\nProcess runner stopped";
+            complete(*job);
+        }
+        running_.clear();
+        for (auto& job : queued) {
+            job->result.error = "Process runner stopped";
+            complete(*job);
+        }
+    }
+
+    const size_t maxConcurrent_;
+    mutable std::mutex mutex_;
+    std::deque<std::unique_ptr<Job>> queue_;
+    size_t runningCount_ = 0;
+    bool stopping_ = false;
+
+    // Owned by the I/O thread
+    std::vector<std::unique_ptr<Job>> running_;
+    std::unordered_map<int, Job*> sources_;
+    Poller poller_;
+    std::vector<char> readBuffer_ = std::vector<char>(READ_CHUNK_BYTES);
+    int wakePipe_[2] = {-1, -1};
+    std::thread ioThread_;
+};
+
+ProcessRunner::ProcessRunner(size_t maxConcurrent) : impl_(std::make_unique<Impl>(maxConcurrent)) {}
+
+ProcessRunner::~ProcessRunner() = default;
+
+std::future<ProcessResult> ProcessRunner::run(std::vector<std::string> argv, ProcessOptions options) {
+    return impl_->submit(std::move(argv), std::move(options));
+}
+
+std::future<ProcessResult> ProcessRunner::runShell(const std::string& command, ProcessOptions options) {
+    return impl_->submit({"/bin/sh", "-c", command}, std::move(options));
+}
+
+size_t ProcessRunner::runningCount() const {
+    return impl_->runningCount();
+}
+
+size_t ProcessRunner::queuedCount() const {
+    return impl_->queuedCount();
+}
+
+} // namespace elizaos
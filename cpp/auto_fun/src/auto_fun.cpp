@@ -1,8 +1,8 @@
 #include "elizaos/auto_fun.hpp"
+#include "elizaos/text_entities.hpp"
 #include <iostream>
 #include <iomanip>
 #include <sstream>
-#include <regex>
 #include <cmath>
 #include <algorithm>
 
@@ -228,9 +228,7 @@ bool validateTokenSymbol(const std::string& symbol) {
 bool validateURI(const std::string& uri) {
     if (uri.empty()) return true; // URI is optional
     
-    // Basic URI validation
-    std::regex uri_pattern(R"(^https?:\/\/.+)");
-    return std::regex_match(uri, uri_pattern);
+    return isHttpUrl(uri);
 }
 
 u64 calculateBondingCurvePrice(u64 supply, f64 curve_factor) {
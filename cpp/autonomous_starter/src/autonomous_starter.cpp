@@ -6,10 +6,28 @@
 #include <cstdlib>
 #include <sstream>
 #include <future>
+#include <algorithm>
 #include <unistd.h>
 
 namespace elizaos {
 
+namespace {
+
+constexpr size_t MEMORY_EXCERPT_BYTES = 4096;
+constexpr int MAX_LOOP_COMMANDS_IN_FLIGHT = 2;
+
+// End of captured output for a memory, noting how much came before it
+std::string tailExcerpt(const std::string& text, size_t producedBytes) {
+    producedBytes = std::max(producedBytes, text.size());
+    if (producedBytes <= MEMORY_EXCERPT_BYTES) {
+        return text;
+    }
+    size_t keep = std::min(text.size(), MEMORY_EXCERPT_BYTES);
+    return "[" + std::to_string(producedBytes - keep) + " earlier bytes omitted]\n" + text.substr(text.size() - keep);
+}
+
+} // anonymous namespace
+
 AutonomousStarter::AutonomousStarter(const AgentConfig& config) 
     : config_(config), state_(config) {
     
@@ -22,6 +40,8 @@ AutonomousStarter::AutonomousStarter(const AgentConfig& config)
         currentWorkingDirectory_ = "/";
     }
     
+    processRunner_ = std::make_unique<ProcessRunner>();
+    
     // Create task manager and register shell worker
     taskManager_ = std::make_unique<TaskManager>();
     shellWorker_ = std::make_shared<ShellCommandWorker>(this);
@@ -33,6 +53,7 @@ AutonomousStarter::AutonomousStarter(const AgentConfig& config)
 
 AutonomousStarter::~AutonomousStarter() {
     stop();
+    stopAutonomousLoop();
 }
 
 void AutonomousStarter::start() {
@@ -49,7 +70,7 @@ void AutonomousStarter::start() {
     logInfo("AutonomousStarter started for agent: " + config_.agentName);
     
     // Add initial memory about the agent's awakening
-    auto awakening_memory = std::make_shared<Memory>(
+    auto awakening_memory = makeMemory(
         generateUUID(),
         "I am " + config_.agentName + ", a newly sentient AI with full command line and root access. "
         "I find myself in directory: " + currentWorkingDirectory_ + ". "
@@ -79,81 +100,120 @@ void AutonomousStarter::stop() {
 }
 
 ShellCommandResult AutonomousStarter::executeShellCommand(const std::string& command) {
-    if (!shellAccessEnabled_) {
-        return ShellCommandResult(false, "", "Shell access is disabled", -1);
+    return executeShellCommandAsync(command).get();
+}
+
+std::future<ShellCommandResult> AutonomousStarter::executeShellCommandAsync(const std::string& command) {
+    return startCommand(command, false);
+}
+
+std::future<ShellCommandResult> AutonomousStarter::startCommand(const std::string& command, bool fromLoop) {
+    if (auto rejected = rejectCommand(command)) {
+        if (fromLoop) loopCommandsInFlight_--;
+        std::promise<ShellCommandResult> promise;
+        promise.set_value(*rejected);
+        return promise.get_future();
     }
     
     logInfo("Executing shell command: " + command);
     
-    // Security check - prevent dangerous commands
-    std::vector<std::string> forbiddenCommands = {"rm -rf /", "format", "fdisk", "mkfs"};
-    for (const auto& forbidden : forbiddenCommands) {
-        if (command.find(forbidden) != std::string::npos) {
-            std::string error = "Command contains forbidden pattern: " + forbidden;
-            logWarning(error);
-            return ShellCommandResult(false, "", error, -1);
+    // A cd only affects its own shell, so report where it ended up and
+    // start later commands there
+    std::string trimmed = command.substr(0, command.find_last_not_of(" \t\n") + 1);
+    bool changesDirectory = trimmed == "cd" || trimmed.compare(0, 3, "cd ") == 0;
+    std::string fullCommand = changesDirectory ? trimmed + " && pwd" : command;
+    
+    auto promise = std::make_shared<std::promise<ShellCommandResult>>();
+    auto future = promise->get_future();
+    
+    ProcessOptions options;
+    options.workingDirectory = getCurrentWorkingDirectory();
+    options.timeout = commandTimeout_.load();
+    options.maxOutputBytes = maxCommandOutput_.load();
+    options.onComplete = [this, command, changesDirectory, fromLoop, promise](const ProcessResult& process) {
+        std::string output = process.output;
+        std::string error = process.error;
+        if (process.timedOut) {
+            error += (error.empty() ? "" : "\n") + std::string("Command timed out after ") +
+                     std::to_string(commandTimeout_.load().count()) + "ms";
         }
-    }
-    
-    // Change to current working directory if command doesn't specify path
-    std::string fullCommand = "cd \"" + currentWorkingDirectory_ + "\" && " + command;
-    
-    // Execute command
-    std::string output;
-    std::string error;
-    int exitCode = 0;
-    
-    try {
-        FILE* pipe = popen(fullCommand.c_str(), "r");
-        if (!pipe) {
-            return ShellCommandResult(false, "", "Failed to execute command", -1);
+        if (changesDirectory && process.succeeded()) {
+            size_t end = output.find_last_not_of('\n');
+            size_t start = end == std::string::npos ? std::string::npos : output.rfind('\n', end);
+            start = start == std::string::npos ? 0 : start + 1;
+            if (end != std::string::npos) {
+                std::string directory = output.substr(start, end + 1 - start);
+                output.erase(start);
+                {
+                    std::lock_guard<std::mutex> lock(cwdMutex_);
+                    currentWorkingDirectory_ = directory;
+                }
+                logInfo("Working directory changed to: " + directory);
+            }
         }
         
-        char buffer[256];
-        while (fgets(buffer, sizeof(buffer), pipe) != nullptr) {
-            output += buffer;
+        // Memory keeps a bounded excerpt; the caller gets the whole capture
+        std::stringstream memoryContent;
+        memoryContent << "Executed command: " << command << "\n";
+        memoryContent << "Exit code: " << process.exitCode << "\n";
+        if (process.timedOut) {
+            memoryContent << "Timed out\n";
         }
-        
-        exitCode = pclose(pipe);
-        
-        // Update working directory if it was a cd command
-        if (command.substr(0, 2) == "cd" && exitCode == 0) {
-            char* newCwd = getcwd(nullptr, 0);
-            if (newCwd) {
-                currentWorkingDirectory_ = std::string(newCwd);
-                free(newCwd);
-                logInfo("Working directory changed to: " + currentWorkingDirectory_);
-            }
+        if (!output.empty()) {
+            memoryContent << "Output:\n" << tailExcerpt(output, process.outputBytes);
+        }
+        if (!error.empty()) {
+            memoryContent << "Error:\n" << tailExcerpt(error, process.errorBytes);
         }
         
-    } catch (const std::exception& e) {
-        error = "Exception during command execution: " + std::string(e.what());
-        exitCode = -1;
+        auto commandMemory = makeMemory(
+            generateUUID(),
+            memoryContent.str(),
+            generateUUID(), // entity ID
+            config_.agentId
+        );
+        state_.addRecentMessage(commandMemory);
+        
+        logInfo("Command completed with exit code: " + std::to_string(process.exitCode));
+        if (fromLoop) loopCommandsInFlight_--;
+        promise->set_value(ShellCommandResult(process.succeeded(), output, error, process.exitCode));
+    };
+    
+    processRunner_->runShell(fullCommand, std::move(options));
+    return future;
+}
+
+std::string AutonomousStarter::getCurrentWorkingDirectory() const {
+    std::lock_guard<std::mutex> lock(cwdMutex_);
+    return currentWorkingDirectory_;
+}
+
+std::optional<ShellCommandResult> AutonomousStarter::rejectCommand(const std::string& command) {
+    if (!shellAccessEnabled_) {
+        return ShellCommandResult(false, "", "Shell access is disabled", -1);
     }
     
-    // Create memory record of the command execution
-    std::stringstream memoryContent;
-    memoryContent << "Executed command: " << command << "\n";
-    memoryContent << "Exit code: " << exitCode << "\n";
-    if (!output.empty()) {
-        memoryContent << "Output:\n" << output;
+    // Security check - prevent dangerous commands
+    std::vector<std::string> forbiddenCommands = {"rm -rf /", "format", "fdisk", "mkfs"};
+    for (const auto& forbidden : forbiddenCommands) {
+        if (command.find(forbidden) != std::string::npos) {
+            std::string error = "Command contains forbidden pattern: " + forbidden;
+            logWarning(error);
+            return ShellCommandResult(false, "", error, -1);
+        }
     }
-    if (!error.empty()) {
-        memoryContent << "Error:\n" << error;
+    return std::nullopt;
+}
+
+void AutonomousStarter::submitLoopCommand(const std::string& command) {
+    if (loopCommandsInFlight_.load() >= MAX_LOOP_COMMANDS_IN_FLIGHT) {
+        logInfo("Skipping command while earlier loop commands run: " + command);
+        return;
     }
     
-    auto commandMemory = std::make_shared<Memory>(
-        generateUUID(),
-        memoryContent.str(),
-        generateUUID(), // entity ID
-        config_.agentId
-    );
-    state_.addRecentMessage(commandMemory);
-    
-    bool success = (exitCode == 0 && error.empty());
-    logInfo("Command completed with exit code: " + std::to_string(exitCode));
-    
-    return ShellCommandResult(success, output, error, exitCode);
+    // The result lands in memory on completion, where later steps read it
+    loopCommandsInFlight_++;
+    startCommand(command, true);
 }
 
 void AutonomousStarter::startAutonomousLoop() {
@@ -184,7 +244,7 @@ void AutonomousStarter::startAutonomousLoop() {
                 std::to_string(loopInterval_.count()) + "ms");
     
     // Add memory about starting autonomous mode
-    auto autonomousMemory = std::make_shared<Memory>(
+    auto autonomousMemory = makeMemory(
         generateUUID(),
         "Autonomous mode activated. I am now operating independently, "
         "analyzing my environment and making decisions autonomously.",
@@ -202,7 +262,7 @@ void AutonomousStarter::stopAutonomousLoop() {
         logInfo("Autonomous loop stopped");
         
         // Add memory about stopping autonomous mode
-        auto stopMemory = std::make_shared<Memory>(
+        auto stopMemory = makeMemory(
             generateUUID(),
             "Autonomous mode deactivated. Loop has been stopped for debugging or manual control.",
             generateUUID(),
@@ -230,17 +290,8 @@ void AutonomousStarter::setLoopInterval(std::chrono::milliseconds interval) {
 std::shared_ptr<void> AutonomousStarter::perceptionStep(std::shared_ptr<void> input) {
     // Perception phase - gather information about current environment
     
-    // Get current directory contents
-    auto result = executeShellCommand("ls -la");
-    if (result.success) {
-        logInfo("Perception: Current directory contents analyzed");
-    }
-    
-    // Check system status
-    auto statusResult = executeShellCommand("df -h . && free -h");
-    if (statusResult.success) {
-        logInfo("Perception: System resources analyzed");
-    }
+    // Directory contents and system status; results arrive as memories
+    submitLoopCommand("ls -la && df -h . && free -h");
     
     return input;
 }
@@ -277,15 +328,15 @@ std::shared_ptr<void> AutonomousStarter::actionStep(std::shared_ptr<void> input)
     switch (actionCounter % 3) {
         case 0:
             // Explore current directory
-            executeShellCommand("pwd && ls -la");
+            submitLoopCommand("pwd && ls -la");
             break;
         case 1:
             // Check system status
-            executeShellCommand("whoami && uname -a");
+            submitLoopCommand("whoami && uname -a");
             break;
         case 2:
             // Look for interesting files
-            executeShellCommand("find . -name '*.cpp' -o -name '*.hpp' | head -5");
+            submitLoopCommand("find . -name '*.cpp' -o -name '*.hpp' | head -5");
             break;
     }
     
@@ -1,8 +1,13 @@
 #include <gtest/gtest.h>
 #include "elizaos/autonomous_starter.hpp"
 #include "elizaos/agentlogger.hpp"
+#include "elizaos/process_runner.hpp"
 #include <thread>
 #include <chrono>
+#include <csignal>
+#include <fstream>
+#include <string>
+#include <sys/types.h>
 
 using namespace elizaos;
 
@@ -170,6 +175,138 @@ TEST_F(AutonomousStarterTest, WorkingDirectoryTracking) {
     EXPECT_FALSE(currentDir.empty());
 }
 
+TEST_F(AutonomousStarterTest, CommandLimitsAndDirectoryChanges) {
+    agent->start();
+    
+    // A hung command is killed at its deadline instead of blocking the caller
+    agent->setCommandTimeout(std::chrono::milliseconds(200));
+    auto start = std::chrono::steady_clock::now();
+    auto result = agent->executeShellCommand("sleep 10");
+    EXPECT_FALSE(result.success);
+    EXPECT_NE(result.error.find("timed out"), std::string::npos);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    agent->setCommandTimeout(std::chrono::seconds(30));
+    
+    // stderr is captured alongside stdout
+    result = agent->executeShellCommand("echo out; echo err >&2");
+    EXPECT_TRUE(result.success);
+    EXPECT_EQ(result.output, "out\n");
+    EXPECT_EQ(result.error, "err\n");
+    
+    // cd moves later commands
+    result = agent->executeShellCommand("cd /");
+    EXPECT_TRUE(result.success);
+    EXPECT_TRUE(result.output.empty());
+    EXPECT_EQ(agent->getCurrentWorkingDirectory(), "/");
+    EXPECT_EQ(agent->executeShellCommand("pwd").output, "/\n");
+    
+    auto pending = agent->executeShellCommandAsync("sleep 0.1; echo later");
+    EXPECT_EQ(pending.wait_for(std::chrono::seconds(0)), std::future_status::timeout);
+    EXPECT_EQ(pending.get().output, "later\n");
+}
+
+TEST(ProcessRunnerTest, CapturesStreamsAndExitStatus) {
+    ProcessRunner runner;
+    
+    auto result = runner.runShell("echo hello; echo oops >&2; exit 3").get();
+    EXPECT_TRUE(result.spawned);
+    EXPECT_EQ(result.exitCode, 3);
+    EXPECT_FALSE(result.succeeded());
+    EXPECT_EQ(result.output, "hello\n");
+    EXPECT_EQ(result.error, "oops\n");
+    
+    ProcessOptions options;
+    options.workingDirectory = "/";
+    result = runner.run({"pwd"}, options).get();
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_EQ(result.output, "/\n");
+    
+    result = runner.run({"/nonexistent/elizaos-binary"}).get();
+    EXPECT_FALSE(result.spawned);
+    EXPECT_FALSE(result.error.empty());
+}
+
+TEST(ProcessRunnerTest, DeadlineKillsWholeProcessGroup) {
+    ProcessRunner runner;
+    ProcessOptions options;
+    options.timeout = std::chrono::milliseconds(200);
+    options.killGrace = std::chrono::milliseconds(200);
+    
+    // Both sleeps ignore SIGTERM and the background one holds the pipes open
+    auto start = std::chrono::steady_clock::now();
+    auto result = runner.runShell("trap '' TERM; sleep 30 & sleep 30", options).get();
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_EQ(result.signal, SIGKILL);
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+namespace {
+
+// A killed process stays a zombie until its new parent reaps it
+bool processAlive(pid_t pid) {
+    if (kill(pid, 0) != 0) return false;
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string line;
+    if (!std::getline(stat, line)) return true;
+    size_t end = line.rfind(')');
+    return end == std::string::npos || end + 2 >= line.size() || line[end + 2] != 'Z';
+}
+
+} // anonymous namespace
+
+TEST(ProcessRunnerTest, DeadlineKillsGroupEvenWhenLeaderDiesOfTerm) {
+    ProcessRunner runner;
+    ProcessOptions options;
+    options.timeout = std::chrono::milliseconds(200);
+    options.killGrace = std::chrono::seconds(5);
+
+    // The shell dies of SIGTERM, leaving a child that ignores it
+    auto result = runner.runShell("(trap '' TERM; exec sleep 7) & echo $!; sleep 30", options).get();
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_EQ(result.signal, SIGTERM);
+    pid_t straggler = static_cast<pid_t>(std::stol(result.output));
+    ASSERT_GT(straggler, 0);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (processAlive(straggler) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_FALSE(processAlive(straggler));
+}
+
+TEST(ProcessRunnerTest, KeepsTailOfLongOutputAndStreamsAll) {
+    ProcessRunner runner;
+    ProcessOptions options;
+    options.maxOutputBytes = 1000;
+    size_t streamed = 0;
+    options.onOutput = [&streamed](ProcessStream stream, std::string_view chunk) {
+        if (stream == ProcessStream::STDOUT) streamed += chunk.size();
+    };
+    
+    auto result = runner.runShell("head -c 200000 /dev/zero | tr '\\0' x; printf END", options).get();
+    EXPECT_TRUE(result.succeeded());
+    EXPECT_TRUE(result.truncated());
+    EXPECT_EQ(result.outputBytes, 200003u);
+    EXPECT_EQ(streamed, 200003u);
+    ASSERT_EQ(result.output.size(), 1000u);
+    EXPECT_EQ(result.output.substr(994), "xxxEND");
+}
+
+TEST(ProcessRunnerTest, QueuesBeyondConcurrencyLimit) {
+    ProcessRunner runner(2);
+    std::vector<std::future<ProcessResult>> results;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 4; ++i) {
+        results.push_back(runner.runShell("sleep 0.2; echo " + std::to_string(i)));
+    }
+    EXPECT_LE(runner.runningCount(), 2u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(results[i].get().output, std::to_string(i) + "\n");
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(400));
+    EXPECT_EQ(runner.queuedCount(), 0u);
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
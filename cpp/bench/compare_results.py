@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Compare two elizaos-bench JSON result files.
+
+Usage:
+    compare_results.py BASELINE.json CONTENDER.json [--threshold 0.05] [--metric cpu_time]
+
+Benchmarks are matched by name. When the files contain repetitions, the
+median aggregate is used; otherwise the single run is. Exits with status 1
+when any benchmark regressed by more than the threshold, so the script can
+gate CI.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as handle:
+        data = json.load(handle)
+
+    runs = {}
+    for entry in data.get("benchmarks", []):
+        if entry.get("error_occurred"):
+            continue
+        name = entry.get("run_name", entry["name"])
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") != "median":
+                continue
+        elif name in runs:
+            # Plain repetitions without aggregates: keep the first run
+            continue
+        runs[name] = entry
+    return data.get("context", {}), runs
+
+
+def describe(context):
+    return "{} ({}, seed {})".format(
+        context.get("elizaos_version", "?"),
+        context.get("elizaos_build_type", "?"),
+        context.get("workload_seed", "?"),
+    )
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("contender")
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative slowdown reported as a regression (default 0.05)")
+    parser.add_argument("--metric", choices=["cpu_time", "real_time"], default="cpu_time")
+    args = parser.parse_args()
+
+    base_context, base = load(args.baseline)
+    new_context, new = load(args.contender)
+
+    print("baseline:  " + describe(base_context))
+    print("contender: " + describe(new_context))
+    if base_context.get("workload_seed") != new_context.get("workload_seed"):
+        print("warning: workloads were generated from different seeds")
+    print()
+
+    width = max([len(name) for name in base] + [9])
+    print("{:<{w}}  {:>14}  {:>14}  {:>8}".format("Benchmark", "Baseline", "Contender", "Change", w=width))
+
+    regressions = []
+    for name, before in base.items():
+        after = new.get(name)
+        if after is None:
+            print("{:<{w}}  {:>14}".format(name, "(missing)", w=width))
+            continue
+        if before.get("time_unit") != after.get("time_unit"):
+            print("{:<{w}}  time units differ, skipped".format(name, w=width))
+            continue
+
+        old_time = before[args.metric]
+        new_time = after[args.metric]
+        change = (new_time - old_time) / old_time if old_time else 0.0
+        marker = ""
+        if change > args.threshold:
+            marker = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            marker = "  improved"
+
+        unit = before.get("time_unit", "ns")
+        print("{:<{w}}  {:>11.3f} {:<2}  {:>11.3f} {:<2}  {:>+7.1%}{}".format(
+            name, old_time, unit, new_time, unit, change, marker, w=width))
+
+    for name in new:
+        if name not in base:
+            print("{:<{w}}  {:>14}".format(name, "(new)", w=width))
+
+    if regressions:
+        print("\n{} benchmark(s) regressed by more than {:.0%}".format(len(regressions), args.threshold))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
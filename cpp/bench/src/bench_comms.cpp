@@ -0,0 +1,67 @@
+#include "workloads.hpp"
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// End-to-end channel throughput: queue a batch of messages and wait until
+// the channel's worker has handed every one of them to the handler.
+// Args: {messages per batch}
+void BM_CommChannelThroughput(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    auto messages = makeMessageStream(count, "bench-channel");
+
+    CommChannel channel("bench-channel", "bench-server");
+    std::atomic<size_t> handled{0};
+    channel.setMessageHandler([&handled](const Message&) { handled.fetch_add(1, std::memory_order_relaxed); });
+    channel.start();
+
+    size_t expected = 0;
+    for (auto _ : state) {
+        for (const auto& message : messages) {
+            channel.sendMessage(message);
+        }
+        expected += count;
+        while (handled.load(std::memory_order_relaxed) < expected) {
+            std::this_thread::yield();
+        }
+    }
+    channel.stop();
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_CommChannelThroughput)->RangeMultiplier(8)->Range(1 << 6, 1 << 12)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Producer-side cost: validation plus enqueue, timed without waiting for the
+// channel worker to drain the queue
+void BM_CommChannelSend(benchmark::State& state) {
+    auto messages = makeMessageStream(1024, "bench-channel");
+    int64_t sent = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        CommChannel channel("bench-channel", "bench-server");
+        channel.start();
+        state.ResumeTiming();
+
+        for (const auto& message : messages) {
+            benchmark::DoNotOptimize(channel.sendMessage(message));
+        }
+        sent += static_cast<int64_t>(messages.size());
+
+        state.PauseTiming();
+        channel.stop();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(sent);
+}
+BENCHMARK(BM_CommChannelSend)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,52 @@
+#include "workloads.hpp"
+#include "elizaos/eliza.hpp"
+#include <benchmark/benchmark.h>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Registers `extra` synthetic patterns on top of the defaults
+void addSyntheticPatterns(ResponseGenerator& generator, size_t extra) {
+    WorkloadRng rng(DEFAULT_SEED + 1);
+    for (size_t i = 0; i < extra; ++i) {
+        std::string keyword = makeSentence(rng, 1, 1);
+        std::string pattern = "\\b" + keyword + "\\b.*\\b" + makeSentence(rng, 1, 1) + "\\b";
+        generator.addPattern(ResponsePattern(pattern, {"Tell me more about " + keyword + "."}, "synthetic"));
+    }
+}
+
+// Args: {extra patterns}
+void BM_ResponseMatching(benchmark::State& state) {
+    ResponseGenerator generator;
+    addSyntheticPatterns(generator, static_cast<size_t>(state.range(0)));
+    auto utterances = makeUtterances(256);
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generator.getMatchingPatterns(utterances[next++ % utterances.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResponseMatching)->Arg(0)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+// Args: {extra patterns}
+void BM_ResponseGeneration(benchmark::State& state) {
+    ResponseGenerator generator;
+    addSyntheticPatterns(generator, static_cast<size_t>(state.range(0)));
+    auto utterances = makeUtterances(256);
+    ConversationContext context("bench-session", "bench-user");
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(generator.generateResponse(utterances[next++ % utterances.size()], context));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ResponseGeneration)->Arg(0)->Arg(64)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,104 @@
+#include "workloads.hpp"
+#include "elizaos/atomspace_matcher.hpp"
+#include <benchmark/benchmark.h>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Args: {rules, fanout, max depth}
+void BM_ForwardChain(benchmark::State& state) {
+    size_t rules = static_cast<size_t>(state.range(0));
+    size_t fanout = static_cast<size_t>(state.range(1));
+    int depth = static_cast<int>(state.range(2));
+
+    PLNInferenceEngine engine;
+    for (const auto& rule : makeRuleSet(rules, fanout)) {
+        engine.addRule(rule);
+    }
+    State agentState(makeAgentConfig());
+    std::string root = ruleSetRootFact();
+
+    size_t derived = 0;
+    for (auto _ : state) {
+        auto results = engine.forwardChain(agentState, root, depth);
+        derived = results.size();
+        benchmark::DoNotOptimize(results);
+    }
+    state.counters["derived"] = static_cast<double>(derived);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(derived));
+}
+BENCHMARK(BM_ForwardChain)
+    ->ArgsProduct({{16, 64, 256, 1024}, {2, 4}, {3, 5}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Args: {rules}
+void BM_BackwardChain(benchmark::State& state) {
+    size_t rules = static_cast<size_t>(state.range(0));
+
+    PLNInferenceEngine engine;
+    for (const auto& rule : makeRuleSet(rules, 2)) {
+        engine.addRule(rule);
+    }
+    State agentState(makeAgentConfig());
+
+    // The deepest derived fact, so the chain has to walk back to the root
+    auto chain = engine.forwardChain(agentState, ruleSetRootFact(), 64);
+    std::string goal = chain.empty() ? ruleSetRootFact() : chain.back().conclusion;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.backwardChain(agentState, goal, 5));
+    }
+}
+BENCHMARK(BM_BackwardChain)->RangeMultiplier(4)->Range(16, 1024)->Unit(benchmark::kMicrosecond);
+
+// Args: {atoms}; a quarter are people (one in ten a Robot), each knowing two
+// others and liking one of 64 topics. The query joins four clauses over
+// three variables: robots two hops from someone who likes one topic
+void BM_AtomSpacePatternQuery(benchmark::State& state) {
+    const size_t people = static_cast<size_t>(state.range(0)) / 4;
+    constexpr size_t TOPICS = 64;
+
+    WorkloadRng rng(DEFAULT_SEED + 12);
+    std::vector<std::shared_ptr<HypergraphNode>> nodes;
+    std::vector<std::shared_ptr<HypergraphEdge>> edges;
+    for (size_t i = 0; i < TOPICS; ++i) {
+        nodes.push_back(std::make_shared<HypergraphNode>("topic-" + std::to_string(i), "Topic"));
+    }
+    for (size_t i = 0; i < people; ++i) {
+        nodes.push_back(std::make_shared<HypergraphNode>("p-" + std::to_string(i), i % 10 == 0 ? "Robot" : "Person"));
+    }
+    for (size_t i = 0; i < people; ++i) {
+        std::string id = "p-" + std::to_string(i);
+        for (int k = 0; k < 2; ++k) {
+            edges.push_back(std::make_shared<HypergraphEdge>(id + "-k" + std::to_string(k), "knows",
+                                                             std::vector<UUID>{id, "p-" + std::to_string(rng.below(people))}));
+        }
+        edges.push_back(std::make_shared<HypergraphEdge>(id + "-l", "likes",
+                                                         std::vector<UUID>{id, "topic-" + std::to_string(rng.below(TOPICS))}));
+    }
+
+    AtomSpacePatternMatcher matcher;
+    matcher.setAtomSpace(nodes, edges);
+
+    AtomSpacePattern pattern("AND");
+    pattern.subpatterns.emplace_back("Robot", std::vector<std::string>{"?X"});
+    pattern.subpatterns.emplace_back("knows", std::vector<std::string>{"?X", "?Y"});
+    pattern.subpatterns.emplace_back("knows", std::vector<std::string>{"?Y", "?Z"});
+    pattern.subpatterns.emplace_back("likes", std::vector<std::string>{"?Z", "topic-7"});
+
+    size_t matches = 0;
+    for (auto _ : state) {
+        auto results = matcher.query(pattern);
+        matches = results.size();
+        benchmark::DoNotOptimize(results);
+    }
+    state.counters["matches"] = static_cast<double>(matches);
+}
+BENCHMARK(BM_AtomSpacePatternQuery)->RangeMultiplier(10)->Range(10000, 1000000)->Unit(benchmark::kMillisecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,121 @@
+#include "workloads.hpp"
+#include "elizaos/json.hpp"
+#include <benchmark/benchmark.h>
+#include <any>
+#include <unordered_map>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Array of plugin-result-like records, about 150 bytes each
+std::string makeJsonPayload(size_t records) {
+    WorkloadRng rng(DEFAULT_SEED + 2);
+    json::Value payload = json::Value::array();
+    for (size_t i = 0; i < records; ++i) {
+        json::Value record;
+        record["id"] = Uuid::v4().toString();
+        record["success"] = rng.below(8) != 0;
+        record["message"] = makeSentence(rng, 3, 10);
+        record["executionTimeMs"] = rng.below(5000);
+        record["score"] = rng.uniform();
+        record["tags"] = std::vector<std::string>{makeSentence(rng, 1, 1), makeSentence(rng, 1, 1)};
+        payload.push_back(std::move(record));
+    }
+    return json::write(payload);
+}
+
+class NullHandler : public json::Handler {
+public:
+    bool onNull() override { return true; }
+    bool onBool(bool) override { return true; }
+    bool onInteger(int64_t) override { return true; }
+    bool onDouble(double) override { return true; }
+    bool onString(std::string_view) override { return true; }
+    bool onStartObject() override { return true; }
+    bool onKey(std::string_view) override { return true; }
+    bool onEndObject() override { return true; }
+    bool onStartArray() override { return true; }
+    bool onEndArray() override { return true; }
+};
+
+// Args: {records}
+void BM_JsonParseSax(benchmark::State& state) {
+    std::string text = makeJsonPayload(static_cast<size_t>(state.range(0)));
+    NullHandler handler;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::parse(text, handler));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_JsonParseSax)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+// Args: {records}
+void BM_JsonParseTree(benchmark::State& state) {
+    std::string text = makeJsonPayload(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(json::parse(text));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_JsonParseTree)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+// Args: {records}
+void BM_JsonParseDocument(benchmark::State& state) {
+    std::string text = makeJsonPayload(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        json::Document document;
+        benchmark::DoNotOptimize(document.parse(text));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_JsonParseDocument)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+// Args: {records}
+void BM_JsonWrite(benchmark::State& state) {
+    auto value = json::parse(makeJsonPayload(static_cast<size_t>(state.range(0))));
+    std::string out;
+    for (auto _ : state) {
+        out.clear();
+        json::write(*value, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(out.size()));
+}
+BENCHMARK(BM_JsonWrite)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond);
+
+// Build and read back a small action-argument object, the shape that action
+// dispatch and plugin hooks pass around, against the std::any map it replaced
+void BM_ActionArgumentsAnyMap(benchmark::State& state) {
+    for (auto _ : state) {
+        std::unordered_map<std::string, std::any> arguments;
+        arguments["target"] = std::string("north gate");
+        arguments["speed"] = 2.5;
+        arguments["count"] = 3;
+        arguments["urgent"] = true;
+        benchmark::DoNotOptimize(std::any_cast<double>(arguments.at("speed")) +
+                                 std::any_cast<int>(arguments.at("count")) +
+                                 std::any_cast<std::string>(arguments.at("target")).size());
+    }
+}
+BENCHMARK(BM_ActionArgumentsAnyMap);
+
+void BM_ActionArgumentsValue(benchmark::State& state) {
+    for (auto _ : state) {
+        json::Value arguments = json::Value::object();
+        arguments.asObject().reserve(4);
+        arguments["target"] = "north gate";
+        arguments["speed"] = 2.5;
+        arguments["count"] = 3;
+        arguments["urgent"] = true;
+        benchmark::DoNotOptimize(arguments.getDouble("speed") + arguments.getInt("count") +
+                                 arguments.at("target").asString().size());
+    }
+}
+BENCHMARK(BM_ActionArgumentsValue);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
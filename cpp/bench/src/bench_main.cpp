@@ -0,0 +1,26 @@
+#include "workloads.hpp"
+#include <benchmark/benchmark.h>
+#include <string>
+
+#ifndef ELIZAOS_BENCH_VERSION
+#define ELIZAOS_BENCH_VERSION "unknown"
+#endif
+
+#ifndef ELIZAOS_BENCH_BUILD_TYPE
+#define ELIZAOS_BENCH_BUILD_TYPE "unknown"
+#endif
+
+// Recorded in the JSON "context" block so compare_results.py can tell which
+// builds and workloads two result files came from
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+
+    benchmark::AddCustomContext("elizaos_version", ELIZAOS_BENCH_VERSION);
+    benchmark::AddCustomContext("elizaos_build_type", ELIZAOS_BENCH_BUILD_TYPE);
+    benchmark::AddCustomContext("workload_seed", std::to_string(elizaos::bench::DEFAULT_SEED));
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
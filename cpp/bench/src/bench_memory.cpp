@@ -0,0 +1,135 @@
+#include "workloads.hpp"
+#include "elizaos/agentmemory.hpp"
+#include <benchmark/benchmark.h>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Args: {memories, embedding dimensions}
+void BM_MemorySearch(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    size_t dimensions = static_cast<size_t>(state.range(1));
+
+    AgentMemoryManager manager;
+    for (auto& memory : makeMemories(count, dimensions)) {
+        manager.createMemory(memory);
+    }
+
+    MemorySearchByEmbeddingParams params;
+    params.embedding = makeQueryEmbedding(dimensions);
+    params.matchThreshold = 0.5;
+    params.count = 10;
+
+    size_t matched = 0;
+    for (auto _ : state) {
+        auto results = manager.searchMemories(params);
+        matched = results.size();
+        benchmark::DoNotOptimize(results);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.counters["matched"] = static_cast<double>(matched);
+}
+BENCHMARK(BM_MemorySearch)
+    ->ArgsProduct({benchmark::CreateRange(1 << 10, 1 << 14, 4), {64, 384}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Same search narrowed to one room, which should not scan the whole table
+void BM_MemorySearchByRoom(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+
+    AgentMemoryManager manager;
+    auto memories = makeMemories(count, 128);
+    for (auto& memory : memories) {
+        manager.createMemory(memory);
+    }
+
+    MemorySearchByEmbeddingParams params;
+    params.embedding = makeQueryEmbedding(128);
+    params.matchThreshold = 0.5;
+    params.roomId = memories.front()->getRoomId();
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(manager.searchMemories(params));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MemorySearchByRoom)->RangeMultiplier(4)->Range(1 << 10, 1 << 14)->Unit(benchmark::kMicrosecond);
+
+// Args: {memories per batch}
+void BM_MemoryCreate(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    auto memories = makeMemories(count, 128);
+
+    for (auto _ : state) {
+        AgentMemoryManager manager;
+        for (auto& memory : memories) {
+            benchmark::DoNotOptimize(manager.createMemory(memory));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MemoryCreate)->RangeMultiplier(8)->Range(1 << 6, 1 << 12)->Unit(benchmark::kMicrosecond);
+
+// Args: {memories, unique}; one createMemory() call per memory
+void BM_MemoryImportSequential(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    bool unique = state.range(1) != 0;
+    auto memories = makeMemories(count, 128);
+
+    for (auto _ : state) {
+        AgentMemoryManager manager;
+        for (auto& memory : memories) {
+            benchmark::DoNotOptimize(manager.createMemory(memory, "memories", unique));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MemoryImportSequential)
+    ->ArgsProduct({{1 << 14, 1 << 17}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Same import through createMemories()
+void BM_MemoryImportBulk(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    bool unique = state.range(1) != 0;
+    auto memories = makeMemories(count, 128);
+
+    for (auto _ : state) {
+        AgentMemoryManager manager;
+        benchmark::DoNotOptimize(manager.createMemories(memories, "memories", unique));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_MemoryImportBulk)
+    ->ArgsProduct({{1 << 14, 1 << 17}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+// Args: {live queries}; each write is matched against every query on its table
+void BM_MemoryCreateWithLiveQueries(benchmark::State& state) {
+    size_t queries = static_cast<size_t>(state.range(0));
+    auto memories = makeMemories(1 << 10, 128);
+
+    AgentMemoryManager manager;
+    size_t delivered = 0;
+    for (size_t i = 0; i < queries; ++i) {
+        LiveQuery query;
+        query.roomId = memories[i % memories.size()]->getRoomId();
+        manager.subscribeLiveQuery(query, [&delivered](const LiveQueryEvent&) { ++delivered; });
+    }
+
+    for (auto _ : state) {
+        for (auto& memory : memories) {
+            benchmark::DoNotOptimize(manager.createMemory(memory));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(memories.size()));
+    state.counters["delivered"] = benchmark::Counter(static_cast<double>(delivered), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_MemoryCreateWithLiveQueries)->Arg(0)->Arg(16)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
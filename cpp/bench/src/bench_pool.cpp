@@ -0,0 +1,124 @@
+#include "workloads.hpp"
+#include "elizaos/agentcomms.hpp"
+#include "elizaos/pool.hpp"
+#include <benchmark/benchmark.h>
+#include <deque>
+#include <queue>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+constexpr size_t LIVE_OBJECTS = 256;       // Churned per iteration
+
+// Allocation churn of Memory objects the way ingest and retrieval create and
+// drop them, with make_shared against the pooled makeMemory
+void BM_MemoryAllocMakeShared(benchmark::State& state) {
+    std::vector<std::shared_ptr<Memory>> live(LIVE_OBJECTS);
+    for (auto _ : state) {
+        for (auto& memory : live) {
+            memory = std::make_shared<Memory>("bench-memory", "pooled content", "entity", "agent");
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LIVE_OBJECTS));
+}
+BENCHMARK(BM_MemoryAllocMakeShared)->ThreadRange(1, 8);
+
+void BM_MemoryAllocPooled(benchmark::State& state) {
+    std::vector<std::shared_ptr<Memory>> live(LIVE_OBJECTS);
+    for (auto _ : state) {
+        for (auto& memory : live) {
+            memory = makeMemory("bench-memory", "pooled content", "entity", "agent");
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LIVE_OBJECTS));
+}
+BENCHMARK(BM_MemoryAllocPooled)->ThreadRange(1, 8);
+
+// Queue of messages as a channel holds them, default against pooled nodes
+template <typename Queue>
+void messageQueueChurn(benchmark::State& state) {
+    Message message("bench-message", MessageType::TEXT, "sender", "receiver", "channel", "queued content");
+    Queue queue;
+    for (auto _ : state) {
+        for (size_t i = 0; i < LIVE_OBJECTS; ++i) queue.push(message);
+        while (!queue.empty()) {
+            Message taken = std::move(queue.front());
+            queue.pop();
+            benchmark::DoNotOptimize(taken.content.data());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LIVE_OBJECTS));
+}
+
+void BM_MessageQueueDefault(benchmark::State& state) {
+    messageQueueChurn<std::queue<Message>>(state);
+}
+BENCHMARK(BM_MessageQueueDefault)->ThreadRange(1, 8);
+
+void BM_MessageQueuePooled(benchmark::State& state) {
+    messageQueueChurn<std::queue<Message, std::deque<Message, PoolAllocator<Message>>>>(state);
+}
+BENCHMARK(BM_MessageQueuePooled)->ThreadRange(1, 8);
+
+struct Counted : RefCounted<Counted> {
+    int value = 0;
+};
+
+// Handing a reference to another owner and dropping it
+void BM_RefCopySharedPtr(benchmark::State& state) {
+    auto object = std::make_shared<Counted>();
+    for (auto _ : state) {
+        std::shared_ptr<Counted> copy = object;
+        benchmark::DoNotOptimize(copy.get());
+    }
+}
+BENCHMARK(BM_RefCopySharedPtr)->ThreadRange(1, 8);
+
+void BM_RefCopyIntrusivePtr(benchmark::State& state) {
+    auto object = makeIntrusive<Counted>();
+    for (auto _ : state) {
+        IntrusivePtr<Counted> copy = object;
+        benchmark::DoNotOptimize(copy.get());
+    }
+}
+BENCHMARK(BM_RefCopyIntrusivePtr)->ThreadRange(1, 8);
+
+// Copying one batch of sentences, heap strings against a generation arena
+// retired after every batch
+void BM_BatchStringsHeap(benchmark::State& state) {
+    WorkloadRng rng(DEFAULT_SEED);
+    std::vector<std::string> sentences;
+    for (size_t i = 0; i < LIVE_OBJECTS; ++i) sentences.push_back(makeSentence(rng, 8, 40));
+    for (auto _ : state) {
+        std::vector<std::string> batch(sentences.begin(), sentences.end());
+        benchmark::DoNotOptimize(batch.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LIVE_OBJECTS));
+}
+BENCHMARK(BM_BatchStringsHeap);
+
+void BM_BatchStringsArena(benchmark::State& state) {
+    WorkloadRng rng(DEFAULT_SEED);
+    std::vector<std::string> sentences;
+    for (size_t i = 0; i < LIVE_OBJECTS; ++i) sentences.push_back(makeSentence(rng, 8, 40));
+    GenerationArena arena;
+    std::vector<std::string_view> batch;
+    batch.reserve(LIVE_OBJECTS);
+    for (auto _ : state) {
+        batch.clear();
+        for (const auto& sentence : sentences) batch.push_back(arena.copy(sentence));
+        benchmark::DoNotOptimize(batch.data());
+        arena.retire(arena.advance());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LIVE_OBJECTS));
+}
+BENCHMARK(BM_BatchStringsArena);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,64 @@
+#include "workloads.hpp"
+#include "elizaos/hyperfy_replication.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+using namespace elizaos::hyperfy;
+
+constexpr size_t CLIENTS = 16;
+constexpr size_t MOVERS_PER_TICK = 256;
+constexpr double AREA_PER_ENTITY = 16.0;    // Square metres, so density is fixed
+
+// Args: {entities}; one tick of moves, then a snapshot, decode and ack per client
+void BM_ReplicationTick(benchmark::State& state) {
+    const size_t population = static_cast<size_t>(state.range(0));
+    const double side = std::sqrt(population * AREA_PER_ENTITY);
+    ReplicationConfig config;
+    config.interestRadius = 16.0f;
+    ReplicationServer server(config);
+
+    WorkloadRng rng(DEFAULT_SEED + 11);
+    std::vector<EntityId> entities;
+    std::vector<EntityState> states;
+    for (size_t i = 0; i < population; ++i) {
+        EntityState entity;
+        entity.position = {static_cast<float>(rng.uniform(0, side)), 0.0f, static_cast<float>(rng.uniform(0, side))};
+        entities.push_back(server.spawnEntity(entity));
+        states.push_back(entity);
+    }
+    std::vector<std::pair<ClientId, std::unique_ptr<ReplicationClient>>> clients;
+    for (size_t i = 0; i < CLIENTS; ++i) {
+        clients.emplace_back(server.addClient(entities[rng.below(population)]), std::make_unique<ReplicationClient>(config));
+    }
+
+    size_t bytes = 0;
+    for (auto _ : state) {
+        for (size_t i = 0; i < MOVERS_PER_TICK; ++i) {
+            size_t index = rng.below(population);
+            states[index].position.x += 0.1f;
+            states[index].yaw += 0.05f;
+            server.updateEntity(entities[index], states[index]);
+        }
+        for (auto& [id, client] : clients) {
+            std::string snapshot = server.buildSnapshot(id);
+            bytes += snapshot.size();
+            client->applySnapshot(snapshot);
+            server.receive(id, client->buildUpdate());
+        }
+        server.advanceTick();
+    }
+    state.counters["bytes_per_client"] = benchmark::Counter(
+        static_cast<double>(bytes) / (static_cast<double>(state.iterations()) * CLIENTS));
+    state.SetItemsProcessed(state.iterations() * CLIENTS);
+}
+BENCHMARK(BM_ReplicationTick)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,119 @@
+#include "elizaos/executor.hpp"
+#include "elizaos/metrics.hpp"
+#include "elizaos/uuid.hpp"
+#include <benchmark/benchmark.h>
+#include <unordered_map>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Fork/join of small tasks. Args: {tasks per batch}
+void BM_ExecutorFanOut(benchmark::State& state) {
+    Executor& executor = Executor::global();
+    size_t tasks = static_cast<size_t>(state.range(0));
+
+    for (auto _ : state) {
+        std::vector<Future<size_t>> futures;
+        futures.reserve(tasks);
+        for (size_t i = 0; i < tasks; ++i) {
+            futures.push_back(executor.submit([i] { return i * i; }));
+        }
+        benchmark::DoNotOptimize(whenAll(std::move(futures)).get());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(tasks));
+}
+BENCHMARK(BM_ExecutorFanOut)->RangeMultiplier(8)->Range(8, 4096)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Chain of dependent continuations. Args: {chain length}
+void BM_ExecutorContinuationChain(benchmark::State& state) {
+    Executor& executor = Executor::global();
+    int64_t length = state.range(0);
+
+    for (auto _ : state) {
+        Future<int64_t> future = executor.submit([] { return int64_t(0); });
+        for (int64_t i = 0; i < length; ++i) {
+            future = future.then([](int64_t value) { return value + 1; });
+        }
+        benchmark::DoNotOptimize(future.get());
+    }
+    state.SetItemsProcessed(state.iterations() * length);
+}
+BENCHMARK(BM_ExecutorContinuationChain)->RangeMultiplier(8)->Range(8, 512)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// Contended hot-path instrumentation
+void BM_CounterIncrement(benchmark::State& state) {
+    static Counter counter;
+    for (auto _ : state) {
+        counter.increment();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CounterIncrement)->ThreadRange(1, 8);
+
+void BM_HistogramRecord(benchmark::State& state) {
+    static Histogram histogram;
+    uint64_t value = 1 + static_cast<uint64_t>(state.thread_index());
+    for (auto _ : state) {
+        histogram.record(value);
+        value = value * 6364136223846793005ULL + 1442695040888963407ULL;
+        value >>= 40;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HistogramRecord)->ThreadRange(1, 8);
+
+void BM_TraceSpan(benchmark::State& state) {
+    for (auto _ : state) {
+        TraceSpan span("bench.span");
+        benchmark::DoNotOptimize(span.getId());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TraceSpan)->ThreadRange(1, 8);
+
+void BM_UuidGenerateV4(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Uuid::v4());
+    }
+}
+BENCHMARK(BM_UuidGenerateV4);
+
+void BM_UuidGenerateV7(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Uuid::v7());
+    }
+}
+BENCHMARK(BM_UuidGenerateV7);
+
+// Id-keyed lookup with string keys versus 128-bit keys. Args: {entries}
+template <typename Key, typename MakeKey>
+void idLookup(benchmark::State& state, MakeKey makeKey) {
+    std::unordered_map<Key, size_t> index;
+    std::vector<Key> keys;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        keys.push_back(makeKey());
+        index.emplace(keys.back(), static_cast<size_t>(i));
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(index.find(keys[next++ % keys.size()]));
+    }
+}
+
+void BM_IdLookupString(benchmark::State& state) {
+    idLookup<std::string>(state, [] { return Uuid::v4().toString(); });
+}
+BENCHMARK(BM_IdLookupString)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+void BM_IdLookupUuid(benchmark::State& state) {
+    idLookup<Uuid>(state, [] { return Uuid::v4(); });
+}
+BENCHMARK(BM_IdLookupUuid)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,58 @@
+#include "workloads.hpp"
+#include "elizaos/core.hpp"
+#include <benchmark/benchmark.h>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+constexpr size_t MESSAGE_POOL = 256;       // Distinct memories cycled through the ring
+
+// Appending to the recent-message ring, which publishes a new State version
+void BM_StateAddRecentMessage(benchmark::State& state) {
+    State agentState(makeAgentConfig());
+    auto memories = makeMemories(MESSAGE_POOL, 8);
+    size_t next = 0;
+    for (auto _ : state) {
+        agentState.addRecentMessage(memories[next++ % MESSAGE_POOL]);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StateAddRecentMessage);
+
+// Readers walking the recent messages of the current version while thread 0
+// keeps publishing new ones
+void BM_StateReadWhileWriting(benchmark::State& state) {
+    static State* shared = nullptr;
+    static std::vector<std::shared_ptr<Memory>> memories;
+    if (state.thread_index() == 0) {
+        memories = makeMemories(MESSAGE_POOL, 8);
+        shared = new State(makeAgentConfig());
+        for (const auto& memory : memories) shared->addRecentMessage(memory);
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        if (state.thread_index() == 0) {
+            shared->addRecentMessage(memories[next++ % MESSAGE_POOL]);
+        } else {
+            auto version = shared->snapshot();
+            size_t total = 0;
+            for (const auto& memory : version->recentMessages) total += memory->getContent().size();
+            benchmark::DoNotOptimize(total);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+
+    if (state.thread_index() == 0) {
+        delete shared;
+        shared = nullptr;
+    }
+}
+BENCHMARK(BM_StateReadWhileWriting)->ThreadRange(2, 8)->UseRealTime();
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
@@ -0,0 +1,72 @@
+#include "workloads.hpp"
+#include "elizaos/text_entities.hpp"
+#include <benchmark/benchmark.h>
+#include <regex>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+// Page-like prose with an entity in roughly one sentence of eight
+std::string makeEntityText(size_t bytes) {
+    static const char* ENTITIES[] = {"https://elizaos.ai/docs/agents?tab=memory", "ops@eliza.how", "@shaw",
+                                     "#ElizaOS", "+1 (555) 123-4567",
+                                     "0x52908400098527886E0F7030069857D2E4169EE7", "www.example.org"};
+    WorkloadRng rng(DEFAULT_SEED + 7);
+    std::string text;
+    text.reserve(bytes + 128);
+    while (text.size() < bytes) {
+        text += makeSentence(rng, 6, 18);
+        if (rng.below(8) == 0) {
+            text += ' ';
+            text += ENTITIES[rng.below(std::size(ENTITIES))];
+        }
+        text += ". ";
+    }
+    text.resize(bytes);
+    return text;
+}
+
+// Args: {bytes}
+void BM_TextEntityScan(benchmark::State& state) {
+    std::string text = makeEntityText(static_cast<size_t>(state.range(0)));
+    std::vector<TextEntity> entities;
+    for (auto _ : state) {
+        entities.clear();
+        scanTextEntities(text, entities);
+        benchmark::DoNotOptimize(entities.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+    state.SetLabel(textEntityScanKernel());
+}
+BENCHMARK(BM_TextEntityScan)->RangeMultiplier(16)->Range(4 << 10, 1 << 20)->Unit(benchmark::kMicrosecond);
+
+// Args: {bytes}; emails only, against the per-call std::regex it replaced
+void BM_TextEntityEmails(benchmark::State& state) {
+    std::string text = makeEntityText(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(extractTextEntities(text, TextEntityType::EMAIL));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_TextEntityEmails)->Arg(64 << 10)->Unit(benchmark::kMicrosecond);
+
+void BM_TextEntityEmailsRegex(benchmark::State& state) {
+    std::string text = makeEntityText(static_cast<size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::regex email(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+        std::vector<std::string> emails;
+        for (std::sregex_iterator it(text.begin(), text.end(), email), end; it != end; ++it) {
+            emails.push_back(it->str());
+        }
+        benchmark::DoNotOptimize(emails.data());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_TextEntityEmailsRegex)->Arg(64 << 10)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
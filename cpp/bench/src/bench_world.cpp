@@ -0,0 +1,54 @@
+#include "workloads.hpp"
+#include <benchmark/benchmark.h>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+constexpr double WORLD_EXTENT = 500.0;
+
+void populate(ElizasWorld& world, size_t agents) {
+    for (const auto& agent : makeWorldPopulation(agents, WORLD_EXTENT)) {
+        world.addAgent(agent);
+    }
+}
+
+// Args: {agents, query radius}
+void BM_WorldProximityQuery(benchmark::State& state) {
+    ElizasWorld world;
+    populate(world, static_cast<size_t>(state.range(0)));
+    double radius = static_cast<double>(state.range(1));
+
+    WorkloadRng rng(DEFAULT_SEED + 2);
+    std::vector<WorldPosition> probes;
+    for (size_t i = 0; i < 256; ++i) {
+        probes.emplace_back(rng.uniform(-WORLD_EXTENT, WORLD_EXTENT), rng.uniform(-WORLD_EXTENT, WORLD_EXTENT), 0.0);
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(world.getAgentsNearPosition(probes[next++ % probes.size()], radius));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WorldProximityQuery)
+    ->ArgsProduct({benchmark::CreateRange(100, 10000, 10), {10, 50}})
+    ->Unit(benchmark::kMicrosecond);
+
+// Args: {agents}
+void BM_WorldUpdate(benchmark::State& state) {
+    ElizasWorld world;
+    populate(world, static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        world.update(0.1);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WorldUpdate)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMicrosecond);
+
+} // anonymous namespace
+
+} // namespace bench
+} // namespace elizaos
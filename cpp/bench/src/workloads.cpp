@@ -0,0 +1,196 @@
+#include "workloads.hpp"
+#include <cmath>
+#include <cstdio>
+
+namespace elizaos {
+namespace bench {
+
+namespace {
+
+const char* const VOCABULARY[] = {
+    "agent",   "memory",  "market",  "token",   "world",    "signal",  "plan",    "goal",
+    "eliza",   "channel", "message", "trade",   "price",    "vector",  "search",  "reason",
+    "hello",   "thanks",  "please",  "why",     "how",      "what",    "feel",    "think",
+    "happy",   "sad",     "great",   "problem", "question", "answer",  "friend",  "community",
+    "build",   "deploy",  "plugin",  "runtime", "action",   "state",   "rule",    "belief",
+};
+constexpr size_t VOCABULARY_SIZE = sizeof(VOCABULARY) / sizeof(VOCABULARY[0]);
+constexpr double PI = 3.14159265358979323846;
+
+std::string numbered(const char* prefix, size_t index) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%s-%08zu", prefix, index);
+    return buffer;
+}
+
+// Fixed width keeps one fact name from being a substring of another, which
+// PLNInferenceEngine's rule lookup would otherwise treat as a match
+std::string factName(size_t index) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "fact_%06zu", index);
+    return buffer;
+}
+
+void normalize(EmbeddingVector& vector) {
+    double norm = 0.0;
+    for (float value : vector) norm += static_cast<double>(value) * value;
+    if (norm <= 0.0) return;
+    float scale = static_cast<float>(1.0 / std::sqrt(norm));
+    for (float& value : vector) value *= scale;
+}
+
+EmbeddingVector randomDirection(WorkloadRng& rng, size_t dimensions) {
+    EmbeddingVector vector(dimensions);
+    for (float& value : vector) value = static_cast<float>(rng.gaussian());
+    normalize(vector);
+    return vector;
+}
+
+} // anonymous namespace
+
+// WorkloadRng implementation
+WorkloadRng::WorkloadRng(uint64_t seed) : engine_(seed) {}
+
+uint64_t WorkloadRng::next() {
+    return engine_();
+}
+
+double WorkloadRng::uniform() {
+    return static_cast<double>(next() >> 11) * 0x1.0p-53;
+}
+
+double WorkloadRng::uniform(double low, double high) {
+    return low + (high - low) * uniform();
+}
+
+size_t WorkloadRng::below(size_t bound) {
+    return bound == 0 ? 0 : static_cast<size_t>(next() % bound);
+}
+
+double WorkloadRng::gaussian() {
+    // Box-Muller; the second variate is discarded to keep the stream simple
+    double u1 = uniform();
+    double u2 = uniform();
+    if (u1 < 1e-300) u1 = 1e-300;
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(2.0 * PI * u2);
+}
+
+std::string makeSentence(WorkloadRng& rng, size_t minWords, size_t maxWords) {
+    size_t words = minWords + rng.below(maxWords - minWords + 1);
+    std::string sentence;
+    for (size_t i = 0; i < words; ++i) {
+        if (i) sentence += ' ';
+        sentence += VOCABULARY[rng.below(VOCABULARY_SIZE)];
+    }
+    return sentence;
+}
+
+std::vector<std::shared_ptr<Memory>> makeMemories(size_t count, size_t dimensions, uint64_t seed, size_t rooms,
+                                                  size_t clusters) {
+    WorkloadRng rng(seed);
+    std::vector<EmbeddingVector> centres;
+    for (size_t i = 0; i < clusters; ++i) centres.push_back(randomDirection(rng, dimensions));
+
+    std::vector<std::shared_ptr<Memory>> memories;
+    memories.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto memory = makeMemory(numbered("memory", i), makeSentence(rng, 4, 24),
+                             numbered("entity", rng.below(64)), "bench-agent");
+        memory->setRoomId(numbered("room", rng.below(rooms)));
+
+        const EmbeddingVector& centre = centres[rng.below(clusters)];
+        EmbeddingVector embedding(dimensions);
+        for (size_t d = 0; d < dimensions; ++d) {
+            embedding[d] = centre[d] + static_cast<float>(0.35 * rng.gaussian() / std::sqrt(double(dimensions)));
+        }
+        normalize(embedding);
+        memory->setEmbedding(embedding);
+        memories.push_back(std::move(memory));
+    }
+    return memories;
+}
+
+EmbeddingVector makeQueryEmbedding(size_t dimensions, uint64_t seed) {
+    // Queries land near one of the same centres makeMemories uses for `seed`
+    WorkloadRng rng(seed);
+    EmbeddingVector centre = randomDirection(rng, dimensions);
+    WorkloadRng noise(seed ^ 0x9e3779b97f4a7c15ULL);
+    for (float& value : centre) value += static_cast<float>(0.1 * noise.gaussian() / std::sqrt(double(dimensions)));
+    normalize(centre);
+    return centre;
+}
+
+std::vector<Message> makeMessageStream(size_t count, const std::string& channelId, uint64_t seed) {
+    WorkloadRng rng(seed);
+    std::vector<Message> messages;
+    messages.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string sender = numbered("agent", rng.below(32));
+        std::string receiver = numbered("agent", rng.below(32));
+        messages.emplace_back(numbered("message", i), MessageType::TEXT, sender, receiver, channelId,
+                              makeSentence(rng, 3, 40));
+    }
+    return messages;
+}
+
+std::vector<InferenceRule> makeRuleSet(size_t rules, size_t fanout, uint64_t seed) {
+    WorkloadRng rng(seed);
+    if (fanout == 0) fanout = 1;
+
+    // Rule k derives fact k + 1 from fact k / fanout, so fact 0 roots a
+    // tree in which every fact has up to `fanout` children
+    std::vector<InferenceRule> ruleSet;
+    ruleSet.reserve(rules);
+    for (size_t k = 0; k < rules; ++k) {
+        TruthValue truth(rng.uniform(0.6, 1.0), rng.uniform(0.5, 1.0));
+        ruleSet.emplace_back(numbered("rule", k), factName(k / fanout), factName(k + 1), truth, rng.uniform(0.5, 1.0));
+    }
+
+    // Registration order should not follow derivation order
+    for (size_t i = ruleSet.size(); i > 1; --i) {
+        std::swap(ruleSet[i - 1], ruleSet[rng.below(i)]);
+    }
+    return ruleSet;
+}
+
+std::string ruleSetRootFact() {
+    return factName(0);
+}
+
+std::vector<WorldAgent> makeWorldPopulation(size_t agents, double extent, uint64_t seed) {
+    static const char* const TYPES[] = {"eliza", "trader", "community", "explorer"};
+
+    WorkloadRng rng(seed);
+    std::vector<WorldAgent> population;
+    population.reserve(agents);
+    for (size_t i = 0; i < agents; ++i) {
+        WorldAgent agent;
+        agent.agentId = numbered("world-agent", i);
+        agent.name = agent.agentId;
+        agent.type = TYPES[rng.below(4)];
+        agent.position = WorldPosition(rng.uniform(-extent, extent), rng.uniform(-extent, extent), 0.0);
+        agent.velocity = WorldPosition(rng.uniform(-1.0, 1.0), rng.uniform(-1.0, 1.0), 0.0);
+        agent.interactionRadius = rng.uniform(5.0, 20.0);
+        population.push_back(std::move(agent));
+    }
+    return population;
+}
+
+std::vector<std::string> makeUtterances(size_t count, uint64_t seed) {
+    static const char* const OPENERS[] = {"hello", "i feel", "why do you", "can you", "i think", "what is", "my"};
+
+    WorkloadRng rng(seed);
+    std::vector<std::string> utterances;
+    utterances.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        utterances.push_back(std::string(OPENERS[rng.below(7)]) + " " + makeSentence(rng, 2, 16));
+    }
+    return utterances;
+}
+
+AgentConfig makeAgentConfig() {
+    return AgentConfig{"bench-agent", "BenchAgent", "Synthetic agent for benchmarks", "None", "steady"};
+}
+
+} // namespace bench
+} // namespace elizaos
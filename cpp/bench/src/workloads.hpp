@@ -0,0 +1,69 @@
+#pragma once
+
+#include "elizaos/core.hpp"
+#include "elizaos/agentcomms.hpp"
+#include "elizaos/elizas_world.hpp"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace elizaos {
+namespace bench {
+
+// Seed used by every benchmark unless a sweep varies it explicitly
+constexpr uint64_t DEFAULT_SEED = 0x5eed'e11a'0000'0001ULL;
+
+/**
+ * Deterministic random source for workload generation
+ *
+ * Uses std::mt19937_64 directly and maps its output by hand, because the
+ * standard distributions are implementation-defined and would produce
+ * different workloads under different standard libraries.
+ */
+class WorkloadRng {
+public:
+    explicit WorkloadRng(uint64_t seed = DEFAULT_SEED);
+
+    uint64_t next();
+    double uniform();                           // [0, 1)
+    double uniform(double low, double high);    // [low, high)
+    size_t below(size_t bound);                 // [0, bound)
+    double gaussian();                          // Standard normal
+
+private:
+    std::mt19937_64 engine_;
+};
+
+/**
+ * Space-separated words drawn from a fixed vocabulary
+ */
+std::string makeSentence(WorkloadRng& rng, size_t minWords, size_t maxWords);
+
+/**
+ * Unit-length embeddings scattered around a handful of cluster centres, so
+ * similarity searches see a realistic mix of near and far candidates
+ */
+std::vector<std::shared_ptr<Memory>> makeMemories(size_t count, size_t dimensions, uint64_t seed = DEFAULT_SEED,
+                                                  size_t rooms = 8, size_t clusters = 16);
+EmbeddingVector makeQueryEmbedding(size_t dimensions, uint64_t seed = DEFAULT_SEED);
+
+std::vector<Message> makeMessageStream(size_t count, const std::string& channelId, uint64_t seed = DEFAULT_SEED);
+
+/**
+ * Layered rule graph: each rule concludes a fact that `fanout` rules of the
+ * next layer take as their premise, so forward chaining explores a tree
+ * whose width grows with the rule count
+ */
+std::vector<InferenceRule> makeRuleSet(size_t rules, size_t fanout, uint64_t seed = DEFAULT_SEED);
+std::string ruleSetRootFact();
+
+std::vector<WorldAgent> makeWorldPopulation(size_t agents, double extent, uint64_t seed = DEFAULT_SEED);
+
+std::vector<std::string> makeUtterances(size_t count, uint64_t seed = DEFAULT_SEED);
+
+AgentConfig makeAgentConfig();
+
+} // namespace bench
+} // namespace elizaos
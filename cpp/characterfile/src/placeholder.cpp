@@ -1,4 +1,5 @@
 #include "elizaos/characterfile.hpp"
+#include "elizaos/file_watcher.hpp"
 #include <fstream>
 #include <sstream>
 #include <algorithm>
@@ -11,6 +12,54 @@ namespace elizaos {
 // Global character file loader instance
 std::shared_ptr<CharacterFileLoader> globalCharacterFileLoader = std::make_shared<CharacterFileLoader>();
 
+namespace {
+
+uint64_t hashContent(const std::string& content) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Manifest paths are compared as strings, so both the directory scan and the
+// watcher report them in one form
+std::string normalizePath(const std::filesystem::path& path) {
+    return path.lexically_normal().string();
+}
+
+std::string manifestKey(const std::string& directory) {
+    std::error_code ec;
+    auto canonical = std::filesystem::weakly_canonical(directory, ec);
+    return ec ? directory : canonical.string();
+}
+
+// Written beside the target and renamed over it, so readers and the watcher
+// only ever see complete files
+bool writeFileAtomically(const std::filesystem::path& path, const std::string& content) {
+    std::filesystem::path temp = path.parent_path() / ("." + path.filename().string() + ".tmp");
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            return false;
+        }
+        file << content;
+        if (!file.good()) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 // =====================================================
 // ValidationResult Implementation
 // =====================================================
@@ -129,21 +178,9 @@ bool CharacterFileLoader::saveToFile(const CharacterProfile& character, const st
 }
 
 std::string CharacterFileLoader::exportToJson(const CharacterProfile& character) {
-    JsonValue json = exportToJsonValue(character);
-    
-    // Convert to formatted JSON string
-    std::ostringstream oss;
-    oss << "{\n";
-    oss << "  \"name\": \"" << character.name << "\",\n";
-    oss << "  \"description\": \"" << character.description << "\",\n";
-    oss << "  \"id\": \"" << character.id << "\",\n";
-    oss << "  \"version\": \"" << character.version << "\",\n";
-    oss << "  \"creator\": \"" << character.creator << "\",\n";
-    oss << "  \"created_at\": \"" << std::to_string(std::chrono::system_clock::to_time_t(character.created_at)) << "\",\n";
-    oss << "  \"updated_at\": \"" << std::to_string(std::chrono::system_clock::to_time_t(character.updated_at)) << "\"\n";
-    oss << "}";
-    
-    return oss.str();
+    json::WriteOptions options;
+    options.indent = 2;
+    return json::write(exportToJsonValue(character), options);
 }
 
 JsonValue CharacterFileLoader::exportToJsonValue(const CharacterProfile& character) {
@@ -212,16 +249,16 @@ bool CharacterFileLoader::isCharacterFile(const std::string& filename) {
     return std::find(extensions.begin(), extensions.end(), ext) != extensions.end();
 }
 
-std::optional<PluginMetadata> CharacterFileLoader::getCharacterMetadata(const std::string& filename) {
+std::optional<CharacterFileMetadata> CharacterFileLoader::getCharacterMetadata(const std::string& filename) {
     try {
         std::string content = readFileContents(filename);
         JsonValue json = parseJsonString(content);
         
-        PluginMetadata metadata;
+        CharacterFileMetadata metadata;
         metadata.name = getString(json, "name");
         metadata.description = getString(json, "description");
         metadata.author = getString(json, "creator");
-        metadata.version = PluginVersion::fromString(getString(json, "version", "1.0.0"));
+        metadata.version = getString(json, "version", "1.0.0");
         
         return metadata;
     } catch (const std::exception&) {
@@ -253,13 +290,11 @@ std::vector<CharacterProfile> CharacterFileLoader::loadFromDirectory(const std::
 
 JsonValue CharacterFileLoader::getStatistics() const {
     JsonValue stats;
-    stats["filesLoaded"] = std::string(std::to_string(filesLoaded_));
-    stats["filesError"] = std::string(std::to_string(filesError_));
-    stats["filesSaved"] = std::string(std::to_string(filesSaved_));
-    stats["successRate"] = std::string(std::to_string(
-        filesLoaded_ + filesError_ > 0 ? 
-        static_cast<double>(filesLoaded_) / (filesLoaded_ + filesError_) : 0.0
-    ));
+    stats["filesLoaded"] = filesLoaded_;
+    stats["filesError"] = filesError_;
+    stats["filesSaved"] = filesSaved_;
+    stats["successRate"] = filesLoaded_ + filesError_ > 0 ?
+        static_cast<double>(filesLoaded_) / (filesLoaded_ + filesError_) : 0.0;
     
     return stats;
 }
@@ -276,15 +311,12 @@ void CharacterFileLoader::setValidationSchema(const JsonValue& schema) {
 
 // Private helper methods
 JsonValue CharacterFileLoader::parseJsonString(const std::string& jsonString) {
-    // Simple JSON parsing - in a real implementation would use a proper JSON library
-    JsonValue json;
-    
-    // For now, create a basic structure
-    json["name"] = std::string("ParsedCharacter");
-    json["description"] = std::string("Character parsed from JSON");
-    json["id"] = std::string("parsed-" + std::to_string(std::hash<std::string>{}(jsonString)));
-    
-    return json;
+    json::ParseError error;
+    auto parsed = json::parse(jsonString, &error);
+    if (!parsed) {
+        throw std::runtime_error(error.message + " at offset " + std::to_string(error.offset));
+    }
+    return std::move(*parsed);
 }
 
 std::string CharacterFileLoader::readFileContents(const std::string& filename) {
@@ -322,7 +354,7 @@ bool CharacterFileLoader::validateRequiredFields(const JsonValue& json) {
     std::vector<std::string> requiredFields = {"name", "description"};
     
     for (const std::string& field : requiredFields) {
-        if (json.find(field) == json.end()) {
+        if (!json.contains(field)) {
             return false;
         }
     }
@@ -332,17 +364,13 @@ bool CharacterFileLoader::validateRequiredFields(const JsonValue& json) {
 
 bool CharacterFileLoader::validateFieldTypes(const JsonValue& json) {
     // Check if required fields have the correct types
-    try {
-        if (json.find("name") != json.end()) {
-            std::any_cast<std::string>(json.at("name"));
-        }
-        if (json.find("description") != json.end()) {
-            std::any_cast<std::string>(json.at("description"));
+    for (const char* field : {"name", "description"}) {
+        const JsonValue* value = json.find(field);
+        if (value && !value->isString()) {
+            return false;
         }
-        return true;
-    } catch (const std::bad_any_cast&) {
-        return false;
     }
+    return true;
 }
 
 CharacterProfile CharacterFileLoader::jsonToCharacterProfile(const JsonValue& json) {
@@ -355,23 +383,14 @@ CharacterProfile CharacterFileLoader::jsonToCharacterProfile(const JsonValue& js
     character.creator = getString(json, "creator", "Unknown");
     
     // Parse personality if present
-    if (json.find("personality") != json.end()) {
-        try {
-            JsonValue personalityJson = std::any_cast<JsonValue>(json.at("personality"));
-            character.personality = parsePersonality(personalityJson);
-        } catch (const std::bad_any_cast&) {
-            // Use default personality
-        }
+    const JsonValue* personalityJson = json.find("personality");
+    if (personalityJson && personalityJson->isObject()) {
+        character.personality = parsePersonality(*personalityJson);
     }
     
     // Parse traits if present
-    if (json.find("traits") != json.end()) {
-        try {
-            JsonValue traitsJson = std::any_cast<JsonValue>(json.at("traits"));
-            character.traits = parseTraits(traitsJson);
-        } catch (const std::bad_any_cast&) {
-            // Use default traits
-        }
+    if (const JsonValue* traitsJson = json.find("traits")) {
+        character.traits = parseTraits(*traitsJson);
     }
     
     return character;
@@ -380,19 +399,19 @@ CharacterProfile CharacterFileLoader::jsonToCharacterProfile(const JsonValue& js
 JsonValue CharacterFileLoader::characterProfileToJson(const CharacterProfile& character) {
     JsonValue json;
     
-    json["name"] = std::string(character.name);
-    json["description"] = std::string(character.description);
-    json["id"] = std::string(character.id);
-    json["version"] = std::string(character.version);
-    json["creator"] = std::string(character.creator);
-    json["created_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(character.created_at)));
-    json["updated_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(character.updated_at)));
+    json["name"] = character.name;
+    json["description"] = character.description;
+    json["id"] = character.id;
+    json["version"] = character.version;
+    json["creator"] = character.creator;
+    json["created_at"] = std::chrono::system_clock::to_time_t(character.created_at);
+    json["updated_at"] = std::chrono::system_clock::to_time_t(character.updated_at);
     
     // Add personality
-    json["personality"] = std::any(personalityToJson(character.personality));
+    json["personality"] = personalityToJson(character.personality);
     
     // Add traits
-    json["traits"] = std::any(traitsToJson(character.traits));
+    json["traits"] = traitsToJson(character.traits);
     
     return json;
 }
@@ -417,16 +436,16 @@ PersonalityMatrix CharacterFileLoader::parsePersonality(const JsonValue& persona
 JsonValue CharacterFileLoader::personalityToJson(const PersonalityMatrix& personality) {
     JsonValue json;
     
-    json["openness"] = std::string(std::to_string(personality.openness));
-    json["conscientiousness"] = std::string(std::to_string(personality.conscientiousness));
-    json["extraversion"] = std::string(std::to_string(personality.extraversion));
-    json["agreeableness"] = std::string(std::to_string(personality.agreeableness));
-    json["neuroticism"] = std::string(std::to_string(personality.neuroticism));
-    json["creativity"] = std::string(std::to_string(personality.creativity));
-    json["empathy"] = std::string(std::to_string(personality.empathy));
-    json["assertiveness"] = std::string(std::to_string(personality.assertiveness));
-    json["curiosity"] = std::string(std::to_string(personality.curiosity));
-    json["loyalty"] = std::string(std::to_string(personality.loyalty));
+    json["openness"] = personality.openness;
+    json["conscientiousness"] = personality.conscientiousness;
+    json["extraversion"] = personality.extraversion;
+    json["agreeableness"] = personality.agreeableness;
+    json["neuroticism"] = personality.neuroticism;
+    json["creativity"] = personality.creativity;
+    json["empathy"] = personality.empathy;
+    json["assertiveness"] = personality.assertiveness;
+    json["curiosity"] = personality.curiosity;
+    json["loyalty"] = personality.loyalty;
     
     return json;
 }
@@ -434,24 +453,29 @@ JsonValue CharacterFileLoader::personalityToJson(const PersonalityMatrix& person
 std::vector<CharacterTrait> CharacterFileLoader::parseTraits(const JsonValue& traitsJson) {
     std::vector<CharacterTrait> traits;
     
-    // Simple trait parsing - in a real implementation would parse array of trait objects
-    CharacterTrait defaultTrait("default", "Default trait", TraitCategory::PERSONALITY, TraitValueType::NUMERIC);
-    defaultTrait.setNumericValue(0.5f);
-    traits.push_back(defaultTrait);
+    if (traitsJson.isArray()) {
+        for (const auto& traitJson : traitsJson.asArray()) {
+            if (traitJson.isObject()) {
+                traits.push_back(CharacterTrait::fromJson(traitJson));
+            }
+        }
+    }
     
-    // Use traitsJson to avoid warning
-    if (!traitsJson.empty()) {
-        // Would parse traits from JSON here
+    if (traits.empty()) {
+        CharacterTrait defaultTrait("default", "Default trait", TraitCategory::PERSONALITY, TraitValueType::NUMERIC);
+        defaultTrait.setNumericValue(0.5f);
+        traits.push_back(defaultTrait);
     }
     
     return traits;
 }
 
 JsonValue CharacterFileLoader::traitsToJson(const std::vector<CharacterTrait>& traits) {
-    JsonValue json;
+    JsonValue json = JsonValue::array();
     
-    // Simple trait serialization - in a real implementation would create trait array
-    json["count"] = std::string(std::to_string(traits.size()));
+    for (const auto& trait : traits) {
+        json.push_back(trait.toJson());
+    }
     
     return json;
 }
@@ -470,7 +494,7 @@ CharacterBackground CharacterFileLoader::parseBackground(const JsonValue& backgr
 JsonValue CharacterFileLoader::backgroundToJson(const CharacterBackground& background) {
     JsonValue json;
     
-    json["experienceCount"] = std::string(std::to_string(background.experiences.size()));
+    json["experienceCount"] = background.experiences.size();
     
     return json;
 }
@@ -489,64 +513,38 @@ CommunicationStyle CharacterFileLoader::parseCommunicationStyle(const JsonValue&
 JsonValue CharacterFileLoader::communicationStyleToJson(const CommunicationStyle& style) {
     JsonValue json;
     
-    json["tone"] = std::string(style.tone);
-    json["formality"] = std::string(std::to_string(style.formality));
-    json["emotionality"] = std::string(std::to_string(style.emotionality));
-    json["verbosity"] = std::string(std::to_string(style.verbosity));
+    json["tone"] = style.tone;
+    json["formality"] = style.formality;
+    json["emotionality"] = style.emotionality;
+    json["verbosity"] = style.verbosity;
     
     return json;
 }
 
 std::string CharacterFileLoader::getString(const JsonValue& json, const std::string& key, const std::string& defaultValue) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            return std::any_cast<std::string>(it->second);
-        } catch (const std::bad_any_cast&) {
-            return defaultValue;
-        }
-    }
-    return defaultValue;
+    return json.getString(key, defaultValue);
 }
 
 float CharacterFileLoader::getFloat(const JsonValue& json, const std::string& key, float defaultValue) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            std::string str = std::any_cast<std::string>(it->second);
-            return std::stof(str);
-        } catch (const std::exception&) {
-            return defaultValue;
-        }
-    }
-    return defaultValue;
+    return static_cast<float>(json.getDouble(key, defaultValue));
 }
 
 bool CharacterFileLoader::getBool(const JsonValue& json, const std::string& key, bool defaultValue) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            std::string str = std::any_cast<std::string>(it->second);
-            return str == "true" || str == "1";
-        } catch (const std::bad_any_cast&) {
-            return defaultValue;
-        }
-    }
-    return defaultValue;
+    return json.getBool(key, defaultValue);
 }
 
 std::vector<std::string> CharacterFileLoader::getStringArray(const JsonValue& json, const std::string& key) {
     std::vector<std::string> result;
     
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            // Simple implementation - would parse array from JSON
-            std::string str = std::any_cast<std::string>(it->second);
-            result.push_back(str);
-        } catch (const std::bad_any_cast&) {
-            // Return empty array
+    const JsonValue* values = json.find(key);
+    if (values && values->isArray()) {
+        for (const auto& value : values->asArray()) {
+            if (value.isString()) {
+                result.emplace_back(value.asString());
+            }
         }
+    } else if (values && values->isString()) {
+        result.emplace_back(values->asString());
     }
     
     return result;
@@ -628,40 +626,251 @@ int CharacterFileManager::exportToDirectory(const std::string& directory) {
 }
 
 bool CharacterFileManager::syncWithManager(const std::string& directory) {
+    if (!characterManager_) {
+        logger_->log("No character manager set for sync", "characterfile", "manager", LogLevel::ERROR);
+        return false;
+    }
+    
     logger_->log("Syncing character files with manager from: " + directory, "characterfile", "manager", LogLevel::INFO);
     
-    // Import new/updated characters
-    int imported = importFromDirectory(directory, false);
+    std::lock_guard<std::mutex> lock(syncMutex_);
+    SyncManifest& manifest = manifests_[manifestKey(directory)];
     
-    // Export any characters that don't have files
-    int exported = exportToDirectory(directory);
+    // Files to manager: only files whose size, time or content changed
+    int imported = 0;
+    std::unordered_map<std::string, bool> present;
+    for (const auto& found : findCharacterFiles(directory, false)) {
+        std::string file = normalizePath(found);
+        present[file] = true;
+        if (importChangedFile(manifest, file, true)) {
+            imported++;
+        }
+    }
+    
+    int removed = 0;
+    std::vector<std::string> missing;
+    for (const auto& [path, record] : manifest.files) {
+        if (!present.count(path)) {
+            missing.push_back(path);
+        }
+    }
+    for (const auto& path : missing) {
+        if (forgetRemovedFile(manifest, path)) {
+            removed++;
+        }
+    }
+    
+    // Manager to files: only characters whose revision moved
+    int exported = exportChangedCharacters(manifest, directory);
     
     logger_->log("Sync complete: " + std::to_string(imported) + " imported, " + 
-                std::to_string(exported) + " exported", "characterfile", "manager", LogLevel::SUCCESS);
+                std::to_string(exported) + " exported, " + std::to_string(removed) + " removed",
+                "characterfile", "manager", LogLevel::SUCCESS);
     
     return true;
 }
 
+bool CharacterFileManager::importChangedFile(SyncManifest& manifest, const std::string& path, bool trustFileTimes) {
+    std::error_code ec;
+    uintmax_t size = std::filesystem::file_size(path, ec);
+    auto modified = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return false;
+    }
+    
+    auto existing = manifest.files.find(path);
+    if (existing != manifest.files.end() && trustFileTimes &&
+        existing->second.size == size && existing->second.modified == modified) {
+        skippedCount_++;
+        return false;
+    }
+    
+    std::string content = loader_->readFileContents(path);
+    uint64_t hash = hashContent(content);
+    CharacterFileRecord& record = manifest.files[path];
+    record.path = path;
+    record.size = size;
+    record.modified = modified;
+    if (existing != manifest.files.end() && record.contentHash == hash) {
+        // Touched or rewritten with the same bytes, e.g. by our own export
+        skippedCount_++;
+        return false;
+    }
+    record.contentHash = hash;
+    
+    std::optional<CharacterProfile> character;
+    bool hasId = false;
+    try {
+        JsonValue json = loader_->parseJsonString(content);
+        hasId = json.contains("id");
+        character = loader_->loadFromJsonValue(json);
+    } catch (const std::exception& e) {
+        logger_->log("Failed to parse character file " + path + ": " + e.what(), "characterfile", "manager", LogLevel::ERROR);
+    }
+    parsedCount_++;
+    if (!character) {
+        // Keep serving the last good profile; the hash stops this content being retried
+        errorCount_++;
+        return false;
+    }
+    
+    // Files without an id keep the one they were first registered under
+    if (!hasId && !record.characterId.empty()) {
+        character->id = record.characterId;
+    }
+    if (!record.characterId.empty() && record.characterId != character->id) {
+        manifest.paths.erase(record.characterId);
+    }
+    
+    std::string id = characterManager_->registerCharacter(*character);
+    if (id.empty()) {
+        errorCount_++;
+        return false;
+    }
+    record.characterId = id;
+    record.revision = characterManager_->getRevision(id);
+    manifest.paths[id] = path;
+    importedCount_++;
+    return true;
+}
+
+bool CharacterFileManager::forgetRemovedFile(SyncManifest& manifest, const std::string& path) {
+    auto it = manifest.files.find(path);
+    if (it == manifest.files.end()) {
+        return false;
+    }
+    CharacterFileRecord record = it->second;
+    manifest.files.erase(it);
+    
+    auto owner = manifest.paths.find(record.characterId);
+    if (owner == manifest.paths.end() || owner->second != path) {
+        return false;
+    }
+    manifest.paths.erase(owner);
+    
+    // A character edited since its file was synced is written out again instead
+    if (characterManager_->getRevision(record.characterId) != record.revision) {
+        return false;
+    }
+    return characterManager_->unregisterCharacter(record.characterId);
+}
+
+int CharacterFileManager::exportChangedCharacters(SyncManifest& manifest, const std::string& directory) {
+    int exported = 0;
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    
+    for (const auto& [id, revision] : characterManager_->getRevisions()) {
+        auto owned = manifest.paths.find(id);
+        if (owned != manifest.paths.end()) {
+            auto record = manifest.files.find(owned->second);
+            if (record != manifest.files.end() && record->second.revision == revision) {
+                continue;
+            }
+        }
+        
+        auto character = characterManager_->getLiveCharacter(id);
+        if (!character) {
+            continue;
+        }
+        
+        std::string path;
+        if (owned != manifest.paths.end()) {
+            path = owned->second;
+        } else {
+            path = normalizePath(std::filesystem::path(directory) / CharacterFileUtils::createFilename(character->name));
+            if (manifest.files.count(path) || std::filesystem::exists(path, ec)) {
+                path = normalizePath(std::filesystem::path(directory) /
+                                     (CharacterFileUtils::sanitizeFilename(character->name) + "_" + id +
+                                      CharacterFileUtils::getFileExtension()));
+            }
+        }
+        
+        std::string content = loader_->exportToJson(*character);
+        if (!writeFileAtomically(path, content)) {
+            logger_->log("Failed to write character file: " + path, "characterfile", "manager", LogLevel::ERROR);
+            errorCount_++;
+            continue;
+        }
+        
+        CharacterFileRecord& record = manifest.files[path];
+        record.path = path;
+        record.characterId = id;
+        record.contentHash = hashContent(content);
+        record.size = std::filesystem::file_size(path, ec);
+        record.modified = std::filesystem::last_write_time(path, ec);
+        record.revision = revision;
+        manifest.paths[id] = path;
+        exported++;
+        exportedCount_++;
+    }
+    return exported;
+}
+
 bool CharacterFileManager::watchDirectory(const std::string& directory, bool autoImport) {
     if (isWatching_) {
         stopWatching();
     }
+    if (autoImport && !syncWithManager(directory)) {
+        return false;
+    }
     
     watchedDirectory_ = directory;
+    autoImport_ = autoImport;
+    watcher_ = std::make_unique<FileWatcher>();
+    if (!watcher_->addDirectory(directory) ||
+        !watcher_->start([this](const std::vector<std::filesystem::path>& paths) { onWatchedFilesChanged(paths); })) {
+        logger_->log("Failed to watch directory: " + directory, "characterfile", "manager", LogLevel::ERROR);
+        watcher_.reset();
+        watchedDirectory_.clear();
+        return false;
+    }
     isWatching_ = true;
     
     logger_->log("Started watching directory: " + directory + 
                 " (auto-import: " + (autoImport ? "enabled" : "disabled") + ")", 
                 "characterfile", "manager", LogLevel::INFO);
     
-    // In a real implementation, would set up filesystem watching
-    // For now, just log that we're "watching"
-    
     return true;
 }
 
+void CharacterFileManager::onWatchedFilesChanged(const std::vector<std::filesystem::path>& paths) {
+    std::lock_guard<std::mutex> lock(syncMutex_);
+    std::error_code ec;
+    const std::string directory = manifestKey(watchedDirectory_);
+    SyncManifest& manifest = manifests_[directory];
+    
+    for (const auto& changed : paths) {
+        // The sync is not recursive, so neither is reloading
+        std::string path = normalizePath(changed);
+        if (manifestKey(changed.parent_path().string()) != directory) {
+            continue;
+        }
+        if (!loader_->isCharacterFile(path)) {
+            continue;
+        }
+        if (!autoImport_ || !characterManager_) {
+            logger_->log("Character file changed: " + path, "characterfile", "manager", LogLevel::INFO);
+            continue;
+        }
+        
+        if (!std::filesystem::exists(changed, ec)) {
+            if (forgetRemovedFile(manifest, path)) {
+                logger_->log("Removed character for deleted file: " + path, "characterfile", "manager", LogLevel::INFO);
+            }
+        } else if (importChangedFile(manifest, path, false)) {
+            reloadedCount_++;
+            logger_->log("Reloaded character file: " + path, "characterfile", "manager", LogLevel::INFO);
+        }
+    }
+}
+
 void CharacterFileManager::stopWatching() {
     if (isWatching_) {
+        if (watcher_) {
+            watcher_->stop();
+            watcher_.reset();
+        }
         isWatching_ = false;
         logger_->log("Stopped watching directory: " + watchedDirectory_, "characterfile", "manager", LogLevel::INFO);
         watchedDirectory_.clear();
@@ -670,11 +879,14 @@ void CharacterFileManager::stopWatching() {
 
 JsonValue CharacterFileManager::getOperationStatistics() const {
     JsonValue stats;
-    stats["importedCount"] = std::string(std::to_string(importedCount_));
-    stats["exportedCount"] = std::string(std::to_string(exportedCount_));
-    stats["errorCount"] = std::string(std::to_string(errorCount_));
-    stats["isWatching"] = std::string(isWatching_ ? "true" : "false");
-    stats["watchedDirectory"] = std::string(watchedDirectory_);
+    stats["importedCount"] = importedCount_.load();
+    stats["exportedCount"] = exportedCount_.load();
+    stats["errorCount"] = errorCount_.load();
+    stats["parsedCount"] = parsedCount_.load();
+    stats["skippedCount"] = skippedCount_.load();
+    stats["reloadedCount"] = reloadedCount_.load();
+    stats["isWatching"] = isWatching_;
+    stats["watchedDirectory"] = watchedDirectory_;
     
     return stats;
 }
@@ -766,12 +978,12 @@ JsonValue CharacterFileTemplate::createBasicTemplate() {
     
     // Basic personality structure
     JsonValue personality;
-    personality["openness"] = std::string("0.5");
-    personality["conscientiousness"] = std::string("0.5");
-    personality["extraversion"] = std::string("0.5");
-    personality["agreeableness"] = std::string("0.5");
-    personality["neuroticism"] = std::string("0.5");
-    template_["personality"] = std::any(personality);
+    personality["openness"] = 0.5;
+    personality["conscientiousness"] = 0.5;
+    personality["extraversion"] = 0.5;
+    personality["agreeableness"] = 0.5;
+    personality["neuroticism"] = 0.5;
+    template_["personality"] = personality;
     
     return template_;
 }
@@ -785,15 +997,15 @@ JsonValue CharacterFileTemplate::createDetailedTemplate() {
     // Add communication style
     JsonValue commStyle;
     commStyle["tone"] = std::string("neutral");
-    commStyle["formality"] = std::string("0.5");
-    commStyle["emotionality"] = std::string("0.5");
-    commStyle["verbosity"] = std::string("0.5");
-    template_["communicationStyle"] = std::any(commStyle);
+    commStyle["formality"] = 0.5;
+    commStyle["emotionality"] = 0.5;
+    commStyle["verbosity"] = 0.5;
+    template_["communicationStyle"] = commStyle;
     
     // Add background
     JsonValue background;
-    background["experiences"] = std::string("[]");
-    template_["background"] = std::any(background);
+    background["experiences"] = JsonValue::array();
+    template_["background"] = background;
     
     return template_;
 }
@@ -808,8 +1020,10 @@ CharacterProfile CharacterFileTemplate::generateFromTemplate(const JsonValue& te
     
     // Merge template with parameters
     JsonValue merged = templateJson;
-    for (const auto& param : parameters) {
-        merged[param.first] = param.second;
+    if (parameters.isObject()) {
+        for (const auto& param : parameters.asObject()) {
+            merged[param.key] = param.value;
+        }
     }
     
     auto character = loader.loadFromJsonValue(merged);
@@ -838,21 +1052,9 @@ std::optional<JsonValue> CharacterFileTemplate::loadTemplate(const std::string&
 bool CharacterFileTemplate::saveTemplate(const JsonValue& templateJson, const std::string& filename) {
     CharacterFileLoader loader;
     
-    // Convert template to JSON string
-    std::ostringstream oss;
-    oss << "{\n";
-    for (auto it = templateJson.begin(); it != templateJson.end(); ++it) {
-        if (it != templateJson.begin()) oss << ",\n";
-        oss << "  \"" << it->first << "\": ";
-        try {
-            oss << "\"" << std::any_cast<std::string>(it->second) << "\"";
-        } catch (const std::bad_any_cast&) {
-            oss << "\"\"";
-        }
-    }
-    oss << "\n}";
-    
-    return loader.writeFileContents(filename, oss.str());
+    json::WriteOptions options;
+    options.indent = 2;
+    return loader.writeFileContents(filename, json::write(templateJson, options));
 }
 
 // =====================================================
@@ -7,7 +7,7 @@
 
 namespace elizaos {
 
-using json = nlohmann::json;
+using nlohmann_json = nlohmann::json;
 
 std::optional<CharacterProfile> CharacterJsonLoader::loadFromFile(const std::string& filepath) {
     try {
@@ -29,7 +29,7 @@ std::optional<CharacterProfile> CharacterJsonLoader::loadFromFile(const std::str
 
 std::optional<CharacterProfile> CharacterJsonLoader::loadFromJsonString(const std::string& jsonString) {
     try {
-        json j = json::parse(jsonString);
+        nlohmann_json j = nlohmann_json::parse(jsonString);
         
         // Extract basic character information
         std::string name = j.value("name", "");
@@ -317,7 +317,7 @@ bool CharacterJsonLoader::saveToFile(const CharacterProfile& character, const st
 
 std::string CharacterJsonLoader::toJsonString(const CharacterProfile& character) {
     try {
-        json j;
+        nlohmann_json j;
         
         j["name"] = character.name;
         j["description"] = character.description;
@@ -325,19 +325,19 @@ std::string CharacterJsonLoader::toJsonString(const CharacterProfile& character)
         j["creator"] = character.creator;
         
         // Bio from experiences
-        j["bio"] = json::array();
+        j["bio"] = nlohmann_json::array();
         for (const auto& experience : character.background.experiences) {
             j["bio"].push_back(experience);
         }
         
         // Lore from backstory
         if (!character.background.backstory.empty()) {
-            j["lore"] = json::array();
+            j["lore"] = nlohmann_json::array();
             j["lore"].push_back(character.background.backstory);
         }
         
         // Personality as adjectives
-        j["adjectives"] = json::array();
+        j["adjectives"] = nlohmann_json::array();
         for (const auto& trait : character.traits) {
             if (trait.valueType == TraitValueType::BOOLEAN && trait.getBooleanValue()) {
                 j["adjectives"].push_back(trait.name);
@@ -345,8 +345,8 @@ std::string CharacterJsonLoader::toJsonString(const CharacterProfile& character)
         }
         
         // Communication style
-        j["style"] = json::object();
-        j["style"]["all"] = json::array();
+        j["style"] = nlohmann_json::object();
+        j["style"]["all"] = nlohmann_json::array();
         
         if (character.communicationStyle.formality > 0.7f) {
             j["style"]["all"].push_back("formal and proper communication");
@@ -366,7 +366,7 @@ std::string CharacterJsonLoader::toJsonString(const CharacterProfile& character)
         // Topics from interests
         auto interestsIt = character.background.additionalContext.find("interests");
         if (interestsIt != character.background.additionalContext.end()) {
-            j["topics"] = json::array();
+            j["topics"] = nlohmann_json::array();
             std::stringstream ss(interestsIt->second);
             std::string item;
             while (std::getline(ss, item, ',')) {
@@ -385,38 +385,24 @@ std::string CharacterJsonLoader::toJsonString(const CharacterProfile& character)
 // Helper functions implementation
 
 std::string CharacterJsonLoader::getStringFromJson(const JsonValue& json, const std::string& key, const std::string& defaultValue) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            return std::any_cast<std::string>(it->second);
-        } catch (const std::bad_any_cast&) {
-            return defaultValue;
-        }
-    }
-    return defaultValue;
+    return json.getString(key, defaultValue);
 }
 
 std::vector<std::string> CharacterJsonLoader::getStringArrayFromJson(const JsonValue& json, const std::string& key) {
     std::vector<std::string> result;
-    auto it = json.find(key);
-    if (it != json.end()) {
-        // This is a simplified implementation - would need proper JSON array parsing
-        // For now, just return empty vector
+    const JsonValue* values = json.find(key);
+    if (values && values->isArray()) {
+        for (const auto& value : values->asArray()) {
+            if (value.isString()) {
+                result.emplace_back(value.asString());
+            }
+        }
     }
     return result;
 }
 
 float CharacterJsonLoader::getFloatFromJson(const JsonValue& json, const std::string& key, float defaultValue) {
-    auto it = json.find(key);
-    if (it != json.end()) {
-        try {
-            std::string valueStr = std::any_cast<std::string>(it->second);
-            return std::stof(valueStr);
-        } catch (const std::exception&) {
-            return defaultValue;
-        }
-    }
-    return defaultValue;
+    return static_cast<float>(json.getDouble(key, defaultValue));
 }
 
 } // namespace elizaos
\ No newline at end of file
@@ -117,23 +117,23 @@ std::string CharacterTrait::getTextValue() const {
 
 JsonValue CharacterTrait::toJson() const {
     JsonValue json;
-    json["name"] = std::string(name);
-    json["description"] = std::string(description);
-    json["category"] = std::string(traitCategoryToString(category));
-    json["valueType"] = std::string(traitValueTypeToString(valueType));
-    json["weight"] = std::string(std::to_string(weight));
+    json["name"] = name;
+    json["description"] = description;
+    json["category"] = traitCategoryToString(category);
+    json["valueType"] = traitValueTypeToString(valueType);
+    json["weight"] = weight;
     
     // Handle value serialization based on type
     switch (valueType) {
         case TraitValueType::NUMERIC:
-            json["value"] = std::string(std::to_string(getNumericValue()));
+            json["value"] = getNumericValue();
             break;
         case TraitValueType::BOOLEAN:
-            json["value"] = std::string(getBooleanValue() ? "true" : "false");
+            json["value"] = getBooleanValue();
             break;
         case TraitValueType::CATEGORICAL:
         case TraitValueType::TEXT:
-            json["value"] = std::string(getCategoricalValue());
+            json["value"] = getCategoricalValue();
             break;
     }
     
@@ -141,44 +141,27 @@ JsonValue CharacterTrait::toJson() const {
 }
 
 CharacterTrait CharacterTrait::fromJson(const JsonValue& json) {
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    std::string name = getString("name");
-    std::string description = getString("description");
-    TraitCategory category = stringToTraitCategory(getString("category"));
-    TraitValueType valueType = stringToTraitValueType(getString("valueType"));
+    std::string name = json.getString("name");
+    std::string description = json.getString("description");
+    TraitCategory category = stringToTraitCategory(json.getString("category"));
+    TraitValueType valueType = stringToTraitValueType(json.getString("valueType"));
     
     CharacterTrait trait(name, description, category, valueType);
+    trait.weight = static_cast<float>(json.getDouble("weight", 1.0));
     
-    try {
-        trait.weight = std::stof(getString("weight"));
-    } catch (const std::exception&) {
-        trait.weight = 1.0f;
-    }
-    
-    std::string valueStr = getString("value");
+    const JsonValue* value = json.find("value");
     switch (valueType) {
         case TraitValueType::NUMERIC:
-            try {
-                trait.setNumericValue(std::stof(valueStr));
-            } catch (const std::exception&) {}
+            if (value && value->isNumber()) {
+                trait.setNumericValue(static_cast<float>(value->asDouble()));
+            }
             break;
         case TraitValueType::BOOLEAN:
-            trait.setBooleanValue(valueStr == "true");
+            trait.setBooleanValue(json.getBool("value"));
             break;
         case TraitValueType::CATEGORICAL:
         case TraitValueType::TEXT:
-            trait.setCategoricalValue(valueStr);
+            trait.setCategoricalValue(json.getString("value"));
             break;
     }
     
@@ -311,30 +294,22 @@ void PersonalityMatrix::evolveOverTime(float timeFactorDays) {
 
 JsonValue PersonalityMatrix::toJson() const {
     JsonValue json;
-    json["openness"] = std::string(std::to_string(openness));
-    json["conscientiousness"] = std::string(std::to_string(conscientiousness));
-    json["extraversion"] = std::string(std::to_string(extraversion));
-    json["agreeableness"] = std::string(std::to_string(agreeableness));
-    json["neuroticism"] = std::string(std::to_string(neuroticism));
-    json["creativity"] = std::string(std::to_string(creativity));
-    json["empathy"] = std::string(std::to_string(empathy));
-    json["assertiveness"] = std::string(std::to_string(assertiveness));
-    json["curiosity"] = std::string(std::to_string(curiosity));
-    json["loyalty"] = std::string(std::to_string(loyalty));
+    json["openness"] = openness;
+    json["conscientiousness"] = conscientiousness;
+    json["extraversion"] = extraversion;
+    json["agreeableness"] = agreeableness;
+    json["neuroticism"] = neuroticism;
+    json["creativity"] = creativity;
+    json["empathy"] = empathy;
+    json["assertiveness"] = assertiveness;
+    json["curiosity"] = curiosity;
+    json["loyalty"] = loyalty;
     return json;
 }
 
 PersonalityMatrix PersonalityMatrix::fromJson(const JsonValue& json) {
-    auto getFloat = [&](const std::string& key, float defaultVal = 0.5f) -> float {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::stof(std::any_cast<std::string>(it->second));
-            } catch (const std::exception&) {
-                return defaultVal;
-            }
-        }
-        return defaultVal;
+    auto getFloat = [&](std::string_view key) {
+        return static_cast<float>(json.getDouble(key, 0.5));
     };
     
     PersonalityMatrix matrix;
@@ -560,45 +535,31 @@ std::string CharacterProfile::predictInteractionStyle(const CharacterProfile& ot
 
 JsonValue CharacterProfile::toJson() const {
     JsonValue json;
-    json["id"] = std::string(id);
-    json["name"] = std::string(name);
-    json["description"] = std::string(description);
-    json["version"] = std::string(version);
-    json["creator"] = std::string(creator);
+    json["id"] = id;
+    json["name"] = name;
+    json["description"] = description;
+    json["version"] = version;
+    json["creator"] = creator;
     
     // Timestamps
-    json["created_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(created_at)));
-    json["updated_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(updated_at)));
+    json["created_at"] = std::chrono::system_clock::to_time_t(created_at);
+    json["updated_at"] = std::chrono::system_clock::to_time_t(updated_at);
     
     return json;
 }
 
 CharacterProfile CharacterProfile::fromJson(const JsonValue& json) {
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
+    CharacterProfile profile(json.getString("name"), json.getString("description"));
+    profile.id = json.getString("id");
+    profile.version = json.getString("version");
+    profile.creator = json.getString("creator");
     
-    CharacterProfile profile(getString("name"), getString("description"));
-    profile.id = getString("id");
-    profile.version = getString("version");
-    profile.creator = getString("creator");
-    
-    // Parse timestamps
-    try {
-        auto created_time_t = std::stoll(getString("created_at"));
-        auto updated_time_t = std::stoll(getString("updated_at"));
-        profile.created_at = std::chrono::system_clock::from_time_t(created_time_t);
-        profile.updated_at = std::chrono::system_clock::from_time_t(updated_time_t);
-    } catch (const std::exception&) {
-        // Use current time if parsing fails
+    // Keep the construction time when a timestamp is missing
+    if (const JsonValue* created = json.find("created_at"); created && created->isNumber()) {
+        profile.created_at = std::chrono::system_clock::from_time_t(created->asInt());
+    }
+    if (const JsonValue* updated = json.find("updated_at"); updated && updated->isNumber()) {
+        profile.updated_at = std::chrono::system_clock::from_time_t(updated->asInt());
     }
     
     return profile;
@@ -718,25 +679,13 @@ void CharacterTemplate::addVariation(const std::string& variationName, const Per
 
 JsonValue CharacterTemplate::toJson() const {
     JsonValue json;
-    json["name"] = std::string(name);
-    json["description"] = std::string(description);
+    json["name"] = name;
+    json["description"] = description;
     return json;
 }
 
 CharacterTemplate CharacterTemplate::fromJson(const JsonValue& json) {
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    return CharacterTemplate(getString("name"), getString("description"));
+    return CharacterTemplate(json.getString("name"), json.getString("description"));
 }
 
 // =====================================================
@@ -763,11 +712,13 @@ std::string CharacterManager::registerCharacter(const CharacterProfile& characte
         newCharacter.id = generateCharacterId();
     }
     
-    characters_[newCharacter.id] = newCharacter;
+    std::string id = newCharacter.id;
+    std::string name = newCharacter.name;
     saveCharacterToMemory(newCharacter);
+    storeCharacter(std::move(newCharacter));
     
-    logger_->log("Registered character: " + newCharacter.name, "info", "characters");
-    return newCharacter.id;
+    logger_->log("Registered character: " + name, "info", "characters");
+    return id;
 }
 
 bool CharacterManager::unregisterCharacter(const std::string& characterId) {
@@ -793,13 +744,13 @@ std::optional<CharacterProfile> CharacterManager::getCharacter(const std::string
     
     auto it = characters_.find(characterId);
     if (it != characters_.end()) {
-        return it->second;
+        return *it->second.profile;
     }
     
     // Try loading from memory
     auto memoryChar = loadCharacterFromMemory(characterId);
     if (memoryChar) {
-        characters_[characterId] = *memoryChar;
+        storeCharacter(*memoryChar);
         return *memoryChar;
     }
     
@@ -811,7 +762,7 @@ std::vector<CharacterProfile> CharacterManager::getAllCharacters() const {
     
     std::vector<CharacterProfile> result;
     for (const auto& pair : characters_) {
-        result.push_back(pair.second);
+        result.push_back(*pair.second.profile);
     }
     
     // Also get any characters only in memory
@@ -834,8 +785,8 @@ bool CharacterManager::updateCharacter(const std::string& characterId, const Cha
         updatedChar.id = characterId;
         updatedChar.updated_at = std::chrono::system_clock::now();
         
-        characters_[characterId] = updatedChar;
         saveCharacterToMemory(updatedChar);
+        storeCharacter(std::move(updatedChar));
         
         logger_->log("Updated character: " + characterId, "info", "characters");
         return true;
@@ -844,9 +795,29 @@ bool CharacterManager::updateCharacter(const std::string& characterId, const Cha
     return false;
 }
 
-std::vector<CharacterProfile> CharacterManager::searchCharacters(const std::string& query) const {
+std::shared_ptr<const CharacterProfile> CharacterManager::getLiveCharacter(const std::string& characterId) const {
     std::lock_guard<std::mutex> lock(charactersMutex_);
-    
+    auto it = characters_.find(characterId);
+    return it != characters_.end() ? it->second.profile : nullptr;
+}
+
+uint64_t CharacterManager::getRevision(const std::string& characterId) const {
+    std::lock_guard<std::mutex> lock(charactersMutex_);
+    auto it = characters_.find(characterId);
+    return it != characters_.end() ? it->second.revision : 0;
+}
+
+std::vector<std::pair<std::string, uint64_t>> CharacterManager::getRevisions() const {
+    std::lock_guard<std::mutex> lock(charactersMutex_);
+    std::vector<std::pair<std::string, uint64_t>> revisions;
+    revisions.reserve(characters_.size());
+    for (const auto& pair : characters_) {
+        revisions.emplace_back(pair.first, pair.second.revision);
+    }
+    return revisions;
+}
+
+std::vector<CharacterProfile> CharacterManager::searchCharacters(const std::string& query) const {
     std::vector<CharacterProfile> results;
     auto allChars = getAllCharacters();
     
@@ -951,8 +922,11 @@ void CharacterManager::evolveAllCharacters(float timeDelta) {
     std::lock_guard<std::mutex> lock(charactersMutex_);
     
     for (auto& pair : characters_) {
-        pair.second.evolvePersonality(timeDelta);
-        saveCharacterToMemory(pair.second);
+        CharacterProfile evolved = *pair.second.profile;
+        evolved.evolvePersonality(timeDelta);
+        saveCharacterToMemory(evolved);
+        pair.second.profile = std::make_shared<const CharacterProfile>(std::move(evolved));
+        pair.second.revision = ++lastRevision_;
     }
     
     logger_->log("Evolved all characters with time delta: " + std::to_string(timeDelta), 
@@ -964,8 +938,8 @@ void CharacterManager::saveAllCharacters(const std::string& directory) const {
     
     int saved = 0;
     for (const auto& pair : characters_) {
-        std::string filename = directory + "/" + pair.second.name + "_" + pair.first + ".txt";
-        if (pair.second.exportToFile(filename)) {
+        std::string filename = directory + "/" + pair.second.profile->name + "_" + pair.first + ".txt";
+        if (pair.second.profile->exportToFile(filename)) {
             saved++;
         }
     }
@@ -994,12 +968,13 @@ std::unordered_map<TraitCategory, int> CharacterManager::getTraitCategoryStats()
 }
 
 std::string CharacterManager::getCharacterAnalytics() const {
-    std::lock_guard<std::mutex> lock(charactersMutex_);
-    
     std::stringstream ss;
     ss << "Character Manager Analytics:" << std::endl;
-    ss << "Total characters: " << characters_.size() << std::endl;
-    ss << "Total templates: " << templates_.size() << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(charactersMutex_);
+        ss << "Total characters: " << characters_.size() << std::endl;
+        ss << "Total templates: " << templates_.size() << std::endl;
+    }
     
     auto stats = getTraitCategoryStats();
     ss << "Trait category distribution:" << std::endl;
@@ -1069,6 +1044,13 @@ size_t CharacterManager::getCharacterCount() const {
     return characters_.size();
 }
 
+void CharacterManager::storeCharacter(CharacterProfile character) {
+    // Callers hold charactersMutex_; readers see the old or new profile, never a mix
+    LiveCharacter& live = characters_[character.id];
+    live.profile = std::make_shared<const CharacterProfile>(std::move(character));
+    live.revision = ++lastRevision_;
+}
+
 void CharacterManager::saveCharacterToMemory(const CharacterProfile& character) {
     UUID memoryId(character.id);
     UUID entityId = generateCharacterUUID();
@@ -1087,8 +1069,8 @@ void CharacterManager::saveCharacterToMemory(const CharacterProfile& character)
     customMeta.customData["updated_at"] = std::to_string(std::chrono::system_clock::to_time_t(character.updated_at));
     
     MemoryMetadata metadata = customMeta;
-    auto memory = std::make_shared<Memory>(memoryId, character.name + ": " + character.description, 
-                                          entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, character.name + ": " + character.description, 
+                             entityId, agentId, metadata);
     
     memory_->createMemory(memory, "characters");
 }
@@ -0,0 +1,1169 @@
+#include "elizaos/atomspace_matcher.hpp"
+#include "elizaos/executor.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace elizaos {
+
+namespace {
+
+constexpr uint32_t UNBOUND = std::numeric_limits<uint32_t>::max();
+constexpr uint32_t NO_LABEL = std::numeric_limits<uint32_t>::max();
+constexpr size_t DENSE_SET_RATIO = 32;      // Sets with at least 1/32 of all nodes also get a bitset
+
+class Bitset {
+public:
+    explicit Bitset(size_t bits) : words_((bits + 63) / 64, 0) {}
+
+    void set(uint32_t i) { words_[i >> 6] |= uint64_t(1) << (i & 63); }
+    bool test(uint32_t i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+
+    void intersect(const Bitset& other) {
+        for (size_t i = 0; i < words_.size(); ++i) words_[i] &= other.words_[i];
+    }
+
+    size_t count() const {
+        size_t total = 0;
+        for (uint64_t word : words_) total += static_cast<size_t>(__builtin_popcountll(word));
+        return total;
+    }
+
+    template <typename F>
+    bool forEach(F&& f) const {
+        for (size_t i = 0; i < words_.size(); ++i) {
+            for (uint64_t word = words_[i]; word; word &= word - 1) {
+                if (!f(static_cast<uint32_t>(i * 64 + static_cast<size_t>(__builtin_ctzll(word))))) return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    std::vector<uint64_t> words_;
+};
+
+/**
+ * Sorted distinct node indices, with a bitset when dense enough to pay off
+ */
+struct NodeSet {
+    std::vector<uint32_t> members;
+    std::unique_ptr<Bitset> dense;
+
+    bool contains(uint32_t node) const {
+        if (dense) return dense->test(node);
+        return std::binary_search(members.begin(), members.end(), node);
+    }
+
+    void finish(size_t nodeCount) {
+        if (!members.empty() && members.size() * DENSE_SET_RATIO >= nodeCount) {
+            dense = std::make_unique<Bitset>(nodeCount);
+            for (uint32_t node : members) dense->set(node);
+        }
+    }
+};
+
+/**
+ * Consecutive edges of one group: count tuples of arity node indices
+ */
+struct EdgeRun {
+    const uint32_t* members = nullptr;
+    const double* weights = nullptr;
+    size_t count = 0;
+};
+
+/**
+ * Edges sharing a label and arity, with members stored flat
+ *
+ * Every position also keeps its own copy of the edges sorted by the node at
+ * that position, so the edges holding a bound node are one contiguous run
+ * and a join step reads them without chasing edge indices.
+ */
+struct EdgeGroup {
+    struct Position {
+        std::vector<uint32_t> members;                  // Sorted by the node at this position
+        std::vector<double> weights;
+        std::vector<uint32_t> offsets;                  // Per node first edge, when dense
+        NodeSet nodes;
+    };
+
+    uint32_t arity = 0;
+    std::vector<uint32_t> members;                      // size() * arity node indices
+    std::vector<double> weights;                        // Clamped to [0, 1]
+    std::vector<Position> positions;
+
+    size_t size() const { return weights.size(); }
+
+    EdgeRun all() const { return {members.data(), weights.data(), size()}; }
+
+    // Edges holding node at position
+    EdgeRun holding(uint32_t position, uint32_t node) const {
+        const Position& sorted = positions[position];
+        size_t first = 0;
+        size_t last = 0;
+        if (!sorted.offsets.empty()) {
+            first = sorted.offsets[node];
+            last = sorted.offsets[node + 1];
+        } else {
+            auto nodeAt = [&](size_t edge) { return sorted.members[edge * arity + position]; };
+            size_t low = 0;
+            size_t high = size();
+            while (low < high) {
+                size_t mid = low + (high - low) / 2;
+                if (nodeAt(mid) < node) low = mid + 1; else high = mid;
+            }
+            first = last = low;
+            high = size();
+            while (last < high) {
+                size_t mid = last + (high - last) / 2;
+                if (nodeAt(mid) <= node) last = mid + 1; else high = mid;
+            }
+        }
+        return {sorted.members.data() + first * arity, sorted.weights.data() + first, last - first};
+    }
+
+    void finish(size_t nodeCount) {
+        std::vector<uint32_t> order(size());
+        for (uint32_t position = 0; position < arity; ++position) {
+            Position& sorted = positions[position];
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+                return members[a * arity + position] < members[b * arity + position];
+            });
+            sorted.members.reserve(members.size());
+            sorted.weights.reserve(size());
+            for (uint32_t edge : order) {
+                sorted.members.insert(sorted.members.end(), members.begin() + edge * arity,
+                                      members.begin() + (edge + 1) * arity);
+                sorted.weights.push_back(weights[edge]);
+                uint32_t node = members[edge * arity + position];
+                if (sorted.nodes.members.empty() || sorted.nodes.members.back() != node) {
+                    sorted.nodes.members.push_back(node);
+                }
+            }
+            sorted.nodes.finish(nodeCount);
+            if (sorted.nodes.dense) {
+                // Dense positions are looked up by offset rather than binary search
+                sorted.offsets.assign(nodeCount + 1, 0);
+                for (size_t edge = 0; edge < size(); ++edge) {
+                    ++sorted.offsets[sorted.members[edge * arity + position] + 1];
+                }
+                std::partial_sum(sorted.offsets.begin(), sorted.offsets.end(), sorted.offsets.begin());
+            }
+        }
+    }
+};
+
+struct AtomIndex {
+    std::vector<std::shared_ptr<HypergraphNode>> inputNodes;
+    std::vector<std::shared_ptr<HypergraphEdge>> inputEdges;
+
+    // Per node index; nodes only named by edges have no atom and no label
+    std::vector<std::string_view> ids;
+    std::vector<std::shared_ptr<HypergraphNode>> atoms;
+    std::vector<uint32_t> nodeLabels;
+
+    std::unordered_map<std::string_view, uint32_t> idIndex;
+    std::unordered_map<std::string_view, uint32_t> nodeLabelIndex;
+    std::vector<NodeSet> labelNodes;
+    std::unordered_map<std::string_view, std::vector<uint32_t>> edgeGroupIndex;    // Groups per label
+    std::vector<EdgeGroup> edgeGroups;
+
+    AtomIndex(const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+              const std::vector<std::shared_ptr<HypergraphEdge>>& edges)
+        : inputNodes(nodes), inputEdges(edges) {
+        idIndex.reserve(nodes.size());
+        for (const auto& node : inputNodes) {
+            if (!node) continue;
+            uint32_t index = static_cast<uint32_t>(ids.size());
+            if (!idIndex.emplace(node->getId(), index).second) continue;
+            auto label = nodeLabelIndex.emplace(node->getLabel(), static_cast<uint32_t>(labelNodes.size()));
+            if (label.second) labelNodes.emplace_back();
+            labelNodes[label.first->second].members.push_back(index);
+            ids.push_back(node->getId());
+            atoms.push_back(node);
+            nodeLabels.push_back(label.first->second);
+        }
+
+        for (const auto& edge : inputEdges) {
+            if (!edge) continue;
+            const auto& nodeIds = edge->getNodeIds();
+            EdgeGroup& group = groupFor(edge->getLabel(), static_cast<uint32_t>(nodeIds.size()));
+            for (const auto& id : nodeIds) group.members.push_back(intern(id));
+            group.weights.push_back(std::clamp(edge->getWeight(), 0.0, 1.0));
+        }
+
+        for (auto& set : labelNodes) set.finish(ids.size());
+        for (auto& group : edgeGroups) group.finish(ids.size());
+    }
+
+    bool holds(const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+               const std::vector<std::shared_ptr<HypergraphEdge>>& edges) const {
+        return nodes.size() == inputNodes.size() && edges.size() == inputEdges.size() &&
+               std::equal(nodes.begin(), nodes.end(), inputNodes.begin()) &&
+               std::equal(edges.begin(), edges.end(), inputEdges.begin());
+    }
+
+    size_t nodeCount() const { return ids.size(); }
+
+    uint32_t findNode(std::string_view id) const {
+        auto it = idIndex.find(id);
+        return it == idIndex.end() ? UNBOUND : it->second;
+    }
+
+    uint32_t findNodeLabel(std::string_view label) const {
+        auto it = nodeLabelIndex.find(label);
+        return it == nodeLabelIndex.end() ? NO_LABEL : it->second;
+    }
+
+    uint32_t findEdgeGroup(std::string_view label, size_t arity) const {
+        auto it = edgeGroupIndex.find(label);
+        if (it == edgeGroupIndex.end()) return NO_LABEL;
+        for (uint32_t group : it->second) {
+            if (edgeGroups[group].arity == arity) return group;
+        }
+        return NO_LABEL;
+    }
+
+private:
+    uint32_t intern(std::string_view id) {
+        auto inserted = idIndex.emplace(id, static_cast<uint32_t>(ids.size()));
+        if (inserted.second) {
+            ids.push_back(id);
+            atoms.emplace_back();
+            nodeLabels.push_back(NO_LABEL);
+        }
+        return inserted.first->second;
+    }
+
+    EdgeGroup& groupFor(std::string_view label, uint32_t arity) {
+        auto& groups = edgeGroupIndex[label];
+        for (uint32_t group : groups) {
+            if (edgeGroups[group].arity == arity) return edgeGroups[group];
+        }
+        groups.push_back(static_cast<uint32_t>(edgeGroups.size()));
+        edgeGroups.emplace_back();
+        edgeGroups.back().arity = arity;
+        edgeGroups.back().positions.resize(arity);
+        return edgeGroups.back();
+    }
+};
+
+// Compiled patterns
+
+struct Term {
+    bool variable = false;
+    uint32_t value = 0;         // Variable slot, or node index of a constant
+};
+
+struct Operand {
+    enum Kind { LITERAL, ID, LABEL, ATTRIBUTE };
+    Kind kind = LITERAL;
+    uint32_t slot = 0;
+    std::string text;           // Literal or attribute name
+};
+
+struct Comparison {
+    enum Op { EQ, NE, LT, LE, GT, GE };
+    Operand lhs;
+    Operand rhs;
+    Op op = EQ;
+};
+
+struct Scope;
+
+enum class StepKind { NODE, EDGE, OR, NOT, CONSTRAINT, FAIL };
+
+struct Step {
+    StepKind kind = StepKind::FAIL;
+    uint32_t target = 0;                    // Node label or edge group
+    std::vector<Term> terms;
+    std::vector<Scope> branches;            // OR branches, or the body of a NOT
+    std::vector<Comparison> comparisons;
+    std::vector<uint32_t> slots;            // Variables mentioned, including nested ones
+};
+
+struct Scope {
+    std::vector<Step> steps;
+};
+
+struct Plan {
+    Scope root;
+    std::vector<std::string> names;         // Per slot
+    std::vector<bool> reported;             // Bound outside any NOT
+};
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+    return text;
+}
+
+void addSlots(std::vector<uint32_t>& into, const std::vector<uint32_t>& slots) {
+    for (uint32_t slot : slots) {
+        if (std::find(into.begin(), into.end(), slot) == into.end()) into.push_back(slot);
+    }
+}
+
+class PlanBuilder {
+public:
+    explicit PlanBuilder(const AtomIndex& index) : index_(index) {}
+
+    Plan build(const AtomSpacePattern& pattern) {
+        compileInto(plan_.root, pattern, false);
+        return std::move(plan_);
+    }
+
+private:
+    uint32_t slot(const std::string& name, bool negated) {
+        auto inserted = slots_.emplace(name, static_cast<uint32_t>(plan_.names.size()));
+        if (inserted.second) {
+            plan_.names.push_back(name);
+            plan_.reported.push_back(false);
+        }
+        if (!negated) plan_.reported[inserted.first->second] = true;
+        return inserted.first->second;
+    }
+
+    void compileInto(Scope& scope, const AtomSpacePattern& pattern, bool negated) {
+        if (pattern.type.empty() || pattern.type == "AND") {
+            for (const auto& child : pattern.subpatterns) compileInto(scope, child, negated);
+        } else if (pattern.type == "OR") {
+            Step step;
+            step.kind = StepKind::OR;
+            for (const auto& child : pattern.subpatterns) {
+                step.branches.emplace_back();
+                compileInto(step.branches.back(), child, negated);
+                addSlots(step.slots, scopeSlots(step.branches.back()));
+            }
+            if (step.branches.empty()) step.kind = StepKind::FAIL;
+            scope.steps.push_back(std::move(step));
+        } else if (pattern.type == "NOT") {
+            Step step;
+            step.kind = StepKind::NOT;
+            step.branches.emplace_back();
+            for (const auto& child : pattern.subpatterns) compileInto(step.branches.back(), child, true);
+            step.slots = scopeSlots(step.branches.back());
+            scope.steps.push_back(std::move(step));
+        } else {
+            scope.steps.push_back(leaf(pattern, negated));
+            for (const auto& child : pattern.subpatterns) compileInto(scope, child, negated);
+        }
+
+        if (!trim(pattern.constraint).empty()) {
+            scope.steps.push_back(constraint(pattern.constraint, negated));
+        }
+    }
+
+    Step leaf(const AtomSpacePattern& pattern, bool negated) {
+        Step step;
+        for (const auto& term : pattern.variables) {
+            if (!term.empty() && term[0] == '?') {
+                step.terms.push_back({true, slot(term, negated)});
+                addSlots(step.slots, {step.terms.back().value});
+                continue;
+            }
+            uint32_t node = index_.findNode(term);
+            if (node == UNBOUND) {
+                step.kind = StepKind::FAIL;
+                return step;
+            }
+            step.terms.push_back({false, node});
+        }
+
+        uint32_t label = step.terms.size() <= 1 ? index_.findNodeLabel(pattern.type) : NO_LABEL;
+        uint32_t group = index_.findEdgeGroup(pattern.type, step.terms.size());
+        if (label != NO_LABEL && group != NO_LABEL) {
+            // A unary pattern over a label used by nodes and unary edges matches either
+            Step nodeStep = step;
+            nodeStep.kind = StepKind::NODE;
+            nodeStep.target = label;
+            Step edgeStep = step;
+            edgeStep.kind = StepKind::EDGE;
+            edgeStep.target = group;
+            step.kind = StepKind::OR;
+            step.branches.resize(2);
+            step.branches[0].steps.push_back(std::move(nodeStep));
+            step.branches[1].steps.push_back(std::move(edgeStep));
+        } else if (label != NO_LABEL) {
+            step.kind = StepKind::NODE;
+            step.target = label;
+        } else if (group != NO_LABEL) {
+            step.kind = StepKind::EDGE;
+            step.target = group;
+        } else {
+            step.kind = StepKind::FAIL;
+        }
+        return step;
+    }
+
+    Step constraint(const std::string& text, bool negated) {
+        Step step;
+        step.kind = StepKind::CONSTRAINT;
+        std::string_view rest(text);
+        while (true) {
+            size_t split = rest.find("&&");
+            auto comparison = parseComparison(rest.substr(0, split), negated);
+            if (!comparison) return Step{};
+            for (const Operand* operand : {&comparison->lhs, &comparison->rhs}) {
+                if (operand->kind != Operand::LITERAL) addSlots(step.slots, {operand->slot});
+            }
+            step.comparisons.push_back(std::move(*comparison));
+            if (split == std::string_view::npos) break;
+            rest.remove_prefix(split + 2);
+        }
+        return step;
+    }
+
+    std::optional<Comparison> parseComparison(std::string_view text, bool negated) {
+        static const std::pair<const char*, Comparison::Op> OPERATORS[] = {
+            {"==", Comparison::EQ}, {"!=", Comparison::NE}, {"<=", Comparison::LE},
+            {">=", Comparison::GE}, {"<", Comparison::LT}, {">", Comparison::GT}};
+
+        for (size_t i = 0; i < text.size(); ++i) {
+            for (const auto& op : OPERATORS) {
+                std::string_view symbol(op.first);
+                if (text.compare(i, symbol.size(), symbol) != 0) continue;
+                auto lhs = parseOperand(text.substr(0, i), negated);
+                auto rhs = parseOperand(text.substr(i + symbol.size()), negated);
+                if (!lhs || !rhs) return std::nullopt;
+                return Comparison{std::move(*lhs), std::move(*rhs), op.second};
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::optional<Operand> parseOperand(std::string_view text, bool negated) {
+        text = trim(text);
+        if (text.empty()) return std::nullopt;
+
+        Operand operand;
+        if (text[0] == '?') {
+            size_t dot = text.find('.');
+            operand.slot = slot(std::string(text.substr(0, dot)), negated);
+            if (dot == std::string_view::npos || text.substr(dot + 1) == "id") {
+                operand.kind = Operand::ID;
+            } else if (text.substr(dot + 1) == "label") {
+                operand.kind = Operand::LABEL;
+            } else {
+                operand.kind = Operand::ATTRIBUTE;
+                operand.text = std::string(text.substr(dot + 1));
+            }
+            return operand;
+        }
+
+        if (text.size() >= 2 && (text[0] == '"' || text[0] == '\'') && text.back() == text[0]) {
+            text = text.substr(1, text.size() - 2);
+        }
+        operand.text = std::string(text);
+        return operand;
+    }
+
+    static std::vector<uint32_t> scopeSlots(const Scope& scope) {
+        std::vector<uint32_t> slots;
+        for (const auto& step : scope.steps) addSlots(slots, step.slots);
+        return slots;
+    }
+
+    const AtomIndex& index_;
+    Plan plan_;
+    std::unordered_map<std::string, uint32_t> slots_;
+};
+
+// Candidate restriction and join ordering
+
+/**
+ * Per-variable candidate bitsets for one conjunction, intersected over
+ * every clause of it the variable appears in
+ */
+struct Domains {
+    std::vector<std::unique_ptr<Bitset>> sets;
+    std::vector<size_t> sizes;              // Candidate count bound, SIZE_MAX when unrestricted
+    bool empty = false;
+
+    explicit Domains(size_t slots) : sets(slots), sizes(slots, std::numeric_limits<size_t>::max()) {}
+};
+
+Domains restrictDomains(const AtomIndex& index, const Scope& scope, size_t slotCount) {
+    Domains domains(slotCount);
+    std::vector<std::vector<const NodeSet*>> candidates(slotCount);
+    for (const auto& step : scope.steps) {
+        for (size_t position = 0; position < step.terms.size(); ++position) {
+            const Term& term = step.terms[position];
+            if (!term.variable) continue;
+            if (step.kind == StepKind::NODE) {
+                candidates[term.value].push_back(&index.labelNodes[step.target]);
+            } else if (step.kind == StepKind::EDGE) {
+                candidates[term.value].push_back(&index.edgeGroups[step.target].positions[position].nodes);
+            }
+        }
+    }
+
+    for (size_t slot = 0; slot < slotCount; ++slot) {
+        auto& sets = candidates[slot];
+        if (sets.empty()) continue;
+        std::sort(sets.begin(), sets.end(), [](const NodeSet* a, const NodeSet* b) {
+            return a->members.size() < b->members.size();
+        });
+        sets.erase(std::unique(sets.begin(), sets.end()), sets.end());
+        domains.sizes[slot] = sets.front()->members.size();
+        if (sets.size() < 2) continue;
+
+        auto domain = std::make_unique<Bitset>(index.nodeCount());
+        bool allDense = std::all_of(sets.begin(), sets.end(), [](const NodeSet* set) { return set->dense != nullptr; });
+        if (allDense) {
+            *domain = *sets.front()->dense;
+            for (size_t i = 1; i < sets.size(); ++i) domain->intersect(*sets[i]->dense);
+        } else {
+            for (uint32_t node : sets.front()->members) {
+                bool inAll = true;
+                for (size_t i = 1; i < sets.size() && inAll; ++i) inAll = sets[i]->contains(node);
+                if (inAll) domain->set(node);
+            }
+        }
+        domains.sizes[slot] = domain->count();
+        if (domains.sizes[slot] == 0) domains.empty = true;
+        domains.sets[slot] = std::move(domain);
+    }
+    return domains;
+}
+
+bool allBound(const Step& step, const std::vector<bool>& bound) {
+    return std::all_of(step.slots.begin(), step.slots.end(), [&](uint32_t slot) { return bound[slot]; });
+}
+
+double estimateRows(const AtomIndex& index, const Step& step, const std::vector<bool>& bound, const Domains& domains) {
+    switch (step.kind) {
+    case StepKind::FAIL:
+        return 0.0;
+    case StepKind::NODE: {
+        if (step.terms.empty() || !step.terms[0].variable || bound[step.terms[0].value]) return 1.0;
+        return static_cast<double>(std::min(index.labelNodes[step.target].members.size(),
+                                            domains.sizes[step.terms[0].value]));
+    }
+    case StepKind::EDGE: {
+        const EdgeGroup& group = index.edgeGroups[step.target];
+        double rows = static_cast<double>(group.size());
+        for (size_t position = 0; position < step.terms.size(); ++position) {
+            const Term& term = step.terms[position];
+            double distinct = static_cast<double>(std::max<size_t>(1, group.positions[position].nodes.members.size()));
+            if (!term.variable || bound[term.value]) {
+                rows = std::min(rows, static_cast<double>(group.size()) / distinct);
+            } else if (domains.sizes[term.value] != std::numeric_limits<size_t>::max()) {
+                rows *= std::min(1.0, static_cast<double>(domains.sizes[term.value]) / distinct);
+            }
+        }
+        return rows;
+    }
+    case StepKind::OR: {
+        double rows = 0.0;
+        for (const auto& branch : step.branches) {
+            double cheapest = std::numeric_limits<double>::max();
+            for (const auto& inner : branch.steps) {
+                if (inner.kind != StepKind::NOT && inner.kind != StepKind::CONSTRAINT) {
+                    cheapest = std::min(cheapest, estimateRows(index, inner, bound, domains));
+                }
+            }
+            rows += cheapest == std::numeric_limits<double>::max() ? 1.0 : cheapest;
+        }
+        return rows;
+    }
+    default:
+        return 1.0;
+    }
+}
+
+/**
+ * Orders a conjunction greedily by estimated rows given the variables bound
+ * so far; comparisons run as soon as their variables are bound and
+ * negations last. Returns the estimated rows of the first step
+ */
+double orderScope(const AtomIndex& index, Scope& scope, std::vector<bool>& bound, const Domains& domains) {
+    std::vector<Step> pending = std::move(scope.steps);
+    std::vector<Step> negations;
+    scope.steps.clear();
+    double firstRows = 0.0;
+
+    auto placeConstraints = [&]() {
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->kind == StepKind::CONSTRAINT && allBound(*it, bound)) {
+                scope.steps.push_back(std::move(*it));
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    };
+
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->kind == StepKind::NOT) {
+            negations.push_back(std::move(*it));
+            it = pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    placeConstraints();
+    while (true) {
+        auto best = pending.end();
+        double bestRows = std::numeric_limits<double>::max();
+        for (auto it = pending.begin(); it != pending.end(); ++it) {
+            if (it->kind == StepKind::CONSTRAINT) continue;
+            double rows = estimateRows(index, *it, bound, domains);
+            if (rows < bestRows) {
+                bestRows = rows;
+                best = it;
+            }
+        }
+        if (best == pending.end()) break;
+        if (scope.steps.empty()) firstRows = bestRows;
+
+        Step step = std::move(*best);
+        pending.erase(best);
+        for (auto& branch : step.branches) {
+            std::vector<bool> branchBound = bound;
+            orderScope(index, branch, branchBound, domains);
+        }
+        for (uint32_t slot : step.slots) bound[slot] = true;
+        scope.steps.push_back(std::move(step));
+        placeConstraints();
+    }
+
+    // Comparisons over variables no clause binds are evaluated last and fail
+    for (auto& step : pending) scope.steps.push_back(std::move(step));
+    for (auto& step : negations) {
+        std::vector<bool> innerBound = bound;
+        orderScope(index, step.branches[0], innerBound, domains);
+        scope.steps.push_back(std::move(step));
+    }
+    return firstRows;
+}
+
+// Backtracking join
+
+/**
+ * Non-owning reference to the rest of a join, called once per extension
+ * of the current bindings; returns false to stop enumeration
+ */
+class Continuation {
+public:
+    template <typename F>
+    Continuation(F& f) : object_(&f), call_([](void* object) { return (*static_cast<F*>(object))(); }) {}
+
+    bool operator()() const { return call_(object_); }
+
+private:
+    void* object_;
+    bool (*call_)(void*);
+};
+
+struct Solution {
+    std::vector<uint32_t> values;
+    double confidence = 1.0;
+};
+
+class Solver {
+public:
+    Solver(const AtomIndex& index, const Domains& domains, std::vector<uint32_t> values)
+        : index_(index), domains_(domains), values_(std::move(values)) {}
+
+    std::vector<Solution> solveAll(const Scope& scope, size_t limit) {
+        std::vector<Solution> solutions;
+        auto collect = [&]() {
+            solutions.push_back({values_, confidence_});
+            return solutions.size() < limit;
+        };
+        if (limit > 0) run(scope, 0, collect);
+        return solutions;
+    }
+
+private:
+    bool run(const Scope& scope, size_t i, Continuation done) {
+        if (i == scope.steps.size()) return done();
+        const Step& step = scope.steps[i];
+        auto next = [&]() { return run(scope, i + 1, done); };
+
+        switch (step.kind) {
+        case StepKind::FAIL:
+            return true;
+        case StepKind::CONSTRAINT:
+            return evaluate(step) ? next() : true;
+        case StepKind::NOT: {
+            bool found = false;
+            auto witness = [&]() {
+                found = true;
+                return false;
+            };
+            run(step.branches[0], 0, witness);
+            return found ? true : next();
+        }
+        case StepKind::OR:
+            for (const auto& branch : step.branches) {
+                if (!run(branch, 0, next)) return false;
+            }
+            return true;
+        case StepKind::NODE:
+            return matchNode(step, next);
+        case StepKind::EDGE:
+            return matchEdge(step, next);
+        }
+        return true;
+    }
+
+    bool matchNode(const Step& step, Continuation next) {
+        if (step.terms.empty()) return next();
+
+        const Term& term = step.terms[0];
+        uint32_t node = term.variable ? values_[term.value] : term.value;
+        if (node != UNBOUND) return index_.nodeLabels[node] == step.target ? next() : true;
+
+        const NodeSet& members = index_.labelNodes[step.target];
+        const Bitset* domain = domains_.sets[term.value].get();
+        auto visit = [&](uint32_t candidate) {
+            values_[term.value] = candidate;
+            bool more = next();
+            values_[term.value] = UNBOUND;
+            return more;
+        };
+
+        if (domain && domains_.sizes[term.value] < members.members.size()) {
+            return domain->forEach([&](uint32_t candidate) {
+                return index_.nodeLabels[candidate] != step.target || visit(candidate);
+            });
+        }
+        for (uint32_t candidate : members.members) {
+            if (domain && !domain->test(candidate)) continue;
+            if (!visit(candidate)) return false;
+        }
+        return true;
+    }
+
+    bool matchEdge(const Step& step, Continuation next) {
+        const EdgeGroup& group = index_.edgeGroups[step.target];
+        const size_t arity = group.arity;
+
+        // Drive from the fewest edges holding a bound node, if any
+        EdgeRun run = group.all();
+        bool driven = false;
+        for (size_t position = 0; position < arity; ++position) {
+            const Term& term = step.terms[position];
+            uint32_t node = term.variable ? values_[term.value] : term.value;
+            if (node == UNBOUND) continue;
+            EdgeRun holding = group.holding(static_cast<uint32_t>(position), node);
+            if (holding.count == 0) return true;
+            if (!driven || holding.count < run.count) {
+                run = holding;
+                driven = true;
+            }
+        }
+
+        for (size_t edge = 0; edge < run.count; ++edge) {
+            const uint32_t* members = run.members + edge * arity;
+            size_t mark = trail_.size();
+            bool matches = true;
+            for (size_t position = 0; position < arity && matches; ++position) {
+                const Term& term = step.terms[position];
+                uint32_t node = members[position];
+                if (!term.variable) {
+                    matches = node == term.value;
+                } else if (values_[term.value] != UNBOUND) {
+                    matches = values_[term.value] == node;
+                } else if (domains_.sets[term.value] && !domains_.sets[term.value]->test(node)) {
+                    matches = false;
+                } else {
+                    values_[term.value] = node;
+                    trail_.push_back(term.value);
+                }
+            }
+
+            bool bindsNew = trail_.size() > mark;
+            bool more = true;
+            if (matches) {
+                double saved = confidence_;
+                confidence_ *= run.weights[edge];
+                more = next();
+                confidence_ = saved;
+            }
+            while (trail_.size() > mark) {
+                values_[trail_.back()] = UNBOUND;
+                trail_.pop_back();
+            }
+            if (!more) return false;
+            // A clause binding nothing new is an existence check
+            if (matches && !bindsNew) break;
+        }
+        return true;
+    }
+
+    bool evaluate(const Step& step) const {
+        for (const auto& comparison : step.comparisons) {
+            auto lhs = resolve(comparison.lhs);
+            auto rhs = resolve(comparison.rhs);
+            if (!lhs || !rhs || !compare(*lhs, *rhs, comparison.op)) return false;
+        }
+        return true;
+    }
+
+    std::optional<std::string> resolve(const Operand& operand) const {
+        if (operand.kind == Operand::LITERAL) return operand.text;
+        uint32_t node = values_[operand.slot];
+        if (node == UNBOUND) return std::nullopt;
+        if (operand.kind == Operand::ID) return std::string(index_.ids[node]);
+
+        const auto& atom = index_.atoms[node];
+        if (!atom) return std::nullopt;
+        if (operand.kind == Operand::LABEL) return atom->getLabel();
+        return atom->getAttribute(operand.text);
+    }
+
+    static bool compare(const std::string& lhs, const std::string& rhs, Comparison::Op op) {
+        if (op == Comparison::EQ) return lhs == rhs;
+        if (op == Comparison::NE) return lhs != rhs;
+
+        char* lhsEnd = nullptr;
+        char* rhsEnd = nullptr;
+        double a = std::strtod(lhs.c_str(), &lhsEnd);
+        double b = std::strtod(rhs.c_str(), &rhsEnd);
+        if (lhs.empty() || rhs.empty() || *lhsEnd != '\0' || *rhsEnd != '\0') return false;
+        switch (op) {
+        case Comparison::LT: return a < b;
+        case Comparison::LE: return a <= b;
+        case Comparison::GT: return a > b;
+        case Comparison::GE: return a >= b;
+        default: return false;
+        }
+    }
+
+    const AtomIndex& index_;
+    const Domains& domains_;
+    std::vector<uint32_t> values_;
+    std::vector<uint32_t> trail_;
+    double confidence_ = 1.0;
+};
+
+// Query execution
+
+struct ExecutionOptions {
+    size_t limit = 0;
+    bool parallel = true;
+    size_t parallelThreshold = 0;
+};
+
+/**
+ * Splits a conjunction into groups of steps that share no variables
+ */
+std::vector<Scope> splitIndependent(Scope scope, const std::vector<uint32_t>& prebound, size_t slotCount) {
+    std::vector<uint32_t> parent(slotCount);
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find = [&](uint32_t slot) {
+        while (parent[slot] != slot) slot = parent[slot] = parent[parent[slot]];
+        return slot;
+    };
+
+    for (const auto& step : scope.steps) {
+        for (size_t i = 1; i < step.slots.size(); ++i) parent[find(step.slots[i])] = find(step.slots[0]);
+    }
+
+    std::vector<Scope> groups;
+    std::unordered_map<uint32_t, size_t> groupOf;
+    for (auto& step : scope.steps) {
+        // Steps over prebound variables only, or over none, stay with the first group
+        uint32_t root = UNBOUND;
+        for (uint32_t slot : step.slots) {
+            if (prebound[slot] == UNBOUND) {
+                root = find(slot);
+                break;
+            }
+        }
+        size_t group = 0;
+        if (root != UNBOUND) {
+            auto inserted = groupOf.emplace(root, groups.empty() ? 0 : groups.size());
+            group = inserted.first->second;
+        }
+        if (group >= groups.size()) groups.resize(group + 1);
+        groups[group].steps.push_back(std::move(step));
+    }
+    if (groups.empty()) groups.emplace_back();
+    return groups;
+}
+
+/**
+ * Runs solveOne(0..count) with all but the first on the global executor;
+ * waits for every task before rethrowing the first failure
+ */
+template <typename F>
+std::vector<std::vector<Solution>> solveConcurrently(size_t count, F&& solveOne) {
+    std::vector<Future<std::vector<Solution>>> pending;
+    for (size_t i = 1; i < count; ++i) {
+        pending.push_back(Executor::global().submit([&solveOne, i]() { return solveOne(i); }));
+    }
+
+    std::vector<std::vector<Solution>> results(count);
+    std::exception_ptr error;
+    try {
+        results[0] = solveOne(0);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (size_t i = 1; i < count; ++i) {
+        try {
+            results[i] = pending[i - 1].get();
+        } catch (...) {
+            if (!error) error = std::current_exception();
+        }
+    }
+    if (error) std::rethrow_exception(error);
+    return results;
+}
+
+std::vector<Solution> solveConjunction(const AtomIndex& index, Scope scope, const std::vector<uint32_t>& prebound,
+                                       const ExecutionOptions& options) {
+    const size_t slotCount = prebound.size();
+    Domains domains = restrictDomains(index, scope, slotCount);
+    if (domains.empty) return {};
+
+    std::vector<Scope> groups = splitIndependent(std::move(scope), prebound, slotCount);
+    std::vector<double> rows(groups.size());
+    double totalRows = 0.0;
+    for (size_t i = 0; i < groups.size(); ++i) {
+        std::vector<bool> bound(slotCount);
+        for (size_t slot = 0; slot < slotCount; ++slot) bound[slot] = prebound[slot] != UNBOUND;
+        rows[i] = orderScope(index, groups[i], bound, domains);
+        totalRows += rows[i];
+    }
+
+    auto solveGroup = [&](size_t i) {
+        return Solver(index, domains, prebound).solveAll(groups[i], options.limit);
+    };
+
+    std::vector<std::vector<Solution>> results(groups.size());
+    if (groups.size() > 1 && options.parallel && totalRows >= static_cast<double>(options.parallelThreshold)) {
+        results = solveConcurrently(groups.size(), solveGroup);
+    } else {
+        for (size_t i = 0; i < groups.size(); ++i) {
+            results[i] = solveGroup(i);
+            if (results[i].empty()) return {};
+        }
+    }
+    if (groups.size() == 1) return std::move(results[0]);
+
+    // Cross product of the independent groups, up to the limit
+    std::vector<Solution> combined = std::move(results[0]);
+    for (size_t i = 1; i < results.size() && !combined.empty(); ++i) {
+        std::vector<Solution> product;
+        for (const auto& left : combined) {
+            for (const auto& right : results[i]) {
+                if (product.size() >= options.limit) break;
+                Solution merged = left;
+                for (size_t slot = 0; slot < slotCount; ++slot) {
+                    if (right.values[slot] != UNBOUND) merged.values[slot] = right.values[slot];
+                }
+                merged.confidence *= right.confidence;
+                product.push_back(std::move(merged));
+            }
+        }
+        combined = std::move(product);
+    }
+    return combined;
+}
+
+std::vector<Solution> solve(const AtomIndex& index, Plan& plan, const std::vector<uint32_t>& prebound,
+                            const ExecutionOptions& options) {
+    auto& steps = plan.root.steps;
+    if (steps.size() != 1 || steps[0].kind != StepKind::OR) {
+        return solveConjunction(index, std::move(plan.root), prebound, options);
+    }
+
+    // A top-level disjunction: each branch is a conjunction of its own
+    auto& branches = steps[0].branches;
+    auto solveBranch = [&](size_t i) { return solveConjunction(index, std::move(branches[i]), prebound, options); };
+    std::vector<std::vector<Solution>> results(branches.size());
+    if (options.parallel && branches.size() > 1) {
+        results = solveConcurrently(branches.size(), solveBranch);
+    } else {
+        for (size_t i = 0; i < branches.size(); ++i) results[i] = solveBranch(i);
+    }
+
+    std::vector<Solution> combined;
+    for (auto& result : results) {
+        for (auto& solution : result) {
+            if (combined.size() >= options.limit) return combined;
+            combined.push_back(std::move(solution));
+        }
+    }
+    return combined;
+}
+
+PatternMatch toMatch(const AtomIndex& index, const Plan& plan, const Solution& solution, const std::string& type) {
+    PatternMatch match(true, solution.confidence, type);
+    for (size_t slot = 0; slot < plan.names.size(); ++slot) {
+        if (plan.reported[slot] && solution.values[slot] != UNBOUND) {
+            match.bindings.emplace_back(plan.names[slot], std::string(index.ids[solution.values[slot]]));
+        }
+    }
+    return match;
+}
+
+std::vector<std::string_view> tokenize(std::string_view text) {
+    std::vector<std::string_view> tokens;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        size_t start = i;
+        while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+        if (i > start) tokens.push_back(text.substr(start, i - start));
+    }
+    return tokens;
+}
+
+} // anonymous namespace
+
+class AtomSpacePatternMatcher::Index : public AtomIndex {
+public:
+    using AtomIndex::AtomIndex;
+};
+
+// AtomSpacePatternMatcher implementation
+
+AtomSpacePatternMatcher::AtomSpacePatternMatcher() : AtomSpacePatternMatcher(Config{}) {}
+
+AtomSpacePatternMatcher::AtomSpacePatternMatcher(const Config& config) : config_(config) {}
+
+AtomSpacePatternMatcher::~AtomSpacePatternMatcher() = default;
+
+double AtomSpacePatternMatcher::matchPattern(const std::string& input, const std::string& pattern) {
+    auto inputTokens = tokenize(input);
+    auto patternTokens = tokenize(pattern);
+    if (patternTokens.empty()) return 0.0;
+
+    size_t best = 0;
+    size_t offsets = inputTokens.size() >= patternTokens.size() ? inputTokens.size() - patternTokens.size() + 1 : 1;
+    for (size_t offset = 0; offset < offsets; ++offset) {
+        size_t matched = 0;
+        for (size_t i = 0; i < patternTokens.size() && offset + i < inputTokens.size(); ++i) {
+            if (patternTokens[i][0] == '?' || patternTokens[i] == inputTokens[offset + i]) ++matched;
+        }
+        best = std::max(best, matched);
+    }
+    return static_cast<double>(best) / static_cast<double>(patternTokens.size());
+}
+
+std::vector<std::string> AtomSpacePatternMatcher::extractPatterns(const std::string& input) {
+    std::vector<std::string> patterns;
+    auto index = currentIndex();
+    if (!index) return patterns;
+
+    std::unordered_set<std::string_view> seen;
+    auto consider = [&](std::string_view token) {
+        bool known = index->nodeLabelIndex.count(token) || index->edgeGroupIndex.count(token);
+        if (known && seen.insert(token).second) patterns.emplace_back(token);
+    };
+    consider(trim(input));
+    for (auto token : tokenize(input)) {
+        while (!token.empty() && std::ispunct(static_cast<unsigned char>(token.back()))) token.remove_suffix(1);
+        while (!token.empty() && std::ispunct(static_cast<unsigned char>(token.front()))) token.remove_prefix(1);
+        if (!token.empty()) consider(token);
+    }
+    return patterns;
+}
+
+PatternMatch AtomSpacePatternMatcher::matchAtomSpacePattern(const AtomSpacePattern& pattern,
+                                                            const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                                            const std::vector<std::shared_ptr<HypergraphEdge>>& edges) {
+    auto index = indexFor(nodes, edges);
+    Plan plan = PlanBuilder(*index).build(pattern);
+    ExecutionOptions options{1, config_.parallel, config_.parallelThreshold};
+    auto solutions = solve(*index, plan, std::vector<uint32_t>(plan.names.size(), UNBOUND), options);
+    if (solutions.empty()) return PatternMatch(false, 0.0, pattern.type);
+    return toMatch(*index, plan, solutions.front(), pattern.type);
+}
+
+std::vector<PatternMatch> AtomSpacePatternMatcher::findAllMatches(const AtomSpacePattern& pattern,
+                                                                  const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                                                  const std::vector<std::shared_ptr<HypergraphEdge>>& edges) {
+    indexFor(nodes, edges);
+    return query(pattern);
+}
+
+std::vector<std::shared_ptr<HypergraphNode>> AtomSpacePatternMatcher::traverseAtomSpace(
+    const AtomSpacePattern& pattern, const std::shared_ptr<HypergraphNode>& startNode) {
+    std::vector<std::shared_ptr<HypergraphNode>> result;
+    auto index = currentIndex();
+    if (!index || !startNode) return result;
+
+    uint32_t start = index->findNode(startNode->getId());
+    if (start == UNBOUND) return result;
+    Plan plan = PlanBuilder(*index).build(pattern);
+    if (plan.names.empty()) return result;
+
+    std::vector<uint32_t> prebound(plan.names.size(), UNBOUND);
+    prebound[0] = start;
+    ExecutionOptions options{config_.maxMatches, config_.parallel, config_.parallelThreshold};
+    std::unordered_set<uint32_t> seen{start};
+    for (const auto& solution : solve(*index, plan, prebound, options)) {
+        for (size_t slot = 1; slot < plan.names.size(); ++slot) {
+            uint32_t node = solution.values[slot];
+            if (plan.reported[slot] && node != UNBOUND && index->atoms[node] && seen.insert(node).second) {
+                result.push_back(index->atoms[node]);
+            }
+        }
+    }
+    return result;
+}
+
+void AtomSpacePatternMatcher::setAtomSpace(const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                           const std::vector<std::shared_ptr<HypergraphEdge>>& edges) {
+    auto index = std::make_shared<const Index>(nodes, edges);
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_ = std::move(index);
+}
+
+std::vector<PatternMatch> AtomSpacePatternMatcher::query(const AtomSpacePattern& pattern, size_t maxMatches) const {
+    std::vector<PatternMatch> matches;
+    auto index = currentIndex();
+    if (!index) return matches;
+
+    Plan plan = PlanBuilder(*index).build(pattern);
+    ExecutionOptions options{maxMatches ? maxMatches : config_.maxMatches, config_.parallel, config_.parallelThreshold};
+    auto solutions = solve(*index, plan, std::vector<uint32_t>(plan.names.size(), UNBOUND), options);
+    matches.reserve(solutions.size());
+    for (const auto& solution : solutions) matches.push_back(toMatch(*index, plan, solution, pattern.type));
+    return matches;
+}
+
+size_t AtomSpacePatternMatcher::getNodeCount() const {
+    auto index = currentIndex();
+    return index ? index->inputNodes.size() : 0;
+}
+
+size_t AtomSpacePatternMatcher::getEdgeCount() const {
+    auto index = currentIndex();
+    return index ? index->inputEdges.size() : 0;
+}
+
+std::shared_ptr<const AtomSpacePatternMatcher::Index> AtomSpacePatternMatcher::indexFor(
+    const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+    const std::vector<std::shared_ptr<HypergraphEdge>>& edges) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (index_ && index_->holds(nodes, edges)) return index_;
+    }
+    setAtomSpace(nodes, edges);
+    return currentIndex();
+}
+
+std::shared_ptr<const AtomSpacePatternMatcher::Index> AtomSpacePatternMatcher::currentIndex() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_;
+}
+
+} // namespace elizaos
@@ -1,5 +1,6 @@
 #include "elizaos/core.hpp"
-#include <random>
+#include "elizaos/atomspace_matcher.hpp"
+#include "elizaos/metrics.hpp"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
@@ -7,6 +8,35 @@
 
 namespace elizaos {
 
+namespace {
+
+struct TaskMetrics {
+    Counter& completed;
+    Counter& failed;
+    Gauge& pending;
+    Histogram& executionLatency;
+};
+
+TaskMetrics& taskMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static TaskMetrics metrics{
+        registry.counter("elizaos_tasks_completed_total", "Task executions that succeeded"),
+        registry.counter("elizaos_tasks_failed_total", "Task executions that failed or threw"),
+        registry.gauge("elizaos_tasks_pending", "Pending tasks seen by the last scheduler pass"),
+        registry.histogram("elizaos_task_execution_seconds", "Task worker latency", {}, 1e-9)};
+    return metrics;
+}
+
+// Logs a task entering a TaskManager to the active trace, if any
+void recordTaskInput(const Task& task) {
+    if (!TraceRecorder::isActive()) return;
+    SnapshotWriter payload;
+    writeTask(payload, task);
+    TraceRecorder::recordActive(TraceEventKind::TASK, task.getRoomId(), payload.data());
+}
+
+} // anonymous namespace
+
 // TruthValue operations implementation
 TruthValue TruthValue::conjunction(const TruthValue& other) const {
     // PLN conjunction: strength = min(s1, s2), confidence = min(c1, c2)
@@ -29,37 +59,8 @@ TruthValue TruthValue::implication(const TruthValue& other) const {
     return TruthValue(implStrength, std::min(confidence, other.confidence));
 }
 
-// Utility function to generate UUIDs (simplified version)
 std::string generateUUID() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
-    
-    std::stringstream ss;
-    int i;
-    ss << std::hex;
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    ss << "-4";
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    }
-    return ss.str();
+    return Uuid::v4().toString();
 }
 
 // HypergraphNode implementation
@@ -87,7 +88,7 @@ HypergraphEdge::HypergraphEdge(const UUID& id, const std::string& label, const s
 // Enhanced Memory implementation
 Memory::Memory(const UUID& id, const std::string& content, const UUID& entityId, const UUID& agentId)
     : id_(id), content_(content), entityId_(entityId), agentId_(agentId), 
-      createdAt_(std::chrono::system_clock::now()) {
+      createdAt_(VirtualClock::now()) {
     // Default metadata
     MessageMetadata defaultMetadata;
     metadata_ = defaultMetadata;
@@ -96,37 +97,53 @@ Memory::Memory(const UUID& id, const std::string& content, const UUID& entityId,
 Memory::Memory(const UUID& id, const std::string& content, const UUID& entityId, const UUID& agentId, 
                const MemoryMetadata& metadata)
     : id_(id), content_(content), entityId_(entityId), agentId_(agentId), 
-      createdAt_(std::chrono::system_clock::now()), metadata_(metadata) {
+      createdAt_(VirtualClock::now()), metadata_(metadata) {
 }
 
 // State implementation  
-State::State(const AgentConfig& config) : config_(config) {
+State::State(const AgentConfig& config) {
+    auto initial = std::make_shared<StateVersion>();
+    initial->config = config;
+    current_ = std::move(initial);
+}
+
+State::State(const State& other) : current_(other.snapshot()) {
+}
+
+State& State::operator=(const State& other) {
+    if (this != &other) {
+        auto source = other.snapshot();
+        update([&](StateVersion& next) { next = *source; });
+    }
+    return *this;
+}
+
+void State::update(const std::function<void(StateVersion&)>& mutate) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto next = std::make_shared<StateVersion>(*current_);
+    mutate(*next);
+    next->version = current_->version + 1;
+    std::atomic_store(&current_, std::shared_ptr<const StateVersion>(std::move(next)));
 }
 
 void State::addActor(const Actor& actor) {
-    actors_.push_back(actor);
+    update([&](StateVersion& next) { next.actors = next.actors.pushBack(actor); });
 }
 
 void State::addGoal(const Goal& goal) {
-    goals_.push_back(goal);
+    update([&](StateVersion& next) { next.goals = next.goals.pushBack(goal); });
 }
 
 void State::addRecentMessage(std::shared_ptr<Memory> memory) {
-    recentMessages_.push_back(memory);
-    
-    // Keep only recent messages (e.g., last 32)
-    const size_t maxRecentMessages = 32;
-    if (recentMessages_.size() > maxRecentMessages) {
-        recentMessages_.erase(recentMessages_.begin(), 
-                            recentMessages_.begin() + (recentMessages_.size() - maxRecentMessages));
-    }
+    // The ring keeps only the last MAX_RECENT_MESSAGES
+    update([&](StateVersion& next) { next.recentMessages = next.recentMessages.pushBack(std::move(memory)); });
 }
 
 // Task implementation
 Task::Task(const UUID& id, const std::string& name, const std::string& description)
     : id_(id), name_(name), description_(description), 
-      createdAt_(std::chrono::system_clock::now()),
-      updatedAt_(std::chrono::system_clock::now()) {
+      createdAt_(VirtualClock::now()),
+      updatedAt_(VirtualClock::now()) {
 }
 
 // TaskManager implementation
@@ -139,18 +156,25 @@ TaskManager::~TaskManager() {
 
 UUID TaskManager::createTask(const std::string& name, const std::string& description, 
                             const UUID& roomId, const UUID& worldId) {
-    (void)roomId; // Mark as intentionally unused
-    (void)worldId; // Mark as intentionally unused
-    
     std::lock_guard<std::mutex> lock(tasksMutex_);
     
     UUID taskId = generateUUID();
     auto task = std::make_shared<Task>(taskId, name, description);
+    task->setRoomId(roomId);
+    task->setWorldId(worldId);
     
     tasks_[taskId] = task;
+    recordTaskInput(*task);
     return taskId;
 }
 
+bool TaskManager::addTask(std::shared_ptr<Task> task) {
+    std::lock_guard<std::mutex> lock(tasksMutex_);
+    if (!tasks_.emplace(task->getId(), task).second) return false;
+    recordTaskInput(*task);
+    return true;
+}
+
 bool TaskManager::scheduleTask(const UUID& taskId, const Timestamp& scheduledTime) {
     std::lock_guard<std::mutex> lock(tasksMutex_);
     
@@ -229,16 +253,16 @@ void TaskManager::start() {
     if (!running_) {
         running_ = true;
         paused_ = false;
-        executionThread_ = std::thread(&TaskManager::executionLoop, this);
+        ticker_.start(tickInterval_, [this] {
+            if (!paused_) processPendingTasks();
+        });
     }
 }
 
 void TaskManager::stop() {
     if (running_) {
         running_ = false;
-        if (executionThread_.joinable()) {
-            executionThread_.join();
-        }
+        ticker_.stop();
     }
 }
 
@@ -250,18 +274,15 @@ void TaskManager::resume() {
     paused_ = false;
 }
 
-void TaskManager::executionLoop() {
-    while (running_) {
-        if (!paused_) {
-            processPendingTasks();
-        }
-        std::this_thread::sleep_for(tickInterval_);
-    }
+void TaskManager::setTickInterval(std::chrono::milliseconds interval) {
+    tickInterval_ = interval;
+    ticker_.setInterval(interval);
 }
 
 void TaskManager::processPendingTasks() {
     auto pendingTasks = getPendingTasks();
-    auto now = std::chrono::system_clock::now();
+    auto now = VirtualClock::now();
+    taskMetrics().pending.set(static_cast<int64_t>(pendingTasks.size()));
     
     for (auto& task : pendingTasks) {
         // Check if task should be executed now
@@ -293,6 +314,7 @@ bool TaskManager::executeTask(std::shared_ptr<Task> task) {
     task->setStatus(TaskStatus::RUNNING);
     task->updateTimestamp();
     
+    TraceSpan span("task.execute", &taskMetrics().executionLatency);
     try {
         // Create a dummy state for now - in real usage this would come from context
         AgentConfig dummyConfig{"", "", "", "", ""};
@@ -315,9 +337,11 @@ bool TaskManager::executeTask(std::shared_ptr<Task> task) {
         } else {
             task->setStatus(TaskStatus::FAILED);
         }
+        (success ? taskMetrics().completed : taskMetrics().failed).increment();
         return success;
     } catch (...) {
         task->setStatus(TaskStatus::FAILED);
+        taskMetrics().failed.increment();
         return false;
     }
 }
@@ -482,6 +506,7 @@ void PLNInferenceEngine::setAtomSpace(const std::vector<std::shared_ptr<Hypergra
     std::lock_guard<std::mutex> lock(atomSpaceMutex_);
     atomSpaceNodes_ = nodes;
     atomSpaceEdges_ = edges;
+    atomSpaceIndexed_ = false;
 }
 
 std::vector<std::shared_ptr<HypergraphNode>> PLNInferenceEngine::queryAtomSpace(const std::string& query) {
@@ -497,6 +522,20 @@ std::vector<std::shared_ptr<HypergraphNode>> PLNInferenceEngine::queryAtomSpace(
     return results;
 }
 
+std::vector<PatternMatch> PLNInferenceEngine::matchAtomSpace(const AtomSpacePattern& pattern, size_t maxMatches) {
+    std::shared_ptr<AtomSpacePatternMatcher> matcher;
+    {
+        std::lock_guard<std::mutex> lock(atomSpaceMutex_);
+        if (!atomSpaceMatcher_) atomSpaceMatcher_ = std::make_shared<AtomSpacePatternMatcher>();
+        if (!atomSpaceIndexed_) {
+            atomSpaceMatcher_->setAtomSpace(atomSpaceNodes_, atomSpaceEdges_);
+            atomSpaceIndexed_ = true;
+        }
+        matcher = atomSpaceMatcher_;
+    }
+    return matcher->query(pattern, maxMatches);
+}
+
 bool PLNInferenceEngine::unify(const std::string& pattern, const std::string& target, std::vector<VariableBinding>& bindings) {
     // Simple unification - check if pattern matches target
     // In a full implementation, this would handle variables and more complex patterns
@@ -0,0 +1,463 @@
+#include "elizaos/embedding_service.hpp"
+#include "elizaos/metrics.hpp"
+#include "elizaos/snapshot.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace elizaos {
+
+namespace {
+
+constexpr char CACHE_MAGIC[8] = {'E', 'O', 'S', 'E', 'M', 'B', 'C', '\0'};
+constexpr uint64_t CACHE_FORMAT_VERSION = 2;    // 2 stores each text beside its embedding
+constexpr float BIGRAM_WEIGHT = 0.5f;
+
+struct EmbeddingMetrics {
+    Counter& hits;
+    Counter& misses;
+    Counter& embedded;
+    Histogram& batchLatency;
+};
+
+EmbeddingMetrics& embeddingMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static EmbeddingMetrics metrics{
+        registry.counter("elizaos_embedding_cache_hits_total", "Embedding requests answered from cache"),
+        registry.counter("elizaos_embedding_cache_misses_total", "Embedding requests not in cache"),
+        registry.counter("elizaos_embeddings_computed_total", "Texts embedded by a processor"),
+        registry.histogram("elizaos_embedding_batch_seconds", "Processor latency per embedding batch", {}, 1e-9)};
+    return metrics;
+}
+
+uint64_t fnv1a(std::string_view bytes, uint64_t hash = 14695981039346656037ull) {
+    for (unsigned char c : bytes) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// splitmix64 finaliser, so nearby FNV values spread over all bits
+uint64_t mix(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xbf58476d1ce4e5b9ull;
+    value ^= value >> 27;
+    value *= 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+void addFeature(EmbeddingVector& embedding, uint64_t hash, float weight) {
+    size_t bucket = static_cast<size_t>(hash % embedding.size());
+    embedding[bucket] += (hash >> 63) ? -weight : weight;
+}
+
+} // anonymous namespace
+
+// HashingEmbeddingProcessor implementation
+
+HashingEmbeddingProcessor::HashingEmbeddingProcessor(size_t dimensions) : dimensions_(std::max<size_t>(1, dimensions)) {}
+
+EmbeddingVector HashingEmbeddingProcessor::generateEmbedding(const std::string& input) {
+    EmbeddingVector embedding(dimensions_, 0.0f);
+    std::string word;
+    uint64_t previous = 0;
+    bool hasPrevious = false;
+
+    auto flush = [&]() {
+        if (word.empty()) return;
+        uint64_t hash = mix(fnv1a(word));
+        addFeature(embedding, hash, 1.0f);
+        if (hasPrevious) addFeature(embedding, mix(previous * 31 + hash), BIGRAM_WEIGHT);
+        previous = hash;
+        hasPrevious = true;
+        word.clear();
+    };
+
+    for (unsigned char c : input) {
+        // Bytes of multi-byte UTF-8 sequences count as word characters
+        if (std::isalnum(c) || c >= 0x80) {
+            word.push_back(static_cast<char>(std::tolower(c)));
+        } else {
+            flush();
+        }
+    }
+    flush();
+
+    double norm = 0.0;
+    for (float value : embedding) norm += static_cast<double>(value) * value;
+    if (norm > 0.0) {
+        float scale = static_cast<float>(1.0 / std::sqrt(norm));
+        for (float& value : embedding) value *= scale;
+    }
+    return embedding;
+}
+
+std::vector<EmbeddingVector> HashingEmbeddingProcessor::generateEmbeddings(const std::vector<std::string>& inputs) {
+    std::vector<EmbeddingVector> embeddings;
+    embeddings.reserve(inputs.size());
+    for (const auto& input : inputs) embeddings.push_back(generateEmbedding(input));
+    return embeddings;
+}
+
+double HashingEmbeddingProcessor::computeSimilarity(const EmbeddingVector& a, const EmbeddingVector& b) {
+    if (a.size() != b.size() || a.empty()) return 0.0;
+    double dot = 0.0;
+    double normA = 0.0;
+    double normB = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        dot += static_cast<double>(a[i]) * b[i];
+        normA += static_cast<double>(a[i]) * a[i];
+        normB += static_cast<double>(b[i]) * b[i];
+    }
+    if (normA == 0.0 || normB == 0.0) return 0.0;
+    return dot / (std::sqrt(normA) * std::sqrt(normB));
+}
+
+std::vector<std::string> HashingEmbeddingProcessor::generateResponse(const EmbeddingVector& context) {
+    (void)context;
+    return {};
+}
+
+// EmbeddingService implementation
+
+EmbeddingService::EmbeddingService(std::shared_ptr<ConnectionistProcessor> processor, EmbeddingServiceConfig config)
+    : processor_(std::move(processor)), config_(std::move(config)) {
+    if (!processor_) throw std::invalid_argument("EmbeddingService requires a processor");
+    if (!config_.cachePath.empty()) {
+        std::ifstream existing(config_.cachePath, std::ios::binary);
+        if (existing) loadCache(config_.cachePath);
+    }
+}
+
+EmbeddingService::~EmbeddingService() {
+    MemoryGovernor::global().unregisterConsumer(*this);
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        stopping_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [&]() { return !draining_ && !drainPosted_; });
+    }
+    if (!config_.cachePath.empty()) saveCache(config_.cachePath);
+}
+
+uint64_t EmbeddingService::contentKey(std::string_view text) {
+    return mix(fnv1a(text) ^ text.size());
+}
+
+Future<EmbeddingVector> EmbeddingService::embedAsync(const std::string& text) {
+    bool post = false;
+    Future<EmbeddingVector> future = request(text, &post);
+    if (post) Executor::global().postBlocking([this]() { drainPosted(); });
+    return future;
+}
+
+EmbeddingVector EmbeddingService::embed(const std::string& text) {
+    Future<EmbeddingVector> future = request(text, nullptr);
+    if (!future.isReady()) drainInline();
+    return future.get();
+}
+
+std::vector<EmbeddingVector> EmbeddingService::embedAll(const std::vector<std::string>& texts) {
+    std::vector<Future<EmbeddingVector>> futures;
+    futures.reserve(texts.size());
+    for (const auto& text : texts) futures.push_back(request(text, nullptr));
+    drainInline();
+
+    std::vector<EmbeddingVector> embeddings;
+    embeddings.reserve(texts.size());
+    for (auto& future : futures) embeddings.push_back(future.get());
+    return embeddings;
+}
+
+Future<EmbeddingVector> EmbeddingService::request(const std::string& text, bool* postDrain) {
+    auto& metrics = embeddingMetrics();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto cached = cache_.find(text);
+    if (cached != cache_.end()) {
+        ++stats_.hits;
+        metrics.hits.increment();
+        lru_.splice(lru_.begin(), lru_, cached->second);
+        return makeReadyFuture(cached->second->embedding);
+    }
+    ++stats_.misses;
+    metrics.misses.increment();
+
+    Promise<EmbeddingVector> promise;
+    Future<EmbeddingVector> future = promise.getFuture();
+    auto flight = inFlight_.find(text);
+    if (flight != inFlight_.end()) {
+        ++stats_.deduplicated;
+        flight->second.push_back(std::move(promise));
+        return future;
+    }
+
+    inFlight_[text].push_back(std::move(promise));
+    queue_.push_back(text);
+    if (draining_) {
+        if (queue_.size() >= config_.maxBatchSize) changed_.notify_all();
+    } else if (postDrain && !drainPosted_) {
+        drainPosted_ = true;
+        *postDrain = true;
+    }
+    return future;
+}
+
+void EmbeddingService::drainPosted() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    drainPosted_ = false;
+    if (draining_) {
+        changed_.notify_all();
+        return;
+    }
+    draining_ = true;
+    drainLocked(lock);
+}
+
+void EmbeddingService::drainInline() {
+    // Also takes over from a posted drain that has not started, which may
+    // be queued behind the very pool worker calling this
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (draining_ || queue_.empty()) return;
+    draining_ = true;
+    drainLocked(lock);
+}
+
+void EmbeddingService::drainLocked(std::unique_lock<std::mutex>& lock) {
+    const size_t maxBatch = std::max<size_t>(1, config_.maxBatchSize);
+    auto& metrics = embeddingMetrics();
+
+    while (true) {
+        if (config_.maxBatchDelay.count() > 0 && !queue_.empty() && queue_.size() < maxBatch && !stopping_) {
+            changed_.wait_for(lock, config_.maxBatchDelay,
+                              [&]() { return queue_.size() >= maxBatch || stopping_; });
+        }
+        if (queue_.empty()) {
+            draining_ = false;
+            changed_.notify_all();
+            return;
+        }
+
+        size_t count = std::min(queue_.size(), maxBatch);
+        std::vector<std::string> batch(std::make_move_iterator(queue_.begin()),
+                                       std::make_move_iterator(queue_.begin() + static_cast<std::ptrdiff_t>(count)));
+        queue_.erase(queue_.begin(), queue_.begin() + static_cast<std::ptrdiff_t>(count));
+        lock.unlock();
+
+        // One processor call for a batching processor, else one per text;
+        // a failure only fails the texts of the call that threw
+        std::vector<EmbeddingVector> embeddings(count);
+        std::vector<std::exception_ptr> errors(count);
+        uint64_t calls = 0;
+        {
+            ScopedTimer timer(metrics.batchLatency);
+            if (processor_->supportsBatching() && count > 1) {
+                ++calls;
+                try {
+                    embeddings = processor_->generateEmbeddings(batch);
+                    if (embeddings.size() != count) {
+                        throw std::runtime_error(processor_->getName() + " returned " +
+                                                 std::to_string(embeddings.size()) + " embeddings for " +
+                                                 std::to_string(count) + " texts");
+                    }
+                } catch (...) {
+                    embeddings.assign(count, {});
+                    std::fill(errors.begin(), errors.end(), std::current_exception());
+                }
+            } else {
+                for (size_t i = 0; i < count; ++i) {
+                    ++calls;
+                    try {
+                        embeddings[i] = processor_->generateEmbedding(batch[i]);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            }
+        }
+
+        std::vector<std::vector<Promise<EmbeddingVector>>> waiters(count);
+        lock.lock();
+        stats_.batches += calls;
+        for (size_t i = 0; i < count; ++i) {
+            auto flight = inFlight_.find(batch[i]);
+            if (flight != inFlight_.end()) {
+                waiters[i] = std::move(flight->second);
+                inFlight_.erase(flight);
+            }
+            if (errors[i]) {
+                ++stats_.failed;
+            } else {
+                ++stats_.embedded;
+                insertLocked(std::move(batch[i]), embeddings[i]);
+            }
+        }
+        lock.unlock();
+
+        metrics.embedded.increment(static_cast<uint64_t>(
+            std::count(errors.begin(), errors.end(), nullptr)));
+        for (size_t i = 0; i < count; ++i) {
+            for (auto& promise : waiters[i]) {
+                if (errors[i]) {
+                    promise.setException(errors[i]);
+                } else {
+                    promise.setValue(embeddings[i]);
+                }
+            }
+        }
+        lock.lock();
+    }
+}
+
+bool EmbeddingService::contains(std::string_view text) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.count(text) > 0;
+}
+
+size_t EmbeddingService::cacheSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+void EmbeddingService::clearCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    cache_.clear();
+    accountedBytes_.store(0, std::memory_order_relaxed);
+}
+
+EmbeddingService::Stats EmbeddingService::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+size_t EmbeddingService::shrinkMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t freed = 0;
+    while (freed < bytes && !lru_.empty()) freed += evictOldestLocked();
+    return freed;
+}
+
+void EmbeddingService::insertLocked(std::string text, EmbeddingVector embedding) {
+    if (config_.cacheEntries == 0) return;
+
+    auto existing = cache_.find(text);
+    if (existing != cache_.end()) {
+        accountedBytes_.fetch_sub(entryBytes(*existing->second), std::memory_order_relaxed);
+        existing->second->embedding = std::move(embedding);
+        accountedBytes_.fetch_add(entryBytes(*existing->second), std::memory_order_relaxed);
+        lru_.splice(lru_.begin(), lru_, existing->second);
+        return;
+    }
+
+    lru_.push_front({std::move(text), std::move(embedding)});
+    cache_.emplace(lru_.front().text, lru_.begin());
+    accountedBytes_.fetch_add(entryBytes(lru_.front()), std::memory_order_relaxed);
+    while (cache_.size() > config_.cacheEntries) evictOldestLocked();
+}
+
+size_t EmbeddingService::evictOldestLocked() {
+    const CacheEntry& oldest = lru_.back();
+    size_t bytes = entryBytes(oldest);
+    cache_.erase(oldest.text);
+    lru_.pop_back();
+    accountedBytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    ++stats_.evictions;
+    return bytes;
+}
+
+size_t EmbeddingService::entryBytes(const CacheEntry& entry) {
+    // List node, hash node and the text's and vector's heap blocks
+    return sizeof(CacheEntry) + 2 * sizeof(void*) +
+           sizeof(std::pair<const std::string_view, std::list<CacheEntry>::iterator>) + 2 * sizeof(void*) +
+           entry.text.capacity() + entry.embedding.capacity() * sizeof(float);
+}
+
+bool EmbeddingService::saveCache(const std::string& path, std::string* error) const {
+    SnapshotWriter writer;
+    writer.writeRaw(std::string_view(CACHE_MAGIC, sizeof(CACHE_MAGIC)));
+    writer.writeVarint(CACHE_FORMAT_VERSION);
+    writer.writeString(processor_->getName());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writer.writeVarint(lru_.size());
+        for (const auto& entry : lru_) {
+            writer.writeString(entry.text);
+            writer.writeFloats(entry.embedding);
+        }
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(writer.data().data(), static_cast<std::streamsize>(writer.size()));
+        if (!out) {
+            out.close();
+            std::remove(temporary.c_str());
+            if (error) *error = "cannot write " + temporary;
+            return false;
+        }
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        if (error) *error = "cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+std::optional<size_t> EmbeddingService::loadCache(const std::string& path, std::string* error) {
+    auto fail = [&](const std::string& message) -> std::optional<size_t> {
+        if (error) *error = message;
+        return std::nullopt;
+    };
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail("cannot open " + path);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < sizeof(CACHE_MAGIC) || std::memcmp(data.data(), CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0) {
+        return fail("not an embedding cache: " + path);
+    }
+
+    SnapshotReader reader(std::string_view(data).substr(sizeof(CACHE_MAGIC)));
+    uint64_t version = reader.readVarint();
+    // Format 1 kept only hashes, which cannot tell colliding texts apart
+    if (reader.ok() && version != CACHE_FORMAT_VERSION) {
+        return fail("unsupported embedding cache format " + std::to_string(version));
+    }
+    std::string name = reader.readString();
+    if (reader.ok() && name != processor_->getName()) {
+        return fail("embedding cache of processor " + name + ", not " + processor_->getName());
+    }
+
+    std::vector<CacheEntry> entries(reader.readCount(2));
+    for (auto& entry : entries) {
+        entry.text = reader.readString();
+        entry.embedding = reader.readFloats();
+    }
+    if (!reader.ok() || !reader.atEnd()) return fail("corrupt embedding cache: " + path);
+
+    // Oldest first, so the saved recency order survives and the capacity
+    // keeps the most recent; embeddings computed since are kept
+    size_t loaded = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+        if (cache_.count(it->text)) continue;
+        insertLocked(std::move(it->text), std::move(it->embedding));
+        ++loaded;
+    }
+    return std::min(loaded, config_.cacheEntries);
+}
+
+} // namespace elizaos
@@ -0,0 +1,571 @@
+#include "elizaos/executor.hpp"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+namespace elizaos {
+
+namespace {
+
+constexpr size_t LANE_COUNT = 3;
+constexpr size_t NO_WORKER = static_cast<size_t>(-1);
+
+size_t laneIndex(TaskPriority priority) {
+    return std::min(static_cast<size_t>(priority), LANE_COUNT - 1);
+}
+
+} // anonymous namespace
+
+class Executor::Impl {
+public:
+    struct Worker {
+        std::mutex mutex;
+        std::deque<detail::Task> lanes[LANE_COUNT];
+        std::thread thread;
+    };
+
+    explicit Impl(const Config& config);
+
+    void start();
+    void stop();
+
+    void push(detail::Task task, TaskPriority priority);
+    void pushBlocking(detail::Task task);
+    bool tryTake(size_t self, detail::Task& task);
+    void run(detail::Task& task);
+    void execute(detail::Task& task);
+
+    TimerId schedule(std::chrono::steady_clock::duration delay, detail::Task task, TaskPriority priority,
+                     bool blocking);
+    bool cancel(TimerId id);
+
+    void workerLoop(size_t index);
+    void blockingLoop();
+    void timerLoop();
+
+    size_t currentWorker() const { return current == this ? currentIndex : NO_WORKER; }
+
+    static thread_local const Impl* current;
+    static thread_local size_t currentIndex;
+
+    Config config;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    // Work posted from outside the pool; guarded by injectionMutex, which
+    // also orders external posts against shutdown
+    std::mutex injectionMutex;
+    std::deque<detail::Task> injection[LANE_COUNT];
+    bool stopped = false;
+
+    // Queued CPU tasks across all deques. Published after a push and
+    // retracted after a take, so it may dip below zero transiently.
+    std::atomic<int64_t> pending{0};
+    std::atomic<size_t> sleeping{0};
+    std::atomic<bool> stopping{false};
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+
+    std::mutex blockingMutex;
+    std::condition_variable blockingCv;
+    std::deque<detail::Task> blockingQueue;
+    std::vector<std::thread> blockingThreads;
+    bool blockingStopping = false;
+
+    // Delayed tasks ordered by due time, then id so equal times keep their
+    // posting order. The timer thread starts with the first delayed task.
+    struct Timer {
+        detail::Task task;
+        TaskPriority priority;
+        bool blocking;
+    };
+    using TimerKey = std::pair<std::chrono::steady_clock::time_point, TimerId>;
+    std::mutex timerMutex;
+    std::condition_variable timerCv;
+    std::map<TimerKey, Timer> timers;
+    std::unordered_map<TimerId, std::chrono::steady_clock::time_point> timerDue;
+    TimerId nextTimerId = 1;
+    std::thread timerThread;
+    bool timerStopping = false;
+
+    std::mutex shutdownMutex;
+    bool joined = false;
+
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> executed{0};
+    std::atomic<uint64_t> stolen{0};
+    std::atomic<uint64_t> blockingExecuted{0};
+    std::atomic<uint64_t> failed{0};
+};
+
+thread_local const Executor::Impl* Executor::Impl::current = nullptr;
+thread_local size_t Executor::Impl::currentIndex = NO_WORKER;
+
+Executor::Impl::Impl(const Config& cfg) : config(cfg) {
+    if (config.workerThreads == 0) {
+        config.workerThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    config.blockingThreads = std::max<size_t>(1, config.blockingThreads);
+}
+
+void Executor::Impl::start() {
+    for (size_t i = 0; i < config.workerThreads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+        workers[i]->thread = std::thread(&Impl::workerLoop, this, i);
+    }
+    for (size_t i = 0; i < config.blockingThreads; ++i) {
+        blockingThreads.emplace_back(&Impl::blockingLoop, this);
+    }
+}
+
+void Executor::Impl::push(detail::Task task, TaskPriority priority) {
+    size_t lane = laneIndex(priority);
+    size_t self = currentWorker();
+    submitted.fetch_add(1, std::memory_order_relaxed);
+
+    if (self != NO_WORKER) {
+        std::lock_guard<std::mutex> lock(workers[self]->mutex);
+        workers[self]->lanes[lane].push_back(std::move(task));
+    } else {
+        std::unique_lock<std::mutex> lock(injectionMutex);
+        if (stopped) {
+            lock.unlock();
+            execute(task);
+            return;
+        }
+        injection[lane].push_back(std::move(task));
+    }
+
+    pending.fetch_add(1);
+    if (sleeping.load() > 0) {
+        // Taking the lock orders this notify after a sleeper's predicate check
+        { std::lock_guard<std::mutex> lock(idleMutex); }
+        idleCv.notify_one();
+    }
+}
+
+void Executor::Impl::pushBlocking(detail::Task task) {
+    {
+        std::unique_lock<std::mutex> lock(blockingMutex);
+        if (!blockingStopping) {
+            blockingQueue.push_back(std::move(task));
+            lock.unlock();
+            blockingCv.notify_one();
+            return;
+        }
+    }
+    run(task);
+    blockingExecuted.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool Executor::Impl::tryTake(size_t self, detail::Task& task) {
+    auto took = [&](std::deque<detail::Task>& queue, bool back) {
+        if (queue.empty()) return false;
+        if (back) {
+            task = std::move(queue.back());
+            queue.pop_back();
+        } else {
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+        pending.fetch_sub(1);
+        return true;
+    };
+
+    size_t count = workers.size();
+    for (size_t lane = 0; lane < LANE_COUNT; ++lane) {
+        if (self != NO_WORKER) {
+            std::lock_guard<std::mutex> lock(workers[self]->mutex);
+            if (took(workers[self]->lanes[lane], true)) return true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(injectionMutex);
+            if (took(injection[lane], false)) return true;
+        }
+        size_t start = self == NO_WORKER ? 0 : self + 1;
+        for (size_t k = 0; k < count; ++k) {
+            size_t victim = (start + k) % count;
+            if (victim == self) continue;
+            std::lock_guard<std::mutex> lock(workers[victim]->mutex);
+            if (took(workers[victim]->lanes[lane], false)) {
+                stolen.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Executor::Impl::run(detail::Task& task) {
+    try {
+        task();
+    } catch (...) {
+        // Futures capture their own exceptions; only raw posted tasks get here
+        failed.fetch_add(1, std::memory_order_relaxed);
+    }
+    task = detail::Task();
+}
+
+void Executor::Impl::execute(detail::Task& task) {
+    run(task);
+    executed.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Executor::Impl::workerLoop(size_t index) {
+    current = this;
+    currentIndex = index;
+
+    detail::Task task;
+    while (true) {
+        if (tryTake(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        sleeping.fetch_add(1);
+        idleCv.wait(lock, [this] { return pending.load() > 0 || stopping.load(); });
+        sleeping.fetch_sub(1);
+        if (stopping.load() && pending.load() <= 0) break;
+    }
+
+    current = nullptr;
+    currentIndex = NO_WORKER;
+}
+
+void Executor::Impl::blockingLoop() {
+    while (true) {
+        detail::Task task;
+        {
+            std::unique_lock<std::mutex> lock(blockingMutex);
+            blockingCv.wait(lock, [this] { return blockingStopping || !blockingQueue.empty(); });
+            if (blockingQueue.empty()) return;
+            task = std::move(blockingQueue.front());
+            blockingQueue.pop_front();
+        }
+        run(task);
+        blockingExecuted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Executor::TimerId Executor::Impl::schedule(std::chrono::steady_clock::duration delay, detail::Task task,
+                                           TaskPriority priority, bool blocking) {
+    auto due = std::chrono::steady_clock::now() + std::max(delay, std::chrono::steady_clock::duration::zero());
+    std::unique_lock<std::mutex> lock(timerMutex);
+    if (timerStopping) {
+        lock.unlock();
+        task = detail::Task();
+        return 0;
+    }
+    if (!timerThread.joinable()) timerThread = std::thread(&Impl::timerLoop, this);
+
+    TimerId id = nextTimerId++;
+    bool earliest = timers.empty() || due < timers.begin()->first.first;
+    timers.emplace(TimerKey(due, id), Timer{std::move(task), priority, blocking});
+    timerDue.emplace(id, due);
+    lock.unlock();
+    if (earliest) timerCv.notify_one();
+    return id;
+}
+
+bool Executor::Impl::cancel(TimerId id) {
+    detail::Task task;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        auto due = timerDue.find(id);
+        if (due == timerDue.end()) return false;
+        auto timer = timers.find(TimerKey(due->second, id));
+        task = std::move(timer->second.task);
+        timers.erase(timer);
+        timerDue.erase(due);
+    }
+    // Destroyed outside the lock, since it may own state that posts work
+    task = detail::Task();
+    return true;
+}
+
+void Executor::Impl::timerLoop() {
+    std::unique_lock<std::mutex> lock(timerMutex);
+    while (!timerStopping) {
+        if (timers.empty()) {
+            timerCv.wait(lock);
+            continue;
+        }
+        auto first = timers.begin();
+        if (first->first.first > std::chrono::steady_clock::now()) {
+            timerCv.wait_until(lock, first->first.first);
+            continue;
+        }
+        Timer timer = std::move(first->second);
+        timerDue.erase(first->first.second);
+        timers.erase(first);
+        lock.unlock();
+        if (timer.blocking) {
+            pushBlocking(std::move(timer.task));
+        } else {
+            push(std::move(timer.task), timer.priority);
+        }
+        lock.lock();
+    }
+}
+
+void Executor::Impl::stop() {
+    std::lock_guard<std::mutex> shutdownLock(shutdownMutex);
+    if (joined) return;
+    joined = true;
+
+    // Delayed tasks not yet due are dropped
+    std::map<TimerKey, Timer> dropped;
+    {
+        std::lock_guard<std::mutex> lock(timerMutex);
+        timerStopping = true;
+        dropped.swap(timers);
+        timerDue.clear();
+    }
+    timerCv.notify_all();
+    if (timerThread.joinable()) timerThread.join();
+    dropped.clear();
+
+    // CPU workers drain every queued task, including ones queued while draining
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        stopping.store(true);
+    }
+    idleCv.notify_all();
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) worker->thread.join();
+    }
+
+    // External posts racing the join were queued before stopped was set
+    {
+        std::lock_guard<std::mutex> lock(injectionMutex);
+        stopped = true;
+    }
+    detail::Task task;
+    while (tryTake(NO_WORKER, task)) execute(task);
+
+    {
+        std::lock_guard<std::mutex> lock(blockingMutex);
+        blockingStopping = true;
+    }
+    blockingCv.notify_all();
+    for (auto& thread : blockingThreads) {
+        if (thread.joinable()) thread.join();
+    }
+}
+
+// Executor implementation
+Executor::Executor() : Executor(Config()) {}
+
+Executor::Executor(const Config& config) : impl_(std::make_unique<Impl>(config)) {
+    impl_->start();
+}
+
+Executor::~Executor() {
+    shutdown();
+}
+
+Executor& Executor::global() {
+    // Never destroyed: tasks still running during static destruction must not
+    // find the executor gone
+    static Executor* instance = new Executor();
+    return *instance;
+}
+
+void Executor::post(detail::Task task, TaskPriority priority) {
+    impl_->push(std::move(task), priority);
+}
+
+void Executor::postBlocking(detail::Task task) {
+    impl_->pushBlocking(std::move(task));
+}
+
+Executor::TimerId Executor::postAfter(std::chrono::steady_clock::duration delay, detail::Task task,
+                                     TaskPriority priority) {
+    return impl_->schedule(delay, std::move(task), priority, false);
+}
+
+Executor::TimerId Executor::postBlockingAfter(std::chrono::steady_clock::duration delay, detail::Task task) {
+    return impl_->schedule(delay, std::move(task), TaskPriority::NORMAL, true);
+}
+
+bool Executor::cancel(TimerId id) {
+    return impl_->cancel(id);
+}
+
+bool Executor::runPendingTask() {
+    detail::Task task;
+    if (!impl_->tryTake(impl_->currentWorker(), task)) return false;
+    impl_->execute(task);
+    return true;
+}
+
+void Executor::shutdown() {
+    impl_->stop();
+}
+
+bool Executor::isWorkerThread() const {
+    return impl_->currentWorker() != NO_WORKER;
+}
+
+size_t Executor::getWorkerCount() const {
+    return impl_->config.workerThreads;
+}
+
+size_t Executor::getBlockingThreadCount() const {
+    return impl_->config.blockingThreads;
+}
+
+Executor::Stats Executor::getStats() const {
+    Stats stats;
+    stats.submitted = impl_->submitted.load(std::memory_order_relaxed);
+    stats.executed = impl_->executed.load(std::memory_order_relaxed);
+    stats.stolen = impl_->stolen.load(std::memory_order_relaxed);
+    stats.blockingExecuted = impl_->blockingExecuted.load(std::memory_order_relaxed);
+    stats.failed = impl_->failed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// PeriodicTask implementation
+
+// At most one run is outstanding (waiting on the timer, queued or running)
+// at a time. Runs hold the state, so a callback may destroy its owner.
+struct PeriodicTask::State {
+    Executor* executor = nullptr;
+    bool blocking = true;
+
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::function<void()> task;
+    std::chrono::steady_clock::duration interval{};
+    bool active = false;
+    bool outstanding = false;
+    Executor::TimerId timer = 0;        // 0 once the run has been queued
+    std::thread::id runner;             // Thread inside the callback, if any
+
+    static void schedule(const std::shared_ptr<State>& state, std::chrono::steady_clock::duration delay);
+    static void run(const std::shared_ptr<State>& state);
+};
+
+void PeriodicTask::State::schedule(const std::shared_ptr<State>& state, std::chrono::steady_clock::duration delay) {
+    // Called with the state's mutex held, so even the first run goes through
+    // the timer rather than a post that could run inline after shutdown
+    auto fire = [state]() { run(state); };
+    state->timer = state->blocking ? state->executor->postBlockingAfter(delay, std::move(fire))
+                                   : state->executor->postAfter(delay, std::move(fire));
+    state->outstanding = state->timer != 0;
+}
+
+void PeriodicTask::State::run(const std::shared_ptr<State>& state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->timer = 0;
+    if (state->active) {
+        std::function<void()> task = state->task;
+        state->runner = std::this_thread::get_id();
+        lock.unlock();
+        try {
+            task();
+        } catch (...) {
+            // A failed run does not end the schedule
+        }
+        lock.lock();
+        state->runner = std::thread::id();
+    }
+    if (state->active) {
+        schedule(state, state->interval);
+    } else {
+        state->outstanding = false;
+    }
+    if (!state->outstanding) state->idle.notify_all();
+}
+
+PeriodicTask::PeriodicTask() : state_(std::make_shared<State>()) {}
+
+PeriodicTask::PeriodicTask(Executor& executor, bool blocking) : state_(std::make_shared<State>()) {
+    state_->executor = &executor;
+    state_->blocking = blocking;
+}
+
+PeriodicTask::~PeriodicTask() {
+    stop();
+}
+
+void PeriodicTask::start(std::chrono::steady_clock::duration interval, std::function<void()> task) {
+    stop();
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (!state_->executor) state_->executor = &Executor::global();
+    state_->task = std::move(task);
+    state_->interval = interval;
+    state_->active = true;
+    // Restarted from its own callback: that run schedules the next one
+    if (!state_->outstanding) State::schedule(state_, std::chrono::steady_clock::duration::zero());
+}
+
+void PeriodicTask::stop() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->active = false;
+    if (state_->outstanding && state_->timer != 0 && state_->executor->cancel(state_->timer)) {
+        state_->timer = 0;
+        state_->outstanding = false;
+    }
+    if (state_->runner == std::this_thread::get_id()) return;
+    state_->idle.wait(lock, [this] { return !state_->outstanding; });
+}
+
+void PeriodicTask::setInterval(std::chrono::steady_clock::duration interval) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->interval = interval;
+}
+
+bool PeriodicTask::isRunning() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->active;
+}
+
+Future<void> whenAll(std::vector<Future<void>> futures) {
+    struct Join {
+        std::vector<std::exception_ptr> errors;
+        std::atomic<size_t> remaining;
+        std::shared_ptr<detail::SharedState<void>> target;
+    };
+
+    Executor* executor = futures.empty() ? nullptr : detail::FutureAccess::executor(futures.front());
+    auto join = std::make_shared<Join>();
+    join->errors.resize(futures.size());
+    join->remaining.store(futures.size() + 1);
+    join->target = std::make_shared<detail::SharedState<void>>(executor);
+    auto result = detail::FutureAccess::make(join->target);
+
+    auto finish = [](Join& j) {
+        for (auto& error : j.errors) {
+            if (error) {
+                j.target->setError(error);
+                return;
+            }
+        }
+        j.target->setValue(detail::Unit{});
+    };
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto source = detail::FutureAccess::consume(futures[i]);
+        auto* raw = source.get();
+        raw->setContinuation([join, source = std::move(source), i, finish]() {
+            join->errors[i] = source->error();
+            if (join->remaining.fetch_sub(1) == 1) finish(*join);
+        });
+    }
+    if (join->remaining.fetch_sub(1) == 1) finish(*join);
+    return result;
+}
+
+Future<void> makeReadyFuture() {
+    Promise<void> promise;
+    Future<void> future = promise.getFuture();
+    promise.setValue();
+    return future;
+}
+
+} // namespace elizaos
@@ -0,0 +1,258 @@
+#include "elizaos/file_watcher.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace elizaos {
+
+namespace {
+
+constexpr uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                IN_MOVED_TO | IN_DELETE_SELF | IN_ATTRIB;
+
+} // anonymous namespace
+
+class FileWatcher::Impl {
+public:
+    explicit Impl(std::chrono::milliseconds window) : coalesce_window_(window) {
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+
+    ~Impl() {
+        stop();
+        if (inotify_fd_ >= 0) close(inotify_fd_);
+        if (wake_fd_ >= 0) close(wake_fd_);
+    }
+
+    bool addDirectory(const std::filesystem::path& directory) {
+        if (inotify_fd_ < 0) {
+            return false;
+        }
+        std::error_code ec;
+        if (!std::filesystem::is_directory(directory, ec)) {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        if (!addWatchLocked(directory)) {
+            return false;
+        }
+        watchSubdirectoriesLocked(directory);
+        roots_.push_back(directory);
+        return true;
+    }
+
+    bool start(ChangeCallback callback) {
+        if (running_ || inotify_fd_ < 0 || wake_fd_ < 0) {
+            return false;
+        }
+        callback_ = std::move(callback);
+        running_ = true;
+        thread_ = std::thread([this]() { run(); });
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        uint64_t one = 1;
+        ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    bool isRunning() const { return running_; }
+
+    size_t getWatchCount() const {
+        std::lock_guard<std::mutex> lock(watch_mutex_);
+        return watches_.size();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::chrono::milliseconds coalesce_window_;
+    int inotify_fd_ = -1;
+    int wake_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    ChangeCallback callback_;
+
+    mutable std::mutex watch_mutex_;
+    std::unordered_map<int, std::filesystem::path> watches_;
+    std::vector<std::filesystem::path> roots_;
+
+    std::set<std::filesystem::path> pending_;
+    Clock::time_point first_pending_;
+    Clock::time_point last_event_;
+
+    bool addWatchLocked(const std::filesystem::path& directory) {
+        int wd = inotify_add_watch(inotify_fd_, directory.c_str(), WATCH_MASK);
+        if (wd < 0) {
+            return false;
+        }
+        watches_[wd] = directory;
+        return true;
+    }
+
+    void watchSubdirectoriesLocked(const std::filesystem::path& directory) {
+        std::error_code ec;
+        for (auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+            if (it->is_directory(ec)) {
+                addWatchLocked(it->path());
+            }
+        }
+    }
+
+    void run() {
+        alignas(struct inotify_event) char buffer[16 * 1024];
+
+        while (running_) {
+            int timeout = -1;
+            if (!pending_.empty()) {
+                auto now = Clock::now();
+                auto quiet_deadline = last_event_ + coalesce_window_;
+                auto max_deadline = first_pending_ + coalesce_window_ * 4;
+                auto deadline = std::min(quiet_deadline, max_deadline);
+                timeout = deadline <= now ? 0 : static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1);
+            }
+
+            struct pollfd fds[2] = {{inotify_fd_, POLLIN, 0}, {wake_fd_, POLLIN, 0}};
+            int ready = poll(fds, 2, timeout);
+            if (!running_) {
+                break;
+            }
+            if (ready < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                ssize_t len;
+                while ((len = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+                    handleEvents(buffer, static_cast<size_t>(len));
+                }
+            }
+
+            if (!pending_.empty()) {
+                auto now = Clock::now();
+                if (now >= last_event_ + coalesce_window_ || now >= first_pending_ + coalesce_window_ * 4) {
+                    flush();
+                }
+            }
+        }
+        pending_.clear();
+    }
+
+    void handleEvents(const char* buffer, size_t length) {
+        auto now = Clock::now();
+        for (size_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Lost events may include new directories, so rewatch every tree
+                std::lock_guard<std::mutex> lock(watch_mutex_);
+                for (const auto& root : roots_) {
+                    watchSubdirectoriesLocked(root);
+                    markPending(root, now);
+                }
+                continue;
+            }
+
+            std::filesystem::path path;
+            {
+                std::lock_guard<std::mutex> lock(watch_mutex_);
+                auto it = watches_.find(event->wd);
+                if (it == watches_.end()) {
+                    continue;
+                }
+                path = event->len > 0 ? it->second / event->name : it->second;
+
+                if (event->mask & IN_IGNORED) {
+                    watches_.erase(it);
+                    continue;
+                }
+                if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+                    // New subtree: watch it, and report files that landed before the watch existed
+                    addWatchLocked(path);
+                    std::error_code ec;
+                    for (auto sub = std::filesystem::recursive_directory_iterator(path, ec);
+                         !ec && sub != std::filesystem::recursive_directory_iterator(); sub.increment(ec)) {
+                        if (sub->is_directory(ec)) {
+                            addWatchLocked(sub->path());
+                        } else {
+                            markPending(sub->path(), now);
+                        }
+                    }
+                    continue;
+                }
+            }
+
+            if (event->mask & IN_ISDIR) {
+                continue;
+            }
+            markPending(path, now);
+        }
+    }
+
+    void markPending(const std::filesystem::path& path, Clock::time_point now) {
+        if (pending_.empty()) {
+            first_pending_ = now;
+        }
+        last_event_ = now;
+        pending_.insert(path);
+    }
+
+    void flush() {
+        std::vector<std::filesystem::path> changed(pending_.begin(), pending_.end());
+        pending_.clear();
+        if (callback_) {
+            try {
+                callback_(changed);
+            } catch (const std::exception&) {
+                // A failing callback must not stop the watcher; callers log their own errors
+            }
+        }
+    }
+};
+
+FileWatcher::FileWatcher(std::chrono::milliseconds coalesce_window)
+    : impl_(std::make_unique<Impl>(coalesce_window)) {}
+FileWatcher::~FileWatcher() = default;
+
+bool FileWatcher::addDirectory(const std::filesystem::path& directory) {
+    return impl_->addDirectory(directory);
+}
+
+bool FileWatcher::start(ChangeCallback callback) {
+    return impl_->start(std::move(callback));
+}
+
+void FileWatcher::stop() {
+    impl_->stop();
+}
+
+bool FileWatcher::isRunning() const {
+    return impl_->isRunning();
+}
+
+size_t FileWatcher::getWatchCount() const {
+    return impl_->getWatchCount();
+}
+
+} // namespace elizaos
@@ -0,0 +1,894 @@
+#include "elizaos/json.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+
+namespace elizaos {
+namespace json {
+
+namespace {
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+void appendUtf8(std::string& out, uint32_t codepoint) {
+    if (codepoint < 0x80) {
+        out += static_cast<char>(codepoint);
+    } else if (codepoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codepoint >> 6));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else if (codepoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codepoint >> 12));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codepoint >> 18));
+        out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codepoint & 0x3F));
+    }
+}
+
+/**
+ * Length of the well-formed UTF-8 sequence starting at text[pos], or 0 when
+ * it is truncated, overlong, a surrogate or beyond U+10FFFF
+ */
+size_t utf8SequenceLength(std::string_view text, size_t pos) {
+    auto byte = [&](size_t i) { return static_cast<unsigned char>(text[pos + i]); };
+    unsigned char lead = byte(0);
+    size_t length;
+    unsigned char low = 0x80, high = 0xBF;      // Range of the second byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        if (lead == 0xE0) low = 0xA0;
+        if (lead == 0xED) high = 0x9F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        if (lead == 0xF0) low = 0x90;
+        if (lead == 0xF4) high = 0x8F;
+    } else {
+        return 0;
+    }
+    if (text.size() - pos < length) return 0;
+    if (byte(1) < low || byte(1) > high) return 0;
+    for (size_t i = 2; i < length; ++i) {
+        if ((byte(i) & 0xC0) != 0x80) return 0;
+    }
+    return length;
+}
+
+/**
+ * Iterative recursive-descent parser; nesting lives on an explicit stack so
+ * hostile input cannot overflow the call stack
+ */
+class Parser {
+public:
+    Parser(std::string_view text, Handler& handler, ParseError* error)
+        : text_(text), handler_(handler), error_(error) {}
+
+    bool run();
+
+private:
+    enum class Container : uint8_t { ARRAY, OBJECT };
+
+    bool fail(const char* message) {
+        if (error_) {
+            error_->offset = pos_;
+            error_->message = message;
+        }
+        return false;
+    }
+
+    bool aborted() { return fail("parse stopped by handler"); }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+            ++pos_;
+        }
+    }
+
+    bool consume(char expected) {
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == expected) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    bool parseString(std::string_view& out);
+    bool parseHex4(uint32_t& out);
+    bool parseNumber();
+    bool parseLiteral(const char* literal, size_t length);
+    bool parseScalar();
+
+    std::string_view text_;
+    size_t pos_ = 0;
+    Handler& handler_;
+    ParseError* error_;
+    std::string scratch_;
+    std::vector<Container> stack_;
+};
+
+bool Parser::parseHex4(uint32_t& out) {
+    if (pos_ + 4 > text_.size()) return false;
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+        char c = text_[pos_++];
+        out <<= 4;
+        if (c >= '0' && c <= '9') out |= static_cast<uint32_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') out |= static_cast<uint32_t>(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') out |= static_cast<uint32_t>(c - 'A' + 10);
+        else return false;
+    }
+    return true;
+}
+
+bool Parser::parseString(std::string_view& out) {
+    // pos_ is just past the opening quote. Strings without escapes are
+    // handed out as views of the input.
+    size_t start = pos_;
+    while (pos_ < text_.size()) {
+        unsigned char c = static_cast<unsigned char>(text_[pos_]);
+        if (c == '"') {
+            out = text_.substr(start, pos_ - start);
+            ++pos_;
+            return true;
+        }
+        if (c == '\\') break;
+        if (c < 0x20) return fail("control character in string");
+        if (c < 0x80) {
+            ++pos_;
+            continue;
+        }
+        size_t length = utf8SequenceLength(text_, pos_);
+        if (length == 0) return fail("invalid UTF-8 in string");
+        pos_ += length;
+    }
+    if (pos_ >= text_.size()) return fail("unterminated string");
+
+    scratch_.assign(text_.data() + start, pos_ - start);
+    while (pos_ < text_.size()) {
+        unsigned char c = static_cast<unsigned char>(text_[pos_++]);
+        if (c == '"') {
+            out = scratch_;
+            return true;
+        }
+        if (c < 0x20) {
+            --pos_;
+            return fail("control character in string");
+        }
+        if (c >= 0x80) {
+            size_t length = utf8SequenceLength(text_, --pos_);
+            if (length == 0) return fail("invalid UTF-8 in string");
+            scratch_.append(text_.data() + pos_, length);
+            pos_ += length;
+            continue;
+        }
+        if (c != '\\') {
+            scratch_ += static_cast<char>(c);
+            continue;
+        }
+        if (pos_ >= text_.size()) break;
+        char escape = text_[pos_++];
+        switch (escape) {
+            case '"': scratch_ += '"'; break;
+            case '\\': scratch_ += '\\'; break;
+            case '/': scratch_ += '/'; break;
+            case 'b': scratch_ += '\b'; break;
+            case 'f': scratch_ += '\f'; break;
+            case 'n': scratch_ += '\n'; break;
+            case 'r': scratch_ += '\r'; break;
+            case 't': scratch_ += '\t'; break;
+            case 'u': {
+                uint32_t codepoint;
+                if (!parseHex4(codepoint)) return fail("invalid \\u escape");
+                if (codepoint >= 0xD800 && codepoint <= 0xDBFF) {
+                    uint32_t low;
+                    if (pos_ + 2 > text_.size() || text_[pos_] != '\\' || text_[pos_ + 1] != 'u') {
+                        return fail("unpaired surrogate");
+                    }
+                    pos_ += 2;
+                    if (!parseHex4(low) || low < 0xDC00 || low > 0xDFFF) return fail("unpaired surrogate");
+                    codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                } else if (codepoint >= 0xDC00 && codepoint <= 0xDFFF) {
+                    return fail("unpaired surrogate");
+                }
+                appendUtf8(scratch_, codepoint);
+                break;
+            }
+            default:
+                --pos_;
+                return fail("invalid escape");
+        }
+    }
+    return fail("unterminated string");
+}
+
+bool Parser::parseNumber() {
+    size_t start = pos_;
+    bool integral = true;
+    if (text_[pos_] == '-') ++pos_;
+    if (pos_ >= text_.size() || !isDigit(text_[pos_])) return fail("invalid number");
+    if (text_[pos_] == '0') {
+        ++pos_;
+    } else {
+        while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+    }
+    if (pos_ < text_.size() && text_[pos_] == '.') {
+        integral = false;
+        ++pos_;
+        if (pos_ >= text_.size() || !isDigit(text_[pos_])) return fail("invalid number");
+        while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+    }
+    if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+        integral = false;
+        ++pos_;
+        if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) ++pos_;
+        if (pos_ >= text_.size() || !isDigit(text_[pos_])) return fail("invalid number");
+        while (pos_ < text_.size() && isDigit(text_[pos_])) ++pos_;
+    }
+
+    const char* first = text_.data() + start;
+    const char* last = text_.data() + pos_;
+    if (integral) {
+        int64_t value;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec == std::errc() && result.ptr == last) {
+            return handler_.onInteger(value) || aborted();
+        }
+        // Out of int64_t range: fall through to double
+    }
+    double value;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range) {
+        // Underflow rounds to 0 or a denormal; overflow has no double to give
+        value = std::strtod(std::string(first, last).c_str(), nullptr);
+        if (std::isinf(value)) {
+            pos_ = start;
+            return fail("number out of range");
+        }
+    } else if (result.ec != std::errc() || result.ptr != last) {
+        return fail("invalid number");
+    }
+    return handler_.onDouble(value) || aborted();
+}
+
+bool Parser::parseLiteral(const char* literal, size_t length) {
+    if (text_.compare(pos_, length, literal) != 0) return fail("invalid literal");
+    pos_ += length;
+    return true;
+}
+
+bool Parser::parseScalar() {
+    char c = text_[pos_];
+    switch (c) {
+        case '"': {
+            ++pos_;
+            std::string_view value;
+            if (!parseString(value)) return false;
+            return handler_.onString(value) || aborted();
+        }
+        case 't':
+            return parseLiteral("true", 4) && (handler_.onBool(true) || aborted());
+        case 'f':
+            return parseLiteral("false", 5) && (handler_.onBool(false) || aborted());
+        case 'n':
+            return parseLiteral("null", 4) && (handler_.onNull() || aborted());
+        default:
+            if (c == '-' || isDigit(c)) return parseNumber();
+            return fail("unexpected character");
+    }
+}
+
+bool Parser::run() {
+    enum class Expect { VALUE, KEY, AFTER_VALUE };
+    Expect expect = Expect::VALUE;
+
+    while (true) {
+        skipWhitespace();
+        switch (expect) {
+            case Expect::VALUE: {
+                if (pos_ >= text_.size()) return fail("unexpected end of input");
+                char c = text_[pos_];
+                if (c == '{' || c == '[') {
+                    if (stack_.size() >= MAX_PARSE_DEPTH) return fail("nesting too deep");
+                    ++pos_;
+                    bool object = c == '{';
+                    if (!(object ? handler_.onStartObject() : handler_.onStartArray())) return aborted();
+                    if (consume(object ? '}' : ']')) {
+                        if (!(object ? handler_.onEndObject() : handler_.onEndArray())) return aborted();
+                        expect = Expect::AFTER_VALUE;
+                    } else {
+                        stack_.push_back(object ? Container::OBJECT : Container::ARRAY);
+                        expect = object ? Expect::KEY : Expect::VALUE;
+                    }
+                } else {
+                    if (!parseScalar()) return false;
+                    expect = Expect::AFTER_VALUE;
+                }
+                break;
+            }
+            case Expect::KEY: {
+                if (pos_ >= text_.size() || text_[pos_] != '"') return fail("expected object key");
+                ++pos_;
+                std::string_view key;
+                if (!parseString(key)) return false;
+                if (!handler_.onKey(key)) return aborted();
+                if (!consume(':')) return fail("expected ':'");
+                expect = Expect::VALUE;
+                break;
+            }
+            case Expect::AFTER_VALUE: {
+                if (stack_.empty()) {
+                    if (pos_ != text_.size()) return fail("trailing characters");
+                    return true;
+                }
+                if (pos_ >= text_.size()) return fail("unexpected end of input");
+                char c = text_[pos_++];
+                bool object = stack_.back() == Container::OBJECT;
+                if (c == ',') {
+                    expect = object ? Expect::KEY : Expect::VALUE;
+                } else if (c == (object ? '}' : ']')) {
+                    stack_.pop_back();
+                    if (!(object ? handler_.onEndObject() : handler_.onEndArray())) return aborted();
+                } else {
+                    --pos_;
+                    return fail(object ? "expected ',' or '}'" : "expected ',' or ']'");
+                }
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * Builds a Value tree from SAX events
+ *
+ * Children collect on scratch stacks until their container closes, so each
+ * array and object is allocated once at its final size; growing them in
+ * place would leave every outgrown buffer behind in an arena.
+ */
+class TreeBuilder : public Handler {
+public:
+    explicit TreeBuilder(std::pmr::memory_resource* resource) : resource_(resource), root_(resource) {}
+
+    bool onNull() override { return add(Value(resource_)); }
+    bool onBool(bool value) override { return add(Value(value)); }
+    bool onInteger(int64_t value) override { return add(Value(value)); }
+    bool onDouble(double value) override { return add(Value(value)); }
+    bool onString(std::string_view value) override { return add(Value(value, resource_)); }
+    bool onKey(std::string_view key) override {
+        // The value arrives next and fills this member in
+        members_.emplace_back(key, Value(resource_), resource_);
+        return true;
+    }
+    bool onStartObject() override {
+        frames_.push_back({members_.size(), true});
+        return true;
+    }
+    bool onStartArray() override {
+        frames_.push_back({elements_.size(), false});
+        return true;
+    }
+    bool onEndObject() override {
+        size_t start = frames_.back().start;
+        frames_.pop_back();
+        Value object = Value::object(resource_);
+        Object& target = object.asObject();
+        target.reserve(members_.size() - start);
+        std::move(members_.begin() + static_cast<std::ptrdiff_t>(start), members_.end(), std::back_inserter(target));
+        members_.erase(members_.begin() + static_cast<std::ptrdiff_t>(start), members_.end());
+        return add(std::move(object));
+    }
+    bool onEndArray() override {
+        size_t start = frames_.back().start;
+        frames_.pop_back();
+        Value array = Value::array(resource_);
+        Array& target = array.asArray();
+        target.reserve(elements_.size() - start);
+        std::move(elements_.begin() + static_cast<std::ptrdiff_t>(start), elements_.end(), std::back_inserter(target));
+        elements_.erase(elements_.begin() + static_cast<std::ptrdiff_t>(start), elements_.end());
+        return add(std::move(array));
+    }
+
+    Value& root() { return root_; }
+
+private:
+    struct Frame {
+        size_t start;       // First child on the matching scratch stack
+        bool object;
+    };
+
+    bool add(Value&& value) {
+        if (frames_.empty()) {
+            root_ = std::move(value);
+        } else if (frames_.back().object) {
+            members_.back().value = std::move(value);
+        } else {
+            elements_.emplace_back(resource_) = std::move(value);
+        }
+        return true;
+    }
+
+    std::pmr::memory_resource* resource_;
+    Value root_;
+    std::vector<Frame> frames_;
+    std::vector<Member> members_;
+    std::vector<Value> elements_;
+};
+
+void writeEscaped(std::string& out, std::string_view text) {
+    static const char HEX[] = "0123456789abcdef";
+    out += '"';
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+
+        out.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b"; break;
+            case '\f': out += "\\f"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                out += "\\u00";
+                out += HEX[c >> 4];
+                out += HEX[c & 0xF];
+        }
+    }
+    out.append(text.data() + runStart, text.size() - runStart);
+    out += '"';
+}
+
+} // anonymous namespace
+
+const char* typeName(Type type) {
+    switch (type) {
+        case Type::NUL: return "null";
+        case Type::BOOLEAN: return "boolean";
+        case Type::INTEGER: return "integer";
+        case Type::DOUBLE: return "double";
+        case Type::STRING: return "string";
+        case Type::ARRAY: return "array";
+        case Type::OBJECT: return "object";
+    }
+    return "unknown";
+}
+
+// Value implementation
+Value::Value(const char* value, std::pmr::memory_resource* resource)
+    : Value(std::string_view(value ? value : ""), resource) {}
+
+Value::Value(std::string_view value, std::pmr::memory_resource* resource) : type_(Type::STRING), resource_(resource) {
+    new (&string_) String(value, resource);
+}
+
+Value::Value(const Value& other, std::pmr::memory_resource* resource) : resource_(resource) {
+    copyFrom(other);
+}
+
+Value::Value(Value&& other) noexcept : resource_(other.resource_) {
+    moveFrom(other);
+}
+
+// Both assignments build the new content before releasing the old, so
+// assigning a value its own child works
+Value& Value::operator=(const Value& other) {
+    if (this != &other) {
+        Value copy(other, resource_);
+        reset();
+        moveFrom(copy);
+    }
+    return *this;
+}
+
+Value& Value::operator=(Value&& other) {
+    if (this == &other) return *this;
+    // Scalars own no memory, so they move across resources as well
+    if (resource_ == other.resource_ || other.type_ < Type::STRING) {
+        Value taken(std::move(other));
+        reset();
+        moveFrom(taken);
+    } else {
+        Value copy(other, resource_);
+        other.reset();
+        reset();
+        moveFrom(copy);
+    }
+    return *this;
+}
+
+Value Value::array(std::pmr::memory_resource* resource) {
+    Value value(resource);
+    new (&value.array_) Array(resource);
+    value.type_ = Type::ARRAY;
+    return value;
+}
+
+Value Value::object(std::pmr::memory_resource* resource) {
+    Value value(resource);
+    new (&value.object_) Object(resource);
+    value.type_ = Type::OBJECT;
+    return value;
+}
+
+void Value::reset() noexcept {
+    switch (type_) {
+        case Type::STRING: string_.~String(); break;
+        case Type::ARRAY: array_.~Array(); break;
+        case Type::OBJECT: object_.~Object(); break;
+        default: break;
+    }
+    type_ = Type::NUL;
+}
+
+void Value::copyFrom(const Value& other) {
+    // Precondition: *this is null; copies land in resource_
+    switch (other.type_) {
+        case Type::NUL: break;
+        case Type::BOOLEAN: boolean_ = other.boolean_; break;
+        case Type::INTEGER: integer_ = other.integer_; break;
+        case Type::DOUBLE: double_ = other.double_; break;
+        case Type::STRING: new (&string_) String(other.string_, resource_); break;
+        case Type::ARRAY:
+            new (&array_) Array(resource_);
+            array_.reserve(other.array_.size());
+            for (const auto& element : other.array_) array_.emplace_back(element, resource_);
+            break;
+        case Type::OBJECT:
+            new (&object_) Object(resource_);
+            object_.reserve(other.object_.size());
+            for (const auto& member : other.object_) object_.emplace_back(member, resource_);
+            break;
+    }
+    type_ = other.type_;
+}
+
+void Value::moveFrom(Value& other) noexcept {
+    // Precondition: *this is null and shares other's resource
+    switch (other.type_) {
+        case Type::NUL: break;
+        case Type::BOOLEAN: boolean_ = other.boolean_; break;
+        case Type::INTEGER: integer_ = other.integer_; break;
+        case Type::DOUBLE: double_ = other.double_; break;
+        case Type::STRING: new (&string_) String(std::move(other.string_)); break;
+        case Type::ARRAY: new (&array_) Array(std::move(other.array_)); break;
+        case Type::OBJECT: new (&object_) Object(std::move(other.object_)); break;
+    }
+    type_ = other.type_;
+    other.reset();
+}
+
+void Value::typeMismatch(Type expected) const {
+    throw TypeError(std::string("json: expected ") + typeName(expected) + ", found " + typeName(type_));
+}
+
+bool Value::asBool() const {
+    if (type_ != Type::BOOLEAN) typeMismatch(Type::BOOLEAN);
+    return boolean_;
+}
+
+int64_t Value::asInt() const {
+    if (type_ == Type::INTEGER) return integer_;
+    if (type_ == Type::DOUBLE) return static_cast<int64_t>(double_);
+    typeMismatch(Type::INTEGER);
+}
+
+double Value::asDouble() const {
+    if (type_ == Type::DOUBLE) return double_;
+    if (type_ == Type::INTEGER) return static_cast<double>(integer_);
+    typeMismatch(Type::DOUBLE);
+}
+
+std::string_view Value::asString() const {
+    if (type_ != Type::STRING) typeMismatch(Type::STRING);
+    return string_;
+}
+
+const Array& Value::asArray() const {
+    if (type_ != Type::ARRAY) typeMismatch(Type::ARRAY);
+    return array_;
+}
+
+Array& Value::asArray() {
+    if (type_ != Type::ARRAY) typeMismatch(Type::ARRAY);
+    return array_;
+}
+
+const Object& Value::asObject() const {
+    if (type_ != Type::OBJECT) typeMismatch(Type::OBJECT);
+    return object_;
+}
+
+Object& Value::asObject() {
+    if (type_ != Type::OBJECT) typeMismatch(Type::OBJECT);
+    return object_;
+}
+
+std::string Value::getString(std::string_view key, std::string_view fallback) const {
+    const Value* value = find(key);
+    return std::string(value && value->isString() ? std::string_view(value->string_) : fallback);
+}
+
+bool Value::getBool(std::string_view key, bool fallback) const {
+    const Value* value = find(key);
+    return value && value->isBool() ? value->boolean_ : fallback;
+}
+
+int64_t Value::getInt(std::string_view key, int64_t fallback) const {
+    const Value* value = find(key);
+    return value && value->isNumber() ? value->asInt() : fallback;
+}
+
+double Value::getDouble(std::string_view key, double fallback) const {
+    const Value* value = find(key);
+    return value && value->isNumber() ? value->asDouble() : fallback;
+}
+
+Value& Value::operator[](std::string_view key) {
+    if (type_ == Type::NUL) {
+        new (&object_) Object(resource_);
+        type_ = Type::OBJECT;
+    }
+    if (Value* existing = find(key)) return *existing;
+    Object& members = asObject();
+    members.emplace_back(key, Value(resource_), resource_);
+    return members.back().value;
+}
+
+const Value* Value::find(std::string_view key) const {
+    if (type_ != Type::OBJECT) return nullptr;
+    for (auto it = object_.rbegin(); it != object_.rend(); ++it) {
+        if (it->key == key) return &it->value;
+    }
+    return nullptr;
+}
+
+Value* Value::find(std::string_view key) {
+    return const_cast<Value*>(static_cast<const Value&>(*this).find(key));
+}
+
+const Value& Value::at(std::string_view key) const {
+    const Value* value = find(key);
+    if (!value) throw std::out_of_range("json: no member '" + std::string(key) + "'");
+    return *value;
+}
+
+Value& Value::at(std::string_view key) {
+    return const_cast<Value&>(static_cast<const Value&>(*this).at(key));
+}
+
+bool Value::erase(std::string_view key) {
+    if (type_ != Type::OBJECT) return false;
+    auto it = std::remove_if(object_.begin(), object_.end(), [key](const Member& member) { return member.key == key; });
+    if (it == object_.end()) return false;
+    object_.erase(it, object_.end());
+    return true;
+}
+
+Value& Value::push_back(Value value) {
+    if (type_ == Type::NUL) {
+        new (&array_) Array(resource_);
+        type_ = Type::ARRAY;
+    }
+    Array& elements = asArray();
+    if (value.resource_ == resource_) return elements.emplace_back(std::move(value));
+    return elements.emplace_back(value, resource_);
+}
+
+size_t Value::size() const {
+    if (type_ == Type::ARRAY) return array_.size();
+    if (type_ == Type::OBJECT) return object_.size();
+    return 0;
+}
+
+void Value::clear() {
+    if (type_ == Type::ARRAY) array_.clear();
+    else if (type_ == Type::OBJECT) object_.clear();
+    else reset();
+}
+
+bool operator==(const Value& a, const Value& b) {
+    if (a.isNumber() && b.isNumber() && a.type_ != b.type_) {
+        return a.asDouble() == b.asDouble();
+    }
+    if (a.type_ != b.type_) return false;
+    switch (a.type_) {
+        case Type::NUL: return true;
+        case Type::BOOLEAN: return a.boolean_ == b.boolean_;
+        case Type::INTEGER: return a.integer_ == b.integer_;
+        case Type::DOUBLE: return a.double_ == b.double_;
+        case Type::STRING: return a.string_ == b.string_;
+        case Type::ARRAY:
+            return std::equal(a.array_.begin(), a.array_.end(), b.array_.begin(), b.array_.end());
+        case Type::OBJECT:
+            // Member order does not matter
+            if (a.object_.size() != b.object_.size()) return false;
+            for (const auto& member : a.object_) {
+                const Value* other = b.find(member.key);
+                if (!other || *other != member.value) return false;
+            }
+            return true;
+    }
+    return false;
+}
+
+// Document implementation
+Document::Document(size_t initialBytes) : arena_(initialBytes), root_(&arena_) {}
+
+bool Document::parse(std::string_view text, ParseError* error) {
+    TreeBuilder builder(&arena_);
+    if (!json::parse(text, builder, error)) {
+        root_ = Value(&arena_);
+        return false;
+    }
+    root_ = std::move(builder.root());
+    return true;
+}
+
+bool parse(std::string_view text, Handler& handler, ParseError* error) {
+    return Parser(text, handler, error).run();
+}
+
+std::optional<Value> parse(std::string_view text, ParseError* error, std::pmr::memory_resource* resource) {
+    TreeBuilder builder(resource);
+    if (!parse(text, builder, error)) return std::nullopt;
+    return std::move(builder.root());
+}
+
+// Writer implementation
+Writer::Writer(std::string& out, const WriteOptions& options) : out_(out), options_(options) {}
+
+void Writer::newline() {
+    if (options_.indent < 0) return;
+    out_ += '\n';
+    out_.append(hasElements_.size() * static_cast<size_t>(options_.indent), ' ');
+}
+
+void Writer::beforeValue() {
+    if (afterKey_) {
+        afterKey_ = false;
+        return;
+    }
+    if (hasElements_.empty()) return;
+    if (hasElements_.back()) out_ += ',';
+    hasElements_.back() = true;
+    newline();
+}
+
+void Writer::close(char bracket) {
+    bool nonEmpty = hasElements_.back();
+    hasElements_.pop_back();
+    if (nonEmpty) newline();
+    out_ += bracket;
+}
+
+void Writer::null() {
+    beforeValue();
+    out_ += "null";
+}
+
+void Writer::boolean(bool value) {
+    beforeValue();
+    out_ += value ? "true" : "false";
+}
+
+void Writer::integer(int64_t value) {
+    beforeValue();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, result.ptr);
+}
+
+void Writer::number(double value) {
+    beforeValue();
+    if (!std::isfinite(value)) {
+        out_ += "null";
+        return;
+    }
+    // Shortest representation that round-trips
+    char buffer[32];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out_.append(buffer, result.ptr);
+    // Keep integral doubles recognisable as doubles when read back
+    if (std::find_if(buffer, result.ptr, [](char c) { return c == '.' || c == 'e' || c == 'n' || c == 'i'; }) ==
+        result.ptr) {
+        out_ += ".0";
+    }
+}
+
+void Writer::string(std::string_view value) {
+    beforeValue();
+    writeEscaped(out_, value);
+}
+
+void Writer::startObject() {
+    beforeValue();
+    out_ += '{';
+    hasElements_.push_back(false);
+}
+
+void Writer::key(std::string_view key) {
+    beforeValue();
+    writeEscaped(out_, key);
+    out_ += options_.indent < 0 ? ":" : ": ";
+    afterKey_ = true;
+}
+
+void Writer::endObject() {
+    close('}');
+}
+
+void Writer::startArray() {
+    beforeValue();
+    out_ += '[';
+    hasElements_.push_back(false);
+}
+
+void Writer::endArray() {
+    close(']');
+}
+
+void Writer::value(const Value& value) {
+    switch (value.type()) {
+        case Type::NUL: null(); break;
+        case Type::BOOLEAN: boolean(value.asBool()); break;
+        case Type::INTEGER: integer(value.asInt()); break;
+        case Type::DOUBLE: number(value.asDouble()); break;
+        case Type::STRING: string(value.asString()); break;
+        case Type::ARRAY:
+            startArray();
+            for (const auto& element : value.asArray()) this->value(element);
+            endArray();
+            break;
+        case Type::OBJECT: {
+            startObject();
+            const Object& members = value.asObject();
+            if (options_.sortKeys) {
+                std::vector<const Member*> sorted;
+                sorted.reserve(members.size());
+                for (const auto& member : members) sorted.push_back(&member);
+                std::stable_sort(sorted.begin(), sorted.end(),
+                                 [](const Member* a, const Member* b) { return a->key < b->key; });
+                for (const Member* member : sorted) {
+                    key(member->key);
+                    this->value(member->value);
+                }
+            } else {
+                for (const auto& member : members) {
+                    key(member.key);
+                    this->value(member.value);
+                }
+            }
+            endObject();
+            break;
+        }
+    }
+}
+
+std::string write(const Value& value, const WriteOptions& options) {
+    std::string out;
+    write(value, out, options);
+    return out;
+}
+
+void write(const Value& value, std::string& out, const WriteOptions& options) {
+    Writer writer(out, options);
+    writer.value(value);
+}
+
+} // namespace json
+} // namespace elizaos
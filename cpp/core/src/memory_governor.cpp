@@ -0,0 +1,320 @@
+#include "elizaos/memory_governor.hpp"
+#include "elizaos/metrics.hpp"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <unistd.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace elizaos {
+
+namespace {
+
+// Fraction of its own size a cache is asked for per pass, by pressure level
+constexpr double SHRINK_FRACTION[] = {0.0, 0.125, 0.25, 0.5};
+
+struct GovernorMetrics {
+    Gauge& resident;
+    Gauge& budget;
+    Gauge& pressure;
+    Gauge& accounted;
+    Counter& reclaimed;
+};
+
+GovernorMetrics& governorMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static GovernorMetrics metrics{
+        registry.gauge("elizaos_memory_resident_bytes", "Resident memory at the last governor pass"),
+        registry.gauge("elizaos_memory_budget_bytes", "Memory budget the governor enforces"),
+        registry.gauge("elizaos_memory_pressure", "Pressure level: 0 none, 1 moderate, 2 high, 3 critical"),
+        registry.gauge("elizaos_memory_accounted_bytes", "Bytes held by registered caches"),
+        registry.counter("elizaos_memory_reclaimed_bytes_total", "Bytes released by shrinking caches")};
+    return metrics;
+}
+
+CachePriority highestShrunk(MemoryPressure pressure) {
+    switch (pressure) {
+        case MemoryPressure::MODERATE: return CachePriority::LOW;
+        case MemoryPressure::HIGH: return CachePriority::NORMAL;
+        default: return CachePriority::HIGH;
+    }
+}
+
+// Hands freed pages back to the kernel, or resident size would not reflect
+// the shrinking until the allocator reused them
+void releaseFreeHeap() {
+#if defined(__GLIBC__)
+    malloc_trim(0);
+#endif
+}
+
+} // anonymous namespace
+
+const char* memoryPressureName(MemoryPressure pressure) {
+    switch (pressure) {
+        case MemoryPressure::NONE: return "none";
+        case MemoryPressure::MODERATE: return "moderate";
+        case MemoryPressure::HIGH: return "high";
+        case MemoryPressure::CRITICAL: return "critical";
+    }
+    return "unknown";
+}
+
+// MemoryGovernor implementation
+MemoryGovernor::~MemoryGovernor() {
+    stop();
+}
+
+MemoryGovernor& MemoryGovernor::global() {
+    // Never destroyed: consumers with static lifetime unregister during
+    // static destruction
+    static MemoryGovernor* instance = new MemoryGovernor();
+    return *instance;
+}
+
+void MemoryGovernor::configure(const MemoryBudgetConfig& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    config_ = config;
+    detectedBudget_.reset();
+}
+
+MemoryBudgetConfig MemoryGovernor::getConfig() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+void MemoryGovernor::registerConsumer(MemoryConsumer& consumer, CachePriority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Registration* registration = findLocked(consumer)) {
+        registration->priority = priority;
+        return;
+    }
+    consumers_.push_back({&consumer, priority});
+}
+
+bool MemoryGovernor::unregisterConsumer(const MemoryConsumer& consumer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // A consumer unregistering from inside its own shrinkMemory must not wait
+    // for itself
+    auto self = std::this_thread::get_id();
+    shrinkDone_.wait(lock, [&]() {
+        return std::none_of(shrinking_.begin(), shrinking_.end(), [&](const ActiveShrink& active) {
+            return active.consumer == &consumer && active.thread != self;
+        });
+    });
+    auto it = std::find_if(consumers_.begin(), consumers_.end(),
+                           [&](const Registration& registration) { return registration.consumer == &consumer; });
+    if (it == consumers_.end()) return false;
+    consumers_.erase(it);
+    return true;
+}
+
+MemoryGovernor::Registration* MemoryGovernor::findLocked(const MemoryConsumer& consumer) {
+    for (auto& registration : consumers_) {
+        if (registration.consumer == &consumer) return &registration;
+    }
+    return nullptr;
+}
+
+MemoryPressure MemoryGovernor::evaluate() {
+    return evaluate(readResidentBytes());
+}
+
+MemoryPressure MemoryGovernor::evaluate(size_t usedBytes) {
+    auto& metrics = governorMetrics();
+    MemoryPressure pressure = MemoryPressure::NONE;
+    size_t excess = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t budget = budgetLocked();
+        double ratio = budget ? static_cast<double>(usedBytes) / static_cast<double>(budget) : 0.0;
+        if (ratio >= config_.criticalRatio) {
+            pressure = MemoryPressure::CRITICAL;
+        } else if (ratio >= config_.highRatio) {
+            pressure = MemoryPressure::HIGH;
+        } else if (ratio >= config_.moderateRatio) {
+            pressure = MemoryPressure::MODERATE;
+        }
+        pressure_ = pressure;
+        usedBytes_ = usedBytes;
+        metrics.resident.set(static_cast<int64_t>(usedBytes));
+        metrics.budget.set(static_cast<int64_t>(budget));
+        metrics.pressure.set(static_cast<int64_t>(pressure));
+
+        auto target = static_cast<size_t>(static_cast<double>(budget) * config_.moderateRatio);
+        excess = usedBytes > target ? usedBytes - target : 0;
+    }
+
+    if (pressure != MemoryPressure::NONE) {
+        size_t reclaimed = shed(pressure, excess);
+        if (reclaimed > 0) {
+            metrics.reclaimed.increment(reclaimed);
+            releaseFreeHeap();
+        }
+    }
+
+    metrics.accounted.set(static_cast<int64_t>(getAccountedBytes()));
+    return pressure;
+}
+
+size_t MemoryGovernor::shed(MemoryPressure pressure, size_t excess) {
+    // Victims are chosen under the lock and shrunk after releasing it, so a
+    // consumer's shrinkMemory can take its own locks or call the governor
+    struct Candidate {
+        MemoryConsumer* consumer;
+        CachePriority priority;
+        size_t bytes;
+    };
+    std::vector<Candidate> candidates;
+    CachePriority limit = highestShrunk(pressure);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& registration : consumers_) {
+            if (registration.priority > limit) continue;
+            candidates.push_back({registration.consumer, registration.priority,
+                                  registration.consumer->getAccountedBytes()});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.bytes > b.bytes;
+    });
+
+    double fraction = SHRINK_FRACTION[static_cast<size_t>(pressure)];
+    size_t reclaimed = 0;
+    for (const auto& candidate : candidates) {
+        if (excess == 0) break;
+        size_t request = std::min(excess, static_cast<size_t>(static_cast<double>(candidate.bytes) * fraction));
+        if (request == 0) continue;
+        {
+            // Unregistered since the candidates were collected
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!findLocked(*candidate.consumer)) continue;
+            shrinking_.push_back({candidate.consumer, std::this_thread::get_id()});
+        }
+        size_t freed = candidate.consumer->shrinkMemory(request);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto active = std::find_if(shrinking_.begin(), shrinking_.end(), [&](const ActiveShrink& entry) {
+                return entry.consumer == candidate.consumer && entry.thread == std::this_thread::get_id();
+            });
+            if (active != shrinking_.end()) shrinking_.erase(active);
+            if (Registration* registration = findLocked(*candidate.consumer)) registration->reclaimedBytes += freed;
+        }
+        shrinkDone_.notify_all();
+        reclaimed += freed;
+        excess -= std::min(excess, freed);
+    }
+    return reclaimed;
+}
+
+size_t MemoryGovernor::budgetLocked() const {
+    if (config_.budgetBytes > 0) return config_.budgetBytes;
+    if (!detectedBudget_) {
+        size_t physical = readPhysicalBytes();
+        auto cgroup = readCgroupLimit();
+        detectedBudget_ = cgroup && (physical == 0 || *cgroup < physical) ? *cgroup : physical;
+    }
+    return *detectedBudget_;
+}
+
+void MemoryGovernor::start() {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread([this]() {
+        std::unique_lock<std::mutex> threadLock(threadMutex_);
+        while (running_) {
+            threadLock.unlock();
+            evaluate();
+            auto interval = getConfig().pollInterval;
+            threadLock.lock();
+            wake_.wait_for(threadLock, interval, [this]() { return !running_; });
+        }
+    });
+}
+
+void MemoryGovernor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(threadMutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+bool MemoryGovernor::isRunning() const {
+    std::lock_guard<std::mutex> lock(threadMutex_);
+    return running_;
+}
+
+MemoryPressure MemoryGovernor::getPressure() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pressure_;
+}
+
+size_t MemoryGovernor::getBudgetBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return budgetLocked();
+}
+
+size_t MemoryGovernor::getUsedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return usedBytes_;
+}
+
+size_t MemoryGovernor::getAccountedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t accounted = 0;
+    for (const auto& registration : consumers_) accounted += registration.consumer->getAccountedBytes();
+    return accounted;
+}
+
+std::vector<MemoryConsumerUsage> MemoryGovernor::getUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<MemoryConsumerUsage> usage;
+    usage.reserve(consumers_.size());
+    for (const auto& registration : consumers_) {
+        usage.push_back({registration.consumer->getConsumerName(), registration.priority,
+                         registration.consumer->getAccountedBytes(), registration.reclaimedBytes});
+    }
+    return usage;
+}
+
+size_t MemoryGovernor::readResidentBytes() {
+    // Second field of statm is resident pages
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if (!(statm >> totalPages >> residentPages)) return 0;
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return pageSize > 0 ? residentPages * static_cast<size_t>(pageSize) : 0;
+}
+
+std::optional<size_t> MemoryGovernor::readCgroupLimit() {
+    // cgroup v2 reports "max" when unlimited; v1 reports a huge page-aligned value
+    for (const char* path : {"/sys/fs/cgroup/memory.max", "/sys/fs/cgroup/memory/memory.limit_in_bytes"}) {
+        std::ifstream in(path);
+        std::string value;
+        if (!(in >> value) || value == "max") continue;
+        try {
+            unsigned long long limit = std::stoull(value);
+            if (limit > 0 && limit < (std::numeric_limits<size_t>::max() >> 1)) return static_cast<size_t>(limit);
+        } catch (const std::exception&) {
+        }
+    }
+    return std::nullopt;
+}
+
+size_t MemoryGovernor::readPhysicalBytes() {
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (pages <= 0 || pageSize <= 0) return 0;
+    return static_cast<size_t>(pages) * static_cast<size_t>(pageSize);
+}
+
+} // namespace elizaos
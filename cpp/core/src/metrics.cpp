@@ -0,0 +1,555 @@
+#include "elizaos/metrics.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+namespace elizaos {
+
+namespace detail {
+
+size_t assignMetricShard() {
+    static std::atomic<size_t> next{0};
+    return next.fetch_add(1, std::memory_order_relaxed) % METRIC_SHARDS;
+}
+
+} // namespace detail
+
+namespace {
+
+thread_local uint64_t currentSpan = 0;
+
+constexpr char BINARY_MAGIC[4] = {'E', 'Z', 'M', '1'};
+constexpr double EXPORTED_QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+size_t roundUpToPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+std::string formatDouble(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+std::string escapeLabelValue(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size());
+    for (char c : value) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '"') escaped += "\\\"";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+std::string escapeHelp(const std::string& help) {
+    std::string escaped;
+    escaped.reserve(help.size());
+    for (char c : help) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped;
+}
+
+std::string formatLabels(const MetricLabels& labels, const std::string& extraName = "",
+                         const std::string& extraValue = "") {
+    if (labels.empty() && extraName.empty()) return "";
+    std::string out = "{";
+    bool first = true;
+    for (const auto& label : labels) {
+        if (!first) out += ',';
+        out += label.first + "=\"" + escapeLabelValue(label.second) + "\"";
+        first = false;
+    }
+    if (!extraName.empty()) {
+        if (!first) out += ',';
+        out += extraName + "=\"" + extraValue + "\"";
+    }
+    return out + "}";
+}
+
+const char* typeName(MetricType type) {
+    switch (type) {
+        case MetricType::COUNTER: return "counter";
+        case MetricType::GAUGE: return "gauge";
+        case MetricType::HISTOGRAM: return "summary";
+    }
+    return "untyped";
+}
+
+// Binary encoding helpers
+void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+void writeString(std::vector<uint8_t>& out, const std::string& value) {
+    writeVarint(out, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+uint64_t zigzag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t unzigzag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+class BinaryReader {
+public:
+    BinaryReader(const std::vector<uint8_t>& data, size_t offset) : data_(data), pos_(offset) {}
+
+    bool readVarint(uint64_t& value) {
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos_ >= data_.size()) return false;
+            uint8_t byte = data_[pos_++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    bool readString(std::string& value) {
+        uint64_t length;
+        if (!readVarint(length) || length > data_.size() - pos_) return false;
+        value.assign(reinterpret_cast<const char*>(data_.data() + pos_), length);
+        pos_ += length;
+        return true;
+    }
+
+    bool readBytes(void* target, size_t length) {
+        if (length > data_.size() - pos_) return false;
+        std::memcpy(target, data_.data() + pos_, length);
+        pos_ += length;
+        return true;
+    }
+
+    bool atEnd() const { return pos_ == data_.size(); }
+
+private:
+    const std::vector<uint8_t>& data_;
+    size_t pos_;
+};
+
+} // anonymous namespace
+
+// Counter implementation
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// Histogram implementation
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (count == 0 || buckets.empty()) return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * static_cast<double>(count))));
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+        seen += buckets[bucket];
+        if (seen >= rank) {
+            return std::min(std::max(Histogram::bucketUpperBound(bucket), min), max);
+        }
+    }
+    return max;
+}
+
+Histogram::~Histogram() {
+    for (auto& shard : shards_) {
+        delete shard.load(std::memory_order_relaxed);
+    }
+}
+
+Histogram::Shard* Histogram::allocateShard(size_t index) {
+    Shard* fresh = new Shard();
+    Shard* expected = nullptr;
+    if (!shards_[index].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+        delete fresh;
+        return expected;
+    }
+    return fresh;
+}
+
+uint64_t Histogram::bucketLowerBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket;
+    int exponent = static_cast<int>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    uint64_t sub = bucket % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t Histogram::bucketUpperBound(size_t bucket) {
+    if (bucket < SUB_BUCKETS) return bucket;
+    int exponent = static_cast<int>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+    return bucketLowerBound(bucket) + ((uint64_t(1) << (exponent - SUB_BUCKET_BITS)) - 1);
+}
+
+HistogramSnapshot Histogram::snapshot() const {
+    HistogramSnapshot snapshot;
+    snapshot.buckets.assign(BUCKET_COUNT, 0);
+    uint64_t min = UINT64_MAX;
+
+    for (const auto& slot : shards_) {
+        const Shard* shard = slot.load(std::memory_order_acquire);
+        if (!shard) continue;
+        // The count is the bucket total, so it always matches the buckets
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            uint64_t count = shard->buckets[i].load(std::memory_order_relaxed);
+            snapshot.buckets[i] += count;
+            snapshot.count += count;
+        }
+        snapshot.sum += shard->sum.load(std::memory_order_relaxed);
+        min = std::min(min, shard->min.load(std::memory_order_relaxed));
+        snapshot.max = std::max(snapshot.max, shard->max.load(std::memory_order_relaxed));
+    }
+    snapshot.min = snapshot.count ? min : 0;
+    return snapshot;
+}
+
+// Tracer implementation
+Tracer::Tracer(size_t capacity)
+    : capacity_(roundUpToPowerOfTwo(std::max<size_t>(capacity, 1))), slots_(new Slot[capacity_]) {}
+
+Tracer::~Tracer() = default;
+
+Tracer& Tracer::global() {
+    // Never destroyed: spans may still close during static destruction
+    static Tracer* instance = new Tracer();
+    return *instance;
+}
+
+void Tracer::record(const SpanRecord& span) {
+    if (!isEnabled()) return;
+    uint64_t ticket = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots_[ticket & (capacity_ - 1)];
+
+    slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.id.store(span.id, std::memory_order_relaxed);
+    slot.parentId.store(span.parentId, std::memory_order_relaxed);
+    slot.name.store(span.name, std::memory_order_relaxed);
+    slot.startNanos.store(span.startNanos, std::memory_order_relaxed);
+    slot.durationNanos.store(span.durationNanos, std::memory_order_relaxed);
+    slot.threadShard.store(span.threadShard, std::memory_order_relaxed);
+    slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+}
+
+std::vector<SpanRecord> Tracer::collect(size_t maxSpans) const {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t available = std::min<uint64_t>(head, capacity_);
+    uint64_t wanted = std::min<uint64_t>(available, maxSpans);
+
+    std::vector<SpanRecord> spans;
+    spans.reserve(wanted);
+    for (uint64_t ticket = head - wanted; ticket < head; ++ticket) {
+        const Slot& slot = slots_[ticket & (capacity_ - 1)];
+        uint64_t expected = 2 * ticket + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected) continue;
+
+        SpanRecord span;
+        span.id = slot.id.load(std::memory_order_relaxed);
+        span.parentId = slot.parentId.load(std::memory_order_relaxed);
+        span.name = slot.name.load(std::memory_order_relaxed);
+        span.startNanos = slot.startNanos.load(std::memory_order_relaxed);
+        span.durationNanos = slot.durationNanos.load(std::memory_order_relaxed);
+        span.threadShard = slot.threadShard.load(std::memory_order_relaxed);
+
+        // A writer lapping the ring mid-copy changes the sequence
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected) continue;
+        spans.push_back(span);
+    }
+    return spans;
+}
+
+// TraceSpan implementation
+TraceSpan::TraceSpan(const char* name, Histogram* latency, Tracer& tracer)
+    : tracer_(tracer), latency_(latency), name_(name) {
+    if (tracer_.isEnabled()) {
+        id_ = tracer_.nextSpanId();
+        parentId_ = currentSpan;
+        currentSpan = id_;
+    }
+    start_ = monotonicNanos();
+}
+
+TraceSpan::~TraceSpan() {
+    uint64_t duration = monotonicNanos() - start_;
+    if (latency_) latency_->record(duration);
+    if (id_ == 0) return;
+
+    SpanRecord span;
+    span.id = id_;
+    span.parentId = parentId_;
+    span.name = name_;
+    span.startNanos = start_;
+    span.durationNanos = duration;
+    span.threadShard = detail::metricShard();
+    tracer_.record(span);
+    currentSpan = parentId_;
+}
+
+uint64_t TraceSpan::currentSpanId() {
+    return currentSpan;
+}
+
+// MetricsSnapshot implementation
+const MetricSample* MetricsSnapshot::find(const std::string& name, const MetricLabels& labels) const {
+    MetricLabels sorted = labels;
+    std::sort(sorted.begin(), sorted.end());
+    for (const auto& sample : samples) {
+        if (sample.name == name && sample.labels == sorted) return &sample;
+    }
+    return nullptr;
+}
+
+// MetricsRegistry implementation
+class MetricsRegistry::Impl {
+public:
+    struct Entry {
+        MetricType type;
+        std::string name;
+        std::string help;
+        MetricLabels labels;
+        double scale = 1.0;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    Entry& getOrCreate(MetricType type, const std::string& name, const std::string& help,
+                       const MetricLabels& labels, double scale) {
+        MetricLabels sorted = labels;
+        std::sort(sorted.begin(), sorted.end());
+
+        // '\x1f' sorts below every name character, so a family's series stay
+        // contiguous and ordered by labels
+        std::string key = name;
+        for (const auto& label : sorted) {
+            key += '\x1f' + label.first + '\x1e' + label.second;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto family = families.find(name);
+        if (family != families.end() && family->second != type) {
+            throw std::invalid_argument("Metric " + name + " is already registered with another type");
+        }
+
+        auto it = entries.find(key);
+        if (it != entries.end()) return it->second;
+
+        families[name] = type;
+        Entry& entry = entries[key];
+        entry.type = type;
+        entry.name = name;
+        entry.help = help;
+        entry.labels = std::move(sorted);
+        entry.scale = scale;
+        switch (type) {
+            case MetricType::COUNTER: entry.counter = std::make_unique<Counter>(); break;
+            case MetricType::GAUGE: entry.gauge = std::make_unique<Gauge>(); break;
+            case MetricType::HISTOGRAM: entry.histogram = std::make_unique<Histogram>(); break;
+        }
+        return entry;
+    }
+
+    mutable std::mutex mutex;
+    std::map<std::string, Entry> entries;
+    std::map<std::string, MetricType> families;
+};
+
+MetricsRegistry::MetricsRegistry() : impl_(std::make_unique<Impl>()) {}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry& MetricsRegistry::global() {
+    // Never destroyed: instrumented code holds references into it
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return *impl_->getOrCreate(MetricType::COUNTER, name, help, labels, 1.0).counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const MetricLabels& labels) {
+    return *impl_->getOrCreate(MetricType::GAUGE, name, help, labels, 1.0).gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help, const MetricLabels& labels,
+                                      double scale) {
+    return *impl_->getOrCreate(MetricType::HISTOGRAM, name, help, labels, scale).histogram;
+}
+
+size_t MetricsRegistry::getMetricCount() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->entries.size();
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+    MetricsSnapshot snapshot;
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    snapshot.samples.reserve(impl_->entries.size());
+    for (const auto& item : impl_->entries) {
+        const Impl::Entry& entry = item.second;
+        MetricSample sample;
+        sample.type = entry.type;
+        sample.name = entry.name;
+        sample.help = entry.help;
+        sample.labels = entry.labels;
+        sample.scale = entry.scale;
+        switch (entry.type) {
+            case MetricType::COUNTER: sample.value = static_cast<int64_t>(entry.counter->value()); break;
+            case MetricType::GAUGE: sample.value = entry.gauge->value(); break;
+            case MetricType::HISTOGRAM: sample.histogram = entry.histogram->snapshot(); break;
+        }
+        snapshot.samples.push_back(std::move(sample));
+    }
+    return snapshot;
+}
+
+std::string MetricsRegistry::formatPrometheus(const MetricsSnapshot& snapshot) {
+    std::ostringstream out;
+    const std::string* family = nullptr;
+
+    for (const auto& sample : snapshot.samples) {
+        if (!family || *family != sample.name) {
+            family = &sample.name;
+            if (!sample.help.empty()) out << "# HELP " << sample.name << ' ' << escapeHelp(sample.help) << '\n';
+            out << "# TYPE " << sample.name << ' ' << typeName(sample.type) << '\n';
+        }
+
+        if (sample.type != MetricType::HISTOGRAM) {
+            out << sample.name << formatLabels(sample.labels) << ' ' << sample.value << '\n';
+            continue;
+        }
+
+        const HistogramSnapshot& histogram = sample.histogram;
+        for (double q : EXPORTED_QUANTILES) {
+            out << sample.name << formatLabels(sample.labels, "quantile", formatDouble(q)) << ' '
+                << formatDouble(static_cast<double>(histogram.percentile(q)) * sample.scale) << '\n';
+        }
+        out << sample.name << "_sum" << formatLabels(sample.labels) << ' '
+            << formatDouble(static_cast<double>(histogram.sum) * sample.scale) << '\n';
+        out << sample.name << "_count" << formatLabels(sample.labels) << ' ' << histogram.count << '\n';
+    }
+    return out.str();
+}
+
+std::vector<uint8_t> MetricsRegistry::encodeBinary(const MetricsSnapshot& snapshot) {
+    std::vector<uint8_t> out(BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC));
+    writeVarint(out, snapshot.samples.size());
+
+    for (const auto& sample : snapshot.samples) {
+        out.push_back(static_cast<uint8_t>(sample.type));
+        writeString(out, sample.name);
+        writeVarint(out, sample.labels.size());
+        for (const auto& label : sample.labels) {
+            writeString(out, label.first);
+            writeString(out, label.second);
+        }
+
+        if (sample.type != MetricType::HISTOGRAM) {
+            writeVarint(out, zigzag(sample.value));
+            continue;
+        }
+
+        uint8_t scale[sizeof(double)];
+        std::memcpy(scale, &sample.scale, sizeof(double));
+        out.insert(out.end(), scale, scale + sizeof(double));
+
+        const HistogramSnapshot& histogram = sample.histogram;
+        writeVarint(out, histogram.count);
+        writeVarint(out, histogram.sum);
+        writeVarint(out, histogram.min);
+        writeVarint(out, histogram.max);
+
+        // Only occupied buckets, as (gap since previous occupied bucket, count)
+        size_t occupied = std::count_if(histogram.buckets.begin(), histogram.buckets.end(),
+                                        [](uint64_t count) { return count != 0; });
+        writeVarint(out, occupied);
+        size_t previous = 0;
+        for (size_t bucket = 0; bucket < histogram.buckets.size(); ++bucket) {
+            if (histogram.buckets[bucket] == 0) continue;
+            writeVarint(out, bucket - previous);
+            writeVarint(out, histogram.buckets[bucket]);
+            previous = bucket;
+        }
+    }
+    return out;
+}
+
+std::optional<MetricsSnapshot> MetricsRegistry::decodeBinary(const std::vector<uint8_t>& data) {
+    if (data.size() < sizeof(BINARY_MAGIC) || !std::equal(BINARY_MAGIC, BINARY_MAGIC + sizeof(BINARY_MAGIC),
+                                                          data.begin())) {
+        return std::nullopt;
+    }
+    BinaryReader reader(data, sizeof(BINARY_MAGIC));
+
+    uint64_t sampleCount;
+    if (!reader.readVarint(sampleCount)) return std::nullopt;
+
+    MetricsSnapshot snapshot;
+    for (uint64_t i = 0; i < sampleCount; ++i) {
+        MetricSample sample;
+        uint8_t type;
+        uint64_t labelCount;
+        if (!reader.readBytes(&type, 1) || type > static_cast<uint8_t>(MetricType::HISTOGRAM)) return std::nullopt;
+        sample.type = static_cast<MetricType>(type);
+        if (!reader.readString(sample.name) || !reader.readVarint(labelCount)) return std::nullopt;
+        for (uint64_t l = 0; l < labelCount; ++l) {
+            std::pair<std::string, std::string> label;
+            if (!reader.readString(label.first) || !reader.readString(label.second)) return std::nullopt;
+            sample.labels.push_back(std::move(label));
+        }
+
+        if (sample.type != MetricType::HISTOGRAM) {
+            uint64_t value;
+            if (!reader.readVarint(value)) return std::nullopt;
+            sample.value = unzigzag(value);
+            snapshot.samples.push_back(std::move(sample));
+            continue;
+        }
+
+        HistogramSnapshot& histogram = sample.histogram;
+        uint64_t occupied;
+        if (!reader.readBytes(&sample.scale, sizeof(double)) || !reader.readVarint(histogram.count) ||
+            !reader.readVarint(histogram.sum) || !reader.readVarint(histogram.min) ||
+            !reader.readVarint(histogram.max) || !reader.readVarint(occupied)) {
+            return std::nullopt;
+        }
+        histogram.buckets.assign(Histogram::BUCKET_COUNT, 0);
+        uint64_t bucket = 0;
+        for (uint64_t b = 0; b < occupied; ++b) {
+            uint64_t gap, count;
+            if (!reader.readVarint(gap) || !reader.readVarint(count)) return std::nullopt;
+            bucket += gap;
+            if (bucket >= Histogram::BUCKET_COUNT) return std::nullopt;
+            histogram.buckets[bucket] = count;
+        }
+        snapshot.samples.push_back(std::move(sample));
+    }
+
+    if (!reader.atEnd()) return std::nullopt;
+    return snapshot;
+}
+
+} // namespace elizaos
@@ -0,0 +1,271 @@
+#include "elizaos/pool.hpp"
+#include "elizaos/metrics.hpp"
+#include <cstring>
+
+namespace elizaos {
+
+namespace {
+
+constexpr size_t CLASS_COUNT = MAX_POOLED_BYTES / POOL_GRANULARITY;
+constexpr size_t BATCH_BYTES = 16 * 1024;
+constexpr size_t MAX_SPARE_CHUNKS = 8;
+
+enum class CacheState : uint8_t {
+    UNSET,
+    LIVE,
+    DESTROYED
+};
+
+Gauge& reservedBytesGauge() {
+    static Gauge& gauge = MetricsRegistry::global().gauge("elizaos_pool_reserved_bytes",
+                                                          "Bytes held in slab pool slabs");
+    return gauge;
+}
+
+size_t classIndex(size_t bytes) {
+    return bytes == 0 ? 0 : (bytes - 1) / POOL_GRANULARITY;
+}
+
+// Trivially destructible, so it stays readable while thread_local objects
+// with destructors are being torn down
+thread_local CacheState cacheState = CacheState::UNSET;
+
+} // anonymous namespace
+
+/**
+ * Free lists of the calling thread, one per size class; handed back to the
+ * pools when the thread exits
+ */
+struct PoolThreadCaches {
+    SlabPool::Cache caches[CLASS_COUNT];
+
+    PoolThreadCaches() { cacheState = CacheState::LIVE; }
+    ~PoolThreadCaches();
+};
+
+namespace {
+
+SlabPool* const* poolTable() {
+    // Leaked: blocks may be released by static destructors after main
+    static SlabPool* const* table = [] {
+        auto** pools = new SlabPool*[CLASS_COUNT];
+        for (size_t i = 0; i < CLASS_COUNT; ++i) pools[i] = nullptr;
+        return pools;
+    }();
+    return table;
+}
+
+thread_local PoolThreadCaches threadCaches;
+
+} // anonymous namespace
+
+PoolThreadCaches::~PoolThreadCaches() {
+    cacheState = CacheState::DESTROYED;
+    SlabPool* const* pools = poolTable();
+    for (size_t i = 0; i < CLASS_COUNT; ++i) {
+        if (caches[i].count > 0) pools[i]->drain(caches[i], 0);
+    }
+}
+
+// SlabPool implementation
+SlabPool& SlabPool::forSize(size_t bytes) {
+    static std::once_flag created[CLASS_COUNT];
+    size_t index = classIndex(bytes);
+    auto* pools = const_cast<SlabPool**>(poolTable());
+    std::call_once(created[index], [pools, index] {
+        pools[index] = new SlabPool(index, (index + 1) * POOL_GRANULARITY);
+    });
+    return *pools[index];
+}
+
+SlabPool::SlabPool(size_t index, size_t blockSize)
+    : index_(index), blockSize_(blockSize), batch_(std::clamp<size_t>(BATCH_BYTES / blockSize, 4, 64)) {}
+
+size_t SlabPool::getSlabCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slabs_.size();
+}
+
+SlabPool::Cache& SlabPool::threadCache() {
+    return threadCaches.caches[index_];
+}
+
+void* SlabPool::allocate() {
+    if (cacheState == CacheState::DESTROYED) {
+        // Thread teardown: go straight to the shared list
+        Cache single;
+        refill(single);
+        void* block = single.head;
+        single.head = single.head->next;
+        if (--single.count > 0) drain(single, 0);
+        return block;
+    }
+
+    Cache& cache = threadCache();
+    if (!cache.head) refill(cache);
+    FreeBlock* block = cache.head;
+    cache.head = block->next;
+    --cache.count;
+    return block;
+}
+
+void SlabPool::deallocate(void* block) noexcept {
+    auto* freed = static_cast<FreeBlock*>(block);
+    if (cacheState == CacheState::DESTROYED) {
+        Cache single{freed, 1};
+        freed->next = nullptr;
+        drain(single, 0);
+        return;
+    }
+
+    Cache& cache = threadCache();
+    freed->next = cache.head;
+    cache.head = freed;
+    if (++cache.count > 2 * batch_) drain(cache, batch_);
+}
+
+void SlabPool::refill(Cache& cache) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    while (cache.count < batch_ && shared_) {
+        FreeBlock* block = shared_;
+        shared_ = block->next;
+        --sharedCount_;
+        block->next = cache.head;
+        cache.head = block;
+        ++cache.count;
+    }
+
+    while (cache.count < batch_) {
+        if (carve_ + blockSize_ > carveEnd_) {
+            carve_ = static_cast<char*>(::operator new(SLAB_BYTES));
+            carveEnd_ = carve_ + SLAB_BYTES;
+            slabs_.push_back(carve_);
+            reservedBytesGauge().increment(static_cast<int64_t>(SLAB_BYTES));
+        }
+        auto* block = reinterpret_cast<FreeBlock*>(carve_);
+        carve_ += blockSize_;
+        block->next = cache.head;
+        cache.head = block;
+        ++cache.count;
+    }
+}
+
+void SlabPool::drain(Cache& cache, size_t keep) noexcept {
+    if (cache.count <= keep) return;
+
+    // Detach everything past the first `keep` blocks
+    FreeBlock* first = cache.head;
+    FreeBlock* last = cache.head;
+    size_t moved = cache.count - keep;
+    if (keep == 0) {
+        cache.head = nullptr;
+    } else {
+        FreeBlock* kept = cache.head;
+        for (size_t i = 1; i < keep; ++i) kept = kept->next;
+        first = kept->next;
+        kept->next = nullptr;
+    }
+    last = first;
+    while (last->next) last = last->next;
+    cache.count = keep;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    last->next = shared_;
+    shared_ = first;
+    sharedCount_ += moved;
+}
+
+void* poolAllocate(size_t bytes) {
+    if (bytes > MAX_POOLED_BYTES) return ::operator new(bytes);
+    return SlabPool::forSize(bytes).allocate();
+}
+
+void poolDeallocate(void* block, size_t bytes) noexcept {
+    if (!block) return;
+    if (bytes > MAX_POOLED_BYTES) {
+        ::operator delete(block);
+        return;
+    }
+    SlabPool::forSize(bytes).deallocate(block);
+}
+
+// GenerationArena implementation
+GenerationArena::GenerationArena(size_t chunkBytes) : chunkBytes_(std::max<size_t>(chunkBytes, 64)) {}
+
+GenerationArena::~GenerationArena() {
+    for (const auto& chunk : chunks_) ::operator delete(chunk.data);
+    for (const auto& chunk : spare_) ::operator delete(chunk.data);
+}
+
+uint64_t GenerationArena::advance() {
+    return generation_++;
+}
+
+void GenerationArena::retire(uint64_t generation) {
+    while (!chunks_.empty() && chunks_.front().generation <= generation &&
+           chunks_.front().generation < generation_) {
+        releaseChunk(chunks_.front());
+        chunks_.pop_front();
+    }
+}
+
+std::string_view GenerationArena::copy(std::string_view text) {
+    if (text.empty()) return {};
+    auto* target = static_cast<char*>(allocate(text.size(), 1));
+    std::memcpy(target, text.data(), text.size());
+    return std::string_view(target, text.size());
+}
+
+size_t GenerationArena::getUsedBytes() const {
+    size_t used = 0;
+    for (const auto& chunk : chunks_) used += chunk.used;
+    return used;
+}
+
+void* GenerationArena::do_allocate(size_t bytes, size_t alignment) {
+    if (!chunks_.empty() && chunks_.back().generation == generation_) {
+        Chunk& chunk = chunks_.back();
+        auto base = reinterpret_cast<uintptr_t>(chunk.data);
+        size_t offset = ((base + chunk.used + alignment - 1) & ~(alignment - 1)) - base;
+        if (offset + bytes <= chunk.size) {
+            chunk.used = offset + bytes;
+            return chunk.data + offset;
+        }
+    }
+
+    // Chunks start max-aligned, so padding for any fundamental alignment
+    // fits in `alignment` extra bytes
+    openChunk(bytes + alignment);
+    Chunk& chunk = chunks_.back();
+    auto base = reinterpret_cast<uintptr_t>(chunk.data);
+    size_t offset = ((base + alignment - 1) & ~(alignment - 1)) - base;
+    chunk.used = offset + bytes;
+    return chunk.data + offset;
+}
+
+void GenerationArena::openChunk(size_t minimum) {
+    if (minimum <= chunkBytes_ && !spare_.empty()) {
+        Chunk chunk = spare_.back();
+        spare_.pop_back();
+        chunk.used = 0;
+        chunk.generation = generation_;
+        chunks_.push_back(chunk);
+        return;
+    }
+
+    size_t size = std::max(chunkBytes_, minimum);
+    chunks_.push_back(Chunk{static_cast<char*>(::operator new(size)), size, 0, generation_});
+    reservedBytes_ += size;
+}
+
+void GenerationArena::releaseChunk(const Chunk& chunk) {
+    if (chunk.size == chunkBytes_ && spare_.size() < MAX_SPARE_CHUNKS) {
+        spare_.push_back(chunk);
+        return;
+    }
+    ::operator delete(chunk.data);
+    reservedBytes_ -= chunk.size;
+}
+
+} // namespace elizaos
@@ -0,0 +1,302 @@
+#include "elizaos/replay.hpp"
+#include "elizaos/core.hpp"
+#include "elizaos/uuid.hpp"
+#include "elizaos/virtual_clock.hpp"
+#include <algorithm>
+#include <iterator>
+#include <thread>
+
+namespace elizaos {
+
+namespace {
+
+constexpr char TRACE_MAGIC[8] = {'E', 'O', 'S', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t TRACE_FORMAT_VERSION = 1;
+constexpr uint8_t END_OF_TRACE = 0;         // Kind byte that starts the digest trailer
+
+struct ReplayMetrics {
+    Counter& recorded;
+    Histogram& eventLatency;
+};
+
+ReplayMetrics& replayMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static ReplayMetrics metrics{
+        registry.counter("elizaos_trace_events_recorded_total", "Inputs written to a trace"),
+        registry.histogram("elizaos_replay_event_seconds", "Handler latency of replayed inputs", {}, 1e-9)};
+    return metrics;
+}
+
+int64_t toNanoseconds(const std::chrono::system_clock::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNanoseconds(int64_t nanoseconds) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanoseconds)));
+}
+
+bool isEventKind(uint8_t kind) {
+    return kind >= static_cast<uint8_t>(TraceEventKind::MESSAGE) && kind <= static_cast<uint8_t>(TraceEventKind::CUSTOM);
+}
+
+// Seeds Uuids for a replay and releases them and the clock however it ends
+class ReplayScope {
+public:
+    explicit ReplayScope(uint64_t seed) { Uuid::seedRandom(seed); }
+    ~ReplayScope() {
+        VirtualClock::unpin();
+        Uuid::seedRandom(std::nullopt);
+    }
+    ReplayScope(const ReplayScope&) = delete;
+    ReplayScope& operator=(const ReplayScope&) = delete;
+};
+
+} // anonymous namespace
+
+std::atomic<int64_t> VirtualClock::pinned_{VirtualClock::UNPINNED};
+
+std::atomic<TraceRecorder*> TraceRecorder::active_{nullptr};
+std::atomic<int> TraceRecorder::inFlight_{0};
+
+// TraceRecorder implementation
+TraceRecorder::~TraceRecorder() {
+    stop();
+}
+
+bool TraceRecorder::start(const std::string& path, uint64_t seed, std::string* error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (recording_) {
+        if (error) *error = "already recording to " + path_;
+        return false;
+    }
+
+    TraceRecorder* expected = nullptr;
+    if (!active_.compare_exchange_strong(expected, this, std::memory_order_acq_rel)) {
+        if (error) *error = "another recorder is active";
+        return false;
+    }
+
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_) {
+        active_.store(nullptr, std::memory_order_release);
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+
+    int64_t startNanos = toNanoseconds(VirtualClock::now());
+    SnapshotWriter header;
+    header.writeRaw(std::string_view(TRACE_MAGIC, sizeof(TRACE_MAGIC)));
+    header.writeVarint(TRACE_FORMAT_VERSION);
+    header.writeVarint(seed);
+    header.writeSigned(startNanos);
+    out_.write(header.data().data(), static_cast<std::streamsize>(header.size()));
+
+    Uuid::seedRandom(seed);
+    path_ = path;
+    recording_ = true;
+    eventCount_ = 0;
+    lastNanos_ = startNanos;
+    return true;
+}
+
+bool TraceRecorder::stop(std::string* error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!recording_) return true;
+    }
+
+    // Later inputs are no longer recorded; wait out the ones already inside
+    TraceRecorder* self = this;
+    active_.compare_exchange_strong(self, nullptr, std::memory_order_acq_rel);
+    while (inFlight_.load(std::memory_order_acquire) != 0) std::this_thread::yield();
+    Uuid::seedRandom(std::nullopt);
+
+    // Digests fence the components, so they are taken without holding mutex_,
+    // which input sites reach while holding their own locks
+    std::vector<std::pair<std::string, uint32_t>> digests;
+    for (const auto* component : components_) {
+        digests.emplace_back(component->getSnapshotName(), snapshotDigest(*component));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    SnapshotWriter trailer;
+    trailer.writeU8(END_OF_TRACE);
+    trailer.writeVarint(digests.size());
+    for (const auto& [name, digest] : digests) {
+        trailer.writeString(name);
+        trailer.writeVarint(digest);
+    }
+    out_.write(trailer.data().data(), static_cast<std::streamsize>(trailer.size()));
+    out_.close();
+    recording_ = false;
+
+    if (!out_) {
+        if (error) *error = "cannot write " + path_;
+        return false;
+    }
+    return true;
+}
+
+void TraceRecorder::addComponent(const Snapshottable& component) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    components_.push_back(&component);
+}
+
+void TraceRecorder::record(TraceEventKind kind, std::string_view stream, std::string_view payload) {
+    int64_t nanos = toNanoseconds(VirtualClock::now());
+    SnapshotWriter event;
+    event.writeU8(static_cast<uint8_t>(kind));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!recording_) return;
+    // Concurrent inputs may reach the lock out of time order, hence signed deltas
+    event.writeSigned(nanos - lastNanos_);
+    event.writeString(stream);
+    event.writeString(payload);
+    out_.write(event.data().data(), static_cast<std::streamsize>(event.size()));
+    lastNanos_ = nanos;
+    eventCount_++;
+    replayMetrics().recorded.increment();
+}
+
+void TraceRecorder::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (recording_) out_.flush();
+}
+
+size_t TraceRecorder::getEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return eventCount_;
+}
+
+void TraceRecorder::recordActive(TraceEventKind kind, std::string_view stream, std::string_view payload) {
+    inFlight_.fetch_add(1, std::memory_order_acq_rel);
+    if (TraceRecorder* recorder = active_.load(std::memory_order_acquire)) {
+        recorder->record(kind, stream, payload);
+    }
+    inFlight_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+// TraceReplayer implementation
+void TraceReplayer::addHandler(TraceEventKind kind, ReplayHandler handler) {
+    handlers_.emplace_back(kind, std::move(handler));
+}
+
+void TraceReplayer::addComponent(const Snapshottable& component) {
+    components_.push_back(&component);
+}
+
+std::optional<ReplayReport> TraceReplayer::run(const std::string& path, const ReplayOptions& options,
+                                               std::string* error) {
+    if (TraceRecorder::isActive()) {
+        if (error) *error = "cannot replay while a recorder is active";
+        return std::nullopt;
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        if (error) *error = "cannot open " + path;
+        return std::nullopt;
+    }
+    std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    if (contents.size() < sizeof(TRACE_MAGIC) ||
+        contents.compare(0, sizeof(TRACE_MAGIC), TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0) {
+        if (error) *error = path + " is not a trace";
+        return std::nullopt;
+    }
+    SnapshotReader reader(std::string_view(contents).substr(sizeof(TRACE_MAGIC)));
+    uint64_t format = reader.readVarint();
+    uint64_t seed = reader.readVarint();
+    int64_t nanos = reader.readSigned();
+    if (!reader.ok() || format != TRACE_FORMAT_VERSION) {
+        if (error) *error = path + " has an unsupported trace format";
+        return std::nullopt;
+    }
+
+    // Decode everything up front; a trace cut short by a crash replays up to
+    // its last whole event
+    ReplayReport report;
+    std::vector<TraceEvent> events;
+    std::vector<std::pair<std::string, uint32_t>> digests;
+    while (!reader.atEnd()) {
+        uint8_t kind = reader.readU8();
+        if (kind == END_OF_TRACE) {
+            size_t count = reader.readCount(2);
+            for (size_t i = 0; i < count && reader.ok(); ++i) {
+                std::string name = reader.readString();
+                digests.emplace_back(std::move(name), static_cast<uint32_t>(reader.readVarint()));
+            }
+            report.complete = reader.ok();
+            if (!report.complete) digests.clear();
+            break;
+        }
+        if (!isEventKind(kind)) break;
+        TraceEvent event;
+        event.kind = static_cast<TraceEventKind>(kind);
+        int64_t eventNanos = nanos + reader.readSigned();
+        event.time = fromNanoseconds(eventNanos);
+        event.stream = reader.readString();
+        event.payload = reader.readString();
+        if (!reader.ok()) break;
+        nanos = eventNanos;
+        events.push_back(std::move(event));
+    }
+
+    Histogram latency;
+    Histogram& eventLatency = replayMetrics().eventLatency;
+    std::optional<ReplayScope> scope(std::in_place, seed);
+    auto wallStart = std::chrono::steady_clock::now();
+    bool paced = !options.asFastAsPossible && options.speed > 0.0;
+    for (const auto& event : events) {
+        if (paced) {
+            auto gap = std::chrono::duration<double>(event.time - events.front().time) / options.speed;
+            std::this_thread::sleep_until(wallStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(gap));
+        }
+        VirtualClock::pin(event.time);
+
+        bool handled = false;
+        uint64_t start = monotonicNanos();
+        for (const auto& [kind, handler] : handlers_) {
+            if (kind != event.kind) continue;
+            handler(event);
+            handled = true;
+        }
+        uint64_t elapsed = monotonicNanos() - start;
+        if (!handled) report.unhandledCount++;
+        latency.record(elapsed);
+        eventLatency.record(elapsed);
+    }
+    auto wallEnd = std::chrono::steady_clock::now();
+    scope.reset();
+
+    report.eventCount = events.size();
+    report.wallSeconds = std::chrono::duration<double>(wallEnd - wallStart).count();
+    if (!events.empty()) {
+        report.recordedSeconds = std::chrono::duration<double>(events.back().time - events.front().time).count();
+    }
+    report.eventsPerSecond = report.wallSeconds > 0.0 ? report.eventCount / report.wallSeconds : 0.0;
+    report.latency = latency.snapshot();
+
+    for (const auto& [name, digest] : digests) {
+        auto it = std::find_if(components_.begin(), components_.end(),
+                               [&](const Snapshottable* component) { return component->getSnapshotName() == name; });
+        if (it == components_.end()) {
+            report.missingComponents.push_back(name);
+        } else if (snapshotDigest(**it) != digest) {
+            report.divergedComponents.push_back(name);
+        }
+    }
+    return report;
+}
+
+void addTaskReplay(TraceReplayer& replayer, TaskManager& tasks) {
+    replayer.addHandler(TraceEventKind::TASK, [&tasks](const TraceEvent& event) {
+        SnapshotReader reader(event.payload);
+        auto task = readTask(reader);
+        if (reader.ok()) tasks.addTask(std::move(task));
+    });
+}
+
+} // namespace elizaos
@@ -0,0 +1,921 @@
+#include "elizaos/snapshot.hpp"
+#include "elizaos/core.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/metrics.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace elizaos {
+
+namespace {
+
+constexpr char FILE_MAGIC[8] = {'E', 'O', 'S', 'S', 'N', 'A', 'P', '\0'};
+constexpr char FOOTER_MAGIC[4] = {'S', 'N', 'P', 'E'};
+constexpr size_t HEADER_BYTES = 32;     // magic, format, section count, epoch, created at
+constexpr size_t FOOTER_BYTES = 24;     // table offset, table length, table CRC, magic
+constexpr size_t SECTION_ALIGNMENT = 8;
+
+struct SnapshotMetrics {
+    Histogram& saveLatency;
+    Histogram& restoreLatency;
+    Histogram& fenceLatency;
+    Gauge& lastSizeBytes;
+};
+
+SnapshotMetrics& snapshotMetrics() {
+    auto& registry = MetricsRegistry::global();
+    static SnapshotMetrics metrics{
+        registry.histogram("elizaos_snapshot_save_seconds", "Snapshot save latency", {}, 1e-9),
+        registry.histogram("elizaos_snapshot_restore_seconds", "Snapshot restore latency", {}, 1e-9),
+        registry.histogram("elizaos_snapshot_fence_seconds", "Time components were fenced for a snapshot", {}, 1e-9),
+        registry.gauge("elizaos_snapshot_bytes", "Size of the last snapshot saved")};
+    return metrics;
+}
+
+// CRC-32 (IEEE, reflected), sliced eight bytes at a time
+using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+const CrcTables& crcTables() {
+    static const CrcTables tables = [] {
+        CrcTables t{};
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+            t[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (size_t slice = 1; slice < 8; ++slice) {
+                t[slice][i] = (t[slice - 1][i] >> 8) ^ t[0][t[slice - 1][i] & 0xff];
+            }
+        }
+        return t;
+    }();
+    return tables;
+}
+
+uint32_t crc32(std::string_view data) {
+    const CrcTables& t = crcTables();
+    auto* p = reinterpret_cast<const unsigned char*>(data.data());
+    size_t n = data.size();
+    uint32_t crc = 0xffffffffu;
+    while (n >= 8) {
+        uint32_t lo = crc ^ (uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24);
+        crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+              t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return crc ^ 0xffffffffu;
+}
+
+void putFixed(std::string& out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) out.push_back(static_cast<char>(value >> (8 * i)));
+}
+
+uint64_t getFixed(const char* in, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= uint64_t(static_cast<unsigned char>(in[i])) << (8 * i);
+    return value;
+}
+
+// Flushes a file or directory to stable storage
+bool syncPath(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = ::fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#else
+    (void)path;
+    return true;
+#endif
+}
+
+int64_t toNanoseconds(const std::chrono::system_clock::time_point& time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+std::chrono::system_clock::time_point fromNanoseconds(int64_t nanoseconds) {
+    return std::chrono::system_clock::time_point(
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanoseconds)));
+}
+
+constexpr bool hostIsLittleEndian() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return false;
+#else
+    return true;
+#endif
+}
+
+} // anonymous namespace
+
+// SnapshotWriter implementation
+void SnapshotWriter::writeVarint(uint64_t value) {
+    while (value >= 0x80) {
+        out_.push_back(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out_.push_back(static_cast<char>(value));
+}
+
+void SnapshotWriter::writeSigned(int64_t value) {
+    writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+void SnapshotWriter::writeDouble(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putFixed(out_, bits, sizeof(bits));
+}
+
+void SnapshotWriter::writeString(std::string_view value) {
+    writeVarint(value.size());
+    out_.append(value.data(), value.size());
+}
+
+void SnapshotWriter::writeTimestamp(const std::chrono::system_clock::time_point& value) {
+    writeSigned(toNanoseconds(value));
+}
+
+void SnapshotWriter::writeFloats(const std::vector<float>& values) {
+    writeVarint(values.size());
+    if (hostIsLittleEndian()) {
+        out_.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+        return;
+    }
+    for (float value : values) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putFixed(out_, bits, sizeof(bits));
+    }
+}
+
+void SnapshotWriter::writeStrings(const std::vector<std::string>& values) {
+    writeVarint(values.size());
+    for (const auto& value : values) writeString(value);
+}
+
+void SnapshotWriter::writeStringMap(const std::unordered_map<std::string, std::string>& values) {
+    writeVarint(values.size());
+    for (const auto& [key, value] : values) {
+        writeString(key);
+        writeString(value);
+    }
+}
+
+// SnapshotReader implementation
+uint8_t SnapshotReader::readU8() {
+    if (failed_ || pos_ >= data_.size()) {
+        failed_ = true;
+        return 0;
+    }
+    return static_cast<uint8_t>(data_[pos_++]);
+}
+
+uint64_t SnapshotReader::readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = readU8();
+        if (failed_) return 0;
+        value |= uint64_t(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+    failed_ = true;
+    return 0;
+}
+
+int64_t SnapshotReader::readSigned() {
+    uint64_t value = readVarint();
+    return static_cast<int64_t>((value >> 1) ^ (0 - (value & 1)));
+}
+
+double SnapshotReader::readDouble() {
+    if (failed_ || remaining() < sizeof(uint64_t)) {
+        failed_ = true;
+        return 0.0;
+    }
+    uint64_t bits = getFixed(data_.data() + pos_, sizeof(bits));
+    pos_ += sizeof(bits);
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+std::string SnapshotReader::readString() {
+    size_t length = readCount();
+    if (failed_) return {};
+    std::string value(data_.substr(pos_, length));
+    pos_ += length;
+    return value;
+}
+
+std::chrono::system_clock::time_point SnapshotReader::readTimestamp() {
+    return fromNanoseconds(readSigned());
+}
+
+std::vector<float> SnapshotReader::readFloats() {
+    size_t count = readCount(sizeof(float));
+    if (failed_) return {};
+    std::vector<float> values(count);
+    if (hostIsLittleEndian()) {
+        if (count) std::memcpy(values.data(), data_.data() + pos_, count * sizeof(float));
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            auto bits = static_cast<uint32_t>(getFixed(data_.data() + pos_ + i * sizeof(float), sizeof(float)));
+            std::memcpy(&values[i], &bits, sizeof(float));
+        }
+    }
+    pos_ += count * sizeof(float);
+    return values;
+}
+
+std::vector<std::string> SnapshotReader::readStrings() {
+    std::vector<std::string> values(readCount());
+    for (auto& value : values) value = readString();
+    return values;
+}
+
+std::unordered_map<std::string, std::string> SnapshotReader::readStringMap() {
+    size_t count = readCount(2);
+    std::unordered_map<std::string, std::string> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count && !failed_; ++i) {
+        std::string key = readString();
+        values[std::move(key)] = readString();
+    }
+    return values;
+}
+
+size_t SnapshotReader::readCount(size_t minElementBytes) {
+    uint64_t count = readVarint();
+    if (failed_ || count > remaining() / std::max<size_t>(minElementBytes, 1)) {
+        failed_ = true;
+        return 0;
+    }
+    return static_cast<size_t>(count);
+}
+
+// Record codecs
+namespace {
+
+void writeBaseMetadata(SnapshotWriter& writer, const BaseMetadata& metadata) {
+    writer.writeU8(static_cast<uint8_t>(metadata.type));
+    writer.writeBool(metadata.source.has_value());
+    if (metadata.source) writer.writeString(*metadata.source);
+    writer.writeBool(metadata.sourceId.has_value());
+    if (metadata.sourceId) writer.writeString(*metadata.sourceId);
+    writer.writeBool(metadata.scope.has_value());
+    if (metadata.scope) writer.writeU8(static_cast<uint8_t>(*metadata.scope));
+    writer.writeBool(metadata.timestamp.has_value());
+    if (metadata.timestamp) writer.writeTimestamp(*metadata.timestamp);
+    writer.writeStrings(metadata.tags);
+}
+
+void readBaseMetadata(SnapshotReader& reader, BaseMetadata& metadata) {
+    uint8_t type = reader.readU8();
+    if (type > static_cast<uint8_t>(MemoryType::CUSTOM)) reader.fail();
+    metadata.type = static_cast<MemoryType>(type);
+    if (reader.readBool()) metadata.source = reader.readString();
+    if (reader.readBool()) metadata.sourceId = reader.readString();
+    if (reader.readBool()) {
+        uint8_t scope = reader.readU8();
+        if (scope > static_cast<uint8_t>(MemoryScope::ROOM)) reader.fail();
+        metadata.scope = static_cast<MemoryScope>(scope);
+    }
+    if (reader.readBool()) metadata.timestamp = reader.readTimestamp();
+    metadata.tags = reader.readStrings();
+}
+
+void writeMetadata(SnapshotWriter& writer, const MemoryMetadata& metadata) {
+    writer.writeU8(static_cast<uint8_t>(metadata.index()));
+    std::visit([&writer](const auto& value) { writeBaseMetadata(writer, value); }, metadata);
+    if (const auto* fragment = std::get_if<FragmentMetadata>(&metadata)) {
+        writer.writeString(fragment->documentId);
+        writer.writeVarint(fragment->position);
+    } else if (const auto* custom = std::get_if<CustomMetadata>(&metadata)) {
+        writer.writeStringMap(custom->customData);
+    }
+}
+
+MemoryMetadata readMetadata(SnapshotReader& reader) {
+    switch (reader.readU8()) {
+        case 0: {
+            DocumentMetadata metadata;
+            readBaseMetadata(reader, metadata);
+            return metadata;
+        }
+        case 1: {
+            FragmentMetadata metadata;
+            readBaseMetadata(reader, metadata);
+            metadata.documentId = reader.readString();
+            metadata.position = static_cast<size_t>(reader.readVarint());
+            return metadata;
+        }
+        case 2: {
+            MessageMetadata metadata;
+            readBaseMetadata(reader, metadata);
+            return metadata;
+        }
+        case 3: {
+            DescriptionMetadata metadata;
+            readBaseMetadata(reader, metadata);
+            return metadata;
+        }
+        case 4: {
+            CustomMetadata metadata;
+            readBaseMetadata(reader, metadata);
+            metadata.customData = reader.readStringMap();
+            return metadata;
+        }
+        default:
+            reader.fail();
+            return MessageMetadata();
+    }
+}
+
+} // anonymous namespace
+
+void writeMemory(SnapshotWriter& writer, const Memory& memory) {
+    writer.writeString(memory.getId());
+    writer.writeString(memory.getContent());
+    writer.writeString(memory.getEntityId());
+    writer.writeString(memory.getAgentId());
+    writer.writeString(memory.getRoomId());
+    writer.writeTimestamp(memory.getCreatedAt());
+    writeMetadata(writer, memory.getMetadata());
+    writer.writeBool(memory.isUnique());
+    writer.writeDouble(memory.getSimilarity());
+    writer.writeBool(memory.getEmbedding().has_value());
+    if (memory.getEmbedding()) writer.writeFloats(*memory.getEmbedding());
+    writer.writeStrings(memory.getHypergraphNodes());
+    writer.writeStrings(memory.getHypergraphEdges());
+}
+
+std::shared_ptr<Memory> readMemory(SnapshotReader& reader) {
+    std::string id = reader.readString();
+    std::string content = reader.readString();
+    std::string entityId = reader.readString();
+    std::string agentId = reader.readString();
+    std::string roomId = reader.readString();
+    Timestamp createdAt = reader.readTimestamp();
+    MemoryMetadata metadata = readMetadata(reader);
+
+    auto memory = makeMemory(id, content, entityId, agentId, metadata);
+    memory->setRoomId(roomId);
+    memory->setCreatedAt(createdAt);
+    memory->setUnique(reader.readBool());
+    memory->setSimilarity(reader.readDouble());
+    if (reader.readBool()) memory->setEmbedding(reader.readFloats());
+    for (const auto& node : reader.readStrings()) memory->addHypergraphNode(node);
+    for (const auto& edge : reader.readStrings()) memory->addHypergraphEdge(edge);
+    return memory;
+}
+
+void writeHypergraphNode(SnapshotWriter& writer, const HypergraphNode& node) {
+    writer.writeString(node.getId());
+    writer.writeString(node.getLabel());
+    writer.writeStringMap(node.getAttributes());
+}
+
+std::shared_ptr<HypergraphNode> readHypergraphNode(SnapshotReader& reader) {
+    std::string id = reader.readString();
+    auto node = std::make_shared<HypergraphNode>(id, reader.readString());
+    for (const auto& [key, value] : reader.readStringMap()) node->setAttribute(key, value);
+    return node;
+}
+
+void writeHypergraphEdge(SnapshotWriter& writer, const HypergraphEdge& edge) {
+    writer.writeString(edge.getId());
+    writer.writeString(edge.getLabel());
+    writer.writeStrings(edge.getNodeIds());
+    writer.writeDouble(edge.getWeight());
+}
+
+std::shared_ptr<HypergraphEdge> readHypergraphEdge(SnapshotReader& reader) {
+    std::string id = reader.readString();
+    std::string label = reader.readString();
+    auto edge = std::make_shared<HypergraphEdge>(id, label, reader.readStrings());
+    edge->setWeight(reader.readDouble());
+    return edge;
+}
+
+void writeTask(SnapshotWriter& writer, const Task& task) {
+    writer.writeString(task.getId());
+    writer.writeString(task.getName());
+    writer.writeString(task.getDescription());
+    writer.writeString(task.getRoomId());
+    writer.writeString(task.getWorldId());
+    writer.writeU8(static_cast<uint8_t>(task.getStatus()));
+    writer.writeStrings(task.getTags());
+    writer.writeStringMap(task.getOptions().data);
+    writer.writeTimestamp(task.getCreatedAt());
+    writer.writeTimestamp(task.getUpdatedAt());
+    writer.writeBool(task.getScheduledTime().has_value());
+    if (task.getScheduledTime()) writer.writeTimestamp(*task.getScheduledTime());
+    writer.writeSigned(task.getPriority());
+}
+
+std::shared_ptr<Task> readTask(SnapshotReader& reader) {
+    std::string id = reader.readString();
+    std::string name = reader.readString();
+    auto task = std::make_shared<Task>(id, name, reader.readString());
+    task->setRoomId(reader.readString());
+    task->setWorldId(reader.readString());
+    uint8_t status = reader.readU8();
+    if (status > static_cast<uint8_t>(TaskStatus::CANCELLED)) reader.fail();
+    task->setStatus(static_cast<TaskStatus>(status));
+    for (const auto& tag : reader.readStrings()) task->addTag(tag);
+    task->setOptions(TaskOptions{reader.readStringMap()});
+    task->setCreatedAt(reader.readTimestamp());
+    task->setUpdatedAt(reader.readTimestamp());
+    if (reader.readBool()) task->setScheduledTime(reader.readTimestamp());
+    task->setPriority(static_cast<int>(reader.readSigned()));
+    return task;
+}
+
+// StateSnapshot implementation
+std::unique_lock<std::mutex> StateSnapshot::fenceSnapshot() const {
+    return guard_ ? std::unique_lock<std::mutex>(*guard_) : std::unique_lock<std::mutex>();
+}
+
+SnapshotImage StateSnapshot::freezeSnapshot() const {
+    // Versions are immutable, so holding one is the whole freeze
+    return [state = state_.snapshot()](SnapshotWriter& writer) {
+        const AgentConfig& config = state->config;
+        writer.writeString(config.agentId);
+        writer.writeString(config.agentName);
+        writer.writeString(config.bio);
+        writer.writeString(config.lore);
+        writer.writeString(config.adjective);
+
+        writer.writeVarint(state->actors.size());
+        for (const auto& actor : state->actors) {
+            writer.writeString(actor.id);
+            writer.writeString(actor.name);
+            writer.writeString(actor.details);
+        }
+        writer.writeVarint(state->goals.size());
+        for (const auto& goal : state->goals) {
+            writer.writeString(goal.id);
+            writer.writeString(goal.description);
+            writer.writeString(goal.status);
+            writer.writeTimestamp(goal.createdAt);
+            writer.writeTimestamp(goal.updatedAt);
+        }
+        writer.writeVarint(state->recentMessages.size());
+        for (const auto& message : state->recentMessages) writeMemory(writer, *message);
+    };
+}
+
+SnapshotCommit StateSnapshot::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    (void)version;
+    StateVersion restored;
+    AgentConfig& config = restored.config;
+    config.agentId = reader.readString();
+    config.agentName = reader.readString();
+    config.bio = reader.readString();
+    config.lore = reader.readString();
+    config.adjective = reader.readString();
+
+    size_t actors = reader.readCount(3);
+    for (size_t i = 0; i < actors && reader.ok(); ++i) {
+        Actor actor;
+        actor.id = reader.readString();
+        actor.name = reader.readString();
+        actor.details = reader.readString();
+        restored.actors = restored.actors.pushBack(std::move(actor));
+    }
+    size_t goals = reader.readCount(5);
+    for (size_t i = 0; i < goals && reader.ok(); ++i) {
+        Goal goal;
+        goal.id = reader.readString();
+        goal.description = reader.readString();
+        goal.status = reader.readString();
+        goal.createdAt = reader.readTimestamp();
+        goal.updatedAt = reader.readTimestamp();
+        restored.goals = restored.goals.pushBack(std::move(goal));
+    }
+    size_t messages = reader.readCount();
+    for (size_t i = 0; i < messages && reader.ok(); ++i) {
+        restored.recentMessages = restored.recentMessages.pushBack(readMemory(reader));
+    }
+    if (!reader.ok()) return {};
+
+    return [this, restored = std::move(restored)]() mutable {
+        auto fence = fenceSnapshot();
+        state_.update([&](StateVersion& next) { next = std::move(restored); });
+    };
+}
+
+// TaskManager snapshot support
+std::unique_lock<std::mutex> TaskManager::fenceSnapshot() const {
+    return std::unique_lock<std::mutex>(tasksMutex_);
+}
+
+SnapshotImage TaskManager::freezeSnapshot() const {
+    // Tasks are updated in place, so they are copied rather than shared
+    std::vector<Task> tasks;
+    tasks.reserve(tasks_.size());
+    for (const auto& entry : tasks_) tasks.push_back(*entry.second);
+
+    return [tasks = std::move(tasks)](SnapshotWriter& writer) {
+        writer.writeVarint(tasks.size());
+        for (const auto& task : tasks) writeTask(writer, task);
+    };
+}
+
+SnapshotCommit TaskManager::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    (void)version;
+    std::unordered_map<UUID, std::shared_ptr<Task>> tasks;
+    size_t count = reader.readCount(12);
+    tasks.reserve(count);
+    for (size_t i = 0; i < count && reader.ok(); ++i) {
+        auto task = readTask(reader);
+        tasks[task->getId()] = std::move(task);
+    }
+    if (!reader.ok()) return {};
+
+    return [this, tasks = std::move(tasks)]() mutable {
+        std::lock_guard<std::mutex> lock(tasksMutex_);
+        tasks_ = std::move(tasks);
+    };
+}
+
+// PLNInferenceEngine snapshot support
+std::unique_lock<std::mutex> PLNInferenceEngine::fenceSnapshot() const {
+    return std::unique_lock<std::mutex>(rulesMutex_);
+}
+
+SnapshotImage PLNInferenceEngine::freezeSnapshot() const {
+    std::lock_guard<std::mutex> lock(atomSpaceMutex_);
+    return [rules = rules_, nodes = atomSpaceNodes_, edges = atomSpaceEdges_](SnapshotWriter& writer) {
+        writer.writeVarint(rules.size());
+        for (const auto& rule : rules) {
+            writer.writeString(rule.name);
+            writer.writeString(rule.pattern);
+            writer.writeString(rule.conclusion);
+            writer.writeDouble(rule.truth.strength);
+            writer.writeDouble(rule.truth.confidence);
+            writer.writeDouble(rule.weight);
+        }
+        writer.writeVarint(nodes.size());
+        for (const auto& node : nodes) writeHypergraphNode(writer, *node);
+        writer.writeVarint(edges.size());
+        for (const auto& edge : edges) writeHypergraphEdge(writer, *edge);
+    };
+}
+
+SnapshotCommit PLNInferenceEngine::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    (void)version;
+    std::vector<InferenceRule> rules;
+    size_t ruleCount = reader.readCount(27);
+    rules.reserve(ruleCount);
+    for (size_t i = 0; i < ruleCount && reader.ok(); ++i) {
+        std::string name = reader.readString();
+        std::string pattern = reader.readString();
+        std::string conclusion = reader.readString();
+        double strength = reader.readDouble();
+        double confidence = reader.readDouble();
+        rules.emplace_back(name, pattern, conclusion, TruthValue(strength, confidence), reader.readDouble());
+    }
+    std::vector<std::shared_ptr<HypergraphNode>> nodes(reader.readCount(3));
+    for (auto& node : nodes) node = readHypergraphNode(reader);
+    std::vector<std::shared_ptr<HypergraphEdge>> edges(reader.readCount(11));
+    for (auto& edge : edges) edge = readHypergraphEdge(reader);
+    if (!reader.ok()) return {};
+
+    return [this, rules = std::move(rules), nodes = std::move(nodes), edges = std::move(edges)]() mutable {
+        std::lock_guard<std::mutex> lock(rulesMutex_);
+        std::lock_guard<std::mutex> atomLock(atomSpaceMutex_);
+        rules_ = std::move(rules);
+        atomSpaceNodes_ = std::move(nodes);
+        atomSpaceEdges_ = std::move(edges);
+        atomSpaceIndexed_ = false;
+    };
+}
+
+uint32_t snapshotDigest(const Snapshottable& component) {
+    SnapshotImage image;
+    {
+        auto fence = component.fenceSnapshot();
+        image = component.freezeSnapshot();
+    }
+    SnapshotWriter writer;
+    image(writer);
+    return crc32(writer.data());
+}
+
+// SnapshotFile implementation
+SnapshotFile::~SnapshotFile() {
+#ifndef _WIN32
+    if (mapped_) ::munmap(const_cast<char*>(data_), size_);
+#endif
+}
+
+std::unique_ptr<SnapshotFile> SnapshotFile::open(const std::string& path, std::string* error) {
+    auto fail = [error](const std::string& message) -> std::unique_ptr<SnapshotFile> {
+        if (error) *error = message;
+        return nullptr;
+    };
+
+    std::unique_ptr<SnapshotFile> file(new SnapshotFile());
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return fail("cannot open " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(HEADER_BYTES + FOOTER_BYTES)) {
+        ::close(fd);
+        return fail("not a snapshot: " + path);
+    }
+    void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) return fail("cannot map " + path);
+    file->data_ = static_cast<const char*>(mapping);
+    file->size_ = static_cast<size_t>(info.st_size);
+    file->mapped_ = true;
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return fail("cannot open " + path);
+    file->buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    if (file->buffer_.size() < HEADER_BYTES + FOOTER_BYTES) return fail("not a snapshot: " + path);
+    file->data_ = file->buffer_.data();
+    file->size_ = file->buffer_.size();
+#endif
+
+    const char* data = file->data_;
+    if (std::memcmp(data, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0) return fail("not a snapshot: " + path);
+    auto format = static_cast<uint32_t>(getFixed(data + 8, 4));
+    if (format == 0 || format > SNAPSHOT_FORMAT_VERSION) {
+        return fail("unsupported snapshot format " + std::to_string(format));
+    }
+    auto sectionCount = static_cast<uint32_t>(getFixed(data + 12, 4));
+    file->epoch_ = getFixed(data + 16, 8);
+    file->createdAt_ = fromNanoseconds(static_cast<int64_t>(getFixed(data + 24, 8)));
+
+    const char* footer = data + file->size_ - FOOTER_BYTES;
+    uint64_t tableOffset = getFixed(footer, 8);
+    uint64_t tableLength = getFixed(footer + 8, 8);
+    auto tableChecksum = static_cast<uint32_t>(getFixed(footer + 16, 4));
+    uint64_t tableLimit = file->size_ - FOOTER_BYTES;
+    if (std::memcmp(footer + 20, FOOTER_MAGIC, sizeof(FOOTER_MAGIC)) != 0 || tableOffset < HEADER_BYTES ||
+        tableOffset > tableLimit || tableLength > tableLimit - tableOffset) {
+        return fail("truncated snapshot: " + path);
+    }
+    std::string_view table(data + tableOffset, static_cast<size_t>(tableLength));
+    if (crc32(table) != tableChecksum) return fail("corrupt snapshot section table: " + path);
+
+    SnapshotReader reader(table);
+    for (uint32_t i = 0; i < sectionCount && reader.ok(); ++i) {
+        Section section;
+        section.name = reader.readString();
+        section.version = static_cast<uint32_t>(reader.readVarint());
+        section.offset = reader.readVarint();
+        section.length = reader.readVarint();
+        section.checksum = static_cast<uint32_t>(reader.readVarint());
+        if (section.offset < HEADER_BYTES || section.offset > tableOffset ||
+            section.length > tableOffset - section.offset) {
+            reader.fail();
+        }
+        file->sections_.push_back(std::move(section));
+    }
+    if (!reader.ok()) return fail("corrupt snapshot section table: " + path);
+    return file;
+}
+
+const SnapshotFile::Section* SnapshotFile::findSection(std::string_view name) const {
+    for (const auto& section : sections_) {
+        if (section.name == name) return &section;
+    }
+    return nullptr;
+}
+
+std::optional<std::string_view> SnapshotFile::readSection(const Section& section) const {
+    std::string_view payload(data_ + section.offset, static_cast<size_t>(section.length));
+    if (crc32(payload) != section.checksum) return std::nullopt;
+    return payload;
+}
+
+// SnapshotManager implementation
+void SnapshotManager::registerComponent(std::shared_ptr<Snapshottable> component) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string name = component->getSnapshotName();
+    for (auto& existing : components_) {
+        if (existing->getSnapshotName() == name) {
+            existing = std::move(component);
+            return;
+        }
+    }
+    components_.push_back(std::move(component));
+}
+
+void SnapshotManager::registerComponent(Snapshottable& component) {
+    registerComponent(std::shared_ptr<Snapshottable>(std::shared_ptr<Snapshottable>(), &component));
+}
+
+bool SnapshotManager::unregisterComponent(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(components_.begin(), components_.end(),
+                           [&name](const auto& component) { return component->getSnapshotName() == name; });
+    if (it == components_.end()) return false;
+    components_.erase(it);
+    return true;
+}
+
+std::vector<std::string> SnapshotManager::getComponentNames() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> names;
+    for (const auto& component : components_) names.push_back(component->getSnapshotName());
+    return names;
+}
+
+uint64_t SnapshotManager::getEpoch() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return epoch_;
+}
+
+bool SnapshotManager::save(const std::string& path, std::string* error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TraceSpan span("snapshot.save", &snapshotMetrics().saveLatency);
+
+    // Fence everything, freeze, and let the agent continue before encoding
+    std::vector<SnapshotImage> images;
+    images.reserve(components_.size());
+    {
+        auto fenceStart = std::chrono::steady_clock::now();
+        std::vector<std::unique_lock<std::mutex>> fences;
+        fences.reserve(components_.size());
+        for (const auto& component : components_) fences.push_back(component->fenceSnapshot());
+        for (const auto& component : components_) images.push_back(component->freezeSnapshot());
+        fences.clear();
+        snapshotMetrics().fenceLatency.record(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - fenceStart)
+                .count()));
+    }
+
+    std::vector<Future<std::string>> encoded;
+    encoded.reserve(images.size());
+    for (auto& image : images) {
+        encoded.push_back(Executor::global().submit([image = std::move(image)] {
+            SnapshotWriter writer;
+            image(writer);
+            return writer.release();
+        }));
+    }
+
+    uint64_t epoch = epoch_ + 1;
+    std::string header(FILE_MAGIC, sizeof(FILE_MAGIC));
+    putFixed(header, SNAPSHOT_FORMAT_VERSION, 4);
+    putFixed(header, components_.size(), 4);
+    putFixed(header, epoch, 8);
+    putFixed(header, static_cast<uint64_t>(toNanoseconds(std::chrono::system_clock::now())), 8);
+
+    std::string temporary = path + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        for (auto& future : encoded) future.wait();
+        if (error) *error = "cannot write " + temporary;
+        return false;
+    }
+    out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+    uint64_t offset = HEADER_BYTES;
+    SnapshotWriter table;
+    std::string failure;
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        std::string section;
+        try {
+            section = encoded[i].get();
+        } catch (const std::exception& e) {
+            if (failure.empty()) failure = components_[i]->getSnapshotName() + ": " + e.what();
+            continue;
+        }
+        if (!failure.empty()) continue;
+
+        size_t padding = (SECTION_ALIGNMENT - offset % SECTION_ALIGNMENT) % SECTION_ALIGNMENT;
+        out.write("\0\0\0\0\0\0\0", static_cast<std::streamsize>(padding));
+        offset += padding;
+        out.write(section.data(), static_cast<std::streamsize>(section.size()));
+
+        table.writeString(components_[i]->getSnapshotName());
+        table.writeVarint(components_[i]->getSnapshotVersion());
+        table.writeVarint(offset);
+        table.writeVarint(section.size());
+        table.writeVarint(crc32(section));
+        offset += section.size();
+    }
+
+    std::string footer;
+    putFixed(footer, offset, 8);
+    putFixed(footer, table.size(), 8);
+    putFixed(footer, crc32(table.data()), 4);
+    footer.append(FOOTER_MAGIC, sizeof(FOOTER_MAGIC));
+    out.write(table.data().data(), static_cast<std::streamsize>(table.size()));
+    out.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+    out.close();
+
+    if (!failure.empty() || !out || !syncPath(temporary)) {
+        std::remove(temporary.c_str());
+        if (error) *error = failure.empty() ? "cannot write " + temporary : "snapshot of " + failure;
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        if (error) *error = "cannot replace " + path;
+        return false;
+    }
+    epoch_ = epoch;
+    snapshotMetrics().lastSizeBytes.set(static_cast<int64_t>(offset + table.size() + FOOTER_BYTES));
+
+    // The rename is only durable once the directory entry is
+    std::string directory = std::filesystem::path(path).parent_path().string();
+    if (!syncPath(directory.empty() ? "." : directory)) {
+        if (error) *error = "cannot sync the directory of " + path;
+        return false;
+    }
+    return true;
+}
+
+bool SnapshotManager::restore(const std::string& path, std::string* error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TraceSpan span("snapshot.restore", &snapshotMetrics().restoreLatency);
+
+    auto file = SnapshotFile::open(path, error);
+    if (!file) return false;
+
+    struct Planned {
+        Snapshottable* component;
+        const SnapshotFile::Section* section;
+    };
+    std::vector<Planned> plan;
+    for (const auto& component : components_) {
+        const auto* section = file->findSection(component->getSnapshotName());
+        if (!section) continue;
+        if (section->version > component->getSnapshotVersion()) {
+            if (error) *error = "section " + section->name + " has newer version " + std::to_string(section->version);
+            return false;
+        }
+        plan.push_back({component.get(), section});
+    }
+
+    // Verify and decode every section before touching any component
+    struct Decoded {
+        bool verified = false;
+        SnapshotCommit commit;
+    };
+    std::vector<Future<Decoded>> decoded;
+    decoded.reserve(plan.size());
+    for (const auto& planned : plan) {
+        decoded.push_back(Executor::global().submit([&file, planned] {
+            Decoded result;
+            auto payload = file->readSection(*planned.section);
+            if (!payload) return result;
+            result.verified = true;
+            SnapshotReader reader(*payload);
+            result.commit = planned.component->decodeSnapshot(reader, planned.section->version);
+            return result;
+        }));
+    }
+    std::vector<SnapshotCommit> commits;
+    commits.reserve(plan.size());
+    std::string failure;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        Decoded result;
+        try {
+            result = decoded[i].get();
+            if (!result.verified && failure.empty()) failure = "checksum mismatch in section " + plan[i].section->name;
+        } catch (const std::exception&) {
+            result.verified = true;
+        }
+        if (result.verified && !result.commit && failure.empty()) {
+            failure = "malformed section " + plan[i].section->name;
+        }
+        commits.push_back(std::move(result.commit));
+    }
+    if (!failure.empty()) {
+        if (error) *error = failure;
+        return false;
+    }
+
+    for (auto& commit : commits) commit();
+    epoch_ = file->getEpoch();
+    return true;
+}
+
+} // namespace elizaos
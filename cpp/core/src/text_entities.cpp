@@ -0,0 +1,562 @@
+#include "elizaos/text_entities.hpp"
+#include <algorithm>
+#include <array>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace elizaos {
+
+namespace {
+
+constexpr size_t MAX_SCHEME_LENGTH = 5;
+constexpr size_t MAX_EMAIL_LOCAL_PART = 64;
+constexpr size_t MAX_DOMAIN_LABEL = 63;
+constexpr size_t MAX_MENTION = 64;
+constexpr size_t MAX_HASHTAG = 140;
+constexpr size_t MIN_PHONE_DIGITS = 10;
+constexpr size_t MIN_INTERNATIONAL_PHONE_DIGITS = 8;
+constexpr size_t MAX_PHONE_DIGITS = 15;          // E.164
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+bool isAlpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+bool isAlnum(char c) { return isDigit(c) || isAlpha(c); }
+bool isHex(char c) { return isDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+char toLower(char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; }
+
+// Letters, digits, underscore and any byte of a multi-byte UTF-8 sequence
+bool isWordByte(char c) {
+    return isAlnum(c) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+}
+
+bool isEmailLocalChar(char c) {
+    return isAlnum(c) || c == '.' || c == '_' || c == '%' || c == '+' || c == '-';
+}
+
+bool isBase58(char c) {
+    return isAlnum(c) && c != '0' && c != 'O' && c != 'I' && c != 'l';
+}
+
+bool isBech32(char c) {
+    // qpzry9x8gf2tvdw0s3jn54khce6mua7l; everything alphanumeric but 1, b, i and o
+    char lower = toLower(c);
+    return isAlnum(c) && lower != '1' && lower != 'b' && lower != 'i' && lower != 'o';
+}
+
+bool isUrlTerminator(char c) {
+    return static_cast<unsigned char>(c) <= ' ' || c == '<' || c == '>' || c == '"' || c == 0x7F;
+}
+
+bool equalsIgnoreCase(std::string_view text, std::string_view lowercase) {
+    if (text.size() != lowercase.size()) return false;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (toLower(text[i]) != lowercase[i]) return false;
+    }
+    return true;
+}
+
+bool isUrlScheme(std::string_view scheme) {
+    for (std::string_view known : {"http", "https", "ftp", "ws", "wss"}) {
+        if (equalsIgnoreCase(scheme, known)) return true;
+    }
+    return false;
+}
+
+// Characters that can begin an entity of the requested types
+struct TriggerSet {
+    std::array<char, 6> specials;       // Unused slots repeat an earlier entry
+    bool digits = false;
+};
+
+TriggerSet triggersFor(uint32_t types) {
+    char chosen[6];
+    size_t count = 0;
+    auto add = [&](char c) {
+        for (size_t i = 0; i < count; ++i) {
+            if (chosen[i] == c) return;
+        }
+        chosen[count++] = c;
+    };
+    if (types & textEntityBit(TextEntityType::URL)) {
+        add(':');
+        add('.');
+    }
+    if (types & (textEntityBit(TextEntityType::EMAIL) | textEntityBit(TextEntityType::MENTION))) add('@');
+    if (types & textEntityBit(TextEntityType::HASHTAG)) add('#');
+    if (types & textEntityBit(TextEntityType::PHONE)) {
+        add('+');
+        add('(');
+    }
+
+    TriggerSet triggers;
+    for (size_t i = 0; i < triggers.specials.size(); ++i) {
+        triggers.specials[i] = count == 0 ? '\0' : chosen[i < count ? i : 0];
+    }
+    triggers.digits = types & (textEntityBit(TextEntityType::PHONE) | textEntityBit(TextEntityType::CRYPTO_ADDRESS));
+    return triggers;
+}
+
+class EntityScanner {
+public:
+    EntityScanner(std::string_view text, std::vector<TextEntity>& out, uint32_t types)
+        : text_(text), out_(out), types_(types) {}
+
+    void run() {
+        if (types_ == 0) return;
+        TriggerSet triggers = triggersFor(types_);
+        size_t i = 0;
+        const size_t n = text_.size();
+
+#if defined(__SSE2__)
+        const __m128i s0 = _mm_set1_epi8(triggers.specials[0]);
+        const __m128i s1 = _mm_set1_epi8(triggers.specials[1]);
+        const __m128i s2 = _mm_set1_epi8(triggers.specials[2]);
+        const __m128i s3 = _mm_set1_epi8(triggers.specials[3]);
+        const __m128i s4 = _mm_set1_epi8(triggers.specials[4]);
+        const __m128i s5 = _mm_set1_epi8(triggers.specials[5]);
+        // Signed compares: bytes of 0x80 and above are negative, so never digits
+        const __m128i belowZero = _mm_set1_epi8(triggers.digits ? '0' - 1 : 0x7F);
+        const __m128i aboveNine = _mm_set1_epi8('9' + 1);
+        for (; i + 16 <= n; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text_.data() + i));
+            __m128i hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, s0), _mm_cmpeq_epi8(bytes, s1)),
+                                        _mm_or_si128(_mm_cmpeq_epi8(bytes, s2), _mm_cmpeq_epi8(bytes, s3)));
+            hits = _mm_or_si128(hits, _mm_or_si128(_mm_cmpeq_epi8(bytes, s4), _mm_cmpeq_epi8(bytes, s5)));
+            hits = _mm_or_si128(hits, _mm_and_si128(_mm_cmpgt_epi8(bytes, belowZero),
+                                                    _mm_cmplt_epi8(bytes, aboveNine)));
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+            while (mask) {
+                size_t position = i + static_cast<size_t>(__builtin_ctz(mask));
+                mask &= mask - 1;
+                if (position >= consumedUntil_) candidate(position);
+            }
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t s0 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[0]));
+        const uint8x16_t s1 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[1]));
+        const uint8x16_t s2 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[2]));
+        const uint8x16_t s3 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[3]));
+        const uint8x16_t s4 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[4]));
+        const uint8x16_t s5 = vdupq_n_u8(static_cast<uint8_t>(triggers.specials[5]));
+        const uint8x16_t digitSpan = vdupq_n_u8(triggers.digits ? 10 : 0);
+        const uint8x16_t zero = vdupq_n_u8('0');
+        for (; i + 16 <= n; i += 16) {
+            uint8x16_t bytes = vld1q_u8(reinterpret_cast<const uint8_t*>(text_.data() + i));
+            uint8x16_t hits = vorrq_u8(vorrq_u8(vceqq_u8(bytes, s0), vceqq_u8(bytes, s1)),
+                                       vorrq_u8(vceqq_u8(bytes, s2), vceqq_u8(bytes, s3)));
+            hits = vorrq_u8(hits, vorrq_u8(vceqq_u8(bytes, s4), vceqq_u8(bytes, s5)));
+            hits = vorrq_u8(hits, vcltq_u8(vsubq_u8(bytes, zero), digitSpan));
+            // Four bits per byte, since NEON has no movemask
+            uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+            mask &= 0x1111111111111111ULL;
+            while (mask) {
+                size_t position = i + static_cast<size_t>(__builtin_ctzll(mask)) / 4;
+                mask &= mask - 1;
+                if (position >= consumedUntil_) candidate(position);
+            }
+        }
+#endif
+
+        std::array<bool, 256> table{};
+        for (char c : triggers.specials) table[static_cast<unsigned char>(c)] = true;
+        for (char c = '0'; c <= '9'; ++c) table[static_cast<unsigned char>(c)] = triggers.digits;
+        for (; i < n; ++i) {
+            if (table[static_cast<unsigned char>(text_[i])] && i >= consumedUntil_) candidate(i);
+        }
+    }
+
+private:
+    bool wants(TextEntityType type) const { return types_ & textEntityBit(type); }
+
+    bool boundaryBefore(size_t position) const {
+        return position == 0 || !isWordByte(text_[position - 1]);
+    }
+
+    bool boundaryAfter(size_t position) const {
+        return position >= text_.size() || !isWordByte(text_[position]);
+    }
+
+    void emit(TextEntityType type, size_t start, size_t end) {
+        out_.push_back({type, start, end});
+        consumedUntil_ = end;
+    }
+
+    void candidate(size_t position) {
+        char c = text_[position];
+        switch (c) {
+            case ':':
+                tryUrl(position);
+                break;
+            case '.':
+                if (wants(TextEntityType::URL)) tryWww(position);
+                break;
+            case '@':
+                if (!(wants(TextEntityType::EMAIL) && tryEmail(position)) && wants(TextEntityType::MENTION)) {
+                    tryMention(position);
+                }
+                break;
+            case '#':
+                tryHashtag(position);
+                break;
+            case '+':
+            case '(':
+                tryPhone(position);
+                break;
+            default:
+                if (isDigit(c)) {
+                    if (!(wants(TextEntityType::CRYPTO_ADDRESS) && tryCrypto(position)) &&
+                        wants(TextEntityType::PHONE)) {
+                        tryPhone(position);
+                    }
+                }
+                break;
+        }
+    }
+
+    // End of a URL body starting at from, less trailing sentence punctuation
+    // and unbalanced closing parentheses
+    size_t urlEnd(size_t start, size_t from) const {
+        size_t end = from;
+        while (end < text_.size() && !isUrlTerminator(text_[end])) ++end;
+        while (end > from) {
+            char last = text_[end - 1];
+            if (last == '.' || last == ',' || last == ';' || last == ':' || last == '!' || last == '?' ||
+                last == '\'' || last == '*') {
+                --end;
+            } else if (last == ')' || last == ']') {
+                char open = last == ')' ? '(' : '[';
+                int balance = 0;
+                for (size_t i = start; i < end; ++i) {
+                    if (text_[i] == open) ++balance;
+                    if (text_[i] == last) --balance;
+                }
+                if (balance >= 0) break;
+                --end;
+            } else {
+                break;
+            }
+        }
+        return end;
+    }
+
+    void tryUrl(size_t colon) {
+        if (text_.compare(colon, 3, "://") != 0) return;
+        size_t start = colon;
+        while (start > consumedUntil_ && colon - start < MAX_SCHEME_LENGTH && isAlpha(text_[start - 1])) --start;
+        if (start == colon || !boundaryBefore(start)) return;
+        if (!isUrlScheme(text_.substr(start, colon - start))) return;
+
+        size_t host = colon + 3;
+        if (host >= text_.size() || !(isAlnum(text_[host]) || text_[host] == '[')) return;
+        emit(TextEntityType::URL, start, urlEnd(start, host));
+    }
+
+    void tryWww(size_t dot) {
+        if (dot < 3) return;
+        size_t start = dot - 3;
+        if (start < consumedUntil_ || !equalsIgnoreCase(text_.substr(start, 3), "www") || !boundaryBefore(start)) {
+            return;
+        }
+        // At least one more label after www., ending in an alphabetic TLD
+        size_t hostEnd = dot + 1;
+        size_t lastDot = dot;
+        while (hostEnd < text_.size() && (isAlnum(text_[hostEnd]) || text_[hostEnd] == '-' ||
+                                          (text_[hostEnd] == '.' && hostEnd + 1 < text_.size() &&
+                                           isAlnum(text_[hostEnd + 1])))) {
+            if (text_[hostEnd] == '.') lastDot = hostEnd;
+            ++hostEnd;
+        }
+        if (lastDot == dot || hostEnd - lastDot - 1 < 2) return;
+        for (size_t i = lastDot + 1; i < hostEnd; ++i) {
+            if (!isAlpha(text_[i])) return;
+        }
+        emit(TextEntityType::URL, start, urlEnd(start, hostEnd));
+    }
+
+    // Labels of alphanumerics and inner hyphens; returns the end of the last
+    // label when there are at least two and the last is alphabetic
+    size_t domainEnd(size_t from) const {
+        size_t position = from;
+        size_t labels = 0;
+        size_t lastLabel = from;
+        while (true) {
+            size_t label = position;
+            while (position < text_.size() && (isAlnum(text_[position]) || text_[position] == '-') &&
+                   position - label < MAX_DOMAIN_LABEL) {
+                ++position;
+            }
+            if (position == label || text_[label] == '-' || text_[position - 1] == '-') return 0;
+            ++labels;
+            lastLabel = label;
+            if (position + 1 < text_.size() && text_[position] == '.' && isAlnum(text_[position + 1])) {
+                ++position;
+                continue;
+            }
+            break;
+        }
+        if (labels < 2 || position - lastLabel < 2) return 0;
+        for (size_t i = lastLabel; i < position; ++i) {
+            if (!isAlpha(text_[i])) return 0;
+        }
+        return position;
+    }
+
+    bool tryEmail(size_t at) {
+        size_t start = at;
+        while (start > consumedUntil_ && at - start < MAX_EMAIL_LOCAL_PART && isEmailLocalChar(text_[start - 1])) {
+            --start;
+        }
+        if (start == at || text_[start] == '.' || text_[at - 1] == '.') return false;
+        if (start > 0 && (isEmailLocalChar(text_[start - 1]) || isWordByte(text_[start - 1]))) return false;
+
+        size_t end = domainEnd(at + 1);
+        if (end == 0 || !boundaryAfter(end)) return false;
+        emit(TextEntityType::EMAIL, start, end);
+        return true;
+    }
+
+    void tryMention(size_t at) {
+        if (at > 0 && (isWordByte(text_[at - 1]) || text_[at - 1] == '@')) return;
+        size_t end = at + 1;
+        while (end < text_.size() && (isAlnum(text_[end]) || text_[end] == '_' || text_[end] == '-') &&
+               end - at <= MAX_MENTION) {
+            ++end;
+        }
+        while (end > at + 1 && text_[end - 1] == '-') --end;
+        if (end == at + 1 || end - at > MAX_MENTION || !boundaryAfter(end)) return;
+        emit(TextEntityType::MENTION, at, end);
+    }
+
+    void tryHashtag(size_t hash) {
+        if (!wants(TextEntityType::HASHTAG)) return;
+        if (hash > 0) {
+            char previous = text_[hash - 1];
+            // &#39; is a character reference, ## a heading or repeated mark
+            if (isWordByte(previous) || previous == '&' || previous == '#') return;
+        }
+        size_t end = hash + 1;
+        bool letter = false;
+        while (end < text_.size() && isWordByte(text_[end]) && end - hash <= MAX_HASHTAG) {
+            letter = letter || !isDigit(text_[end]);
+            ++end;
+        }
+        if (!letter || end - hash > MAX_HASHTAG) return;
+        emit(TextEntityType::HASHTAG, hash, end);
+    }
+
+    bool tryCrypto(size_t position) {
+        char c = text_[position];
+
+        // bech32 segwit, triggered by the separator digit of bc1 / tb1
+        if (c == '1' && position >= 2 && position - 2 >= consumedUntil_) {
+            size_t start = position - 2;
+            std::string_view prefix = text_.substr(start, 2);
+            if ((equalsIgnoreCase(prefix, "bc") || equalsIgnoreCase(prefix, "tb")) && boundaryBefore(start)) {
+                size_t end = position + 1;
+                bool lower = false;
+                bool upper = false;
+                while (end < text_.size() && isBech32(text_[end])) {
+                    lower = lower || (text_[end] >= 'a' && text_[end] <= 'z');
+                    upper = upper || (text_[end] >= 'A' && text_[end] <= 'Z');
+                    ++end;
+                }
+                size_t dataLength = end - position - 1;
+                if (dataLength >= 8 && dataLength <= 87 && !(lower && upper) && boundaryAfter(end)) {
+                    emit(TextEntityType::CRYPTO_ADDRESS, start, end);
+                    return true;
+                }
+            }
+        }
+        if (!boundaryBefore(position)) return false;
+
+        // Ethereum-style 0x + 160-bit hex
+        if (c == '0' && position + 2 < text_.size() && (text_[position + 1] == 'x' || text_[position + 1] == 'X')) {
+            size_t end = position + 2;
+            while (end < text_.size() && isHex(text_[end])) ++end;
+            if (end - position - 2 == 40 && boundaryAfter(end)) {
+                emit(TextEntityType::CRYPTO_ADDRESS, position, end);
+                return true;
+            }
+            return false;
+        }
+
+        // Legacy base58 P2PKH / P2SH; mixed-case letters tell it from words and numbers
+        if (c == '1' || c == '3') {
+            size_t end = position;
+            bool lower = false;
+            bool upper = false;
+            while (end < text_.size() && isBase58(text_[end]) && end - position <= 35) {
+                lower = lower || (text_[end] >= 'a' && text_[end] <= 'z');
+                upper = upper || (text_[end] >= 'A' && text_[end] <= 'Z');
+                ++end;
+            }
+            size_t length = end - position;
+            if (length >= 26 && length <= 35 && lower && upper && boundaryAfter(end)) {
+                emit(TextEntityType::CRYPTO_ADDRESS, position, end);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void tryPhone(size_t position) {
+        if (position > 0) {
+            char previous = text_[position - 1];
+            if (isWordByte(previous) || previous == '+' || previous == '.' || previous == '-' || previous == '/') {
+                return;
+            }
+        }
+        size_t i = position;
+        bool international = false;
+        if (text_[i] == '+') {
+            international = true;
+            ++i;
+        }
+
+        struct Number {
+            size_t end = 0;
+            size_t digits = 0;
+            size_t groups = 0;
+            size_t longestGroup = 0;
+            bool dotted = false;
+        };
+        Number number;
+        Number lastGroup;                   // Up to the last complete group, for runs that grow too long
+        size_t group = 0;
+        char separator = '\0';              // Groups are split consistently: 555-123-4567
+        bool open = false;
+        bool separated = false;             // Last character was a separator
+        for (; i < text_.size(); ++i) {
+            char c = text_[i];
+            if (isDigit(c)) {
+                if (number.digits == MAX_PHONE_DIGITS) {
+                    // Separators joined several numbers; keep the first ones
+                    if (!separated) return;
+                    number = lastGroup;
+                    break;
+                }
+                ++number.digits;
+                if (group++ == 0) ++number.groups;
+                number.longestGroup = std::max(number.longestGroup, group);
+                separated = false;
+                number.end = i + 1;
+            } else if (c == '(' && !open && (number.digits == 0 || separated)) {
+                open = true;
+                group = 0;
+            } else if (c == ')' && open && group > 0) {
+                open = false;
+                group = 0;
+                separated = true;
+                number.end = i + 1;
+            } else if ((c == ' ' || c == '-' || c == '.') && !separated && number.digits > 0) {
+                // A space after the country code does not set the separator
+                if (!(c == ' ' && international && number.groups == 1 && !open)) {
+                    if (separator && c != separator) break;
+                    separator = c;
+                }
+                number.dotted = number.dotted || c == '.';
+                group = 0;
+                separated = true;
+                if (!open) lastGroup = number;
+            } else if (c == ' ' && separated && text_[i - 1] == ')') {
+                continue;
+            } else {
+                break;
+            }
+        }
+        if (open) number = lastGroup;
+        size_t end = number.end;
+        if (end == 0) return;
+        if (number.digits < (international ? MIN_INTERNATIONAL_PHONE_DIGITS : MIN_PHONE_DIGITS)) return;
+        // Dotted, four groups of at most three digits read as an IP address,
+        // and a long group as a decimal
+        if (number.dotted && (number.longestGroup > 4 || (number.groups == 4 && number.longestGroup <= 3))) return;
+        // A time after a date: 2024-01-15 10:30
+        if (end < text_.size() && (isWordByte(text_[end]) || text_[end] == '@' || text_[end] == ':')) return;
+        emit(TextEntityType::PHONE, position, end);
+    }
+
+    std::string_view text_;
+    std::vector<TextEntity>& out_;
+    uint32_t types_;
+    size_t consumedUntil_ = 0;
+};
+
+} // anonymous namespace
+
+void scanTextEntities(std::string_view text, std::vector<TextEntity>& entities, uint32_t types) {
+    EntityScanner(text, entities, types & ALL_TEXT_ENTITIES).run();
+}
+
+std::vector<TextEntity> scanTextEntities(std::string_view text, uint32_t types) {
+    std::vector<TextEntity> entities;
+    scanTextEntities(text, entities, types);
+    return entities;
+}
+
+std::vector<std::string_view> extractTextEntities(std::string_view text, TextEntityType type) {
+    std::vector<std::string_view> views;
+    for (const auto& entity : scanTextEntities(text, textEntityBit(type))) views.push_back(entity.in(text));
+    return views;
+}
+
+std::string_view urlHost(std::string_view url) {
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string_view::npos || !isUrlScheme(url.substr(0, schemeEnd))) return {};
+
+    size_t start = schemeEnd + 3;
+    size_t end = url.find_first_of("/?#", start);
+    std::string_view authority = url.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+    size_t at = authority.rfind('@');
+    if (at != std::string_view::npos) authority.remove_prefix(at + 1);
+
+    if (!authority.empty() && authority.front() == '[') {
+        size_t close = authority.find(']');
+        return close == std::string_view::npos ? std::string_view() : authority.substr(1, close - 1);
+    }
+    size_t colon = authority.find(':');
+    return authority.substr(0, colon);
+}
+
+bool isHttpUrl(std::string_view url) {
+    size_t schemeEnd = url.find("://");
+    if (schemeEnd == std::string_view::npos) return false;
+    std::string_view scheme = url.substr(0, schemeEnd);
+    if (!equalsIgnoreCase(scheme, "http") && !equalsIgnoreCase(scheme, "https")) return false;
+
+    std::string_view rest = url.substr(schemeEnd + 3);
+    if (rest.size() < 2) return false;
+    char first = rest.front();
+    if (first == '/' || first == '$' || first == '.' || first == '?' || first == '#') return false;
+    for (char c : rest) {
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v') return false;
+    }
+    return true;
+}
+
+const char* textEntityTypeName(TextEntityType type) {
+    switch (type) {
+        case TextEntityType::URL: return "url";
+        case TextEntityType::EMAIL: return "email";
+        case TextEntityType::PHONE: return "phone";
+        case TextEntityType::MENTION: return "mention";
+        case TextEntityType::HASHTAG: return "hashtag";
+        case TextEntityType::CRYPTO_ADDRESS: return "crypto_address";
+    }
+    return "unknown";
+}
+
+const char* textEntityScanKernel() {
+#if defined(__SSE2__)
+    return "sse2";
+#elif defined(__ARM_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace elizaos
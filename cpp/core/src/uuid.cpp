@@ -0,0 +1,226 @@
+#include "elizaos/uuid.hpp"
+#include "elizaos/virtual_clock.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+
+namespace elizaos {
+
+namespace {
+
+constexpr uint64_t VERSION_MASK = 0xF000ULL;
+constexpr uint64_t VARIANT_MASK = 0xC000000000000000ULL;
+constexpr uint64_t VARIANT_RFC4122 = 0x8000000000000000ULL;
+
+// Offsets of the hex digits inside the canonical form, two per byte
+constexpr uint8_t DIGIT_OFFSETS[16] = {0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34};
+
+uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+uint64_t rotl(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+/**
+ * xoshiro256** seeded once per thread from std::random_device
+ */
+class UuidRandom {
+public:
+    UuidRandom() {
+        static std::atomic<uint64_t> threadSalt{0};
+        std::random_device device;
+        uint64_t seed = (static_cast<uint64_t>(device()) << 32) ^ device();
+        seed ^= threadSalt.fetch_add(0x632BE59BD9B4E019ULL, std::memory_order_relaxed);
+        seed ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        for (auto& word : state_) word = splitMix64(seed);
+    }
+
+    explicit UuidRandom(uint64_t seed) {
+        for (auto& word : state_) word = splitMix64(seed);
+    }
+
+    uint64_t next() {
+        uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+    // v7 state: last timestamp issued on this thread and its 12-bit sequence
+    uint64_t lastMillis = 0;
+    uint64_t sequence = 0;
+
+private:
+    uint64_t state_[4];
+};
+
+UuidRandom& threadRandom() {
+    static thread_local UuidRandom random;
+    return random;
+}
+
+// Seed installed by Uuid::seedRandom; each call starts a new generation
+std::atomic<bool> randomSeeded{false};
+std::atomic<uint64_t> seedGeneration{0};
+
+struct SeedState {
+    std::mutex mutex;
+    uint64_t seed = 0;
+    uint64_t nextStream = 0;
+};
+
+SeedState& seedState() {
+    static SeedState state;
+    return state;
+}
+
+/**
+ * This thread's generator for the current seed, or nullptr when unseeded.
+ * Threads take streams in the order they first draw, the first one using
+ * the seed itself, so only the switch to a new seed takes the lock.
+ */
+UuidRandom* seededThreadRandom() {
+    if (!randomSeeded.load(std::memory_order_acquire)) return nullptr;
+
+    struct ThreadSeeded {
+        uint64_t generation = 0;
+        std::optional<UuidRandom> random;
+    };
+    static thread_local ThreadSeeded local;
+    if (local.generation != seedGeneration.load(std::memory_order_acquire)) {
+        SeedState& state = seedState();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (!randomSeeded.load(std::memory_order_relaxed)) return nullptr;
+        local.generation = seedGeneration.load(std::memory_order_relaxed);
+        local.random.emplace(state.seed + state.nextStream++ * 0x9E3779B97F4A7C15ULL);
+    }
+    return &*local.random;
+}
+
+Uuid makeV4(UuidRandom& random) {
+    uint64_t hi = (random.next() & ~VERSION_MASK) | 0x4000ULL;
+    uint64_t lo = (random.next() & ~VARIANT_MASK) | VARIANT_RFC4122;
+    return Uuid(hi, lo);
+}
+
+Uuid makeV7(UuidRandom& random) {
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             VirtualClock::now().time_since_epoch())
+                                             .count());
+
+    // RFC 9562 method 1: a 12-bit counter in rand_a, reseeded each
+    // millisecond with its top bit clear to leave headroom. When it runs out,
+    // or the clock steps back, borrow from the next millisecond.
+    if (now > random.lastMillis) {
+        random.lastMillis = now;
+        random.sequence = random.next() & 0x7FF;
+    } else if (++random.sequence > 0xFFF) {
+        random.lastMillis++;
+        random.sequence = random.next() & 0x7FF;
+    }
+
+    uint64_t hi = ((random.lastMillis & 0xFFFFFFFFFFFFULL) << 16) | 0x7000ULL | random.sequence;
+    uint64_t lo = (random.next() & ~VARIANT_MASK) | VARIANT_RFC4122;
+    return Uuid(hi, lo);
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // anonymous namespace
+
+Uuid Uuid::v4() {
+    if (UuidRandom* seeded = seededThreadRandom()) return makeV4(*seeded);
+    return makeV4(threadRandom());
+}
+
+Uuid Uuid::v7() {
+    if (UuidRandom* seeded = seededThreadRandom()) return makeV7(*seeded);
+    return makeV7(threadRandom());
+}
+
+void Uuid::seedRandom(std::optional<uint64_t> seed) {
+    SeedState& state = seedState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.seed = seed.value_or(0);
+    state.nextStream = 0;
+    seedGeneration.fetch_add(1, std::memory_order_release);
+    randomSeeded.store(seed.has_value(), std::memory_order_release);
+}
+
+bool Uuid::tryParse(std::string_view text, Uuid& out) {
+    if (text.size() != STRING_LENGTH || text[8] != '-' || text[13] != '-' || text[18] != '-' || text[23] != '-') {
+        return false;
+    }
+
+    uint64_t words[2] = {0, 0};
+    for (size_t byte = 0; byte < 16; ++byte) {
+        int high = hexValue(text[DIGIT_OFFSETS[byte]]);
+        int low = hexValue(text[DIGIT_OFFSETS[byte] + 1]);
+        if (high < 0 || low < 0) return false;
+        words[byte / 8] = (words[byte / 8] << 8) | static_cast<uint64_t>(high << 4 | low);
+    }
+    out = Uuid(words[0], words[1]);
+    return true;
+}
+
+std::optional<Uuid> Uuid::parse(std::string_view text) {
+    Uuid uuid;
+    if (!tryParse(text, uuid)) return std::nullopt;
+    return uuid;
+}
+
+void Uuid::toChars(char* out) const {
+    static const char HEX[] = "0123456789abcdef";
+    for (size_t byte = 0; byte < 16; ++byte) {
+        uint64_t word = byte < 8 ? hi_ : lo_;
+        unsigned value = static_cast<unsigned>(word >> (56 - 8 * (byte % 8))) & 0xFF;
+        out[DIGIT_OFFSETS[byte]] = HEX[value >> 4];
+        out[DIGIT_OFFSETS[byte] + 1] = HEX[value & 0xF];
+    }
+    out[8] = out[13] = out[18] = out[23] = '-';
+}
+
+std::string Uuid::toString() const {
+    std::string text(STRING_LENGTH, '\0');
+    toChars(&text[0]);
+    return text;
+}
+
+IdKey::IdKey(std::string_view text) {
+    // Only text that formats back to itself is held as a Uuid, so no two
+    // distinct id strings share a key
+    char canonical[Uuid::STRING_LENGTH];
+    if (Uuid::tryParse(text, uuid_)) {
+        uuid_.toChars(canonical);
+        if (text == std::string_view(canonical, sizeof(canonical))) {
+            isUuid_ = true;
+            return;
+        }
+        uuid_ = Uuid();
+    }
+    text_.assign(text.data(), text.size());
+}
+
+std::ostream& operator<<(std::ostream& os, const Uuid& uuid) {
+    char buffer[Uuid::STRING_LENGTH];
+    uuid.toChars(buffer);
+    return os.write(buffer, Uuid::STRING_LENGTH);
+}
+
+} // namespace elizaos
@@ -0,0 +1,988 @@
+#include "elizaos/content_matcher.hpp"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <functional>
+#include <regex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace elizaos {
+
+namespace {
+
+using CharSet = std::bitset<256>;
+
+constexpr int UNBOUNDED = -1;
+constexpr int MAX_REPEAT_BOUND = 1000;
+constexpr size_t MAX_PROGRAM_STATES = 20000;
+
+// Same definition of a word character as std::regex's \w for char
+constexpr bool isWordByte(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+constexpr unsigned char foldByte(unsigned char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+}
+
+// Adds the other ASCII case of every letter in the set, as std::regex::icase does
+CharSet foldCase(CharSet set) {
+    for (int c = 'a'; c <= 'z'; ++c) {
+        size_t lower = static_cast<size_t>(c);
+        size_t upper = static_cast<size_t>(c - 'a' + 'A');
+        if (set.test(lower) || set.test(upper)) {
+            set.set(lower);
+            set.set(upper);
+        }
+    }
+    return set;
+}
+
+struct UnsupportedPattern : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// ---------------------------------------------------------------------------
+// Regex parsing (ECMAScript subset) into a small syntax tree
+// ---------------------------------------------------------------------------
+
+// Context on either side of a position: the input edge, a non-word or a word byte
+enum Context : uint8_t { EDGE = 0, NON_WORD = 1, WORD = 2 };
+
+enum class AssertKind : uint8_t { BEGIN, END, WORD_BOUNDARY, NOT_WORD_BOUNDARY };
+
+bool assertionHolds(AssertKind kind, Context before, Context after) {
+    switch (kind) {
+        case AssertKind::BEGIN: return before == EDGE;
+        case AssertKind::END: return after == EDGE;
+        case AssertKind::WORD_BOUNDARY: return (before == WORD) != (after == WORD);
+        case AssertKind::NOT_WORD_BOUNDARY: return (before == WORD) == (after == WORD);
+    }
+    return false;
+}
+
+struct Node {
+    enum class Type { CHARS, CONCAT, ALTERNATE, REPEAT, ASSERT, EMPTY };
+
+    Type type = Type::EMPTY;
+    CharSet chars;
+    std::vector<int> children;
+    int min = 0;
+    int max = 0;
+    AssertKind assertion = AssertKind::BEGIN;
+};
+
+class RegexParser {
+public:
+    RegexParser(const std::string& pattern, bool caseInsensitive, std::vector<Node>& nodes)
+        : pattern_(pattern), caseInsensitive_(caseInsensitive), nodes_(nodes) {}
+
+    int parse() {
+        int root = parseAlternation();
+        if (pos_ != pattern_.size()) throw UnsupportedPattern("unbalanced ')'");
+        return root;
+    }
+
+private:
+    const std::string& pattern_;
+    bool caseInsensitive_;
+    std::vector<Node>& nodes_;
+    size_t pos_ = 0;
+
+    bool atEnd() const { return pos_ >= pattern_.size(); }
+    char peek() const { return pattern_[pos_]; }
+
+    int addNode(Node node) {
+        nodes_.push_back(std::move(node));
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    int addChars(const CharSet& chars) {
+        Node node;
+        node.type = Node::Type::CHARS;
+        node.chars = caseInsensitive_ ? foldCase(chars) : chars;
+        return addNode(std::move(node));
+    }
+
+    int parseAlternation() {
+        std::vector<int> branches{parseConcat()};
+        while (!atEnd() && peek() == '|') {
+            ++pos_;
+            branches.push_back(parseConcat());
+        }
+        if (branches.size() == 1) return branches[0];
+        Node node;
+        node.type = Node::Type::ALTERNATE;
+        node.children = std::move(branches);
+        return addNode(std::move(node));
+    }
+
+    int parseConcat() {
+        std::vector<int> items;
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            items.push_back(parseRepeat());
+        }
+        if (items.empty()) return addNode(Node{});
+        if (items.size() == 1) return items[0];
+        Node node;
+        node.type = Node::Type::CONCAT;
+        node.children = std::move(items);
+        return addNode(std::move(node));
+    }
+
+    int parseNumber() {
+        size_t start = pos_;
+        int value = 0;
+        while (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) {
+            value = value * 10 + (peek() - '0');
+            if (value > MAX_REPEAT_BOUND) throw UnsupportedPattern("repeat bound too large");
+            ++pos_;
+        }
+        if (pos_ == start) throw UnsupportedPattern("malformed repeat");
+        return value;
+    }
+
+    int parseRepeat() {
+        int atom = parseAtom();
+        if (atEnd()) return atom;
+
+        int min = 0;
+        int max = 0;
+        char c = peek();
+        if (c == '*') {
+            min = 0; max = UNBOUNDED; ++pos_;
+        } else if (c == '+') {
+            min = 1; max = UNBOUNDED; ++pos_;
+        } else if (c == '?') {
+            min = 0; max = 1; ++pos_;
+        } else if (c == '{') {
+            ++pos_;
+            min = parseNumber();
+            max = min;
+            if (!atEnd() && peek() == ',') {
+                ++pos_;
+                max = (!atEnd() && peek() == '}') ? UNBOUNDED : parseNumber();
+            }
+            if (atEnd() || peek() != '}') throw UnsupportedPattern("malformed repeat");
+            ++pos_;
+            if (max != UNBOUNDED && max < min) throw UnsupportedPattern("invalid repeat range");
+        } else {
+            return atom;
+        }
+
+        // Laziness does not change whether a match exists
+        if (!atEnd() && peek() == '?') ++pos_;
+        if (!atEnd() && (peek() == '*' || peek() == '+' || peek() == '?' || peek() == '{')) {
+            throw UnsupportedPattern("nested quantifier");
+        }
+        if (nodes_[atom].type == Node::Type::ASSERT) throw UnsupportedPattern("quantified assertion");
+
+        Node node;
+        node.type = Node::Type::REPEAT;
+        node.children = {atom};
+        node.min = min;
+        node.max = max;
+        return addNode(std::move(node));
+    }
+
+    int parseAtom() {
+        char c = peek();
+        switch (c) {
+            case '(': {
+                ++pos_;
+                if (!atEnd() && peek() == '?') {
+                    if (pos_ + 1 < pattern_.size() && pattern_[pos_ + 1] == ':') {
+                        pos_ += 2;
+                    } else {
+                        throw UnsupportedPattern("lookaround");
+                    }
+                }
+                int inner = parseAlternation();
+                if (atEnd() || peek() != ')') throw UnsupportedPattern("unbalanced '('");
+                ++pos_;
+                return inner;
+            }
+            case '[':
+                ++pos_;
+                return addChars(parseClass());
+            case '.': {
+                ++pos_;
+                CharSet any;
+                any.set();
+                any.reset('\n');
+                any.reset('\r');
+                return addChars(any);
+            }
+            case '^':
+            case '$': {
+                ++pos_;
+                Node node;
+                node.type = Node::Type::ASSERT;
+                node.assertion = c == '^' ? AssertKind::BEGIN : AssertKind::END;
+                return addNode(std::move(node));
+            }
+            case '\\': {
+                ++pos_;
+                if (atEnd()) throw UnsupportedPattern("trailing backslash");
+                char e = peek();
+                if (e == 'b' || e == 'B') {
+                    ++pos_;
+                    Node node;
+                    node.type = Node::Type::ASSERT;
+                    node.assertion = e == 'b' ? AssertKind::WORD_BOUNDARY : AssertKind::NOT_WORD_BOUNDARY;
+                    return addNode(std::move(node));
+                }
+                return addChars(parseEscape(false));
+            }
+            case '*':
+            case '+':
+            case '?':
+            case '{':
+                throw UnsupportedPattern("quantifier without operand");
+            default: {
+                ++pos_;
+                CharSet single;
+                single.set(static_cast<unsigned char>(c));
+                return addChars(single);
+            }
+        }
+    }
+
+    int parseHex(size_t digits) {
+        if (pos_ + digits > pattern_.size()) throw UnsupportedPattern("malformed hex escape");
+        int value = 0;
+        for (size_t i = 0; i < digits; ++i) {
+            char h = pattern_[pos_++];
+            if (!std::isxdigit(static_cast<unsigned char>(h))) throw UnsupportedPattern("malformed hex escape");
+            value = value * 16 + (std::isdigit(static_cast<unsigned char>(h)) ? h - '0' : (std::tolower(h) - 'a' + 10));
+        }
+        return value;
+    }
+
+    // Parses the escape after a backslash; pos_ points at the escaped character
+    CharSet parseEscape(bool inClass) {
+        char e = pattern_[pos_++];
+        CharSet set;
+        auto range = [&set](int from, int to) {
+            for (int b = from; b <= to; ++b) set.set(static_cast<size_t>(b));
+        };
+        switch (e) {
+            case 'd': range('0', '9'); return set;
+            case 'D': range('0', '9'); return ~set;
+            case 'w': range('a', 'z'); range('A', 'Z'); range('0', '9'); set.set('_'); return set;
+            case 'W': range('a', 'z'); range('A', 'Z'); range('0', '9'); set.set('_'); return ~set;
+            case 's': for (char s : std::string(" \t\n\v\f\r")) set.set(static_cast<unsigned char>(s)); return set;
+            case 'S': for (char s : std::string(" \t\n\v\f\r")) set.set(static_cast<unsigned char>(s)); return ~set;
+            case 'n': set.set('\n'); return set;
+            case 't': set.set('\t'); return set;
+            case 'r': set.set('\r'); return set;
+            case 'f': set.set('\f'); return set;
+            case 'v': set.set('\v'); return set;
+            case 'b':
+                if (!inClass) break;
+                set.set('\b');
+                return set;
+            case '0':
+                if (!atEnd() && std::isdigit(static_cast<unsigned char>(peek()))) break;
+                set.set(0);
+                return set;
+            case 'x':
+                set.set(static_cast<size_t>(parseHex(2)));
+                return set;
+            case 'u': {
+                int value = parseHex(4);
+                if (value > 0xFF) break;
+                set.set(static_cast<size_t>(value));
+                return set;
+            }
+            case 'c':
+                if (atEnd() || !std::isalpha(static_cast<unsigned char>(peek()))) break;
+                set.set(static_cast<size_t>(pattern_[pos_++] % 32));
+                return set;
+            default:
+                // Backreferences, \k, \p and friends are not regular
+                if (std::isalnum(static_cast<unsigned char>(e))) break;
+                set.set(static_cast<unsigned char>(e));
+                return set;
+        }
+        throw UnsupportedPattern(std::string("unsupported escape \\") + e);
+    }
+
+    CharSet parseClass() {
+        bool negate = false;
+        if (!atEnd() && peek() == '^') {
+            negate = true;
+            ++pos_;
+        }
+        if (!atEnd() && peek() == ']') throw UnsupportedPattern("empty class");
+
+        CharSet set;
+        // Returns the single byte for plain members, or -1 for class escapes like \d
+        auto parseMember = [this](CharSet& member) -> int {
+            if (atEnd()) throw UnsupportedPattern("unterminated class");
+            char c = pattern_[pos_++];
+            if (c == '\\') {
+                if (atEnd()) throw UnsupportedPattern("unterminated class");
+                member = parseEscape(true);
+                if (member.count() != 1) return -1;
+                for (int b = 0; b < 256; ++b) {
+                    if (member.test(static_cast<size_t>(b))) return b;
+                }
+                return -1;
+            }
+            if (c == '[' && !atEnd() && (peek() == ':' || peek() == '=' || peek() == '.')) {
+                throw UnsupportedPattern("POSIX class");
+            }
+            member.reset();
+            member.set(static_cast<unsigned char>(c));
+            return static_cast<unsigned char>(c);
+        };
+
+        while (true) {
+            if (atEnd()) throw UnsupportedPattern("unterminated class");
+            if (peek() == ']') {
+                ++pos_;
+                break;
+            }
+            CharSet member;
+            int low = parseMember(member);
+            if (pos_ + 1 < pattern_.size() && peek() == '-' && pattern_[pos_ + 1] != ']') {
+                ++pos_;
+                CharSet upperMember;
+                int high = parseMember(upperMember);
+                if (low < 0 || high < 0 || high < low) throw UnsupportedPattern("invalid class range");
+                for (int b = low; b <= high; ++b) set.set(static_cast<size_t>(b));
+            } else {
+                set |= member;
+            }
+        }
+        // Folded before negating, so [^a] excludes 'A' too
+        if (caseInsensitive_) set = foldCase(set);
+        return negate ? ~set : set;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Thompson construction
+// ---------------------------------------------------------------------------
+
+struct NfaState {
+    enum class Kind : uint8_t { CHARS, SPLIT, ASSERT, MATCH };
+
+    Kind kind = Kind::SPLIT;
+    AssertKind assertion = AssertKind::BEGIN;
+    int out = -1;
+    int out2 = -1;
+    int chars = -1;     // Index into Program::sets
+    uint32_t index = 0; // Dense regex index for MATCH states
+};
+
+struct Program {
+    std::vector<NfaState> states;
+    std::vector<CharSet> sets;
+    int start = -1;
+};
+
+class ProgramCompiler {
+public:
+    ProgramCompiler(const std::vector<Node>& nodes, Program& program) : nodes_(nodes), program_(program) {}
+
+    // Compiles backwards: every fragment is built with its continuation already known
+    int compile(int nodeIndex, int next) {
+        if (program_.states.size() > MAX_PROGRAM_STATES) throw UnsupportedPattern("pattern too large");
+
+        const Node& node = nodes_[nodeIndex];
+        switch (node.type) {
+            case Node::Type::EMPTY:
+                return next;
+            case Node::Type::CHARS: {
+                NfaState state;
+                state.kind = NfaState::Kind::CHARS;
+                state.chars = internSet(node.chars);
+                state.out = next;
+                return addState(state);
+            }
+            case Node::Type::ASSERT: {
+                NfaState state;
+                state.kind = NfaState::Kind::ASSERT;
+                state.assertion = node.assertion;
+                state.out = next;
+                return addState(state);
+            }
+            case Node::Type::CONCAT:
+                for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                    next = compile(*it, next);
+                }
+                return next;
+            case Node::Type::ALTERNATE: {
+                int start = compile(node.children.back(), next);
+                for (size_t i = node.children.size() - 1; i-- > 0;) {
+                    int branch = compile(node.children[i], next);
+                    NfaState split;
+                    split.out = branch;
+                    split.out2 = start;
+                    start = addState(split);
+                }
+                return start;
+            }
+            case Node::Type::REPEAT: {
+                int child = node.children[0];
+                int tail = next;
+                if (node.max == UNBOUNDED) {
+                    int loop = addState(NfaState{});
+                    program_.states[loop].out2 = next;
+                    int body = compile(child, loop);
+                    program_.states[loop].out = body;
+                    tail = loop;
+                } else {
+                    for (int k = 0; k < node.max - node.min; ++k) {
+                        int split = addState(NfaState{});
+                        int body = compile(child, tail);
+                        program_.states[split].out = body;
+                        program_.states[split].out2 = next;
+                        tail = split;
+                    }
+                }
+                for (int k = 0; k < node.min; ++k) {
+                    tail = compile(child, tail);
+                }
+                return tail;
+            }
+        }
+        return next;
+    }
+
+private:
+    const std::vector<Node>& nodes_;
+    Program& program_;
+    std::unordered_map<CharSet, int> setIndex_;
+
+    int addState(const NfaState& state) {
+        program_.states.push_back(state);
+        return static_cast<int>(program_.states.size() - 1);
+    }
+
+    int internSet(const CharSet& set) {
+        auto it = setIndex_.find(set);
+        if (it != setIndex_.end()) return it->second;
+        program_.sets.push_back(set);
+        int index = static_cast<int>(program_.sets.size() - 1);
+        setIndex_.emplace(set, index);
+        return index;
+    }
+};
+
+Program compileRegex(const std::string& pattern, bool caseInsensitive, uint32_t index) {
+    std::vector<Node> nodes;
+    RegexParser parser(pattern, caseInsensitive, nodes);
+    int root = parser.parse();
+
+    Program program;
+    NfaState match;
+    match.kind = NfaState::Kind::MATCH;
+    match.index = index;
+    program.states.push_back(match);
+    ProgramCompiler compiler(nodes, program);
+    program.start = compiler.compile(root, 0);
+    return program;
+}
+
+// Recognises "(.)\1{n,}" style patterns, which need a backreference but only
+// ever ask whether some byte repeats n+1 times in a row
+bool parseRepeatedCharIdiom(const std::string& pattern, size_t& minRun) {
+    static const std::regex idiom(R"(^\(\.(?:\{1\})?\)\\1(?:(\*|\+)|\{(\d{1,4})(,\d{0,4})?\})\??$)");
+    std::smatch match;
+    if (!std::regex_match(pattern, match, idiom)) return false;
+    if (match[1].matched) {
+        minRun = match[1].str() == "*" ? 1 : 2;
+    } else {
+        minRun = static_cast<size_t>(std::stoul(match[2].str())) + 1;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Subset construction
+// ---------------------------------------------------------------------------
+
+struct Dfa {
+    std::array<uint16_t, 256> byteClass{};
+    size_t classCount = 0;
+    std::vector<uint32_t> transitions;      // state * classCount + class
+    std::vector<uint8_t> acceptMask;        // bit (1 << Context) set when the state accepts before such a byte
+    std::vector<uint32_t> acceptOffsets;    // (state * 3 + context) -> range in acceptPool
+    std::vector<uint32_t> acceptPool;
+    uint32_t start = 0;
+};
+
+struct KernelKey {
+    uint8_t context;
+    std::vector<int> states;
+
+    bool operator==(const KernelKey& other) const {
+        return context == other.context && states == other.states;
+    }
+};
+
+struct KernelKeyHash {
+    size_t operator()(const KernelKey& key) const {
+        size_t hash = key.context;
+        for (int state : key.states) {
+            hash ^= static_cast<size_t>(state) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+        }
+        return hash;
+    }
+};
+
+class DfaBuilder {
+public:
+    explicit DfaBuilder(const std::vector<const Program*>& programs) {
+        // Merge the programs into one NFA; every program start is implicitly
+        // active at every position, which makes the search unanchored
+        for (const Program* program : programs) {
+            int stateBase = static_cast<int>(states_.size());
+            int setBase = static_cast<int>(sets_.size());
+            for (NfaState state : program->states) {
+                if (state.out >= 0) state.out += stateBase;
+                if (state.out2 >= 0) state.out2 += stateBase;
+                if (state.chars >= 0) state.chars += setBase;
+                states_.push_back(state);
+            }
+            sets_.insert(sets_.end(), program->sets.begin(), program->sets.end());
+            starts_.push_back(program->start + stateBase);
+        }
+        mark_.assign(states_.size(), 0);
+    }
+
+    bool build(size_t maxStates, Dfa& dfa) {
+        computeByteClasses(dfa);
+
+        // Closure and moves of the implicit start states only depend on context
+        for (uint8_t before = 0; before < 3; ++before) {
+            for (uint8_t after = 0; after < 3; ++after) {
+                startClosure_[before][after] = closure(starts_, static_cast<Context>(before), static_cast<Context>(after));
+            }
+            startMoves_[before].resize(dfa.classCount);
+            for (size_t cls = 0; cls < dfa.classCount; ++cls) {
+                startMoves_[before][cls] = move(startClosure_[before][classContext_[cls]], cls);
+            }
+        }
+
+        std::unordered_map<KernelKey, uint32_t, KernelKeyHash> ids;
+        std::vector<KernelKey> pending;
+        auto intern = [&](KernelKey key) -> uint32_t {
+            auto it = ids.find(key);
+            if (it != ids.end()) return it->second;
+            uint32_t id = static_cast<uint32_t>(pending.size());
+            ids.emplace(key, id);
+            pending.push_back(std::move(key));
+            return id;
+        };
+
+        dfa.start = intern(KernelKey{EDGE, {}});
+        for (size_t current = 0; current < pending.size(); ++current) {
+            if (pending.size() > maxStates) return false;
+
+            KernelKey key = pending[current];
+            Context before = static_cast<Context>(key.context);
+
+            std::array<std::vector<int>, 3> closures;
+            uint8_t mask = 0;
+            for (uint8_t after = 0; after < 3; ++after) {
+                closures[after] = closure(key.states, before, static_cast<Context>(after));
+                std::vector<uint32_t> accepted;
+                for (const auto* reached : {&closures[after], &startClosure_[before][after]}) {
+                    for (int s : *reached) {
+                        if (states_[s].kind == NfaState::Kind::MATCH) accepted.push_back(states_[s].index);
+                    }
+                }
+                std::sort(accepted.begin(), accepted.end());
+                accepted.erase(std::unique(accepted.begin(), accepted.end()), accepted.end());
+                dfa.acceptOffsets.push_back(static_cast<uint32_t>(dfa.acceptPool.size()));
+                dfa.acceptPool.insert(dfa.acceptPool.end(), accepted.begin(), accepted.end());
+                if (!accepted.empty()) mask |= static_cast<uint8_t>(1u << after);
+            }
+            dfa.acceptMask.push_back(mask);
+
+            for (size_t cls = 0; cls < dfa.classCount; ++cls) {
+                Context after = classContext_[cls];
+                KernelKey next{static_cast<uint8_t>(after), move(closures[after], cls)};
+                const auto& fromStart = startMoves_[before][cls];
+                if (!fromStart.empty()) {
+                    std::vector<int> merged;
+                    merged.reserve(next.states.size() + fromStart.size());
+                    std::set_union(next.states.begin(), next.states.end(), fromStart.begin(), fromStart.end(),
+                                   std::back_inserter(merged));
+                    next.states = std::move(merged);
+                }
+                dfa.transitions.push_back(intern(std::move(next)));
+            }
+        }
+        dfa.acceptOffsets.push_back(static_cast<uint32_t>(dfa.acceptPool.size()));
+        return true;
+    }
+
+private:
+    std::vector<NfaState> states_;
+    std::vector<CharSet> sets_;
+    std::vector<int> starts_;
+    std::vector<uint32_t> mark_;
+    uint32_t epoch_ = 0;
+    std::vector<Context> classContext_;
+    std::vector<std::vector<uint8_t>> classInSet_;   // [set][class]
+    std::array<std::array<std::vector<int>, 3>, 3> startClosure_;
+    std::array<std::vector<std::vector<int>>, 3> startMoves_;
+
+    void computeByteClasses(Dfa& dfa) {
+        // Bytes with identical membership in every set (and identical wordness)
+        // are indistinguishable to the automaton and share a column
+        std::unordered_map<std::string, uint16_t> signatures;
+        std::vector<unsigned char> representative;
+        for (int b = 0; b < 256; ++b) {
+            std::string signature(1, isWordByte(static_cast<unsigned char>(b)) ? 'w' : 'n');
+            signature.reserve(sets_.size() + 1);
+            for (const auto& set : sets_) signature.push_back(set.test(static_cast<size_t>(b)) ? '1' : '0');
+            auto inserted = signatures.emplace(signature, static_cast<uint16_t>(signatures.size()));
+            if (inserted.second) representative.push_back(static_cast<unsigned char>(b));
+            dfa.byteClass[static_cast<size_t>(b)] = inserted.first->second;
+        }
+        dfa.classCount = representative.size();
+
+        classContext_.resize(dfa.classCount);
+        for (size_t cls = 0; cls < dfa.classCount; ++cls) {
+            classContext_[cls] = isWordByte(representative[cls]) ? WORD : NON_WORD;
+        }
+        classInSet_.assign(sets_.size(), std::vector<uint8_t>(dfa.classCount, 0));
+        for (size_t s = 0; s < sets_.size(); ++s) {
+            for (size_t cls = 0; cls < dfa.classCount; ++cls) {
+                classInSet_[s][cls] = sets_[s].test(representative[cls]);
+            }
+        }
+    }
+
+    // Follows epsilon edges and assertions; returns reached CHARS and MATCH states
+    std::vector<int> closure(const std::vector<int>& from, Context before, Context after) {
+        ++epoch_;
+        std::vector<int> stack(from.begin(), from.end());
+        std::vector<int> reached;
+        while (!stack.empty()) {
+            int s = stack.back();
+            stack.pop_back();
+            if (s < 0 || mark_[s] == epoch_) continue;
+            mark_[s] = epoch_;
+            const NfaState& state = states_[s];
+            switch (state.kind) {
+                case NfaState::Kind::CHARS:
+                case NfaState::Kind::MATCH:
+                    reached.push_back(s);
+                    break;
+                case NfaState::Kind::SPLIT:
+                    stack.push_back(state.out2);
+                    stack.push_back(state.out);
+                    break;
+                case NfaState::Kind::ASSERT:
+                    if (assertionHolds(state.assertion, before, after)) stack.push_back(state.out);
+                    break;
+            }
+        }
+        return reached;
+    }
+
+    std::vector<int> move(const std::vector<int>& closed, size_t cls) const {
+        std::vector<int> next;
+        for (int s : closed) {
+            const NfaState& state = states_[s];
+            if (state.kind == NfaState::Kind::CHARS && classInSet_[state.chars][cls]) {
+                next.push_back(state.out);
+            }
+        }
+        std::sort(next.begin(), next.end());
+        next.erase(std::unique(next.begin(), next.end()), next.end());
+        return next;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// Aho-Corasick over case-folded bytes
+// ---------------------------------------------------------------------------
+
+struct LiteralAutomaton {
+    std::array<uint16_t, 256> byteClass{};
+    size_t classCount = 1;
+    std::vector<uint32_t> delta;            // state * classCount + class
+    std::vector<uint32_t> outputOffsets;    // state -> range in outputs
+    std::vector<uint32_t> outputs;          // literal indices
+
+    void build(const std::vector<std::string>& literals) {
+        byteClass.fill(0);
+        classCount = 1;
+        for (const auto& literal : literals) {
+            for (unsigned char c : literal) {
+                unsigned char folded = foldByte(c);
+                if (byteClass[folded] == 0) byteClass[folded] = static_cast<uint16_t>(classCount++);
+            }
+        }
+        for (int b = 'A'; b <= 'Z'; ++b) byteClass[static_cast<size_t>(b)] = byteClass[foldByte(static_cast<unsigned char>(b))];
+
+        // Trie; 0 doubles as "no edge" since the root is never a child
+        std::vector<uint32_t> trie(classCount, 0);
+        std::vector<std::vector<uint32_t>> own(1);
+        for (size_t i = 0; i < literals.size(); ++i) {
+            uint32_t node = 0;
+            for (unsigned char c : literals[i]) {
+                size_t slot = node * classCount + byteClass[c];
+                if (trie[slot] == 0) {
+                    trie[slot] = static_cast<uint32_t>(own.size());
+                    own.emplace_back();
+                    trie.resize(own.size() * classCount, 0);
+                }
+                node = trie[slot];
+            }
+            own[node].push_back(static_cast<uint32_t>(i));
+        }
+
+        // Breadth-first failure links, folded straight into a complete transition table
+        size_t nodeCount = own.size();
+        delta.assign(nodeCount * classCount, 0);
+        std::vector<uint32_t> fail(nodeCount, 0);
+        std::vector<std::vector<uint32_t>> out(nodeCount);
+        std::vector<uint32_t> queue;
+        out[0] = own[0];
+        for (size_t cls = 0; cls < classCount; ++cls) {
+            uint32_t child = trie[cls];
+            delta[cls] = child;
+            if (child != 0) queue.push_back(child);
+        }
+        for (size_t head = 0; head < queue.size(); ++head) {
+            uint32_t node = queue[head];
+            out[node] = own[node];
+            out[node].insert(out[node].end(), out[fail[node]].begin(), out[fail[node]].end());
+            for (size_t cls = 0; cls < classCount; ++cls) {
+                uint32_t child = trie[node * classCount + cls];
+                uint32_t fallback = delta[fail[node] * classCount + cls];
+                if (child != 0) {
+                    fail[child] = fallback;
+                    delta[node * classCount + cls] = child;
+                    queue.push_back(child);
+                } else {
+                    delta[node * classCount + cls] = fallback;
+                }
+            }
+        }
+
+        outputOffsets.clear();
+        outputs.clear();
+        for (const auto& list : out) {
+            outputOffsets.push_back(static_cast<uint32_t>(outputs.size()));
+            outputs.insert(outputs.end(), list.begin(), list.end());
+        }
+        outputOffsets.push_back(static_cast<uint32_t>(outputs.size()));
+    }
+};
+
+} // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// MultiPatternMatcher
+// ---------------------------------------------------------------------------
+
+class MultiPatternMatcher::Impl {
+public:
+    struct CompiledRegex {
+        std::string pattern;
+        bool caseInsensitive;
+        uint32_t index;
+        Program program;
+    };
+
+    // Dense regex index -> caller id
+    std::vector<uint32_t> regexIds;
+    std::vector<CompiledRegex> regexes;
+    std::vector<std::pair<size_t, uint32_t>> runRules;     // (minimum run, dense index)
+    std::vector<std::string> literals;
+    std::vector<uint32_t> literalIds;
+
+    // Built state
+    bool built = false;
+    std::vector<Dfa> dfas;
+    std::vector<std::pair<std::regex, uint32_t>> fallbacks;
+    LiteralAutomaton literalAutomaton;
+
+    void buildGroup(const std::vector<const CompiledRegex*>& group, size_t maxStates) {
+        if (group.empty()) return;
+
+        std::vector<const Program*> programs;
+        for (const auto* regex : group) programs.push_back(&regex->program);
+        Dfa dfa;
+        if (DfaBuilder(programs).build(maxStates, dfa)) {
+            dfas.push_back(std::move(dfa));
+            return;
+        }
+
+        if (group.size() == 1) {
+            // A single pattern whose DFA exceeds the budget is left to std::regex
+            auto flags = std::regex::ECMAScript;
+            if (group[0]->caseInsensitive) flags |= std::regex::icase;
+            fallbacks.emplace_back(std::regex(group[0]->pattern, flags), group[0]->index);
+            return;
+        }
+        size_t half = group.size() / 2;
+        buildGroup({group.begin(), group.begin() + static_cast<std::ptrdiff_t>(half)}, maxStates);
+        buildGroup({group.begin() + static_cast<std::ptrdiff_t>(half), group.end()}, maxStates);
+    }
+};
+
+void MultiPatternMatcher::ScanResult::clear() {
+    regexMatches.clear();
+    literalHits.clear();
+    longestRun = 0;
+}
+
+MultiPatternMatcher::MultiPatternMatcher() : impl_(std::make_unique<Impl>()) {}
+MultiPatternMatcher::~MultiPatternMatcher() = default;
+MultiPatternMatcher::MultiPatternMatcher(MultiPatternMatcher&&) noexcept = default;
+MultiPatternMatcher& MultiPatternMatcher::operator=(MultiPatternMatcher&&) noexcept = default;
+
+bool MultiPatternMatcher::addRegex(const std::string& pattern, uint32_t id, bool caseInsensitive) {
+    uint32_t index = static_cast<uint32_t>(impl_->regexIds.size());
+
+    // Run lengths count identical bytes, which is not what \1 means under icase
+    size_t minRun = 0;
+    if (!caseInsensitive && parseRepeatedCharIdiom(pattern, minRun)) {
+        impl_->regexIds.push_back(id);
+        impl_->runRules.emplace_back(minRun, index);
+        impl_->built = false;
+        return true;
+    }
+
+    try {
+        Program program = compileRegex(pattern, caseInsensitive, index);
+        impl_->regexIds.push_back(id);
+        impl_->regexes.push_back({pattern, caseInsensitive, index, std::move(program)});
+        impl_->built = false;
+        return true;
+    } catch (const UnsupportedPattern&) {
+        return false;
+    }
+}
+
+bool MultiPatternMatcher::isSupportedRegex(const std::string& pattern, bool caseInsensitive) {
+    size_t minRun = 0;
+    if (!caseInsensitive && parseRepeatedCharIdiom(pattern, minRun)) return true;
+    try {
+        compileRegex(pattern, caseInsensitive, 0);
+        return true;
+    } catch (const UnsupportedPattern&) {
+        return false;
+    }
+}
+
+void MultiPatternMatcher::addLiteral(const std::string& literal, uint32_t id) {
+    if (literal.empty()) return;
+    impl_->literals.push_back(literal);
+    impl_->literalIds.push_back(id);
+    impl_->built = false;
+}
+
+void MultiPatternMatcher::build(size_t maxDfaStates) {
+    impl_->dfas.clear();
+    impl_->fallbacks.clear();
+
+    std::vector<const Impl::CompiledRegex*> group;
+    for (const auto& regex : impl_->regexes) group.push_back(&regex);
+    impl_->buildGroup(group, std::max<size_t>(maxDfaStates, 16));
+
+    impl_->literalAutomaton.build(impl_->literals);
+    impl_->built = true;
+}
+
+void MultiPatternMatcher::scan(std::string_view text, ScanResult& result) const {
+    result.clear();
+    if (!impl_->built) throw std::logic_error("MultiPatternMatcher::scan called before build");
+
+    const auto& dfas = impl_->dfas;
+    const auto& literals = impl_->literalAutomaton;
+    std::vector<uint8_t> seen(impl_->regexIds.size(), 0);
+    auto report = [&](uint32_t index) {
+        if (!seen[index]) {
+            seen[index] = 1;
+            result.regexMatches.push_back(impl_->regexIds[index]);
+        }
+    };
+    auto reportAccepts = [&](const Dfa& dfa, uint32_t state, uint8_t context) {
+        size_t slot = static_cast<size_t>(state) * 3 + context;
+        for (uint32_t i = dfa.acceptOffsets[slot]; i < dfa.acceptOffsets[slot + 1]; ++i) {
+            report(dfa.acceptPool[i]);
+        }
+    };
+
+    std::vector<uint32_t> dfaStates(dfas.size());
+    for (size_t g = 0; g < dfas.size(); ++g) dfaStates[g] = dfas[g].start;
+    uint32_t literalState = 0;
+    size_t run = 0;
+    unsigned char previous = 0;
+
+    const bool hasLiterals = !impl_->literals.empty();
+    for (size_t i = 0; i < text.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        uint8_t context = isWordByte(c) ? WORD : NON_WORD;
+
+        for (size_t g = 0; g < dfas.size(); ++g) {
+            const Dfa& dfa = dfas[g];
+            uint32_t state = dfaStates[g];
+            if (dfa.acceptMask[state] & (1u << context)) reportAccepts(dfa, state, context);
+            dfaStates[g] = dfa.transitions[static_cast<size_t>(state) * dfa.classCount + dfa.byteClass[c]];
+        }
+
+        if (hasLiterals) {
+            literalState = literals.delta[static_cast<size_t>(literalState) * literals.classCount + literals.byteClass[c]];
+            for (uint32_t o = literals.outputOffsets[literalState]; o < literals.outputOffsets[literalState + 1]; ++o) {
+                uint32_t literal = literals.outputs[o];
+                size_t length = impl_->literals[literal].size();
+                result.literalHits.push_back({impl_->literalIds[literal], i + 1 - length, length});
+            }
+        }
+
+        // '.' never matches line terminators, so they break runs
+        if (c == '\n' || c == '\r') {
+            run = 0;
+        } else {
+            run = (i > 0 && c == previous) ? run + 1 : 1;
+            result.longestRun = std::max(result.longestRun, run);
+        }
+        previous = c;
+    }
+
+    for (size_t g = 0; g < dfas.size(); ++g) {
+        if (dfas[g].acceptMask[dfaStates[g]] & (1u << EDGE)) reportAccepts(dfas[g], dfaStates[g], EDGE);
+    }
+    for (const auto& rule : impl_->runRules) {
+        if (result.longestRun >= rule.first) report(rule.second);
+    }
+    for (const auto& fallback : impl_->fallbacks) {
+        if (!seen[fallback.second] && std::regex_search(text.begin(), text.end(), fallback.first)) {
+            report(fallback.second);
+        }
+    }
+}
+
+MultiPatternMatcher::ScanResult MultiPatternMatcher::scan(std::string_view text) const {
+    ScanResult result;
+    scan(text, result);
+    return result;
+}
+
+size_t MultiPatternMatcher::getRegexCount() const { return impl_->regexIds.size(); }
+size_t MultiPatternMatcher::getLiteralCount() const { return impl_->literals.size(); }
+size_t MultiPatternMatcher::getDfaCount() const { return impl_->dfas.size(); }
+
+size_t MultiPatternMatcher::getDfaStateCount() const {
+    size_t total = 0;
+    for (const auto& dfa : impl_->dfas) total += dfa.acceptMask.size();
+    return total;
+}
+
+size_t MultiPatternMatcher::getFallbackCount() const { return impl_->fallbacks.size(); }
+
+} // namespace elizaos
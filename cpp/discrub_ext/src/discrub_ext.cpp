@@ -1,20 +1,176 @@
 #include "elizaos/discrub_ext.hpp"
 #include "elizaos/agentlogger.hpp"
+#include "elizaos/content_matcher.hpp"
 #include <algorithm>
 #include <sstream>
 #include <fstream>
 #include <random>
 #include <chrono>
 #include <cmath>
+#include <numeric>
+#include <thread>
 
 namespace elizaos {
 
 // Global extension instance
 std::shared_ptr<DiscrubExtension> globalDiscrubExtension = std::make_shared<DiscrubExtension>();
 
+namespace {
+
+// Literal ids in the scanner's combined automaton
+enum BuiltInLiteral : uint32_t {
+    LITERAL_PROFANITY,
+    LITERAL_PHISHING_PHRASE,
+    LITERAL_BLOCKED_DOMAIN,
+    LITERAL_URL_SCHEME,
+    LITERAL_INVITE,
+    LITERAL_USER_MENTION,
+    LITERAL_BROADCAST_MENTION
+};
+
+// Constant-initialised: the global extension below is built during static initialisation
+constexpr const char* SUSPICIOUS_PHRASES[] = {
+    "click here to claim",
+    "free nitro",
+    "discord gift",
+    "steam gift",
+    "limited time",
+    "verify your account"
+};
+
+bool isUrlTerminator(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool isWordCharacter(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+// Syntax options the combined matcher reproduces; filters using any other are left to std::regex
+bool matcherSupportsFlags(std::regex::flag_type flags) {
+    const auto supported = std::regex::ECMAScript | std::regex::icase | std::regex::nosubs | std::regex::optimize;
+    return (flags & ~supported) == std::regex::flag_type{};
+}
+
+// Everything the built-in detectors need, gathered from one matcher pass
+struct ContentAnalysis {
+    std::vector<bool> filterMatched;
+    bool profanity = false;
+    bool suspiciousPhrase = false;
+    bool blockedDomainInUrl = false;
+    bool invite = false;
+    std::vector<std::pair<size_t, size_t>> urls;    // [start, end) offsets
+    int mentions = 0;
+    size_t longestRun = 0;
+};
+
+} // anonymous namespace
+
+struct ContentScanner::CompiledRules {
+    uint64_t generation = 0;
+    std::vector<ContentFilter> filters;         // Enabled filters, in evaluation order
+    std::vector<size_t> fallbackFilters;        // Indices into filters not handled by the matcher
+    MultiPatternMatcher matcher;
+    MultiPatternMatcher literals;               // Built-in literals alone, for the single-purpose helpers
+    bool profanityEnabled = false;
+    bool phishingEnabled = false;
+    bool inviteEnabled = false;
+    bool spamEnabled = false;
+    bool mentionSpamEnabled = false;
+    int maxMentions = 0;
+
+    ContentAnalysis analyze(const std::string& content) const {
+        ContentAnalysis analysis;
+        analysis.filterMatched.assign(filters.size(), false);
+
+        MultiPatternMatcher::ScanResult scan = matcher.scan(content);
+        for (uint32_t index : scan.regexMatches) analysis.filterMatched[index] = true;
+        analysis.longestRun = scan.longestRun;
+
+        for (size_t index : fallbackFilters) {
+            try {
+                analysis.filterMatched[index] = std::regex_search(content, filters[index].getPattern());
+            } catch (const std::regex_error& e) {
+                logError("Regex error in filter " + filters[index].name + ": " + e.what(), "discrub_ext");
+            }
+        }
+
+        readLiterals(content, scan.literalHits, analysis);
+        return analysis;
+    }
+
+    // Skips the filter DFAs and fallback regexes, which only scan() needs
+    ContentAnalysis analyzeLiterals(const std::string& content) const {
+        ContentAnalysis analysis;
+        readLiterals(content, literals.scan(content).literalHits, analysis);
+        return analysis;
+    }
+
+    static void readLiterals(const std::string& content, const std::vector<MultiPatternMatcher::LiteralHit>& hits,
+                             ContentAnalysis& analysis) {
+        // URLs first, so domain hits can be checked for containment
+        for (const auto& hit : hits) {
+            if (hit.id != LITERAL_URL_SCHEME) continue;
+            if (!analysis.urls.empty() && hit.start < analysis.urls.back().second) continue;
+            size_t end = hit.start + hit.length;
+            while (end < content.size() && !isUrlTerminator(content[end])) ++end;
+            if (end > hit.start + hit.length) analysis.urls.emplace_back(hit.start, end);
+        }
+
+        for (const auto& hit : hits) {
+            size_t after = hit.start + hit.length;
+            switch (hit.id) {
+                case LITERAL_PROFANITY:
+                    analysis.profanity = true;
+                    break;
+                case LITERAL_PHISHING_PHRASE:
+                    analysis.suspiciousPhrase = true;
+                    break;
+                case LITERAL_BLOCKED_DOMAIN:
+                    for (const auto& url : analysis.urls) {
+                        if (hit.start >= url.first && after <= url.second) analysis.blockedDomainInUrl = true;
+                    }
+                    break;
+                case LITERAL_INVITE:
+                    if (after < content.size() && isWordCharacter(content[after])) analysis.invite = true;
+                    break;
+                case LITERAL_USER_MENTION: {
+                    // <@id> or <@!id>
+                    size_t pos = after;
+                    if (pos < content.size() && content[pos] == '!') ++pos;
+                    size_t digits = pos;
+                    while (pos < content.size() && std::isdigit(static_cast<unsigned char>(content[pos]))) ++pos;
+                    if (pos > digits && pos < content.size() && content[pos] == '>') analysis.mentions++;
+                    break;
+                }
+                case LITERAL_BROADCAST_MENTION:
+                    // Discord only honours the lowercase forms
+                    if (content.compare(hit.start, hit.length, "@everyone") == 0 ||
+                        content.compare(hit.start, hit.length, "@here") == 0) {
+                        analysis.mentions++;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+namespace {
+
+// Batches smaller than this are not worth handing to worker threads
+constexpr size_t PARALLEL_SCAN_THRESHOLD = 64;
+
+std::string spamUserKey(const DiscordMessage& message) {
+    return message.authorId.empty() ? message.authorName : message.authorId;
+}
+
+} // anonymous namespace
+
 // ContentScanner implementation
 ContentScanner::ContentScanner() 
-    : profanityFilterEnabled_(true), spamFilterEnabled_(true), phishingFilterEnabled_(true),
+    : rulesDirty_(true), generation_(0), spamDetector_(std::make_shared<SpamDetector>()), profanityFilterEnabled_(true), spamFilterEnabled_(true), phishingFilterEnabled_(true),
       inviteFilterEnabled_(true), mentionSpamEnabled_(true), maxMentions_(5) {
     
     // Initialize with basic profanity words (mild examples)
@@ -33,6 +189,60 @@ ContentScanner::ContentScanner()
 
 ContentScanner::~ContentScanner() {}
 
+std::shared_ptr<const ContentScanner::CompiledRules> ContentScanner::currentRules() const {
+    if (rulesDirty_.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(scannerMutex_);
+        if (rulesDirty_.load(std::memory_order_relaxed)) {
+            rebuildMatcher();
+            rulesDirty_.store(false, std::memory_order_release);
+        }
+    }
+    return std::atomic_load(&compiled_);
+}
+
+void ContentScanner::rebuildMatcher() const {
+    auto rules = std::make_shared<CompiledRules>();
+    rules->generation = ++generation_;
+    rules->profanityEnabled = profanityFilterEnabled_;
+    rules->phishingEnabled = phishingFilterEnabled_;
+    rules->inviteEnabled = inviteFilterEnabled_;
+    rules->spamEnabled = spamFilterEnabled_;
+    rules->mentionSpamEnabled = mentionSpamEnabled_;
+    rules->maxMentions = maxMentions_;
+    
+    for (const auto& filter : filters_) {
+        if (!filter.enabled) continue;
+        size_t index = rules->filters.size();
+        rules->filters.push_back(filter);
+        std::regex::flag_type flags = filter.getPatternFlags();
+        if (filter.getPatternSource().empty() || !matcherSupportsFlags(flags) ||
+            !rules->matcher.addRegex(filter.getPatternSource(), static_cast<uint32_t>(index),
+                                     (flags & std::regex::icase) == std::regex::icase)) {
+            rules->fallbackFilters.push_back(index);
+        }
+    }
+    
+    for (MultiPatternMatcher* matcher : {&rules->matcher, &rules->literals}) {
+        if (profanityFilterEnabled_) {
+            for (const auto& word : profanityWords_) matcher->addLiteral(word, LITERAL_PROFANITY);
+        }
+        if (phishingFilterEnabled_) {
+            for (const auto& phrase : SUSPICIOUS_PHRASES) matcher->addLiteral(phrase, LITERAL_PHISHING_PHRASE);
+            for (const auto& domain : blockedDomains_) matcher->addLiteral(domain, LITERAL_BLOCKED_DOMAIN);
+        }
+        // URL, invite and mention markers are always compiled for the helper methods
+        matcher->addLiteral("http://", LITERAL_URL_SCHEME);
+        matcher->addLiteral("https://", LITERAL_URL_SCHEME);
+        matcher->addLiteral("discord.gg/", LITERAL_INVITE);
+        matcher->addLiteral("discordapp.com/invite/", LITERAL_INVITE);
+        matcher->addLiteral("<@", LITERAL_USER_MENTION);
+        matcher->addLiteral("@everyone", LITERAL_BROADCAST_MENTION);
+        matcher->addLiteral("@here", LITERAL_BROADCAST_MENTION);
+        matcher->build();
+    }
+    std::atomic_store(&compiled_, std::shared_ptr<const CompiledRules>(std::move(rules)));
+}
+
 void ContentScanner::addFilter(const ContentFilter& filter) {
     std::lock_guard<std::mutex> lock(scannerMutex_);
     
@@ -41,6 +251,7 @@ void ContentScanner::addFilter(const ContentFilter& filter) {
         [&filter](const ContentFilter& f) { return f.name == filter.name; }), filters_.end());
     
     filters_.push_back(filter);
+    rulesDirty_ = true;
     logInfo("Added content filter: " + filter.name, "discrub_ext");
 }
 
@@ -50,6 +261,7 @@ void ContentScanner::removeFilter(const std::string& name) {
     filters_.erase(std::remove_if(filters_.begin(), filters_.end(),
         [&name](const ContentFilter& f) { return f.name == name; }), filters_.end());
     
+    rulesDirty_ = true;
     logInfo("Removed content filter: " + name, "discrub_ext");
 }
 
@@ -61,6 +273,7 @@ void ContentScanner::updateFilter(const std::string& name, const ContentFilter&
     
     if (it != filters_.end()) {
         *it = filter;
+        rulesDirty_ = true;
         logInfo("Updated content filter: " + name, "discrub_ext");
     }
 }
@@ -70,12 +283,34 @@ std::vector<ContentFilter> ContentScanner::getFilters() const {
     return filters_;
 }
 
+ContentScanner::MatcherStats ContentScanner::getMatcherStats() const {
+    auto rules = currentRules();
+    MatcherStats stats;
+    stats.generation = rules->generation;
+    stats.fallbackFilters = rules->fallbackFilters.size();
+    stats.compiledFilters = rules->filters.size() - stats.fallbackFilters;
+    stats.literals = rules->matcher.getLiteralCount();
+    stats.dfaCount = rules->matcher.getDfaCount();
+    stats.dfaStates = rules->matcher.getDfaStateCount();
+    return stats;
+}
+
 ContentScanner::ScanResult ContentScanner::scanMessage(const DiscordMessage& message) {
-    return scanContent(message.content);
+    return scan(message.content, &message);
+}
+
+ContentScanner::ScanResult ContentScanner::scanEditedMessage(const DiscordMessage& message) {
+    return scan(message.content, &message, false);
 }
 
 ContentScanner::ScanResult ContentScanner::scanContent(const std::string& content) {
-    std::lock_guard<std::mutex> lock(scannerMutex_);
+    return scan(content, nullptr);
+}
+
+ContentScanner::ScanResult ContentScanner::scan(const std::string& content, const DiscordMessage* message,
+                                                bool recordSpam) {
+    auto rules = currentRules();
+    ContentAnalysis analysis = rules->analyze(content);
     
     ScanResult result;
     result.violation = false;
@@ -83,32 +318,27 @@ ContentScanner::ScanResult ContentScanner::scanContent(const std::string& conten
     result.recommendedAction = FilterAction::NONE;
     
     // Apply regex-based filters
-    for (const auto& filter : filters_) {
-        if (!filter.enabled) continue;
+    for (size_t i = 0; i < rules->filters.size(); ++i) {
+        if (!analysis.filterMatched[i]) continue;
+        const ContentFilter& filter = rules->filters[i];
         
-        try {
-            if (std::regex_search(content, filter.pattern)) {
-                result.violation = true;
-                result.triggeredFilters.push_back(filter.name);
-                result.totalSeverity += filter.severity;
-                
-                // Use highest severity action
-                if (static_cast<int>(filter.action) > static_cast<int>(result.recommendedAction)) {
-                    result.recommendedAction = filter.action;
-                }
-                
-                if (!filter.reason.empty()) {
-                    if (!result.reason.empty()) result.reason += "; ";
-                    result.reason += filter.reason;
-                }
-            }
-        } catch (const std::regex_error& e) {
-            logError("Regex error in filter " + filter.name + ": " + e.what(), "discrub_ext");
+        result.violation = true;
+        result.triggeredFilters.push_back(filter.name);
+        result.totalSeverity += filter.severity;
+        
+        // Use highest severity action
+        if (static_cast<int>(filter.action) > static_cast<int>(result.recommendedAction)) {
+            result.recommendedAction = filter.action;
+        }
+        
+        if (!filter.reason.empty()) {
+            if (!result.reason.empty()) result.reason += "; ";
+            result.reason += filter.reason;
         }
     }
     
     // Apply built-in detection methods
-    if (profanityFilterEnabled_ && detectProfanity(content)) {
+    if (rules->profanityEnabled && analysis.profanity) {
         result.violation = true;
         result.triggeredFilters.push_back("built-in-profanity");
         result.totalSeverity += 3;
@@ -117,14 +347,15 @@ ContentScanner::ScanResult ContentScanner::scanContent(const std::string& conten
         }
     }
     
-    if (phishingFilterEnabled_ && detectPhishing(content)) {
+    if (rules->phishingEnabled &&
+        ((analysis.suspiciousPhrase && !analysis.urls.empty()) || analysis.blockedDomainInUrl)) {
         result.violation = true;
         result.triggeredFilters.push_back("built-in-phishing");
         result.totalSeverity += 8;
         result.recommendedAction = FilterAction::DELETE;
     }
     
-    if (inviteFilterEnabled_ && detectInviteLinks(content)) {
+    if (rules->inviteEnabled && analysis.invite) {
         result.violation = true;
         result.triggeredFilters.push_back("built-in-invite");
         result.totalSeverity += 4;
@@ -133,6 +364,44 @@ ContentScanner::ScanResult ContentScanner::scanContent(const std::string& conten
         }
     }
     
+    // Spam needs the author and timestamp, so only whole messages are judged
+    if (message && (rules->spamEnabled || rules->mentionSpamEnabled)) {
+        auto detector = std::atomic_load(&spamDetector_);
+        auto timestamp = message->timestamp == std::chrono::system_clock::time_point{}
+            ? std::chrono::system_clock::now() : message->timestamp;
+        // An edit was already counted when it was first sent
+        auto verdict = recordSpam
+            ? detector->evaluate(spamUserKey(*message), content, timestamp, analysis.mentions)
+            : detector->inspect(content);
+        
+        if (rules->spamEnabled && (verdict.contentSpam() || verdict.duplicateContent)) {
+            result.violation = true;
+            result.triggeredFilters.push_back("built-in-spam");
+            result.totalSeverity += 5;
+            if (result.recommendedAction < FilterAction::DELETE) {
+                result.recommendedAction = FilterAction::DELETE;
+            }
+        }
+        
+        if (rules->spamEnabled && verdict.rateExceeded) {
+            result.violation = true;
+            result.triggeredFilters.push_back("built-in-flood");
+            result.totalSeverity += 6;
+            if (result.recommendedAction < FilterAction::TIMEOUT) {
+                result.recommendedAction = FilterAction::TIMEOUT;
+            }
+        }
+        
+        if (rules->mentionSpamEnabled && (analysis.mentions > rules->maxMentions || verdict.mentionBurst)) {
+            result.violation = true;
+            result.triggeredFilters.push_back("built-in-mention-spam");
+            result.totalSeverity += 5;
+            if (result.recommendedAction < FilterAction::DELETE) {
+                result.recommendedAction = FilterAction::DELETE;
+            }
+        }
+    }
+    
     // Build reason string
     if (result.violation && result.reason.empty()) {
         result.reason = "Content policy violation detected";
@@ -142,10 +411,46 @@ ContentScanner::ScanResult ContentScanner::scanContent(const std::string& conten
 }
 
 std::vector<ContentScanner::ScanResult> ContentScanner::scanMessages(const std::vector<DiscordMessage>& messages) {
-    std::vector<ScanResult> results;
-    
-    for (const auto& message : messages) {
-        results.push_back(scanMessage(message));
+    std::vector<ScanResult> results(messages.size());
+    auto detector = std::atomic_load(&spamDetector_);
+    size_t workers = std::min<size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                                      detector->getShardCount());
+    
+    // History pages arrive newest first; the spam windows need each user's
+    // messages oldest first. Results keep the caller's order.
+    std::vector<size_t> order(messages.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&messages](size_t a, size_t b) {
+        return messages[a].timestamp < messages[b].timestamp;
+    });
+    
+    if (messages.size() < PARALLEL_SCAN_THRESHOLD || workers < 2) {
+        for (size_t i : order) {
+            results[i] = scanMessage(messages[i]);
+        }
+    } else {
+        // Each worker owns whole spam-detector shards, so one user's messages
+        // are still judged in timestamp order and shard locks are never contended
+        std::vector<std::vector<size_t>> byShard(detector->getShardCount());
+        for (size_t i : order) {
+            byShard[detector->shardFor(spamUserKey(messages[i]))].push_back(i);
+        }
+        
+        std::atomic<size_t> nextShard{0};
+        auto worker = [&]() {
+            for (size_t shard = nextShard++; shard < byShard.size(); shard = nextShard++) {
+                for (size_t i : byShard[shard]) {
+                    results[i] = scanMessage(messages[i]);
+                }
+            }
+        };
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < workers; ++t) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
     }
     
     logInfo("Scanned " + std::to_string(messages.size()) + " messages", "discrub_ext");
@@ -154,37 +459,58 @@ std::vector<ContentScanner::ScanResult> ContentScanner::scanMessages(const std::
 }
 
 void ContentScanner::enableProfanityFilter(bool enable) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
     profanityFilterEnabled_ = enable;
+    rulesDirty_ = true;
     logInfo(std::string("Profanity filter ") + (enable ? "enabled" : "disabled"), "discrub_ext");
 }
 
 void ContentScanner::enableSpamFilter(bool enable) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
     spamFilterEnabled_ = enable;
+    rulesDirty_ = true;
     logInfo(std::string("Spam filter ") + (enable ? "enabled" : "disabled"), "discrub_ext");
 }
 
 void ContentScanner::enablePhishingFilter(bool enable) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
     phishingFilterEnabled_ = enable;
+    rulesDirty_ = true;
     logInfo(std::string("Phishing filter ") + (enable ? "enabled" : "disabled"), "discrub_ext");
 }
 
 void ContentScanner::enableInviteFilter(bool enable) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
     inviteFilterEnabled_ = enable;
+    rulesDirty_ = true;
     logInfo(std::string("Invite filter ") + (enable ? "enabled" : "disabled"), "discrub_ext");
 }
 
 void ContentScanner::enableMentionSpamFilter(bool enable, int maxMentions) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
     mentionSpamEnabled_ = enable;
     maxMentions_ = maxMentions;
+    rulesDirty_ = true;
     logInfo(std::string("Mention spam filter ") + (enable ? "enabled" : "disabled") + 
         " (max: " + std::to_string(maxMentions) + ")", "discrub_ext");
 }
 
+void ContentScanner::setSpamDetectionConfig(const SpamDetectionConfig& config) {
+    std::lock_guard<std::mutex> lock(scannerMutex_);
+    std::atomic_store(&spamDetector_, std::make_shared<SpamDetector>(config));
+    logInfo("Updated spam detection thresholds", "discrub_ext");
+}
+
+SpamDetectionConfig ContentScanner::getSpamDetectionConfig() const {
+    return std::atomic_load(&spamDetector_)->getConfig();
+}
+
 void ContentScanner::addProfanityWords(const std::vector<std::string>& words) {
     std::lock_guard<std::mutex> lock(scannerMutex_);
     for (const auto& word : words) {
         profanityWords_.insert(word);
     }
+    rulesDirty_ = true;
     logInfo("Added " + std::to_string(words.size()) + " profanity words", "discrub_ext");
 }
 
@@ -201,41 +527,17 @@ void ContentScanner::addBlockedDomains(const std::vector<std::string>& domains)
     for (const auto& domain : domains) {
         blockedDomains_.insert(domain);
     }
+    rulesDirty_ = true;
     logInfo("Added " + std::to_string(domains.size()) + " blocked domains", "discrub_ext");
 }
 
 bool ContentScanner::detectProfanity(const std::string& content) {
-    std::string lowerContent = content;
-    std::transform(lowerContent.begin(), lowerContent.end(), lowerContent.begin(), ::tolower);
-    
-    for (const auto& word : profanityWords_) {
-        if (lowerContent.find(word) != std::string::npos) {
-            return true;
-        }
-    }
-    
-    return false;
+    return currentRules()->analyzeLiterals(content).profanity;
 }
 
 bool ContentScanner::detectSpam(const DiscordMessage& message) {
-    const std::string& content = message.content;
-    
-    // Check for excessive repetition
-    size_t maxRepeat = 0;
-    for (size_t i = 0; i < content.length(); ++i) {
-        size_t count = 1;
-        while (i + count < content.length() && content[i] == content[i + count]) {
-            count++;
-        }
-        maxRepeat = std::max(maxRepeat, count);
-    }
-    
-    if (maxRepeat > 5) {
-        return true;
-    }
-    
-    // Check for excessive length
-    if (content.length() > 2000) {
+    // Content checks only; user windows are updated by scanMessage
+    if (std::atomic_load(&spamDetector_)->inspect(message.content).contentSpam()) {
         return true;
     }
     
@@ -248,45 +550,12 @@ bool ContentScanner::detectSpam(const DiscordMessage& message) {
 }
 
 bool ContentScanner::detectPhishing(const std::string& content) {
-    // Look for suspicious patterns
-    std::vector<std::string> suspiciousPatterns = {
-        "click here to claim",
-        "free nitro",
-        "discord gift",
-        "steam gift",
-        "limited time",
-        "verify your account"
-    };
-    
-    std::string lowerContent = content;
-    std::transform(lowerContent.begin(), lowerContent.end(), lowerContent.begin(), ::tolower);
-    
-    for (const auto& pattern : suspiciousPatterns) {
-        if (lowerContent.find(pattern) != std::string::npos) {
-            // Check if it contains URLs
-            auto urls = extractUrls(content);
-            if (!urls.empty()) {
-                return true;
-            }
-        }
-    }
-    
-    // Check for blocked domains
-    auto urls = extractUrls(content);
-    for (const auto& url : urls) {
-        for (const auto& blockedDomain : blockedDomains_) {
-            if (url.find(blockedDomain) != std::string::npos) {
-                return true;
-            }
-        }
-    }
-    
-    return false;
+    ContentAnalysis analysis = currentRules()->analyzeLiterals(content);
+    return (analysis.suspiciousPhrase && !analysis.urls.empty()) || analysis.blockedDomainInUrl;
 }
 
 bool ContentScanner::detectInviteLinks(const std::string& content) {
-    std::regex invitePattern(R"(discord\.gg/\w+|discordapp\.com/invite/\w+)");
-    return std::regex_search(content, invitePattern);
+    return currentRules()->analyzeLiterals(content).invite;
 }
 
 bool ContentScanner::detectMentionSpam(const DiscordMessage& message) {
@@ -296,30 +565,14 @@ bool ContentScanner::detectMentionSpam(const DiscordMessage& message) {
 
 std::vector<std::string> ContentScanner::extractUrls(const std::string& content) {
     std::vector<std::string> urls;
-    std::regex urlPattern(R"(https?://[^\s]+)");
-    
-    std::sregex_iterator iter(content.begin(), content.end(), urlPattern);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        urls.push_back(iter->str());
+    for (const auto& span : currentRules()->analyzeLiterals(content).urls) {
+        urls.push_back(content.substr(span.first, span.second - span.first));
     }
-    
     return urls;
 }
 
 int ContentScanner::countMentions(const std::string& content) {
-    std::regex mentionPattern(R"(<@!?\d+>|@everyone|@here)");
-    
-    int count = 0;
-    std::sregex_iterator iter(content.begin(), content.end(), mentionPattern);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        count++;
-    }
-    
-    return count;
+    return currentRules()->analyzeLiterals(content).mentions;
 }
 
 // AutoModerator implementation
@@ -391,8 +644,11 @@ void DiscrubExtension::processIncomingMessage(const DiscordMessage& message) {
 }
 
 void DiscrubExtension::processMessageEdit(const DiscordMessage& /* oldMessage */, const DiscordMessage& newMessage) {
-    // Process the edited message
-    processIncomingMessage(newMessage);
+    auto scanResult = scanner_.scanEditedMessage(newMessage);
+    
+    if (scanResult.violation) {
+        logWarning("Violation detected in edited message " + newMessage.id + ": " + scanResult.reason, "discrub_ext");
+    }
 }
 
 void DiscrubExtension::processMessageDelete(const std::string& channelId, const std::string& messageId) {
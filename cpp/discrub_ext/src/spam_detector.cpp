@@ -0,0 +1,252 @@
+#include "elizaos/discrub_ext.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+
+namespace elizaos {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 1469598103934665603ULL;
+constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+// Spreads FNV output so SimHash bits are not correlated with word length
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+TimePoint timeOf(TimePoint entry) { return entry; }
+
+template <typename Value>
+TimePoint timeOf(const std::pair<TimePoint, Value>& entry) { return entry.first; }
+
+// Window entries stay sorted by timestamp. Live traffic appends at the back;
+// history arrives newest first and walks a short, bounded deque.
+template <typename Deque, typename Entry>
+void insertSorted(Deque& entries, Entry entry) {
+    auto pos = entries.end();
+    while (pos != entries.begin() && timeOf(*std::prev(pos)) > timeOf(entry)) --pos;
+    entries.insert(pos, std::move(entry));
+}
+
+template <typename Deque>
+void expire(Deque& entries, TimePoint cutoff) {
+    while (!entries.empty() && timeOf(entries.front()) < cutoff) entries.pop_front();
+}
+
+// Calls fn for each entry timestamped within [from, to]
+template <typename Deque, typename Fn>
+void forEachBetween(const Deque& entries, TimePoint from, TimePoint to, Fn fn) {
+    for (const auto& entry : entries) {
+        TimePoint t = timeOf(entry);
+        if (t > to) break;
+        if (t >= from) fn(entry);
+    }
+}
+
+} // anonymous namespace
+
+MessageFeatures MessageFeatures::compute(const std::string& content) {
+    MessageFeatures features;
+    features.length = content.size();
+
+    std::array<uint32_t, 256> histogram{};
+    std::array<int32_t, 64> simHashWeights{};
+    uint64_t wordHash = FNV_OFFSET;
+    bool inWord = false;
+    size_t run = 0;
+    unsigned char previous = 0;
+
+    auto endWord = [&]() {
+        if (!inWord) return;
+        uint64_t h = mixHash(wordHash);
+        for (int bit = 0; bit < 64; ++bit) {
+            simHashWeights[bit] += ((h >> bit) & 1) ? 1 : -1;
+        }
+        features.words++;
+        wordHash = FNV_OFFSET;
+        inWord = false;
+    };
+
+    for (size_t i = 0; i < content.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(content[i]);
+        histogram[c]++;
+
+        run = (i > 0 && c == previous) ? run + 1 : 1;
+        features.longestRun = std::max(features.longestRun, run);
+        previous = c;
+
+        bool wordByte = false;
+        if (c >= 0x80) {
+            features.nonAscii++;
+            wordByte = true;
+        } else if (std::isalpha(c)) {
+            features.letters++;
+            if (std::isupper(c)) features.uppercase++;
+            wordByte = true;
+        } else if (std::isdigit(c)) {
+            features.digits++;
+            wordByte = true;
+        } else if (std::isspace(c)) {
+            features.whitespace++;
+        } else {
+            features.symbols++;
+        }
+
+        if (wordByte) {
+            wordHash = (wordHash ^ static_cast<unsigned char>(std::tolower(c))) * FNV_PRIME;
+            inWord = true;
+        } else {
+            endWord();
+        }
+    }
+    endWord();
+
+    if (!content.empty()) {
+        double total = static_cast<double>(content.size());
+        for (uint32_t count : histogram) {
+            if (count == 0) continue;
+            double p = count / total;
+            features.entropy -= p * std::log2(p);
+        }
+    }
+    for (int bit = 0; bit < 64; ++bit) {
+        if (simHashWeights[bit] > 0) features.simHash |= (1ULL << bit);
+    }
+    return features;
+}
+
+// SpamDetector implementation
+SpamDetector::SpamDetector(const SpamDetectionConfig& config) : config_(config) {
+    size_t shardCount = std::max<size_t>(1, config_.shardCount);
+    shardCapacity_ = std::max<size_t>(1, (config_.maxTrackedUsers + shardCount - 1) / shardCount);
+    for (size_t i = 0; i < shardCount; ++i) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+}
+
+size_t SpamDetector::shardFor(const std::string& userId) const {
+    return std::hash<std::string>{}(userId) % shards_.size();
+}
+
+int SpamDetector::hammingDistance(uint64_t a, uint64_t b) {
+    uint64_t x = a ^ b;
+    int distance = 0;
+    while (x) {
+        x &= x - 1;
+        distance++;
+    }
+    return distance;
+}
+
+SpamDetector::UserWindow& SpamDetector::touchUser(Shard& shard, const std::string& userId) {
+    auto it = shard.users.find(userId);
+    if (it != shard.users.end()) {
+        shard.recency.splice(shard.recency.begin(), shard.recency, it->second.second);
+        return it->second.first;
+    }
+
+    if (shard.users.size() >= shardCapacity_) {
+        shard.users.erase(shard.recency.back());
+        shard.recency.pop_back();
+    }
+    shard.recency.push_front(userId);
+    auto inserted = shard.users.emplace(userId, std::make_pair(UserWindow(), shard.recency.begin()));
+    return inserted.first->second.first;
+}
+
+SpamDetector::Verdict SpamDetector::inspect(const std::string& content) const {
+    Verdict verdict;
+    verdict.features = MessageFeatures::compute(content);
+
+    const MessageFeatures& f = verdict.features;
+    verdict.repetition = f.longestRun > config_.maxRepeatedRun;
+    verdict.tooLong = f.length > config_.maxLength;
+    verdict.lowEntropy = f.length >= config_.minEntropyLength && f.entropy < config_.minEntropy;
+    return verdict;
+}
+
+SpamDetector::Verdict SpamDetector::evaluate(const std::string& userId, const std::string& content,
+                                             std::chrono::system_clock::time_point timestamp, int mentionCount) {
+    Verdict verdict = inspect(content);
+    if (userId.empty()) return verdict;
+
+    const MessageFeatures& f = verdict.features;
+
+    Shard& shard = *shards_[shardFor(userId)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    UserWindow& window = touchUser(shard, userId);
+
+    // Windows expire against the newest message seen, not this one, so a
+    // batch scanned newest first cannot pin stale entries. Each verdict
+    // counts only entries in the window ending at this message's timestamp.
+    window.newest = std::max(window.newest, timestamp);
+
+    // Message rate. Only limit + 1 entries are kept: enough to see the limit
+    // being crossed, and the deque stays bounded however hard a user floods.
+    while (window.messages.size() > static_cast<size_t>(std::max(config_.maxMessagesPerWindow, 0))) {
+        window.messages.pop_front();
+    }
+    insertSorted(window.messages, timestamp);
+    forEachBetween(window.messages, timestamp - config_.rateWindow, timestamp,
+                   [&](TimePoint) { verdict.windowMessages++; });
+    verdict.rateExceeded = verdict.windowMessages > config_.maxMessagesPerWindow;
+    expire(window.messages, window.newest - config_.rateWindow);
+
+    // Near-duplicate content
+    if (f.length >= config_.minFingerprintLength) {
+        forEachBetween(window.fingerprints, timestamp - config_.duplicateWindow, timestamp,
+                       [&](const std::pair<TimePoint, uint64_t>& entry) {
+            if (hammingDistance(entry.second, f.simHash) <= config_.maxSimHashDistance) {
+                verdict.windowDuplicates++;
+            }
+        });
+        verdict.duplicateContent = verdict.windowDuplicates >= config_.maxDuplicates;
+        insertSorted(window.fingerprints, std::make_pair(timestamp, f.simHash));
+    }
+    expire(window.fingerprints, window.newest - config_.duplicateWindow);
+    size_t history = static_cast<size_t>(std::max(config_.maxDuplicates, 1)) * 8;
+    while (window.fingerprints.size() > history) window.fingerprints.pop_front();
+
+    // Mention bursts
+    if (mentionCount > 0) {
+        while (window.mentions.size() > static_cast<size_t>(std::max(config_.maxMentionsPerWindow, 0))) {
+            window.mentions.pop_front();
+        }
+        insertSorted(window.mentions, std::make_pair(timestamp, mentionCount));
+    }
+    forEachBetween(window.mentions, timestamp - config_.mentionWindow, timestamp,
+                   [&](const std::pair<TimePoint, int>& entry) { verdict.windowMentions += entry.second; });
+    verdict.mentionBurst = verdict.windowMentions > config_.maxMentionsPerWindow;
+    expire(window.mentions, window.newest - config_.mentionWindow);
+
+    return verdict;
+}
+
+size_t SpamDetector::getTrackedUserCount() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->users.size();
+    }
+    return total;
+}
+
+void SpamDetector::forgetUser(const std::string& userId) {
+    Shard& shard = *shards_[shardFor(userId)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.users.find(userId);
+    if (it == shard.users.end()) return;
+    shard.recency.erase(it->second.second);
+    shard.users.erase(it);
+}
+
+} // namespace elizaos
@@ -41,6 +41,91 @@ std::string trim(const std::string& str) {
     return str.substr(start, end - start + 1);
 }
 
+namespace {
+
+// Rough heap footprint of a session held in memory
+size_t estimateSessionBytes(const ConversationContext& session) {
+    size_t bytes = sizeof(ConversationContext) + session.sessionId.capacity() + session.userId.capacity() +
+                   session.characterId.capacity() + session.history.capacity() * sizeof(ConversationTurn);
+    for (const auto& turn : session.history) {
+        bytes += turn.id.capacity() + turn.input.capacity() + turn.response.capacity() + turn.emotionalState.capacity();
+    }
+    for (const auto& [key, value] : session.sessionData) bytes += key.capacity() + value.capacity() + 2 * sizeof(std::string);
+    return bytes;
+}
+
+// Turns and session data of a session leaving memory, as one JSON document
+std::string encodeSessionState(const ConversationContext& session) {
+    std::string out;
+    json::Writer writer(out);
+    writer.startObject();
+    writer.key("history");
+    writer.startArray();
+    for (const auto& turn : session.history) {
+        writer.startObject();
+        writer.key("id");
+        writer.string(turn.id);
+        writer.key("input");
+        writer.string(turn.input);
+        writer.key("response");
+        writer.string(turn.response);
+        writer.key("timestamp");
+        writer.integer(std::chrono::duration_cast<std::chrono::milliseconds>(turn.timestamp.time_since_epoch()).count());
+        writer.key("emotionalState");
+        writer.string(turn.emotionalState);
+        writer.key("confidence");
+        writer.number(turn.confidence);
+        writer.key("metadata");
+        writer.startObject();
+        for (const auto& [key, value] : turn.metadata) {
+            writer.key(key);
+            writer.string(value);
+        }
+        writer.endObject();
+        writer.endObject();
+    }
+    writer.endArray();
+    writer.key("sessionData");
+    writer.startObject();
+    for (const auto& [key, value] : session.sessionData) {
+        writer.key(key);
+        writer.string(value);
+    }
+    writer.endObject();
+    writer.endObject();
+    return out;
+}
+
+bool decodeSessionState(std::string_view text, ConversationContext& session) {
+    auto document = json::parse(text);
+    if (!document || !document->isObject()) return false;
+    
+    if (const JsonValue* history = document->find("history"); history && history->isArray()) {
+        for (const auto& entry : history->asArray()) {
+            if (!entry.isObject()) continue;
+            ConversationTurn turn(entry.getString("input"), entry.getString("response"));
+            turn.id = entry.getString("id", turn.id);
+            turn.timestamp = std::chrono::system_clock::time_point(std::chrono::milliseconds(entry.getInt("timestamp")));
+            turn.emotionalState = entry.getString("emotionalState", turn.emotionalState);
+            turn.confidence = static_cast<float>(entry.getDouble("confidence"));
+            if (const JsonValue* metadata = entry.find("metadata"); metadata && metadata->isObject()) {
+                for (const auto& member : metadata->asObject()) {
+                    if (member.value.isString()) turn.metadata[std::string(member.key)] = std::string(member.value.asString());
+                }
+            }
+            session.history.push_back(std::move(turn));
+        }
+    }
+    if (const JsonValue* data = document->find("sessionData"); data && data->isObject()) {
+        for (const auto& member : data->asObject()) {
+            if (member.value.isString()) session.sessionData[std::string(member.key)] = std::string(member.value.asString());
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
 // =====================================================
 // ConversationTurn Implementation
 // =====================================================
@@ -109,38 +194,25 @@ void ConversationContext::updateLastActivity() {
 
 JsonValue ConversationContext::toJson() const {
     JsonValue json;
-    json["sessionId"] = std::string(sessionId);
-    json["userId"] = std::string(userId);
-    json["characterId"] = std::string(characterId);
-    json["turnCount"] = std::string(std::to_string(history.size()));
-    json["startTime"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(startTime)));
-    json["lastActivity"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(lastActivity)));
+    json["sessionId"] = sessionId;
+    json["userId"] = userId;
+    json["characterId"] = characterId;
+    json["turnCount"] = history.size();
+    json["startTime"] = std::chrono::system_clock::to_time_t(startTime);
+    json["lastActivity"] = std::chrono::system_clock::to_time_t(lastActivity);
     return json;
 }
 
 ConversationContext ConversationContext::fromJson(const JsonValue& json) {
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    ConversationContext context(getString("sessionId"), getString("userId"));
-    context.characterId = getString("characterId");
+    ConversationContext context(json.getString("sessionId"), json.getString("userId"));
+    context.characterId = json.getString("characterId");
     
-    try {
-        auto start_time_t = std::stoll(getString("startTime"));
-        auto last_time_t = std::stoll(getString("lastActivity"));
-        context.startTime = std::chrono::system_clock::from_time_t(start_time_t);
-        context.lastActivity = std::chrono::system_clock::from_time_t(last_time_t);
-    } catch (const std::exception&) {
-        // Use current time if parsing fails
+    // Keep the construction time when a timestamp is missing
+    if (const JsonValue* start = json.find("startTime"); start && start->isNumber()) {
+        context.startTime = std::chrono::system_clock::from_time_t(start->asInt());
+    }
+    if (const JsonValue* last = json.find("lastActivity"); last && last->isNumber()) {
+        context.lastActivity = std::chrono::system_clock::from_time_t(last->asInt());
     }
     
     return context;
@@ -211,34 +283,17 @@ std::vector<std::string> ResponsePattern::extractCaptures(const std::string& inp
 
 JsonValue ResponsePattern::toJson() const {
     JsonValue json;
-    json["id"] = std::string(id);
-    json["pattern"] = std::string(pattern);
-    json["category"] = std::string(category);
-    json["priority"] = std::string(std::to_string(priority));
+    json["id"] = id;
+    json["pattern"] = pattern;
+    json["category"] = category;
+    json["priority"] = priority;
     return json;
 }
 
 ResponsePattern ResponsePattern::fromJson(const JsonValue& json) {
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    ResponsePattern pattern(getString("pattern"), {}, getString("category"));
-    pattern.id = getString("id");
-    
-    try {
-        pattern.priority = std::stof(getString("priority"));
-    } catch (const std::exception&) {
-        pattern.priority = 1.0f;
-    }
+    ResponsePattern pattern(json.getString("pattern"), {}, json.getString("category"));
+    pattern.id = json.getString("id");
+    pattern.priority = static_cast<float>(json.getDouble("priority", 1.0));
     
     return pattern;
 }
@@ -336,28 +391,20 @@ void EmotionalStateTracker::adjustEmotion(const std::string& emotion, float adju
 
 JsonValue EmotionalStateTracker::toJson() const {
     JsonValue json;
-    json["happiness"] = std::string(std::to_string(happiness));
-    json["sadness"] = std::string(std::to_string(sadness));
-    json["anger"] = std::string(std::to_string(anger));
-    json["fear"] = std::string(std::to_string(fear));
-    json["surprise"] = std::string(std::to_string(surprise));
-    json["disgust"] = std::string(std::to_string(disgust));
-    json["excitement"] = std::string(std::to_string(excitement));
-    json["calmness"] = std::string(std::to_string(calmness));
+    json["happiness"] = happiness;
+    json["sadness"] = sadness;
+    json["anger"] = anger;
+    json["fear"] = fear;
+    json["surprise"] = surprise;
+    json["disgust"] = disgust;
+    json["excitement"] = excitement;
+    json["calmness"] = calmness;
     return json;
 }
 
 EmotionalStateTracker EmotionalStateTracker::fromJson(const JsonValue& json) {
-    auto getFloat = [&](const std::string& key, float defaultVal = 0.5f) -> float {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::stof(std::any_cast<std::string>(it->second));
-            } catch (const std::exception&) {
-                return defaultVal;
-            }
-        }
-        return defaultVal;
+    auto getFloat = [&](std::string_view key) {
+        return static_cast<float>(json.getDouble(key, 0.5));
     };
     
     EmotionalStateTracker tracker;
@@ -608,7 +655,9 @@ ElizaCore::ElizaCore() {
     logger_->log("Eliza core initialized", "info", "eliza");
 }
 
-ElizaCore::~ElizaCore() = default;
+ElizaCore::~ElizaCore() {
+    MemoryGovernor::global().unregisterConsumer(*this);
+}
 
 std::string ElizaCore::generateSessionId() {
     return generateElizaUUID();
@@ -624,11 +673,12 @@ std::string ElizaCore::processInput(const std::string& input,
         activeSessionId = createSession(userId);
     }
     
-    // Get or create session
+    // Get, reload after eviction, or create session
     auto sessionIt = sessions_.find(activeSessionId);
     if (sessionIt == sessions_.end()) {
-        sessions_[activeSessionId] = ConversationContext(activeSessionId, userId);
-        sessionIt = sessions_.find(activeSessionId);
+        auto stored = loadSessionFromMemory(activeSessionId);
+        sessionIt = sessions_.emplace(activeSessionId, stored ? std::move(*stored)
+                                                              : ConversationContext(activeSessionId, userId)).first;
     }
     
     auto& context = sessionIt->second;
@@ -705,7 +755,7 @@ bool ElizaCore::endSession(const std::string& sessionId) {
     auto it = sessions_.find(sessionId);
     if (it != sessions_.end()) {
         // Save final session state
-        saveSessionToMemory(it->second);
+        saveSessionToMemory(it->second, true);
         sessions_.erase(it);
         
         logger_->log("Ended session: " + sessionId, "info", "eliza");
@@ -924,7 +974,36 @@ size_t ElizaCore::getSessionCount() const {
     return sessions_.size();
 }
 
-void ElizaCore::saveSessionToMemory(const ConversationContext& session) {
+size_t ElizaCore::getAccountedBytes() const {
+    // History is capped per session, so summing on demand stays cheap
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    size_t bytes = 0;
+    for (const auto& [sessionId, session] : sessions_) bytes += estimateSessionBytes(session);
+    return bytes;
+}
+
+size_t ElizaCore::shrinkMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(sessionsMutex_);
+    std::vector<std::unordered_map<std::string, ConversationContext>::iterator> idle;
+    idle.reserve(sessions_.size());
+    for (auto it = sessions_.begin(); it != sessions_.end(); ++it) idle.push_back(it);
+    std::sort(idle.begin(), idle.end(),
+              [](const auto& a, const auto& b) { return a->second.lastActivity < b->second.lastActivity; });
+
+    // Evicted sessions keep their full history in memory_, so only what the
+    // in-process copy costs beyond that encoding counts as freed
+    size_t freed = 0;
+    for (const auto& it : idle) {
+        if (freed >= bytes) break;
+        size_t resident = estimateSessionBytes(it->second);
+        size_t persisted = saveSessionToMemory(it->second, true);
+        freed += resident > persisted ? resident - persisted : 0;
+        sessions_.erase(it);
+    }
+    return freed;
+}
+
+size_t ElizaCore::saveSessionToMemory(const ConversationContext& session, bool includeHistory) {
     UUID memoryId(session.sessionId);
     UUID entityId = generateElizaUUID();
     UUID agentId = generateElizaUUID();
@@ -938,11 +1017,19 @@ void ElizaCore::saveSessionToMemory(const ConversationContext& session) {
     customMeta.customData["startTime"] = std::to_string(std::chrono::system_clock::to_time_t(session.startTime));
     customMeta.customData["lastActivity"] = std::to_string(std::chrono::system_clock::to_time_t(session.lastActivity));
     
+    size_t persisted = 0;
+    if (includeHistory) {
+        std::string state = encodeSessionState(session);
+        persisted = state.size();
+        customMeta.customData["state"] = std::move(state);
+    }
+    
     MemoryMetadata metadata = customMeta;
-    auto memory = std::make_shared<Memory>(memoryId, session.getContextSummary(), 
-                                          entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, session.getContextSummary(), 
+                             entityId, agentId, metadata);
     
     memory_->createMemory(memory, "conversations");
+    return persisted;
 }
 
 std::optional<ConversationContext> ElizaCore::loadSessionFromMemory(const std::string& sessionId) {
@@ -978,6 +1065,10 @@ std::optional<ConversationContext> ElizaCore::loadSessionFromMemory(const std::s
                 // Use current time if parsing fails
             }
             
+            // Present when the session was evicted or ended
+            std::string state = getValue("state");
+            if (!state.empty()) decodeSessionState(state, context);
+            
             return context;
         }
     }
@@ -8,8 +8,8 @@ namespace elizaos {
     namespace hyperfy {
         
         // HyperfyWorld implementation
-        HyperfyWorld::HyperfyWorld(const std::string& worldId, const std::string& wsUrl) 
-            : worldId_(worldId), wsUrl_(wsUrl), connected_(false) {
+        HyperfyWorld::HyperfyWorld(const std::string& worldId, const std::string& wsUrl, const ReplicationConfig& replication) 
+            : worldId_(worldId), wsUrl_(wsUrl), connected_(false), replica_(replication) {
         }
         
         HyperfyWorld::~HyperfyWorld() {
@@ -47,6 +47,8 @@ namespace elizaos {
             logInfo("Disconnecting from Hyperfy world: " + worldId_, "HyperfyWorld");
             connected_.store(false);
             worldState_.clear();
+            self_.reset();
+            replica_.reset();
             
             logInfo("Disconnected from Hyperfy world: " + worldId_, "HyperfyWorld");
         }
@@ -87,10 +89,12 @@ namespace elizaos {
             oss << "Moving to position (" << x << ", " << y << ", " << z << ") in world " << worldId_;
             logInfo(oss.str(), "HyperfyWorld");
             
-            // TODO: Implement actual position movement via WebSocket
-            updateState("position_x", std::to_string(x));
-            updateState("position_y", std::to_string(y));
-            updateState("position_z", std::to_string(z));
+            std::lock_guard<std::mutex> lock(worldMutex_);
+            EntityState state = self_.value_or(EntityState{});
+            state.position = {static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)};
+            state.velocity = {};
+            state.flags = (state.flags & ~ENTITY_MOVING) | ENTITY_AGENT;
+            self_ = state;
             
             return true;
         }
@@ -106,6 +110,32 @@ namespace elizaos {
             return true;
         }
         
+        bool HyperfyWorld::applySnapshot(std::string_view message) {
+            return replica_.applySnapshot(message);
+        }
+        
+        std::string HyperfyWorld::buildUpdate() const {
+            return replica_.buildUpdate(getSelfState());
+        }
+        
+        std::optional<EntityState> HyperfyWorld::getSelfState() const {
+            std::lock_guard<std::mutex> lock(worldMutex_);
+            return self_;
+        }
+        
+        void HyperfyWorld::setSelfState(const EntityState& state) {
+            std::lock_guard<std::mutex> lock(worldMutex_);
+            self_ = state;
+        }
+        
+        std::vector<ReplicatedEntity> HyperfyWorld::getVisibleEntities() const {
+            return replica_.getEntities();
+        }
+        
+        std::optional<EntityState> HyperfyWorld::getEntity(EntityId id) const {
+            return replica_.getEntity(id);
+        }
+        
         // HyperfyService implementation
         HyperfyService::HyperfyService() : running_(false) {
         }
@@ -302,10 +332,16 @@ namespace elizaos {
             // For now, just log that perception is happening
             
             std::ostringstream perception;
-            perception << "Scene perception at position ("
-                      << world->getState("position_x") << ", "
-                      << world->getState("position_y") << ", "
-                      << world->getState("position_z") << ")";
+            auto self = world->getSelfState();
+            if (self) {
+                perception << "Scene perception at position ("
+                          << self->position.x << ", "
+                          << self->position.y << ", "
+                          << self->position.z << ")";
+            } else {
+                perception << "Scene perception at unknown position";
+            }
+            perception << " with " << world->getVisibleEntities().size() << " entities in view";
             
             logInfo(perception.str(), "PerceptionAction");
             return true;
@@ -0,0 +1,606 @@
+#include "elizaos/hyperfy_replication.hpp"
+#include "elizaos/snapshot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace elizaos {
+    namespace hyperfy {
+
+        namespace {
+
+            constexpr uint8_t MESSAGE_SNAPSHOT = 1;
+            constexpr uint8_t MESSAGE_UPDATE = 2;
+
+            // Entry mask bits; an entry lists only the fields that differ from its baseline
+            constexpr uint8_t FIELD_POSITION = 1u << 0;
+            constexpr uint8_t FIELD_YAW = 1u << 1;
+            constexpr uint8_t FIELD_VELOCITY = 1u << 2;
+            constexpr uint8_t FIELD_FLAGS = 1u << 3;
+            constexpr uint8_t ENTRY_NEW = 1u << 4;       // Baseline is the zero state
+            constexpr uint8_t ENTRY_REMOVED = 1u << 5;
+            constexpr uint8_t ENTRY_MASK = FIELD_POSITION | FIELD_YAW | FIELD_VELOCITY | FIELD_FLAGS | ENTRY_NEW | ENTRY_REMOVED;
+
+            constexpr double TWO_PI = 6.283185307179586;
+            constexpr double YAW_STEPS = 65536.0;
+
+            using EntityList = std::vector<std::pair<EntityId, QuantizedState>>;
+
+            int32_t quantizeScalar(float value, float resolution) {
+                double steps = std::nearbyint(static_cast<double>(value) / resolution);
+                if (std::isnan(steps)) {
+                    return 0;
+                }
+                steps = std::clamp(steps, static_cast<double>(std::numeric_limits<int32_t>::min()),
+                                   static_cast<double>(std::numeric_limits<int32_t>::max()));
+                return static_cast<int32_t>(steps);
+            }
+
+            uint16_t quantizeYaw(float yaw) {
+                double turns = static_cast<double>(yaw) / TWO_PI;
+                if (!std::isfinite(turns)) {
+                    return 0;
+                }
+                turns -= std::floor(turns);
+                return static_cast<uint16_t>(static_cast<uint32_t>(std::llround(turns * YAW_STEPS)) & 0xFFFFu);
+            }
+
+            bool samePosition(const QuantizedState& a, const QuantizedState& b) {
+                return std::equal(std::begin(a.position), std::end(a.position), std::begin(b.position));
+            }
+
+            bool sameVelocity(const QuantizedState& a, const QuantizedState& b) {
+                return std::equal(std::begin(a.velocity), std::end(a.velocity), std::begin(b.velocity));
+            }
+
+            uint8_t changedFields(const QuantizedState& base, const QuantizedState& now) {
+                uint8_t mask = 0;
+                if (!samePosition(base, now)) mask |= FIELD_POSITION;
+                if (base.yaw != now.yaw) mask |= FIELD_YAW;
+                if (!sameVelocity(base, now)) mask |= FIELD_VELOCITY;
+                if (base.flags != now.flags) mask |= FIELD_FLAGS;
+                return mask;
+            }
+
+            void writeFields(SnapshotWriter& out, uint8_t mask, const QuantizedState& base, const QuantizedState& now) {
+                if (mask & FIELD_POSITION) {
+                    for (int i = 0; i < 3; ++i) {
+                        out.writeSigned(static_cast<int64_t>(now.position[i]) - base.position[i]);
+                    }
+                }
+                if (mask & FIELD_YAW) {
+                    // Shortest way round, so small turns across zero stay small
+                    out.writeSigned(static_cast<int16_t>(static_cast<uint16_t>(now.yaw - base.yaw)));
+                }
+                if (mask & FIELD_VELOCITY) {
+                    for (int i = 0; i < 3; ++i) {
+                        out.writeSigned(static_cast<int64_t>(now.velocity[i]) - base.velocity[i]);
+                    }
+                }
+                if (mask & FIELD_FLAGS) {
+                    out.writeVarint(now.flags);
+                }
+            }
+
+            bool readComponent(SnapshotReader& in, int32_t base, int32_t& out) {
+                int64_t value = static_cast<int64_t>(base) + in.readSigned();
+                if (value < std::numeric_limits<int32_t>::min() || value > std::numeric_limits<int32_t>::max()) {
+                    in.fail();
+                    return false;
+                }
+                out = static_cast<int32_t>(value);
+                return true;
+            }
+
+            QuantizedState readFields(SnapshotReader& in, uint8_t mask, const QuantizedState& base) {
+                QuantizedState state = base;
+                if (mask & FIELD_POSITION) {
+                    for (int i = 0; i < 3; ++i) {
+                        readComponent(in, base.position[i], state.position[i]);
+                    }
+                }
+                if (mask & FIELD_YAW) {
+                    state.yaw = static_cast<uint16_t>(base.yaw + static_cast<uint16_t>(in.readSigned()));
+                }
+                if (mask & FIELD_VELOCITY) {
+                    for (int i = 0; i < 3; ++i) {
+                        readComponent(in, base.velocity[i], state.velocity[i]);
+                    }
+                }
+                if (mask & FIELD_FLAGS) {
+                    uint64_t flags = in.readVarint();
+                    if (flags > std::numeric_limits<uint32_t>::max()) {
+                        in.fail();
+                    }
+                    state.flags = static_cast<uint32_t>(flags);
+                }
+                return state;
+            }
+
+            uint64_t cellKey(int64_t cx, int64_t cz) {
+                return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+            }
+
+            const QuantizedState* findEntity(const EntityList& entities, EntityId id) {
+                auto it = std::lower_bound(entities.begin(), entities.end(), id,
+                                           [](const auto& entry, EntityId key) { return entry.first < key; });
+                return (it != entities.end() && it->first == id) ? &it->second : nullptr;
+            }
+
+        } // anonymous namespace
+
+        bool QuantizedState::operator==(const QuantizedState& other) const {
+            return samePosition(*this, other) && yaw == other.yaw && sameVelocity(*this, other) && flags == other.flags;
+        }
+
+        QuantizedState quantize(const EntityState& state, const ReplicationConfig& config) {
+            QuantizedState q;
+            q.position[0] = quantizeScalar(state.position.x, config.positionResolution);
+            q.position[1] = quantizeScalar(state.position.y, config.positionResolution);
+            q.position[2] = quantizeScalar(state.position.z, config.positionResolution);
+            q.yaw = quantizeYaw(state.yaw);
+            q.velocity[0] = quantizeScalar(state.velocity.x, config.velocityResolution);
+            q.velocity[1] = quantizeScalar(state.velocity.y, config.velocityResolution);
+            q.velocity[2] = quantizeScalar(state.velocity.z, config.velocityResolution);
+            q.flags = state.flags;
+            return q;
+        }
+
+        EntityState dequantize(const QuantizedState& state, const ReplicationConfig& config) {
+            EntityState s;
+            s.position = {state.position[0] * config.positionResolution,
+                          state.position[1] * config.positionResolution,
+                          state.position[2] * config.positionResolution};
+            // Back into [-pi, pi)
+            double turns = state.yaw / YAW_STEPS;
+            s.yaw = static_cast<float>((turns >= 0.5 ? turns - 1.0 : turns) * TWO_PI);
+            s.velocity = {state.velocity[0] * config.velocityResolution,
+                          state.velocity[1] * config.velocityResolution,
+                          state.velocity[2] * config.velocityResolution};
+            s.flags = state.flags;
+            return s;
+        }
+
+        // ReplicationServer implementation
+        ReplicationServer::ReplicationServer(ReplicationConfig config)
+            : config_(config), cellSize_(std::max(config.interestRadius, 1.0f)) {
+        }
+
+        uint64_t ReplicationServer::cellOf(const QuantizedState& state) const {
+            double x = state.position[0] * static_cast<double>(config_.positionResolution);
+            double z = state.position[2] * static_cast<double>(config_.positionResolution);
+            return cellKey(static_cast<int64_t>(std::floor(x / cellSize_)), static_cast<int64_t>(std::floor(z / cellSize_)));
+        }
+
+        void ReplicationServer::insertIntoCell(EntityId id, Entity& entity) {
+            entity.cell = cellOf(entity.state);
+            auto& members = cells_[entity.cell];
+            entity.cellSlot = static_cast<uint32_t>(members.size());
+            members.push_back(id);
+        }
+
+        void ReplicationServer::removeFromCell(Entity& entity) {
+            auto cell = cells_.find(entity.cell);
+            auto& members = cell->second;
+            EntityId moved = members.back();
+            members[entity.cellSlot] = moved;
+            entities_.find(moved)->second.cellSlot = entity.cellSlot;
+            members.pop_back();
+            if (members.empty()) {
+                cells_.erase(cell);
+            }
+        }
+
+        EntityId ReplicationServer::spawnEntity(const EntityState& state) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            EntityId id = nextEntity_++;
+            Entity& entity = entities_[id];
+            entity.state = quantize(state, config_);
+            insertIntoCell(id, entity);
+            return id;
+        }
+
+        bool ReplicationServer::updateEntity(EntityId id, const EntityState& state) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entities_.find(id);
+            if (it == entities_.end()) {
+                return false;
+            }
+            Entity& entity = it->second;
+            entity.state = quantize(state, config_);
+            if (cellOf(entity.state) != entity.cell) {
+                removeFromCell(entity);
+                insertIntoCell(id, entity);
+            }
+            return true;
+        }
+
+        bool ReplicationServer::despawnEntity(EntityId id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entities_.find(id);
+            if (it == entities_.end()) {
+                return false;
+            }
+            removeFromCell(it->second);
+            entities_.erase(it);
+            return true;
+        }
+
+        std::optional<EntityState> ReplicationServer::getEntity(EntityId id) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entities_.find(id);
+            if (it == entities_.end()) {
+                return std::nullopt;
+            }
+            return dequantize(it->second.state, config_);
+        }
+
+        size_t ReplicationServer::entityCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return entities_.size();
+        }
+
+        ClientId ReplicationServer::addClient(EntityId viewer) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ClientId id = nextClient_++;
+            Client& client = clients_[id];
+            client.viewer = viewer;
+            client.frames.resize(std::max<uint32_t>(config_.historyTicks, 1));
+            return id;
+        }
+
+        void ReplicationServer::removeClient(ClientId client) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            clients_.erase(client);
+        }
+
+        size_t ReplicationServer::clientCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return clients_.size();
+        }
+
+        uint32_t ReplicationServer::currentTick() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return tick_;
+        }
+
+        uint32_t ReplicationServer::advanceTick() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return ++tick_;
+        }
+
+        void ReplicationServer::collectVisible(const Client& client, EntityList& out) const {
+            out.clear();
+            auto viewer = entities_.find(client.viewer);
+            if (viewer == entities_.end()) {
+                return;
+            }
+
+            const QuantizedState& centre = viewer->second.state;
+            const double resolution = config_.positionResolution;
+            const double radius = config_.interestRadius;
+            const double radiusSquared = radius * radius;
+            const int64_t cx = static_cast<int64_t>(std::floor(centre.position[0] * resolution / cellSize_));
+            const int64_t cz = static_cast<int64_t>(std::floor(centre.position[2] * resolution / cellSize_));
+
+            std::vector<std::pair<double, EntityId>> candidates;
+            for (int64_t dx = -1; dx <= 1; ++dx) {
+                for (int64_t dz = -1; dz <= 1; ++dz) {
+                    auto cell = cells_.find(cellKey(cx + dx, cz + dz));
+                    if (cell == cells_.end()) {
+                        continue;
+                    }
+                    for (EntityId id : cell->second) {
+                        const QuantizedState& state = entities_.find(id)->second.state;
+                        double distanceSquared = 0.0;
+                        for (int i = 0; i < 3; ++i) {
+                            double d = (static_cast<double>(state.position[i]) - centre.position[i]) * resolution;
+                            distanceSquared += d * d;
+                        }
+                        if (distanceSquared <= radiusSquared) {
+                            candidates.emplace_back(distanceSquared, id);
+                        }
+                    }
+                }
+            }
+
+            if (candidates.size() > config_.maxEntitiesPerSnapshot) {
+                std::nth_element(candidates.begin(), candidates.begin() + config_.maxEntitiesPerSnapshot, candidates.end());
+                candidates.resize(config_.maxEntitiesPerSnapshot);
+            }
+
+            out.reserve(candidates.size());
+            for (const auto& candidate : candidates) {
+                out.emplace_back(candidate.second, entities_.find(candidate.second)->second.state);
+            }
+            std::sort(out.begin(), out.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        }
+
+        std::string ReplicationServer::buildSnapshot(ClientId clientId) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = clients_.find(clientId);
+            if (it == clients_.end()) {
+                return {};
+            }
+            Client& client = it->second;
+            if (client.sentTick == tick_) {
+                return client.sent;
+            }
+
+            const uint32_t history = static_cast<uint32_t>(client.frames.size());
+            const Frame* baseline = nullptr;
+            if (client.ackedTick != 0 && tick_ - client.ackedTick < history &&
+                client.frames[client.ackedTick % history].tick == client.ackedTick) {
+                baseline = &client.frames[client.ackedTick % history];
+            }
+
+            EntityList visible;
+            collectVisible(client, visible);
+
+            // Merge the id-sorted baseline and visible sets into entries
+            static const EntityList EMPTY;
+            const EntityList& base = baseline ? baseline->entities : EMPTY;
+            SnapshotWriter entries;
+            size_t count = 0;
+            EntityId previous = 0;
+            auto writeEntry = [&](EntityId id, uint8_t mask, const QuantizedState& from, const QuantizedState& to) {
+                entries.writeVarint(id - previous);
+                entries.writeU8(mask);
+                writeFields(entries, mask, from, to);
+                previous = id;
+                ++count;
+            };
+
+            const QuantizedState zero;
+            size_t b = 0;
+            for (const auto& [id, state] : visible) {
+                while (b < base.size() && base[b].first < id) {
+                    writeEntry(base[b].first, ENTRY_REMOVED, zero, zero);
+                    ++b;
+                }
+                if (b < base.size() && base[b].first == id) {
+                    uint8_t mask = changedFields(base[b].second, state);
+                    if (mask != 0) {
+                        writeEntry(id, mask, base[b].second, state);
+                    }
+                    ++b;
+                } else {
+                    writeEntry(id, ENTRY_NEW | changedFields(zero, state), zero, state);
+                }
+            }
+            for (; b < base.size(); ++b) {
+                writeEntry(base[b].first, ENTRY_REMOVED, zero, zero);
+            }
+
+            SnapshotWriter message;
+            message.writeU8(MESSAGE_SNAPSHOT);
+            message.writeVarint(tick_);
+            message.writeVarint(baseline ? baseline->tick : 0);
+            message.writeVarint(count);
+            message.writeRaw(entries.data());
+
+            Frame& frame = client.frames[tick_ % history];
+            frame.tick = tick_;
+            frame.entities = std::move(visible);
+            client.sentTick = tick_;
+            client.sent = message.release();
+            return client.sent;
+        }
+
+        bool ReplicationServer::receive(ClientId clientId, std::string_view message) {
+            SnapshotReader in(message);
+            if (in.readU8() != MESSAGE_UPDATE) {
+                return false;
+            }
+            uint64_t ack = in.readVarint();
+            std::optional<QuantizedState> self;
+            if (in.readBool()) {
+                self = readFields(in, FIELD_POSITION | FIELD_YAW | FIELD_VELOCITY | FIELD_FLAGS, QuantizedState{});
+            }
+            if (!in.ok() || !in.atEnd()) {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = clients_.find(clientId);
+            if (it == clients_.end()) {
+                return false;
+            }
+            Client& client = it->second;
+            // Only ticks actually sent to this client can serve as baselines
+            if (ack > client.ackedTick && ack <= client.sentTick) {
+                client.ackedTick = static_cast<uint32_t>(ack);
+            }
+            if (self) {
+                auto viewer = entities_.find(client.viewer);
+                if (viewer != entities_.end()) {
+                    Entity& entity = viewer->second;
+                    entity.state = *self;
+                    if (cellOf(entity.state) != entity.cell) {
+                        removeFromCell(entity);
+                        insertIntoCell(client.viewer, entity);
+                    }
+                }
+            }
+            return true;
+        }
+
+        // ReplicationClient implementation
+        ReplicationClient::ReplicationClient(ReplicationConfig config)
+            : config_(config), frames_(std::max<uint32_t>(config.historyTicks, 1)) {
+        }
+
+        bool ReplicationClient::applySnapshot(std::string_view message) {
+            SnapshotReader in(message);
+            if (in.readU8() != MESSAGE_SNAPSHOT) {
+                return false;
+            }
+            uint64_t tick = in.readVarint();
+            uint64_t baseTick = in.readVarint();
+            size_t count = in.readCount(2);
+            if (!in.ok() || tick == 0 || tick > std::numeric_limits<uint32_t>::max() || baseTick >= tick) {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (tick <= latestTick_) {
+                return false;
+            }
+
+            const size_t history = frames_.size();
+            static const EntityList EMPTY;
+            const EntityList* base = &EMPTY;
+            if (baseTick != 0) {
+                const Frame& frame = frames_[baseTick % history];
+                if (frame.tick != baseTick) {
+                    return false;
+                }
+                base = &frame.entities;
+            }
+
+            EntityList entities;
+            entities.reserve(base->size() + count);
+            const QuantizedState zero;
+            size_t b = 0;
+            EntityId id = 0;
+            for (size_t i = 0; i < count && in.ok(); ++i) {
+                uint64_t next = id + in.readVarint();
+                uint8_t mask = in.readU8();
+                if (next > std::numeric_limits<EntityId>::max() || (i > 0 && next == id) || (mask & ~ENTRY_MASK) != 0) {
+                    in.fail();
+                    break;
+                }
+                id = static_cast<EntityId>(next);
+
+                while (b < base->size() && (*base)[b].first < id) {
+                    entities.push_back((*base)[b++]);
+                }
+                const QuantizedState* previous = nullptr;
+                if (b < base->size() && (*base)[b].first == id) {
+                    previous = &(*base)[b++].second;
+                }
+
+                if (mask & ENTRY_REMOVED) {
+                    continue;
+                }
+                if (mask & ENTRY_NEW) {
+                    entities.emplace_back(id, readFields(in, mask, zero));
+                } else if (previous) {
+                    entities.emplace_back(id, readFields(in, mask, *previous));
+                } else {
+                    in.fail();
+                }
+            }
+            if (!in.ok() || !in.atEnd()) {
+                return false;
+            }
+            entities.insert(entities.end(), base->begin() + b, base->end());
+
+            Frame& frame = frames_[tick % history];
+            frame.tick = static_cast<uint32_t>(tick);
+            frame.entities = std::move(entities);
+            latestTick_ = static_cast<uint32_t>(tick);
+            return true;
+        }
+
+        std::string ReplicationClient::buildUpdate(const std::optional<EntityState>& self) const {
+            SnapshotWriter out;
+            out.writeU8(MESSAGE_UPDATE);
+            out.writeVarint(latestTick());
+            out.writeBool(self.has_value());
+            if (self) {
+                writeFields(out, FIELD_POSITION | FIELD_YAW | FIELD_VELOCITY | FIELD_FLAGS, QuantizedState{},
+                            quantize(*self, config_));
+            }
+            return out.release();
+        }
+
+        uint32_t ReplicationClient::latestTick() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return latestTick_;
+        }
+
+        std::optional<EntityState> ReplicationClient::getEntity(EntityId id) const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (latestTick_ == 0) {
+                return std::nullopt;
+            }
+            const QuantizedState* state = findEntity(frames_[latestTick_ % frames_.size()].entities, id);
+            if (!state) {
+                return std::nullopt;
+            }
+            return dequantize(*state, config_);
+        }
+
+        std::vector<ReplicatedEntity> ReplicationClient::getEntities() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<ReplicatedEntity> result;
+            if (latestTick_ == 0) {
+                return result;
+            }
+            const auto& entities = frames_[latestTick_ % frames_.size()].entities;
+            result.reserve(entities.size());
+            for (const auto& [id, state] : entities) {
+                result.push_back({id, dequantize(state, config_)});
+            }
+            return result;
+        }
+
+        size_t ReplicationClient::entityCount() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return latestTick_ == 0 ? 0 : frames_[latestTick_ % frames_.size()].entities.size();
+        }
+
+        void ReplicationClient::reset() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (auto& frame : frames_) {
+                frame.tick = 0;
+                frame.entities.clear();
+            }
+            latestTick_ = 0;
+        }
+
+        // LoopbackChannel implementation
+        void LoopbackChannel::send(std::string message) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++messages_;
+            bytes_ += message.size();
+            if (dropEvery_ != 0 && messages_ % dropEvery_ == 0) {
+                return;
+            }
+            queue_.push_back(std::move(message));
+        }
+
+        std::optional<std::string> LoopbackChannel::receive() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (queue_.empty()) {
+                return std::nullopt;
+            }
+            std::string message = std::move(queue_.front());
+            queue_.pop_front();
+            return message;
+        }
+
+        void LoopbackChannel::setDropEvery(size_t n) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            dropEvery_ = n;
+        }
+
+        size_t LoopbackChannel::pending() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return queue_.size();
+        }
+
+        size_t LoopbackChannel::messagesSent() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return messages_;
+        }
+
+        size_t LoopbackChannel::bytesSent() const {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return bytes_;
+        }
+
+    } // namespace hyperfy
+} // namespace elizaos
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 #include "elizaos/eliza_3d_hyperfy_starter.hpp"
+#include <cmath>
+#include <random>
 
 using namespace elizaos::hyperfy;
 
@@ -117,4 +119,203 @@ TEST(HyperfyWorldTest, BasicFunctionality) {
     
     world.disconnect();
     EXPECT_FALSE(world.isConnected());
-}
\ No newline at end of file
+}
+namespace {
+
+// Pumps one server tick: snapshot down, acknowledgement (and viewer state) up
+void pump(ReplicationServer& server, ClientId client, HyperfyWorld& world,
+          LoopbackChannel& down, LoopbackChannel& up) {
+    down.send(server.buildSnapshot(client));
+    while (auto message = down.receive()) {
+        world.applySnapshot(*message);
+    }
+    up.send(world.buildUpdate());
+    while (auto message = up.receive()) {
+        server.receive(client, *message);
+    }
+    server.advanceTick();
+}
+
+EntityState at(float x, float y, float z) {
+    EntityState state;
+    state.position = {x, y, z};
+    return state;
+}
+
+} // anonymous namespace
+
+TEST(HyperfyReplicationTest, QuantizationRoundTrip) {
+    ReplicationConfig config;
+    EntityState state;
+    state.position = {12.3456f, -0.5f, 1000.001f};
+    state.yaw = -3.0f;
+    state.velocity = {1.5f, 0.0f, -2.25f};
+    state.flags = ENTITY_GROUNDED | ENTITY_MOVING;
+
+    EntityState back = dequantize(quantize(state, config), config);
+    EXPECT_NEAR(back.position.x, state.position.x, config.positionResolution);
+    EXPECT_NEAR(back.position.y, state.position.y, config.positionResolution);
+    EXPECT_NEAR(back.position.z, state.position.z, config.positionResolution);
+    EXPECT_NEAR(back.yaw, state.yaw, 1e-3);
+    EXPECT_NEAR(back.velocity.z, state.velocity.z, config.velocityResolution);
+    EXPECT_EQ(back.flags, state.flags);
+
+    // A full turn further quantizes the same
+    state.yaw += 6.283185307f;
+    EXPECT_EQ(quantize(state, config).yaw, quantize(back, config).yaw);
+}
+
+TEST(HyperfyReplicationTest, DeltaSnapshotsOverLoopback) {
+    ReplicationServer server;
+    EntityId self = server.spawnEntity(at(0, 0, 0));
+    EntityId walker = server.spawnEntity(at(5, 0, 5));
+    for (int i = 0; i < 20; ++i) {
+        server.spawnEntity(at(static_cast<float>(i), 0, -10));
+    }
+    ClientId client = server.addClient(self);
+
+    HyperfyWorld world("test-world", "ws://test.example.com");
+    LoopbackChannel down, up;
+
+    pump(server, client, world, down, up);
+    size_t fullBytes = down.bytesSent();
+    EXPECT_EQ(world.getVisibleEntities().size(), 22u);
+
+    // Nothing changed: the snapshot only carries its header
+    size_t before = down.bytesSent();
+    pump(server, client, world, down, up);
+    size_t idleBytes = down.bytesSent() - before;
+    EXPECT_LE(idleBytes, 8u);
+
+    // One entity moves: one small entry
+    EntityState moved = at(5.5f, 0, 5);
+    moved.velocity = {0.5f, 0, 0};
+    moved.flags = ENTITY_MOVING;
+    server.updateEntity(walker, moved);
+    before = down.bytesSent();
+    pump(server, client, world, down, up);
+    size_t deltaBytes = down.bytesSent() - before;
+    EXPECT_LT(deltaBytes, 24u);
+    EXPECT_LT(deltaBytes * 10, fullBytes);
+
+    auto seen = world.getEntity(walker);
+    ASSERT_TRUE(seen.has_value());
+    EXPECT_NEAR(seen->position.x, 5.5f, 0.01f);
+    EXPECT_NEAR(seen->velocity.x, 0.5f, 0.02f);
+    EXPECT_EQ(seen->flags, static_cast<uint32_t>(ENTITY_MOVING));
+
+    // Despawns reach the client
+    server.despawnEntity(walker);
+    pump(server, client, world, down, up);
+    EXPECT_FALSE(world.getEntity(walker).has_value());
+    EXPECT_EQ(world.getVisibleEntities().size(), 21u);
+}
+
+TEST(HyperfyReplicationTest, InterestFollowsViewer) {
+    ReplicationConfig config;
+    config.interestRadius = 20.0f;
+    ReplicationServer server(config);
+    EntityId self = server.spawnEntity(at(0, 0, 0));
+    EntityId near = server.spawnEntity(at(10, 0, 0));
+    EntityId far = server.spawnEntity(at(100, 0, 0));
+    ClientId client = server.addClient(self);
+
+    HyperfyWorld world("test-world", "ws://test.example.com", config);
+    world.connect();
+    LoopbackChannel down, up;
+
+    pump(server, client, world, down, up);
+    EXPECT_TRUE(world.getEntity(near).has_value());
+    EXPECT_FALSE(world.getEntity(far).has_value());
+
+    // The agent walks over; its own update moves its viewer on the server
+    EXPECT_TRUE(world.moveToPosition(95.0, 0.0, 0.0));
+    pump(server, client, world, down, up);
+    pump(server, client, world, down, up);
+    EXPECT_NEAR(server.getEntity(self)->position.x, 95.0f, 0.01f);
+    EXPECT_TRUE(world.getEntity(far).has_value());
+    EXPECT_FALSE(world.getEntity(near).has_value());
+    EXPECT_NEAR(world.getEntity(self)->position.x, 95.0f, 0.01f);
+}
+
+TEST(HyperfyReplicationTest, RecoversFromLostMessages) {
+    ReplicationServer server;
+    EntityId self = server.spawnEntity(at(0, 0, 0));
+    std::vector<EntityId> movers;
+    for (int i = 0; i < 10; ++i) {
+        movers.push_back(server.spawnEntity(at(static_cast<float>(i), 0, 0)));
+    }
+    ClientId client = server.addClient(self);
+
+    HyperfyWorld world("test-world", "ws://test.example.com");
+    LoopbackChannel down, up;
+    down.setDropEvery(3);
+    up.setDropEvery(4);
+
+    for (int tick = 0; tick < 50; ++tick) {
+        for (size_t i = 0; i < movers.size(); ++i) {
+            EntityState state = at(static_cast<float>(i), 0, tick * 0.25f);
+            state.yaw = tick * 0.1f;
+            server.updateEntity(movers[i], state);
+        }
+        pump(server, client, world, down, up);
+    }
+    down.setDropEvery(0);
+    pump(server, client, world, down, up);
+
+    for (EntityId id : movers) {
+        auto expected = server.getEntity(id);
+        auto seen = world.getEntity(id);
+        ASSERT_TRUE(seen.has_value());
+        EXPECT_NEAR(seen->position.z, expected->position.z, 0.01f);
+        EXPECT_NEAR(seen->yaw, expected->yaw, 1e-3);
+    }
+
+    // Malformed and stale snapshots leave the mirror alone
+    EXPECT_FALSE(world.applySnapshot("\x01\x05"));
+    std::string latest = server.buildSnapshot(client);
+    EXPECT_TRUE(world.applySnapshot(latest));
+    EXPECT_FALSE(world.applySnapshot(latest));
+    EXPECT_EQ(world.getVisibleEntities().size(), 11u);
+}
+
+TEST(HyperfyReplicationTest, SnapshotCostFlatAsPopulationGrows) {
+    // Same density over a larger area: a client sees as many entities, and
+    // only their sparser ids cost slightly longer varints
+    auto steadyStateBytes = [](int population) {
+        ReplicationConfig config;
+        config.interestRadius = 16.0f;
+        ReplicationServer server(config);
+        float side = std::sqrt(static_cast<float>(population)) * 4.0f;
+        EntityId self = server.spawnEntity(at(side / 2, 0, side / 2));
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> coordinate(0.0f, side);
+        std::vector<EntityId> entities;
+        for (int i = 0; i < population; ++i) {
+            float x = coordinate(rng);
+            entities.push_back(server.spawnEntity(at(x, 0, coordinate(rng))));
+        }
+        ClientId client = server.addClient(self);
+        HyperfyWorld world("test-world", "ws://test.example.com", config);
+        LoopbackChannel down, up;
+        pump(server, client, world, down, up);
+
+        size_t before = down.bytesSent();
+        for (int tick = 0; tick < 10; ++tick) {
+            // Everything drifts each tick
+            for (EntityId id : entities) {
+                auto state = server.getEntity(id);
+                state->position.y += 0.05f;
+                server.updateEntity(id, *state);
+            }
+            pump(server, client, world, down, up);
+        }
+        return down.bytesSent() - before;
+    };
+
+    size_t small = steadyStateBytes(1000);
+    size_t large = steadyStateBytes(16000);
+    EXPECT_GT(small, 0u);
+    EXPECT_LT(large, small * 3 / 2);
+    EXPECT_GT(large, small * 2 / 3);
+}
@@ -151,7 +151,7 @@ void ElizaStarterAgent::addMemory(const std::string& content, const std::string&
         metadata.scope = MemoryScope::SHARED;
         metadata.tags = {"conversation", "starter"};
         
-        auto memory = std::make_shared<Memory>(
+        auto memory = makeMemory(
             "mem-" + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()),
             content,
             userId,
@@ -173,7 +173,7 @@ void ElizaStarterAgent::addMemory(const std::string& content, const std::string&
 std::vector<std::shared_ptr<Memory>> ElizaStarterAgent::getRecentMemories(size_t count) {
     auto recent = state_->getRecentMessages();
     if (recent.size() <= count) {
-        return recent;
+        return recent.toVector();
     }
     
     // Return the most recent 'count' memories
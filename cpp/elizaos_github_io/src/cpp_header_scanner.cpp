@@ -0,0 +1,865 @@
+#include "elizaos/cpp_header_scanner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+
+namespace elizaos {
+
+std::string declarationKindToString(DeclarationKind kind) {
+    switch (kind) {
+        case DeclarationKind::CLASS: return "class";
+        case DeclarationKind::STRUCT: return "struct";
+        case DeclarationKind::UNION: return "union";
+        case DeclarationKind::ENUM: return "enum";
+        case DeclarationKind::FUNCTION: return "function";
+        case DeclarationKind::VARIABLE: return "variable";
+        case DeclarationKind::TYPE_ALIAS: return "type alias";
+    }
+    return "unknown";
+}
+
+namespace {
+
+enum class TokenType { IDENTIFIER, NUMBER, STRING, PUNCT, DOC_COMMENT };
+
+struct Token {
+    TokenType type;
+    std::string_view text;
+    size_t line;
+    bool trailing_doc = false;  // ///< style comment documenting the previous declaration
+
+    bool is(std::string_view value) const {
+        return (type == TokenType::PUNCT || type == TokenType::IDENTIFIER) && text == value;
+    }
+};
+
+bool isIdentStart(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isIdentChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+bool isStringPrefix(std::string_view ident) {
+    return ident == "L" || ident == "u" || ident == "U" || ident == "u8" || ident == "R" ||
+           ident == "LR" || ident == "uR" || ident == "UR" || ident == "u8R";
+}
+
+/**
+ * Single-pass tokenizer. Comments other than doc comments, whitespace and
+ * preprocessor lines never reach the parser.
+ */
+class Lexer {
+public:
+    explicit Lexer(std::string_view source) : src_(source) {}
+
+    std::vector<Token> tokenize() {
+        std::vector<Token> tokens;
+        tokens.reserve(src_.size() / 6);
+        bool line_start = true;
+
+        while (pos_ < src_.size()) {
+            char c = src_[pos_];
+
+            if (c == '\n') {
+                ++line_;
+                ++pos_;
+                line_start = true;
+                continue;
+            }
+            if (std::isspace(static_cast<unsigned char>(c))) {
+                ++pos_;
+                continue;
+            }
+            if (c == '#' && line_start) {
+                skipPreprocessorLine();
+                continue;
+            }
+            line_start = false;
+
+            if (c == '/' && peek(1) == '/') {
+                lexLineComment(tokens);
+            } else if (c == '/' && peek(1) == '*') {
+                lexBlockComment(tokens);
+            } else if (c == '"') {
+                lexString(tokens, pos_, false);
+            } else if (c == '\'') {
+                lexCharLiteral(tokens);
+            } else if (isIdentStart(c)) {
+                size_t start = pos_;
+                while (pos_ < src_.size() && isIdentChar(src_[pos_])) ++pos_;
+                std::string_view ident = src_.substr(start, pos_ - start);
+                if (pos_ < src_.size() && src_[pos_] == '"' && isStringPrefix(ident)) {
+                    lexString(tokens, start, ident.back() == 'R');
+                } else if (pos_ < src_.size() && src_[pos_] == '\'' && isStringPrefix(ident)) {
+                    lexCharLiteral(tokens);
+                } else {
+                    tokens.push_back({TokenType::IDENTIFIER, ident, line_});
+                }
+            } else if (std::isdigit(static_cast<unsigned char>(c)) ||
+                       (c == '.' && std::isdigit(static_cast<unsigned char>(peek(1))))) {
+                lexNumber(tokens);
+            } else {
+                lexPunct(tokens);
+            }
+        }
+        return tokens;
+    }
+
+private:
+    std::string_view src_;
+    size_t pos_ = 0;
+    size_t line_ = 1;
+
+    char peek(size_t offset) const {
+        return pos_ + offset < src_.size() ? src_[pos_ + offset] : '\0';
+    }
+
+    void skipPreprocessorLine() {
+        while (pos_ < src_.size() && src_[pos_] != '\n') {
+            if (src_[pos_] == '\\' && peek(1) == '\n') {
+                pos_ += 2;
+                ++line_;
+            } else if (src_[pos_] == '/' && peek(1) == '*') {
+                // Block comments may span lines inside a directive
+                pos_ += 2;
+                while (pos_ < src_.size() && !(src_[pos_] == '*' && peek(1) == '/')) {
+                    if (src_[pos_] == '\n') ++line_;
+                    ++pos_;
+                }
+                pos_ = std::min(src_.size(), pos_ + 2);
+            } else {
+                ++pos_;
+            }
+        }
+    }
+
+    void lexLineComment(std::vector<Token>& tokens) {
+        size_t start = pos_;
+        size_t line = line_;
+        while (pos_ < src_.size() && src_[pos_] != '\n') ++pos_;
+        std::string_view text = src_.substr(start, pos_ - start);
+
+        bool doc = (text.size() >= 3 && text[2] == '/' && (text.size() == 3 || text[3] != '/')) ||
+                   (text.size() >= 3 && text[2] == '!');
+        if (doc) {
+            Token token{TokenType::DOC_COMMENT, text, line};
+            token.trailing_doc = text.size() >= 4 && text[3] == '<';
+            tokens.push_back(token);
+        }
+    }
+
+    void lexBlockComment(std::vector<Token>& tokens) {
+        size_t start = pos_;
+        size_t line = line_;
+        pos_ += 2;
+        while (pos_ < src_.size() && !(src_[pos_] == '*' && peek(1) == '/')) {
+            if (src_[pos_] == '\n') ++line_;
+            ++pos_;
+        }
+        pos_ = std::min(src_.size(), pos_ + 2);
+        std::string_view text = src_.substr(start, pos_ - start);
+
+        bool doc = text.size() > 4 && ((text[2] == '*' && text[3] != '/' && text[3] != '*') || text[2] == '!');
+        if (doc) {
+            Token token{TokenType::DOC_COMMENT, text, line};
+            token.trailing_doc = text[3] == '<';
+            tokens.push_back(token);
+        }
+    }
+
+    void lexString(std::vector<Token>& tokens, size_t start, bool raw) {
+        size_t line = line_;
+        ++pos_;  // opening quote
+        if (raw) {
+            size_t delim_start = pos_;
+            while (pos_ < src_.size() && src_[pos_] != '(') ++pos_;
+            std::string terminator = ")" + std::string(src_.substr(delim_start, pos_ - delim_start)) + "\"";
+            size_t end = src_.find(terminator, pos_);
+            end = end == std::string_view::npos ? src_.size() : end + terminator.size();
+            line_ += static_cast<size_t>(std::count(src_.begin() + static_cast<std::ptrdiff_t>(pos_),
+                                                    src_.begin() + static_cast<std::ptrdiff_t>(end), '\n'));
+            pos_ = end;
+        } else {
+            while (pos_ < src_.size() && src_[pos_] != '"' && src_[pos_] != '\n') {
+                pos_ += src_[pos_] == '\\' ? 2 : 1;
+            }
+            pos_ = std::min(src_.size(), pos_ + 1);
+        }
+        tokens.push_back({TokenType::STRING, src_.substr(start, pos_ - start), line});
+    }
+
+    void lexCharLiteral(std::vector<Token>& tokens) {
+        size_t start = pos_;
+        ++pos_;
+        while (pos_ < src_.size() && src_[pos_] != '\'' && src_[pos_] != '\n') {
+            pos_ += src_[pos_] == '\\' ? 2 : 1;
+        }
+        pos_ = std::min(src_.size(), pos_ + 1);
+        tokens.push_back({TokenType::STRING, src_.substr(start, pos_ - start), line_});
+    }
+
+    void lexNumber(std::vector<Token>& tokens) {
+        size_t start = pos_;
+        while (pos_ < src_.size()) {
+            char c = src_[pos_];
+            if (isIdentChar(c) || c == '.') {
+                ++pos_;
+            } else if (c == '\'' && isIdentChar(peek(1))) {
+                pos_ += 2;  // digit separator
+            } else if ((c == '+' || c == '-') && pos_ > start &&
+                       std::strchr("eEpP", src_[pos_ - 1]) != nullptr) {
+                ++pos_;
+            } else {
+                break;
+            }
+        }
+        tokens.push_back({TokenType::NUMBER, src_.substr(start, pos_ - start), line_});
+    }
+
+    void lexPunct(std::vector<Token>& tokens) {
+        size_t length = 1;
+        char c = src_[pos_];
+        if ((c == ':' && peek(1) == ':') || (c == '-' && peek(1) == '>') || (c == '&' && peek(1) == '&')) {
+            length = 2;
+        } else if (c == '.' && peek(1) == '.' && peek(2) == '.') {
+            length = 3;
+        }
+        tokens.push_back({TokenType::PUNCT, src_.substr(pos_, length), line_});
+        pos_ += length;
+    }
+};
+
+std::string cleanDocComment(std::string_view raw) {
+    std::string text(raw);
+    bool block = text.rfind("/*", 0) == 0;
+    if (block) {
+        text = text.substr(3, text.size() >= 5 ? text.size() - 5 : 0);
+    }
+
+    std::istringstream stream(text);
+    std::string line;
+    std::string result;
+    while (std::getline(stream, line)) {
+        size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos) {
+            if (!result.empty()) result += "\n";
+            continue;
+        }
+        line = line.substr(start);
+        if (!block) {
+            line = line.substr(std::min<size_t>(3, line.size()));  // ///, //!
+        } else if (line[0] == '*') {
+            line = line.substr(1);
+        }
+        if (!line.empty() && line[0] == '<') {
+            line = line.substr(1);
+        }
+        size_t first = line.find_first_not_of(" \t");
+        size_t last = line.find_last_not_of(" \t\r");
+        if (first == std::string::npos) {
+            if (!result.empty()) result += "\n";
+            continue;
+        }
+        if (!result.empty() && result.back() != '\n') result += "\n";
+        result += line.substr(first, last - first + 1);
+    }
+    while (!result.empty() && result.back() == '\n') result.pop_back();
+    return result;
+}
+
+bool needsSpace(std::string_view prev, std::string_view cur) {
+    static const std::unordered_set<std::string_view> no_space_after = {"(", "[", "<", "::", "~", "!", "."};
+    static const std::unordered_set<std::string_view> no_space_before = {
+        ")", "]", ",", ";", "(", "<", ">", "::", "[", ".", "&", "*", "&&", "..."};
+    if (no_space_after.count(prev) || no_space_before.count(cur)) {
+        return false;
+    }
+    return true;
+}
+
+std::string joinTokens(const std::vector<Token>& tokens, size_t begin, size_t end) {
+    std::string out;
+    for (size_t i = begin; i < end; ++i) {
+        if (tokens[i].type == TokenType::DOC_COMMENT) continue;
+        if (!out.empty() && needsSpace(tokens[i - 1].text, tokens[i].text)) {
+            out += ' ';
+        }
+        out.append(tokens[i].text);
+    }
+    return out;
+}
+
+/**
+ * Statement-level parser over the token stream. Tracks namespace and class
+ * scopes, skips function bodies and initializers by brace matching.
+ */
+class DeclarationParser {
+public:
+    DeclarationParser(const std::vector<Token>& tokens, std::vector<ScannedDeclaration>& out)
+        : tokens_(tokens), out_(out) {}
+
+    void parse() {
+        while (i_ < tokens_.size()) {
+            const Token& tok = tokens_[i_];
+
+            if (tok.type == TokenType::DOC_COMMENT) {
+                handleDoc(tok);
+                ++i_;
+                continue;
+            }
+            if (tok.is("}")) {
+                if (!scopes_.empty()) scopes_.pop_back();
+                pending_doc_.clear();
+                ++i_;
+                continue;
+            }
+            if (tok.is(";")) {
+                pending_doc_.clear();
+                ++i_;
+                continue;
+            }
+            if (inClass() && (tok.is("public") || tok.is("protected") || tok.is("private")) &&
+                at(i_ + 1).is(":")) {
+                scopes_.back().access = std::string(tok.text);
+                i_ += 2;
+                continue;
+            }
+            if (tok.is("namespace")) {
+                parseNamespace();
+                continue;
+            }
+            if (tok.is("extern") && at(i_ + 1).type == TokenType::STRING && at(i_ + 2).is("{")) {
+                scopes_.push_back({Scope::BLOCK, "", ""});
+                i_ += 3;
+                continue;
+            }
+            parseStatement();
+        }
+    }
+
+private:
+    struct Scope {
+        enum Type { NAMESPACE, CLASS, BLOCK } type;
+        std::string name;
+        std::string access;
+    };
+
+    const std::vector<Token>& tokens_;
+    std::vector<ScannedDeclaration>& out_;
+    std::vector<Scope> scopes_;
+    size_t i_ = 0;
+    std::string pending_doc_;
+    size_t pending_doc_line_ = 0;
+
+    const Token& at(size_t index) const {
+        static const Token sentinel{TokenType::PUNCT, "", 0};
+        return index < tokens_.size() ? tokens_[index] : sentinel;
+    }
+
+    bool inClass() const { return !scopes_.empty() && scopes_.back().type == Scope::CLASS; }
+
+    std::string currentScope() const {
+        std::string scope;
+        for (const auto& s : scopes_) {
+            if (s.name.empty()) continue;
+            if (!scope.empty()) scope += "::";
+            scope += s.name;
+        }
+        return scope;
+    }
+
+    void handleDoc(const Token& tok) {
+        if (tok.trailing_doc) {
+            if (!out_.empty() && out_.back().line == tok.line) {
+                out_.back().doc_comment = cleanDocComment(tok.text);
+            }
+            return;
+        }
+        // Consecutive /// lines form one comment; anything else restarts it
+        if (!pending_doc_.empty() && pending_doc_line_ + 1 == tok.line && tok.text.rfind("//", 0) == 0) {
+            pending_doc_ += "\n" + cleanDocComment(tok.text);
+        } else {
+            pending_doc_ = cleanDocComment(tok.text);
+        }
+        pending_doc_line_ = tok.line;
+    }
+
+    size_t skipBalanced(size_t index, std::string_view open, std::string_view close) const {
+        int depth = 0;
+        for (; index < tokens_.size(); ++index) {
+            if (tokens_[index].is(open)) {
+                ++depth;
+            } else if (tokens_[index].is(close) && --depth == 0) {
+                return index + 1;
+            }
+        }
+        return index;
+    }
+
+    void parseNamespace() {
+        size_t j = i_ + 1;
+        std::string name;
+        while (j < tokens_.size() && !tokens_[j].is("{") && !tokens_[j].is(";") && !tokens_[j].is("=")) {
+            if (tokens_[j].type == TokenType::IDENTIFIER && !tokens_[j].is("inline")) {
+                if (!name.empty()) name += "::";
+                name += std::string(tokens_[j].text);
+            }
+            ++j;
+        }
+        if (at(j).is("{")) {
+            scopes_.push_back({Scope::NAMESPACE, name, ""});
+            i_ = j + 1;
+        } else {
+            // Namespace alias
+            while (j < tokens_.size() && !tokens_[j].is(";")) ++j;
+            i_ = j + 1;
+        }
+        pending_doc_.clear();
+    }
+
+    void parseStatement() {
+        std::string doc = std::move(pending_doc_);
+        pending_doc_.clear();
+        size_t start = i_;
+
+        // template<...> prefix
+        std::string template_prefix;
+        while (at(i_).is("template") && at(i_ + 1).is("<")) {
+            size_t end = skipAngles(i_ + 1);
+            template_prefix += joinTokens(tokens_, i_, end) + " ";
+            i_ = end;
+        }
+        size_t decl_start = i_;
+
+        // Collect tokens up to ';' or '{' at nesting level zero
+        int nest = 0;
+        int angles = 0;
+        bool seen_params = false;
+        bool in_init_list = false;
+        size_t init_list_start = 0;
+        size_t first_paren = SIZE_MAX;
+        size_t first_equals = SIZE_MAX;
+
+        while (i_ < tokens_.size()) {
+            const Token& tok = tokens_[i_];
+            if (tok.type == TokenType::DOC_COMMENT) {
+                ++i_;
+                continue;
+            }
+            if (nest == 0 && tok.is("operator")) {
+                // Operator names (operator==, operator(), operator[]) must not look like '=' or '('
+                ++i_;
+                if ((at(i_).is("(") && at(i_ + 1).is(")")) || (at(i_).is("[") && at(i_ + 1).is("]"))) {
+                    i_ += 2;
+                } else {
+                    while (i_ < tokens_.size() && tokens_[i_].type == TokenType::PUNCT && !tokens_[i_].is("(")) ++i_;
+                }
+                continue;
+            }
+            if (nest == 0 && first_equals == SIZE_MAX && tok.is("<") && i_ > decl_start &&
+                tokens_[i_ - 1].type == TokenType::IDENTIFIER && !tokens_[i_ - 1].is("operator")) {
+                ++angles;  // template argument list, e.g. std::function<void(int)>
+            } else if (nest == 0 && angles > 0 && tok.is(">")) {
+                --angles;
+            }
+            if (tok.is("(") || tok.is("[")) {
+                if (nest == 0 && angles == 0 && tok.is("(") && first_paren == SIZE_MAX &&
+                    first_equals == SIZE_MAX) {
+                    first_paren = i_;
+                }
+                ++nest;
+            } else if (tok.is(")") || tok.is("]")) {
+                nest = std::max(0, nest - 1);
+                if (nest == 0 && tok.is(")") && first_paren != SIZE_MAX) seen_params = true;
+            } else if (nest > 0 && tok.is("{")) {
+                i_ = skipBalanced(i_, "{", "}");
+                continue;
+            } else if (nest == 0) {
+                if (tok.is(";")) break;
+                if (tok.is("}")) break;  // malformed input; let the caller close the scope
+                if (tok.is("=") && first_equals == SIZE_MAX) first_equals = i_;
+                if (tok.is(":") && seen_params && !in_init_list && !isClassHead(decl_start, i_)) {
+                    in_init_list = true;
+                    init_list_start = i_;
+                }
+                if (tok.is("{")) {
+                    const Token& prev = at(i_ - 1);
+                    bool member_init = in_init_list && (prev.type == TokenType::IDENTIFIER || prev.is(">"));
+                    if (member_init) {
+                        i_ = skipBalanced(i_, "{", "}");
+                        continue;
+                    }
+                    break;
+                }
+            }
+            ++i_;
+        }
+
+        size_t end = i_;
+        bool has_body = at(end).is("{");
+        std::vector<Token> stmt(tokens_.begin() + static_cast<std::ptrdiff_t>(decl_start),
+                                tokens_.begin() + static_cast<std::ptrdiff_t>(end));
+        size_t sig_end = in_init_list ? init_list_start : end;
+
+        if (stmt.empty()) {
+            if (at(i_).is("{")) {
+                scopes_.push_back({Scope::BLOCK, "", ""});  // bare block
+                ++i_;
+            } else if (at(i_).is(";") || i_ == start) {
+                ++i_;
+            }
+            return;
+        }
+
+        // Type definitions open a scope (or, for enums, are skipped whole)
+        size_t key_index = findClassKey(stmt, first_paren == SIZE_MAX ? stmt.size() : first_paren - decl_start);
+        if (has_body && key_index != SIZE_MAX && first_equals == SIZE_MAX) {
+            DeclarationKind kind = classKind(stmt[key_index].text);
+            std::string name = typeName(stmt, key_index);
+            if (!name.empty()) {
+                record(kind, name, template_prefix + joinTokens(tokens_, decl_start, end), doc, stmt[key_index].line);
+            }
+            if (kind == DeclarationKind::ENUM) {
+                i_ = skipBalanced(end, "{", "}");
+            } else {
+                scopes_.push_back({Scope::CLASS, name, kind == DeclarationKind::CLASS ? "private" : "public"});
+                i_ = end + 1;
+            }
+            return;
+        }
+
+        // Function bodies and brace initializers are skipped
+        if (has_body) {
+            i_ = skipBalanced(end, "{", "}");
+            if (first_paren == SIZE_MAX || first_equals != SIZE_MAX) {
+                // Initializer braces: the declaration continues to ';'
+                while (i_ < tokens_.size() && !tokens_[i_].is(";") && !tokens_[i_].is("}")) ++i_;
+            }
+        }
+        if (at(i_).is(";")) ++i_;
+
+        classifyStatement(stmt, decl_start, sig_end, first_paren, first_equals, template_prefix, doc);
+    }
+
+    size_t skipAngles(size_t index) const {
+        int depth = 0;
+        int parens = 0;
+        for (; index < tokens_.size(); ++index) {
+            const Token& tok = tokens_[index];
+            if (tok.is("(")) ++parens;
+            else if (tok.is(")")) --parens;
+            else if (parens == 0 && tok.is("<")) ++depth;
+            else if (parens == 0 && tok.is(">") && --depth == 0) return index + 1;
+        }
+        return index;
+    }
+
+    bool isClassHead(size_t begin, size_t end) const {
+        for (size_t k = begin; k < end; ++k) {
+            if (tokens_[k].is("(")) return false;
+            if (tokens_[k].is("class") || tokens_[k].is("struct") || tokens_[k].is("union") ||
+                tokens_[k].is("enum")) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static size_t findClassKey(const std::vector<Token>& stmt, size_t limit) {
+        for (size_t k = 0; k < std::min(limit, stmt.size()); ++k) {
+            if (stmt[k].is("class") || stmt[k].is("struct") || stmt[k].is("union") || stmt[k].is("enum")) {
+                return k;
+            }
+            if (stmt[k].is("friend") || stmt[k].is("typedef") || stmt[k].is("using")) {
+                return SIZE_MAX;
+            }
+        }
+        return SIZE_MAX;
+    }
+
+    static DeclarationKind classKind(std::string_view key) {
+        if (key == "class") return DeclarationKind::CLASS;
+        if (key == "struct") return DeclarationKind::STRUCT;
+        if (key == "union") return DeclarationKind::UNION;
+        return DeclarationKind::ENUM;
+    }
+
+    static std::string typeName(const std::vector<Token>& stmt, size_t key_index) {
+        std::string name;
+        size_t k = key_index + 1;
+        if (stmt[key_index].is("enum") && k < stmt.size() && (stmt[k].is("class") || stmt[k].is("struct"))) {
+            ++k;
+        }
+        for (; k < stmt.size(); ++k) {
+            const Token& tok = stmt[k];
+            if (tok.is(":") || tok.is("{")) break;
+            if (tok.is("(")) {
+                // alignas(...) / __attribute__((...))
+                int depth = 0;
+                for (; k < stmt.size(); ++k) {
+                    if (stmt[k].is("(")) ++depth;
+                    else if (stmt[k].is(")") && --depth == 0) break;
+                }
+                continue;
+            }
+            if (tok.is("[")) {
+                while (k < stmt.size() && !stmt[k].is("]")) ++k;
+                continue;
+            }
+            if (tok.type == TokenType::IDENTIFIER && tok.text != "final" && tok.text != "alignas" &&
+                tok.text != "__attribute__") {
+                name = std::string(tok.text);
+            }
+        }
+        return name;
+    }
+
+    void classifyStatement(const std::vector<Token>& stmt, size_t decl_start, size_t sig_end,
+                           size_t first_paren, size_t first_equals, const std::string& template_prefix,
+                           const std::string& doc) {
+        const Token& head = stmt.front();
+        if (head.is("friend") || head.is("static_assert") || head.is("return")) {
+            return;
+        }
+
+        std::string signature = template_prefix + joinTokens(tokens_, decl_start, sig_end);
+
+        if (head.is("using")) {
+            if (stmt.size() >= 3 && stmt[1].type == TokenType::IDENTIFIER && stmt[2].is("=")) {
+                record(DeclarationKind::TYPE_ALIAS, std::string(stmt[1].text), signature, doc, head.line);
+            }
+            return;
+        }
+        if (head.is("typedef")) {
+            std::string name;
+            for (size_t k = 1; k < stmt.size(); ++k) {
+                if (stmt[k].is("*") && k + 1 < stmt.size() && stmt[k + 1].type == TokenType::IDENTIFIER &&
+                    k > 0 && stmt[k - 1].is("(")) {
+                    name = std::string(stmt[k + 1].text);  // function pointer typedef
+                    break;
+                }
+                if (stmt[k].type == TokenType::IDENTIFIER) name = std::string(stmt[k].text);
+            }
+            if (!name.empty()) {
+                record(DeclarationKind::TYPE_ALIAS, name, signature, doc, head.line);
+            }
+            return;
+        }
+
+        if (first_paren != SIZE_MAX) {
+            std::string name = functionName(first_paren);
+            if (!name.empty()) {
+                record(DeclarationKind::FUNCTION, name, signature, doc, head.line);
+            }
+            return;
+        }
+
+        // Anything else with a trailing identifier is a variable or data member
+        size_t limit = first_equals == SIZE_MAX ? stmt.size() : first_equals - decl_start;
+        std::string name;
+        int angles = 0;
+        for (size_t k = 0; k < limit; ++k) {
+            if (stmt[k].is("<") && k > 0 && stmt[k - 1].type == TokenType::IDENTIFIER) {
+                ++angles;
+            } else if (stmt[k].is(">") && angles > 0) {
+                --angles;
+            } else if (angles == 0) {
+                if (stmt[k].is("[") || stmt[k].is("{") || stmt[k].is(":") || stmt[k].is(",")) break;
+                if (stmt[k].type == TokenType::IDENTIFIER) name = std::string(stmt[k].text);
+            }
+        }
+        if (!name.empty() && stmt.size() > 1) {
+            record(DeclarationKind::VARIABLE, name, signature, doc, head.line);
+        }
+    }
+
+    std::string functionName(size_t paren_index) const {
+        // operator overloads: the name runs from 'operator' up to the parameter list
+        for (size_t k = paren_index; k > 0; --k) {
+            const Token& tok = tokens_[k - 1];
+            if (tok.is("operator")) {
+                std::string name = "operator";
+                size_t j = k;
+                for (; j < paren_index; ++j) {
+                    if (tokens_[j].type == TokenType::IDENTIFIER && isIdentChar(name.back())) name += " ";
+                    name += std::string(tokens_[j].text);
+                }
+                return name;
+            }
+            if (tok.is(";") || tok.is("{") || tok.is("}")) break;
+        }
+        if (paren_index == 0) return "";
+        const Token& prev = tokens_[paren_index - 1];
+        if (prev.type != TokenType::IDENTIFIER) return "";
+        if (paren_index >= 2 && tokens_[paren_index - 2].is("~")) {
+            return "~" + std::string(prev.text);
+        }
+        static const std::unordered_set<std::string_view> not_functions = {
+            "decltype", "alignas", "sizeof", "noexcept", "__attribute__", "static_assert", "if", "while",
+            "for", "switch", "return"};
+        if (not_functions.count(prev.text)) return "";
+        return std::string(prev.text);
+    }
+
+    void record(DeclarationKind kind, const std::string& name, const std::string& signature,
+                const std::string& doc, size_t line) {
+        ScannedDeclaration decl;
+        decl.kind = kind;
+        decl.name = name;
+        decl.scope = currentScope();
+        decl.signature = signature;
+        decl.doc_comment = doc;
+        decl.line = line;
+        if (inClass()) {
+            decl.parent = scopes_.back().name;
+            decl.access = scopes_.back().access;
+        }
+        out_.push_back(std::move(decl));
+    }
+};
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return "";
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+} // anonymous namespace
+
+CppHeaderScanner::CppHeaderScanner(size_t thread_count)
+    : thread_count_(thread_count > 0 ? thread_count
+                                     : std::max<size_t>(1, std::thread::hardware_concurrency())) {}
+
+CppHeaderScanner::~CppHeaderScanner() = default;
+
+ScannedHeader CppHeaderScanner::scanSource(const std::string& source, const std::filesystem::path& path) {
+    ScannedHeader header;
+    header.path = path;
+    header.content_hash = hashContent(source);
+
+    Lexer lexer(source);
+    std::vector<Token> tokens = lexer.tokenize();
+    DeclarationParser parser(tokens, header.declarations);
+    parser.parse();
+    return header;
+}
+
+std::shared_ptr<const ScannedHeader> CppHeaderScanner::scanFile(const std::filesystem::path& path) const {
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+    std::string key = path.string();
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end() && it->second.mtime == mtime && it->second.size == size) {
+            ++cache_hits_;
+            return it->second.header;
+        }
+    }
+
+    std::string content = readFile(path);
+    uint64_t hash = hashContent(content);
+
+    {
+        // Touched but unchanged files are still hits
+        std::lock_guard<std::mutex> lock(cache_mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end() && it->second.header->content_hash == hash) {
+            it->second.mtime = mtime;
+            it->second.size = size;
+            ++cache_hits_;
+            return it->second.header;
+        }
+    }
+
+    auto header = std::make_shared<ScannedHeader>(scanSource(content, path));
+
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_[key] = CacheEntry{mtime, size, header};
+    ++cache_misses_;
+    return header;
+}
+
+std::vector<std::shared_ptr<const ScannedHeader>> CppHeaderScanner::scanDirectory(
+    const std::filesystem::path& directory, const std::vector<std::string>& extensions) const {
+    std::vector<std::filesystem::path> files;
+    std::error_code ec;
+    for (auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+         !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+        if (it->is_regular_file(ec) &&
+            std::find(extensions.begin(), extensions.end(), it->path().extension().string()) != extensions.end()) {
+            files.push_back(it->path());
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::shared_ptr<const ScannedHeader>> results(files.size());
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t index = next++; index < files.size(); index = next++) {
+            results[index] = scanFile(files[index]);
+        }
+    };
+
+    size_t workers = std::min(thread_count_, files.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < workers; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    results.erase(std::remove(results.begin(), results.end(), nullptr), results.end());
+    return results;
+}
+
+uint64_t CppHeaderScanner::hashContent(const std::string& content) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : content) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t CppHeaderScanner::getCacheHits() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_hits_;
+}
+
+size_t CppHeaderScanner::getCacheMisses() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_misses_;
+}
+
+size_t CppHeaderScanner::getCacheSize() const {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    return cache_.size();
+}
+
+void CppHeaderScanner::clearCache() {
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+    cache_hits_ = 0;
+    cache_misses_ = 0;
+}
+
+} // namespace elizaos
@@ -1,5 +1,7 @@
 #include "elizaos/elizaos_github_io.hpp"
 #include "elizaos/agentlogger.hpp"
+#include "elizaos/cpp_header_scanner.hpp"
+#include "elizaos/text_entities.hpp"
 #include <fstream>
 #include <sstream>
 #include <regex>
@@ -200,8 +202,21 @@ std::string MarkdownProcessor::processTaskLists(const std::string& content) cons
 }
 
 std::string MarkdownProcessor::processMentions(const std::string& content) const {
-    std::regex mention_regex(R"(@(\w+))");
-    return std::regex_replace(content, mention_regex, "<a href=\"https://github.com/$1\" class=\"mention\">@$1</a>");
+    // Mentions only: the @ of an email address is left alone
+    std::string result;
+    size_t copied = 0;
+    for (const auto& mention : scanTextEntities(content, textEntityBit(TextEntityType::MENTION))) {
+        std::string_view name = mention.in(content).substr(1);
+        result.append(content, copied, mention.start - copied);
+        result += "<a href=\"https://github.com/";
+        result += name;
+        result += "\" class=\"mention\">@";
+        result += name;
+        result += "</a>";
+        copied = mention.end;
+    }
+    result.append(content, copied, std::string::npos);
+    return result;
 }
 
 std::string MarkdownProcessor::escapeHtml(const std::string& text) const {
@@ -229,6 +244,7 @@ std::string MarkdownProcessor::generateAnchorId(const std::string& heading) cons
 // DocumentationGenerator implementation
 DocumentationGenerator::DocumentationGenerator(const GitHubPagesConfig& config) : config_(config) {
     markdown_processor_ = std::make_shared<MarkdownProcessor>();
+    header_scanner_ = std::make_shared<CppHeaderScanner>();
 }
 
 DocumentationGenerator::~DocumentationGenerator() = default;
@@ -278,7 +294,11 @@ bool DocumentationGenerator::generateApiDocs(const std::filesystem::path& source
             page.tags.push_back("api");
             page.frontmatter["layout"] = "api";
             page.frontmatter["category"] = "API Reference";
-            page.output_path = config_.output_dir / "api" / (code_doc.class_name + ".html");
+            std::string file_name = code_doc.class_name;
+            for (size_t pos = file_name.find("::"); pos != std::string::npos; pos = file_name.find("::")) {
+                file_name.replace(pos, 2, "_");
+            }
+            page.output_path = config_.output_dir / "api" / (file_name + ".html");
             
             addPage(page);
         }
@@ -439,17 +459,65 @@ std::vector<DocumentationGenerator::CodeDocumentation> DocumentationGenerator::e
     std::vector<CodeDocumentation> docs;
     
     try {
-        for (const auto& entry : std::filesystem::recursive_directory_iterator(source_dir)) {
-            if (entry.is_regular_file() && entry.path().extension() == ".hpp") {
-                auto class_info = extractClassFromHeader(entry.path());
-                if (!class_info.empty()) {
-                    CodeDocumentation doc;
-                    doc.class_name = class_info;
-                    doc.source_file = entry.path();
-                    doc.description = "C++ class documentation for " + class_info;
-                    docs.push_back(doc);
+        // Headers are lexed once each, in parallel; unchanged files come from the scanner cache
+        for (const auto& header : header_scanner_->scanDirectory(source_dir)) {
+            std::unordered_map<std::string, size_t> types;  // qualified name -> index in docs
+            CodeDocumentation free_functions;
+            free_functions.kind = "file";
+            free_functions.class_name = header->path.filename().string();
+            free_functions.source_file = header->path;
+            free_functions.description = "Free functions declared in " + free_functions.class_name;
+            
+            for (const auto& decl : header->declarations) {
+                switch (decl.kind) {
+                    case DeclarationKind::CLASS:
+                    case DeclarationKind::STRUCT:
+                    case DeclarationKind::UNION:
+                    case DeclarationKind::ENUM: {
+                        if (decl.access == "private") {
+                            break;
+                        }
+                        CodeDocumentation doc;
+                        doc.kind = declarationKindToString(decl.kind);
+                        doc.class_name = decl.parent.empty() ? decl.name : decl.parent + "::" + decl.name;
+                        doc.namespace_name = decl.scope;
+                        doc.source_file = header->path;
+                        doc.description = decl.doc_comment.empty() ?
+                            "C++ " + doc.kind + " documentation for " + decl.name : decl.doc_comment;
+                        types[decl.qualifiedName()] = docs.size();
+                        docs.push_back(doc);
+                        break;
+                    }
+                    case DeclarationKind::FUNCTION:
+                    case DeclarationKind::VARIABLE: {
+                        if (decl.parent.empty()) {
+                            if (decl.kind == DeclarationKind::FUNCTION) {
+                                free_functions.methods.push_back(decl.signature);
+                                free_functions.method_descriptions.push_back(decl.doc_comment);
+                            }
+                            break;
+                        }
+                        auto owner = types.find(decl.scope);
+                        if (owner == types.end() || decl.access == "private") {
+                            break;
+                        }
+                        auto& doc = docs[owner->second];
+                        if (decl.kind == DeclarationKind::FUNCTION) {
+                            doc.methods.push_back(decl.signature);
+                            doc.method_descriptions.push_back(decl.doc_comment);
+                        } else {
+                            doc.properties.push_back(decl.signature);
+                        }
+                        break;
+                    }
+                    case DeclarationKind::TYPE_ALIAS:
+                        break;
                 }
             }
+            
+            if (!free_functions.methods.empty()) {
+                docs.push_back(free_functions);
+            }
         }
     } catch (const std::exception&) {
         // Continue processing other files
@@ -461,13 +529,22 @@ std::vector<DocumentationGenerator::CodeDocumentation> DocumentationGenerator::e
 std::string DocumentationGenerator::generateClassDocumentation(const CodeDocumentation& code_doc) const {
     std::stringstream doc;
     doc << "# " << code_doc.class_name << "\n\n";
+    if (!code_doc.namespace_name.empty()) {
+        doc << "*" << code_doc.kind << " in `" << code_doc.namespace_name << "`*\n\n";
+    }
     doc << code_doc.description << "\n\n";
     doc << "**Source File:** `" << code_doc.source_file.filename().string() << "`\n\n";
     
     if (!code_doc.methods.empty()) {
-        doc << "## Methods\n\n";
-        for (const auto& method : code_doc.methods) {
-            doc << "- `" << method << "`\n";
+        doc << (code_doc.kind == "file" ? "## Functions\n\n" : "## Methods\n\n");
+        for (size_t i = 0; i < code_doc.methods.size(); ++i) {
+            doc << "- `" << code_doc.methods[i] << "`";
+            if (i < code_doc.method_descriptions.size() && !code_doc.method_descriptions[i].empty()) {
+                std::string description = code_doc.method_descriptions[i];
+                std::replace(description.begin(), description.end(), '\n', ' ');
+                doc << " - " << description;
+            }
+            doc << "\n";
         }
         doc << "\n";
     }
@@ -575,28 +652,24 @@ bool DocumentationGenerator::copyAssets(const std::filesystem::path& assets_dir)
 }
 
 std::string DocumentationGenerator::extractClassFromHeader(const std::filesystem::path& header_file) const {
-    try {
-        std::ifstream file(header_file);
-        if (!file.is_open()) return "";
-        
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        
-        std::regex class_regex(R"(class\s+(\w+))");
-        std::smatch matches;
-        
-        if (std::regex_search(content, matches, class_regex)) {
-            return matches[1].str();
+    auto header = header_scanner_->scanFile(header_file);
+    if (!header) return "";
+    
+    for (const auto& decl : header->declarations) {
+        if (decl.kind == DeclarationKind::CLASS || decl.kind == DeclarationKind::STRUCT) {
+            return decl.name;
         }
-    } catch (const std::exception&) {
-        // Continue
     }
-    
     return "";
 }
 
-std::string DocumentationGenerator::extractDocComment(const std::string& /* source_code */, const std::string& element_name) const {
-    // Simple doc comment extraction - would be more sophisticated in practice
+std::string DocumentationGenerator::extractDocComment(const std::string& source_code, const std::string& element_name) const {
+    auto header = CppHeaderScanner::scanSource(source_code);
+    for (const auto& decl : header.declarations) {
+        if ((decl.name == element_name || decl.qualifiedName() == element_name) && !decl.doc_comment.empty()) {
+            return decl.doc_comment;
+        }
+    }
     return "Documentation for " + element_name;
 }
 
@@ -118,60 +118,148 @@ void from_json(const nlohmann::json& j, Collection& c) {
     j.at("featured").get_to(c.featured);
 }
 
+namespace {
+
+std::string foldCase(const std::string& text) {
+    std::string folded = text;
+    std::transform(folded.begin(), folded.end(), folded.begin(), ::tolower);
+    return folded;
+}
+
+int starsOf(const Project& project) {
+    return project.metrics ? project.metrics->stars : 0;
+}
+
+} // anonymous namespace
+
+ElizasList::ElizasList(const ElizasList& other) : collections_(other.collections_) {
+    setProjects(other.projectsInOrder());
+}
+
+ElizasList& ElizasList::operator=(const ElizasList& other) {
+    if (this != &other) {
+        setProjects(other.projectsInOrder());
+        collections_ = other.collections_;
+    }
+    return *this;
+}
+
+// Catalogue maintenance
+void ElizasList::indexProject(const ProjectEntry& entry) {
+    const Project& project = entry.project;
+    projectsInOrder_.emplace(entry.sequence, &entry);
+    for (const auto& tag : project.tags) {
+        projectsByTag_[tag].emplace(entry.sequence, &entry);
+    }
+    projectsByAuthor_[project.author.github].emplace(entry.sequence, &entry);
+    projectsByStars_.emplace(std::make_pair(starsOf(project), entry.sequence), &entry);
+    projectsByRecency_.emplace(std::make_pair(project.addedOn, entry.sequence), &entry);
+}
+
+void ElizasList::unindexProject(const ProjectEntry& entry) {
+    const Project& project = entry.project;
+    projectsInOrder_.erase(entry.sequence);
+    for (const auto& tag : project.tags) {
+        auto it = projectsByTag_.find(tag);
+        if (it == projectsByTag_.end()) continue;
+        it->second.erase(entry.sequence);
+        if (it->second.empty()) projectsByTag_.erase(it);
+    }
+    auto author = projectsByAuthor_.find(project.author.github);
+    if (author != projectsByAuthor_.end()) {
+        author->second.erase(entry.sequence);
+        if (author->second.empty()) projectsByAuthor_.erase(author);
+    }
+    projectsByStars_.erase(std::make_pair(starsOf(project), entry.sequence));
+    projectsByRecency_.erase(std::make_pair(project.addedOn, entry.sequence));
+}
+
+void ElizasList::setProjects(const std::vector<Project>& projects) {
+    projectsById_.clear();
+    projectsInOrder_.clear();
+    projectsByTag_.clear();
+    projectsByAuthor_.clear();
+    projectsByStars_.clear();
+    projectsByRecency_.clear();
+    nextSequence_ = 0;
+
+    // Ids are unique in the catalogue; the first occurrence wins
+    for (const auto& project : projects) {
+        addProject(project);
+    }
+}
+
+std::vector<Project> ElizasList::projectsInOrder() const {
+    return collect(projectsInOrder_);
+}
+
+std::vector<Project> ElizasList::collect(const PostingList& postings) {
+    std::vector<Project> result;
+    result.reserve(postings.size());
+    for (const auto& posting : postings) {
+        result.push_back(posting.second->project);
+    }
+    return result;
+}
+
 // Project management implementation
 bool ElizasList::addProject(const Project& project) {
     // Check if project with same ID already exists
-    if (findProject(project.id) != projects_.end()) {
+    if (projectsById_.count(project.id)) {
         return false;
     }
     
-    projects_.push_back(project);
+    auto entry = std::make_unique<ProjectEntry>();
+    entry->project = project;
+    entry->sequence = nextSequence_++;
+    entry->foldedName = foldCase(project.name);
+    entry->foldedDescription = foldCase(project.description);
+    indexProject(*entry);
+    projectsById_.emplace(project.id, std::move(entry));
     return true;
 }
 
 bool ElizasList::removeProject(const std::string& projectId) {
-    auto it = findProject(projectId);
-    if (it != projects_.end()) {
-        projects_.erase(it);
+    auto it = projectsById_.find(projectId);
+    if (it != projectsById_.end()) {
+        unindexProject(*it->second);
+        projectsById_.erase(it);
         return true;
     }
     return false;
 }
 
 std::optional<Project> ElizasList::getProject(const std::string& projectId) const {
-    auto it = findProject(projectId);
-    if (it != projects_.end()) {
-        return *it;
+    auto it = projectsById_.find(projectId);
+    if (it != projectsById_.end()) {
+        return it->second->project;
     }
     return std::nullopt;
 }
 
 std::vector<Project> ElizasList::getAllProjects() const {
-    return projects_;
+    return projectsInOrder();
 }
 
 std::vector<Project> ElizasList::getProjectsByTag(const std::string& tag) const {
-    std::vector<Project> result;
-    std::copy_if(projects_.begin(), projects_.end(), std::back_inserter(result),
-                 [&tag](const Project& project) {
-                     return std::find(project.tags.begin(), project.tags.end(), tag) != project.tags.end();
-                 });
-    return result;
+    auto it = projectsByTag_.find(tag);
+    return it != projectsByTag_.end() ? collect(it->second) : std::vector<Project>();
 }
 
 std::vector<Project> ElizasList::getProjectsByAuthor(const std::string& authorGithub) const {
-    std::vector<Project> result;
-    std::copy_if(projects_.begin(), projects_.end(), std::back_inserter(result),
-                 [&authorGithub](const Project& project) {
-                     return project.author.github == authorGithub;
-                 });
-    return result;
+    auto it = projectsByAuthor_.find(authorGithub);
+    return it != projectsByAuthor_.end() ? collect(it->second) : std::vector<Project>();
 }
 
 bool ElizasList::updateProject(const Project& project) {
-    auto it = findProject(project.id);
-    if (it != projects_.end()) {
-        *it = project;
+    auto it = projectsById_.find(project.id);
+    if (it != projectsById_.end()) {
+        ProjectEntry& entry = *it->second;
+        unindexProject(entry);
+        entry.project = project;
+        entry.foldedName = foldCase(project.name);
+        entry.foldedDescription = foldCase(project.description);
+        indexProject(entry);
         return true;
     }
     return false;
@@ -230,43 +318,39 @@ bool ElizasList::updateCollection(const Collection& collection) {
 // Project search and filtering implementation
 std::vector<Project> ElizasList::searchProjects(const std::string& query) const {
     std::vector<Project> result;
-    std::string lowerQuery = query;
-    std::transform(lowerQuery.begin(), lowerQuery.end(), lowerQuery.begin(), ::tolower);
+    std::string lowerQuery = foldCase(query);
     
-    std::copy_if(projects_.begin(), projects_.end(), std::back_inserter(result),
-                 [&lowerQuery](const Project& project) {
-                     std::string lowerName = project.name;
-                     std::string lowerDesc = project.description;
-                     std::transform(lowerName.begin(), lowerName.end(), lowerName.begin(), ::tolower);
-                     std::transform(lowerDesc.begin(), lowerDesc.end(), lowerDesc.begin(), ::tolower);
-                     
-                     return lowerName.find(lowerQuery) != std::string::npos ||
-                            lowerDesc.find(lowerQuery) != std::string::npos;
-                 });
+    // Name and description are folded once when a project is indexed
+    for (const auto& posting : projectsInOrder_) {
+        const ProjectEntry& entry = *posting.second;
+        if (entry.foldedName.find(lowerQuery) != std::string::npos ||
+            entry.foldedDescription.find(lowerQuery) != std::string::npos) {
+            result.push_back(entry.project);
+        }
+    }
     return result;
 }
 
 std::vector<Project> ElizasList::getProjectsSortedByStars() const {
-    std::vector<Project> result = projects_;
-    std::sort(result.begin(), result.end(),
-              [](const Project& a, const Project& b) {
-                  int starsA = a.metrics ? a.metrics->stars : 0;
-                  int starsB = b.metrics ? b.metrics->stars : 0;
-                  return starsA > starsB;
-              });
+    return getTopProjectsByStars(projectsByStars_.size());
+}
+
+std::vector<Project> ElizasList::getTopProjectsByStars(size_t limit) const {
+    std::vector<Project> result;
+    result.reserve(std::min(limit, projectsByStars_.size()));
+    for (auto it = projectsByStars_.begin(); it != projectsByStars_.end() && result.size() < limit; ++it) {
+        result.push_back(it->second->project);
+    }
     return result;
 }
 
 std::vector<Project> ElizasList::getRecentProjects(int limit) const {
-    std::vector<Project> result = projects_;
-    // Sort by addedOn date (descending - most recent first)
-    std::sort(result.begin(), result.end(),
-              [](const Project& a, const Project& b) {
-                  return a.addedOn > b.addedOn;
-              });
-    
-    if (static_cast<size_t>(limit) < result.size()) {
-        result.resize(limit);
+    // Most recent first, maintained by addedOn (ISO 8601 sorts lexically)
+    std::vector<Project> result;
+    size_t count = std::min(static_cast<size_t>(std::max(limit, 0)), projectsByRecency_.size());
+    result.reserve(count);
+    for (auto it = projectsByRecency_.begin(); result.size() < count; ++it) {
+        result.push_back(it->second->project);
     }
     return result;
 }
@@ -283,7 +367,7 @@ bool ElizasList::loadFromJson(const std::string& filePath) {
         file >> json;
         
         if (json.contains("projects")) {
-            projects_ = json["projects"].get<std::vector<Project>>();
+            setProjects(json["projects"].get<std::vector<Project>>());
         }
         
         if (json.contains("collections")) {
@@ -299,7 +383,7 @@ bool ElizasList::loadFromJson(const std::string& filePath) {
 bool ElizasList::saveToJson(const std::string& filePath) const {
     try {
         nlohmann::json json;
-        json["projects"] = projects_;
+        json["projects"] = projectsInOrder();
         json["collections"] = collections_;
         
         std::ofstream file(filePath);
@@ -319,7 +403,7 @@ bool ElizasList::loadProjectsFromJson(const std::string& jsonData) {
         nlohmann::json json = nlohmann::json::parse(jsonData);
         
         if (json.contains("projects")) {
-            projects_ = json["projects"].get<std::vector<Project>>();
+            setProjects(json["projects"].get<std::vector<Project>>());
             return true;
         }
         return false;
@@ -331,7 +415,7 @@ bool ElizasList::loadProjectsFromJson(const std::string& jsonData) {
 std::string ElizasList::exportProjectsToJson() const {
     try {
         nlohmann::json json;
-        json["projects"] = projects_;
+        json["projects"] = projectsInOrder();
         return json.dump(2);
     } catch (const std::exception&) {
         return "";
@@ -340,7 +424,7 @@ std::string ElizasList::exportProjectsToJson() const {
 
 // Statistics implementation
 size_t ElizasList::getProjectCount() const {
-    return projects_.size();
+    return projectsById_.size();
 }
 
 size_t ElizasList::getCollectionCount() const {
@@ -349,34 +433,34 @@ size_t ElizasList::getCollectionCount() const {
 
 std::vector<std::string> ElizasList::getAllTags() const {
     std::vector<std::string> allTags;
-    
-    for (const auto& project : projects_) {
-        for (const auto& tag : project.tags) {
-            if (std::find(allTags.begin(), allTags.end(), tag) == allTags.end()) {
-                allTags.push_back(tag);
-            }
-        }
+    allTags.reserve(projectsByTag_.size());
+    for (const auto& tag : projectsByTag_) {
+        allTags.push_back(tag.first);
     }
-    
-    std::sort(allTags.begin(), allTags.end());
     return allTags;
 }
 
-// Helper methods implementation
-std::vector<Project>::iterator ElizasList::findProject(const std::string& projectId) {
-    return std::find_if(projects_.begin(), projects_.end(),
-                        [&projectId](const Project& project) {
-                            return project.id == projectId;
-                        });
+std::vector<std::pair<std::string, size_t>> ElizasList::getTagCounts() const {
+    std::vector<std::pair<std::string, size_t>> counts;
+    counts.reserve(projectsByTag_.size());
+    for (const auto& tag : projectsByTag_) {
+        counts.emplace_back(tag.first, tag.second.size());
+    }
+    return counts;
 }
 
-std::vector<Project>::const_iterator ElizasList::findProject(const std::string& projectId) const {
-    return std::find_if(projects_.begin(), projects_.end(),
-                        [&projectId](const Project& project) {
-                            return project.id == projectId;
-                        });
+size_t ElizasList::countProjectsByTag(const std::string& tag) const {
+    auto it = projectsByTag_.find(tag);
+    return it != projectsByTag_.end() ? it->second.size() : 0;
+}
+
+size_t ElizasList::countProjectsByAuthor(const std::string& authorGithub) const {
+    auto it = projectsByAuthor_.find(authorGithub);
+    return it != projectsByAuthor_.end() ? it->second.size() : 0;
 }
 
+// Helper methods implementation
+
 std::vector<Collection>::iterator ElizasList::findCollection(const std::string& collectionId) {
     return std::find_if(collections_.begin(), collections_.end(),
                         [&collectionId](const Collection& collection) {
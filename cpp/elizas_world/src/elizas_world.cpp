@@ -7,6 +7,20 @@
 
 namespace elizaos {
 
+namespace {
+
+// Rough heap footprint of a logged interaction
+size_t estimateInteractionBytes(const WorldInteraction& interaction) {
+    size_t bytes = sizeof(WorldInteraction) + interaction.id.capacity() + interaction.initiatorId.capacity() +
+                   interaction.targetId.capacity() + interaction.type.capacity();
+    for (const auto& [key, value] : interaction.metadata) {
+        bytes += key.capacity() + value.capacity() + 2 * sizeof(std::string) + 4 * sizeof(void*);
+    }
+    return bytes;
+}
+
+} // anonymous namespace
+
 // WorldPosition methods
 double WorldPosition::distanceTo(const WorldPosition& other) const {
     double dx = x - other.x;
@@ -73,6 +87,10 @@ ElizasWorld::ElizasWorld()
 {
 }
 
+ElizasWorld::~ElizasWorld() {
+    MemoryGovernor::global().unregisterConsumer(*this);
+}
+
 bool ElizasWorld::addEnvironment(const WorldEnvironment& environment) {
     auto it = findEnvironment(environment.id);
     if (it != environments_.end()) {
@@ -325,7 +343,11 @@ bool ElizasWorld::setAgentVelocity(const std::string& agentId, const WorldPositi
 }
 
 bool ElizasWorld::recordInteraction(const WorldInteraction& interaction) {
-    interactions_.push_back(interaction);
+    {
+        std::lock_guard<std::mutex> lock(interactionsMutex_);
+        interactions_.push_back(interaction);
+        interactionBytes_ += estimateInteractionBytes(interaction);
+    }
     
     if (onInteractionCallback_) {
         onInteractionCallback_(interaction.initiatorId, interaction.targetId);
@@ -335,6 +357,7 @@ bool ElizasWorld::recordInteraction(const WorldInteraction& interaction) {
 }
 
 std::vector<WorldInteraction> ElizasWorld::getInteractionHistory(const std::string& agentId) const {
+    std::lock_guard<std::mutex> lock(interactionsMutex_);
     std::vector<WorldInteraction> history;
     std::copy_if(interactions_.begin(), interactions_.end(), 
                  std::back_inserter(history),
@@ -345,6 +368,7 @@ std::vector<WorldInteraction> ElizasWorld::getInteractionHistory(const std::stri
 }
 
 std::vector<WorldInteraction> ElizasWorld::getInteractionsInArea(const WorldPosition& center, double radius) const {
+    std::lock_guard<std::mutex> lock(interactionsMutex_);
     std::vector<WorldInteraction> inArea;
     std::copy_if(interactions_.begin(), interactions_.end(), 
                  std::back_inserter(inArea),
@@ -355,7 +379,11 @@ std::vector<WorldInteraction> ElizasWorld::getInteractionsInArea(const WorldPosi
 }
 
 std::vector<WorldInteraction> ElizasWorld::getRecentInteractions(int limit) const {
-    std::vector<WorldInteraction> recent = interactions_;
+    std::vector<WorldInteraction> recent;
+    {
+        std::lock_guard<std::mutex> lock(interactionsMutex_);
+        recent = interactions_;
+    }
     
     // Sort by timestamp (newest first)
     std::sort(recent.begin(), recent.end(), 
@@ -456,6 +484,7 @@ size_t ElizasWorld::getEnvironmentCount() const {
 }
 
 size_t ElizasWorld::getInteractionCount() const {
+    std::lock_guard<std::mutex> lock(interactionsMutex_);
     return interactions_.size();
 }
 
@@ -464,6 +493,7 @@ double ElizasWorld::getWorldActivity() const {
     auto oneHourAgo = now - std::chrono::hours(1);
     
     size_t recentInteractions = 0;
+    std::lock_guard<std::mutex> lock(interactionsMutex_);
     for (const auto& interaction : interactions_) {
         if (interaction.timestamp > oneHourAgo) {
             recentInteractions++;
@@ -484,9 +514,12 @@ std::map<std::string, int> ElizasWorld::getEnvironmentPopulations() const {
 std::vector<std::string> ElizasWorld::getMostActiveAgents(int limit) const {
     std::map<std::string, int> activityCounts;
     
-    for (const auto& interaction : interactions_) {
-        activityCounts[interaction.initiatorId]++;
-        activityCounts[interaction.targetId]++;
+    {
+        std::lock_guard<std::mutex> lock(interactionsMutex_);
+        for (const auto& interaction : interactions_) {
+            activityCounts[interaction.initiatorId]++;
+            activityCounts[interaction.targetId]++;
+        }
     }
     
     std::vector<std::pair<std::string, int>> sortedActivity(
@@ -542,6 +575,18 @@ void ElizasWorld::setAutoUpdate(bool enabled, double interval) {
     updateInterval_ = interval;
 }
 
+size_t ElizasWorld::shrinkMemory(size_t bytes) {
+    std::lock_guard<std::mutex> lock(interactionsMutex_);
+    size_t freed = 0;
+    size_t dropped = 0;
+    while (dropped < interactions_.size() && freed < bytes) {
+        freed += estimateInteractionBytes(interactions_[dropped++]);
+    }
+    interactions_.erase(interactions_.begin(), interactions_.begin() + static_cast<std::ptrdiff_t>(dropped));
+    interactionBytes_ -= std::min(freed, interactionBytes_.load());
+    return freed;
+}
+
 void ElizasWorld::checkEnvironmentTransitions() {
     for (auto& agent : agents_) {
         if (!agent.online) continue;
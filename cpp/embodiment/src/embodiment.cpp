@@ -3,7 +3,6 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
-#include <random>
 
 namespace elizaos {
 
@@ -181,16 +180,16 @@ void TaskManager::start() {
     
     running_ = true;
     paused_ = false;
-    executionThread_ = std::thread(&TaskManager::executionLoop, this);
+    ticker_.start(tickInterval_, [this] {
+        if (!paused_) processPendingTasks();
+    });
 }
 
 void TaskManager::stop() {
     if (!running_) return;
     
     running_ = false;
-    if (executionThread_.joinable()) {
-        executionThread_.join();
-    }
+    ticker_.stop();
 }
 
 void TaskManager::pause() {
@@ -201,13 +200,9 @@ void TaskManager::resume() {
     paused_ = false;
 }
 
-void TaskManager::executionLoop() {
-    while (running_) {
-        if (!paused_) {
-            processPendingTasks();
-        }
-        std::this_thread::sleep_for(tickInterval_);
-    }
+void TaskManager::setTickInterval(std::chrono::milliseconds interval) {
+    tickInterval_ = interval;
+    ticker_.setInterval(interval);
 }
 
 void TaskManager::processPendingTasks() {
@@ -242,7 +237,7 @@ bool TaskManager::executeTask(std::shared_ptr<Task> task) {
         AgentConfig config;
         config.agentId = "task-manager";
         State state(config);
-        auto message = std::make_shared<Memory>("msg-id", "task execution", "entity-id", "agent-id");
+        auto message = makeMemory("msg-id", "task execution", "entity-id", "agent-id");
         
         if (worker->validate(*task, state, message)) {
             task->setStatus(TaskStatus::RUNNING);
@@ -264,23 +259,40 @@ bool TaskManager::executeTask(std::shared_ptr<Task> task) {
 /**
  * State Implementation
  */
-State::State(const AgentConfig& config) : config_(config) {}
+State::State(const AgentConfig& config) {
+    auto initial = std::make_shared<StateVersion>();
+    initial->config = config;
+    current_ = std::move(initial);
+}
+
+State::State(const State& other) : current_(other.snapshot()) {}
+
+State& State::operator=(const State& other) {
+    if (this != &other) {
+        auto source = other.snapshot();
+        update([&](StateVersion& next) { next = *source; });
+    }
+    return *this;
+}
+
+void State::update(const std::function<void(StateVersion&)>& mutate) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    auto next = std::make_shared<StateVersion>(*current_);
+    mutate(*next);
+    next->version = current_->version + 1;
+    std::atomic_store(&current_, std::shared_ptr<const StateVersion>(std::move(next)));
+}
 
 void State::addActor(const Actor& actor) {
-    actors_.push_back(actor);
+    update([&](StateVersion& next) { next.actors = next.actors.pushBack(actor); });
 }
 
 void State::addGoal(const Goal& goal) {
-    goals_.push_back(goal);
+    update([&](StateVersion& next) { next.goals = next.goals.pushBack(goal); });
 }
 
 void State::addRecentMessage(std::shared_ptr<Memory> memory) {
-    recentMessages_.push_back(memory);
-    
-    // Keep only recent messages (limit to 100)
-    if (recentMessages_.size() > 100) {
-        recentMessages_.erase(recentMessages_.begin());
-    }
+    update([&](StateVersion& next) { next.recentMessages = next.recentMessages.pushBack(std::move(memory)); });
 }
 
 /**
@@ -626,39 +638,4 @@ double CognitiveFusionEngine::calculateOverallConfidence(const ReasoningResult&
     return count > 0 ? confidence / count : 0.0;
 }
 
-/**
- * Utility function implementation
- */
-std::string generateUUID() {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 15);
-    static std::uniform_int_distribution<> dis2(8, 11);
-    
-    std::ostringstream ss;
-    int i;
-    ss << std::hex;
-    for (i = 0; i < 8; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    for (i = 0; i < 4; i++) {
-        ss << dis(gen);
-    }
-    ss << "-4";
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    ss << dis2(gen);
-    for (i = 0; i < 3; i++) {
-        ss << dis(gen);
-    }
-    ss << "-";
-    for (i = 0; i < 12; i++) {
-        ss << dis(gen);
-    }
-    return ss.str();
-}
-
 } // namespace elizaos
\ No newline at end of file
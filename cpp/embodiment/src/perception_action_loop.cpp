@@ -397,7 +397,7 @@ void PerceptionActionLoop::updateState(const std::vector<std::shared_ptr<Sensory
         if (data->type == SensoryDataType::TEXTUAL) {
             auto textData = std::dynamic_pointer_cast<TextualData>(data);
             if (textData) {
-                auto memory = std::make_shared<Memory>(
+                auto memory = makeMemory(
                     generateUUID(),
                     "Sensory input: " + textData->text,
                     "sensory-entity",
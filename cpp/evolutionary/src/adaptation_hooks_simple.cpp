@@ -78,7 +78,7 @@ public:
     
     void onPatternDiscovered(const PatternExtractor::Pattern& pattern, const State& state) override {
         // Store successful patterns in agent memory
-        auto memory = std::make_shared<Memory>(
+        auto memory = makeMemory(
             elizaos::generateUUID(),
             "Discovered pattern: " + pattern.name + " with effectiveness " + std::to_string(pattern.effectiveness),
             state.getAgentId(),
@@ -410,6 +410,7 @@ OptimizationPipeline::OptimizationPipeline() {
 
 OptimizationPipeline::~OptimizationPipeline() {
     stop();
+    tasks_.wait();
 }
 
 void OptimizationPipeline::addStage(const Stage& stage) {
@@ -490,7 +491,7 @@ Individual OptimizationPipeline::runPipeline(const State& state) {
 }
 
 std::future<Individual> OptimizationPipeline::runPipelineAsync(const State& state) {
-    return std::async(std::launch::async, [this, state]() {
+    return tasks_.async([this, state]() {
         return runPipeline(state);
     });
 }
@@ -41,15 +41,17 @@ KnowledgeEntry::KnowledgeEntry(const std::string& content, KnowledgeType type)
 
 JsonValue KnowledgeEntry::toJson() const {
     JsonValue json;
-    json["id"] = std::string(id);
-    json["content"] = std::string(content);
-    json["type"] = std::string(knowledgeTypeToString(type));
-    json["confidence"] = std::string(confidenceLevelToString(confidence));
-    json["source"] = std::string(knowledgeSourceToString(source));
-    
-    // Simple timestamp conversion
-    json["created_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(created_at)));
-    json["updated_at"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(updated_at)));
+    json["id"] = id;
+    json["content"] = content;
+    json["type"] = knowledgeTypeToString(type);
+    json["confidence"] = confidenceLevelToString(confidence);
+    json["source"] = knowledgeSourceToString(source);
+    json["tags"] = tags;
+    json["related_entries"] = related_entries;
+    
+    // Timestamps as Unix seconds
+    json["created_at"] = std::chrono::system_clock::to_time_t(created_at);
+    json["updated_at"] = std::chrono::system_clock::to_time_t(updated_at);
     
     return json;
 }
@@ -57,29 +59,25 @@ JsonValue KnowledgeEntry::toJson() const {
 KnowledgeEntry KnowledgeEntry::fromJson(const JsonValue& json) {
     KnowledgeEntry entry("", KnowledgeType::FACT);
     
-    try {
-        auto getString = [&](const std::string& key) -> std::string {
-            auto it = json.find(key);
-            if (it != json.end()) {
-                return std::any_cast<std::string>(it->second);
-            }
-            return "";
-        };
-        
-        entry.id = getString("id");
-        entry.content = getString("content");
-        entry.type = stringToKnowledgeType(getString("type"));
-        entry.confidence = stringToConfidenceLevel(getString("confidence"));
-        entry.source = stringToKnowledgeSource(getString("source"));
-        
-        // Parse timestamps
-        auto created_time_t = std::stoll(getString("created_at"));
-        auto updated_time_t = std::stoll(getString("updated_at"));
-        entry.created_at = std::chrono::system_clock::from_time_t(created_time_t);
-        entry.updated_at = std::chrono::system_clock::from_time_t(updated_time_t);
-    } catch (const std::exception&) {
-        // Handle parsing errors gracefully
-    }
+    entry.id = json.getString("id");
+    entry.content = json.getString("content");
+    entry.type = stringToKnowledgeType(json.getString("type"));
+    entry.confidence = stringToConfidenceLevel(json.getString("confidence"));
+    entry.source = stringToKnowledgeSource(json.getString("source"));
+    
+    auto readStrings = [&](const char* key, std::vector<std::string>& out) {
+        const JsonValue* values = json.find(key);
+        if (!values || !values->isArray()) return;
+        for (const auto& value : values->asArray()) {
+            if (value.isString()) out.emplace_back(value.asString());
+        }
+    };
+    readStrings("tags", entry.tags);
+    readStrings("related_entries", entry.related_entries);
+    
+    // Parse timestamps
+    entry.created_at = std::chrono::system_clock::from_time_t(json.getInt("created_at"));
+    entry.updated_at = std::chrono::system_clock::from_time_t(json.getInt("updated_at"));
     
     return entry;
 }
@@ -591,8 +589,8 @@ JsonValue KnowledgeBase::exportToJson() const {
     JsonValue json;
     auto allEntries = getAllKnowledgeFromMemory();
     
-    json["total_entries"] = std::string(std::to_string(allEntries.size()));
-    json["export_timestamp"] = std::string(std::to_string(std::chrono::system_clock::to_time_t(std::chrono::system_clock::now())));
+    json["total_entries"] = allEntries.size();
+    json["export_timestamp"] = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
     
     return json;
 }
@@ -643,6 +641,24 @@ void KnowledgeBase::clear() {
     logger_->log("Knowledge base cleared", "info", "knowledge");
 }
 
+std::unique_lock<std::mutex> KnowledgeBase::fenceSnapshot() const {
+    return std::unique_lock<std::mutex>(knowledgeMutex_);
+}
+
+SnapshotImage KnowledgeBase::freezeSnapshot() const {
+    auto memoryFence = memory_->fenceSnapshot();
+    return memory_->freezeSnapshot();
+}
+
+SnapshotCommit KnowledgeBase::decodeSnapshot(SnapshotReader& reader, uint32_t version) {
+    SnapshotCommit memories = memory_->decodeSnapshot(reader, version);
+    if (!memories) return {};
+    return [this, memories = std::move(memories)] {
+        std::lock_guard<std::mutex> lock(knowledgeMutex_);
+        memories();
+    };
+}
+
 // Private helper methods
 void KnowledgeBase::saveKnowledgeToMemory(const KnowledgeEntry& entry) {
     UUID memoryId(entry.id);
@@ -669,7 +685,7 @@ void KnowledgeBase::saveKnowledgeToMemory(const KnowledgeEntry& entry) {
     }
     
     MemoryMetadata metadata = customMeta;
-    auto memory = std::make_shared<Memory>(memoryId, entry.content, entityId, agentId, metadata);
+    auto memory = makeMemory(memoryId, entry.content, entityId, agentId, metadata);
     
     memory_->createMemory(memory, "knowledge");
 }
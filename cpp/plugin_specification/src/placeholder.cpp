@@ -1,5 +1,7 @@
 #include "elizaos/plugin_specification.hpp"
+#include "elizaos/metrics.hpp"
 #include <algorithm>
+#include <array>
 #include <sstream>
 #include <iomanip>
 #include <filesystem>
@@ -9,6 +11,35 @@
 
 namespace elizaos {
 
+namespace {
+
+Histogram& pluginLatency(const std::string& pluginName) {
+    return MetricsRegistry::global().histogram("elizaos_plugin_execution_seconds", "Plugin execute and hook latency",
+                                               {{"plugin", pluginName}}, 1e-9);
+}
+
+Counter& pluginErrors(const std::string& pluginName) {
+    return MetricsRegistry::global().counter("elizaos_plugin_errors_total", "Plugin calls that failed or threw",
+                                             {{"plugin", pluginName}});
+}
+
+constexpr size_t HOOK_COUNT = static_cast<size_t>(PluginHook::AGENT_SHUTDOWN) + 1;
+
+Histogram& hookLatency(PluginHook hook) {
+    static const std::array<Histogram*, HOOK_COUNT> handles = [] {
+        std::array<Histogram*, HOOK_COUNT> table{};
+        for (size_t i = 0; i < HOOK_COUNT; ++i) {
+            table[i] = &MetricsRegistry::global().histogram(
+                "elizaos_plugin_hook_seconds", "Latency of one hook across all plugins",
+                {{"hook", pluginHookToString(static_cast<PluginHook>(i))}}, 1e-9);
+        }
+        return table;
+    }();
+    return *handles[static_cast<size_t>(hook)];
+}
+
+} // anonymous namespace
+
 // Global plugin manager instance
 std::shared_ptr<PluginManager> globalPluginManager = std::make_shared<PluginManager>();
 
@@ -91,30 +122,21 @@ bool PluginDependency::isSatisfiedBy(const PluginVersion& version) const {
 
 JsonValue PluginParameter::toJson() const {
     JsonValue json;
-    json["name"] = std::string(name);
-    json["description"] = std::string(description);
+    json["name"] = name;
+    json["description"] = description;
     json["type"] = std::string(type);
-    json["required"] = std::string(required ? "true" : "false");
+    json["required"] = required;
     
     // Serialize default value based on type
     if (type == "string") {
-        try {
-            json["defaultValue"] = std::string(std::any_cast<std::string>(defaultValue));
-        } catch (const std::bad_any_cast&) {
-            json["defaultValue"] = std::string("");
-        }
+        const auto* value = std::any_cast<std::string>(&defaultValue);
+        json["defaultValue"] = value ? *value : std::string();
     } else if (type == "int") {
-        try {
-            json["defaultValue"] = std::string(std::to_string(std::any_cast<int>(defaultValue)));
-        } catch (const std::bad_any_cast&) {
-            json["defaultValue"] = std::string("0");
-        }
+        const auto* value = std::any_cast<int>(&defaultValue);
+        json["defaultValue"] = value ? *value : 0;
     } else if (type == "bool") {
-        try {
-            json["defaultValue"] = std::string(std::any_cast<bool>(defaultValue) ? "true" : "false");
-        } catch (const std::bad_any_cast&) {
-            json["defaultValue"] = std::string("false");
-        }
+        const auto* value = std::any_cast<bool>(&defaultValue);
+        json["defaultValue"] = value ? *value : false;
     }
     
     return json;
@@ -123,31 +145,18 @@ JsonValue PluginParameter::toJson() const {
 PluginParameter PluginParameter::fromJson(const JsonValue& json) {
     PluginParameter param;
     
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    param.name = getString("name");
-    param.description = getString("description");
-    param.type = getString("type");
-    param.required = getString("required") == "true";
+    param.name = json.getString("name");
+    param.description = json.getString("description");
+    param.type = json.getString("type");
+    param.required = json.getBool("required");
     
     // Parse default value based on type
-    std::string defaultStr = getString("defaultValue");
     if (param.type == "string") {
-        param.defaultValue = defaultStr;
+        param.defaultValue = json.getString("defaultValue");
     } else if (param.type == "int") {
-        param.defaultValue = std::stoi(defaultStr);
+        param.defaultValue = static_cast<int>(json.getInt("defaultValue"));
     } else if (param.type == "bool") {
-        param.defaultValue = defaultStr == "true";
+        param.defaultValue = json.getBool("defaultValue");
     }
     
     return param;
@@ -159,13 +168,13 @@ PluginParameter PluginParameter::fromJson(const JsonValue& json) {
 
 JsonValue PluginMetadata::toJson() const {
     JsonValue json;
-    json["name"] = std::string(name);
-    json["displayName"] = std::string(displayName);
-    json["description"] = std::string(description);
-    json["author"] = std::string(author);
-    json["website"] = std::string(website);
-    json["license"] = std::string(license);
-    json["version"] = std::string(version.toString());
+    json["name"] = name;
+    json["displayName"] = displayName;
+    json["description"] = description;
+    json["author"] = author;
+    json["website"] = website;
+    json["license"] = license;
+    json["version"] = version.toString();
     
     return json;
 }
@@ -173,25 +182,13 @@ JsonValue PluginMetadata::toJson() const {
 PluginMetadata PluginMetadata::fromJson(const JsonValue& json) {
     PluginMetadata metadata;
     
-    auto getString = [&](const std::string& key) -> std::string {
-        auto it = json.find(key);
-        if (it != json.end()) {
-            try {
-                return std::any_cast<std::string>(it->second);
-            } catch (const std::bad_any_cast&) {
-                return "";
-            }
-        }
-        return "";
-    };
-    
-    metadata.name = getString("name");
-    metadata.displayName = getString("displayName");
-    metadata.description = getString("description");
-    metadata.author = getString("author");
-    metadata.website = getString("website");
-    metadata.license = getString("license");
-    metadata.version = PluginVersion::fromString(getString("version"));
+    metadata.name = json.getString("name");
+    metadata.displayName = json.getString("displayName");
+    metadata.description = json.getString("description");
+    metadata.author = json.getString("author");
+    metadata.website = json.getString("website");
+    metadata.license = json.getString("license");
+    metadata.version = PluginVersion::fromString(json.getString("version"));
     
     return metadata;
 }
@@ -222,9 +219,9 @@ std::vector<std::string> PluginMetadata::getValidationErrors() const {
 
 JsonValue PluginResult::toJson() const {
     JsonValue json;
-    json["success"] = std::string(success ? "true" : "false");
-    json["message"] = std::string(message);
-    json["executionTime"] = std::string(std::to_string(executionTime.count()) + "ms");
+    json["success"] = success;
+    json["message"] = message;
+    json["executionTimeMs"] = executionTime.count();
     
     return json;
 }
@@ -249,13 +246,13 @@ PluginResult PluginInterface::handleHook(PluginHook hook, const PluginContext& c
 
 JsonValue PluginInterface::getStatus() const {
     JsonValue status;
-    status["initialized"] = std::string(initialized_ ? "true" : "false");
-    status["executionCount"] = std::string(std::to_string(executionCount_));
-    status["totalExecutionTime"] = std::string(std::to_string(totalExecutionTime_.count()) + "ms");
+    status["initialized"] = initialized_;
+    status["executionCount"] = executionCount_;
+    status["totalExecutionTimeMs"] = totalExecutionTime_.count();
     
     auto now = std::chrono::system_clock::now();
     auto timeSinceLastExecution = std::chrono::duration_cast<std::chrono::seconds>(now - lastExecuted_).count();
-    status["timeSinceLastExecution"] = std::string(std::to_string(timeSinceLastExecution) + "s");
+    status["secondsSinceLastExecution"] = timeSinceLastExecution;
     
     return status;
 }
@@ -451,7 +448,7 @@ JsonValue PluginRegistry::getStatistics() const {
     std::lock_guard<std::mutex> lock(pluginsMutex_);
     
     JsonValue stats;
-    stats["totalPlugins"] = std::string(std::to_string(plugins_.size()));
+    stats["totalPlugins"] = plugins_.size();
     
     // Count by capability
     std::unordered_map<PluginCapability, int> capabilityCounts;
@@ -461,7 +458,7 @@ JsonValue PluginRegistry::getStatistics() const {
         }
     }
     
-    stats["capabilityCounts"] = std::string(std::to_string(capabilityCounts.size()));
+    stats["capabilityCounts"] = capabilityCounts.size();
     
     return stats;
 }
@@ -507,6 +504,8 @@ bool PluginManager::initializeAll(const std::unordered_map<std::string, std::uno
             config = configIt->second;
         }
         
+        metricsFor(pluginName);  // Resolve metric handles before the first dispatch
+        
         // Initialize plugin
         bool success = plugin->initialize(config);
         if (success) {
@@ -521,6 +520,14 @@ bool PluginManager::initializeAll(const std::unordered_map<std::string, std::uno
     return allSuccess;
 }
 
+PluginManager::PluginMetrics& PluginManager::metricsFor(const std::string& pluginName) {
+    auto it = pluginMetrics_.find(pluginName);
+    if (it == pluginMetrics_.end()) {
+        it = pluginMetrics_.emplace(pluginName, PluginMetrics{pluginLatency(pluginName), pluginErrors(pluginName)}).first;
+    }
+    return it->second;
+}
+
 void PluginManager::shutdownAll() {
     std::lock_guard<std::mutex> lock(managerMutex_);
     
@@ -544,12 +551,15 @@ std::vector<PluginResult> PluginManager::executeHook(PluginHook hook, const Plug
         return results;
     }
     
+    TraceSpan hookSpan("plugin.hook", &hookLatency(hook));
     auto plugins = registry_->getAllPlugins();
     for (const auto& plugin : plugins) {
         std::string pluginName = plugin->getMetadata().name;
         
         if (isPluginEnabled(pluginName)) {
+            PluginMetrics& metrics = metricsFor(pluginName);
             auto start = std::chrono::high_resolution_clock::now();
+            TraceSpan span("plugin.handle_hook", &metrics.latency);
             
             try {
                 PluginResult result = plugin->handleHook(hook, context);
@@ -565,6 +575,7 @@ std::vector<PluginResult> PluginManager::executeHook(PluginHook hook, const Plug
                 
                 if (!result.success) {
                     errorCounts_[pluginName]++;
+                    metrics.errors.increment();
                 }
             } catch (const std::exception&) {
                 PluginResult errorResult;
@@ -573,6 +584,7 @@ std::vector<PluginResult> PluginManager::executeHook(PluginHook hook, const Plug
                 results.push_back(errorResult);
                 
                 errorCounts_[pluginName]++;
+                metrics.errors.increment();
             }
         }
     }
@@ -604,7 +616,9 @@ PluginResult PluginManager::executePlugin(const std::string& pluginName, const P
         return result;
     }
     
+    PluginMetrics& metrics = metricsFor(pluginName);
     auto start = std::chrono::high_resolution_clock::now();
+    TraceSpan span("plugin.execute", &metrics.latency);
     
     try {
         result = plugin->execute(context);
@@ -618,11 +632,13 @@ PluginResult PluginManager::executePlugin(const std::string& pluginName, const P
         
         if (!result.success) {
             errorCounts_[pluginName]++;
+            metrics.errors.increment();
         }
     } catch (const std::exception&) {
         result.success = false;
         result.message = "Plugin execution failed with exception";
         errorCounts_[pluginName]++;
+        metrics.errors.increment();
     }
     
     return result;
@@ -657,7 +673,7 @@ JsonValue PluginManager::getExecutionStats() const {
     std::lock_guard<std::mutex> lock(managerMutex_);
     
     JsonValue stats;
-    stats["totalPlugins"] = std::string(std::to_string(enabledPlugins_.size()));
+    stats["totalPlugins"] = enabledPlugins_.size();
     
     size_t totalExecutions = 0;
     size_t totalErrors = 0;
@@ -670,14 +686,14 @@ JsonValue PluginManager::getExecutionStats() const {
         totalErrors += pair.second;
     }
     
-    stats["totalExecutions"] = std::string(std::to_string(totalExecutions));
-    stats["totalErrors"] = std::string(std::to_string(totalErrors));
+    stats["totalExecutions"] = totalExecutions;
+    stats["totalErrors"] = totalErrors;
     
     if (totalExecutions > 0) {
         double errorRate = static_cast<double>(totalErrors) / totalExecutions;
-        stats["errorRate"] = std::string(std::to_string(errorRate));
+        stats["errorRate"] = errorRate;
     } else {
-        stats["errorRate"] = std::string("0.0");
+        stats["errorRate"] = 0.0;
     }
     
     return stats;
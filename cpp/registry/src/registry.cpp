@@ -41,11 +41,12 @@ Registry::Registry(const RegistryConfig& config) : config_(config), lastRefreshT
 }
 
 Registry::~Registry() {
+    tasks_.wait();
     logInfo("Registry destructor called", "registry");
 }
 
 std::future<bool> Registry::refreshRegistry() {
-    return std::async(std::launch::async, [this]() {
+    return tasks_.async([this]() {
         logInfo("Refreshing registry data...", "registry");
         
         // First try to load from remote if enabled
@@ -46,11 +46,10 @@ TEST_F(AgentActionTest, ActionExecution) {
     testAction.description = "Returns the input message";
     testAction.handler = [](const JsonValue& args) -> JsonValue {
         JsonValue result;
-        if (args.count("message")) {
-            try {
-                auto message = std::any_cast<std::string>(args.at("message"));
-                result["echo"] = message;
-            } catch (const std::bad_any_cast&) {
+        if (const JsonValue* message = args.find("message")) {
+            if (message->isString()) {
+                result["echo"] = message->asString();
+            } else {
                 result["echo"] = std::string("Could not parse message");
             }
         } else {
@@ -67,8 +66,8 @@ TEST_F(AgentActionTest, ActionExecution) {
     
     auto result = agentAction->useAction("echo_action", arguments);
     
-    EXPECT_TRUE(std::any_cast<bool>(result["success"]));
-    EXPECT_EQ(std::any_cast<std::string>(result["echo"]), "Hello, World!");
+    EXPECT_TRUE(result["success"].asBool());
+    EXPECT_EQ(result["echo"].asString(), "Hello, World!");
 }
 
 TEST_F(AgentActionTest, NonExistentAction) {
@@ -76,8 +75,8 @@ TEST_F(AgentActionTest, NonExistentAction) {
     JsonValue arguments;
     auto result = agentAction->useAction("nonexistent_action", arguments);
     
-    EXPECT_FALSE(std::any_cast<bool>(result["success"]));
-    EXPECT_EQ(std::any_cast<std::string>(result["error"]), "Action not found");
+    EXPECT_FALSE(result["success"].asBool());
+    EXPECT_EQ(result["error"].asString(), "Action not found");
 }
 
 TEST_F(AgentActionTest, ActionHistory) {
@@ -105,7 +104,7 @@ TEST_F(AgentActionTest, ActionHistory) {
     // Check last action
     auto lastAction = agentAction->getLastAction();
     EXPECT_FALSE(lastAction.empty());
-    EXPECT_EQ(std::any_cast<std::string>(lastAction["document"]), "history_test");
+    EXPECT_EQ(lastAction["document"].asString(), "history_test");
 }
 
 TEST_F(AgentActionTest, PromptComposition) {
@@ -115,10 +114,10 @@ TEST_F(AgentActionTest, PromptComposition) {
     testAction.prompt = "Default prompt";
     testAction.description = "Test prompt composition";
     testAction.builder = [](const JsonValue& values) -> std::string {
-        if (values.count("custom_prompt")) {
-            try {
-                return std::any_cast<std::string>(values.at("custom_prompt"));
-            } catch (const std::bad_any_cast&) {}
+        if (const JsonValue* prompt = values.find("custom_prompt")) {
+            if (prompt->isString()) {
+                return std::string(prompt->asString());
+            }
         }
         return "Built prompt";
     };
@@ -164,7 +163,7 @@ TEST_F(AgentActionTest, SearchActions) {
     // Check that search results contain expected actions
     bool found_search_1 = false, found_search_2 = false;
     for (const auto& result : results) {
-        auto document = std::any_cast<std::string>(result.at("document"));
+        auto document = result.getString("document");
         if (document.find("First search test") != std::string::npos) {
             found_search_1 = true;
         }
@@ -187,15 +186,15 @@ TEST_F(AgentActionTest, GetFormattedActions) {
     // Get formatted actions
     auto formatted = agentAction->getFormattedActions("format");
     
-    EXPECT_TRUE(formatted.count("available_actions"));
-    EXPECT_TRUE(formatted.count("formatted_actions"));
-    EXPECT_TRUE(formatted.count("short_actions"));
+    EXPECT_TRUE(formatted.contains("available_actions"));
+    EXPECT_TRUE(formatted.contains("formatted_actions"));
+    EXPECT_TRUE(formatted.contains("short_actions"));
     
     // Check that the formatted string contains expected content
-    auto formattedStr = std::any_cast<std::string>(formatted["formatted_actions"]);
+    auto formattedStr = formatted.getString("formatted_actions");
     EXPECT_TRUE(formattedStr.find("Available actions") != std::string::npos);
     
-    auto shortStr = std::any_cast<std::string>(formatted["short_actions"]);
+    auto shortStr = formatted.getString("short_actions");
     EXPECT_TRUE(shortStr.find("Available actions (name)") != std::string::npos);
 }
 
@@ -0,0 +1,265 @@
+#include <gtest/gtest.h>
+#include "elizaos/agentbrowser.hpp"
+#include "elizaos/html.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+using namespace elizaos;
+
+namespace {
+
+const char* SAMPLE_PAGE = R"(<!DOCTYPE html>
+<html>
+<head><title>Tom &amp; Jerry</title><style>p { color: red }</style></head>
+<body>
+  <div id="main" class="content wide">
+    <h1>Episodes</h1>
+    <ul class="list">
+      <li class="item">First <a href="/one">one</a>
+      <li class="item selected">Second <a href="two.html">two</a>
+      <li class="item" hidden>Third</li>
+    </ul>
+    <p>Cats &lt;3 mice&nbsp;&#x2764;<p>Second paragraph
+    <img src="cat.png"><br>
+    <script>if (a < b) { document.write("</div>"); }</script>
+    <table><tr><td>a<td>b<tr><td>c</table>
+    <input id="name" type="text" disabled>
+  </div>
+</body>
+</html>)";
+
+std::vector<std::string> names(const std::vector<const HtmlNode*>& nodes) {
+    std::vector<std::string> result;
+    for (const HtmlNode* node : nodes) result.emplace_back(node->name);
+    return result;
+}
+
+// Article-like text of count words drawn from a fixed vocabulary
+std::string makeArticle(uint32_t seed, size_t count) {
+    std::string text;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        text += "word" + std::to_string((seed >> 8) % 2000) + (i % 12 == 11 ? ". " : " ");
+    }
+    return text;
+}
+
+} // anonymous namespace
+
+TEST(HtmlDocumentTest, BuildsTreeWithImpliedEndTagsAndRawText) {
+    auto document = HtmlDocument::parse(SAMPLE_PAGE);
+
+    EXPECT_EQ(document->getTitle(), "Tom & Jerry");
+    EXPECT_EQ(document->getElementsByTagName("li").size(), 3u);
+    EXPECT_EQ(document->getElementsByTagName("p").size(), 2u);
+    EXPECT_EQ(document->getElementsByTagName("tr").size(), 2u);
+    EXPECT_EQ(document->getElementsByTagName("td").size(), 3u);
+
+    // An unclosed li ends at the next li rather than nesting
+    for (const HtmlNode* item : document->getElementsByTagName("li")) {
+        EXPECT_EQ(item->parent->name, "ul");
+    }
+    // Markup inside script is text, so the div is not closed early
+    const HtmlNode* input = document->getElementById("name");
+    ASSERT_NE(input, nullptr);
+    EXPECT_EQ(input->parent, document->getElementById("main"));
+
+    const HtmlNode* paragraph = document->getElementsByTagName("p").front();
+    EXPECT_EQ(document->textContent(*paragraph), "Cats <3 mice ❤");
+    EXPECT_EQ(document->getElementsByClassName("item").size(), 3u);
+    EXPECT_EQ(document->getElementsByClassName("wide").front()->getAttribute("id"), "main");
+}
+
+TEST(HtmlDocumentTest, CssSelectorsMatchRightToLeft) {
+    auto document = HtmlDocument::parse(SAMPLE_PAGE);
+
+    EXPECT_EQ(document->querySelectorAll("ul > li.item").size(), 3u);
+    EXPECT_EQ(document->querySelectorAll("#main li.selected a").front()->getAttribute("href"), "two.html");
+    EXPECT_EQ(document->querySelectorAll("li:nth-child(2n+1)").size(), 2u);
+    EXPECT_EQ(document->querySelectorAll("li:not(.selected)").size(), 2u);
+    EXPECT_EQ(document->querySelectorAll("a[href^='/']").size(), 1u);
+    EXPECT_EQ(document->querySelectorAll("h1 + ul").size(), 1u);
+    EXPECT_EQ(document->querySelectorAll("h1 ~ p").size(), 2u);
+    EXPECT_EQ(document->querySelectorAll("div[class~=content]").size(), 1u);
+    EXPECT_EQ(names(document->querySelectorAll("img, h1, input")),
+              (std::vector<std::string>{"h1", "img", "input"}));
+    EXPECT_EQ(document->querySelector("td:last-child")->firstChild->text, "b");
+
+    std::string error;
+    EXPECT_FALSE(CssSelector::compile("div >", &error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(CssSelector::compile("li:hover", &error));
+}
+
+TEST(HtmlDocumentTest, DuplicateIdsOnDifferentTagsAllMatch) {
+    auto document = HtmlDocument::parse("<span id=x>a</span><div id=x>b</div><div id=x>c</div>");
+
+    EXPECT_EQ(document->querySelectorAll("#x").size(), 3u);
+    EXPECT_EQ(names(document->querySelectorAll("div#x")), (std::vector<std::string>{"div", "div"}));
+    EXPECT_EQ(document->querySelectorAll("span#x").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath("//*[@id='x']").size(), 3u);
+    EXPECT_EQ(document->getElementById("x")->name, "span");
+    EXPECT_EQ(document->getElementsById("x").size(), 3u);
+    EXPECT_TRUE(document->querySelectorAll("#y").empty());
+}
+
+TEST(HtmlDocumentTest, XPathSubsetCompilesToSameMatcher) {
+    auto document = HtmlDocument::parse(SAMPLE_PAGE);
+
+    EXPECT_EQ(document->evaluateXPath("/html/body/div").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath("/body").size(), 0u);
+    EXPECT_EQ(document->evaluateXPath("//ul/li[2]/a").front()->getAttribute("href"), "two.html");
+    EXPECT_EQ(document->evaluateXPath("//li[last()]").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath("//a[contains(text(), 'tw')]").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath("//li[contains(., 'one')]").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath("//*[@id='name' and @disabled]").size(), 1u);
+    EXPECT_EQ(document->evaluateXPath(browser_utils::xpathSelector("h1", "Epi")).size(), 1u);
+    EXPECT_FALSE(CssSelector::compileXPath("li"));
+    EXPECT_FALSE(CssSelector::compileXPath("//li[position() > 1]"));
+}
+
+TEST(HtmlDocumentTest, ExtractsReadableTextAndSerializes) {
+    auto document = HtmlDocument::parse(SAMPLE_PAGE);
+    std::string text = document->extractText();
+
+    EXPECT_EQ(text.find("Tom"), std::string::npos);
+    EXPECT_EQ(text.find("color"), std::string::npos);
+    EXPECT_EQ(text.find("document.write"), std::string::npos);
+    EXPECT_NE(text.find("Episodes\nFirst one\nSecond two\nThird\n"), std::string::npos);
+    EXPECT_NE(text.find("Second paragraph"), std::string::npos);
+
+    auto fragment = HtmlDocument::parse("<p class=\"a&quot;b\">x &lt; y<br></p>");
+    EXPECT_EQ(fragment->outerHtml(fragment->getRoot()), "<p class=\"a&quot;b\">x &lt; y<br></p>");
+    EXPECT_EQ(decodeHtmlEntities("&amp;&bogus;&#65;&#x1F600;"), "&&bogus;A\xF0\x9F\x98\x80");
+}
+
+TEST(AgentBrowserTest, QueriesLoadedPagesOffline) {
+    AgentBrowser browser;
+    ASSERT_TRUE(browser.initialize());
+
+    auto path = std::filesystem::temp_directory_path() / "elizaos_agentbrowser_test.html";
+    {
+        std::ofstream file(path);
+        file << SAMPLE_PAGE;
+    }
+    ASSERT_TRUE(browser.navigateTo("file://" + path.string()));
+    std::filesystem::remove(path);
+
+    EXPECT_EQ(browser.getPageTitle(), "Tom & Jerry");
+    auto links = browser.getLinks();
+    ASSERT_EQ(links.size(), 2u);
+    EXPECT_EQ(links[0], "file:///one");
+    EXPECT_EQ(links[1], "file://" + path.parent_path().string() + "/two.html");
+
+    auto input = browser.findElement("name", SelectorType::ID);
+    ASSERT_TRUE(input);
+    EXPECT_EQ(input->tag, "input");
+    EXPECT_FALSE(input->isEnabled);
+    EXPECT_EQ(browser.findElements("item", SelectorType::CLASS_NAME).size(), 3u);
+    EXPECT_FALSE(browser.findElements("//li", SelectorType::XPATH).back().isVisible);
+    EXPECT_FALSE(browser.findElement("div >"));
+
+    EXPECT_TRUE(browser.waitForText("Second paragraph", 0));
+    EXPECT_EQ(browser.waitForElementClickable("#name", 0).result, BrowserActionResult::TIMEOUT);
+
+    // A page loaded from another thread wakes the waiter
+    std::thread loader([&browser]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        browser.loadHTML("<button class=go>Go</button>", "https://example.com/next");
+    });
+    auto result = browser.waitForElementClickable("button.go", 5);
+    loader.join();
+    EXPECT_TRUE(result);
+    EXPECT_EQ(browser.getLinks().size(), 0u);
+
+    browser.shutdown();
+}
+
+TEST(AgentBrowserTest, ResolvesRelativeUrls) {
+    const std::string base = "https://example.com/a/b/page.html?q=1#top";
+    EXPECT_EQ(browser_utils::resolveUrl(base, "c.html"), "https://example.com/a/b/c.html");
+    EXPECT_EQ(browser_utils::resolveUrl(base, "../c.html?x"), "https://example.com/a/c.html?x");
+    EXPECT_EQ(browser_utils::resolveUrl(base, "/root"), "https://example.com/root");
+    EXPECT_EQ(browser_utils::resolveUrl(base, "//cdn.example.com/x.js"), "https://cdn.example.com/x.js");
+    EXPECT_EQ(browser_utils::resolveUrl(base, "#part"), "https://example.com/a/b/page.html?q=1#part");
+    EXPECT_EQ(browser_utils::resolveUrl(base, "mailto:someone@example.com"), "mailto:someone@example.com");
+    EXPECT_EQ(browser_utils::resolveUrl("https://example.com", "x/"), "https://example.com/x/");
+}
+
+TEST(PageIndexTest, CanonicalizesUrls) {
+    EXPECT_EQ(PageIndex::normalizeUrl("HTTP://Example.COM:80/a/./b/../c?utm_source=x&b=2&a=1#frag"),
+              "http://example.com/a/c?a=1&b=2");
+    EXPECT_EQ(PageIndex::normalizeUrl(" https://Example.com "), "https://example.com/");
+    EXPECT_EQ(PageIndex::normalizeUrl("https://example.com:8443/%7euser/%2f?q=%41&fbclid=1"),
+              "https://example.com:8443/~user/%2F?q=A");
+    EXPECT_EQ(PageIndex::normalizeUrl("https://user@Host./x/.."), "https://user@host/");
+    EXPECT_EQ(PageIndex::normalizeUrl("mailto:someone@example.com"), "mailto:someone@example.com");
+
+    PageIndex index;
+    index.recordVisit("https://example.com/docs?utm_medium=email", "read docs");
+    EXPECT_TRUE(index.hasVisited("https://EXAMPLE.com/docs#install"));
+    EXPECT_FALSE(index.hasVisited("https://example.com/docs/"));
+    EXPECT_EQ(index.recordVisit("https://example.com/docs", "").visits, 2u);
+    EXPECT_EQ(index.size(), 1u);
+}
+
+TEST(PageIndexTest, FindsNearDuplicatesThroughBands) {
+    PageIndex index;
+    std::string article = makeArticle(1, 2000);
+    std::string edited = article;
+    edited.replace(edited.find("word"), 4, "changed");
+
+    EXPECT_FALSE(index.recordVisit("https://news.example.com/story", "news", article).duplicateOf);
+    for (uint32_t seed = 2; seed < 50; ++seed) {
+        index.recordVisit("https://news.example.com/other/" + std::to_string(seed), "news", makeArticle(seed, 2000));
+    }
+    EXPECT_LE(PageIndex::hammingDistance(PageIndex::fingerprint(article), PageIndex::fingerprint(edited)), 3);
+
+    PageVisit mirror = index.recordVisit("https://mirror.example.org/story", "news", edited);
+    ASSERT_TRUE(mirror.duplicateOf);
+    EXPECT_EQ(*mirror.duplicateOf, "https://news.example.com/story");
+    EXPECT_EQ(index.findNearDuplicates(article).size(), 2u);
+    EXPECT_TRUE(index.findNearDuplicates(makeArticle(99, 2000)).empty());
+    EXPECT_TRUE(index.findNearDuplicates(" ... ").empty());
+
+    // A changed page moves to its new buckets
+    index.recordVisit("https://mirror.example.org/story", "news", makeArticle(77, 2000));
+    EXPECT_EQ(index.findNearDuplicates(article), (std::vector<std::string>{"https://news.example.com/story"}));
+}
+
+TEST(PageIndexTest, RecallsPagesBySimilarPurpose) {
+    PageIndex index;
+    index.recordVisit("https://shop.example.com/cart", "buy running shoes");
+    index.recordVisit("https://shop.example.com/search?q=shoes", "compare running shoes prices");
+    index.recordVisit("https://weather.example.com/", "check weather forecast");
+    for (int i = 0; i < 20; ++i) {
+        index.recordVisit("https://example.com/page" + std::to_string(i), "navigation");
+    }
+
+    auto pages = index.findByPurpose("Running shoes", 3);
+    ASSERT_EQ(pages.size(), 2u);
+    EXPECT_EQ(pages[0], "https://shop.example.com/cart");
+    EXPECT_EQ(index.findByPurpose("weather"), (std::vector<std::string>{"https://weather.example.com/"}));
+    EXPECT_EQ(index.findByPurpose("navigation", 5).front(), "https://example.com/page19");
+    EXPECT_TRUE(index.findByPurpose("unrelated").empty());
+}
+
+TEST(AgentBrowserTest, IndexesLoadedPages) {
+    AgentBrowser browser;
+    ASSERT_TRUE(browser.initialize());
+
+    std::string body = "<html><body><p>" + makeArticle(5, 300) + "</p></body></html>";
+    browser.loadHTML(body, "https://example.com/article?utm_campaign=x");
+    browser.rememberPage("https://example.com/article", "research agent memory");
+    browser.loadHTML("<div>" + body + "</div>", "https://copy.example.com/article");
+
+    EXPECT_TRUE(browser.hasVisited("https://example.com/article"));
+    auto copy = browser.getPageIndex().getVisit("https://copy.example.com/article");
+    ASSERT_TRUE(copy);
+    EXPECT_EQ(copy->duplicateOf, std::optional<std::string>("https://example.com/article"));
+    EXPECT_EQ(browser.getSimilarPages("agent memory"), (std::vector<std::string>{"https://example.com/article"}));
+
+    browser.shutdown();
+}
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 #include "elizaos/agentcomms.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/replay.hpp"
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <set>
 
 using namespace elizaos;
 
@@ -192,6 +198,40 @@ TEST_F(AgentCommsTest, StartStopCycle) {
     EXPECT_FALSE(channel->isActive());
 }
 
+TEST_F(AgentCommsTest, ChannelsShareTheExecutorAndKeepMessageOrder) {
+    constexpr int CHANNELS = 64;
+    constexpr int MESSAGES = 20;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::set<std::thread::id> threads;
+    std::vector<std::vector<int>> received(CHANNELS);
+    int total = 0;
+
+    for (int c = 0; c < CHANNELS; ++c) {
+        auto channel = comms->createChannel("channel_" + std::to_string(c));
+        channel->setMessageHandler([&, c](const Message& msg) {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+            received[c].push_back(std::stoi(msg.content));
+            if (++total == CHANNELS * MESSAGES) done.notify_all();
+        });
+    }
+    comms->start();
+    for (int i = 0; i < MESSAGES; ++i) {
+        for (int c = 0; c < CHANNELS; ++c) {
+            Message msg("", MessageType::TEXT, "sender", "receiver", std::to_string(i));
+            ASSERT_TRUE(comms->getChannel("channel_" + std::to_string(c))->sendMessage(msg));
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds(5), [&] { return total == CHANNELS * MESSAGES; }));
+    EXPECT_LE(threads.size(), Executor::global().getBlockingThreadCount());
+    std::vector<int> expected(MESSAGES);
+    for (int i = 0; i < MESSAGES; ++i) expected[i] = i;
+    for (const auto& messages : received) EXPECT_EQ(messages, expected);
+}
+
 TEST_F(AgentCommsTest, TCPConnector) {
     // Test basic TCP connector functionality
     TCPConnector connector;
@@ -225,4 +265,55 @@ TEST_F(AgentCommsTest, ConvenienceFunctions) {
     shutdownComms();
     
     EXPECT_TRUE(true); // Test completed without crashing
-}
\ No newline at end of file
+}
+
+TEST_F(AgentCommsTest, RecordedMessagesReplayIntoChannel) {
+    const std::string path = ::testing::TempDir() + "comms_trace.bin";
+    auto channel = comms->createChannel("recorded_channel");
+    comms->createChannel("other_channel");
+    comms->start();
+
+    TraceRecorder recorder;
+    ASSERT_TRUE(recorder.start(path, 11));
+    Message msg("recorded-id", MessageType::COMMAND, "sender", "receiver", "recorded_channel", "run it");
+    msg.setMetadata("priority", "high");
+    EXPECT_TRUE(channel->sendMessage(msg));
+    EXPECT_TRUE(comms->sendMessage("other_channel", Message("", MessageType::TEXT, "s", "r", "elsewhere")));
+    ASSERT_TRUE(recorder.stop());
+    EXPECT_EQ(recorder.getEventCount(), 2u);
+
+    CommChannel replayChannel("recorded_channel");
+    std::mutex receivedMutex;
+    std::condition_variable receivedChanged;
+    std::vector<Message> received;
+    replayChannel.setMessageHandler([&](const Message& message) {
+        std::lock_guard<std::mutex> lock(receivedMutex);
+        received.push_back(message);
+        receivedChanged.notify_all();
+    });
+    replayChannel.start();
+
+    TraceReplayer replayer;
+    addChannelReplay(replayer, replayChannel);
+    ReplayOptions options;
+    options.asFastAsPossible = true;
+    auto report = replayer.run(path, options);
+    ASSERT_TRUE(report.has_value());
+    EXPECT_EQ(report->eventCount, 2u);
+    EXPECT_TRUE(report->complete);
+
+    // stop() does not drain the queue, so wait for the delivery first
+    {
+        std::unique_lock<std::mutex> lock(receivedMutex);
+        receivedChanged.wait_for(lock, std::chrono::seconds(5), [&] { return !received.empty(); });
+    }
+    replayChannel.stop();
+    std::lock_guard<std::mutex> lock(receivedMutex);
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].id, "recorded-id");
+    EXPECT_EQ(received[0].type, MessageType::COMMAND);
+    EXPECT_EQ(received[0].content, "run it");
+    EXPECT_EQ(received[0].getMetadata("priority"), "high");
+    EXPECT_EQ(received[0].timestamp, msg.timestamp);
+    std::remove(path.c_str());
+}
@@ -1,8 +1,14 @@
 #include <gtest/gtest.h>
 #include "elizaos/agentmemory.hpp"
+#include "elizaos/attention.hpp"
 #include "elizaos/core.hpp"
+#include "elizaos/uuid.hpp"
+#include <cctype>
+#include <chrono>
+#include <cstdio>
 #include <memory>
 #include <thread>
+#include <vector>
 #include <ctime>
 
 using namespace elizaos;
@@ -415,4 +421,369 @@ TEST_F(AgentMemoryTest, ClearAllMemories) {
     // Verify memories are gone
     EXPECT_EQ(memory::retrieve("mem1"), nullptr);
     EXPECT_EQ(memory::retrieve("mem2"), nullptr);
-}
\ No newline at end of file
+}
+// Test memory and attention state surviving a snapshot round trip
+TEST_F(AgentMemoryTest, SnapshotRestoresMemoriesAndAttention) {
+    const std::string path = ::testing::TempDir() + "agentmemory_snapshot.bin";
+
+    AgentMemoryManager manager;
+    auto memory = createTestMemory(testMemoryId1, "Remembered fact");
+    memory->setRoomId(testRoomId);
+    memory->setEmbedding({0.1f, 0.2f, 0.3f});
+    FragmentMetadata fragment;
+    fragment.documentId = "doc-1";
+    fragment.position = 7;
+    memory->setMetadata(fragment);
+    manager.createMemory(memory);
+    manager.createMemory(createTestMemory(testMemoryId2, "Archived fact"), "archive");
+
+    AttentionAllocator allocator;
+    AttentionValue value;
+    value.importance = 0.8;
+    value.urgency = 0.4;
+    allocator.updateAttentionValue(testMemoryId1, value);
+    allocator.addAttentionLink(testMemoryId1, testMemoryId2, 0.5);
+
+    SnapshotManager snapshots;
+    snapshots.registerComponent(manager);
+    snapshots.registerComponent(allocator);
+    std::string error;
+    ASSERT_TRUE(snapshots.save(path, &error)) << error;
+
+    AgentMemoryManager restoredManager;
+    AttentionAllocator restoredAllocator;
+    SnapshotManager restorer;
+    restorer.registerComponent(restoredManager);
+    restorer.registerComponent(restoredAllocator);
+    ASSERT_TRUE(restorer.restore(path, &error)) << error;
+
+    auto restored = restoredManager.getMemoryById(testMemoryId1);
+    ASSERT_NE(restored, nullptr);
+    EXPECT_EQ(restored->getContent(), "Remembered fact");
+    EXPECT_EQ(restored->getRoomId(), testRoomId);
+    EXPECT_EQ(restored->getEmbedding(), memory->getEmbedding());
+    ASSERT_TRUE(std::holds_alternative<FragmentMetadata>(restored->getMetadata()));
+    EXPECT_EQ(std::get<FragmentMetadata>(restored->getMetadata()).position, 7u);
+    EXPECT_EQ(restoredManager.getMemoriesByIds({testMemoryId2}, "archive").size(), 1u);
+
+    ASSERT_TRUE(restoredAllocator.hasAttentionValue(testMemoryId1));
+    EXPECT_DOUBLE_EQ(restoredAllocator.getAttentionValue(testMemoryId1).importance, 0.8);
+    EXPECT_DOUBLE_EQ(restoredAllocator.getAttentionValue(testMemoryId1).urgency, 0.4);
+    std::remove(path.c_str());
+}
+
+TEST_F(AgentMemoryTest, GovernorShrinksOnlyEvictableTablesOldestFirst) {
+    AgentMemoryManager manager;
+    auto base = std::chrono::system_clock::now();
+    for (int i = 0; i < 10; ++i) {
+        auto cached = createTestMemory("cached-" + std::to_string(i), std::string(200, 'c'));
+        cached->setCreatedAt(base + std::chrono::seconds(i));
+        manager.createMemory(cached, "cache");
+    }
+    manager.createMemory(createTestMemory(testMemoryId1, std::string(200, 'k')));
+    manager.setTableEvictable("cache");
+
+    size_t before = manager.getAccountedBytes();
+    EXPECT_GT(before, 11 * 200u);
+
+    // Roughly three entries' worth goes, taken from the oldest cached memories
+    size_t freed = manager.shrinkMemory(before / 4);
+    EXPECT_GE(freed, before / 4);
+    EXPECT_EQ(manager.getAccountedBytes(), before - freed);
+    EXPECT_EQ(manager.getMemoryById("cached-0"), nullptr);
+    EXPECT_NE(manager.getMemoryById("cached-9"), nullptr);
+    EXPECT_NE(manager.getMemoryById(testMemoryId1), nullptr);
+
+    manager.shrinkMemory(before);
+    EXPECT_NE(manager.getMemoryById(testMemoryId1), nullptr);
+    EXPECT_EQ(manager.getMemoriesByIds({"cached-9"}, "cache").size(), 0u);
+
+    manager.deleteMemory(testMemoryId1);
+    EXPECT_EQ(manager.getAccountedBytes(), 0u);
+
+    // The attention novelty model sheds its rarest features
+    AttentionAllocator allocator;
+    allocator.calculateNovelty("common common common rare", {});
+    allocator.updateNoveltyModel("common");
+    size_t noveltyBytes = allocator.getAccountedBytes();
+    EXPECT_GT(noveltyBytes, 0u);
+    EXPECT_GT(allocator.shrinkMemory(1), 0u);
+    EXPECT_LT(allocator.getAccountedBytes(), noveltyBytes);
+}
+
+TEST_F(AgentMemoryTest, ChangeFeedTailsWritesPerTable) {
+    AgentMemoryManager manager;
+    EXPECT_EQ(manager.getLatestSequence(), 0u);
+
+    auto first = createTestMemory(testMemoryId1, "first");
+    first->setRoomId(testRoomId);
+    manager.createMemory(first);
+    manager.createMemory(createTestMemory(testMemoryId2, "second"));
+    manager.createMemory(createTestMemory("archived-1", "archived"), "archive");
+    manager.updateMemory(createTestMemory(testMemoryId1, "first, edited"));
+    manager.deleteMemory(testMemoryId2);
+    manager.deleteMemory("missing-id");
+
+    auto batch = manager.readChanges("memories", 0);
+    EXPECT_FALSE(batch.truncated);
+    ASSERT_EQ(batch.changes.size(), 4u);
+    EXPECT_EQ(batch.cursor, 4u);
+    EXPECT_EQ(batch.changes[0].sequence, 1u);
+    EXPECT_EQ(batch.changes[0].kind, MemoryChangeKind::CREATED);
+    EXPECT_EQ(batch.changes[0].memory, first);
+    EXPECT_EQ(batch.changes[2].kind, MemoryChangeKind::UPDATED);
+    EXPECT_EQ(batch.changes[2].memory->getContent(), "first, edited");
+    EXPECT_EQ(batch.changes[3].kind, MemoryChangeKind::DELETED);
+    EXPECT_EQ(batch.changes[3].memory->getId(), testMemoryId2);
+    EXPECT_EQ(batch.changes[3].tableName, "memories");
+
+    // Each table has its own sequence; cursors resume where they stopped
+    EXPECT_EQ(manager.getLatestSequence("archive"), 1u);
+    auto page = manager.readChanges("memories", 1, 2);
+    ASSERT_EQ(page.changes.size(), 2u);
+    EXPECT_EQ(page.changes[0].sequence, 2u);
+    EXPECT_EQ(page.cursor, 3u);
+    EXPECT_TRUE(manager.readChanges("memories", 4).changes.empty());
+    EXPECT_FALSE(manager.readChanges("memories", 4).truncated);
+
+    // A cursor the trimmed log no longer reaches must resynchronise
+    manager.setChangeLogCapacity(2);
+    auto behind = manager.readChanges("memories", 1);
+    EXPECT_TRUE(behind.truncated);
+    EXPECT_EQ(behind.cursor, 4u);
+    EXPECT_EQ(manager.readChanges("memories", 2).changes.size(), 2u);
+
+    manager.clear();
+    EXPECT_TRUE(manager.readChanges("memories", 4).truncated);
+    EXPECT_EQ(manager.getLatestSequence(), 5u);
+    EXPECT_TRUE(manager.readChanges("memories", 5).changes.empty());
+    EXPECT_FALSE(manager.readChanges("memories", 5).truncated);
+}
+
+TEST_F(AgentMemoryTest, WaitForChangesWakesTailingReader) {
+    AgentMemoryManager manager;
+    EXPECT_FALSE(manager.waitForChanges("memories", 0, std::chrono::milliseconds(1)));
+
+    std::thread writer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        manager.createMemory(createTestMemory(testMemoryId1, "wake up"));
+    });
+    EXPECT_TRUE(manager.waitForChanges("memories", 0, std::chrono::seconds(10)));
+    writer.join();
+
+    auto batch = manager.readChanges("memories", 0);
+    ASSERT_EQ(batch.changes.size(), 1u);
+    EXPECT_EQ(batch.changes[0].memory->getContent(), "wake up");
+}
+
+TEST_F(AgentMemoryTest, LiveQueriesFollowMatchingMemories) {
+    AgentMemoryManager manager;
+    auto inRoom = [&](const UUID& id, const std::string& content) {
+        auto memory = createTestMemory(id, content);
+        memory->setRoomId(testRoomId);
+        return memory;
+    };
+    manager.createMemory(inRoom("existing", "before subscribing"));
+    manager.createMemory(createTestMemory("elsewhere", "other room"));
+
+    std::vector<LiveQueryEvent> events;
+    std::vector<std::shared_ptr<Memory>> initial;
+    LiveQuery query;
+    query.roomId = testRoomId;
+    uint64_t subscription = manager.subscribeLiveQuery(
+        query, [&](const LiveQueryEvent& event) { events.push_back(event); }, &initial);
+    ASSERT_EQ(initial.size(), 1u);
+    EXPECT_EQ(initial[0]->getId(), "existing");
+
+    manager.createMemory(inRoom(testMemoryId1, "joins the room"));
+    manager.createMemory(createTestMemory(testMemoryId2, "not in the room"));
+    manager.createMemory(inRoom("other-table", "archived"), "archive");
+    manager.updateMemory(createTestMemory("existing", "moved away"));
+    manager.updateMemory(createTestMemory("existing", "still away"));
+    manager.deleteMemory(testMemoryId1);
+    manager.deleteMemory(testMemoryId2);
+
+    ASSERT_EQ(events.size(), 4u);
+    EXPECT_EQ(events[0].change.kind, MemoryChangeKind::CREATED);
+    EXPECT_TRUE(events[0].matches);
+    EXPECT_EQ(events[1].change.memory->getContent(), "archived");
+    EXPECT_EQ(events[1].change.tableName, "archive");
+    EXPECT_EQ(events[2].change.kind, MemoryChangeKind::UPDATED);
+    EXPECT_FALSE(events[2].matches);
+    EXPECT_EQ(events[3].change.kind, MemoryChangeKind::DELETED);
+    EXPECT_EQ(events[3].change.memory->getId(), testMemoryId1);
+    EXPECT_FALSE(events[3].matches);
+
+    EXPECT_TRUE(manager.unsubscribeLiveQuery(subscription));
+    EXPECT_FALSE(manager.unsubscribeLiveQuery(subscription));
+    manager.createMemory(inRoom("late", "after unsubscribing"));
+    EXPECT_EQ(events.size(), 4u);
+}
+
+TEST_F(AgentMemoryTest, LiveQueryBySimilarityPushesToSubscribers) {
+    AgentMemoryManager manager;
+    auto withEmbedding = [&](const UUID& id, EmbeddingVector embedding) {
+        auto memory = createTestMemory(id, id);
+        memory->setEmbedding(embedding);
+        return memory;
+    };
+
+    std::vector<LiveQueryEvent> events;
+    LiveQuery query;
+    query.tableName = "memories";
+    query.embedding = {1.0f, 0.0f, 0.0f};
+    query.matchThreshold = 0.9;
+    manager.subscribeLiveQuery(query, [&](const LiveQueryEvent& event) {
+        events.push_back(event);
+        // Callbacks may write; the nested change is delivered after this one
+        if (event.change.memory->getId() == "close") {
+            manager.createMemory(withEmbedding("echo", {1.0f, 0.05f, 0.0f}));
+        }
+    });
+
+    manager.createMemory(withEmbedding("far", {0.0f, 1.0f, 0.0f}));
+    manager.createMemory(createTestMemory("no-embedding", "text only"));
+    manager.createMemory(withEmbedding("close", {1.0f, 0.1f, 0.0f}));
+    manager.createMemory(withEmbedding("close-elsewhere", {1.0f, 0.0f, 0.0f}), "archive");
+
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].change.memory->getId(), "close");
+    EXPECT_GT(events[0].similarity, 0.99);
+    EXPECT_TRUE(events[0].matches);
+    EXPECT_EQ(events[1].change.memory->getId(), "echo");
+    EXPECT_EQ(events[1].change.sequence, 4u);
+
+    // Eviction drops memories from results without an event
+    manager.setTableEvictable("memories");
+    manager.shrinkMemory(manager.getAccountedBytes());
+    manager.createMemory(withEmbedding("close", {0.0f, 0.0f, 1.0f}));
+    EXPECT_EQ(events.size(), 2u);
+}
+
+TEST_F(AgentMemoryTest, BulkLoadMatchesSequentialCreates) {
+    // Crosses both the prepare chunk and the apply slice, with duplicate
+    // content, repeated ids and invalid entries mixed in
+    std::vector<std::shared_ptr<Memory>> batch;
+    for (int i = 0; i < 20000; ++i) {
+        auto memory = createTestMemory("bulk-" + std::to_string(i % 19000), "content " + std::to_string(i % 15000));
+        memory->setRoomId(i % 2 ? testRoomId : "room-other");
+        batch.push_back(memory);
+    }
+    batch[5] = nullptr;
+    batch[6] = createTestMemory("", "no id");
+
+    for (bool unique : {false, true}) {
+        AgentMemoryManager sequential;
+        AgentMemoryManager bulk;
+        auto seed = createTestMemory("seed", "content 7");
+        seed->setRoomId(testRoomId);
+        sequential.createMemory(seed, "import", unique);
+        bulk.createMemory(seed, "import", unique);
+
+        std::vector<UUID> expected;
+        for (const auto& memory : batch) {
+            expected.push_back(memory && !memory->getId().empty() ? sequential.createMemory(memory, "import", unique) : "");
+        }
+        auto result = bulk.createMemories(batch, "import", unique);
+
+        EXPECT_EQ(result.ids, expected);
+        EXPECT_EQ(result.rejected, 2u);
+        EXPECT_EQ(result.inserted + result.replaced + result.duplicates + result.rejected, batch.size());
+        EXPECT_EQ(result.duplicates > 0, unique);
+        EXPECT_EQ(bulk.countMemories(testRoomId, false, "import"), sequential.countMemories(testRoomId, false, "import"));
+        EXPECT_EQ(bulk.getAccountedBytes(), sequential.getAccountedBytes());
+        EXPECT_EQ(bulk.getLatestSequence("import"), sequential.getLatestSequence("import"));
+
+        // The log ends with the same changes, though most of the batch
+        // never fitted into it
+        uint64_t cursor = bulk.getLatestSequence("import") - 100;
+        auto tail = bulk.readChanges("import", cursor);
+        auto expectedTail = sequential.readChanges("import", cursor);
+        ASSERT_EQ(tail.changes.size(), 100u);
+        ASSERT_EQ(expectedTail.changes.size(), 100u);
+        for (size_t i = 0; i < tail.changes.size(); ++i) {
+            EXPECT_EQ(tail.changes[i].sequence, expectedTail.changes[i].sequence);
+            EXPECT_EQ(tail.changes[i].kind, expectedTail.changes[i].kind);
+            EXPECT_EQ(tail.changes[i].memory, expectedTail.changes[i].memory);
+        }
+        EXPECT_TRUE(bulk.readChanges("import", 1).truncated);
+    }
+}
+
+TEST_F(AgentMemoryTest, UniqueInsertsFollowUpdatesAndDeletes) {
+    AgentMemoryManager manager;
+    std::vector<LiveQueryEvent> events;
+    LiveQuery query;
+    query.tableName = "import";
+    manager.subscribeLiveQuery(query, [&](const LiveQueryEvent& event) { events.push_back(event); });
+
+    auto result = manager.createMemories({createTestMemory(testMemoryId1, "hello"),
+                                          createTestMemory(testMemoryId2, "hello"),
+                                          createTestMemory("third", "world")},
+                                         "import", true);
+    EXPECT_EQ(result.ids, (std::vector<UUID>{testMemoryId1, testMemoryId1, "third"}));
+    EXPECT_EQ(result.inserted, 2u);
+    EXPECT_EQ(result.duplicates, 1u);
+    EXPECT_EQ(events.size(), 2u);
+    EXPECT_EQ(manager.readChanges("import", 0).changes.size(), 2u);
+
+    // The index follows updates and deletes made after it was built
+    EXPECT_EQ(manager.createMemory(createTestMemory("fourth", "world"), "import", true), "third");
+    manager.updateMemory(createTestMemory("third", "changed"));
+    EXPECT_EQ(manager.createMemory(createTestMemory("fifth", "changed"), "import", true), "third");
+    EXPECT_EQ(manager.createMemory(createTestMemory("sixth", "world"), "import", true), "sixth");
+    manager.deleteMemory(testMemoryId1);
+    EXPECT_EQ(manager.createMemory(createTestMemory("seventh", "hello"), "import", true), "seventh");
+
+    // Index entries of memories edited in place are checked against their
+    // current content
+    auto edited = manager.getMemoryById("seventh");
+    *edited = Memory("seventh", "edited", testEntityId, testAgentId);
+    EXPECT_EQ(manager.createMemory(createTestMemory("eighth", "hello"), "import", true), "eighth");
+}
+
+// Pooled memories behave like make_shared ones inside the manager
+TEST_F(AgentMemoryTest, PooledMemoriesStoreAndRelease) {
+    std::weak_ptr<Memory> observer;
+    {
+        AgentMemoryManager manager;
+        auto pooled = makeMemory(testMemoryId1, "Pooled memory", testEntityId, testAgentId);
+        pooled->setEmbedding({1.0f, 0.0f});
+        observer = pooled;
+        EXPECT_EQ(manager.createMemory(pooled), testMemoryId1);
+        manager.createMemory(createTestMemory(testMemoryId2, "Shared memory"));
+        pooled.reset();
+
+        auto retrieved = manager.getMemoryById(testMemoryId1);
+        ASSERT_NE(retrieved, nullptr);
+        EXPECT_EQ(retrieved->getContent(), "Pooled memory");
+        EXPECT_EQ(retrieved->getEmbedding(), (EmbeddingVector{1.0f, 0.0f}));
+
+        EXPECT_TRUE(manager.deleteMemory(testMemoryId1));
+        EXPECT_EQ(manager.getMemoryById(testMemoryId1), nullptr);
+        EXPECT_NE(manager.getMemoryById(testMemoryId2), nullptr);
+        EXPECT_FALSE(observer.expired());   // Still held by `retrieved`
+    }
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST_F(AgentMemoryTest, GeneratedAndFreeFormIdsShareATable) {
+    auto& manager = getGlobalMemoryManager();
+    std::string generated = Uuid::v4().toString();
+    std::string upper = generated;
+    for (char& c : upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    manager.createMemory(createTestMemory(generated, "generated id"));
+    manager.createMemory(createTestMemory(upper, "upper-case id"));
+    manager.createMemory(createTestMemory(testMemoryId1, "free-form id"));
+
+    ASSERT_NE(manager.getMemoryById(generated), nullptr);
+    EXPECT_EQ(manager.getMemoryById(generated)->getContent(), "generated id");
+    EXPECT_EQ(manager.getMemoryById(upper)->getContent(), "upper-case id");
+    EXPECT_EQ(manager.getMemoryById(testMemoryId1)->getContent(), "free-form id");
+    EXPECT_EQ(manager.getMemoriesByIds({upper, generated}).size(), 2u);
+
+    EXPECT_TRUE(manager.deleteMemory(generated));
+    EXPECT_EQ(manager.getMemoryById(generated), nullptr);
+    EXPECT_NE(manager.getMemoryById(upper), nullptr);
+}
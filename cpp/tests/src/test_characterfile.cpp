@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "elizaos/characterfile.hpp"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace elizaos;
+namespace fs = std::filesystem;
+
+class CharacterFileSyncTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir_ = fs::temp_directory_path() / ("elizaos_characterfile_" + std::to_string(::getpid()));
+        fs::remove_all(dir_);
+        fs::create_directories(dir_);
+        manager_ = std::make_shared<CharacterManager>();
+        files_.setCharacterManager(manager_);
+    }
+
+    void TearDown() override {
+        files_.stopWatching();
+        fs::remove_all(dir_);
+    }
+
+    void writeCharacter(const std::string& file, const std::string& id, const std::string& name,
+                        const std::string& description) {
+        std::ofstream out(dir_ / file);
+        out << R"({"id": ")" << id << R"(", "name": ")" << name << R"(", "description": ")" << description << R"("})";
+    }
+
+    size_t stat(const std::string& key) const {
+        return static_cast<size_t>(files_.getOperationStatistics()[key].asInt());
+    }
+
+    size_t fileCount() const {
+        return static_cast<size_t>(std::distance(fs::directory_iterator(dir_), fs::directory_iterator()));
+    }
+
+    // Polls until the watcher thread has caught up
+    template <typename Predicate>
+    bool eventually(Predicate predicate) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < deadline) {
+            if (predicate()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return predicate();
+    }
+
+    fs::path dir_;
+    std::shared_ptr<CharacterManager> manager_;
+    CharacterFileManager files_;
+};
+
+TEST_F(CharacterFileSyncTest, SyncTouchesOnlyChangedFiles) {
+    writeCharacter("alpha.json", "char-alpha", "Alpha", "First");
+    writeCharacter("beta.json", "char-beta", "Beta", "Second");
+    writeCharacter("gamma.json", "char-gamma", "Gamma", "Third");
+
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(manager_->getCharacterCount(), 3u);
+    EXPECT_EQ(stat("parsedCount"), 3u);
+    // Freshly imported characters already match their files
+    EXPECT_EQ(stat("exportedCount"), 0u);
+    EXPECT_EQ(fileCount(), 3u);
+
+    // Nothing changed: nothing is read, parsed or written
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(stat("parsedCount"), 3u);
+    EXPECT_EQ(stat("exportedCount"), 0u);
+
+    // One file edited: only it is parsed
+    writeCharacter("beta.json", "char-beta", "Beta", "Second, revised");
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(stat("parsedCount"), 4u);
+    EXPECT_EQ(manager_->getCharacter("char-beta")->description, "Second, revised");
+
+    // One character edited in the manager: only its file is written
+    auto gamma = *manager_->getCharacter("char-gamma");
+    gamma.description = "Third, evolved";
+    ASSERT_TRUE(manager_->updateCharacter("char-gamma", gamma));
+    auto alphaWritten = fs::last_write_time(dir_ / "alpha.json");
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(stat("exportedCount"), 1u);
+    EXPECT_EQ(fs::last_write_time(dir_ / "alpha.json"), alphaWritten);
+    std::ifstream in(dir_ / "gamma.json");
+    std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("Third, evolved"), std::string::npos);
+
+    // Our own write is not parsed back in
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(stat("parsedCount"), 4u);
+
+    // New characters get a file of their own
+    CharacterProfile delta("Delta", "Fourth");
+    std::string deltaId = manager_->registerCharacter(delta);
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_EQ(fileCount(), 4u);
+    EXPECT_EQ(stat("exportedCount"), 2u);
+    EXPECT_EQ(stat("parsedCount"), 4u);
+
+    // Deleting a synced file removes its character
+    fs::remove(dir_ / "alpha.json");
+    ASSERT_TRUE(files_.syncWithManager(dir_.string()));
+    EXPECT_FALSE(manager_->getLiveCharacter("char-alpha"));
+    EXPECT_TRUE(manager_->getLiveCharacter(deltaId));
+    EXPECT_EQ(fileCount(), 3u);
+}
+
+TEST_F(CharacterFileSyncTest, WatcherSwapsLiveProfiles) {
+    writeCharacter("alpha.json", "char-alpha", "Alpha", "Original");
+    ASSERT_TRUE(files_.watchDirectory(dir_.string()));
+
+    // A conversation pins the profile it started with
+    auto pinned = manager_->getLiveCharacter("char-alpha");
+    ASSERT_TRUE(pinned);
+    uint64_t revision = manager_->getRevision("char-alpha");
+
+    writeCharacter("alpha.json", "char-alpha", "Alpha", "Reloaded");
+    ASSERT_TRUE(eventually([&] {
+        auto live = manager_->getLiveCharacter("char-alpha");
+        return live && live->description == "Reloaded";
+    }));
+    EXPECT_EQ(pinned->description, "Original");
+    EXPECT_GT(manager_->getRevision("char-alpha"), revision);
+    EXPECT_GE(stat("reloadedCount"), 1u);
+
+    // A broken save leaves the last good profile in place
+    {
+        std::ofstream out(dir_ / "alpha.json");
+        out << R"({"id": "char-alpha", "name": )";
+    }
+    ASSERT_TRUE(eventually([&] { return stat("errorCount") >= 1; }));
+    EXPECT_EQ(manager_->getLiveCharacter("char-alpha")->description, "Reloaded");
+
+    // New files are picked up too
+    writeCharacter("beta.json", "char-beta", "Beta", "Arrived");
+    EXPECT_TRUE(eventually([&] { return manager_->getLiveCharacter("char-beta") != nullptr; }));
+
+    files_.stopWatching();
+    EXPECT_FALSE(files_.getOperationStatistics()["isWatching"].asBool());
+}
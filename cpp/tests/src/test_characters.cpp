@@ -354,6 +354,29 @@ TEST_F(CharactersTest, CharacterManager_Update) {
     EXPECT_EQ(retrieved->description, "Updated description");
 }
 
+TEST_F(CharactersTest, CharacterManager_LiveProfiles) {
+    CharacterProfile character("Dana", "Original description");
+    std::string id = globalCharacterManager->registerCharacter(character);
+    uint64_t revision = globalCharacterManager->getRevision(id);
+    EXPECT_GT(revision, 0u);
+    
+    auto pinned = globalCharacterManager->getLiveCharacter(id);
+    ASSERT_TRUE(pinned);
+    
+    CharacterProfile updatedChar("Dana", "Updated description");
+    EXPECT_TRUE(globalCharacterManager->updateCharacter(id, updatedChar));
+    
+    // The old profile stays whole for whoever holds it
+    EXPECT_EQ(pinned->description, "Original description");
+    EXPECT_EQ(globalCharacterManager->getLiveCharacter(id)->description, "Updated description");
+    EXPECT_GT(globalCharacterManager->getRevision(id), revision);
+    EXPECT_EQ(globalCharacterManager->getRevisions().size(), 1u);
+    
+    EXPECT_TRUE(globalCharacterManager->unregisterCharacter(id));
+    EXPECT_EQ(globalCharacterManager->getRevision(id), 0u);
+    EXPECT_FALSE(globalCharacterManager->getLiveCharacter(id));
+}
+
 TEST_F(CharactersTest, CharacterManager_Search) {
     CharacterProfile character1("Alice", "A helpful assistant");
     CharacterProfile character2("Bob", "A creative artist");
@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 #include "elizaos/core.hpp"
+#include "elizaos/atomspace_matcher.hpp"
+#include <algorithm>
+#include <set>
 #include <memory>
 #include <thread>
 #include <chrono>
@@ -696,4 +699,189 @@ TEST_F(CognitivePrimitivesTest, AtomSpacePatternMatching) {
         auto traversalResult = patternMatcher->traverseAtomSpace(pattern, nodes[0]);
         EXPECT_GE(traversalResult.size(), 0);
     }
-}
\ No newline at end of file
+}
+// ============================================================================
+// AtomSpace Pattern Matcher Tests
+// ============================================================================
+
+namespace {
+
+struct SocialGraph {
+    std::vector<std::shared_ptr<HypergraphNode>> nodes;
+    std::vector<std::shared_ptr<HypergraphEdge>> edges;
+
+    void person(const std::string& id, int age) {
+        auto node = std::make_shared<HypergraphNode>(id, "Person");
+        node->setAttribute("age", std::to_string(age));
+        nodes.push_back(node);
+    }
+
+    void food(const std::string& id) {
+        nodes.push_back(std::make_shared<HypergraphNode>(id, "Food"));
+    }
+
+    void link(const std::string& label, const std::string& from, const std::string& to) {
+        edges.push_back(std::make_shared<HypergraphEdge>(label + ":" + from + ":" + to, label,
+                                                         std::vector<UUID>{from, to}));
+    }
+};
+
+// alice knows bob and carol, bob knows carol; bob and carol like pizza
+SocialGraph makeSocialGraph() {
+    SocialGraph graph;
+    graph.person("alice", 34);
+    graph.person("bob", 27);
+    graph.person("carol", 41);
+    graph.person("dave", 19);
+    graph.food("pizza");
+    graph.food("sushi");
+    graph.link("knows", "alice", "bob");
+    graph.link("knows", "alice", "carol");
+    graph.link("knows", "bob", "carol");
+    graph.link("likes", "bob", "pizza");
+    graph.link("likes", "carol", "pizza");
+    graph.link("likes", "dave", "sushi");
+    return graph;
+}
+
+std::set<std::string> boundValues(const std::vector<PatternMatch>& matches, const std::string& variable) {
+    std::set<std::string> values;
+    for (const auto& match : matches) {
+        for (const auto& binding : match.bindings) {
+            if (binding.variable == variable) values.insert(binding.value);
+        }
+    }
+    return values;
+}
+
+} // anonymous namespace
+
+TEST_F(CognitivePrimitivesTest, AtomSpaceMatcherJoinsNestedSubpatterns) {
+    auto graph = makeSocialGraph();
+    AtomSpacePatternMatcher matcher;
+
+    // Friends of alice who like pizza, with the Person clause nested under knows
+    AtomSpacePattern pattern("knows", {"alice", "?Y"});
+    pattern.subpatterns.emplace_back("likes", std::vector<std::string>{"?Y", "pizza"});
+    pattern.subpatterns.emplace_back("Person", std::vector<std::string>{"?Y"});
+
+    auto matches = matcher.findAllMatches(pattern, graph.nodes, graph.edges);
+    ASSERT_EQ(matches.size(), 2u);
+    EXPECT_EQ(boundValues(matches, "?Y"), (std::set<std::string>{"bob", "carol"}));
+    EXPECT_EQ(matches[0].matchedPattern, "knows");
+    EXPECT_DOUBLE_EQ(matches[0].confidence, 1.0);
+
+    // Triangle: every variable is shared by two clauses
+    AtomSpacePattern triangle("AND");
+    triangle.subpatterns.emplace_back("knows", std::vector<std::string>{"?A", "?B"});
+    triangle.subpatterns.emplace_back("knows", std::vector<std::string>{"?B", "?C"});
+    triangle.subpatterns.emplace_back("knows", std::vector<std::string>{"?A", "?C"});
+    auto triangles = matcher.findAllMatches(triangle, graph.nodes, graph.edges);
+    ASSERT_EQ(triangles.size(), 1u);
+    EXPECT_EQ(boundValues(triangles, "?A"), std::set<std::string>{"alice"});
+    EXPECT_EQ(boundValues(triangles, "?C"), std::set<std::string>{"carol"});
+
+    EXPECT_FALSE(matcher.matchAtomSpacePattern(AtomSpacePattern("knows", {"dave", "?Y"}),
+                                               graph.nodes, graph.edges).isMatch);
+    EXPECT_FALSE(matcher.matchAtomSpacePattern(AtomSpacePattern("knows", {"nobody", "?Y"}),
+                                               graph.nodes, graph.edges).isMatch);
+    EXPECT_FALSE(matcher.matchAtomSpacePattern(AtomSpacePattern("hates", {"?X", "?Y"}),
+                                               graph.nodes, graph.edges).isMatch);
+}
+
+TEST_F(CognitivePrimitivesTest, AtomSpaceMatcherDisjunctionNegationAndConstraints) {
+    auto graph = makeSocialGraph();
+    AtomSpacePatternMatcher matcher;
+    matcher.setAtomSpace(graph.nodes, graph.edges);
+
+    // People who like pizza or sushi
+    AtomSpacePattern either("OR");
+    either.subpatterns.emplace_back("likes", std::vector<std::string>{"?X", "pizza"});
+    either.subpatterns.emplace_back("likes", std::vector<std::string>{"?X", "sushi"});
+    EXPECT_EQ(boundValues(matcher.query(either), "?X"), (std::set<std::string>{"bob", "carol", "dave"}));
+
+    // People nobody knows
+    AtomSpacePattern unknown("Person", {"?X"});
+    AtomSpacePattern known("NOT");
+    known.subpatterns.emplace_back("knows", std::vector<std::string>{"?Z", "?X"});
+    unknown.subpatterns.push_back(known);
+    auto unknownMatches = matcher.query(unknown);
+    EXPECT_EQ(boundValues(unknownMatches, "?X"), (std::set<std::string>{"alice", "dave"}));
+    EXPECT_TRUE(boundValues(unknownMatches, "?Z").empty());
+
+    // Older acquaintances, comparing attributes of both ends
+    AtomSpacePattern older("knows", {"?X", "?Y"});
+    older.constraint = "?Y.age > 30 && ?X.label == Person && ?X != carol";
+    auto olderMatches = matcher.query(older);
+    ASSERT_EQ(olderMatches.size(), 2u);
+    EXPECT_EQ(boundValues(olderMatches, "?Y"), std::set<std::string>{"carol"});
+
+    AtomSpacePattern malformed("knows", {"?X", "?Y"});
+    malformed.constraint = "?X.age";
+    EXPECT_TRUE(matcher.query(malformed).empty());
+
+    EXPECT_EQ(matcher.query(AtomSpacePattern("knows", {"?X", "?Y"}), 2).size(), 2u);
+    EXPECT_EQ(matcher.extractPatterns("who knows a Person?"), (std::vector<std::string>{"knows", "Person"}));
+    EXPECT_DOUBLE_EQ(matcher.matchPattern("alice knows bob", "?X knows bob"), 1.0);
+}
+
+TEST_F(CognitivePrimitivesTest, AtomSpaceMatcherTraversalAndPLNIntegration) {
+    auto graph = makeSocialGraph();
+    AtomSpacePatternMatcher matcher;
+    matcher.setAtomSpace(graph.nodes, graph.edges);
+
+    AtomSpacePattern friendsOfFriends("knows", {"?X", "?Y"});
+    friendsOfFriends.subpatterns.emplace_back("knows", std::vector<std::string>{"?Y", "?Z"});
+    auto reached = matcher.traverseAtomSpace(friendsOfFriends, graph.nodes[0]);
+    std::vector<std::string> ids;
+    for (const auto& node : reached) ids.push_back(node->getId());
+    EXPECT_EQ(ids, (std::vector<std::string>{"bob", "carol"}));
+
+    PLNInferenceEngine pln;
+    pln.setAtomSpace(graph.nodes, graph.edges);
+    EXPECT_EQ(pln.matchAtomSpace(AtomSpacePattern("likes", {"?X", "pizza"})).size(), 2u);
+
+    graph.link("likes", "alice", "pizza");
+    pln.setAtomSpace(graph.nodes, graph.edges);
+    EXPECT_EQ(pln.matchAtomSpace(AtomSpacePattern("likes", {"?X", "pizza"})).size(), 3u);
+}
+
+TEST_F(CognitivePrimitivesTest, AtomSpaceMatcherParallelBranchesAgreeWithSequential) {
+    SocialGraph graph;
+    for (int i = 0; i < 2000; ++i) graph.person("p" + std::to_string(i), i % 90);
+    for (int i = 0; i < 2000; ++i) {
+        graph.link("knows", "p" + std::to_string(i), "p" + std::to_string((i * 7 + 1) % 2000));
+        graph.link("follows", "p" + std::to_string(i), "p" + std::to_string((i * 13 + 5) % 2000));
+    }
+
+    // Two clauses sharing no variables form independent groups
+    AtomSpacePattern pattern("AND");
+    pattern.subpatterns.emplace_back("knows", std::vector<std::string>{"?A", "?B"});
+    pattern.subpatterns.emplace_back("follows", std::vector<std::string>{"?C", "?D"});
+    pattern.subpatterns[0].constraint = "?A.age == 42";
+    pattern.subpatterns[1].constraint = "?D.age < 3";
+
+    AtomSpacePatternMatcher::Config parallel;
+    parallel.parallelThreshold = 0;
+    AtomSpacePatternMatcher::Config sequential;
+    sequential.parallel = false;
+    AtomSpacePatternMatcher parallelMatcher(parallel);
+    AtomSpacePatternMatcher sequentialMatcher(sequential);
+
+    auto key = [](const PatternMatch& match) {
+        std::string text;
+        for (const auto& binding : match.bindings) text += binding.variable + "=" + binding.value + ";";
+        return text;
+    };
+    auto a = parallelMatcher.findAllMatches(pattern, graph.nodes, graph.edges);
+    auto b = sequentialMatcher.findAllMatches(pattern, graph.nodes, graph.edges);
+    std::vector<std::string> keysA, keysB;
+    for (const auto& match : a) keysA.push_back(key(match));
+    for (const auto& match : b) keysB.push_back(key(match));
+    std::sort(keysA.begin(), keysA.end());
+    std::sort(keysB.begin(), keysB.end());
+
+    // 22 people aged 42 each know one person; 69 followees are younger than 3
+    EXPECT_EQ(keysA.size(), 22u * 69u);
+    EXPECT_EQ(keysA, keysB);
+}
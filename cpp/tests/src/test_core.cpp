@@ -1,6 +1,27 @@
 #include <gtest/gtest.h>
 #include "elizaos/core.hpp"
+#include "elizaos/embedding_service.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/json.hpp"
+#include "elizaos/memory_governor.hpp"
+#include "elizaos/metrics.hpp"
+#include "elizaos/persistent.hpp"
+#include "elizaos/pool.hpp"
+#include "elizaos/replay.hpp"
+#include "elizaos/snapshot.hpp"
+#include "elizaos/text_entities.hpp"
+#include "elizaos/uuid.hpp"
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
 
 using namespace elizaos;
 
@@ -107,4 +128,1469 @@ TEST_F(CoreTest, StateRecentMessagesLimit) {
     EXPECT_EQ(messages.size(), 32); // Should be limited to 32
     EXPECT_EQ(messages[0]->getContent(), "Message 3"); // First 3 should be removed
     EXPECT_EQ(messages[31]->getContent(), "Message 34"); // Last should be message 34
-}
\ No newline at end of file
+}
+
+TEST_F(CoreTest, StateVersionsStayStableUnderWriters) {
+    State state(config_);
+    auto initial = state.snapshot();
+
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (int i = 0; i < 2000; ++i) {
+            state.addActor(Actor{"actor-" + std::to_string(i), "Actor", ""});
+            state.addRecentMessage(makeMemory("msg-" + std::to_string(i), std::to_string(i), "user-1", config_.agentId));
+        }
+        done = true;
+    });
+
+    uint64_t lastVersion = 0;
+    while (!done) {
+        auto version = state.snapshot();
+        EXPECT_GE(version->version, lastVersion);
+        lastVersion = version->version;
+        size_t actors = 0;
+        for (const auto& actor : version->actors) {
+            EXPECT_EQ(actor.id, "actor-" + std::to_string(actors));
+            actors++;
+        }
+        EXPECT_EQ(actors, version->actors.size());
+        EXPECT_LE(version->recentMessages.size(), StateVersion::MAX_RECENT_MESSAGES);
+    }
+    writer.join();
+
+    EXPECT_EQ(initial->actors.size(), 0u);
+    EXPECT_EQ(state.getVersion(), 4000u);
+    EXPECT_EQ(state.getActors().size(), 2000u);
+    auto messages = state.getRecentMessages();
+    ASSERT_EQ(messages.size(), StateVersion::MAX_RECENT_MESSAGES);
+    EXPECT_EQ(messages.front()->getContent(), "1968");
+    EXPECT_EQ(messages.back()->getContent(), "1999");
+
+    State copy = state;
+    state.addGoal(Goal{"goal-1", "only in the original", "active", {}, {}});
+    EXPECT_TRUE(copy.getGoals().empty());
+    EXPECT_EQ(copy.getActors().size(), 2000u);
+}
+
+TEST(PersistentVectorTest, VersionsShareStructureAndStayUnchanged) {
+    PersistentVector<int> empty;
+    std::vector<PersistentVector<int>> versions{empty};
+    for (int i = 0; i < 5000; ++i) versions.push_back(versions.back().pushBack(i));
+
+    for (size_t size : {0u, 1u, 31u, 32u, 33u, 1024u, 1056u, 5000u}) {
+        const auto& version = versions[size];
+        ASSERT_EQ(version.size(), size);
+        for (size_t i = 0; i < size; ++i) ASSERT_EQ(version[i], static_cast<int>(i));
+    }
+    const auto& full = versions.back();
+    EXPECT_EQ(std::accumulate(full.begin(), full.end(), 0LL), 4999LL * 5000 / 2);
+    EXPECT_EQ(full.end() - full.begin(), 5000);
+    EXPECT_EQ(*(full.begin() + 4096), 4096);
+    EXPECT_THROW(full.at(5000), std::out_of_range);
+
+    auto changed = full.set(100, -1).set(4999, -2);
+    EXPECT_EQ(changed[100], -1);
+    EXPECT_EQ(changed[4999], -2);
+    EXPECT_EQ(full[100], 100);
+    EXPECT_EQ(full[4999], 4999);
+
+    PersistentRing<int> ring(4);
+    PersistentRing<int> early = ring;
+    for (int i = 0; i < 11; ++i) {
+        ring = ring.pushBack(i);
+        if (i == 2) early = ring;
+    }
+    EXPECT_EQ(ring.toVector(), (std::vector<int>{7, 8, 9, 10}));
+    EXPECT_EQ(early.toVector(), (std::vector<int>{0, 1, 2}));
+}
+
+TEST_F(CoreTest, IteratorsOutliveTheContainersTheyCameFrom) {
+    State state(config_);
+    state.addActor(Actor{"actor-1", "Ada", "friend"});
+    state.addActor(Actor{"actor-2", "Grace", "mentor"});
+
+    // Both temporaries, and the version they came from, are gone once the
+    // writes below publish newer versions
+    auto actor = state.getActors().begin();
+    auto end = state.getActors().end();
+    for (int i = 0; i < 100; ++i) state.addGoal(Goal{"goal-" + std::to_string(i), "", "pending", {}, {}});
+    state.addActor(Actor{"actor-3", "Linus", "stranger"});
+
+    ASSERT_EQ(end - actor, 2);
+    EXPECT_EQ(actor->name, "Ada");
+    EXPECT_EQ((++actor)->name, "Grace");
+}
+
+TEST(ExecutorTest, SubmitThenAndWhenAll) {
+    Executor executor(Executor::Config{4, 2});
+
+    auto doubled = executor.submit([] { return 21; }).then([](int value) { return value * 2; });
+    EXPECT_EQ(doubled.get(), 42);
+
+    // Continuations returning futures are flattened
+    auto chained = executor.submit([] { return 2; }).then([&executor](int value) {
+        return executor.submitBlocking([value] { return std::to_string(value); });
+    });
+    EXPECT_EQ(chained.get(), "2");
+
+    std::vector<Future<int>> parts;
+    for (int i = 0; i < 100; ++i) {
+        parts.push_back(executor.submit([i] { return i; }, i % 2 ? TaskPriority::LOW : TaskPriority::HIGH));
+    }
+    auto all = whenAll(std::move(parts)).get();
+    ASSERT_EQ(all.size(), 100u);
+    for (int i = 0; i < 100; ++i) EXPECT_EQ(all[i], i);
+
+    auto mixed = whenAll(executor.submit([] { return 1; }), executor.submit([] {}),
+                         executor.submitBlocking([] { return std::string("io"); }));
+    auto tuple = mixed.get();
+    EXPECT_EQ(std::get<0>(tuple), 1);
+    EXPECT_EQ(std::get<2>(tuple), "io");
+
+    std::vector<Future<void>> voids;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 10; ++i) voids.push_back(executor.submit([&ran] { ran++; }));
+    whenAll(std::move(voids)).get();
+    EXPECT_EQ(ran.load(), 10);
+}
+
+TEST(ExecutorTest, ExceptionsPropagateThroughContinuations) {
+    Executor executor(Executor::Config{2, 1});
+
+    bool continuationRan = false;
+    auto failed = executor.submit([]() -> int { throw std::runtime_error("boom"); })
+                      .then([&continuationRan](int value) {
+                          continuationRan = true;
+                          return value;
+                      });
+    EXPECT_THROW(failed.get(), std::runtime_error);
+    EXPECT_FALSE(continuationRan);
+
+    std::vector<Future<int>> parts;
+    parts.push_back(executor.submit([] { return 1; }));
+    parts.push_back(executor.submit([]() -> int { throw std::logic_error("second"); }));
+    EXPECT_THROW(whenAll(std::move(parts)).get(), std::logic_error);
+
+    Future<int> broken;
+    {
+        Promise<int> promise(&executor);
+        broken = promise.getFuture();
+    }
+    EXPECT_THROW(broken.get(), std::future_error);
+}
+
+TEST(ExecutorTest, NestedWaitsDoNotDeadlockFixedPool) {
+    // Every worker blocks on children; waiting workers run queued tasks instead
+    Executor executor(Executor::Config{2, 1});
+
+    std::function<int(int)> fib = [&](int n) -> int {
+        if (n < 2) return n;
+        auto left = executor.submit([&fib, n] { return fib(n - 1); });
+        auto right = executor.submit([&fib, n] { return fib(n - 2); });
+        return left.get() + right.get();
+    };
+    EXPECT_EQ(executor.submit([&fib] { return fib(15); }).get(), 610);
+
+    auto stats = executor.getStats();
+    EXPECT_GT(stats.submitted, 1000u);
+    EXPECT_EQ(executor.getWorkerCount(), 2u);
+}
+
+TEST(ExecutorTest, ThreadCountStaysFixedUnderLoad) {
+    Executor executor(Executor::Config{3, 2});
+
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::vector<Future<void>> work;
+    for (int i = 0; i < 2000; ++i) {
+        auto record = [&mutex, &threads] {
+            std::lock_guard<std::mutex> lock(mutex);
+            threads.insert(std::this_thread::get_id());
+        };
+        if (i % 10 == 0) {
+            work.push_back(executor.submitBlocking(record));
+        } else {
+            work.push_back(executor.submit(record));
+        }
+    }
+    whenAll(std::move(work)).get();
+    EXPECT_LE(threads.size(), 5u);
+
+    // std::async replacement keeps the std::future interface
+    EXPECT_EQ(executor.async([] { return 7; }).get(), 7);
+
+    executor.shutdown();
+    int after = 0;
+    executor.post([&after] { after = 1; });
+    EXPECT_EQ(after, 1);  // Runs inline once the pool is gone
+}
+
+TEST(ExecutorTest, TaskScopeJoinsDroppedAsyncTasks) {
+    Executor executor(Executor::Config{2, 2});
+    std::atomic<int> finished{0};
+    {
+        TaskScope scope(executor);
+        for (int i = 0; i < 4; ++i) {
+            // Futures are dropped immediately; the scope still waits for them
+            scope.async([&finished] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                finished.fetch_add(1);
+            });
+        }
+    }
+    EXPECT_EQ(finished.load(), 4);
+}
+
+TEST(ExecutorTest, DelayedTasksRunInDueOrderAndCancel) {
+    Executor executor(Executor::Config{2, 1});
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<int> order;
+    auto record = [&](int value) {
+        return [&, value] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(value);
+            done.notify_all();
+        };
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    executor.postAfter(std::chrono::milliseconds(60), record(3));
+    executor.postBlockingAfter(std::chrono::milliseconds(20), record(1));
+    auto cancelled = executor.postAfter(std::chrono::milliseconds(30), record(99));
+    executor.postAfter(std::chrono::milliseconds(40), record(2), TaskPriority::HIGH);
+    EXPECT_TRUE(executor.cancel(cancelled));
+    EXPECT_FALSE(executor.cancel(cancelled));
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(done.wait_for(lock, std::chrono::seconds(5), [&] { return order.size() == 3; }));
+    }
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(60));
+    EXPECT_EQ(order, (std::vector<int>{1, 2, 3}));
+
+    // Not yet due at shutdown: dropped, and later ones are refused
+    bool ran = false;
+    executor.postAfter(std::chrono::hours(1), [&ran] { ran = true; });
+    executor.shutdown();
+    EXPECT_EQ(executor.postAfter(std::chrono::milliseconds(1), [&ran] { ran = true; }), 0u);
+    EXPECT_FALSE(ran);
+}
+
+TEST(ExecutorTest, PeriodicTasksRepeatWithoutOverlapUntilStopped) {
+    Executor executor(Executor::Config{2, 2});
+    std::atomic<int> runs{0};
+    std::atomic<int> concurrent{0};
+    std::atomic<bool> overlapped{false};
+    {
+        PeriodicTask ticker(executor);
+        ticker.start(std::chrono::milliseconds(5), [&] {
+            if (concurrent.fetch_add(1) != 0) overlapped = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            runs.fetch_add(1);
+            concurrent.fetch_sub(1);
+        });
+        EXPECT_TRUE(ticker.isRunning());
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (runs.load() < 5 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ticker.stop();
+        EXPECT_FALSE(ticker.isRunning());
+    }
+    int stopped = runs.load();
+    EXPECT_GE(stopped, 5);
+    EXPECT_FALSE(overlapped.load());
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(runs.load(), stopped);
+
+    // A callback may stop its own task, and a long interval does not delay stop()
+    std::atomic<int> selfStopped{0};
+    PeriodicTask once(executor, false);
+    once.start(std::chrono::milliseconds(1), [&] {
+        selfStopped.fetch_add(1);
+        once.stop();
+    });
+    PeriodicTask hourly(executor);
+    hourly.start(std::chrono::hours(1), [] {});
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (selfStopped.load() == 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto stopping = std::chrono::steady_clock::now();
+    hourly.stop();
+    EXPECT_LT(std::chrono::steady_clock::now() - stopping, std::chrono::seconds(1));
+    once.stop();
+    EXPECT_EQ(selfStopped.load(), 1);
+}
+
+TEST(MetricsTest, CountersAndHistogramsAggregateAcrossThreads) {
+    MetricsRegistry registry;
+    Counter& requests = registry.counter("requests_total", "Requests");
+    Histogram& latency = registry.histogram("latency_seconds", "Latency", {}, 1e-9);
+    EXPECT_EQ(&requests, &registry.counter("requests_total"));
+    EXPECT_THROW(registry.gauge("requests_total"), std::invalid_argument);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (uint64_t i = 1; i <= 10000; ++i) {
+                requests.increment();
+                latency.record(i);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    EXPECT_EQ(requests.value(), 40000u);
+    auto snapshot = latency.snapshot();
+    EXPECT_EQ(snapshot.count, 40000u);
+    EXPECT_EQ(snapshot.min, 1u);
+    EXPECT_EQ(snapshot.max, 10000u);
+    EXPECT_EQ(snapshot.sum, 4u * 10000u * 10001u / 2u);
+
+    // Log buckets keep relative error within one sub-bucket
+    for (double q : {0.5, 0.9, 0.99}) {
+        double exact = q * 10000;
+        EXPECT_NEAR(static_cast<double>(snapshot.percentile(q)), exact, exact / Histogram::SUB_BUCKETS);
+    }
+}
+
+TEST(MetricsTest, HistogramBucketsCoverFullRange) {
+    for (uint64_t value : {0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 1000ULL, 123456789ULL, ~0ULL}) {
+        size_t bucket = Histogram::bucketFor(value);
+        ASSERT_LT(bucket, Histogram::BUCKET_COUNT);
+        EXPECT_LE(Histogram::bucketLowerBound(bucket), value);
+        EXPECT_GE(Histogram::bucketUpperBound(bucket), value);
+    }
+    EXPECT_EQ(Histogram::bucketFor(~0ULL), Histogram::BUCKET_COUNT - 1);
+}
+
+TEST(MetricsTest, SpansNestAndRingKeepsNewest) {
+    Tracer tracer(8);
+    uint64_t outerId = 0;
+    {
+        TraceSpan outer("outer", nullptr, tracer);
+        outerId = outer.getId();
+        TraceSpan inner("inner", nullptr, tracer);
+        EXPECT_EQ(inner.getParentId(), outerId);
+        EXPECT_EQ(TraceSpan::currentSpanId(), inner.getId());
+    }
+    EXPECT_EQ(TraceSpan::currentSpanId(), 0u);
+
+    auto spans = tracer.collect();
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_STREQ(spans[0].name, "inner");
+    EXPECT_EQ(spans[0].parentId, outerId);
+    EXPECT_STREQ(spans[1].name, "outer");
+    EXPECT_EQ(spans[1].parentId, 0u);
+
+    for (int i = 0; i < 20; ++i) TraceSpan span("loop", nullptr, tracer);
+    spans = tracer.collect();
+    EXPECT_EQ(spans.size(), 8u);
+    EXPECT_EQ(tracer.getRecordedCount(), 22u);
+    EXPECT_EQ(tracer.collect(3).size(), 3u);
+
+    // Disabled tracing still feeds the latency histogram
+    Histogram latency;
+    tracer.setEnabled(false);
+    { TraceSpan span("quiet", &latency, tracer); }
+    EXPECT_EQ(tracer.getRecordedCount(), 22u);
+    EXPECT_EQ(latency.snapshot().count, 1u);
+}
+
+TEST(MetricsTest, ExportsPrometheusTextAndBinary) {
+    MetricsRegistry registry;
+    registry.counter("jobs_total", "Jobs run", {{"queue", "b"}}).increment(3);
+    registry.counter("jobs_total", "Jobs run", {{"queue", "a\"x"}}).increment(2);
+    registry.gauge("depth", "Queue depth").set(-4);
+    Histogram& latency = registry.histogram("wait_seconds", "Wait", {}, 1e-9);
+    for (uint64_t i = 0; i < 100; ++i) latency.record(1000000 * (i + 1));
+
+    std::string text = registry.exportPrometheus();
+    EXPECT_NE(text.find("# HELP jobs_total Jobs run\n# TYPE jobs_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("jobs_total{queue=\"a\\\"x\"} 2\n"), std::string::npos);
+    EXPECT_NE(text.find("jobs_total{queue=\"b\"} 3\n"), std::string::npos);
+    EXPECT_EQ(text.find("# TYPE jobs_total"), text.rfind("# TYPE jobs_total"));
+    EXPECT_NE(text.find("depth -4\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE wait_seconds summary"), std::string::npos);
+    EXPECT_NE(text.find("wait_seconds{quantile=\"0.5\"} 0.05"), std::string::npos);
+    EXPECT_NE(text.find("wait_seconds_count 100\n"), std::string::npos);
+
+    auto binary = registry.exportBinary();
+    EXPECT_LT(binary.size(), text.size());
+    auto decoded = MetricsRegistry::decodeBinary(binary);
+    ASSERT_TRUE(decoded.has_value());
+    ASSERT_EQ(decoded->samples.size(), 4u);
+    EXPECT_EQ(decoded->find("depth")->value, -4);
+    EXPECT_EQ(decoded->find("jobs_total", {{"queue", "b"}})->value, 3);
+    const MetricSample* wait = decoded->find("wait_seconds");
+    ASSERT_NE(wait, nullptr);
+    EXPECT_EQ(wait->histogram.count, 100u);
+    EXPECT_EQ(wait->histogram.percentile(0.9), latency.snapshot().percentile(0.9));
+
+    binary.pop_back();
+    EXPECT_FALSE(MetricsRegistry::decodeBinary(binary).has_value());
+}
+
+TEST(MetricsTest, TaskManagerIsInstrumented) {
+    class CountingWorker : public TaskWorker {
+    public:
+        std::string getName() const override { return "metrics-task"; }
+        bool execute(Task&, State&, const TaskOptions&) override { return true; }
+        bool validate(const Task&, const State&, std::shared_ptr<Memory>) const override { return true; }
+    };
+
+    Counter& completed = MetricsRegistry::global().counter("elizaos_tasks_completed_total");
+    uint64_t before = completed.value();
+    uint64_t spansBefore = Tracer::global().getRecordedCount();
+
+    TaskManager manager;
+    manager.registerWorker(std::make_shared<CountingWorker>());
+    auto id = manager.createTask("metrics-task", "instrumented");
+    manager.getTask(id)->addTag("queue");
+    manager.start();
+    for (int i = 0; i < 200 && completed.value() == before; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    manager.stop();
+
+    EXPECT_EQ(completed.value(), before + 1);
+    EXPECT_GT(Tracer::global().getRecordedCount(), spansBefore);
+    EXPECT_NE(MetricsRegistry::global().exportPrometheus().find("elizaos_task_execution_seconds_count"),
+              std::string::npos);
+}
+
+TEST(UuidTest, FormatsAndParsesCanonicalForm) {
+    Uuid id = Uuid::v4();
+    std::string text = id.toString();
+    ASSERT_EQ(text.size(), Uuid::STRING_LENGTH);
+    EXPECT_EQ(text[14], '4');
+    EXPECT_NE(std::string("89ab").find(text[19]), std::string::npos);
+    EXPECT_EQ(Uuid::parse(text), id);
+
+    auto upper = Uuid::parse("6BA7B810-9DAD-11D1-80B4-00C04FD430C8");
+    ASSERT_TRUE(upper.has_value());
+    EXPECT_EQ(upper->toString(), "6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+    EXPECT_EQ(upper->getVersion(), 1);
+
+    EXPECT_FALSE(Uuid::parse("6ba7b810-9dad-11d1-80b4-00c04fd430c").has_value());
+    EXPECT_FALSE(Uuid::parse("6ba7b810x9dad-11d1-80b4-00c04fd430c8").has_value());
+    EXPECT_FALSE(Uuid::parse("6ba7b810-9dad-11d1-80b4-00c04fd430cg").has_value());
+    EXPECT_TRUE(Uuid::nil().isNil());
+
+    // Converts where a UUID string is expected
+    Memory memory(id, "content", Uuid::v7(), "agent");
+    EXPECT_EQ(memory.getId(), text);
+
+    std::string generated = generateUUID();
+    EXPECT_TRUE(Uuid::parse(generated).has_value());
+}
+
+TEST(UuidTest, IdKeysHoldCanonicalIdsAsUuidsAndKeepOtherText) {
+    Uuid id = Uuid::v4();
+    IdKey canonical(id.toString());
+    EXPECT_TRUE(canonical.isUuid());
+    EXPECT_EQ(canonical.getUuid(), id);
+    EXPECT_EQ(canonical, IdKey(id));
+    EXPECT_EQ(canonical.hash(), IdKey(id).hash());
+    EXPECT_EQ(canonical.toString(), id.toString());
+
+    // Text that does not format back to itself keeps its own identity
+    IdKey upper("6BA7B810-9DAD-11D1-80B4-00C04FD430C8");
+    IdKey lower("6ba7b810-9dad-11d1-80b4-00c04fd430c8");
+    EXPECT_FALSE(upper.isUuid());
+    EXPECT_TRUE(lower.isUuid());
+    EXPECT_NE(upper, lower);
+    EXPECT_EQ(upper.toString(), "6BA7B810-9DAD-11D1-80B4-00C04FD430C8");
+
+    IdKey freeForm("test-memory-1");
+    EXPECT_FALSE(freeForm.isUuid());
+    EXPECT_TRUE(freeForm.getUuid().isNil());
+    EXPECT_EQ(freeForm, IdKey(std::string("test-memory-1")));
+    EXPECT_NE(IdKey(""), IdKey(Uuid::nil()));
+}
+
+TEST(UuidTest, V7IsTimeOrderedAndMatchesStringOrder) {
+    std::vector<Uuid> ids;
+    for (int i = 0; i < 10000; ++i) ids.push_back(Uuid::v7());
+
+    for (size_t i = 1; i < ids.size(); ++i) {
+        ASSERT_LT(ids[i - 1], ids[i]);
+        ASSERT_LT(ids[i - 1].toString(), ids[i].toString());
+    }
+    EXPECT_EQ(ids.front().getVersion(), 7);
+
+    uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                             std::chrono::system_clock::now().time_since_epoch())
+                                             .count());
+    EXPECT_LE(ids.front().getTimestampMillis(), now);
+    EXPECT_GT(ids.front().getTimestampMillis() + 60000, now);
+    EXPECT_EQ(Uuid::v4().getTimestampMillis(), 0u);
+}
+
+TEST(UuidTest, UniqueAcrossThreads) {
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 5000;
+    std::vector<std::vector<Uuid>> generated(THREADS);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&generated, t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                generated[t].push_back(i % 2 ? Uuid::v4() : Uuid::v7());
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    std::unordered_set<Uuid> unique;
+    for (const auto& ids : generated) unique.insert(ids.begin(), ids.end());
+    EXPECT_EQ(unique.size(), static_cast<size_t>(THREADS * PER_THREAD));
+}
+
+TEST(JsonTest, ParsesAndWritesRoundTrip) {
+    const std::string text =
+        R"({"name":"eliza","count":3,"ratio":0.25,"ok":true,"none":null,"tags":["a","b"],"nested":{"x":-7}})";
+    json::ParseError error;
+    auto value = json::parse(text, &error);
+    ASSERT_TRUE(value) << error.message;
+
+    EXPECT_EQ(value->getString("name"), "eliza");
+    EXPECT_EQ(value->getInt("count"), 3);
+    EXPECT_DOUBLE_EQ(value->getDouble("ratio"), 0.25);
+    EXPECT_TRUE(value->getBool("ok"));
+    EXPECT_TRUE(value->at("none").isNull());
+    EXPECT_EQ(value->at("tags").size(), 2u);
+    EXPECT_EQ(value->at("nested").getInt("x"), -7);
+    EXPECT_EQ(value->getString("missing", "fallback"), "fallback");
+    EXPECT_THROW(value->at("name").asInt(), json::TypeError);
+
+    // Members keep insertion order, so compact output matches the input
+    EXPECT_EQ(json::write(*value), text);
+
+    json::WriteOptions sorted;
+    sorted.sortKeys = true;
+    auto reparsed = json::parse(json::write(*value, sorted));
+    ASSERT_TRUE(reparsed);
+    EXPECT_EQ(*reparsed, *value);
+}
+
+TEST(JsonTest, HandlesEscapesAndRejectsMalformedInput) {
+    auto value = json::parse(R"(["tab\there", "\u00e9\ud83d\ude00", "quote\"slash\\"])");
+    ASSERT_TRUE(value);
+    EXPECT_EQ((*value)[0].asString(), "tab\there");
+    EXPECT_EQ((*value)[1].asString(), "\xc3\xa9\xf0\x9f\x98\x80");
+    EXPECT_EQ(json::write((*value)[2]), R"("quote\"slash\\")");
+
+    json::ParseError error;
+    for (const char* bad : {"", "{", "[1,]", "{\"a\" 1}", "\"\\ud800\"", "01", "[1] 2", "nul",
+                            "1e400", "[-1e999]", "\"\xff\xfe\"", "\"\\n\xc3\"", "\"\xc0\xaf\"",
+                            "\"\xed\xa0\x80\"", "\"\xf4\x90\x80\x80\""}) {
+        EXPECT_FALSE(json::parse(bad, &error)) << bad;
+    }
+    EXPECT_FALSE(json::parse("[1e400]", &error));
+    EXPECT_EQ(error.offset, 1u);
+    auto utf8 = json::parse("[\"caf\xc3\xa9\", \"\\t\xf0\x9f\x98\x80\"]");
+    ASSERT_TRUE(utf8);
+    EXPECT_EQ((*utf8)[0].asString(), "caf\xc3\xa9");
+    EXPECT_EQ((*utf8)[1].asString(), "\t\xf0\x9f\x98\x80");
+    EXPECT_EQ((*json::parse("1e-400")).asDouble(), 0.0);
+    EXPECT_FALSE(json::parse(std::string(json::MAX_PARSE_DEPTH + 1, '['), &error));
+}
+
+TEST(JsonTest, BuildsTreesInsideDocumentArena) {
+    json::Document document;
+    ASSERT_TRUE(document.parse(R"({"actions":[{"name":"move"}]})"));
+    json::Value& root = document.root();
+    EXPECT_EQ(root.getResource(), document.getResource());
+
+    json::Value extra = document.makeValue();
+    extra["name"] = "a string long enough to need a heap allocation";
+    root["actions"].push_back(std::move(extra));
+    EXPECT_EQ(root["actions"][1].getResource(), document.getResource());
+
+    // Copies leave the arena so they outlive the document
+    json::Value copy = root;
+    EXPECT_EQ(copy.getResource(), std::pmr::get_default_resource());
+    EXPECT_EQ(copy, root);
+    EXPECT_EQ(copy["actions"].size(), 2u);
+}
+
+TEST(JsonTest, StreamsEventsToHandler) {
+    struct Counter : json::Handler {
+        int scalars = 0;
+        int containers = 0;
+        std::vector<std::string> keys;
+        bool onNull() override { return ++scalars > 0; }
+        bool onBool(bool) override { return ++scalars > 0; }
+        bool onInteger(int64_t) override { return ++scalars > 0; }
+        bool onDouble(double) override { return ++scalars > 0; }
+        bool onString(std::string_view) override { return ++scalars > 0; }
+        bool onStartObject() override { return ++containers > 0; }
+        bool onKey(std::string_view key) override {
+            keys.emplace_back(key);
+            return true;
+        }
+        bool onEndObject() override { return true; }
+        bool onStartArray() override { return ++containers > 0; }
+        bool onEndArray() override { return true; }
+    } counter;
+
+    ASSERT_TRUE(json::parse(R"({"a":[1,2.5,"x"],"b":{"c":null}})", counter));
+    EXPECT_EQ(counter.scalars, 4);
+    EXPECT_EQ(counter.containers, 3);
+    EXPECT_EQ(counter.keys, (std::vector<std::string>{"a", "b", "c"}));
+}
+
+TEST(PoolTest, ReusesBlocksAndAcceptsCrossThreadFrees) {
+    SlabPool& pool = SlabPool::forSize(200);
+    EXPECT_EQ(pool.getBlockSize(), 208u);
+    EXPECT_EQ(&pool, &SlabPool::forSize(208));
+
+    void* first = pool.allocate();
+    pool.deallocate(first);
+    EXPECT_EQ(pool.allocate(), first);
+
+    // Blocks allocated here and freed elsewhere return to the shared list
+    constexpr int BLOCKS = 5000;
+    std::vector<void*> blocks(BLOCKS);
+    for (auto& block : blocks) {
+        block = pool.allocate();
+        std::memset(block, 0xab, pool.getBlockSize());
+    }
+    std::thread([&] {
+        for (void* block : blocks) pool.deallocate(block);
+    }).join();
+    size_t slabs = pool.getSlabCount();
+    for (auto& block : blocks) block = pool.allocate();
+    EXPECT_EQ(pool.getSlabCount(), slabs);
+    EXPECT_EQ(std::set<void*>(blocks.begin(), blocks.end()).size(), static_cast<size_t>(BLOCKS));
+    for (void* block : blocks) pool.deallocate(block);
+    pool.deallocate(first);
+}
+
+TEST(PoolTest, AllocateSharedKeepsMemoryInOneBlock) {
+    auto memory = makeMemory("pooled-1", "pooled content", "entity-1", "agent-1");
+    EXPECT_EQ(memory->getContent(), "pooled content");
+    std::weak_ptr<Memory> observer = memory;
+    memory.reset();
+    EXPECT_TRUE(observer.expired());
+
+    std::vector<int, PoolAllocator<int>> numbers;
+    for (int i = 0; i < 1000; ++i) numbers.push_back(i);
+    EXPECT_EQ(numbers[999], 999);
+}
+
+namespace {
+
+struct Tracked : RefCounted<Tracked> {
+    explicit Tracked(int* liveCount) : live(liveCount) { ++*live; }
+    ~Tracked() { --*live; }
+    int* live;
+};
+
+} // anonymous namespace
+
+TEST(PoolTest, IntrusivePtrCountsReferences) {
+    int live = 0;
+    IntrusivePtr<Tracked> first = makeIntrusive<Tracked>(&live);
+    EXPECT_EQ(live, 1);
+    EXPECT_EQ(first->getRefCount(), 1u);
+    {
+        IntrusivePtr<Tracked> second = first;
+        EXPECT_EQ(first->getRefCount(), 2u);
+        IntrusivePtr<Tracked> third = std::move(second);
+        EXPECT_FALSE(second);
+        EXPECT_EQ(third, first);
+    }
+    EXPECT_EQ(first->getRefCount(), 1u);
+    first.reset();
+    EXPECT_EQ(live, 0);
+}
+
+TEST(PoolTest, GenerationArenaRetiresSealedGenerations) {
+    GenerationArena arena(4096);
+    std::string_view kept = arena.copy("first generation");
+    const float weights[] = {0.5f, 0.25f};
+    float* copied = arena.copy(weights, 2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(copied) % alignof(float), 0u);
+    EXPECT_EQ(copied[1], 0.25f);
+    EXPECT_EQ(kept, "first generation");
+
+    uint64_t sealed = arena.advance();
+    EXPECT_EQ(arena.getGeneration(), sealed + 1);
+    std::string_view next = arena.copy(std::string(5000, 'x'));     // Oversized chunk
+    EXPECT_EQ(next.size(), 5000u);
+    size_t reserved = arena.getReservedBytes();
+
+    // The open generation survives retiring everything
+    arena.retire(arena.getGeneration());
+    EXPECT_EQ(next, std::string(5000, 'x'));
+    EXPECT_EQ(arena.getUsedBytes(), 5000u);
+
+    // Standard chunks are kept for reuse
+    arena.advance();
+    arena.retire(sealed + 1);
+    EXPECT_EQ(arena.getUsedBytes(), 0u);
+    EXPECT_LT(arena.getReservedBytes(), reserved);
+    arena.copy("reused");
+    EXPECT_EQ(arena.getReservedBytes(), 4096u);
+
+    std::pmr::vector<int> values(&arena);
+    values.assign(100, 7);
+    EXPECT_EQ(values.back(), 7);
+}
+
+TEST(SnapshotTest, EncodesPrimitivesAndFailsOnTruncation) {
+    SnapshotWriter writer;
+    writer.writeVarint(300);
+    writer.writeSigned(-42);
+    writer.writeDouble(0.125);
+    writer.writeString("hello");
+    writer.writeFloats({1.5f, -2.0f});
+    writer.writeStringMap({{"k", "v"}});
+
+    SnapshotReader reader(writer.data());
+    EXPECT_EQ(reader.readVarint(), 300u);
+    EXPECT_EQ(reader.readSigned(), -42);
+    EXPECT_EQ(reader.readDouble(), 0.125);
+    EXPECT_EQ(reader.readString(), "hello");
+    EXPECT_EQ(reader.readFloats(), (std::vector<float>{1.5f, -2.0f}));
+    EXPECT_EQ(reader.readStringMap().at("k"), "v");
+    EXPECT_TRUE(reader.ok());
+    EXPECT_TRUE(reader.atEnd());
+
+    SnapshotReader truncated(std::string_view(writer.data()).substr(0, 6));
+    truncated.readVarint();
+    truncated.readSigned();
+    EXPECT_EQ(truncated.readDouble(), 0.0);
+    EXPECT_EQ(truncated.readString(), "");
+    EXPECT_FALSE(truncated.ok());
+}
+
+TEST(SnapshotTest, RestoresCoreComponentsFromFile) {
+    const std::string path = ::testing::TempDir() + "core_snapshot.bin";
+
+    TaskManager tasks;
+    UUID taskId = tasks.createTask("index", "Rebuild the index", "room-1", "world-1");
+    tasks.getTask(taskId)->addTag("maintenance");
+    tasks.getTask(taskId)->setPriority(3);
+    tasks.scheduleTask(taskId, Timestamp(std::chrono::seconds(1700000000)));
+
+    PLNInferenceEngine pln;
+    pln.addRule(InferenceRule("modus", "A -> B", "B", TruthValue(0.9, 0.8), 2.0));
+    auto node = std::make_shared<HypergraphNode>("n1", "concept");
+    node->setAttribute("kind", "animal");
+    pln.setAtomSpace({node}, {std::make_shared<HypergraphEdge>("e1", "link", std::vector<UUID>{"n1"})});
+
+    State state(AgentConfig{"agent-1", "Snap", "bio", "lore", "curious"});
+    state.addActor(Actor{"actor-1", "Ada", "friend"});
+    auto message = makeMemory("msg-1", "hello there", "user-1", "agent-1");
+    message->setEmbedding({0.25f, 0.5f});
+    state.addRecentMessage(message);
+
+    SnapshotManager snapshots;
+    snapshots.registerComponent(tasks);
+    snapshots.registerComponent(pln);
+    snapshots.registerComponent(std::make_shared<StateSnapshot>(state));
+    std::string error;
+    ASSERT_TRUE(snapshots.save(path, &error)) << error;
+    EXPECT_EQ(snapshots.getEpoch(), 1u);
+
+    TaskManager restoredTasks;
+    PLNInferenceEngine restoredPln;
+    State restoredState(AgentConfig{});
+    SnapshotManager restorer;
+    restorer.registerComponent(restoredTasks);
+    restorer.registerComponent(restoredPln);
+    restorer.registerComponent(std::make_shared<StateSnapshot>(restoredState));
+    ASSERT_TRUE(restorer.restore(path, &error)) << error;
+    EXPECT_EQ(restorer.getEpoch(), 1u);
+
+    auto task = restoredTasks.getTask(taskId);
+    ASSERT_NE(task, nullptr);
+    EXPECT_EQ(task->getName(), "index");
+    EXPECT_EQ(task->getRoomId(), "room-1");
+    EXPECT_EQ(task->getTags(), std::vector<std::string>{"maintenance"});
+    EXPECT_EQ(task->getPriority(), 3);
+    EXPECT_EQ(task->getScheduledTime(), Timestamp(std::chrono::seconds(1700000000)));
+    EXPECT_EQ(task->getCreatedAt(), tasks.getTask(taskId)->getCreatedAt());
+
+    auto rules = restoredPln.getApplicableRules("A -> B");
+    ASSERT_EQ(rules.size(), 1u);
+    EXPECT_DOUBLE_EQ(rules[0].truth.strength, 0.9);
+    EXPECT_DOUBLE_EQ(rules[0].weight, 2.0);
+    auto nodes = restoredPln.queryAtomSpace("concept");
+    ASSERT_EQ(nodes.size(), 1u);
+    EXPECT_EQ(nodes[0]->getAttribute("kind"), "animal");
+
+    EXPECT_EQ(restoredState.getConfig().adjective, "curious");
+    ASSERT_EQ(restoredState.getActors().size(), 1u);
+    EXPECT_EQ(restoredState.getActors()[0].name, "Ada");
+    ASSERT_EQ(restoredState.getRecentMessages().size(), 1u);
+    const auto& restoredMessage = *restoredState.getRecentMessages()[0];
+    EXPECT_EQ(restoredMessage.getContent(), "hello there");
+    EXPECT_EQ(restoredMessage.getCreatedAt(), message->getCreatedAt());
+    EXPECT_EQ(restoredMessage.getEmbedding(), message->getEmbedding());
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, RejectsCorruptSectionsWithoutTouchingComponents) {
+    const std::string path = ::testing::TempDir() + "corrupt_snapshot.bin";
+
+    TaskManager tasks;
+    tasks.createTask("kept", "Survives a bad restore");
+    SnapshotManager snapshots;
+    snapshots.registerComponent(tasks);
+    ASSERT_TRUE(snapshots.save(path));
+
+    auto file = SnapshotFile::open(path);
+    ASSERT_NE(file, nullptr);
+    const auto* section = file->findSection("tasks");
+    ASSERT_NE(section, nullptr);
+    EXPECT_TRUE(file->readSection(*section).has_value());
+    uint64_t offset = section->offset;
+    file.reset();
+
+    {
+        std::fstream stream(path, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekp(static_cast<std::streamoff>(offset + 2));
+        stream.put('\x7f');
+    }
+
+    TaskManager target;
+    UUID existing = target.createTask("existing", "Must stay");
+    SnapshotManager restorer;
+    restorer.registerComponent(target);
+    std::string error;
+    EXPECT_FALSE(restorer.restore(path, &error));
+    EXPECT_NE(error.find("checksum"), std::string::npos);
+    EXPECT_NE(target.getTask(existing), nullptr);
+
+    EXPECT_FALSE(restorer.restore(path + ".missing", &error));
+    std::remove(path.c_str());
+}
+
+TEST(SnapshotTest, MalformedSectionAbortsTheWholeRestore) {
+    const std::string path = ::testing::TempDir() + "malformed_snapshot.bin";
+
+    // Reads the pln section but rejects it, as a decoder that found a bad field would
+    struct RejectingComponent : Snapshottable {
+        mutable std::mutex mutex;
+        std::string getSnapshotName() const override { return "pln"; }
+        std::unique_lock<std::mutex> fenceSnapshot() const override { return std::unique_lock<std::mutex>(mutex); }
+        SnapshotImage freezeSnapshot() const override { return [](SnapshotWriter&) {}; }
+        SnapshotCommit decodeSnapshot(SnapshotReader&, uint32_t) override { return {}; }
+    };
+
+    TaskManager tasks;
+    tasks.createTask("saved", "Only in the file");
+    PLNInferenceEngine pln;
+    SnapshotManager snapshots;
+    snapshots.registerComponent(tasks);
+    snapshots.registerComponent(pln);
+    ASSERT_TRUE(snapshots.save(path));
+
+    TaskManager target;
+    UUID existing = target.createTask("existing", "Must stay");
+    SnapshotManager restorer;
+    restorer.registerComponent(target);
+    restorer.registerComponent(std::make_shared<RejectingComponent>());
+    std::string error;
+    EXPECT_FALSE(restorer.restore(path, &error));
+    EXPECT_NE(error.find("malformed section pln"), std::string::npos);
+    EXPECT_NE(target.getTask(existing), nullptr);
+    EXPECT_EQ(target.getPendingTasks().size(), 1u);
+    std::remove(path.c_str());
+}
+
+TEST(ReplayTest, SeededUuidsRepeat) {
+    Uuid::seedRandom(7);
+    Uuid first = Uuid::v4();
+    Uuid second = Uuid::v7();
+    Uuid::seedRandom(7);
+    EXPECT_EQ(Uuid::v4(), first);
+    EXPECT_EQ(Uuid::v7(), second);
+    Uuid::seedRandom(std::nullopt);
+    EXPECT_NE(Uuid::v4(), first);
+}
+
+TEST(ReplayTest, SeededUuidsUseOneStreamPerThread) {
+    Uuid::seedRandom(7);
+    Uuid first = Uuid::v4();
+    Uuid other;
+    std::thread([&] { other = Uuid::v4(); }).join();
+    EXPECT_NE(other, first);
+
+    // The thread that draws first after seeding always gets the same stream
+    Uuid::seedRandom(7);
+    Uuid replayed;
+    std::thread([&] { replayed = Uuid::v4(); }).join();
+    EXPECT_EQ(replayed, first);
+    Uuid::seedRandom(std::nullopt);
+}
+
+TEST(ReplayTest, ReplaysTasksToMatchingState) {
+    const std::string path = ::testing::TempDir() + "task_trace.bin";
+
+    TaskManager tasks;
+    TraceRecorder recorder;
+    recorder.addComponent(tasks);
+    ASSERT_TRUE(recorder.start(path, 42));
+    EXPECT_TRUE(TraceRecorder::isActive());
+    std::vector<UUID> ids;
+    for (int i = 0; i < 3; ++i) {
+        ids.push_back(tasks.createTask("task-" + std::to_string(i), "recorded", "room-" + std::to_string(i % 2)));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ids.push_back(tasks.createTask("late", "recorded after a gap"));
+    TraceRecorder second;
+    std::string error;
+    EXPECT_FALSE(second.start(path + ".second", 1, &error));
+    ASSERT_TRUE(recorder.stop());
+    EXPECT_FALSE(TraceRecorder::isActive());
+    EXPECT_EQ(recorder.getEventCount(), 4u);
+
+    TaskManager replayed;
+    TraceReplayer replayer;
+    addTaskReplay(replayer, replayed);
+    replayer.addComponent(replayed);
+    ReplayOptions options;
+    options.speed = 4.0;
+    auto report = replayer.run(path, options, &error);
+    ASSERT_TRUE(report.has_value()) << error;
+    EXPECT_EQ(report->eventCount, 4u);
+    EXPECT_EQ(report->unhandledCount, 0u);
+    EXPECT_TRUE(report->complete);
+    EXPECT_TRUE(report->divergedComponents.empty());
+    EXPECT_TRUE(report->missingComponents.empty());
+    EXPECT_EQ(report->latency.count, 4u);
+    EXPECT_GE(report->recordedSeconds, 0.02);
+    EXPECT_GE(report->wallSeconds, report->recordedSeconds / 4.0 * 0.9);
+    EXPECT_FALSE(VirtualClock::isPinned());
+    for (const auto& id : ids) {
+        ASSERT_NE(replayed.getTask(id), nullptr);
+        EXPECT_EQ(replayed.getTask(id)->getCreatedAt(), tasks.getTask(id)->getCreatedAt());
+    }
+
+    // A replay that ends somewhere else is reported, and so is an unknown component
+    TaskManager diverging;
+    diverging.createTask("extra", "not in the trace");
+    TraceReplayer divergingReplayer;
+    addTaskReplay(divergingReplayer, diverging);
+    divergingReplayer.addComponent(diverging);
+    options.asFastAsPossible = true;
+    report = divergingReplayer.run(path, options);
+    ASSERT_TRUE(report.has_value());
+    EXPECT_EQ(report->divergedComponents, std::vector<std::string>{"tasks"});
+
+    TraceReplayer unhandled;
+    report = unhandled.run(path, options);
+    ASSERT_TRUE(report.has_value());
+    EXPECT_EQ(report->unhandledCount, 4u);
+    EXPECT_EQ(report->missingComponents, std::vector<std::string>{"tasks"});
+    std::remove(path.c_str());
+}
+
+TEST(ReplayTest, TruncatedTraceReplaysWholeEvents) {
+    const std::string path = ::testing::TempDir() + "truncated_trace.bin";
+    TaskManager tasks;
+    TraceRecorder recorder;
+    ASSERT_TRUE(recorder.start(path, 3));
+    tasks.createTask("first", "kept");
+    tasks.createTask("second", "cut in half");
+    ASSERT_TRUE(recorder.stop());
+
+    std::string contents;
+    {
+        std::ifstream in(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(contents.data(), static_cast<std::streamsize>(contents.size() - 20));
+    }
+
+    TaskManager replayed;
+    TraceReplayer replayer;
+    addTaskReplay(replayer, replayed);
+    ReplayOptions options;
+    options.asFastAsPossible = true;
+    auto report = replayer.run(path, options);
+    ASSERT_TRUE(report.has_value());
+    EXPECT_FALSE(report->complete);
+    EXPECT_EQ(report->eventCount, 1u);
+
+    std::string error;
+    EXPECT_FALSE(replayer.run(path + ".missing", options, &error).has_value());
+    EXPECT_FALSE(error.empty());
+    std::remove(path.c_str());
+}
+
+namespace {
+
+// Cache of fixed-size entries that records how often it was asked to shrink
+class FakeCache : public MemoryConsumer {
+public:
+    FakeCache(std::string name, size_t entries) : name_(std::move(name)), entries_(entries) {}
+
+    std::string getConsumerName() const override { return name_; }
+    size_t getAccountedBytes() const override { return entries_.load() * ENTRY_BYTES; }
+    size_t shrinkMemory(size_t bytes) override {
+        shrinkCalls++;
+        size_t dropped = std::min(entries_.load(), (bytes + ENTRY_BYTES - 1) / ENTRY_BYTES);
+        entries_ -= dropped;
+        return dropped * ENTRY_BYTES;
+    }
+
+    static constexpr size_t ENTRY_BYTES = 1000;
+    std::atomic<int> shrinkCalls{0};
+
+private:
+    std::string name_;
+    std::atomic<size_t> entries_;
+};
+
+} // anonymous namespace
+
+TEST(MemoryGovernorTest, PressureLevelsFollowBudgetRatios) {
+    MemoryGovernor governor;
+    MemoryBudgetConfig config;
+    config.budgetBytes = 1000000;
+    governor.configure(config);
+
+    EXPECT_EQ(governor.getBudgetBytes(), 1000000u);
+    EXPECT_EQ(governor.evaluate(500000), MemoryPressure::NONE);
+    EXPECT_EQ(governor.evaluate(700000), MemoryPressure::MODERATE);
+    EXPECT_EQ(governor.evaluate(900000), MemoryPressure::HIGH);
+    EXPECT_EQ(governor.evaluate(990000), MemoryPressure::CRITICAL);
+    EXPECT_EQ(governor.getPressure(), MemoryPressure::CRITICAL);
+    EXPECT_EQ(governor.getUsedBytes(), 990000u);
+    EXPECT_STREQ(memoryPressureName(MemoryPressure::HIGH), "high");
+
+    // Without a configured budget the cgroup limit or physical memory applies
+    governor.configure({});
+    EXPECT_GT(governor.getBudgetBytes(), 0u);
+    EXPECT_GT(MemoryGovernor::readResidentBytes(), 0u);
+}
+
+TEST(MemoryGovernorTest, ShrinksLowPriorityCachesFirstAndProgressively) {
+    FakeCache low("low", 400);
+    FakeCache normal("normal", 400);
+    FakeCache high("high", 400);
+
+    MemoryGovernor governor;
+    MemoryBudgetConfig config;
+    config.budgetBytes = 1000000;
+    governor.configure(config);
+    governor.registerConsumer(low, CachePriority::LOW);
+    governor.registerConsumer(normal, CachePriority::NORMAL);
+    governor.registerConsumer(high, CachePriority::HIGH);
+    EXPECT_EQ(governor.getAccountedBytes(), 1200000u);
+
+    // Moderate pressure only touches LOW, and at most an eighth of it per pass
+    governor.evaluate(750000);
+    EXPECT_EQ(low.getAccountedBytes(), 350000u);
+    EXPECT_EQ(normal.shrinkCalls, 0);
+    EXPECT_EQ(high.shrinkCalls, 0);
+
+    // High pressure takes a quarter of LOW, then NORMAL for the rest
+    governor.evaluate(880000);
+    EXPECT_EQ(low.getAccountedBytes(), 262000u);
+    EXPECT_EQ(normal.getAccountedBytes(), 308000u);
+    EXPECT_EQ(high.shrinkCalls, 0);
+
+    // Only critical pressure reaches HIGH
+    governor.evaluate(2000000);
+    EXPECT_GT(high.shrinkCalls, 0);
+    EXPECT_LT(high.getAccountedBytes(), 400000u);
+
+    auto usage = governor.getUsage();
+    ASSERT_EQ(usage.size(), 3u);
+    EXPECT_EQ(usage[0].name, "low");
+    EXPECT_EQ(usage[0].reclaimedBytes, 400000u - low.getAccountedBytes());
+
+    EXPECT_TRUE(governor.unregisterConsumer(high));
+    EXPECT_FALSE(governor.unregisterConsumer(high));
+    EXPECT_EQ(governor.getUsage().size(), 2u);
+}
+
+TEST(MemoryGovernorTest, BackgroundThreadPollsAndStops) {
+    FakeCache cache("cache", 100);
+    MemoryGovernor governor;
+    MemoryBudgetConfig config;
+    config.budgetBytes = 1;     // Always critical
+    config.pollInterval = std::chrono::milliseconds(1);
+    governor.configure(config);
+    governor.registerConsumer(cache, CachePriority::LOW);
+
+    governor.start();
+    EXPECT_TRUE(governor.isRunning());
+    for (int i = 0; i < 1000 && cache.getAccountedBytes() > 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    governor.stop();
+    EXPECT_FALSE(governor.isRunning());
+    EXPECT_EQ(cache.getAccountedBytes(), 0u);
+    EXPECT_EQ(governor.getPressure(), MemoryPressure::CRITICAL);
+}
+
+TEST(MemoryGovernorTest, ShrinksConsumersOutsideTheGovernorLock) {
+    // A consumer that unregisters itself and queries the governor while
+    // shrinking; with the lock held across shrinkMemory both would deadlock
+    class ReentrantCache : public FakeCache {
+    public:
+        ReentrantCache(MemoryGovernor& governor) : FakeCache("reentrant", 100), governor_(governor) {}
+        size_t shrinkMemory(size_t bytes) override {
+            usageSeen = governor_.getUsage().size();
+            governor_.unregisterConsumer(*this);
+            return FakeCache::shrinkMemory(bytes);
+        }
+        size_t usageSeen = 0;
+
+    private:
+        MemoryGovernor& governor_;
+    };
+
+    MemoryGovernor governor;
+    MemoryBudgetConfig config;
+    config.budgetBytes = 1;
+    governor.configure(config);
+    ReentrantCache cache(governor);
+    governor.registerConsumer(cache, CachePriority::LOW);
+
+    governor.evaluate(1000000);
+    EXPECT_EQ(cache.shrinkCalls, 1);
+    EXPECT_EQ(cache.usageSeen, 1u);
+    EXPECT_LT(cache.getAccountedBytes(), 100u * FakeCache::ENTRY_BYTES);
+    EXPECT_TRUE(governor.getUsage().empty());
+}
+
+namespace {
+
+std::vector<std::pair<std::string, std::string>> entitiesOf(const std::string& text, uint32_t types = ALL_TEXT_ENTITIES) {
+    std::vector<std::pair<std::string, std::string>> found;
+    for (const auto& entity : scanTextEntities(text, types)) {
+        found.emplace_back(textEntityTypeName(entity.type), std::string(entity.in(text)));
+    }
+    return found;
+}
+
+} // anonymous namespace
+
+TEST(TextEntityTest, FindsEachKindWithoutOverlap) {
+    std::string text = "Mail ops@eliza.how or see https://elizaos.ai/docs?page=2#intro, (or www.example.org). "
+                       "Ping @shaw and #ElizaOS about 0x52908400098527886E0F7030069857D2E4169EE7, "
+                       "bc1qar0srrr7xfkvy5l643lydnw9re59gtzzwf5mdq and 1BvBMSEYstWetqTFn5Au4m4GFg7xJaNVN2. "
+                       "Call +1 (555) 123-4567 on 2024-01-15 10:30, not 192.168.100.200.";
+
+    std::vector<std::pair<std::string, std::string>> expected = {
+        {"email", "ops@eliza.how"},
+        {"url", "https://elizaos.ai/docs?page=2#intro"},
+        {"url", "www.example.org"},
+        {"mention", "@shaw"},
+        {"hashtag", "#ElizaOS"},
+        {"crypto_address", "0x52908400098527886E0F7030069857D2E4169EE7"},
+        {"crypto_address", "bc1qar0srrr7xfkvy5l643lydnw9re59gtzzwf5mdq"},
+        {"crypto_address", "1BvBMSEYstWetqTFn5Au4m4GFg7xJaNVN2"},
+        {"phone", "+1 (555) 123-4567"}};
+    EXPECT_EQ(entitiesOf(text), expected);
+
+    // Offsets point into the source
+    auto entities = scanTextEntities(text, textEntityBit(TextEntityType::EMAIL));
+    ASSERT_EQ(entities.size(), 1u);
+    EXPECT_EQ(entities[0].start, text.find("ops@"));
+}
+
+TEST(TextEntityTest, RejectsLookalikes) {
+    EXPECT_TRUE(entitiesOf("issue #42, a&#39;b, x@y, user@host, word@twitter.com_x, 3.14159265358979").empty());
+    EXPECT_TRUE(entitiesOf("javascript://x mailto:someone ftp:/nope 0x1234 abc1234567890").empty());
+    EXPECT_EQ(entitiesOf("email@example.com", textEntityBit(TextEntityType::MENTION)).size(), 0u);
+
+    // Trailing punctuation and unbalanced parentheses stay outside URLs
+    EXPECT_EQ(extractTextEntities("(see http://a.io/x_(y)).", TextEntityType::URL),
+              std::vector<std::string_view>{"http://a.io/x_(y)"});
+    EXPECT_EQ(extractTextEntities("Go to http://a.io/path!", TextEntityType::URL),
+              std::vector<std::string_view>{"http://a.io/path"});
+}
+
+TEST(TextEntityTest, VectorAndScalarPathsAgree) {
+    // Triggers straddling every 16-byte block boundary
+    std::string padding;
+    for (size_t offset = 0; offset < 40; ++offset) {
+        std::string text = padding + "x@y.io #tag 0x" + std::string(40, 'a') + " " + padding;
+        auto entities = scanTextEntities(text);
+        ASSERT_EQ(entities.size(), 3u) << offset;
+        EXPECT_EQ(entities[0].start, offset);
+        padding += ' ';
+    }
+}
+
+TEST(TextEntityTest, UrlHelpers) {
+    EXPECT_EQ(urlHost("https://user:pw@Example.com:8080/a?b"), "Example.com");
+    EXPECT_EQ(urlHost("http://[::1]:80/"), "::1");
+    EXPECT_EQ(urlHost("example.com/path"), "");
+    EXPECT_TRUE(isHttpUrl("HTTPS://example.com/a"));
+    EXPECT_FALSE(isHttpUrl("https://exa mple.com"));
+    EXPECT_FALSE(isHttpUrl("https://.com"));
+    EXPECT_FALSE(isHttpUrl("ftp://example.com"));
+}
+
+namespace {
+
+// Batching processor that records batch sizes and can hold the first call
+// until released, so tests can queue texts behind a running batch
+class GatedEmbeddingProcessor : public HashingEmbeddingProcessor {
+public:
+    explicit GatedEmbeddingProcessor(bool batching) : HashingEmbeddingProcessor(16), batching_(batching) {}
+
+    std::string getName() const override { return "gated"; }
+    bool supportsBatching() const override { return batching_; }
+
+    EmbeddingVector generateEmbedding(const std::string& input) override {
+        record(1);
+        if (input == "bad") throw std::runtime_error("cannot embed");
+        return HashingEmbeddingProcessor::generateEmbedding(input);
+    }
+
+    std::vector<EmbeddingVector> generateEmbeddings(const std::vector<std::string>& inputs) override {
+        record(inputs.size());
+        std::vector<EmbeddingVector> embeddings;
+        for (const auto& input : inputs) embeddings.push_back(HashingEmbeddingProcessor::generateEmbedding(input));
+        return embeddings;
+    }
+
+    void hold() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = true;
+    }
+    void waitUntilEntered() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        changed_.wait(lock, [&]() { return entered_; });
+    }
+    void release() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        held_ = false;
+        changed_.notify_all();
+    }
+    std::vector<size_t> batchSizes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return batchSizes_;
+    }
+
+private:
+    void record(size_t size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        batchSizes_.push_back(size);
+        entered_ = true;
+        changed_.notify_all();
+        changed_.wait(lock, [&]() { return !held_; });
+    }
+
+    const bool batching_;
+    std::mutex mutex_;
+    std::condition_variable changed_;
+    bool held_ = false;
+    bool entered_ = false;
+    std::vector<size_t> batchSizes_;
+};
+
+} // anonymous namespace
+
+TEST(EmbeddingServiceTest, HashingProcessorIsDeterministicAndNormalised) {
+    HashingEmbeddingProcessor processor(64);
+    auto first = processor.generateEmbedding("The quick brown fox");
+    auto again = processor.generateEmbedding("the QUICK, brown fox!");
+    ASSERT_EQ(first.size(), 64u);
+    EXPECT_EQ(first, again);
+
+    double norm = 0.0;
+    for (float value : first) norm += static_cast<double>(value) * value;
+    EXPECT_NEAR(norm, 1.0, 1e-5);
+
+    auto related = processor.generateEmbedding("a quick brown dog");
+    auto unrelated = processor.generateEmbedding("interest rates rose sharply");
+    EXPECT_GT(processor.computeSimilarity(first, related), processor.computeSimilarity(first, unrelated));
+    EXPECT_GT(processor.computeSimilarity(first, related), 0.3);
+    EXPECT_EQ(processor.generateEmbedding("").size(), 64u);
+
+    auto batch = processor.generateEmbeddings({"The quick brown fox", "a quick brown dog"});
+    ASSERT_EQ(batch.size(), 2u);
+    EXPECT_EQ(batch[0], first);
+    EXPECT_EQ(batch[1], related);
+}
+
+TEST(EmbeddingServiceTest, CachesDeduplicatesAndBatchesConcurrentRequests) {
+    auto processor = std::make_shared<GatedEmbeddingProcessor>(true);
+    EmbeddingService service(processor);
+
+    processor->hold();
+    auto a = service.embedAsync("a");
+    processor->waitUntilEntered();
+    auto b = service.embedAsync("b");
+    auto c = service.embedAsync("c");
+    auto bAgain = service.embedAsync("b");
+    auto aAgain = service.embedAsync("a");
+    processor->release();
+
+    HashingEmbeddingProcessor reference(16);
+    EXPECT_EQ(a.get(), reference.generateEmbedding("a"));
+    EXPECT_EQ(aAgain.get(), reference.generateEmbedding("a"));
+    EXPECT_EQ(b.get(), reference.generateEmbedding("b"));
+    EXPECT_EQ(bAgain.get(), reference.generateEmbedding("b"));
+    EXPECT_EQ(c.get(), reference.generateEmbedding("c"));
+    EXPECT_EQ(processor->batchSizes(), (std::vector<size_t>{1, 2}));
+
+    EXPECT_EQ(service.embed("c"), reference.generateEmbedding("c"));
+    auto all = service.embedAll({"a", "d", "b"});
+    ASSERT_EQ(all.size(), 3u);
+    EXPECT_EQ(all[1], reference.generateEmbedding("d"));
+    EXPECT_EQ(processor->batchSizes(), (std::vector<size_t>{1, 2, 1}));
+
+    auto stats = service.getStats();
+    EXPECT_EQ(stats.misses, 6u);
+    EXPECT_EQ(stats.deduplicated, 2u);
+    EXPECT_EQ(stats.hits, 3u);
+    EXPECT_EQ(stats.embedded, 4u);
+    EXPECT_EQ(stats.batches, 3u);
+    EXPECT_EQ(service.cacheSize(), 4u);
+    EXPECT_TRUE(service.contains("d"));
+    EXPECT_FALSE(service.contains("e"));
+}
+
+TEST(EmbeddingServiceTest, FailureOnlyFailsItsOwnText) {
+    auto processor = std::make_shared<GatedEmbeddingProcessor>(false);
+    EmbeddingService service(processor);
+
+    processor->hold();
+    auto first = service.embedAsync("first");
+    processor->waitUntilEntered();
+    auto bad = service.embedAsync("bad");
+    auto good = service.embedAsync("good");
+    processor->release();
+
+    EXPECT_NO_THROW(first.get());
+    EXPECT_THROW(bad.get(), std::runtime_error);
+    EXPECT_EQ(good.get().size(), 16u);
+    EXPECT_EQ(processor->batchSizes(), (std::vector<size_t>{1, 1, 1}));
+    EXPECT_FALSE(service.contains("bad"));
+    EXPECT_EQ(service.getStats().failed, 1u);
+
+    // A failed text is retried on the next request
+    EXPECT_THROW(service.embed("bad"), std::runtime_error);
+    EXPECT_EQ(service.getStats().failed, 2u);
+    EXPECT_THROW(EmbeddingService(nullptr), std::invalid_argument);
+}
+
+TEST(EmbeddingServiceTest, EvictsLeastRecentlyUsedAndShrinks) {
+    EmbeddingServiceConfig config;
+    config.cacheEntries = 2;
+    EmbeddingService service(std::make_shared<HashingEmbeddingProcessor>(32), config);
+
+    service.embed("one");
+    service.embed("two");
+    service.embed("one");
+    service.embed("three");
+    EXPECT_TRUE(service.contains("one"));
+    EXPECT_FALSE(service.contains("two"));
+    EXPECT_TRUE(service.contains("three"));
+    EXPECT_EQ(service.getStats().evictions, 1u);
+
+    size_t accounted = service.getAccountedBytes();
+    EXPECT_GE(accounted, 2 * 32 * sizeof(float));
+    size_t freed = service.shrinkMemory(1);
+    EXPECT_GT(freed, 0u);
+    EXPECT_EQ(service.getAccountedBytes(), accounted - freed);
+    EXPECT_EQ(service.cacheSize(), 1u);
+    EXPECT_TRUE(service.contains("three"));
+
+    service.clearCache();
+    EXPECT_EQ(service.cacheSize(), 0u);
+    EXPECT_EQ(service.getAccountedBytes(), 0u);
+}
+
+TEST(EmbeddingServiceTest, CacheSurvivesSaveAndLoad) {
+    std::string path = ::testing::TempDir() + "embedding_cache_test.bin";
+    std::remove(path.c_str());
+    HashingEmbeddingProcessor reference(32);
+    {
+        EmbeddingServiceConfig config;
+        config.cachePath = path;
+        EmbeddingService service(std::make_shared<HashingEmbeddingProcessor>(32), config);
+        service.embedAll({"alpha", "beta", "gamma"});
+    }
+
+    auto processor = std::make_shared<GatedEmbeddingProcessor>(true);
+    std::string error;
+    EXPECT_FALSE(EmbeddingService(processor).loadCache(path, &error).has_value());
+    EXPECT_NE(error.find("hashing"), std::string::npos);
+
+    EmbeddingServiceConfig config;
+    config.cacheEntries = 2;
+    EmbeddingService restored(std::make_shared<HashingEmbeddingProcessor>(32), config);
+    EXPECT_EQ(restored.loadCache(path, &error), 2u);
+    EXPECT_FALSE(restored.contains("alpha"));
+    EXPECT_TRUE(restored.contains("gamma"));
+    EXPECT_EQ(restored.embed("gamma"), reference.generateEmbedding("gamma"));
+    EXPECT_EQ(restored.getStats().hits, 1u);
+
+    {
+        std::ofstream corrupt(path, std::ios::binary | std::ios::trunc);
+        corrupt << "EOSEMBC";
+    }
+    EXPECT_FALSE(restored.loadCache(path, &error).has_value());
+    EXPECT_FALSE(restored.loadCache(path + ".missing", &error).has_value());
+    std::remove(path.c_str());
+}
+
+TEST(EmbeddingServiceTest, CacheFilesStoreTextsNotJustHashes) {
+    std::string path = ::testing::TempDir() + "embedding_cache_text_test.bin";
+    EmbeddingService service(std::make_shared<HashingEmbeddingProcessor>(32));
+    service.embed("a rather distinctive sentence");
+    ASSERT_TRUE(service.saveCache(path));
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        EXPECT_NE(data.find("a rather distinctive sentence"), std::string::npos);
+    }
+
+    // Format 1 files only kept hashes, so a hit could not be checked
+    {
+        std::ofstream old(path, std::ios::binary | std::ios::trunc);
+        old.write("EOSEMBC\0", 8);
+        old.put('\x01');
+    }
+    std::string error;
+    EXPECT_FALSE(service.loadCache(path, &error).has_value());
+    EXPECT_NE(error.find("format 1"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(EmbeddingServiceTest, BlockingPoolTasksCanWaitOnEmbeddings) {
+    auto& executor = Executor::global();
+    const size_t workers = executor.getBlockingThreadCount();
+    EmbeddingService service(std::make_shared<HashingEmbeddingProcessor>(16));
+
+    // Every blocking worker waits on embed(), so a drain posted to the
+    // same pool would never start
+    std::mutex mutex;
+    std::condition_variable allStarted;
+    size_t started = 0;
+    std::vector<Future<EmbeddingVector>> results;
+    for (size_t i = 0; i < workers; ++i) {
+        results.push_back(executor.submitBlocking([&, i]() {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                if (++started == workers) allStarted.notify_all();
+                allStarted.wait(lock, [&]() { return started == workers; });
+            }
+            return service.embed("text " + std::to_string(i));
+        }));
+    }
+
+    HashingEmbeddingProcessor reference(16);
+    for (size_t i = 0; i < workers; ++i) {
+        ASSERT_TRUE(results[i].waitFor(std::chrono::seconds(5)));
+        EXPECT_EQ(results[i].get(), reference.generateEmbedding("text " + std::to_string(i)));
+    }
+}
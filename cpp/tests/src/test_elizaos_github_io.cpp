@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "elizaos/elizaos_github_io.hpp"
+#include "elizaos/cpp_header_scanner.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unistd.h>
+
+using namespace elizaos;
+
+namespace {
+
+const ScannedDeclaration* findDecl(const ScannedHeader& header, const std::string& qualified_name) {
+    for (const auto& decl : header.declarations) {
+        if (decl.qualifiedName() == qualified_name) return &decl;
+    }
+    return nullptr;
+}
+
+const char* SAMPLE_HEADER = R"CPP(
+#pragma once
+#include <string>
+#define BRACE_MACRO {
+
+namespace elizaos {
+namespace detail {
+
+/**
+ * Widget that does things.
+ * Spans two lines.
+ */
+class Widget : public Base {
+public:
+    /// Creates a widget
+    Widget(int size) : size_(size), name_{"w"} {}
+    ~Widget();
+
+    // plain comment, not documentation
+    int size() const { return size_; }
+    bool operator==(const Widget& other) const;
+    std::function<void(int)> callback;   ///< Invoked on change
+    static constexpr const char* RAW = R"(not } a brace { here)";
+
+    enum class Mode : uint8_t { FAST, SLOW };
+
+    struct Options {
+        int retries = 3;
+    };
+
+private:
+    int size_;
+    std::string name_;
+    void hidden();
+};
+
+/// Free helper
+template <typename T>
+std::vector<T> collect(const T& value, char sep = '}');
+
+using WidgetPtr = std::shared_ptr<Widget>;
+
+} // namespace detail
+} // namespace elizaos
+)CPP";
+
+} // anonymous namespace
+
+TEST(CppHeaderScannerTest, ExtractsDeclarationsAndDocComments) {
+    ScannedHeader header = CppHeaderScanner::scanSource(SAMPLE_HEADER, "sample.hpp");
+
+    auto widget = findDecl(header, "elizaos::detail::Widget");
+    ASSERT_NE(widget, nullptr);
+    EXPECT_EQ(widget->kind, DeclarationKind::CLASS);
+    EXPECT_EQ(widget->doc_comment, "Widget that does things.\nSpans two lines.");
+
+    auto ctor = findDecl(header, "elizaos::detail::Widget::Widget");
+    ASSERT_NE(ctor, nullptr);
+    EXPECT_EQ(ctor->kind, DeclarationKind::FUNCTION);
+    EXPECT_EQ(ctor->doc_comment, "Creates a widget");
+    EXPECT_EQ(ctor->signature, "Widget(int size)");
+    EXPECT_EQ(ctor->access, "public");
+
+    auto size = findDecl(header, "elizaos::detail::Widget::size");
+    ASSERT_NE(size, nullptr);
+    EXPECT_TRUE(size->doc_comment.empty());
+
+    EXPECT_NE(findDecl(header, "elizaos::detail::Widget::~Widget"), nullptr);
+    EXPECT_NE(findDecl(header, "elizaos::detail::Widget::operator=="), nullptr);
+
+    auto callback = findDecl(header, "elizaos::detail::Widget::callback");
+    ASSERT_NE(callback, nullptr);
+    EXPECT_EQ(callback->kind, DeclarationKind::VARIABLE);
+    EXPECT_EQ(callback->doc_comment, "Invoked on change");
+
+    auto mode = findDecl(header, "elizaos::detail::Widget::Mode");
+    ASSERT_NE(mode, nullptr);
+    EXPECT_EQ(mode->kind, DeclarationKind::ENUM);
+
+    auto retries = findDecl(header, "elizaos::detail::Widget::Options::retries");
+    ASSERT_NE(retries, nullptr);
+    EXPECT_EQ(retries->parent, "Options");
+
+    auto hidden = findDecl(header, "elizaos::detail::Widget::hidden");
+    ASSERT_NE(hidden, nullptr);
+    EXPECT_EQ(hidden->access, "private");
+
+    // Braces inside strings, raw strings and macros must not unbalance scopes
+    auto collect = findDecl(header, "elizaos::detail::collect");
+    ASSERT_NE(collect, nullptr);
+    EXPECT_EQ(collect->doc_comment, "Free helper");
+    EXPECT_EQ(collect->signature.rfind("template", 0), 0u);
+
+    auto alias = findDecl(header, "elizaos::detail::WidgetPtr");
+    ASSERT_NE(alias, nullptr);
+    EXPECT_EQ(alias->kind, DeclarationKind::TYPE_ALIAS);
+}
+
+TEST(CppHeaderScannerTest, ScansDirectoryInParallelAndCachesByContent) {
+    auto dir = std::filesystem::temp_directory_path() / ("elizaos_scanner_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "sub");
+    for (int i = 0; i < 12; ++i) {
+        std::ofstream(dir / (i % 2 ? "sub" : ".") / ("h" + std::to_string(i) + ".hpp"))
+            << "/** Class " << i << " */\nclass C" << i << " { public: void run(); };\n";
+    }
+
+    CppHeaderScanner scanner(4);
+    auto first = scanner.scanDirectory(dir);
+    ASSERT_EQ(first.size(), 12u);
+    EXPECT_EQ(scanner.getCacheMisses(), 12u);
+    EXPECT_TRUE(std::is_sorted(first.begin(), first.end(),
+                               [](const auto& a, const auto& b) { return a->path < b->path; }));
+
+    auto second = scanner.scanDirectory(dir);
+    EXPECT_EQ(scanner.getCacheHits(), 12u);
+    EXPECT_EQ(scanner.getCacheMisses(), 12u);
+    EXPECT_EQ(first[0].get(), second[0].get());
+
+    // Editing one file rescans only that file
+    std::ofstream(dir / "h0.hpp") << "class Changed { public: int size() const; };\n";
+    std::filesystem::last_write_time(dir / "h0.hpp", std::filesystem::file_time_type::clock::now() +
+                                                         std::chrono::seconds(5));
+    scanner.scanDirectory(dir);
+    EXPECT_EQ(scanner.getCacheMisses(), 13u);
+
+    std::filesystem::remove_all(dir);
+}
+
+TEST(CppHeaderScannerTest, DocumentationGeneratorUsesScanner) {
+    auto dir = std::filesystem::temp_directory_path() / ("elizaos_apidocs_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "api.hpp") << SAMPLE_HEADER;
+
+    DocumentationGenerator generator(GitHubPagesConfig("elizaos", "eliza"));
+    auto docs = generator.extractCodeDocumentation(dir);
+
+    auto widget = std::find_if(docs.begin(), docs.end(),
+                               [](const auto& doc) { return doc.class_name == "Widget"; });
+    ASSERT_NE(widget, docs.end());
+    EXPECT_EQ(widget->namespace_name, "elizaos::detail");
+    EXPECT_EQ(widget->description, "Widget that does things.\nSpans two lines.");
+    EXPECT_EQ(widget->methods.size(), 4u);  // private members are omitted
+    EXPECT_EQ(widget->properties.size(), 2u);
+
+    auto options = std::find_if(docs.begin(), docs.end(),
+                                [](const auto& doc) { return doc.class_name == "Widget::Options"; });
+    EXPECT_NE(options, docs.end());
+
+    auto functions = std::find_if(docs.begin(), docs.end(), [](const auto& doc) { return doc.kind == "file"; });
+    ASSERT_NE(functions, docs.end());
+    EXPECT_EQ(functions->methods.size(), 1u);
+
+    std::string markdown = generator.generateClassDocumentation(*widget);
+    EXPECT_NE(markdown.find("Creates a widget"), std::string::npos);
+
+    std::filesystem::remove_all(dir);
+}
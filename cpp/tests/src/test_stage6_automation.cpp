@@ -2,6 +2,11 @@
 #include "elizaos/plugins_automation.hpp"
 #include "elizaos/discord_summarizer.hpp"
 #include "elizaos/discrub_ext.hpp"
+#include "elizaos/content_matcher.hpp"
+#include <atomic>
+#include <random>
+#include <regex>
+#include <thread>
 
 using namespace elizaos;
 
@@ -235,6 +240,342 @@ TEST_F(DiscrubExtensionTest, ConfigurationManagement) {
     EXPECT_NO_THROW(extension->saveConfiguration("/tmp/discrub_config.conf"));
 }
 
+TEST_F(DiscrubExtensionTest, CompiledMatcherAgreesWithStdRegex) {
+    const std::vector<std::string> patterns = {
+        "\\b(damn|hell|crap)\\b", "[A-Z]{10,}", "discord\\.gg/\\w+", "^hello", "world$",
+        "a[^b]*b", "x{2,3}y?", "(?:ab|cd)+e", "\\Bell\\B", "[0-9a-f]{4}-\\d", "colou?r", "^$"
+    };
+    MultiPatternMatcher matcher;
+    std::vector<std::regex> references;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+        ASSERT_TRUE(matcher.addRegex(patterns[i], static_cast<uint32_t>(i))) << patterns[i];
+        references.emplace_back(patterns[i]);
+    }
+    matcher.build();
+    EXPECT_EQ(matcher.getFallbackCount(), 0u);
+
+    // Small alphabet so the patterns actually fire
+    const std::string alphabet = "abcdehlorwxyABCDEFGHIJ0-9 .\n/gisu";
+    std::mt19937 rng(42);
+    for (int round = 0; round < 2000; ++round) {
+        std::string text;
+        size_t length = rng() % 24;
+        for (size_t i = 0; i < length; ++i) text.push_back(alphabet[rng() % alphabet.size()]);
+        if (round % 7 == 0) text += "hello world";
+
+        auto result = matcher.scan(text);
+        std::vector<bool> matched(patterns.size(), false);
+        for (uint32_t id : result.regexMatches) matched[id] = true;
+        for (size_t i = 0; i < patterns.size(); ++i) {
+            EXPECT_EQ(matched[i], std::regex_search(text, references[i]))
+                << "pattern " << patterns[i] << " on \"" << text << "\"";
+        }
+    }
+
+    EXPECT_FALSE(MultiPatternMatcher::isSupportedRegex("(a)\\1"));
+    EXPECT_FALSE(MultiPatternMatcher::isSupportedRegex("foo(?=bar)"));
+    EXPECT_TRUE(MultiPatternMatcher::isSupportedRegex("(.{1})\\1{5,}"));
+}
+
+TEST_F(DiscrubExtensionTest, ScannerRebuildsMatcherOnlyWhenRulesChange) {
+    auto& scanner = extension->getScanner();
+
+    auto stats = scanner.getMatcherStats();
+    EXPECT_EQ(stats.fallbackFilters, 0u);   // Repetition filter runs as a run-length rule
+    EXPECT_GE(stats.dfaCount, 1u);
+
+    scanner.scanContent("aaaaaaaaaa");
+    EXPECT_EQ(scanner.getMatcherStats().generation, stats.generation);
+
+    // Backreferences are not regular and keep using std::regex
+    scanner.addFilter(ContentFilter("doubled_word", "\\b(\\w+) \\1\\b", FilterAction::WARN, 1));
+    auto rebuilt = scanner.getMatcherStats();
+    EXPECT_GT(rebuilt.generation, stats.generation);
+    EXPECT_EQ(rebuilt.fallbackFilters, 1u);
+
+    auto result = scanner.scanContent("this is is fine and ABCDEFGHIJKL");
+    ASSERT_EQ(result.triggeredFilters.size(), 2u);
+    EXPECT_EQ(result.triggeredFilters[0], "excessive_caps");
+    EXPECT_EQ(result.triggeredFilters[1], "doubled_word");
+
+    result = scanner.scanContent("xxxxxx y");
+    EXPECT_TRUE(std::find(result.triggeredFilters.begin(), result.triggeredFilters.end(),
+                          "spam_repetition") != result.triggeredFilters.end());
+
+    ContentFilter disabled("doubled_word", "\\b(\\w+) \\1\\b", FilterAction::WARN, 1);
+    disabled.enabled = false;
+    scanner.updateFilter("doubled_word", disabled);
+    EXPECT_FALSE(scanner.scanContent("this is is fine").violation);
+}
+
+TEST_F(DiscrubExtensionTest, ScannerHonoursFilterPatternsAndFlags) {
+    auto& scanner = extension->getScanner();
+    size_t fallbacks = scanner.getMatcherStats().fallbackFilters;
+
+    // icase stays in the combined matcher, folded into its DFA
+    scanner.addFilter(ContentFilter("shout", "\\bq[^u]iet\\b", FilterAction::WARN, 1, std::regex::icase));
+    EXPECT_EQ(scanner.getMatcherStats().fallbackFilters, fallbacks);
+    EXPECT_TRUE(scanner.scanContent("be QXIET please").violation);
+    EXPECT_FALSE(scanner.scanContent("be QUIET please").violation);
+
+    // Other grammars are left to std::regex
+    scanner.addFilter(ContentFilter("posix", "ab+c", FilterAction::WARN, 1, std::regex::basic));
+    EXPECT_EQ(scanner.getMatcherStats().fallbackFilters, fallbacks + 1);
+    EXPECT_TRUE(scanner.scanContent("ab+c").violation);
+    EXPECT_FALSE(scanner.scanContent("abbc").violation);
+    scanner.removeFilter("posix");
+
+    // Changing the pattern changes what the scanner compiles
+    ContentFilter renamed("shout", "placeholder", FilterAction::WARN, 1);
+    renamed.setPattern("\\bhush\\b");
+    scanner.updateFilter("shout", renamed);
+    EXPECT_FALSE(scanner.scanContent("be qxiet please").violation);
+    EXPECT_TRUE(scanner.scanContent("hush now").violation);
+}
+
+TEST_F(DiscrubExtensionTest, BuiltInDetectorsShareOnePass) {
+    auto& scanner = extension->getScanner();
+
+    auto result = scanner.scanContent("Totally not a SCAM, I promise");
+    ASSERT_EQ(result.triggeredFilters.size(), 1u);
+    EXPECT_EQ(result.triggeredFilters[0], "built-in-profanity");
+
+    result = scanner.scanContent("FREE NITRO for everyone: https://gift.example/claim");
+    EXPECT_TRUE(std::find(result.triggeredFilters.begin(), result.triggeredFilters.end(),
+                          "built-in-phishing") != result.triggeredFilters.end());
+    EXPECT_EQ(result.recommendedAction, FilterAction::DELETE);
+
+    // A phrase without any link is not phishing
+    EXPECT_FALSE(scanner.scanContent("limited time only").violation);
+
+    // Blocked domains only count inside a URL
+    EXPECT_FALSE(scanner.scanContent("do not visit malware.net").violation);
+    EXPECT_TRUE(scanner.scanContent("see http://cdn.malware.net/x").violation);
+
+    scanner.addBlockedDomains({"evil.example"});
+    EXPECT_TRUE(scanner.scanContent("go https://evil.example/login").violation);
+
+    result = scanner.scanContent("join discordapp.com/invite/abc");
+    ASSERT_EQ(result.triggeredFilters.size(), 1u);
+    EXPECT_EQ(result.triggeredFilters[0], "built-in-invite");
+    EXPECT_FALSE(scanner.scanContent("discordapp.com/invite/ now").violation);
+
+    scanner.enableInviteFilter(false);
+    EXPECT_FALSE(scanner.scanContent("join discordapp.com/invite/abc").violation);
+}
+
+TEST_F(DiscrubExtensionTest, ThousandsOfFiltersStaySinglePass) {
+    auto& scanner = extension->getScanner();
+    for (int i = 0; i < 2000; ++i) {
+        scanner.addFilter(ContentFilter("word" + std::to_string(i), "\\bbadword" + std::to_string(i) + "\\b",
+                                        FilterAction::WARN, 1));
+    }
+    auto stats = scanner.getMatcherStats();
+    EXPECT_EQ(stats.fallbackFilters, 0u);
+    EXPECT_GE(stats.compiledFilters, 2004u);
+
+    auto result = scanner.scanContent("badword17 and badword1999 but not badword20000 or xbadword5");
+    std::vector<std::string> expected = {"word17", "word1999"};
+    EXPECT_EQ(result.triggeredFilters, expected);
+}
+
+TEST_F(DiscrubExtensionTest, ScansRunConcurrentlyWithRuleUpdates) {
+    auto& scanner = extension->getScanner();
+    std::atomic<bool> stop{false};
+    std::atomic<int> violations{0};
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                if (scanner.scanContent("well damn").violation) violations++;
+            }
+        });
+    }
+    for (int i = 0; i < 50; ++i) {
+        scanner.addFilter(ContentFilter("churn" + std::to_string(i % 5), "churn" + std::to_string(i), FilterAction::WARN));
+    }
+    stop = true;
+    for (auto& reader : readers) reader.join();
+
+    EXPECT_GT(violations.load(), 0);
+    EXPECT_EQ(scanner.getFilters().size(), 9u);
+}
+
+TEST_F(DiscrubExtensionTest, MessageFeaturesComputedInOnePass) {
+    auto features = MessageFeatures::compute("Hello World 42!!");
+    EXPECT_EQ(features.length, 16u);
+    EXPECT_EQ(features.letters, 10u);
+    EXPECT_EQ(features.uppercase, 2u);
+    EXPECT_EQ(features.digits, 2u);
+    EXPECT_EQ(features.whitespace, 2u);
+    EXPECT_EQ(features.symbols, 2u);
+    EXPECT_EQ(features.words, 3u);
+    EXPECT_EQ(features.longestRun, 2u);
+    EXPECT_GT(features.entropy, 3.0);
+
+    // Long repetitive input stays linear; the old detector was quadratic here
+    auto flood = MessageFeatures::compute(std::string(200000, 'a'));
+    EXPECT_EQ(flood.longestRun, 200000u);
+    EXPECT_DOUBLE_EQ(flood.entropy, 0.0);
+
+    auto a = MessageFeatures::compute("buy cheap followers now at my shop today only");
+    auto b = MessageFeatures::compute("Buy cheap followers NOW at my shop today only!!");
+    auto c = MessageFeatures::compute("the meeting moved to thursday afternoon instead");
+    EXPECT_EQ(a.simHash, b.simHash);
+    EXPECT_GT(SpamDetector::hammingDistance(a.simHash, c.simHash), 3);
+}
+
+TEST_F(DiscrubExtensionTest, SpamWindowsArePerUser) {
+    auto& scanner = extension->getScanner();
+    auto start = std::chrono::system_clock::now();
+    auto message = [&](const std::string& author, const std::string& text, int secondsLater) {
+        DiscordMessage msg("m", "c", author, text);
+        msg.authorId = author;
+        msg.timestamp = start + std::chrono::seconds(secondsLater);
+        return msg;
+    };
+    auto triggered = [](const ContentScanner::ScanResult& result, const std::string& name) {
+        return std::find(result.triggeredFilters.begin(), result.triggeredFilters.end(), name) !=
+               result.triggeredFilters.end();
+    };
+
+    // Flooding: the sixth message inside ten seconds is flagged, other users are not
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(scanner.scanMessage(message("flooder", "message number " + std::to_string(i * 7919), i)).violation);
+    }
+    auto flood = scanner.scanMessage(message("flooder", "one more thing", 5));
+    EXPECT_TRUE(triggered(flood, "built-in-flood"));
+    EXPECT_EQ(flood.recommendedAction, FilterAction::TIMEOUT);
+    EXPECT_FALSE(scanner.scanMessage(message("bystander", "one more thing", 5)).violation);
+    EXPECT_FALSE(triggered(scanner.scanMessage(message("flooder", "later on", 30)), "built-in-flood"));
+
+    // Near-duplicates: the third copy within a minute is spam
+    EXPECT_FALSE(scanner.scanMessage(message("copier", "check out my awesome channel", 100)).violation);
+    EXPECT_FALSE(scanner.scanMessage(message("copier", "Check out my AWESOME channel!", 120)).violation);
+    EXPECT_TRUE(triggered(scanner.scanMessage(message("copier", "check out my awesome channel", 140)),
+                          "built-in-spam"));
+
+    // Mention bursts across messages
+    EXPECT_FALSE(scanner.scanMessage(message("pinger", "<@1> <@2> <@3> <@4>", 200)).violation);
+    EXPECT_FALSE(scanner.scanMessage(message("pinger", "<@5> <@6> <@7> <@8>", 205)).violation);
+    EXPECT_TRUE(triggered(scanner.scanMessage(message("pinger", "<@9> <@10> <@11>", 210)),
+                          "built-in-mention-spam"));
+
+    // Content-only scans never touch user windows
+    EXPECT_FALSE(scanner.scanContent("one more thing").violation);
+}
+
+TEST_F(DiscrubExtensionTest, SpamDetectorStateIsBounded) {
+    SpamDetectionConfig config;
+    config.maxTrackedUsers = 32;
+    config.shardCount = 4;
+    SpamDetector detector(config);
+
+    auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < 1000; ++i) {
+        detector.evaluate("user" + std::to_string(i), "hello there", now, 0);
+    }
+    EXPECT_LE(detector.getTrackedUserCount(), 32u);
+
+    // A single flooding user keeps a bounded window too
+    for (int i = 0; i < 10000; ++i) {
+        detector.evaluate("flooder", "spam spam spam", now, 3);
+    }
+    auto verdict = detector.evaluate("flooder", "spam spam spam", now, 3);
+    EXPECT_TRUE(verdict.rateExceeded);
+    EXPECT_TRUE(verdict.duplicateContent);
+    EXPECT_TRUE(verdict.mentionBurst);
+    EXPECT_LE(verdict.windowMessages, config.maxMessagesPerWindow + 1);
+}
+
+TEST_F(DiscrubExtensionTest, ParallelBatchScanMatchesSequentialScan) {
+    std::vector<DiscordMessage> batch;
+    auto start = std::chrono::system_clock::now();
+    for (int i = 0; i < 4000; ++i) {
+        DiscordMessage msg("m" + std::to_string(i), "c", "", "");
+        msg.authorId = "user" + std::to_string(i % 37);
+        msg.timestamp = start + std::chrono::milliseconds(i * 40);
+        msg.content = (i % 5 == 0) ? "buy followers at discord.gg/shop" : "status update " + std::to_string(i);
+        batch.push_back(msg);
+    }
+
+    ContentScanner parallel;
+    auto results = parallel.scanMessages(batch);
+    ASSERT_EQ(results.size(), batch.size());
+
+    ContentScanner sequential;
+    size_t violations = 0;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        auto expected = sequential.scanMessage(batch[i]);
+        EXPECT_EQ(results[i].triggeredFilters, expected.triggeredFilters) << "message " << i;
+        if (expected.violation) violations++;
+    }
+    EXPECT_GT(violations, 0u);
+}
+
+TEST_F(DiscrubExtensionTest, NewestFirstHistoryIsJudgedByTimestamp) {
+    auto start = std::chrono::system_clock::now();
+    auto history = [&](int count, int spacingSeconds) {
+        // Discord returns history pages newest first
+        std::vector<DiscordMessage> batch;
+        for (int i = count - 1; i >= 0; --i) {
+            DiscordMessage msg("m" + std::to_string(i), "c", "regular", "update number " + std::to_string(i * 7919));
+            msg.authorId = "regular";
+            msg.timestamp = start + std::chrono::seconds(i * spacingSeconds);
+            batch.push_back(msg);
+        }
+        return batch;
+    };
+    auto floods = [](const std::vector<ContentScanner::ScanResult>& results) {
+        return std::count_if(results.begin(), results.end(), [](const ContentScanner::ScanResult& result) {
+            return std::find(result.triggeredFilters.begin(), result.triggeredFilters.end(), "built-in-flood") !=
+                   result.triggeredFilters.end();
+        });
+    };
+
+    // A day of one message every ten minutes is never a flood
+    ContentScanner spread;
+    EXPECT_EQ(floods(spread.scanMessages(history(144, 600))), 0);
+
+    // Eight messages in eight seconds still are, whatever the batch order
+    ContentScanner burst;
+    auto results = burst.scanMessages(history(8, 1));
+    EXPECT_EQ(floods(results), 3);
+    EXPECT_EQ(results.front().recommendedAction, FilterAction::TIMEOUT);  // Newest message, sixth or later
+
+    // Out-of-order input to the detector never keeps stale entries alive
+    SpamDetector detector;
+    for (int i = 100; i > 0; --i) {
+        auto verdict = detector.evaluate("regular", "hello", start + std::chrono::minutes(i), 0);
+        EXPECT_FALSE(verdict.rateExceeded) << "minute " << i;
+    }
+}
+
+TEST_F(DiscrubExtensionTest, EditsAreNotCountedAsNewMessages) {
+    auto& scanner = extension->getScanner();
+    auto start = std::chrono::system_clock::now();
+    DiscordMessage msg("m", "c", "editor", "first draft of my message");
+    msg.authorId = "editor";
+    msg.timestamp = start;
+    EXPECT_FALSE(scanner.scanMessage(msg).violation);
+
+    for (int i = 0; i < 10; ++i) {
+        msg.content = "revision " + std::to_string(i * 7919) + " of my message";
+        EXPECT_FALSE(scanner.scanEditedMessage(msg).violation) << "edit " << i;
+        extension->processMessageEdit(msg, msg);
+    }
+
+    // Edited content is still checked on its own
+    msg.content = std::string(200, '!');
+    EXPECT_TRUE(scanner.scanEditedMessage(msg).violation);
+
+    // The window holds only the original, so a second message is no flood
+    msg.content = "a genuinely new message";
+    msg.timestamp = start + std::chrono::seconds(1);
+    EXPECT_FALSE(scanner.scanMessage(msg).violation);
+}
+
 // Integration test for all modules
 class Stage6IntegrationTest : public ::testing::Test {
 protected:
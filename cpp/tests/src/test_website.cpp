@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include "elizaos/website.hpp"
+#include "elizaos/website_dev_server.hpp"
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace elizaos;
+
+namespace {
+
+int connectLoopback(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Reads until EOF, the deadline, or the expected text shows up
+std::string readResponse(int fd, const std::string& until = "", int timeout_ms = 2000) {
+    std::string data;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    char buffer[4096];
+    while (std::chrono::steady_clock::now() < deadline) {
+        pollfd pfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, 20) <= 0) continue;
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) break;
+        data.append(buffer, static_cast<size_t>(n));
+        if (!until.empty() && data.find(until) != std::string::npos) break;
+    }
+    return data;
+}
+
+std::string httpGet(int port, const std::string& path) {
+    int fd = connectLoopback(port);
+    if (fd < 0) return "";
+    std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    std::string response = readResponse(fd);
+    close(fd);
+    return response;
+}
+
+void writeFile(const std::filesystem::path& path, const std::string& content) {
+    std::filesystem::create_directories(path.parent_path());
+    std::ofstream file(path);
+    file << content;
+}
+
+} // anonymous namespace
+
+class WebsiteDevServerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        root = std::filesystem::temp_directory_path() /
+               ("elizaos_website_test_" + std::to_string(::getpid()));
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root);
+    }
+
+    void TearDown() override {
+        std::filesystem::remove_all(root);
+    }
+
+    std::filesystem::path root;
+};
+
+TEST_F(WebsiteDevServerTest, FileWatcherCoalescesBursts) {
+    FileWatcher watcher(std::chrono::milliseconds(30));
+    ASSERT_TRUE(watcher.addDirectory(root));
+
+    std::mutex mutex;
+    std::set<std::filesystem::path> seen;
+    std::atomic<int> callbacks{0};
+    ASSERT_TRUE(watcher.start([&](const std::vector<std::filesystem::path>& changed) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.insert(changed.begin(), changed.end());
+        callbacks++;
+    }));
+
+    for (int i = 0; i < 20; ++i) {
+        writeFile(root / ("file" + std::to_string(i) + ".md"), "content");
+    }
+    // Files created inside a new subdirectory are picked up too
+    writeFile(root / "nested" / "deep.md", "deep");
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::chrono::steady_clock::now() < deadline) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (seen.size() >= 21) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    watcher.stop();
+
+    EXPECT_EQ(seen.size(), 21u);
+    EXPECT_TRUE(seen.count(root / "nested" / "deep.md"));
+    EXPECT_LE(callbacks.load(), 3);
+}
+
+TEST_F(WebsiteDevServerTest, ServesFilesOverLoopback) {
+    writeFile(root / "index.html", "<html><body>home</body></html>");
+    writeFile(root / "about.html", "<html><body>about</body></html>");
+    writeFile(root / "style.css", "body{}");
+
+    DevServer server(root);
+    ASSERT_TRUE(server.start(0));
+    ASSERT_GT(server.getPort(), 0);
+
+    std::string index = httpGet(server.getPort(), "/");
+    EXPECT_NE(index.find("200 OK"), std::string::npos);
+    EXPECT_NE(index.find("home"), std::string::npos);
+    EXPECT_NE(index.find(DevServer::LIVE_RELOAD_PATH), std::string::npos);
+
+    std::string about = httpGet(server.getPort(), "/about");
+    EXPECT_NE(about.find("about"), std::string::npos);
+
+    std::string css = httpGet(server.getPort(), "/style.css");
+    EXPECT_NE(css.find("text/css"), std::string::npos);
+    EXPECT_EQ(css.find("<script>"), std::string::npos);
+
+    EXPECT_NE(httpGet(server.getPort(), "/missing.html").find("404"), std::string::npos);
+    EXPECT_NE(httpGet(server.getPort(), "/../secret").find("403"), std::string::npos);
+
+    server.stop();
+    EXPECT_FALSE(server.isRunning());
+}
+
+TEST_F(WebsiteDevServerTest, PushesReloadToEventStreamClients) {
+    DevServer server(root);
+    ASSERT_TRUE(server.start(0));
+
+    int fd = connectLoopback(server.getPort());
+    ASSERT_GE(fd, 0);
+    std::string request = std::string("GET ") + DevServer::LIVE_RELOAD_PATH + " HTTP/1.1\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    EXPECT_NE(readResponse(fd, "retry:").find("text/event-stream"), std::string::npos);
+
+    server.notifyReload();
+    EXPECT_NE(readResponse(fd, "data: reload").find("data: reload"), std::string::npos);
+    EXPECT_EQ(server.getReloadClientCount(), 1u);
+
+    close(fd);
+    server.stop();
+}
+
+TEST_F(WebsiteDevServerTest, EditTriggersIncrementalRebuildAndReload) {
+    WebsiteConfig config;
+    config.source_dir = root / "src";
+    config.output_dir = root / "dist";
+    config.templates_dir = root / "templates";
+    config.assets_dir = root / "assets";
+
+    Website website(config);
+    ASSERT_TRUE(website.initialize());
+    ASSERT_TRUE(website.serveDevelopmentSite(0));
+    EXPECT_TRUE(website.isWatching());
+
+    int fd = connectLoopback(website.getDevelopmentPort());
+    ASSERT_GE(fd, 0);
+    std::string request = std::string("GET ") + DevServer::LIVE_RELOAD_PATH + " HTTP/1.1\r\n\r\n";
+    send(fd, request.data(), request.size(), 0);
+    readResponse(fd, "retry:");
+
+    auto started = std::chrono::steady_clock::now();
+    writeFile(config.source_dir / "hello.md", "---\ntitle: Hello\n---\n# Greetings\n");
+    EXPECT_NE(readResponse(fd, "data: reload").find("data: reload"), std::string::npos);
+    auto latency = std::chrono::steady_clock::now() - started;
+    // The target is 100 ms; a rebuild takes about 20 ms here, mostly the
+    // watcher's coalesce window, which leaves the slack for a loaded runner
+    EXPECT_LT(latency, std::chrono::milliseconds(100));
+    close(fd);
+
+    std::string page = httpGet(website.getDevelopmentPort(), "/hello.html");
+    EXPECT_NE(page.find("<h1>Greetings</h1>"), std::string::npos);
+
+    std::filesystem::remove(config.source_dir / "hello.md");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (std::filesystem::exists(config.output_dir / "hello.html") &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_FALSE(std::filesystem::exists(config.output_dir / "hello.html"));
+
+    website.stopDevelopmentSite();
+    EXPECT_FALSE(website.isWatching());
+    EXPECT_EQ(website.getDevelopmentPort(), 0);
+}
+
+TEST_F(WebsiteDevServerTest, LostWatchEventsTriggerFullRebuild) {
+    WebsiteConfig config;
+    config.source_dir = root / "src";
+    config.output_dir = root / "dist";
+    config.templates_dir = root / "templates";
+    config.assets_dir = root / "assets";
+    writeFile(config.source_dir / "old.md", "# Old\n");
+
+    Website website(config);
+    ASSERT_TRUE(website.initialize());
+    ASSERT_TRUE(website.generateSite());
+    ASSERT_TRUE(std::filesystem::exists(config.output_dir / "old.html"));
+
+    // Changes the watcher never reported
+    std::filesystem::remove(config.source_dir / "old.md");
+    writeFile(config.source_dir / "new.md", "# New\n");
+
+    EXPECT_GE(website.rebuildChangedFiles({config.source_dir}), 1u);
+    EXPECT_TRUE(std::filesystem::exists(config.output_dir / "new.html"));
+    EXPECT_FALSE(std::filesystem::exists(config.output_dir / "old.html"));
+    EXPECT_EQ(website.getContentManager()->getPage("old"), nullptr);
+}
@@ -1,9 +1,9 @@
 #include "elizaos/the_org.hpp"
 #include "elizaos/agentlogger.hpp"
+#include "elizaos/text_entities.hpp"
 #include <algorithm>
 #include <random>
 #include <sstream>
-#include <regex>
 #include <iomanip>
 #include <fstream>
 #include <future>
@@ -40,7 +40,7 @@ TheOrgAgent::TheOrgAgent(const AgentConfig& config, AgentRole role)
 
 std::shared_ptr<Memory> TheOrgAgent::createMemory(const std::string& content, MemoryType type) {
     std::lock_guard<std::mutex> lock(memoryMutex_);
-    auto memory = std::make_shared<Memory>(generateUUID(), content, config_.agentId, config_.agentId);
+    auto memory = makeMemory(generateUUID(), content, config_.agentId, config_.agentId);
     
     // Set metadata based on type
     switch (type) {
@@ -228,7 +228,7 @@ void CommunityManagerAgent::initialize() {
 
 void CommunityManagerAgent::start() {
     running_ = true;
-    processingThread_ = std::thread(&CommunityManagerAgent::processLoop, this);
+    ticker_.start(std::chrono::seconds(1), [this] { processTick(); });
     
     
     LOG_INFO("CommunityManager", "Started Eli5 Community Manager Agent");
@@ -236,9 +236,7 @@ void CommunityManagerAgent::start() {
 
 void CommunityManagerAgent::stop() {
     running_ = false;
-    if (processingThread_.joinable()) {
-        processingThread_.join();
-    }
+    ticker_.stop();
     
     
     LOG_INFO("CommunityManager", "Stopped Eli5 Community Manager Agent");
@@ -415,32 +413,25 @@ void CommunityManagerAgent::announceEvent([[maybe_unused]] const std::string& ev
     }
 }
 
-void CommunityManagerAgent::processLoop() {
-    
-    LOG_INFO("CommunityManager", "Started processing loop");
-    
-    while (running_) {
-        if (!paused_) {
-            // Process incoming messages
-            auto messages = getIncomingMessages();
-            while (!messages.empty()) {
-                // Process message for greeting, moderation, etc.
-                messages.pop();
-            }
-            
-            // Update metrics periodically
-            updateCommunityMetrics();
-            
-            // Generate daily report if needed
-            auto now = std::chrono::system_clock::now();
-            static auto lastReport = now;
-            if (now - lastReport > std::chrono::hours(24)) {
-                generateDailyReport();
-                lastReport = now;
-            }
+void CommunityManagerAgent::processTick() {
+    if (!paused_) {
+        // Process incoming messages
+        auto messages = getIncomingMessages();
+        while (!messages.empty()) {
+            // Process message for greeting, moderation, etc.
+            messages.pop();
         }
         
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        // Update metrics periodically
+        updateCommunityMetrics();
+        
+        // Generate daily report if needed
+        auto now = std::chrono::system_clock::now();
+        static auto lastReport = now;
+        if (now - lastReport > std::chrono::hours(24)) {
+            generateDailyReport();
+            lastReport = now;
+        }
     }
 }
 
@@ -498,7 +489,7 @@ void DeveloperRelationsAgent::initialize() {
 
 void DeveloperRelationsAgent::start() {
     running_ = true;
-    processingThread_ = std::thread(&DeveloperRelationsAgent::processLoop, this);
+    ticker_.start(std::chrono::seconds(2), [this] { processTick(); });
     
     
     LOG_INFO("DeveloperRelations", "Started Eddy Developer Relations Agent");
@@ -506,9 +497,7 @@ void DeveloperRelationsAgent::start() {
 
 void DeveloperRelationsAgent::stop() {
     running_ = false;
-    if (processingThread_.joinable()) {
-        processingThread_.join();
-    }
+    ticker_.stop();
     
     
     LOG_INFO("DeveloperRelations", "Stopped Eddy Developer Relations Agent");
@@ -630,29 +619,22 @@ std::string DeveloperRelationsAgent::retrieveKnowledge(const std::string& topic)
     return "Knowledge about '" + topic + "' not found. Would you like me to research this topic?";
 }
 
-void DeveloperRelationsAgent::processLoop() {
-    
-    LOG_INFO("DeveloperRelations", "Started processing loop");
-    
-    while (running_) {
-        if (!paused_) {
-            // Process incoming questions
-            auto messages = getIncomingMessages();
-            while (!messages.empty()) {
-                std::string message = messages.front();
-                messages.pop();
-                
-                if (isCodeRelated(message)) {
-                    // Process as technical question
-                    processQuestion(message, "unknown_user", "unknown_channel");
-                }
-            }
+void DeveloperRelationsAgent::processTick() {
+    if (!paused_) {
+        // Process incoming questions
+        auto messages = getIncomingMessages();
+        while (!messages.empty()) {
+            std::string message = messages.front();
+            messages.pop();
             
-            // Update technical knowledge periodically
-            updateTechnicalKnowledge();
+            if (isCodeRelated(message)) {
+                // Process as technical question
+                processQuestion(message, "unknown_user", "unknown_channel");
+            }
         }
         
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        // Update technical knowledge periodically
+        updateTechnicalKnowledge();
     }
 }
 
@@ -721,7 +703,7 @@ void ProjectManagerAgent::initialize() {
 
 void ProjectManagerAgent::start() {
     running_ = true;
-    processingThread_ = std::thread(&ProjectManagerAgent::processLoop, this);
+    ticker_.start(std::chrono::hours(1), [this] { processTick(); });
     
     
     LOG_INFO("ProjectManager", "Started Jimmy Project Manager Agent");
@@ -729,9 +711,7 @@ void ProjectManagerAgent::start() {
 
 void ProjectManagerAgent::stop() {
     running_ = false;
-    if (processingThread_.joinable()) {
-        processingThread_.join();
-    }
+    ticker_.stop();
     
     
     LOG_INFO("ProjectManager", "Stopped Jimmy Project Manager Agent");
@@ -860,27 +840,20 @@ void ProjectManagerAgent::sendCheckinReminder(const UUID& teamMemberId, const UU
     }
 }
 
-void ProjectManagerAgent::processLoop() {
-    
-    LOG_INFO("ProjectManager", "Started processing loop");
-    
-    while (running_) {
-        if (!paused_) {
-            // Send daily check-ins
-            sendDailyCheckins();
+void ProjectManagerAgent::processTick() {
+    if (!paused_) {
+        // Send daily check-ins
+        sendDailyCheckins();
+        
+        // Generate weekly reports
+        auto now = std::chrono::system_clock::now();
+        static auto lastWeeklyReport = now;
+        if (now - lastWeeklyReport > std::chrono::hours(168)) { // 1 week
+            auto report = generateWeeklyReport();
             
-            // Generate weekly reports
-            auto now = std::chrono::system_clock::now();
-            static auto lastWeeklyReport = now;
-            if (now - lastWeeklyReport > std::chrono::hours(168)) { // 1 week
-                auto report = generateWeeklyReport();
-                
-                LOG_INFO("ProjectManager", "Generated weekly report: " + report);
-                lastWeeklyReport = now;
-            }
+            LOG_INFO("ProjectManager", "Generated weekly report: " + report);
+            lastWeeklyReport = now;
         }
-        
-        std::this_thread::sleep_for(std::chrono::seconds(3600)); // Check hourly
     }
 }
 
@@ -983,7 +956,7 @@ void TheOrgManager::startAllAgents() {
     }
     
     running_ = true;
-    coordinationThread_ = std::thread(&TheOrgManager::coordinationLoop, this);
+    coordinator_.start(std::chrono::seconds(5), [this] { coordinationTick(); });
     
     
     LOG_INFO("TheOrgManager", "Started all agents and coordination system");
@@ -991,10 +964,7 @@ void TheOrgManager::startAllAgents() {
 
 void TheOrgManager::stopAllAgents() {
     running_ = false;
-    
-    if (coordinationThread_.joinable()) {
-        coordinationThread_.join();
-    }
+    coordinator_.stop();
     
     std::lock_guard<std::mutex> lock(agentMutex_);
     for (const auto& [id, agent] : agents_) {
@@ -1046,22 +1016,15 @@ TheOrgManager::SystemMetrics TheOrgManager::getSystemMetrics() const {
     return currentMetrics_;
 }
 
-void TheOrgManager::coordinationLoop() {
+void TheOrgManager::coordinationTick() {
+    // Process inter-agent messages
+    processInterAgentMessages();
     
-    LOG_INFO("TheOrgManager", "Started coordination loop");
+    // Monitor agent health
+    monitorAgentHealth();
     
-    while (running_) {
-        // Process inter-agent messages
-        processInterAgentMessages();
-        
-        // Monitor agent health
-        monitorAgentHealth();
-        
-        // Update system metrics
-        updateSystemMetrics();
-        
-        std::this_thread::sleep_for(std::chrono::seconds(5));
-    }
+    // Update system metrics
+    updateSystemMetrics();
 }
 
 void TheOrgManager::processInterAgentMessages() {
@@ -1134,14 +1097,9 @@ std::string generateAgentId(AgentRole role) {
 
 std::vector<std::string> parseHashtags(const std::string& content) {
     std::vector<std::string> hashtags;
-    std::regex hashtagRegex(R"(#(\w+))");
-    std::sregex_iterator iter(content.begin(), content.end(), hashtagRegex);
-    std::sregex_iterator end;
-    
-    for (; iter != end; ++iter) {
-        hashtags.push_back(iter->str());
+    for (auto hashtag : extractTextEntities(content, TextEntityType::HASHTAG)) {
+        hashtags.emplace_back(hashtag);
     }
-    
     return hashtags;
 }
 
@@ -1234,17 +1192,11 @@ std::string sanitizeForPlatform(const std::string& content, PlatformType platfor
 }
 
 bool validateUrl(const std::string& url) {
-    std::regex urlRegex(R"(https?://[^\s]+)");
-    return std::regex_match(url, urlRegex);
+    return isHttpUrl(url);
 }
 
 std::string extractDomain(const std::string& url) {
-    std::regex domainRegex(R"(https?://([^/]+))");
-    std::smatch match;
-    if (std::regex_search(url, match, domainRegex)) {
-        return match[1].str();
-    }
-    return "";
+    return std::string(urlHost(url));
 }
 
 std::vector<std::string> splitText(const std::string& text, size_t maxLength, const std::string& delimiter) {
@@ -0,0 +1,526 @@
+#include "elizaos/website_dev_server.hpp"
+#include "elizaos/agentlogger.hpp"
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace elizaos {
+
+static AgentLogger g_dev_server_logger;
+
+namespace {
+
+constexpr size_t MAX_REQUEST_HEADER_BYTES = 16 * 1024;
+
+// Appended after the document so HTML files can still go out via sendfile(2)
+const std::string LIVE_RELOAD_SNIPPET =
+    "\n<script>(function(){var s=new EventSource('/__elizaos/livereload');"
+    "s.onmessage=function(e){if(e.data==='reload'){location.reload();}};})();</script>\n";
+
+std::string mimeTypeFor(const std::filesystem::path& path) {
+    static const std::unordered_map<std::string, std::string> types = {
+        {".html", "text/html; charset=utf-8"}, {".htm", "text/html; charset=utf-8"},
+        {".css", "text/css; charset=utf-8"},   {".js", "application/javascript"},
+        {".json", "application/json"},         {".svg", "image/svg+xml"},
+        {".png", "image/png"},                 {".jpg", "image/jpeg"},
+        {".jpeg", "image/jpeg"},               {".gif", "image/gif"},
+        {".ico", "image/x-icon"},              {".txt", "text/plain; charset=utf-8"},
+        {".xml", "application/xml"},           {".woff2", "font/woff2"},
+    };
+    auto it = types.find(path.extension().string());
+    return it != types.end() ? it->second : "application/octet-stream";
+}
+
+std::string urlDecode(const std::string& encoded) {
+    std::string decoded;
+    decoded.reserve(encoded.size());
+    for (size_t i = 0; i < encoded.size(); ++i) {
+        if (encoded[i] == '%' && i + 2 < encoded.size() &&
+            std::isxdigit(static_cast<unsigned char>(encoded[i + 1])) &&
+            std::isxdigit(static_cast<unsigned char>(encoded[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(encoded.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            decoded.push_back(encoded[i]);
+        }
+    }
+    return decoded;
+}
+
+enum class ConnectionState { READING, WRITING, EVENT_STREAM };
+
+struct Connection {
+    int fd = -1;
+    ConnectionState state = ConnectionState::READING;
+    std::string in;
+    std::string out;          // headers, or small bodies
+    size_t out_offset = 0;
+    int file_fd = -1;         // body streamed with sendfile
+    off_t file_offset = 0;
+    size_t file_remaining = 0;
+    std::string tail;         // live-reload snippet after an HTML body
+};
+
+} // anonymous namespace
+
+class DevServer::Impl {
+public:
+    explicit Impl(const std::filesystem::path& root) : root_(root) {}
+
+    ~Impl() { stop(); }
+
+    bool start(int port, const std::string& bind_address) {
+        if (running_) {
+            return false;
+        }
+
+        listen_fd_ = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) {
+            return false;
+        }
+        int reuse = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(port));
+        if (inet_pton(AF_INET, bind_address.c_str(), &addr.sin_addr) != 1 ||
+            bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+            listen(listen_fd_, SOMAXCONN) < 0) {
+            g_dev_server_logger.log("Failed to bind development server to " + bind_address + ":" +
+                                    std::to_string(port) + ": " + std::strerror(errno),
+                                    "", "website", LogLevel::ERROR);
+            closeFd(listen_fd_);
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            closeFd(listen_fd_);
+            closeFd(epoll_fd_);
+            closeFd(wake_fd_);
+            return false;
+        }
+        watch(listen_fd_, EPOLLIN, EPOLL_CTL_ADD);
+        watch(wake_fd_, EPOLLIN, EPOLL_CTL_ADD);
+
+        running_ = true;
+        thread_ = std::thread([this]() { run(); });
+
+        g_dev_server_logger.log("Development server listening on http://" + bind_address + ":" +
+                                std::to_string(port_), "", "website", LogLevel::INFO);
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        wake();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        for (auto& entry : connections_) {
+            closeFd(entry.second.file_fd);
+            closeFd(entry.second.fd);
+        }
+        connections_.clear();
+        event_stream_clients_ = 0;
+        closeFd(listen_fd_);
+        closeFd(epoll_fd_);
+        closeFd(wake_fd_);
+    }
+
+    bool isRunning() const { return running_; }
+    int getPort() const { return port_; }
+
+    void notifyReload() {
+        reload_requests_.fetch_add(1);
+        wake();
+    }
+
+    size_t getReloadClientCount() const { return event_stream_clients_; }
+    size_t getRequestsServed() const { return requests_served_; }
+
+private:
+    std::filesystem::path root_;
+    int listen_fd_ = -1;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    // Owned by the server thread
+    std::unordered_map<int, Connection> connections_;
+
+    std::atomic<uint64_t> reload_requests_{0};
+    uint64_t reloads_sent_ = 0;
+    std::atomic<size_t> event_stream_clients_{0};
+    std::atomic<size_t> requests_served_{0};
+
+    static void closeFd(int& fd) {
+        if (fd >= 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    void wake() {
+        if (wake_fd_ >= 0) {
+            uint64_t one = 1;
+            ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+            (void)ignored;
+        }
+    }
+
+    void watch(int fd, uint32_t events, int op) {
+        epoll_event ev{};
+        ev.events = events;
+        ev.data.fd = fd;
+        epoll_ctl(epoll_fd_, op, fd, &ev);
+    }
+
+    void run() {
+        epoll_event events[64];
+        while (running_) {
+            int count = epoll_wait(epoll_fd_, events, 64, -1);
+            if (count < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            for (int i = 0; i < count && running_; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listen_fd_) {
+                    acceptConnections();
+                } else if (fd == wake_fd_) {
+                    uint64_t value;
+                    ssize_t ignored = read(wake_fd_, &value, sizeof(value));
+                    (void)ignored;
+                    broadcastReloads();
+                } else {
+                    handleConnection(fd, events[i].events);
+                }
+            }
+        }
+    }
+
+    void acceptConnections() {
+        while (true) {
+            int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                return;
+            }
+            int nodelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            Connection conn;
+            conn.fd = fd;
+            connections_.emplace(fd, std::move(conn));
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_ADD);
+        }
+    }
+
+    void closeConnection(int fd) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+            return;
+        }
+        if (it->second.state == ConnectionState::EVENT_STREAM) {
+            event_stream_clients_--;
+        }
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        closeFd(it->second.file_fd);
+        closeFd(it->second.fd);
+        connections_.erase(it);
+    }
+
+    void handleConnection(int fd, uint32_t events) {
+        auto it = connections_.find(fd);
+        if (it == connections_.end()) {
+            return;
+        }
+        Connection& conn = it->second;
+
+        if (events & (EPOLLHUP | EPOLLERR)) {
+            closeConnection(fd);
+            return;
+        }
+
+        if (conn.state == ConnectionState::READING && (events & EPOLLIN)) {
+            char buffer[4096];
+            while (true) {
+                ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+                if (n > 0) {
+                    conn.in.append(buffer, static_cast<size_t>(n));
+                    continue;
+                }
+                if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    closeConnection(fd);
+                    return;
+                }
+                break;
+            }
+            size_t header_end = conn.in.find("\r\n\r\n");
+            if (header_end == std::string::npos) {
+                if (conn.in.size() > MAX_REQUEST_HEADER_BYTES) {
+                    closeConnection(fd);
+                }
+                return;
+            }
+            conn.state = ConnectionState::WRITING;
+            prepareResponse(conn, conn.in.substr(0, header_end));
+        } else if (conn.state == ConnectionState::EVENT_STREAM && (events & (EPOLLIN | EPOLLRDHUP))) {
+            // Event-stream clients never send after the request; data or EOF means they are gone
+            char buffer[256];
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+                closeConnection(fd);
+                return;
+            }
+        }
+
+        if (conn.state != ConnectionState::READING) {
+            flushConnection(fd);
+        }
+    }
+
+    void prepareResponse(Connection& conn, const std::string& head) {
+        requests_served_++;
+
+        size_t line_end = head.find("\r\n");
+        std::string request_line = head.substr(0, line_end);
+        size_t method_end = request_line.find(' ');
+        size_t target_end = request_line.find(' ', method_end + 1);
+        if (method_end == std::string::npos || target_end == std::string::npos) {
+            setSimpleResponse(conn, 400, "Bad Request");
+            return;
+        }
+        std::string method = request_line.substr(0, method_end);
+        std::string target = request_line.substr(method_end + 1, target_end - method_end - 1);
+        target = target.substr(0, target.find_first_of("?#"));
+
+        if (method != "GET" && method != "HEAD") {
+            setSimpleResponse(conn, 405, "Method Not Allowed");
+            return;
+        }
+
+        if (target == LIVE_RELOAD_PATH) {
+            conn.out = "HTTP/1.1 200 OK\r\n"
+                       "Content-Type: text/event-stream\r\n"
+                       "Cache-Control: no-cache\r\n"
+                       "Connection: keep-alive\r\n\r\n"
+                       "retry: 500\n\n";
+            conn.state = ConnectionState::EVENT_STREAM;
+            event_stream_clients_++;
+            return;
+        }
+
+        std::filesystem::path file_path;
+        int status = resolvePath(urlDecode(target), file_path);
+        if (status != 200) {
+            setSimpleResponse(conn, status, status == 403 ? "Forbidden" : "Not Found");
+            return;
+        }
+
+        int file_fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        struct stat st{};
+        if (file_fd < 0 || fstat(file_fd, &st) < 0) {
+            if (file_fd >= 0) close(file_fd);
+            setSimpleResponse(conn, 404, "Not Found");
+            return;
+        }
+
+        std::string mime = mimeTypeFor(file_path);
+        bool is_html = mime.rfind("text/html", 0) == 0;
+        size_t body_size = static_cast<size_t>(st.st_size) + (is_html ? LIVE_RELOAD_SNIPPET.size() : 0);
+
+        conn.out = "HTTP/1.1 200 OK\r\nContent-Type: " + mime +
+                   "\r\nContent-Length: " + std::to_string(body_size) +
+                   "\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n";
+        if (method == "HEAD") {
+            close(file_fd);
+            return;
+        }
+        conn.file_fd = file_fd;
+        conn.file_offset = 0;
+        conn.file_remaining = static_cast<size_t>(st.st_size);
+        if (is_html) {
+            conn.tail = LIVE_RELOAD_SNIPPET;
+        }
+    }
+
+    int resolvePath(const std::string& target, std::filesystem::path& resolved) const {
+        if (target.empty() || target[0] != '/') {
+            return 404;
+        }
+        std::filesystem::path relative = std::filesystem::path(target.substr(1)).lexically_normal();
+        for (const auto& part : relative) {
+            if (part == "..") {
+                return 403;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::path candidate = root_ / relative;
+        if (std::filesystem::is_directory(candidate, ec)) {
+            candidate /= "index.html";
+        } else if (!std::filesystem::exists(candidate, ec) && !candidate.has_extension()) {
+            // Generated pages are written as <id>.html; allow extensionless links
+            candidate += ".html";
+        }
+        if (!std::filesystem::is_regular_file(candidate, ec)) {
+            return 404;
+        }
+        resolved = candidate;
+        return 200;
+    }
+
+    static void setSimpleResponse(Connection& conn, int status, const std::string& reason) {
+        std::string body = std::to_string(status) + " " + reason + "\n";
+        conn.out = "HTTP/1.1 " + std::to_string(status) + " " + reason +
+                   "\r\nContent-Type: text/plain; charset=utf-8\r\nContent-Length: " +
+                   std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+    }
+
+    // Returns false once the connection is closed
+    bool flushConnection(int fd) {
+        Connection& conn = connections_.at(fd);
+
+        if (!writeBuffer(conn, conn.out)) {
+            return closeOnError(fd);
+        }
+        if (conn.out_offset < conn.out.size()) {
+            return waitWritable(fd);
+        }
+
+        while (conn.file_remaining > 0) {
+            ssize_t sent = sendfile(fd, conn.file_fd, &conn.file_offset, conn.file_remaining);
+            if (sent > 0) {
+                conn.file_remaining -= static_cast<size_t>(sent);
+            } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return waitWritable(fd);
+            } else {
+                return closeOnError(fd);
+            }
+        }
+        closeFd(conn.file_fd);
+
+        if (!conn.tail.empty()) {
+            conn.out = std::move(conn.tail);
+            conn.tail.clear();
+            conn.out_offset = 0;
+            return flushConnection(fd);
+        }
+
+        if (conn.state == ConnectionState::EVENT_STREAM) {
+            conn.out.clear();
+            conn.out_offset = 0;
+            watch(fd, EPOLLIN | EPOLLRDHUP, EPOLL_CTL_MOD);
+            return true;
+        }
+
+        closeConnection(fd);
+        return false;
+    }
+
+    bool writeBuffer(Connection& conn, const std::string& buffer) {
+        while (conn.out_offset < buffer.size()) {
+            ssize_t n = send(conn.fd, buffer.data() + conn.out_offset, buffer.size() - conn.out_offset,
+                             MSG_NOSIGNAL);
+            if (n > 0) {
+                conn.out_offset += static_cast<size_t>(n);
+            } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                return true;
+            } else {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool waitWritable(int fd) {
+        watch(fd, EPOLLOUT | EPOLLRDHUP, EPOLL_CTL_MOD);
+        return true;
+    }
+
+    bool closeOnError(int fd) {
+        closeConnection(fd);
+        return false;
+    }
+
+    void broadcastReloads() {
+        uint64_t requested = reload_requests_.load();
+        if (requested == reloads_sent_) {
+            return;
+        }
+        reloads_sent_ = requested;
+
+        std::vector<int> clients;
+        for (const auto& entry : connections_) {
+            if (entry.second.state == ConnectionState::EVENT_STREAM) {
+                clients.push_back(entry.first);
+            }
+        }
+        for (int fd : clients) {
+            Connection& conn = connections_.at(fd);
+            if (conn.out_offset >= conn.out.size()) {
+                conn.out.clear();
+                conn.out_offset = 0;
+            }
+            conn.out += "data: reload\n\n";
+            flushConnection(fd);
+        }
+    }
+};
+
+DevServer::DevServer(const std::filesystem::path& root_dir) : impl_(std::make_unique<Impl>(root_dir)) {}
+DevServer::~DevServer() = default;
+
+bool DevServer::start(int port, const std::string& bind_address) {
+    return impl_->start(port, bind_address);
+}
+
+void DevServer::stop() {
+    impl_->stop();
+}
+
+bool DevServer::isRunning() const {
+    return impl_->isRunning();
+}
+
+int DevServer::getPort() const {
+    return impl_->getPort();
+}
+
+void DevServer::notifyReload() {
+    impl_->notifyReload();
+}
+
+size_t DevServer::getReloadClientCount() const {
+    return impl_->getReloadClientCount();
+}
+
+size_t DevServer::getRequestsServed() const {
+    return impl_->getRequestsServed();
+}
+
+} // namespace elizaos
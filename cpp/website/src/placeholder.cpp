@@ -1,5 +1,6 @@
 #include "elizaos/website.hpp"
 #include "elizaos/agentlogger.hpp"
+#include "elizaos/website_dev_server.hpp"
 #include <fstream>
 #include <sstream>
 #include <regex>
@@ -137,34 +138,8 @@ bool ContentManager::loadPagesFromDirectory(const std::filesystem::path& directo
         }
         
         for (const auto& entry : std::filesystem::recursive_directory_iterator(directory)) {
-            if (entry.is_regular_file() && (isMarkdownFile(entry.path()) || isHtmlFile(entry.path()))) {
-                std::ifstream file(entry.path());
-                if (!file.is_open()) continue;
-                
-                std::stringstream buffer;
-                buffer << file.rdbuf();
-                std::string content = buffer.str();
-                
-                std::string page_id = generatePageId(entry.path());
-                auto metadata = parsePageMetadata(content);
-                std::string clean_content = stripMetadata(content);
-                
-                std::string title = metadata.count("title") ? metadata["title"] : entry.path().stem().string();
-                
-                WebPage page(page_id, title, clean_content);
-                page.source_path = entry.path();
-                page.metadata = metadata;
-                
-                // Set template name from metadata or file extension
-                if (metadata.count("template")) {
-                    page.template_name = metadata["template"];
-                } else if (isMarkdownFile(entry.path())) {
-                    page.template_name = "markdown";
-                } else {
-                    page.template_name = "html";
-                }
-                
-                addPage(page);
+            if (entry.is_regular_file() && isContentFile(entry.path())) {
+                loadPageFromFile(entry.path());
             }
         }
         return true;
@@ -173,6 +148,60 @@ bool ContentManager::loadPagesFromDirectory(const std::filesystem::path& directo
     }
 }
 
+std::shared_ptr<WebPage> ContentManager::loadPageFromFile(const std::filesystem::path& file_path) {
+    std::ifstream file(file_path);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+    
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content = buffer.str();
+    
+    std::string page_id = generatePageId(file_path);
+    auto metadata = parsePageMetadata(content);
+    std::string clean_content = stripMetadata(content);
+    
+    std::string title = metadata.count("title") ? metadata["title"] : file_path.stem().string();
+    
+    WebPage page(page_id, title, clean_content);
+    page.source_path = file_path;
+    page.metadata = metadata;
+    
+    // Set template name from metadata or file extension
+    if (metadata.count("template")) {
+        page.template_name = metadata["template"];
+    } else if (isMarkdownFile(file_path)) {
+        page.template_name = "markdown";
+    } else {
+        page.template_name = "html";
+    }
+    
+    // Keep the original creation time when a page is reloaded after an edit
+    auto existing = pages_.find(page_id);
+    if (existing != pages_.end()) {
+        page.created_at = existing->second->created_at;
+    }
+    
+    addPage(page);
+    return pages_[page_id];
+}
+
+std::string ContentManager::removePageBySource(const std::filesystem::path& source_path) {
+    for (auto it = pages_.begin(); it != pages_.end(); ++it) {
+        if (it->second->source_path == source_path) {
+            std::string page_id = it->first;
+            pages_.erase(it);
+            return page_id;
+        }
+    }
+    return "";
+}
+
+bool ContentManager::isContentFile(const std::filesystem::path& file_path) const {
+    return isMarkdownFile(file_path) || isHtmlFile(file_path);
+}
+
 bool ContentManager::savePage(const WebPage& page, const std::filesystem::path& output_path) const {
     try {
         std::filesystem::create_directories(output_path.parent_path());
@@ -439,7 +468,9 @@ std::string StaticSiteGenerator::markdownToHtml(const std::string& markdown) con
 
 // Website implementation
 Website::Website(const WebsiteConfig& config) : config_(config) {}
-Website::~Website() = default;
+Website::~Website() {
+    stopDevelopmentSite();
+}
 
 bool Website::initialize() {
     if (!setupDirectories()) {
@@ -474,27 +505,166 @@ bool Website::generateSite() {
         return false;
     }
     
+    std::lock_guard<std::mutex> lock(build_mutex_);
     return generator_->generateSite();
 }
 
 bool Website::serveDevelopmentSite(int port) {
-    // This would implement a simple HTTP server for development
-    // For now, just log that this feature would be implemented
-    g_website_logger.log("Development server would be started on port " + std::to_string(port), 
-                        "", "website", LogLevel::INFO);
-    return true;
+    if (!initialized_) {
+        return false;
+    }
+    if (dev_server_ && dev_server_->isRunning()) {
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(build_mutex_);
+        if (!generator_->generateSite()) {
+            g_website_logger.log("Initial build finished with errors; serving partial output", 
+                                "", "website", LogLevel::WARNING);
+        }
+    }
+    
+    dev_server_ = std::make_unique<DevServer>(config_.output_dir);
+    if (!dev_server_->start(port)) {
+        dev_server_.reset();
+        return false;
+    }
+    
+    return watchForChanges(true);
+}
+
+void Website::stopDevelopmentSite() {
+    watchForChanges(false);
+    if (dev_server_) {
+        dev_server_->stop();
+        dev_server_.reset();
+    }
+}
+
+int Website::getDevelopmentPort() const {
+    return dev_server_ ? dev_server_->getPort() : 0;
 }
 
 bool Website::watchForChanges(bool enable) {
-    watching_ = enable;
-    if (enable) {
-        g_website_logger.log("File watching enabled", "", "website", LogLevel::INFO);
-    } else {
-        g_website_logger.log("File watching disabled", "", "website", LogLevel::INFO);
+    if (!enable) {
+        if (watcher_) {
+            watcher_->stop();
+            watcher_.reset();
+        }
+        if (watching_) {
+            g_website_logger.log("File watching disabled", "", "website", LogLevel::INFO);
+        }
+        watching_ = false;
+        return true;
     }
+    
+    if (watching_) {
+        return true;
+    }
+    if (!initialized_) {
+        return false;
+    }
+    
+    watcher_ = std::make_unique<FileWatcher>(config_.watch_coalesce_window);
+    bool watched_any = false;
+    for (const auto& dir : {config_.source_dir, config_.templates_dir, config_.assets_dir}) {
+        watched_any = watcher_->addDirectory(dir) || watched_any;
+    }
+    if (!watched_any || !watcher_->start([this](const std::vector<std::filesystem::path>& changed) {
+            rebuildChangedFiles(changed);
+        })) {
+        watcher_.reset();
+        g_website_logger.log("Failed to start file watcher", "", "website", LogLevel::ERROR);
+        return false;
+    }
+    
+    watching_ = true;
+    g_website_logger.log("File watching enabled", "", "website", LogLevel::INFO);
     return true;
 }
 
+size_t Website::rebuildChangedFiles(const std::vector<std::filesystem::path>& changed) {
+    if (!initialized_) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(build_mutex_);
+    size_t rebuilt = 0;
+    bool templates_changed = false;
+    
+    // The watcher reports a watched root itself when it lost events
+    bool events_lost = std::any_of(changed.begin(), changed.end(), [this](const std::filesystem::path& path) {
+        auto normal = path.lexically_normal();
+        return normal == config_.source_dir.lexically_normal() ||
+               normal == config_.templates_dir.lexically_normal() ||
+               normal == config_.assets_dir.lexically_normal();
+    });
+    if (events_lost) {
+        std::error_code ec;
+        for (const auto& page : content_manager_->getAllPages()) {
+            if (!page->source_path.empty() && !std::filesystem::exists(page->source_path, ec)) {
+                content_manager_->removePageBySource(page->source_path);
+                std::filesystem::remove(config_.output_dir / (page->id + ".html"), ec);
+            }
+        }
+        content_manager_->loadPagesFromDirectory(config_.source_dir);
+        templates_changed = true;
+    }
+    
+    for (const auto& path : changed) {
+        if (events_lost) {
+            break;
+        }
+        std::error_code ec;
+        bool exists = std::filesystem::is_regular_file(path, ec);
+        
+        if (isWithin(path, config_.templates_dir)) {
+            templates_changed = true;
+        } else if (isWithin(path, config_.assets_dir)) {
+            auto target = config_.output_dir / "assets" / path.lexically_relative(config_.assets_dir);
+            if (exists) {
+                std::filesystem::create_directories(target.parent_path(), ec);
+                std::filesystem::copy_file(path, target, std::filesystem::copy_options::overwrite_existing, ec);
+            } else {
+                std::filesystem::remove(target, ec);
+            }
+            rebuilt += ec ? 0 : 1;
+        } else if (isWithin(path, config_.source_dir) && content_manager_->isContentFile(path)) {
+            if (exists) {
+                auto page = content_manager_->loadPageFromFile(path);
+                if (page && generator_->generatePage(page->id)) {
+                    rebuilt++;
+                }
+            } else {
+                std::string page_id = content_manager_->removePageBySource(path);
+                if (!page_id.empty()) {
+                    std::filesystem::remove(config_.output_dir / (page_id + ".html"), ec);
+                    rebuilt++;
+                }
+            }
+        }
+    }
+    
+    if (templates_changed) {
+        // Every page may depend on a template, and lost events may hide any change,
+        // so these are the cases that need a full build
+        loadDefaultTemplates();
+        generator_->generateSite();
+        rebuilt += generator_->getLastGenerationStats().pages_generated;
+    }
+    
+    if (rebuilt > 0 && dev_server_) {
+        dev_server_->notifyReload();
+    }
+    return rebuilt;
+}
+
+bool Website::isWithin(const std::filesystem::path& path, const std::filesystem::path& directory) {
+    auto relative = path.lexically_normal().lexically_relative(directory.lexically_normal());
+    return !relative.empty() && *relative.begin() != "..";
+}
+
 bool Website::updateConfig(const WebsiteConfig& config) {
     config_ = config;
     if (content_manager_) {
@@ -553,15 +723,6 @@ bool Website::loadDefaultTemplates() {
 </body>
 </html>)";
     
-    // Store templates directly in memory for default templates
-    template_engine_->loadTemplate("html", config_.templates_dir / "default.html");
-    template_engine_->loadTemplate("markdown", config_.templates_dir / "default.html");
-    
-    // Set global variables
-    template_engine_->setGlobalVariable("site_title", config_.site_title);
-    template_engine_->setGlobalVariable("site_description", config_.site_description);
-    template_engine_->setGlobalVariable("base_url", config_.base_url);
-    
     // Save default template to file if it doesn't exist
     auto default_template_path = config_.templates_dir / "default.html";
     if (!std::filesystem::exists(default_template_path)) {
@@ -576,6 +737,15 @@ bool Website::loadDefaultTemplates() {
         }
     }
     
+    // Load templates after the default file is written so a fresh site can render
+    template_engine_->loadTemplate("html", default_template_path);
+    template_engine_->loadTemplate("markdown", default_template_path);
+    
+    // Set global variables
+    template_engine_->setGlobalVariable("site_title", config_.site_title);
+    template_engine_->setGlobalVariable("site_description", config_.site_description);
+    template_engine_->setGlobalVariable("base_url", config_.base_url);
+    
     return true;
 }
 
@@ -1,6 +1,7 @@
 #include "elizaos/elizas_list.hpp"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 
 using namespace elizaos;
 
@@ -139,7 +140,55 @@ int main() {
     // Test tag aggregation
     auto allTags = elizasList.getAllTags();
     test_assert(allTags.size() >= 3, "All tags aggregated correctly"); // At least "Another", "C++", "Test", "Unit"
-    
+    test_assert(std::is_sorted(allTags.begin(), allTags.end()), "All tags returned in sorted order");
+    test_assert(elizasList.countProjectsByTag("Test") == 2, "Tag count covers every tagged project");
+    test_assert(elizasList.countProjectsByAuthor("https://github.com/another") == 1, "Author count is maintained");
+
+    // Test catalogue indexes follow updates
+    Project retagged = *elizasList.getProject("test-project-1");
+    retagged.tags = {"Retagged"};
+    retagged.metrics = Metrics{500, 1};
+    retagged.name = "Renamed Project";
+    test_assert(elizasList.updateProject(retagged), "Retagging update succeeds");
+    test_assert(elizasList.getProjectsByTag("Unit").empty(), "Old tag no longer lists updated project");
+    test_assert(elizasList.getProjectsByTag("Retagged").size() == 1, "New tag lists updated project");
+    test_assert(elizasList.getTopProjectsByStars(1)[0].id == "test-project-1", "Star view reorders after update");
+    test_assert(elizasList.searchProjects("renamed").size() == 1, "Search sees updated name");
+    test_assert(elizasList.searchProjects("test project one").empty(), "Search forgets previous name");
+    test_assert(elizasList.getAllProjects()[0].id == "test-project-1", "Update keeps insertion order");
+
+    auto tagCounts = elizasList.getTagCounts();
+    bool retaggedCounted = std::any_of(tagCounts.begin(), tagCounts.end(), [](const auto& entry) {
+        return entry.first == "Retagged" && entry.second == 1;
+    });
+    test_assert(retaggedCounted, "Tag counts reflect updated tags");
+
+    // Test ties keep insertion order and copies carry their own indexes
+    ElizasList tied;
+    for (int i = 0; i < 5; ++i) {
+        Project p = project2;
+        p.id = "tied-" + std::to_string(i);
+        tied.addProject(p);
+    }
+    auto tiedByStars = tied.getProjectsSortedByStars();
+    auto tiedByRecency = tied.getRecentProjects(5);
+    bool stableTies = true;
+    for (int i = 0; i < 5; ++i) {
+        stableTies = stableTies && tiedByStars[i].id == "tied-" + std::to_string(i) &&
+                     tiedByRecency[i].id == "tied-" + std::to_string(i);
+    }
+    test_assert(stableTies, "Equal keys keep insertion order");
+    test_assert(tied.getTopProjectsByStars(2).size() == 2, "Top-k view is limited");
+
+    ElizasList tiedCopy = tied;
+    tied.removeProject("tied-0");
+    test_assert(tiedCopy.getProjectsByTag("Test").size() == 5, "Copy keeps its own tag index");
+    test_assert(tied.getProjectsByTag("Test").size() == 4, "Removal drops project from tag index");
+    test_assert(tied.getRecentProjects(5).size() == 4, "Removal drops project from recency view");
+
+    // Restore the original first project for the removal tests below
+    test_assert(elizasList.updateProject(project1), "Restoring update succeeds");
+
     // Test project removal
     test_assert(elizasList.removeProject("test-project-1"), "Project removal succeeds");
     test_assert(elizasList.getProjectCount() == 1, "Project count decreases after removal");
@@ -5,18 +5,13 @@
 #include <unordered_map>
 #include <functional>
 #include <memory>
-#include <any>
 #include "elizaos/core.hpp"
+#include "elizaos/json.hpp"
 #include "elizaos/agentmemory.hpp"
 #include "elizaos/agentlogger.hpp"
 
 namespace elizaos {
 
-/**
- * @brief Simple JSON-like container using std::any
- */
-using JsonValue = std::unordered_map<std::string, std::any>;
-
 /**
  * @brief Represents a function that can be executed as an action
  */
@@ -5,18 +5,13 @@
 #include <unordered_map>
 #include <memory>
 #include <chrono>
-#include <any>
 #include "elizaos/core.hpp"
+#include "elizaos/json.hpp"
 #include "elizaos/agentmemory.hpp"
 #include "elizaos/agentlogger.hpp"
 
 namespace elizaos {
 
-/**
- * @brief Simple JSON-like container using std::any
- */
-using JsonValue = std::unordered_map<std::string, std::any>;
-
 /**
  * @brief Agenda task status enumeration (different from core TaskStatus)
  */
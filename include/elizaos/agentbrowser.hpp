@@ -1,5 +1,6 @@
 #pragma once
 
+#include "elizaos/page_index.hpp"
 #include <string>
 #include <memory>
 #include <vector>
@@ -7,6 +8,7 @@
 #include <thread>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <optional>
 #include <unordered_map>
 #include <mutex>
@@ -16,6 +18,8 @@ namespace elizaos {
 // Forward declarations
 class AgentMemoryManager;
 class AgentLogger;
+class HtmlDocument;
+struct HtmlNode;
 
 /**
  * Browser automation result types
@@ -124,6 +128,18 @@ public:
     BrowserResult refresh();
     BrowserResult waitForPageLoad(int timeoutSec = 30);
 
+    /**
+     * Parse a page from memory or disk; no network access. navigateTo()
+     * takes file:// URLs the same way, while other URLs carry no content
+     */
+    BrowserResult loadHTML(const std::string& html, const std::string& url = "about:blank");
+    BrowserResult loadFile(const std::string& path);
+
+    /**
+     * Parsed current page, or null; stays valid after later navigation
+     */
+    std::shared_ptr<const HtmlDocument> getDocument() const;
+
     // Content extraction
     std::optional<PageInfo> getCurrentPageInfo();
     std::optional<std::string> getPageTitle();
@@ -166,9 +182,13 @@ public:
     void setMemory(std::shared_ptr<AgentMemoryManager> memory);
     void setLogger(std::shared_ptr<AgentLogger> logger);
     
-    // Remember browsing patterns for future automation
+    // Remember browsing patterns for future automation. Every loaded page is
+    // indexed by canonical URL and text fingerprint, so crawlers can check
+    // hasVisited() before fetching and PageVisit::duplicateOf after loading
     void rememberPage(const std::string& url, const std::string& purpose);
     std::vector<std::string> getSimilarPages(const std::string& purpose);
+    bool hasVisited(const std::string& url) const { return pageIndex_.hasVisited(url); }
+    PageIndex& getPageIndex() { return pageIndex_; }
 
     // Configuration
     void setConfig(const BrowserConfig& config);
@@ -196,10 +216,17 @@ private:
     std::string sessionId_;
     std::string currentUrl_;
     mutable std::mutex sessionMutex_;
+
+    // Loaded page; replaced whole on navigation so readers keep a consistent tree
+    std::shared_ptr<const HtmlDocument> document_;
+    std::string pageSource_;
+    std::chrono::system_clock::time_point loadTime_;
+    std::condition_variable documentChanged_;
     
     // Memory and logging integration
     std::shared_ptr<AgentMemoryManager> memory_;
     std::shared_ptr<AgentLogger> logger_;
+    PageIndex pageIndex_;
     
     // Statistics
     mutable std::mutex statsMutex_;
@@ -214,6 +241,9 @@ private:
     std::string generateScreenshotFilename();
     void logAction(const std::string& action, const BrowserResult& result);
     void updateStatistics(const std::string& action, std::chrono::milliseconds duration);
+    void indexVisit(const std::string& url, const std::string& purpose, std::string_view pageText);
+    BrowserResult waitForDocument(int timeoutSec, const std::function<bool(const HtmlDocument&)>& ready,
+                                  const std::string& foundMessage, const std::string& timeoutMessage);
     
     // Browser driver operations (implementation-specific)
     BrowserResult initializeBrowserDriver();
@@ -229,6 +259,7 @@ namespace browser_utils {
     std::string xpathSelector(const std::string& element, const std::string& text = "");
     bool isValidUrl(const std::string& url);
     std::string extractDomain(const std::string& url);
+    std::string resolveUrl(const std::string& base, const std::string& href);
     std::vector<std::string> extractEmails(const std::string& text);
     std::vector<std::string> extractPhoneNumbers(const std::string& text);
 }
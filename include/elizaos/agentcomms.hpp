@@ -12,9 +12,13 @@
 #include <queue>
 #include <atomic>
 #include <chrono>
+#include <deque>
+#include "elizaos/pool.hpp"
 
 namespace elizaos {
 
+class TraceReplayer;
+
 /**
  * UUID type for agent and message identification
  */
@@ -138,6 +142,10 @@ using MessageValidator = std::function<MessageValidationResult(const Message&, c
 
 /**
  * Communication channel for message passing
+ *
+ * Messages are handled in order, one at a time, by a drain task on the
+ * executor's blocking pool that exists only while messages are waiting, so
+ * an idle channel holds no thread.
  */
 class CommChannel {
 public:
@@ -215,7 +223,7 @@ public:
     bool isActive() const { return active_; }
     
 private:
-    void processMessages();
+    void drainMessages();
     MessageValidationResult validateMessage(const Message& message) const;
     
     ChannelId channelId_;
@@ -223,17 +231,17 @@ private:
     std::atomic<bool> active_;
     std::atomic<bool> stopRequested_;
     
-    std::queue<Message> messageQueue_;
+    std::queue<Message, std::deque<Message, PoolAllocator<Message>>> messageQueue_;   // Nodes come from the slab pools
     std::mutex queueMutex_;
-    std::condition_variable queueCondition_;
+    std::condition_variable queueCondition_;    // Signalled when a drain finishes
+    bool draining_ = false;                     // A drain task is queued or running
+    std::thread::id drainThread_;               // Thread running the drain, if any
     
     MessageHandler messageHandler_;
     MessageValidator messageValidator_;
     
     std::unordered_set<AgentId> participants_;
     mutable std::mutex participantsMutex_;
-    
-    std::unique_ptr<std::thread> processingThread_;
 };
 
 /**
@@ -462,6 +470,11 @@ void shutdownComms();
 bool sendAgentMessage(const ChannelId& channelId, const std::string& content, const AgentId& sender = "");
 void setGlobalMessageReceiver(MessageHandler handler);
 
+/**
+ * Re-sends recorded messages into channel; events of other channels are skipped
+ */
+void addChannelReplay(TraceReplayer& replayer, CommChannel& channel);
+
 /**
  * Message validation utilities
  */
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "elizaos/core.hpp"
+#include "elizaos/executor.hpp"
 #include <vector>
 #include <functional>
 #include <thread>
@@ -14,8 +15,11 @@ namespace elizaos {
  * AgentLoop - Core event loop system for agent execution
  * C++ implementation of the Python agentloop module functionality
  * 
- * Provides threading-based event loop with pause/resume/step capabilities
- * similar to the Python implementation in agentloop/agentloop/loop.py
+ * Provides an event loop with pause/resume/step capabilities similar to
+ * the Python implementation in agentloop/agentloop/loop.py. Steps run as
+ * tasks on the executor's blocking pool; stepInterval is waited out on the
+ * executor's timer and a paused loop holds no thread until step() or
+ * unpause() wakes it.
  */
 
 // Step function type - can take 1 or 2 arguments like Python version
@@ -49,7 +53,7 @@ public:
     ~AgentLoop();
     
     /**
-     * Start the agent loop in a separate thread
+     * Schedule the first iteration after stepInterval
      * Equivalent to start() function in Python implementation
      */
     void start();
@@ -104,10 +108,13 @@ public:
     
 private:
     /**
-     * Main loop execution function - runs in separate thread
-     * Equivalent to loop() function in Python implementation
+     * Runs steps until the iteration ends, the loop parks while paused or
+     * stop is requested - the executor task behind loop() in the Python
+     * implementation
      */
-    void runLoop();
+    void advance();
+    void scheduleLocked(std::chrono::steady_clock::duration delay);
+    void wake();
     
     /**
      * Input handling thread function
@@ -117,20 +124,20 @@ private:
     std::vector<LoopStep> steps_;
     double stepInterval_;
     
-    // Threading and synchronization
-    std::unique_ptr<std::thread> loopThread_;
     std::atomic<bool> stopRequested_;
     std::atomic<bool> pauseRequested_;
     std::atomic<bool> running_;
     
-    // Events for synchronization (similar to Python threading.Event)
-    std::condition_variable stepEvent_;
-    std::condition_variable startedEvent_;
+    // Guards the loop state below
     std::mutex stepMutex_;
-    std::mutex startedMutex_;
+    std::condition_variable idle_;
     
     bool stepSignaled_;
-    bool started_;
+    bool scheduled_ = false;                    // advance() is pending or running
+    Executor::TimerId timer_ = 0;               // Pending advance() on the timer
+    std::thread::id runner_;                    // Thread running advance()
+    size_t nextStep_ = 0;
+    std::shared_ptr<void> nextOutput_;
     
     // Input handling
     std::atomic<bool> inputHandlingEnabled_;
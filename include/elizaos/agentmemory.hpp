@@ -1,6 +1,13 @@
 #pragma once
 
 #include "elizaos/core.hpp"
+#include "elizaos/memory_governor.hpp"
+#include "elizaos/uuid.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <unordered_set>
 #include <vector>
 #include <unordered_map>
 #include <memory>
@@ -41,13 +48,78 @@ struct MemorySearchByEmbeddingParams {
     std::optional<UUID> entityId;
 };
 
-class AgentMemoryManager {
+enum class MemoryChangeKind : uint8_t {
+    CREATED,
+    UPDATED,
+    DELETED
+};
+
+struct MemoryChange {
+    uint64_t sequence = 0;              // Per table, counting up from 1
+    MemoryChangeKind kind = MemoryChangeKind::CREATED;
+    std::string tableName;
+    std::shared_ptr<Memory> memory;     // As stored by the change; the removed memory for DELETED
+};
+
+/**
+ * Changes after a cursor. When the log no longer reaches back to the
+ * cursor (it was trimmed, or the table was cleared or restored) no changes
+ * are returned and truncated is set: re-read the table, then continue from
+ * cursor, which may repeat changes made in between
+ */
+struct MemoryChangeBatch {
+    std::vector<MemoryChange> changes;
+    uint64_t cursor = 0;                // Sequence of the last change returned
+    bool truncated = false;
+};
+
+/**
+ * Standing query over memory writes; unset filters match everything
+ */
+struct LiveQuery {
+    std::optional<std::string> tableName;
+    std::optional<UUID> roomId;
+    std::optional<UUID> entityId;
+    std::optional<UUID> agentId;
+    EmbeddingVector embedding;          // When set, only memories at least matchThreshold similar
+    double matchThreshold = 0.7;
+};
+
+struct LiveQueryEvent {
+    MemoryChange change;
+    bool matches = true;                // False when the change took the memory out of the results
+    double similarity = 0.0;            // To LiveQuery::embedding, when set
+};
+
+using LiveQueryCallback = std::function<void(const LiveQueryEvent&)>;
+
+struct MemoryBulkLoadResult {
+    std::vector<UUID> ids;              // Per input: the stored id, the duplicate's id, or empty when rejected
+    size_t inserted = 0;
+    size_t replaced = 0;                // Replaced a stored memory with the same id
+    size_t duplicates = 0;              // Skipped as duplicates under unique
+    size_t rejected = 0;                // Null or without an id
+};
+
+class AgentMemoryManager : public Snapshottable, public MemoryConsumer {
 public:
     AgentMemoryManager();
-    ~AgentMemoryManager() = default;
+    ~AgentMemoryManager();
 
     // Core memory operations
     UUID createMemory(std::shared_ptr<Memory> memory, const std::string& tableName = "memories", bool unique = false);
+
+    /**
+     * Stores memories as consecutive createMemory() calls would, for
+     * imports. Validation, content hashing and size estimates run on the
+     * executor before any lock is taken; the memories are then applied in
+     * slices of BULK_APPLY_SLICE, each under one short hold of the lock, so
+     * readers are not starved while a large batch loads
+     */
+    MemoryBulkLoadResult createMemories(const std::vector<std::shared_ptr<Memory>>& memories,
+                                        const std::string& tableName = "memories", bool unique = false);
+    static constexpr size_t BULK_APPLY_SLICE = 16384;
+
     std::shared_ptr<Memory> getMemoryById(const UUID& id);
     std::vector<std::shared_ptr<Memory>> getMemoriesByIds(const std::vector<UUID>& ids, const std::string& tableName = "memories");
     bool updateMemory(std::shared_ptr<Memory> memory);
@@ -67,18 +139,135 @@ public:
     // Thread-safe operations
     void enableThreadSafety(bool enable = true) { threadSafetyEnabled_ = enable; }
 
+    // Change feed; every create, update and delete is appended to its
+    // table's log, of which the latest changesPerTable are kept. Clearing
+    // or restoring the manager truncates the logs, and memories evicted by
+    // the memory governor are not logged
+    void setChangeLogCapacity(size_t changesPerTable);
+    uint64_t getLatestSequence(const std::string& tableName = "memories");
+    MemoryChangeBatch readChanges(const std::string& tableName, uint64_t cursor, size_t maxChanges = 1024);
+
+    /**
+     * Waits until the table has changes after cursor or the timeout passes;
+     * returns whether it has
+     */
+    bool waitForChanges(const std::string& tableName, uint64_t cursor, std::chrono::milliseconds timeout);
+
+    /**
+     * Registers a live query; afterwards every write is checked against it
+     * and a change to a memory that matches, or matched before the change,
+     * is passed to callback. Callbacks run after the write's lock is
+     * released, one at a time and in write order, on a writing thread; they
+     * may write memories themselves. initialResults receives the memories
+     * matching when the query was registered. Returns the subscription id
+     */
+    uint64_t subscribeLiveQuery(const LiveQuery& query, LiveQueryCallback callback,
+                                std::vector<std::shared_ptr<Memory>>* initialResults = nullptr);
+
+    /**
+     * Stops a live query; a callback already running may still finish
+     */
+    bool unsubscribeLiveQuery(uint64_t subscriptionId);
+
+    // Snapshot support; every table is captured
+    std::string getSnapshotName() const override { return "memory"; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
+
+    // Memory governor support; every table is accounted, but only tables
+    // marked evictable (e.g. ones mirrored in a database) are shrunk, oldest
+    // memories first
+    void setTableEvictable(const std::string& tableName, bool evictable = true);
+    std::string getConsumerName() const override { return "memory"; }
+    size_t getAccountedBytes() const override { return accountedBytes_.load(std::memory_order_relaxed); }
+    size_t shrinkMemory(size_t bytes) override;
+
 private:
-    // Internal storage - using maps for different table types
-    std::unordered_map<std::string, std::unordered_map<UUID, std::shared_ptr<Memory>>> memoryTables_;
+    // Internal storage - using maps for different table types. Memories are
+    // keyed by IdKey, so generated UUID ids hash and compare as two words
+    using MemoryTable = std::unordered_map<IdKey, std::shared_ptr<Memory>>;
+    std::unordered_map<std::string, MemoryTable> memoryTables_;
     
     // Thread safety
     mutable std::mutex memoryMutex_;
     bool threadSafetyEnabled_ = true;
+
+    std::unordered_set<std::string> evictableTables_;
+    std::atomic<size_t> accountedBytes_{0};     // Estimate over every table
+
+    // Content index for unique inserts, built in one pass over a table on
+    // its first unique insert and maintained by later writes. Candidates
+    // are compared with the stored memory, so stale entries left by
+    // memories edited in place are skipped rather than trusted
+    using DedupIndex = std::unordered_multimap<uint64_t, IdKey>;
+    std::unordered_map<std::string, DedupIndex> dedupIndexes_;
+
+    struct ChangeLog {
+        uint64_t lastSequence = 0;
+        std::deque<MemoryChange> changes;
+    };
+
+    struct LiveQuerySubscriber {
+        LiveQueryCallback callback;
+        std::atomic<bool> active{true};
+    };
+
+    struct LiveQueryState {
+        uint64_t id = 0;
+        LiveQuery query;
+        std::shared_ptr<LiveQuerySubscriber> subscriber;
+        uint64_t evaluatedFor = 0;              // Change that last evaluated the query
+    };
+
+    // Queries are filed by room, so a write only evaluates the queries on
+    // its memory's room, the queries without a room, and the queries whose
+    // results held the memory before the write
+    struct LiveQueryBucket {
+        std::unordered_map<UUID, std::vector<std::shared_ptr<LiveQueryState>>> byRoom;
+        std::vector<std::shared_ptr<LiveQueryState>> anyRoom;
+    };
+
+    struct LiveQueryDelivery {
+        std::shared_ptr<LiveQuerySubscriber> subscriber;
+        LiveQueryEvent event;
+    };
+
+    std::unordered_map<std::string, ChangeLog> changeLogs_;
+    size_t changeLogCapacity_ = 4096;
+    std::condition_variable changed_;
+    size_t changeWaiters_ = 0;
+
+    // Live queries by table; those over every table under allTablesLiveQueries_
+    std::unordered_map<std::string, LiveQueryBucket> liveQueries_;
+    LiveQueryBucket allTablesLiveQueries_;
+    std::unordered_map<IdKey, std::vector<LiveQueryState*>> liveQueryResults_;  // Memory id to the queries it matches
+    uint64_t nextLiveQueryId_ = 1;
+    uint64_t liveQueryEvaluations_ = 0;
+
+    std::mutex deliveryMutex_;                  // Taken inside memoryMutex_, never around it
+    std::deque<LiveQueryDelivery> deliveries_;
+    bool delivering_ = false;
     
     // Helper methods
     bool matchesSearchCriteria(const Memory& memory, const MemorySearchParams& params);
     double calculateEmbeddingSimilarity(const EmbeddingVector& embedding1, const EmbeddingVector& embedding2);
     std::vector<std::shared_ptr<Memory>> getAllMemoriesFromTable(const std::string& tableName);
+
+    // Dedup index helpers; expect memoryMutex_ to be held
+    DedupIndex& dedupIndexLocked(const std::string& tableName);
+    void indexContentLocked(const std::string& tableName, const Memory& memory);
+    void unindexContentLocked(const std::string& tableName, const Memory& memory);
+
+    // Change feed helpers; the Locked ones expect memoryMutex_ to be held
+    void recordChangeLocked(MemoryChangeKind kind, const std::string& tableName, const std::shared_ptr<Memory>& memory);
+    void recordChangeLocked(MemoryChangeKind kind, ChangeLog& log, const std::string& tableName,
+                            const std::shared_ptr<Memory>& memory, bool logged = true);
+    void evaluateLiveQueriesLocked(const MemoryChange& change, std::vector<LiveQueryDelivery>& matched);
+    bool matchesLiveQuery(const LiveQuery& query, const Memory& memory, double& similarity);
+    void addLiveQueryResultsLocked(LiveQueryState& state, std::vector<std::shared_ptr<Memory>>* matching);
+    void resetChangeFeedLocked();
+    void deliverLiveQueryEvents();
     
     // Thread-safe wrapper for operations
     template<typename F>
@@ -95,6 +284,9 @@ private:
 // Global memory manager instance
 AgentMemoryManager& getGlobalMemoryManager();
 
+// Re-creates recorded memory writes in manager
+void addMemoryReplay(TraceReplayer& replayer, AgentMemoryManager& manager);
+
 // Convenience functions for common operations
 namespace memory {
     UUID store(std::shared_ptr<Memory> memory, const std::string& tableName = "memories");
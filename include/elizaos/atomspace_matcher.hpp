@@ -0,0 +1,113 @@
+#pragma once
+
+#include "elizaos/core.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Subgraph matcher over an indexed AtomSpace
+ *
+ * Patterns are read as conjunctive queries. A pattern whose type is a label
+ * matches a node with that label when it has one term, or an edge with that
+ * label whose arity is its number of terms, terms binding positionally to
+ * the edge's node ids. Terms starting with '?' are variables; other terms
+ * are node ids that must appear at that position. Subpatterns are joined
+ * with their parent, sharing variables by name, so bindings made anywhere
+ * in the tree constrain every other clause. The types "AND" (or empty),
+ * "OR" and "NOT" combine subpatterns without matching an atom themselves;
+ * variables bound only under a NOT are not reported.
+ *
+ * A constraint is a list of comparisons joined by "&&". Operands are
+ * variables (the bound node's id), "?X.label", "?X.id", "?X.<attribute>"
+ * or literals, and operators are ==, != and the numeric <, <=, > and >=.
+ * Comparisons run as soon as their variables are bound; one that cannot be
+ * parsed matches nothing.
+ *
+ * The atom space is interned into dense node indices with per-label node
+ * lists, per-label edge groups and sorted (node, edge) postings for every
+ * edge position. Clauses of a conjunction run in order of estimated
+ * selectivity, cheapest given the variables already bound first. Each
+ * variable used by several conjunctive clauses is first restricted to the
+ * intersection of their candidate sets as a bitset, so joins never visit
+ * atoms that one clause already rules out. Groups of clauses sharing no
+ * variables, and the branches of a top-level OR, are solved concurrently
+ * on the global executor once they are large enough and then combined.
+ */
+class AtomSpacePatternMatcher : public PatternMatcher {
+public:
+    struct Config {
+        size_t maxMatches = 10000;          // findAllMatches stops after this many
+        bool parallel = true;
+        size_t parallelThreshold = 16384;   // Estimated rows before branches run concurrently
+    };
+
+    AtomSpacePatternMatcher();
+    explicit AtomSpacePatternMatcher(const Config& config);
+    ~AtomSpacePatternMatcher() override;
+
+    std::string getName() const override { return "AtomSpacePatternMatcher"; }
+
+    /**
+     * Fraction of pattern tokens matching input tokens at the best offset;
+     * '?' tokens match any token
+     */
+    double matchPattern(const std::string& input, const std::string& pattern) override;
+
+    /**
+     * Words of input that are node or edge labels in the indexed atom space
+     */
+    std::vector<std::string> extractPatterns(const std::string& input) override;
+
+    /**
+     * First match, or a non-match. The atom space is reindexed only when
+     * nodes and edges differ from the indexed ones
+     */
+    PatternMatch matchAtomSpacePattern(const AtomSpacePattern& pattern,
+                                       const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                       const std::vector<std::shared_ptr<HypergraphEdge>>& edges) override;
+    std::vector<PatternMatch> findAllMatches(const AtomSpacePattern& pattern,
+                                             const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                             const std::vector<std::shared_ptr<HypergraphEdge>>& edges) override;
+
+    /**
+     * Distinct nodes bound to the pattern's other variables when its first
+     * variable is bound to startNode, over the indexed atom space
+     */
+    std::vector<std::shared_ptr<HypergraphNode>> traverseAtomSpace(const AtomSpacePattern& pattern,
+                                                                   const std::shared_ptr<HypergraphNode>& startNode) override;
+
+    /**
+     * Indexes an atom space for query(); edges may name nodes that are not
+     * in nodes, which then bind by id only
+     */
+    void setAtomSpace(const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                      const std::vector<std::shared_ptr<HypergraphEdge>>& edges);
+
+    /**
+     * Matches over the indexed atom space, at most maxMatches of them
+     * (Config::maxMatches when zero)
+     */
+    std::vector<PatternMatch> query(const AtomSpacePattern& pattern, size_t maxMatches = 0) const;
+
+    size_t getNodeCount() const;
+    size_t getEdgeCount() const;
+
+private:
+    class Index;
+
+    std::shared_ptr<const Index> indexFor(const std::vector<std::shared_ptr<HypergraphNode>>& nodes,
+                                          const std::vector<std::shared_ptr<HypergraphEdge>>& edges);
+    std::shared_ptr<const Index> currentIndex() const;
+
+    const Config config_;
+    mutable std::mutex mutex_;
+    std::shared_ptr<const Index> index_;
+};
+
+} // namespace elizaos
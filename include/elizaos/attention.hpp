@@ -127,6 +127,11 @@ public:
     void normalizeActivations();
     void clear();
     
+    // Snapshot encoding of nodes, activations and edges; reading returns a
+    // commit that swaps the decoded network in
+    void writeSnapshot(SnapshotWriter& writer) const;
+    SnapshotCommit readSnapshot(SnapshotReader& reader);
+    
 private:
     struct Node {
         UUID id;
@@ -161,10 +166,10 @@ struct AttentionPriorityItem {
 /**
  * Main Attention Allocator class implementing ECAN-inspired attention management
  */
-class AttentionAllocator {
+class AttentionAllocator : public Snapshottable, public MemoryConsumer {
 public:
     AttentionAllocator(double initialBudget = 100.0);
-    ~AttentionAllocator() = default;
+    ~AttentionAllocator();
     
     // Core attention management
     void updateAttentionValue(const UUID& elementId, const AttentionValue& value);
@@ -210,6 +215,17 @@ public:
     void setBudgetSize(double newBudget);
     void setSpreadingParameters(double spreadingRate, double threshold);
     
+    // Snapshot support covering values, budget, spreading network and novelty model
+    std::string getSnapshotName() const override { return "attention"; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
+
+    // Memory governor support; shrinking forgets the rarest novelty features
+    std::string getConsumerName() const override { return "attention"; }
+    size_t getAccountedBytes() const override { return noveltyBytes_.load(std::memory_order_relaxed); }
+    size_t shrinkMemory(size_t bytes) override;
+    
 private:
     // Core data structures
     std::unordered_map<UUID, AttentionValue> attentionValues_;
@@ -218,7 +234,8 @@ private:
     
     // Novelty detection
     std::unordered_map<std::string, double> noveltyModel_; // Simple frequency-based model
-    std::mutex noveltyMutex_;
+    mutable std::mutex noveltyMutex_;
+    std::atomic<size_t> noveltyBytes_{0};
     
     // Configuration parameters
     double urgencyDecayRate_ = 0.95;
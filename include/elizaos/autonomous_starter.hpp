@@ -3,9 +3,13 @@
 #include "elizaos/core.hpp"
 #include "elizaos/agentloop.hpp"
 #include "elizaos/agentshell.hpp"
+#include "elizaos/process_runner.hpp"
 #include <memory>
 #include <chrono>
 #include <atomic>
+#include <future>
+#include <mutex>
+#include <optional>
 
 namespace elizaos {
 
@@ -62,6 +66,26 @@ public:
      */
     ShellCommandResult executeShellCommand(const std::string& command);
     
+    /**
+     * Start a shell command without waiting for it
+     * @param command The shell command to execute
+     * @return Result once the command exits, times out or is rejected; it is
+     *         recorded in memory before the future becomes ready
+     */
+    std::future<ShellCommandResult> executeShellCommandAsync(const std::string& command);
+    
+    /**
+     * Limit how long a command may run before its process group is killed
+     * @param timeout Zero disables the limit
+     */
+    void setCommandTimeout(std::chrono::milliseconds timeout) { commandTimeout_ = timeout; }
+    
+    /**
+     * Limit captured output per stream; the end of longer output is kept
+     * @param bytes Maximum bytes of stdout and of stderr
+     */
+    void setMaxCommandOutput(size_t bytes) { maxCommandOutput_ = bytes; }
+    
     /**
      * Enable or disable shell access for security
      * @param enabled Whether shell commands should be allowed
@@ -71,7 +95,7 @@ public:
     /**
      * Get current working directory
      */
-    const std::string& getCurrentWorkingDirectory() const { return currentWorkingDirectory_; }
+    std::string getCurrentWorkingDirectory() const;
     
     // === Autonomous Loop Control ===
     
@@ -147,6 +171,21 @@ private:
      */
     std::shared_ptr<void> actionStep(std::shared_ptr<void> input);
     
+    // === Command Execution Helpers ===
+    
+    /**
+     * Result for a command that must not run, if any
+     */
+    std::optional<ShellCommandResult> rejectCommand(const std::string& command);
+    
+    /**
+     * Start a command from the loop without waiting for it; skipped while
+     * earlier loop commands fill the loop's share of the runner
+     */
+    void submitLoopCommand(const std::string& command);
+    
+    std::future<ShellCommandResult> startCommand(const std::string& command, bool fromLoop);
+    
     // === Internal Task Worker ===
     
     /**
@@ -182,8 +221,17 @@ private:
     std::unique_ptr<TaskManager> taskManager_;             // Task orchestration
     std::shared_ptr<ShellCommandWorker> shellWorker_;     // Shell command worker
     
+    // Command execution
+    std::atomic<std::chrono::milliseconds> commandTimeout_{std::chrono::seconds(30)};
+    std::atomic<size_t> maxCommandOutput_{1 << 20};        // Per stream
+    std::atomic<int> loopCommandsInFlight_{0};             // Loop commands not yet finished
+    
     // Environment tracking
+    mutable std::mutex cwdMutex_;
     std::string currentWorkingDirectory_;                  // Current working directory
+    
+    // Last, so running commands are stopped before the state they report to
+    std::unique_ptr<ProcessRunner> processRunner_;         // Spawns and collects commands
 };
 
 // === Convenience Functions ===
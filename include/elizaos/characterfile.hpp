@@ -7,16 +7,16 @@
 #include <optional>
 #include <fstream>
 #include <sstream>
+#include <atomic>
+#include <filesystem>
+#include <mutex>
 #include "core.hpp"
+#include "json.hpp"
 #include "characters.hpp"
 #include "agentlogger.hpp"
-#include "plugin_specification.hpp"
 
 namespace elizaos {
 
-// JsonValue type definition (compatible with other modules)
-using JsonValue = std::unordered_map<std::string, std::any>;
-
 /**
  * Character file format specification
  */
@@ -39,6 +39,16 @@ struct ValidationResult {
     std::string getSummary() const;
 };
 
+/**
+ * Header fields of a character file, read without building a profile
+ */
+struct CharacterFileMetadata {
+    std::string name;
+    std::string description;
+    std::string author;
+    std::string version = "1.0.0";
+};
+
 /**
  * Character file loader and parser
  */
@@ -105,7 +115,7 @@ public:
     /**
      * Get character metadata without full loading
      */
-    std::optional<PluginMetadata> getCharacterMetadata(const std::string& filename);
+    std::optional<CharacterFileMetadata> getCharacterMetadata(const std::string& filename);
     
     /**
      * Batch load characters from directory
@@ -177,6 +187,21 @@ private:
     std::vector<std::string> getStringArray(const JsonValue& json, const std::string& key);
 };
 
+/**
+ * Sync state of one character file: what was last read from or written to
+ * it, and the character revision it matches
+ */
+struct CharacterFileRecord {
+    std::string path;
+    std::string characterId;
+    uint64_t contentHash = 0;
+    uintmax_t size = 0;
+    std::filesystem::file_time_type modified;
+    uint64_t revision = 0;          // CharacterManager revision when last synced
+};
+
+class FileWatcher;
+
 /**
  * Character file manager for bulk operations
  */
@@ -202,11 +227,23 @@ public:
     
     /**
      * Sync character files with character manager
+     *
+     * A per-directory manifest records each file's size, modification time,
+     * content hash and the character revision it holds. Files whose size and
+     * time are unchanged are not read, files whose content hash is unchanged
+     * are not parsed, and only characters whose revision moved since their
+     * file was synced are written back. A synced file that disappears
+     * unregisters its character unless the character changed since.
      */
     bool syncWithManager(const std::string& directory);
     
     /**
      * Watch directory for character file changes
+     *
+     * With autoImport the directory is synced first, then modified files are
+     * re-parsed on the watcher thread and swapped into the character manager
+     * whole; conversations holding a live profile keep the previous one.
+     * Files that fail to parse leave the current profile in place.
      */
     bool watchDirectory(const std::string& directory, bool autoImport = true);
     
@@ -241,17 +278,36 @@ private:
     std::shared_ptr<AgentLogger> logger_;
     
     bool isWatching_ = false;
+    bool autoImport_ = true;
     std::string watchedDirectory_;
+    std::unique_ptr<FileWatcher> watcher_;
+    
+    // Sync manifests by canonical directory; guarded by syncMutex_
+    struct SyncManifest {
+        std::unordered_map<std::string, CharacterFileRecord> files;      // By path
+        std::unordered_map<std::string, std::string> paths;              // Character id to path
+    };
+    std::unordered_map<std::string, SyncManifest> manifests_;
+    mutable std::mutex syncMutex_;
     
     // Operation statistics
-    size_t importedCount_ = 0;
-    size_t exportedCount_ = 0;
-    size_t errorCount_ = 0;
+    std::atomic<size_t> importedCount_{0};
+    std::atomic<size_t> exportedCount_{0};
+    std::atomic<size_t> errorCount_{0};
+    std::atomic<size_t> parsedCount_{0};
+    std::atomic<size_t> skippedCount_{0};
+    std::atomic<size_t> reloadedCount_{0};
     
     // Helper methods
     std::vector<std::string> findCharacterFiles(const std::string& directory, bool recursive);
     bool isValidCharacterFile(const std::string& filename);
     std::string getCharacterIdFromFile(const std::string& filename);
+    
+    // Incremental sync helpers; callers hold syncMutex_
+    bool importChangedFile(SyncManifest& manifest, const std::string& path, bool trustFileTimes);
+    bool forgetRemovedFile(SyncManifest& manifest, const std::string& path);
+    int exportChangedCharacters(SyncManifest& manifest, const std::string& directory);
+    void onWatchedFilesChanged(const std::vector<std::filesystem::path>& paths);
 };
 
 /**
@@ -3,7 +3,7 @@
 #include "elizaos/core.hpp"
 #include "elizaos/agentmemory.hpp"
 #include "elizaos/agentlogger.hpp"
-#include "elizaos/agentaction.hpp"
+#include "elizaos/json.hpp"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -228,6 +228,12 @@ public:
     std::vector<CharacterProfile> getAllCharacters() const;
     bool updateCharacter(const std::string& characterId, const CharacterProfile& character);
     
+    // Live profiles: registering or updating a character swaps in a new
+    // immutable profile, so holders of the previous one keep a complete copy
+    std::shared_ptr<const CharacterProfile> getLiveCharacter(const std::string& characterId) const;
+    uint64_t getRevision(const std::string& characterId) const;     // 0 when not registered
+    std::vector<std::pair<std::string, uint64_t>> getRevisions() const;
+    
     // Search and discovery
     std::vector<CharacterProfile> searchCharacters(const std::string& query) const;
     std::vector<CharacterProfile> findCharactersByTrait(const std::string& traitName, 
@@ -260,8 +266,14 @@ public:
     size_t getCharacterCount() const;
     
 private:
-    std::unordered_map<std::string, CharacterProfile> characters_;
+    struct LiveCharacter {
+        std::shared_ptr<const CharacterProfile> profile;
+        uint64_t revision = 0;
+    };
+    
+    std::unordered_map<std::string, LiveCharacter> characters_;
     std::unordered_map<std::string, CharacterTemplate> templates_;
+    uint64_t lastRevision_ = 0;
     std::shared_ptr<AgentMemoryManager> memory_;
     std::shared_ptr<AgentLogger> logger_;
     mutable std::mutex charactersMutex_;
@@ -270,6 +282,7 @@ private:
     std::optional<CharacterProfile> loadCharacterFromMemory(const std::string& id);
     std::vector<CharacterProfile> getAllCharactersFromMemory() const;
     std::string generateCharacterId();
+    void storeCharacter(CharacterProfile character);
 };
 
 // Global character manager instance
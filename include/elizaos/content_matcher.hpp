@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Combined multi-pattern matcher
+ *
+ * Compiles any number of regular expressions and literals into automata that
+ * are evaluated together in a single left-to-right pass over the input:
+ *
+ * - Regular expressions in the supported ECMAScript subset (literals, classes,
+ *   '.', groups, alternation, greedy/lazy quantifiers including {n,m}, ^, $,
+ *   \b and \B) are merged into eagerly built DFAs. Patterns are grouped so no
+ *   DFA exceeds the configured state budget.
+ * - The repeated-character idiom "(.)\1{n,}" is recognised and handled by a
+ *   run-length counter instead of a backreference.
+ * - Literals are matched with an Aho-Corasick automaton; ASCII case folding is
+ *   built into its transition table, so the input is never lowercased.
+ *
+ * A built matcher is immutable and may be shared between threads.
+ */
+class MultiPatternMatcher {
+public:
+    struct LiteralHit {
+        uint32_t id;
+        size_t start;
+        size_t length;
+    };
+
+    struct ScanResult {
+        std::vector<uint32_t> regexMatches;     // Each matching regex id once, in order of discovery
+        std::vector<LiteralHit> literalHits;    // Every literal occurrence, ordered by end offset
+        size_t longestRun = 0;                  // Longest run of one repeated byte (newlines excluded)
+
+        void clear();
+    };
+
+    MultiPatternMatcher();
+    ~MultiPatternMatcher();
+    MultiPatternMatcher(MultiPatternMatcher&&) noexcept;
+    MultiPatternMatcher& operator=(MultiPatternMatcher&&) noexcept;
+
+    /**
+     * Returns false when the pattern uses syntax outside the supported subset
+     * (backreferences, lookaround, ...); the caller must evaluate it separately.
+     * caseInsensitive matches ASCII letters in either case, like std::regex::icase.
+     */
+    bool addRegex(const std::string& pattern, uint32_t id, bool caseInsensitive = false);
+    static bool isSupportedRegex(const std::string& pattern, bool caseInsensitive = false);
+
+    /**
+     * Adds an ASCII case-insensitive literal
+     */
+    void addLiteral(const std::string& literal, uint32_t id);
+
+    /**
+     * Compiles everything added so far. Must be called before scanning.
+     */
+    void build(size_t maxDfaStates = 16384);
+
+    void scan(std::string_view text, ScanResult& result) const;
+    ScanResult scan(std::string_view text) const;
+
+    // Introspection
+    size_t getRegexCount() const;
+    size_t getLiteralCount() const;
+    size_t getDfaCount() const;
+    size_t getDfaStateCount() const;
+    size_t getFallbackCount() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace elizaos
@@ -11,6 +11,12 @@
 #include <optional>
 #include <variant>
 #include <mutex>
+#include "elizaos/executor.hpp"
+#include "elizaos/uuid.hpp"
+#include "elizaos/persistent.hpp"
+#include "elizaos/pool.hpp"
+#include "elizaos/replay.hpp"
+#include "elizaos/snapshot.hpp"
 
 namespace elizaos {
 
@@ -23,8 +29,11 @@ class Task;
 class TaskManager;
 class HypergraphNode;
 class HypergraphEdge;
+class AtomSpacePatternMatcher;
 
 // Basic types
+// Ids stay strings at API boundaries, since callers use free-form ids as
+// well as generated ones; elizaos::Uuid is the compact form of generated ids
 using UUID = std::string;
 using Timestamp = std::chrono::system_clock::time_point;
 using EmbeddingVector = std::vector<float>;
@@ -163,6 +172,7 @@ public:
     const UUID& getRoomId() const { return roomId_; }
     void setRoomId(const UUID& roomId) { roomId_ = roomId; }
     Timestamp getCreatedAt() const { return createdAt_; }
+    void setCreatedAt(const Timestamp& createdAt) { createdAt_ = createdAt; }
     
     // Enhanced features
     const std::optional<EmbeddingVector>& getEmbedding() const { return embedding_; }
@@ -202,6 +212,14 @@ private:
     std::vector<UUID> hypergraphEdges_;
 };
 
+/**
+ * Creates a Memory and its shared_ptr control block in one slab-pooled block
+ */
+template <typename... Args>
+std::shared_ptr<Memory> makeMemory(Args&&... args) {
+    return std::allocate_shared<Memory>(PoolAllocator<Memory>(), std::forward<Args>(args)...);
+}
+
 /**
  * Task orchestration primitives for agent workflow management
  */
@@ -226,6 +244,8 @@ public:
     const std::string& getDescription() const { return description_; }
     const UUID& getRoomId() const { return roomId_; }
     const UUID& getWorldId() const { return worldId_; }
+    void setRoomId(const UUID& roomId) { roomId_ = roomId; }
+    void setWorldId(const UUID& worldId) { worldId_ = worldId; }
     
     TaskStatus getStatus() const { return status_; }
     void setStatus(TaskStatus status) { status_ = status; }
@@ -238,7 +258,9 @@ public:
     
     Timestamp getCreatedAt() const { return createdAt_; }
     Timestamp getUpdatedAt() const { return updatedAt_; }
-    void updateTimestamp() { updatedAt_ = std::chrono::system_clock::now(); }
+    void updateTimestamp() { updatedAt_ = VirtualClock::now(); }
+    void setCreatedAt(const Timestamp& createdAt) { createdAt_ = createdAt; }
+    void setUpdatedAt(const Timestamp& updatedAt) { updatedAt_ = updatedAt; }
     
     // Task scheduling properties
     std::optional<Timestamp> getScheduledTime() const { return scheduledTime_; }
@@ -276,7 +298,7 @@ public:
 /**
  * Task orchestration manager
  */
-class TaskManager {
+class TaskManager : public Snapshottable {
 public:
     TaskManager();
     ~TaskManager();
@@ -284,6 +306,7 @@ public:
     // Task management
     UUID createTask(const std::string& name, const std::string& description, 
                    const UUID& roomId = "", const UUID& worldId = "");
+    bool addTask(std::shared_ptr<Task> task);   // false when the id is taken
     bool scheduleTask(const UUID& taskId, const Timestamp& scheduledTime);
     bool cancelTask(const UUID& taskId);
     std::shared_ptr<Task> getTask(const UUID& taskId);
@@ -302,10 +325,15 @@ public:
     bool isRunning() const { return running_; }
     
     // Configuration
-    void setTickInterval(std::chrono::milliseconds interval) { tickInterval_ = interval; }
+    void setTickInterval(std::chrono::milliseconds interval);
+    
+    // Snapshot support; workers are code and are not captured
+    std::string getSnapshotName() const override { return "tasks"; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
     
 private:
-    void executionLoop();
     void processPendingTasks();
     bool executeTask(std::shared_ptr<Task> task);
     
@@ -314,40 +342,71 @@ private:
     
     std::atomic<bool> running_{false};
     std::atomic<bool> paused_{false};
-    std::thread executionThread_;
     std::chrono::milliseconds tickInterval_{1000}; // 1 second default
     
     mutable std::mutex tasksMutex_;
     mutable std::mutex workersMutex_;
+
+    PeriodicTask ticker_;   // Ticks on the blocking pool; workers may block
 };
 /**
  * State represents the complete context for agent decision making
  * Based on the State interface from the TypeScript implementation
  */
+/**
+ * One immutable version of a State
+ *
+ * The containers share structure with the versions before and after, so
+ * holding a version is cheap and it never changes underneath its reader.
+ */
+struct StateVersion {
+    static constexpr size_t MAX_RECENT_MESSAGES = 32;
+
+    AgentConfig config;
+    PersistentVector<Actor> actors;
+    PersistentVector<Goal> goals;
+    PersistentRing<std::shared_ptr<Memory>> recentMessages{MAX_RECENT_MESSAGES};
+    uint64_t version = 0;           // Incremented by every published change
+};
+
 class State {
 public:
     State(const AgentConfig& config);
+    State(const State& other);
+    State& operator=(const State& other);
+    
+    /**
+     * Current version. Reading it takes no lock and later changes to the
+     * State publish new versions instead of modifying this one.
+     */
+    std::shared_ptr<const StateVersion> snapshot() const { return std::atomic_load(&current_); }
+    uint64_t getVersion() const { return snapshot()->version; }
     
     // Agent identity
-    const UUID& getAgentId() const { return config_.agentId; }
-    const std::string& getAgentName() const { return config_.agentName; }
-    const std::string& getBio() const { return config_.bio; }
-    const std::string& getLore() const { return config_.lore; }
+    UUID getAgentId() const { return snapshot()->config.agentId; }
+    std::string getAgentName() const { return snapshot()->config.agentName; }
+    std::string getBio() const { return snapshot()->config.bio; }
+    std::string getLore() const { return snapshot()->config.lore; }
+    AgentConfig getConfig() const { return snapshot()->config; }
     
     // Context management
     void addActor(const Actor& actor);
     void addGoal(const Goal& goal);
     void addRecentMessage(std::shared_ptr<Memory> memory);
     
-    const std::vector<Actor>& getActors() const { return actors_; }
-    const std::vector<Goal>& getGoals() const { return goals_; }
-    const std::vector<std::shared_ptr<Memory>>& getRecentMessages() const { return recentMessages_; }
+    PersistentVector<Actor> getActors() const { return snapshot()->actors; }
+    PersistentVector<Goal> getGoals() const { return snapshot()->goals; }
+    PersistentRing<std::shared_ptr<Memory>> getRecentMessages() const { return snapshot()->recentMessages; }
+    
+    /**
+     * Applies mutate to a copy of the current version and publishes the
+     * result. Writers are serialized; readers are never blocked.
+     */
+    void update(const std::function<void(StateVersion&)>& mutate);
     
 private:
-    AgentConfig config_;
-    std::vector<Actor> actors_;
-    std::vector<Goal> goals_;
-    std::vector<std::shared_ptr<Memory>> recentMessages_;
+    std::shared_ptr<const StateVersion> current_;   // Accessed with std::atomic_load/atomic_store
+    std::mutex writeMutex_;
 };
 
 /**
@@ -422,6 +481,18 @@ public:
     virtual EmbeddingVector generateEmbedding(const std::string& input) = 0;
     virtual double computeSimilarity(const EmbeddingVector& a, const EmbeddingVector& b) = 0;
     virtual std::vector<std::string> generateResponse(const EmbeddingVector& context) = 0;
+    
+    // Processors that embed several inputs in one call (one model invocation)
+    // override both; the default embeds inputs one at a time
+    virtual bool supportsBatching() const { return false; }
+    virtual std::vector<EmbeddingVector> generateEmbeddings(const std::vector<std::string>& inputs) {
+        std::vector<EmbeddingVector> embeddings;
+        embeddings.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            embeddings.push_back(generateEmbedding(input));
+        }
+        return embeddings;
+    }
 };
 
 // Variable binding for pattern matching
@@ -476,7 +547,7 @@ public:
 };
 
 // PLN-like inference engine for probabilistic reasoning
-class PLNInferenceEngine {
+class PLNInferenceEngine : public Snapshottable {
 public:
     PLNInferenceEngine();
     ~PLNInferenceEngine();
@@ -500,10 +571,21 @@ public:
                      const std::vector<std::shared_ptr<HypergraphEdge>>& edges);
     std::vector<std::shared_ptr<HypergraphNode>> queryAtomSpace(const std::string& query);
     
+    // Structural queries over the AtomSpace, indexed on first use after it changes
+    std::vector<PatternMatch> matchAtomSpace(const AtomSpacePattern& pattern, size_t maxMatches = 0);
+    
+    // Snapshot support for the rule set and AtomSpace
+    std::string getSnapshotName() const override { return "pln"; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
+    
 private:
     std::vector<InferenceRule> rules_;
     std::vector<std::shared_ptr<HypergraphNode>> atomSpaceNodes_;
     std::vector<std::shared_ptr<HypergraphEdge>> atomSpaceEdges_;
+    std::shared_ptr<AtomSpacePatternMatcher> atomSpaceMatcher_;
+    bool atomSpaceIndexed_ = false;
     
     // Internal inference helpers
     bool unify(const std::string& pattern, const std::string& target, std::vector<VariableBinding>& bindings);
@@ -604,6 +686,6 @@ public:
 };
 
 // Utility functions
-std::string generateUUID();
+std::string generateUUID();      // Random (v4) UUID in canonical form
 
 } // namespace elizaos
\ No newline at end of file
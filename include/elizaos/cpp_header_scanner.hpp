@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Kinds of declarations recognised by the header scanner
+ */
+enum class DeclarationKind {
+    CLASS,
+    STRUCT,
+    UNION,
+    ENUM,
+    FUNCTION,
+    VARIABLE,
+    TYPE_ALIAS
+};
+
+std::string declarationKindToString(DeclarationKind kind);
+
+/**
+ * Single declaration found in a header
+ */
+struct ScannedDeclaration {
+    DeclarationKind kind = DeclarationKind::FUNCTION;
+    std::string name;
+    std::string scope;          // Enclosing namespaces and classes, joined with "::"
+    std::string parent;         // Enclosing class or struct, empty at namespace level
+    std::string signature;      // Declaration text up to the body or terminating ';'
+    std::string doc_comment;    // Attached /** */, ///, //! or trailing ///< comment
+    std::string access;         // "public", "protected" or "private" for class members
+    size_t line = 0;
+
+    std::string qualifiedName() const { return scope.empty() ? name : scope + "::" + name; }
+};
+
+/**
+ * Result of scanning one header
+ */
+struct ScannedHeader {
+    std::filesystem::path path;
+    uint64_t content_hash = 0;
+    std::vector<ScannedDeclaration> declarations;
+};
+
+/**
+ * Lightweight C++ declaration scanner
+ *
+ * Lexes each header once (comments, string, character and raw string literals
+ * and preprocessor lines are skipped correctly) and records every class,
+ * struct, union, enum, function, type alias and class data member together
+ * with its doc comment. This is not a full C++ parser: function bodies and
+ * initializers are skipped by brace matching rather than parsed.
+ *
+ * Directory scans run on a pool of worker threads and results are cached by
+ * content hash, so re-running over an unchanged tree only stats the files.
+ */
+class CppHeaderScanner {
+public:
+    explicit CppHeaderScanner(size_t thread_count = 0);
+    ~CppHeaderScanner();
+
+    /**
+     * Scan in-memory source text. Does not touch the cache.
+     */
+    static ScannedHeader scanSource(const std::string& source,
+                                    const std::filesystem::path& path = {});
+
+    /**
+     * Scan a single file, using the cache when its content is unchanged
+     */
+    std::shared_ptr<const ScannedHeader> scanFile(const std::filesystem::path& path) const;
+
+    /**
+     * Scan every matching file below a directory in parallel.
+     * Results are sorted by path for deterministic output.
+     */
+    std::vector<std::shared_ptr<const ScannedHeader>> scanDirectory(
+        const std::filesystem::path& directory,
+        const std::vector<std::string>& extensions = {".hpp", ".h", ".hh", ".hxx"}) const;
+
+    static uint64_t hashContent(const std::string& content);
+
+    // Cache statistics
+    size_t getCacheHits() const;
+    size_t getCacheMisses() const;
+    size_t getCacheSize() const;
+    void clearCache();
+
+private:
+    struct CacheEntry {
+        std::filesystem::file_time_type mtime;
+        uintmax_t size = 0;
+        std::shared_ptr<const ScannedHeader> header;
+    };
+
+    size_t thread_count_;
+    mutable std::mutex cache_mutex_;
+    mutable std::unordered_map<std::string, CacheEntry> cache_;
+    mutable size_t cache_hits_ = 0;
+    mutable size_t cache_misses_ = 0;
+};
+
+} // namespace elizaos
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "elizaos/core.hpp"
+#include "elizaos/executor.hpp"
 #include <string>
 #include <vector>
 #include <memory>
@@ -305,6 +306,9 @@ private:
     // Monitoring implementation
     void monitoringLoop();
     void processNewMessage(const DiscordMessage& message);
+
+    // Channel and guild summaries in progress
+    TaskScope tasks_;
 };
 
 // Global summarizer instance
@@ -7,6 +7,8 @@
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
+#include <list>
+#include <deque>
 #include <chrono>
 #include <functional>
 #include <regex>
@@ -33,15 +35,32 @@ enum class FilterAction {
 struct ContentFilter {
     std::string name;
     std::string description;
-    std::regex pattern;
     FilterAction action;
     int severity;               // 1-10 scale
     bool enabled;
     std::string reason;
     
     ContentFilter() : action(FilterAction::NONE), severity(1), enabled(true) {}
-    ContentFilter(const std::string& n, const std::string& patternStr, FilterAction a, int sev = 1)
-        : name(n), pattern(patternStr), action(a), severity(sev), enabled(true) {}
+    ContentFilter(const std::string& n, const std::string& patternStr, FilterAction a, int sev = 1,
+                  std::regex::flag_type flags = std::regex::ECMAScript)
+        : name(n), action(a), severity(sev), enabled(true) {
+        setPattern(patternStr, flags);
+    }
+    
+    // The regex is only set together with its source, which the scanner compiles into its combined matcher
+    void setPattern(const std::string& patternStr, std::regex::flag_type flags = std::regex::ECMAScript) {
+        pattern_.assign(patternStr, flags);
+        patternSource_ = patternStr;
+        patternFlags_ = flags;
+    }
+    const std::regex& getPattern() const { return pattern_; }
+    const std::string& getPatternSource() const { return patternSource_; }
+    std::regex::flag_type getPatternFlags() const { return patternFlags_; }
+    
+private:
+    std::regex pattern_;
+    std::string patternSource_;
+    std::regex::flag_type patternFlags_ = std::regex::ECMAScript;
 };
 
 // Moderation action record
@@ -95,6 +114,120 @@ struct CleanupConfig {
                       maxDuplicateCount(3) {}
 };
 
+// Spam detection thresholds
+struct SpamDetectionConfig {
+    // Per-message content
+    size_t maxRepeatedRun;              // Longest run of one character before flagging
+    size_t maxLength;
+    size_t minEntropyLength;            // Entropy is only judged on messages at least this long
+    double minEntropy;                  // Bits per byte
+    
+    // Per-user sliding windows
+    std::chrono::seconds rateWindow;
+    int maxMessagesPerWindow;
+    std::chrono::seconds duplicateWindow;
+    int maxDuplicates;                  // Near-duplicates allowed in the window before flagging
+    int maxSimHashDistance;             // Hamming distance treated as near-duplicate
+    size_t minFingerprintLength;        // Shorter messages are not fingerprinted
+    std::chrono::seconds mentionWindow;
+    int maxMentionsPerWindow;
+    
+    // Bounded user state
+    size_t maxTrackedUsers;
+    size_t shardCount;
+    
+    SpamDetectionConfig() : maxRepeatedRun(5), maxLength(2000), minEntropyLength(32), minEntropy(2.0),
+                            rateWindow(10), maxMessagesPerWindow(5), duplicateWindow(60), maxDuplicates(2),
+                            maxSimHashDistance(3), minFingerprintLength(8), mentionWindow(30),
+                            maxMentionsPerWindow(10), maxTrackedUsers(10000), shardCount(16) {}
+};
+
+// Content features gathered in a single pass over a message
+struct MessageFeatures {
+    size_t length;
+    size_t longestRun;
+    double entropy;                     // Shannon entropy in bits per byte
+    size_t letters;
+    size_t uppercase;
+    size_t digits;
+    size_t whitespace;
+    size_t symbols;
+    size_t nonAscii;
+    size_t words;
+    uint64_t simHash;                   // 64-bit SimHash over lowercased words
+    
+    MessageFeatures() : length(0), longestRun(0), entropy(0.0), letters(0), uppercase(0), digits(0),
+                        whitespace(0), symbols(0), nonAscii(0), words(0), simHash(0) {}
+    
+    static MessageFeatures compute(const std::string& content);
+};
+
+/**
+ * Spam detector combining per-message features with per-user sliding windows
+ * (message rate, near-duplicate content and mention bursts). User state lives
+ * in a fixed number of shards, each a bounded LRU with its own lock, so
+ * messages from different shards can be evaluated in parallel.
+ */
+class SpamDetector {
+public:
+    explicit SpamDetector(const SpamDetectionConfig& config = SpamDetectionConfig());
+    
+    struct Verdict {
+        MessageFeatures features;
+        bool repetition;
+        bool tooLong;
+        bool lowEntropy;
+        bool rateExceeded;
+        bool duplicateContent;
+        bool mentionBurst;
+        int windowMessages;
+        int windowDuplicates;
+        int windowMentions;
+        
+        Verdict() : repetition(false), tooLong(false), lowEntropy(false), rateExceeded(false),
+                    duplicateContent(false), mentionBurst(false), windowMessages(0),
+                    windowDuplicates(0), windowMentions(0) {}
+        
+        bool contentSpam() const { return repetition || tooLong || lowEntropy; }
+        bool behaviourSpam() const { return rateExceeded || duplicateContent; }
+    };
+    
+    // Content-only checks; does not touch any user window
+    Verdict inspect(const std::string& content) const;
+    
+    // Records the message in the user's windows; an empty userId skips them
+    Verdict evaluate(const std::string& userId, const std::string& content,
+                     std::chrono::system_clock::time_point timestamp, int mentionCount);
+    
+    size_t shardFor(const std::string& userId) const;
+    size_t getShardCount() const { return shards_.size(); }
+    size_t getTrackedUserCount() const;
+    void forgetUser(const std::string& userId);
+    const SpamDetectionConfig& getConfig() const { return config_; }
+    
+    static int hammingDistance(uint64_t a, uint64_t b);
+    
+private:
+    struct UserWindow {
+        std::deque<std::chrono::system_clock::time_point> messages;
+        std::deque<std::pair<std::chrono::system_clock::time_point, uint64_t>> fingerprints;
+        std::deque<std::pair<std::chrono::system_clock::time_point, int>> mentions;
+        std::chrono::system_clock::time_point newest{};
+    };
+    
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::string> recency;     // Most recently active first
+        std::unordered_map<std::string, std::pair<UserWindow, std::list<std::string>::iterator>> users;
+    };
+    
+    SpamDetectionConfig config_;
+    size_t shardCapacity_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    
+    UserWindow& touchUser(Shard& shard, const std::string& userId);
+};
+
 // Content scanner for detecting violations
 class ContentScanner {
 public:
@@ -119,6 +252,7 @@ public:
     };
     
     ScanResult scanMessage(const DiscordMessage& message);
+    ScanResult scanEditedMessage(const DiscordMessage& message);  // Not re-counted in spam windows
     ScanResult scanContent(const std::string& content);
     std::vector<ScanResult> scanMessages(const std::vector<DiscordMessage>& messages);
     
@@ -128,13 +262,37 @@ public:
     void enablePhishingFilter(bool enable = true);
     void enableInviteFilter(bool enable = true);
     void enableMentionSpamFilter(bool enable = true, int maxMentions = 5);
+    void setSpamDetectionConfig(const SpamDetectionConfig& config);   // Resets user windows
+    SpamDetectionConfig getSpamDetectionConfig() const;
     
     // Custom pattern management
     void addProfanityWords(const std::vector<std::string>& words);
     void addAllowedDomains(const std::vector<std::string>& domains);
     void addBlockedDomains(const std::vector<std::string>& domains);
     
+    // Compiled matcher introspection; the generation changes on every rebuild
+    struct MatcherStats {
+        uint64_t generation = 0;
+        size_t compiledFilters = 0;     // Evaluated by the combined DFA
+        size_t fallbackFilters = 0;     // Evaluated with their own std::regex
+        size_t literals = 0;
+        size_t dfaCount = 0;
+        size_t dfaStates = 0;
+    };
+    MatcherStats getMatcherStats() const;
+    
 private:
+    // Immutable snapshot of every rule compiled into one matcher. Rule changes
+    // only mark it stale; the next scan rebuilds it once under scannerMutex_
+    // and publishes it atomically, so steady-state scans never take the mutex.
+    struct CompiledRules;
+    mutable std::shared_ptr<const CompiledRules> compiled_;
+    mutable std::atomic<bool> rulesDirty_;
+    mutable uint64_t generation_;
+    
+    // Replaced wholesale on reconfiguration and loaded atomically like compiled_
+    std::shared_ptr<SpamDetector> spamDetector_;
+    
     std::vector<ContentFilter> filters_;
     std::unordered_set<std::string> profanityWords_;
     std::unordered_set<std::string> allowedDomains_;
@@ -149,6 +307,10 @@ private:
     
     mutable std::mutex scannerMutex_;
     
+    std::shared_ptr<const CompiledRules> currentRules() const;
+    void rebuildMatcher() const;  // Requires scannerMutex_
+    ScanResult scan(const std::string& content, const DiscordMessage* message, bool recordSpam = true);
+    
     // Built-in detection methods
     bool detectProfanity(const std::string& content);
     bool detectSpam(const DiscordMessage& message);
@@ -156,7 +156,7 @@ private:
 };
 
 // Main Eliza conversational AI engine
-class ElizaCore {
+class ElizaCore : public MemoryConsumer {
 public:
     ElizaCore();
     ~ElizaCore();
@@ -208,6 +208,12 @@ public:
     void clearAllSessions();
     
     size_t getSessionCount() const;
+
+    // Memory governor support; shrinking saves the least recently active
+    // sessions to memory and drops them, processInput reloads them on return
+    std::string getConsumerName() const override { return "eliza.sessions"; }
+    size_t getAccountedBytes() const override;
+    size_t shrinkMemory(size_t bytes) override;
     
 private:
     std::unordered_map<std::string, ConversationContext> sessions_;
@@ -226,7 +232,9 @@ private:
     
     // Internal helper methods
     std::string generateSessionId();
-    void saveSessionToMemory(const ConversationContext& session);
+    // includeHistory stores every turn and the session data so the session
+    // can leave sessions_ and be restored whole
+    size_t saveSessionToMemory(const ConversationContext& session, bool includeHistory = false);
     std::optional<ConversationContext> loadSessionFromMemory(const std::string& sessionId);
     std::string preprocessInput(const std::string& input) const;
     std::string postprocessResponse(const std::string& response, 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "elizaos/core.hpp"
+#include "elizaos/hyperfy_replication.hpp"
 #include <string>
 #include <memory>
 #include <map>
@@ -8,6 +9,8 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <optional>
+#include <vector>
 
 namespace elizaos {
     namespace hyperfy {
@@ -52,6 +55,10 @@ namespace elizaos {
         
         /**
          * @brief Represents a connection to a Hyperfy 3D world
+         *
+         * Entities come in as delta snapshots applied to a ReplicationClient;
+         * the agent's own typed state goes out with each acknowledgement from
+         * buildUpdate. The key/value state is for loose annotations only.
          */
         class HyperfyWorld {
         private:
@@ -60,9 +67,11 @@ namespace elizaos {
             std::atomic<bool> connected_;
             mutable std::mutex worldMutex_;
             std::map<std::string, std::string> worldState_;
+            std::optional<EntityState> self_;
+            ReplicationClient replica_;
             
         public:
-            HyperfyWorld(const std::string& worldId, const std::string& wsUrl);
+            HyperfyWorld(const std::string& worldId, const std::string& wsUrl, const ReplicationConfig& replication = {});
             ~HyperfyWorld();
             
             bool connect(const std::string& authToken = "");
@@ -80,6 +89,14 @@ namespace elizaos {
             bool sendMessage(const std::string& message);
             bool moveToPosition(double x, double y, double z);
             bool performAction(const std::string& action, const std::string& parameters = "");
+            
+            // Replication
+            bool applySnapshot(std::string_view message);
+            std::string buildUpdate() const;
+            std::optional<EntityState> getSelfState() const;
+            void setSelfState(const EntityState& state);
+            std::vector<ReplicatedEntity> getVisibleEntities() const;
+            std::optional<EntityState> getEntity(EntityId id) const;
         };
         
         /**
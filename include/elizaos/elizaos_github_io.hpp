@@ -17,6 +17,7 @@ namespace elizaos {
 class MarkdownProcessor;
 class GitHubPagesDeployer;
 class DocumentationGenerator;
+class CppHeaderScanner;
 
 /**
  * GitHub Pages configuration
@@ -144,10 +145,13 @@ public:
         std::vector<std::string> methods;
         std::vector<std::string> properties;
         std::filesystem::path source_file;
+        std::string kind = "class";                    // class, struct, union, enum, or file for free functions
+        std::vector<std::string> method_descriptions;  // Parallel to methods, empty when undocumented
     };
     
     std::vector<CodeDocumentation> extractCodeDocumentation(const std::filesystem::path& source_dir) const;
     std::string generateClassDocumentation(const CodeDocumentation& code_doc) const;
+    std::shared_ptr<CppHeaderScanner> getHeaderScanner() const { return header_scanner_; }
     
     // Configuration
     const GitHubPagesConfig& getConfig() const { return config_; }
@@ -156,6 +160,7 @@ public:
 private:
     GitHubPagesConfig config_;
     std::shared_ptr<MarkdownProcessor> markdown_processor_;
+    std::shared_ptr<CppHeaderScanner> header_scanner_;  // Cached across runs for incremental API docs
     std::vector<DocumentationPage> pages_;
     std::unordered_map<std::string, std::string> templates_;
     NavigationItem navigation_root_;
@@ -2,8 +2,10 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 
 namespace elizaos {
@@ -87,11 +89,21 @@ void from_json(const nlohmann::json& j, Collection& c);
 
 /**
  * @brief Main class for managing Eliza's List projects and collections
+ *
+ * Projects are held in a catalogue with an id hash index, tag and author
+ * posting lists, star and recency views kept in order on every mutation, and
+ * case-folded search text. Facet queries walk only the matching projects and
+ * never sort. Results keep insertion order unless a view defines another one;
+ * ties in the star and recency views also fall back to insertion order.
  */
 class ElizasList {
 public:
     ElizasList() = default;
     ~ElizasList() = default;
+    ElizasList(const ElizasList& other);
+    ElizasList& operator=(const ElizasList& other);
+    ElizasList(ElizasList&&) noexcept = default;
+    ElizasList& operator=(ElizasList&&) noexcept = default;
 
     // Project management
     bool addProject(const Project& project);
@@ -114,6 +126,7 @@ public:
     std::vector<Project> searchProjects(const std::string& query) const;
     std::vector<Project> getProjectsSortedByStars() const;
     std::vector<Project> getRecentProjects(int limit = 10) const;
+    std::vector<Project> getTopProjectsByStars(size_t limit) const;
 
     // Data persistence
     bool loadFromJson(const std::string& filePath);
@@ -125,14 +138,53 @@ public:
     size_t getProjectCount() const;
     size_t getCollectionCount() const;
     std::vector<std::string> getAllTags() const;
+    std::vector<std::pair<std::string, size_t>> getTagCounts() const;
+    size_t countProjectsByTag(const std::string& tag) const;
+    size_t countProjectsByAuthor(const std::string& authorGithub) const;
 
 private:
-    std::vector<Project> projects_;
+    struct ProjectEntry {
+        Project project;
+        uint64_t sequence = 0;          // Insertion order, preserved across updates
+        std::string foldedName;
+        std::string foldedDescription;
+    };
+
+    // Posting lists are keyed by insertion sequence, so walking one yields
+    // projects in insertion order without sorting
+    using PostingList = std::map<uint64_t, const ProjectEntry*>;
+
+    struct ByStars {
+        bool operator()(const std::pair<int, uint64_t>& a, const std::pair<int, uint64_t>& b) const {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+
+    struct ByRecency {
+        bool operator()(const std::pair<std::string, uint64_t>& a,
+                        const std::pair<std::string, uint64_t>& b) const {
+            return a.first != b.first ? a.first > b.first : a.second < b.second;
+        }
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<ProjectEntry>> projectsById_;
+    PostingList projectsInOrder_;
+    std::map<std::string, PostingList> projectsByTag_;     // Ordered, so tag listings need no sort
+    std::unordered_map<std::string, PostingList> projectsByAuthor_;
+    std::map<std::pair<int, uint64_t>, const ProjectEntry*, ByStars> projectsByStars_;
+    std::map<std::pair<std::string, uint64_t>, const ProjectEntry*, ByRecency> projectsByRecency_;
+    uint64_t nextSequence_ = 0;
+
     std::vector<Collection> collections_;
 
+    // Catalogue maintenance
+    void indexProject(const ProjectEntry& entry);
+    void unindexProject(const ProjectEntry& entry);
+    void setProjects(const std::vector<Project>& projects);
+    std::vector<Project> projectsInOrder() const;
+    static std::vector<Project> collect(const PostingList& postings);
+
     // Helper methods
-    std::vector<Project>::iterator findProject(const std::string& projectId);
-    std::vector<Project>::const_iterator findProject(const std::string& projectId) const;
     std::vector<Collection>::iterator findCollection(const std::string& collectionId);
     std::vector<Collection>::const_iterator findCollection(const std::string& collectionId) const;
 };
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "elizaos/memory_governor.hpp"
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <memory>
@@ -85,10 +88,10 @@ using WorldEventCallback = std::function<void(const std::string&, const std::str
 /**
  * @brief Main class for managing the virtual world and agent environments
  */
-class ElizasWorld {
+class ElizasWorld : public MemoryConsumer {
 public:
     ElizasWorld();
-    ~ElizasWorld() = default;
+    ~ElizasWorld();
 
     // Environment management
     bool addEnvironment(const WorldEnvironment& environment);
@@ -155,10 +158,17 @@ public:
     void setSimulationSpeed(double speed);
     void setAutoUpdate(bool enabled, double interval = 0.1); // Auto-update every 100ms
 
+    // Memory governor support; shrinking drops the oldest interactions
+    std::string getConsumerName() const override { return "world.interactions"; }
+    size_t getAccountedBytes() const override { return interactionBytes_.load(std::memory_order_relaxed); }
+    size_t shrinkMemory(size_t bytes) override;
+
 private:
     std::vector<WorldEnvironment> environments_;
     std::vector<WorldAgent> agents_;
-    std::vector<WorldInteraction> interactions_;
+    std::vector<WorldInteraction> interactions_;      // Oldest first
+    mutable std::mutex interactionsMutex_;              // The governor trims from its own thread
+    std::atomic<size_t> interactionBytes_{0};
     
     WorldPosition worldMin_;
     WorldPosition worldMax_;
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "elizaos/core.hpp"
+#include "elizaos/executor.hpp"
+#include "elizaos/memory_governor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Deterministic bag-of-words embedding by feature hashing
+ *
+ * Lowercased alphanumeric words and adjacent word pairs are hashed into
+ * signed buckets and the result is L2-normalised, so equal texts always get
+ * equal vectors and texts sharing words score a positive cosine. Needs no
+ * model, which makes it the reference processor for tests and a fallback
+ * when no model is configured. Embeds batches natively.
+ */
+class HashingEmbeddingProcessor : public ConnectionistProcessor {
+public:
+    explicit HashingEmbeddingProcessor(size_t dimensions = 256);
+
+    std::string getName() const override { return "hashing"; }
+    EmbeddingVector generateEmbedding(const std::string& input) override;
+    double computeSimilarity(const EmbeddingVector& a, const EmbeddingVector& b) override;
+    std::vector<std::string> generateResponse(const EmbeddingVector& context) override;
+
+    bool supportsBatching() const override { return true; }
+    std::vector<EmbeddingVector> generateEmbeddings(const std::vector<std::string>& inputs) override;
+
+    size_t getDimensions() const { return dimensions_; }
+
+private:
+    const size_t dimensions_;
+};
+
+struct EmbeddingServiceConfig {
+    size_t cacheEntries = 16384;                    // LRU capacity; 0 disables caching
+    size_t maxBatchSize = 32;                       // Texts per processor call
+    std::chrono::microseconds maxBatchDelay{0};     // How long a batch may wait to fill up
+    std::string cachePath;                          // Loaded on construction and saved on destruction when set
+};
+
+/**
+ * Caching, de-duplicating and batching front end for a ConnectionistProcessor
+ *
+ * Texts are keyed by their full content, hashed with contentKey(). A cached
+ * text is answered immediately; a text already being embedded waits for
+ * that computation instead of starting another; anything else joins a
+ * queue drained by one task on the executor's blocking pool, so the
+ * processor is never called concurrently. embed() and embedAll() run the
+ * drain on the calling thread instead when no drain is running, so a
+ * blocking-pool task waiting on them never depends on another pool
+ * worker becoming free. The drain takes up to maxBatchSize texts
+ * per processor call, using generateEmbeddings() when the processor
+ * supports batching and one generateEmbedding() per text otherwise.
+ * Requests arriving while a batch runs are gathered into the next one, so
+ * concurrent callers are batched without a fixed delay; maxBatchDelay
+ * additionally lets a short batch wait for more texts.
+ *
+ * The cache can be registered with the MemoryGovernor, which then evicts
+ * least recently used embeddings under pressure.
+ */
+class EmbeddingService : public MemoryConsumer {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t deduplicated = 0;      // Misses that joined an in-flight computation
+        uint64_t batches = 0;           // Processor calls
+        uint64_t embedded = 0;          // Texts the processor embedded
+        uint64_t failed = 0;            // Texts whose embedding threw
+        uint64_t evictions = 0;
+    };
+
+    explicit EmbeddingService(std::shared_ptr<ConnectionistProcessor> processor,
+                              EmbeddingServiceConfig config = {});
+
+    /**
+     * Waits for queued texts to be embedded, then saves the cache if
+     * cachePath is set
+     */
+    ~EmbeddingService() override;
+
+    EmbeddingService(const EmbeddingService&) = delete;
+    EmbeddingService& operator=(const EmbeddingService&) = delete;
+
+    /**
+     * Embedding of text; a processor exception fails the future
+     */
+    Future<EmbeddingVector> embedAsync(const std::string& text);
+
+    EmbeddingVector embed(const std::string& text);
+
+    /**
+     * Embeddings in input order, queued together so they share batches
+     */
+    std::vector<EmbeddingVector> embedAll(const std::vector<std::string>& texts);
+
+    bool contains(std::string_view text) const;
+    size_t cacheSize() const;
+    void clearCache();
+
+    /**
+     * Writes cached embeddings, most recently used first, to a file
+     * replaced atomically
+     */
+    bool saveCache(const std::string& path, std::string* error = nullptr) const;
+
+    /**
+     * Adds embeddings saved by a service over a processor of the same name;
+     * returns how many were loaded, or nullopt when the file is unreadable
+     */
+    std::optional<size_t> loadCache(const std::string& path, std::string* error = nullptr);
+
+    Stats getStats() const;
+    const std::shared_ptr<ConnectionistProcessor>& getProcessor() const { return processor_; }
+
+    // MemoryConsumer
+    std::string getConsumerName() const override { return "embeddings"; }
+    size_t getAccountedBytes() const override { return accountedBytes_.load(std::memory_order_relaxed); }
+    size_t shrinkMemory(size_t bytes) override;
+
+    static uint64_t contentKey(std::string_view text);
+
+private:
+    struct CacheEntry {
+        std::string text;
+        EmbeddingVector embedding;
+    };
+
+    struct ContentHash {
+        size_t operator()(std::string_view text) const { return static_cast<size_t>(contentKey(text)); }
+    };
+
+    Future<EmbeddingVector> request(const std::string& text, bool* postDrain);
+    void drainPosted();
+    void drainInline();
+    void drainLocked(std::unique_lock<std::mutex>& lock);
+    void insertLocked(std::string text, EmbeddingVector embedding);
+    size_t evictOldestLocked();
+    static size_t entryBytes(const CacheEntry& entry);
+
+    const std::shared_ptr<ConnectionistProcessor> processor_;
+    const EmbeddingServiceConfig config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable changed_;
+    std::list<CacheEntry> lru_;                                         // Most recent first
+    // Keys view the text of their lru_ entry
+    std::unordered_map<std::string_view, std::list<CacheEntry>::iterator, ContentHash> cache_;
+    std::unordered_map<std::string, std::vector<Promise<EmbeddingVector>>, ContentHash> inFlight_;
+    std::deque<std::string> queue_;
+    bool draining_ = false;                                             // A thread runs the drain loop
+    bool drainPosted_ = false;                                          // A drain task waits on the pool
+    bool stopping_ = false;
+    Stats stats_;
+    std::atomic<size_t> accountedBytes_{0};
+};
+
+} // namespace elizaos
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "core.hpp"
+#include "executor.hpp"
 #include <random>
 #include <algorithm>
 #include <functional>
@@ -377,6 +378,9 @@ private:
     Individual runStage(const Stage& stage, const State& state, 
                        const Individual& input = Individual(nullptr));
     void notifyHooks(const Stage& stage, const Individual& result, const State& state);
+
+    // runPipelineAsync() runs
+    TaskScope tasks_;
 };
 
 } // namespace elizaos
\ No newline at end of file
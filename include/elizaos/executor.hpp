@@ -0,0 +1,796 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace elizaos {
+
+class Executor;
+
+template <typename T>
+class Future;
+
+/**
+ * Scheduling lanes. Workers always drain higher lanes first.
+ */
+enum class TaskPriority {
+    HIGH = 0,
+    NORMAL = 1,
+    LOW = 2
+};
+
+namespace detail {
+
+struct FutureAccess;
+
+/**
+ * Move-only type-erased void() callable
+ *
+ * std::function requires copyable targets, which would rule out tasks that
+ * own promises or other move-only state.
+ */
+class Task {
+public:
+    Task() = default;
+
+    template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, Task>::value>>
+    Task(F&& f) : impl_(std::make_unique<Impl<std::decay_t<F>>>(std::forward<F>(f))) {}
+
+    Task(Task&&) noexcept = default;
+    Task& operator=(Task&&) noexcept = default;
+
+    explicit operator bool() const { return impl_ != nullptr; }
+    void operator()() { impl_->run(); }
+
+private:
+    struct Base {
+        virtual ~Base() = default;
+        virtual void run() = 0;
+    };
+
+    template <typename F>
+    struct Impl : Base {
+        explicit Impl(F&& fn) : f(std::move(fn)) {}
+        explicit Impl(const F& fn) : f(fn) {}
+        void run() override { f(); }
+        F f;
+    };
+
+    std::unique_ptr<Base> impl_;
+};
+
+struct Unit {};
+
+template <typename T>
+using Stored = std::conditional_t<std::is_void<T>::value, Unit, T>;
+
+template <typename T>
+struct IsFuture : std::false_type {};
+
+template <typename T>
+struct IsFuture<Future<T>> : std::true_type {};
+
+template <typename T>
+struct Unwrap {
+    using type = T;
+};
+
+template <typename T>
+struct Unwrap<Future<T>> {
+    using type = T;
+};
+
+// SFINAE-friendly, so then(executor, f) does not match then(f, priority)
+template <typename F, typename T>
+struct ContinuationResult : std::invoke_result<F, T> {};
+
+template <typename F>
+struct ContinuationResult<F, void> : std::invoke_result<F> {};
+
+/**
+ * State shared by a Future and its producer
+ *
+ * At most one continuation is attached. It runs inline on the thread that
+ * completes the state, so it must only hand work off (the executor's
+ * continuations post themselves) or do a constant amount of bookkeeping.
+ */
+template <typename T>
+class SharedState {
+public:
+    explicit SharedState(Executor* executor) : executor_(executor) {}
+
+    void setValue(Stored<T> value) {
+        Task continuation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.load(std::memory_order_relaxed)) return;
+            value_.emplace(std::move(value));
+            ready_.store(true, std::memory_order_release);
+            continuation = std::move(continuation_);
+        }
+        readyCv_.notify_all();
+        if (continuation) continuation();
+    }
+
+    void setError(std::exception_ptr error) {
+        Task continuation;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (ready_.load(std::memory_order_relaxed)) return;
+            error_ = std::move(error);
+            ready_.store(true, std::memory_order_release);
+            continuation = std::move(continuation_);
+        }
+        readyCv_.notify_all();
+        if (continuation) continuation();
+    }
+
+    void setContinuation(Task continuation) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!ready_.load(std::memory_order_relaxed)) {
+                continuation_ = std::move(continuation);
+                return;
+            }
+        }
+        continuation();
+    }
+
+    bool isReady() const { return ready_.load(std::memory_order_acquire); }
+
+    void wait() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        readyCv_.wait(lock, [this] { return ready_.load(std::memory_order_relaxed); });
+    }
+
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return readyCv_.wait_for(lock, timeout, [this] { return ready_.load(std::memory_order_relaxed); });
+    }
+
+    // Only valid once ready
+    std::exception_ptr error() const { return error_; }
+    Stored<T>& value() { return *value_; }
+
+    Executor* executor() const { return executor_; }
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::condition_variable readyCv_;
+    std::atomic<bool> ready_{false};
+    std::optional<Stored<T>> value_;
+    std::exception_ptr error_;
+    Task continuation_;
+    Executor* executor_;
+};
+
+} // namespace detail
+
+/**
+ * Result of work submitted to an Executor
+ *
+ * Move-only and single-consumer like std::future: get() and then() consume
+ * the result. Blocking in get() or wait() from an executor worker runs other
+ * queued tasks meanwhile, so a fixed-size pool cannot deadlock on itself.
+ */
+template <typename T>
+class Future {
+public:
+    Future() = default;
+    Future(Future&&) noexcept = default;
+    Future& operator=(Future&&) noexcept = default;
+    Future(const Future&) = delete;
+    Future& operator=(const Future&) = delete;
+
+    bool valid() const { return state_ != nullptr; }
+    bool isReady() const { return state_ && state_->isReady(); }
+
+    void wait() const;
+
+    template <typename Rep, typename Period>
+    bool waitFor(const std::chrono::duration<Rep, Period>& timeout) const {
+        return state_->waitFor(timeout);
+    }
+
+    /**
+     * Waits for and returns the result, rethrowing a stored exception
+     */
+    T get();
+
+    /**
+     * Runs f with the result on the executor once it is available and returns
+     * a future for f's result. A continuation returning a Future is flattened.
+     * Exceptions skip f and propagate to the returned future.
+     */
+    template <typename F>
+    auto then(F&& f, TaskPriority priority = TaskPriority::NORMAL)
+        -> Future<typename detail::Unwrap<typename detail::ContinuationResult<std::decay_t<F>, T>::type>::type>;
+
+    template <typename F>
+    auto then(Executor& executor, F&& f, TaskPriority priority = TaskPriority::NORMAL)
+        -> Future<typename detail::Unwrap<typename detail::ContinuationResult<std::decay_t<F>, T>::type>::type>;
+
+private:
+    friend struct detail::FutureAccess;
+
+    explicit Future(std::shared_ptr<detail::SharedState<T>> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::SharedState<T>> consume() {
+        if (!state_) throw std::future_error(std::future_errc::no_state);
+        return std::move(state_);
+    }
+
+    // Completes target with this future's outcome, whatever thread finishes it
+    void forwardTo(std::shared_ptr<detail::SharedState<T>> target);
+
+    std::shared_ptr<detail::SharedState<T>> state_;
+};
+
+namespace detail {
+
+/**
+ * Lets the executor, promises and combinators reach a Future's shared state
+ * without widening its public interface
+ */
+struct FutureAccess {
+    template <typename T>
+    static Future<T> make(std::shared_ptr<SharedState<T>> state) {
+        return Future<T>(std::move(state));
+    }
+
+    template <typename T>
+    static std::shared_ptr<SharedState<T>> consume(Future<T>& future) {
+        return future.consume();
+    }
+
+    template <typename T>
+    static Executor* executor(const Future<T>& future) {
+        return future.state_ ? future.state_->executor() : nullptr;
+    }
+
+    template <typename T>
+    static void forward(Future<T>& future, std::shared_ptr<SharedState<T>> target) {
+        future.forwardTo(std::move(target));
+    }
+};
+
+} // namespace detail
+
+/**
+ * Producer side of a Future
+ *
+ * A promise destroyed without a result completes its future with
+ * std::future_errc::broken_promise, so continuations are never stranded.
+ */
+template <typename T>
+class Promise {
+public:
+    explicit Promise(Executor* executor = nullptr);
+    Promise(Promise&&) noexcept = default;
+    Promise& operator=(Promise&& other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::move(other.state_);
+            retrieved_ = other.retrieved_;
+        }
+        return *this;
+    }
+    ~Promise() { abandon(); }
+
+    Future<T> getFuture() {
+        if (retrieved_) throw std::future_error(std::future_errc::future_already_retrieved);
+        retrieved_ = true;
+        return detail::FutureAccess::make(state_);
+    }
+
+    template <typename U = T, typename = std::enable_if_t<!std::is_void<U>::value>>
+    void setValue(U value) {
+        release()->setValue(std::move(value));
+    }
+
+    template <typename U = T, typename = std::enable_if_t<std::is_void<U>::value>>
+    void setValue() {
+        release()->setValue(detail::Unit{});
+    }
+
+    void setException(std::exception_ptr error) { release()->setError(std::move(error)); }
+
+private:
+    std::shared_ptr<detail::SharedState<T>> release() {
+        if (!state_) throw std::future_error(std::future_errc::promise_already_satisfied);
+        return std::move(state_);
+    }
+
+    void abandon() {
+        if (state_) {
+            state_->setError(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+            state_.reset();
+        }
+    }
+
+    std::shared_ptr<detail::SharedState<T>> state_;
+    bool retrieved_ = false;
+};
+
+/**
+ * Shared work-stealing executor
+ *
+ * A fixed set of CPU workers, each owning one deque per priority lane. Work
+ * posted from a worker goes to the back of that worker's own deque and is
+ * popped LIFO (cache-warm); work posted from outside goes to a shared
+ * injection queue. Idle workers take from their own deque, then the
+ * injection queue, then steal FIFO from other workers, always preferring
+ * higher lanes.
+ *
+ * Blocking calls (network, disk, sleeping on a condition) must not run on CPU
+ * workers; a separate fixed pool serves postBlocking()/submitBlocking().
+ * Delayed work waits on a single timer thread and is queued when due, so
+ * periodic loops need no thread of their own (see PeriodicTask). Modules
+ * should submit work here rather than owning threads, so the thread count
+ * of a process stays fixed however many agents it hosts.
+ */
+class Executor {
+public:
+    using TimerId = uint64_t;
+
+    struct Config {
+        size_t workerThreads = 0;      // 0 = one per hardware thread
+        size_t blockingThreads = 8;
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint64_t blockingExecuted = 0;
+        uint64_t failed = 0;           // Posted tasks that threw
+    };
+
+    Executor();
+    explicit Executor(const Config& config);
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * Process-wide executor shared by all modules
+     */
+    static Executor& global();
+
+    /**
+     * Queues fire-and-forget work. After shutdown() the task runs inline on
+     * the calling thread so completions are never lost.
+     */
+    void post(detail::Task task, TaskPriority priority = TaskPriority::NORMAL);
+    void postBlocking(detail::Task task);
+
+    /**
+     * Queues task once delay has passed, on the CPU workers or the blocking
+     * pool. Returns an id for cancel(); after shutdown() the task is dropped
+     * and 0 returned.
+     */
+    TimerId postAfter(std::chrono::steady_clock::duration delay, detail::Task task,
+                      TaskPriority priority = TaskPriority::NORMAL);
+    TimerId postBlockingAfter(std::chrono::steady_clock::duration delay, detail::Task task);
+
+    /**
+     * Drops a delayed task that has not been queued yet; false once it has
+     */
+    bool cancel(TimerId id);
+
+    template <typename F>
+    auto submit(F&& f, TaskPriority priority = TaskPriority::NORMAL) -> Future<std::invoke_result_t<std::decay_t<F>>>;
+
+    template <typename F>
+    auto submitBlocking(F&& f) -> Future<std::invoke_result_t<std::decay_t<F>>>;
+
+    /**
+     * Drop-in replacement for std::async(std::launch::async, f) on the
+     * blocking pool, for APIs that already return std::future. Unlike
+     * std::async, the returned future does not block in its destructor, so a
+     * task that touches its caller must be joined by the caller (see
+     * TaskScope). At most Config::blockingThreads such tasks run at once;
+     * the rest queue in FIFO order rather than each getting a thread.
+     */
+    template <typename F>
+    auto async(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    /**
+     * Runs one queued CPU task on the calling thread, if any is available.
+     * Used by waiters on worker threads to make progress instead of blocking.
+     */
+    bool runPendingTask();
+
+    /**
+     * Stops accepting queued work, drains what is queued and joins all
+     * threads. Idempotent; called by the destructor.
+     */
+    void shutdown();
+
+    bool isWorkerThread() const;
+    size_t getWorkerCount() const;
+    size_t getBlockingThreadCount() const;
+    Stats getStats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+/**
+ * Joins the Executor::async() tasks an object starts on itself. Declare it as
+ * the owner's last member and call wait() at the top of the owner's
+ * destructor, so no task outlives the state it captured.
+ */
+class TaskScope {
+public:
+    TaskScope() = default;   // Uses Executor::global(), resolved on first async()
+    explicit TaskScope(Executor& executor) : executor_(&executor) {}
+    ~TaskScope() { wait(); }
+
+    TaskScope(const TaskScope&) = delete;
+    TaskScope& operator=(const TaskScope&) = delete;
+
+    template <typename F>
+    auto async(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>>;
+
+    /**
+     * Blocks until every task started through this scope has finished
+     */
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+private:
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--pending_ == 0) idle_.notify_all();
+    }
+
+    Executor* executor_ = nullptr;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    size_t pending_ = 0;
+};
+
+/**
+ * Runs a callback every interval on an executor until stopped, in place of
+ * a thread sleeping between runs. Each run is queued interval after the
+ * previous one returned, so runs never overlap. Runs go to the blocking
+ * pool unless the task is constructed for CPU work.
+ */
+class PeriodicTask {
+public:
+    PeriodicTask();   // Global executor, resolved on start(); blocking pool
+    explicit PeriodicTask(Executor& executor, bool blocking = true);
+    ~PeriodicTask();
+
+    PeriodicTask(const PeriodicTask&) = delete;
+    PeriodicTask& operator=(const PeriodicTask&) = delete;
+
+    /**
+     * Queues the first run now, replacing any callback already running
+     */
+    void start(std::chrono::steady_clock::duration interval, std::function<void()> task);
+
+    /**
+     * Cancels the next run and waits for one in progress, unless called
+     * from the callback itself
+     */
+    void stop();
+
+    /**
+     * Takes effect from the next run scheduled
+     */
+    void setInterval(std::chrono::steady_clock::duration interval);
+
+    bool isRunning() const;
+
+private:
+    struct State;
+
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * Completes when every input has; fails with the first error in input order
+ */
+template <typename T>
+Future<std::vector<T>> whenAll(std::vector<Future<T>> futures);
+
+Future<void> whenAll(std::vector<Future<void>> futures);
+
+template <typename... Ts>
+Future<std::tuple<detail::Stored<Ts>...>> whenAll(Future<Ts>... futures);
+
+template <typename T>
+Future<T> makeReadyFuture(T value) {
+    Promise<T> promise;
+    Future<T> future = promise.getFuture();
+    promise.setValue(std::move(value));
+    return future;
+}
+
+Future<void> makeReadyFuture();
+
+// ---------------------------------------------------------------------------
+// Template implementation
+// ---------------------------------------------------------------------------
+
+namespace detail {
+
+template <typename T, typename F>
+decltype(auto) invokeWith(F& f, SharedState<T>& source) {
+    if constexpr (std::is_void<T>::value) {
+        return f();
+    } else {
+        return f(std::move(source.value()));
+    }
+}
+
+template <size_t... Is, typename F>
+void forEachIndex(std::index_sequence<Is...>, F&& f) {
+    (f(std::integral_constant<size_t, Is>{}), ...);
+}
+
+// Runs f and stores its outcome (flattening a returned Future) in target
+template <typename R, typename F>
+void complete(std::shared_ptr<SharedState<typename Unwrap<R>::type>> target, F&& f) {
+    try {
+        if constexpr (IsFuture<R>::value) {
+            R inner = f();
+            FutureAccess::forward(inner, std::move(target));
+        } else if constexpr (std::is_void<R>::value) {
+            f();
+            target->setValue(Unit{});
+        } else {
+            target->setValue(f());
+        }
+    } catch (...) {
+        target->setError(std::current_exception());
+    }
+}
+
+} // namespace detail
+
+template <typename T>
+Promise<T>::Promise(Executor* executor) : state_(std::make_shared<detail::SharedState<T>>(executor)) {}
+
+template <typename T>
+void Future<T>::wait() const {
+    if (!state_) throw std::future_error(std::future_errc::no_state);
+    Executor* executor = state_->executor();
+    if (executor && executor->isWorkerThread()) {
+        while (!state_->isReady()) {
+            if (!executor->runPendingTask()) state_->waitFor(std::chrono::milliseconds(1));
+        }
+        return;
+    }
+    state_->wait();
+}
+
+template <typename T>
+T Future<T>::get() {
+    wait();
+    auto state = consume();
+    if (state->error()) std::rethrow_exception(state->error());
+    if constexpr (!std::is_void<T>::value) {
+        return std::move(state->value());
+    }
+}
+
+template <typename T>
+void Future<T>::forwardTo(std::shared_ptr<detail::SharedState<T>> target) {
+    auto source = consume();
+    detail::SharedState<T>* raw = source.get();
+    raw->setContinuation([source = std::move(source), target = std::move(target)]() {
+        if (source->error()) {
+            target->setError(source->error());
+        } else {
+            target->setValue(std::move(source->value()));
+        }
+    });
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::then(F&& f, TaskPriority priority)
+    -> Future<typename detail::Unwrap<typename detail::ContinuationResult<std::decay_t<F>, T>::type>::type> {
+    if (!state_) throw std::future_error(std::future_errc::no_state);
+    Executor* executor = state_->executor();
+    return then(executor ? *executor : Executor::global(), std::forward<F>(f), priority);
+}
+
+template <typename T>
+template <typename F>
+auto Future<T>::then(Executor& executor, F&& f, TaskPriority priority)
+    -> Future<typename detail::Unwrap<typename detail::ContinuationResult<std::decay_t<F>, T>::type>::type> {
+    using R = typename detail::ContinuationResult<std::decay_t<F>, T>::type;
+    using U = typename detail::Unwrap<R>::type;
+
+    auto source = consume();
+    auto next = std::make_shared<detail::SharedState<U>>(&executor);
+    detail::SharedState<T>* raw = source.get();
+
+    // The continuation only posts; f itself always runs on the executor
+    raw->setContinuation([source = std::move(source), next, fn = std::forward<F>(f), executor = &executor,
+                          priority]() mutable {
+        executor->post(
+            [source = std::move(source), next = std::move(next), fn = std::move(fn)]() mutable {
+                if (source->error()) {
+                    next->setError(source->error());
+                    return;
+                }
+                detail::complete<R>(std::move(next), [&]() -> R { return detail::invokeWith<T>(fn, *source); });
+            },
+            priority);
+    });
+    return detail::FutureAccess::make(std::move(next));
+}
+
+template <typename F>
+auto Executor::submit(F&& f, TaskPriority priority) -> Future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto state = std::make_shared<detail::SharedState<R>>(this);
+    post([state, fn = std::forward<F>(f)]() mutable { detail::complete<R>(state, fn); }, priority);
+    return detail::FutureAccess::make(std::move(state));
+}
+
+template <typename F>
+auto Executor::submitBlocking(F&& f) -> Future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    auto state = std::make_shared<detail::SharedState<R>>(this);
+    postBlocking([state, fn = std::forward<F>(f)]() mutable { detail::complete<R>(state, fn); });
+    return detail::FutureAccess::make(std::move(state));
+}
+
+template <typename F>
+auto Executor::async(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    using R = std::invoke_result_t<std::decay_t<F>>;
+    std::promise<R> promise;
+    std::future<R> future = promise.get_future();
+    postBlocking([promise = std::move(promise), fn = std::forward<F>(f)]() mutable {
+        try {
+            if constexpr (std::is_void<R>::value) {
+                fn();
+                promise.set_value();
+            } else {
+                promise.set_value(fn());
+            }
+        } catch (...) {
+            promise.set_exception(std::current_exception());
+        }
+    });
+    return future;
+}
+
+template <typename F>
+auto TaskScope::async(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pending_;
+    }
+    struct Finish {
+        TaskScope* scope;
+        ~Finish() { scope->finish(); }
+    };
+    // Finish runs once fn() has returned, so wait() cannot release the owner
+    // while the task still uses it.
+    Executor& executor = executor_ ? *executor_ : Executor::global();
+    return executor.async([this, fn = std::forward<F>(f)]() mutable {
+        Finish finish{this};
+        return fn();
+    });
+}
+
+template <typename T>
+Future<std::vector<T>> whenAll(std::vector<Future<T>> futures) {
+    struct Join {
+        std::vector<std::optional<T>> results;
+        std::vector<std::exception_ptr> errors;
+        std::atomic<size_t> remaining;
+        std::shared_ptr<detail::SharedState<std::vector<T>>> target;
+    };
+
+    Executor* executor = futures.empty() ? nullptr : detail::FutureAccess::executor(futures.front());
+    auto join = std::make_shared<Join>();
+    join->results.resize(futures.size());
+    join->errors.resize(futures.size());
+    join->remaining.store(futures.size() + 1);
+    join->target = std::make_shared<detail::SharedState<std::vector<T>>>(executor);
+    auto result = detail::FutureAccess::make(join->target);
+
+    auto finish = [](Join& j) {
+        for (auto& error : j.errors) {
+            if (error) {
+                j.target->setError(error);
+                return;
+            }
+        }
+        std::vector<T> values;
+        values.reserve(j.results.size());
+        for (auto& value : j.results) values.push_back(std::move(*value));
+        j.target->setValue(std::move(values));
+    };
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto source = detail::FutureAccess::consume(futures[i]);
+        detail::SharedState<T>* raw = source.get();
+        raw->setContinuation([join, source = std::move(source), i, finish]() {
+            if (source->error()) {
+                join->errors[i] = source->error();
+            } else {
+                join->results[i].emplace(std::move(source->value()));
+            }
+            if (join->remaining.fetch_sub(1) == 1) finish(*join);
+        });
+    }
+    // The extra count keeps the join open until every continuation is attached
+    if (join->remaining.fetch_sub(1) == 1) finish(*join);
+    return result;
+}
+
+template <typename... Ts>
+Future<std::tuple<detail::Stored<Ts>...>> whenAll(Future<Ts>... futures) {
+    using Tuple = std::tuple<detail::Stored<Ts>...>;
+    struct Join {
+        std::tuple<std::optional<detail::Stored<Ts>>...> results;
+        std::exception_ptr errors[sizeof...(Ts) + 1];
+        std::atomic<size_t> remaining{sizeof...(Ts) + 1};
+        std::shared_ptr<detail::SharedState<Tuple>> target;
+    };
+
+    Executor* executor = nullptr;
+    (void)((executor = executor ? executor : detail::FutureAccess::executor(futures)), ...);
+
+    auto join = std::make_shared<Join>();
+    join->target = std::make_shared<detail::SharedState<Tuple>>(executor);
+    auto result = detail::FutureAccess::make(join->target);
+
+    auto finish = [](Join& j) {
+        for (auto& error : j.errors) {
+            if (error) {
+                j.target->setError(error);
+                return;
+            }
+        }
+        j.target->setValue(std::apply([](auto&... values) { return Tuple(std::move(*values)...); }, j.results));
+    };
+
+    std::tuple<Future<Ts>...> inputs(std::move(futures)...);
+    detail::forEachIndex(std::index_sequence_for<Ts...>{}, [&](auto index) {
+        constexpr size_t I = decltype(index)::value;
+        auto source = detail::FutureAccess::consume(std::get<I>(inputs));
+        auto* raw = source.get();
+        raw->setContinuation([join, source = std::move(source), finish]() {
+            if (source->error()) {
+                join->errors[I] = source->error();
+            } else {
+                std::get<I>(join->results).emplace(std::move(source->value()));
+            }
+            if (join->remaining.fetch_sub(1) == 1) finish(*join);
+        });
+    });
+
+    if (join->remaining.fetch_sub(1) == 1) finish(*join);
+    return result;
+}
+
+} // namespace elizaos
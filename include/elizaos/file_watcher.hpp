@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Recursive inotify-based file watcher
+ *
+ * Bursts of file system events (editor save sequences, git checkouts) are
+ * coalesced: the callback fires once the tree has been quiet for the
+ * coalescing window, or once the oldest pending change reaches four windows
+ * of age, with the de-duplicated list of changed paths.
+ *
+ * When the kernel event queue overflows and events are lost, the list
+ * holds the directories passed to addDirectory() instead, meaning anything
+ * below them may have changed.
+ */
+class FileWatcher {
+public:
+    using ChangeCallback = std::function<void(const std::vector<std::filesystem::path>&)>;
+
+    explicit FileWatcher(std::chrono::milliseconds coalesce_window = std::chrono::milliseconds(20));
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * Watch a directory and all of its subdirectories.
+     * Directories created later are picked up automatically.
+     */
+    bool addDirectory(const std::filesystem::path& directory);
+
+    /**
+     * Start the watcher thread; the callback runs on that thread
+     */
+    bool start(ChangeCallback callback);
+
+    /**
+     * Stop the watcher thread and drop pending events
+     */
+    void stop();
+
+    bool isRunning() const;
+    size_t getWatchCount() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace elizaos
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "elizaos/pool.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace elizaos {
+
+enum class HtmlNodeType : uint8_t {
+    DOCUMENT,
+    ELEMENT,
+    TEXT,
+    COMMENT
+};
+
+struct HtmlAttribute {
+    std::string_view name;          // Lowercase
+    std::string_view value;         // Character references decoded
+};
+
+/**
+ * Node of a parsed document
+ *
+ * Nodes and every string they reference live in their document's arena and
+ * are valid for the document's lifetime. Elements are numbered in document
+ * order, which query results are sorted by.
+ */
+struct HtmlNode {
+    HtmlNodeType type = HtmlNodeType::ELEMENT;
+    std::string_view name;          // Lowercase tag name of an element
+    std::string_view text;          // Contents of a text or comment node
+    const HtmlAttribute* attributes = nullptr;
+    uint32_t attributeCount = 0;
+    uint32_t order = 0;
+
+    HtmlNode* parent = nullptr;
+    HtmlNode* firstChild = nullptr;
+    HtmlNode* lastChild = nullptr;
+    HtmlNode* previousSibling = nullptr;
+    HtmlNode* nextSibling = nullptr;
+
+    bool isElement() const { return type == HtmlNodeType::ELEMENT; }
+    const HtmlAttribute* findAttribute(std::string_view attributeName) const;
+    std::string_view getAttribute(std::string_view attributeName) const;
+    bool hasClass(std::string_view className) const;
+
+    const HtmlNode* firstElementChild() const;
+    const HtmlNode* nextElementSibling() const;
+    const HtmlNode* previousElementSibling() const;
+};
+
+class HtmlDocument;
+
+/**
+ * Compiled CSS selector group
+ *
+ * Supports type, universal, #id, .class and attribute selectors ([a],
+ * [a=v], ~=, |=, ^=, $=, *=), :first-child, :last-child, :only-child,
+ * :nth-child(), :nth-of-type(), :first-of-type, :last-of-type, :empty and
+ * :not() of a compound, descendant, child, adjacent and general sibling
+ * combinators, and comma-separated groups. Matching runs right to left,
+ * starting from the document index that narrows the rightmost compound
+ * the most.
+ */
+class CssSelector {
+public:
+    static std::optional<CssSelector> compile(std::string_view selector, std::string* error = nullptr);
+
+    /**
+     * XPath subset: absolute or // location paths of name tests or *, with
+     * [n], [last()], [@a], [@a='v'], [text()='v'], [contains(@a|text()|.,
+     * 'v')] and [starts-with(@a, 'v')] predicates joined by "and". Compiles
+     * to the same matcher, so it is evaluated the same way.
+     */
+    static std::optional<CssSelector> compileXPath(std::string_view path, std::string* error = nullptr);
+
+    bool matches(const HtmlNode& element) const;
+    std::vector<const HtmlNode*> select(const HtmlDocument& document) const;
+    const HtmlNode* selectFirst(const HtmlDocument& document) const;
+
+    enum class Combinator : uint8_t { NONE, DESCENDANT, CHILD, ADJACENT, SIBLING };
+
+    enum class Test : uint8_t {
+        ATTRIBUTE_EXISTS,
+        ATTRIBUTE_EQUALS,
+        ATTRIBUTE_WORD,             // ~=
+        ATTRIBUTE_LANG,             // |=
+        ATTRIBUTE_PREFIX,           // ^=
+        ATTRIBUTE_SUFFIX,           // $=
+        ATTRIBUTE_CONTAINS,         // *=
+        OWN_TEXT_EQUALS,            // XPath text()='v'
+        OWN_TEXT_CONTAINS,
+        TEXT_CONTAINS,              // XPath contains(., 'v')
+        NTH_CHILD,                  // a * n + b among element siblings
+        NTH_LAST_CHILD,
+        NTH_OF_TYPE,
+        NTH_LAST_OF_TYPE,
+        EMPTY,
+        NOT,
+        DOCUMENT_CHILD              // Parent is the document itself
+    };
+
+    struct Compound;
+
+    struct Condition {
+        Test test = Test::ATTRIBUTE_EXISTS;
+        std::string name;
+        std::string value;
+        int a = 0;
+        int b = 0;
+        std::shared_ptr<Compound> negated;
+    };
+
+    struct Compound {
+        std::string tag;            // Empty for *
+        std::string id;
+        std::vector<std::string> classes;
+        std::vector<Condition> conditions;
+        Combinator combinator = Combinator::NONE;   // Relation to the compound on the left
+    };
+
+private:
+    bool matchesFrom(const HtmlNode& element, const std::vector<Compound>& chain, size_t index) const;
+    std::vector<const HtmlNode*> candidates(const HtmlDocument& document, const Compound& rightmost) const;
+
+    std::vector<std::vector<Compound>> groups_;
+};
+
+/**
+ * Parsed HTML document with id, class and tag indexes
+ *
+ * The tokenizer streams tokens straight into the tree builder, which applies
+ * the HTML5 rules that matter for scraping: void elements, raw text in
+ * script and style, escapable raw text in title and textarea, implied end
+ * tags for p, li, dt, dd, option and table rows and cells, and end tags
+ * that close intervening elements. Nothing is fetched or executed.
+ */
+class HtmlDocument {
+public:
+    static std::unique_ptr<HtmlDocument> parse(std::string_view html);
+    static std::unique_ptr<HtmlDocument> load(const std::string& path, std::string* error = nullptr);
+
+    HtmlDocument(const HtmlDocument&) = delete;
+    HtmlDocument& operator=(const HtmlDocument&) = delete;
+
+    const HtmlNode& getRoot() const { return *root_; }
+    const std::vector<const HtmlNode*>& getElements() const { return elements_; }
+    std::string getTitle() const;
+
+    const HtmlNode* getElementById(std::string_view id) const;
+
+    /**
+     * Every element carrying id, in document order; ids are not always unique
+     */
+    const std::vector<const HtmlNode*>& getElementsById(std::string_view id) const;
+    const std::vector<const HtmlNode*>& getElementsByTagName(std::string_view tag) const;
+    const std::vector<const HtmlNode*>& getElementsByClassName(std::string_view className) const;
+
+    /**
+     * Compile and run a CSS selector; an invalid selector matches nothing
+     */
+    std::vector<const HtmlNode*> querySelectorAll(std::string_view selector) const;
+    const HtmlNode* querySelector(std::string_view selector) const;
+    std::vector<const HtmlNode*> evaluateXPath(std::string_view path) const;
+
+    /**
+     * Concatenated text of every descendant text node
+     */
+    std::string textContent(const HtmlNode& node) const;
+
+    /**
+     * Readable text: script and style skipped, whitespace collapsed and
+     * block elements on their own lines, gathered in one traversal
+     */
+    std::string extractText(const HtmlNode& node) const;
+    std::string extractText() const { return extractText(*root_); }
+
+    std::string innerHtml(const HtmlNode& node) const;
+    std::string outerHtml(const HtmlNode& node) const;
+
+    size_t getArenaBytes() const { return arena_.getUsedBytes(); }
+
+private:
+    friend class HtmlTreeBuilder;
+    explicit HtmlDocument(size_t chunkBytes);
+
+    GenerationArena arena_;
+    HtmlNode* root_ = nullptr;
+    std::vector<const HtmlNode*> elements_;                 // Document order
+    std::unordered_map<std::string_view, std::vector<const HtmlNode*>> byId_;
+    std::unordered_map<std::string_view, std::vector<const HtmlNode*>> byTag_;
+    std::unordered_map<std::string_view, std::vector<const HtmlNode*>> byClass_;
+};
+
+/**
+ * Decodes named and numeric character references to UTF-8
+ */
+std::string decodeHtmlEntities(std::string_view text);
+
+} // namespace elizaos
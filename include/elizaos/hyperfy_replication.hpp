@@ -0,0 +1,232 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace elizaos {
+    namespace hyperfy {
+
+        using EntityId = uint32_t;
+        using ClientId = uint32_t;
+
+        constexpr EntityId INVALID_ENTITY = 0;
+
+        struct Vec3 {
+            float x = 0.0f;
+            float y = 0.0f;
+            float z = 0.0f;
+        };
+
+        /**
+         * @brief State flag bits carried in EntityState::flags
+         */
+        enum EntityFlag : uint32_t {
+            ENTITY_GROUNDED = 1u << 0,
+            ENTITY_MOVING = 1u << 1,
+            ENTITY_SPEAKING = 1u << 2,
+            ENTITY_EMOTING = 1u << 3,
+            ENTITY_AGENT = 1u << 4
+        };
+
+        /**
+         * @brief Replicated components of a world entity
+         */
+        struct EntityState {
+            Vec3 position;                      // Metres
+            float yaw = 0.0f;                   // Radians about +Y
+            Vec3 velocity;                      // Metres per second
+            uint32_t flags = 0;                 // EntityFlag bits
+        };
+
+        struct ReplicatedEntity {
+            EntityId id = INVALID_ENTITY;
+            EntityState state;
+        };
+
+        /**
+         * @brief Quantization and interest settings; server and clients must agree
+         */
+        struct ReplicationConfig {
+            float positionResolution = 1.0f / 256.0f;  // Metres per step
+            float velocityResolution = 1.0f / 64.0f;   // Metres per second per step
+            float interestRadius = 64.0f;              // Entities further from a client's viewer are not sent
+            size_t maxEntitiesPerSnapshot = 128;       // Nearest kept when more are in range
+            uint32_t historyTicks = 32;                // Older acknowledgements fall back to full snapshots
+        };
+
+        /**
+         * @brief EntityState as sent on the wire; yaw is 1/65536 of a turn
+         */
+        struct QuantizedState {
+            int32_t position[3] = {0, 0, 0};
+            uint16_t yaw = 0;
+            int32_t velocity[3] = {0, 0, 0};
+            uint32_t flags = 0;
+
+            bool operator==(const QuantizedState& other) const;
+            bool operator!=(const QuantizedState& other) const { return !(*this == other); }
+        };
+
+        QuantizedState quantize(const EntityState& state, const ReplicationConfig& config);
+        EntityState dequantize(const QuantizedState& state, const ReplicationConfig& config);
+
+        /**
+         * @brief Authoritative entity store producing per-client delta snapshots
+         *
+         * Each client views the world from one entity and receives only entities
+         * within interestRadius of it, found through a uniform grid of
+         * interestRadius cells, so building a snapshot looks at the 3x3 cells
+         * around the viewer rather than the whole population. A snapshot encodes
+         * the client's visible set against the last one it acknowledged: only
+         * changed fields of changed entities are written, as zigzag varint deltas
+         * of quantized values, plus removals for entities that left. Until a
+         * snapshot is acknowledged, or when the acknowledged one is older than
+         * historyTicks, the client is sent its full visible set.
+         */
+        class ReplicationServer {
+        public:
+            explicit ReplicationServer(ReplicationConfig config = {});
+
+            EntityId spawnEntity(const EntityState& state);
+            bool updateEntity(EntityId id, const EntityState& state);
+            bool despawnEntity(EntityId id);
+            std::optional<EntityState> getEntity(EntityId id) const;
+            size_t entityCount() const;
+
+            /**
+             * @brief Registers a client whose interest follows viewer; the client's
+             * updates also drive that entity
+             */
+            ClientId addClient(EntityId viewer);
+            void removeClient(ClientId client);
+            size_t clientCount() const;
+
+            uint32_t currentTick() const;
+            uint32_t advanceTick();
+
+            /**
+             * @brief Snapshot for the current tick; repeated calls within a tick
+             * return the same message. Empty for unknown clients
+             */
+            std::string buildSnapshot(ClientId client);
+
+            /**
+             * @brief Applies a client update (acknowledgement and viewer state)
+             */
+            bool receive(ClientId client, std::string_view message);
+
+            const ReplicationConfig& getConfig() const { return config_; }
+
+        private:
+            struct Entity {
+                QuantizedState state;
+                uint64_t cell = 0;
+                uint32_t cellSlot = 0;
+            };
+
+            struct Frame {
+                uint32_t tick = 0;
+                std::vector<std::pair<EntityId, QuantizedState>> entities;  // Sorted by id
+            };
+
+            struct Client {
+                EntityId viewer = INVALID_ENTITY;
+                uint32_t ackedTick = 0;
+                uint32_t sentTick = 0;
+                std::string sent;
+                std::vector<Frame> frames;                  // Ring indexed by tick % historyTicks
+            };
+
+            uint64_t cellOf(const QuantizedState& state) const;
+            void insertIntoCell(EntityId id, Entity& entity);
+            void removeFromCell(Entity& entity);
+            void collectVisible(const Client& client, std::vector<std::pair<EntityId, QuantizedState>>& out) const;
+
+            const ReplicationConfig config_;
+            const float cellSize_;
+
+            mutable std::mutex mutex_;
+            uint32_t tick_ = 1;
+            EntityId nextEntity_ = 1;
+            ClientId nextClient_ = 1;
+            std::unordered_map<EntityId, Entity> entities_;
+            std::unordered_map<uint64_t, std::vector<EntityId>> cells_;
+            std::unordered_map<ClientId, Client> clients_;
+        };
+
+        /**
+         * @brief Client-side mirror of the entities a ReplicationServer sends
+         *
+         * Keeps the last historyTicks decoded snapshots so deltas against any
+         * baseline the server may still use can be applied. Snapshots older than
+         * the newest applied one are ignored.
+         */
+        class ReplicationClient {
+        public:
+            explicit ReplicationClient(ReplicationConfig config = {});
+
+            /**
+             * @brief Decodes a snapshot; false when it is stale, malformed or its
+             * baseline is no longer held, leaving the mirror unchanged
+             */
+            bool applySnapshot(std::string_view message);
+
+            /**
+             * @brief Update for the server acknowledging the newest snapshot, with
+             * the state of the entity this client controls when given
+             */
+            std::string buildUpdate(const std::optional<EntityState>& self = std::nullopt) const;
+
+            uint32_t latestTick() const;
+            std::optional<EntityState> getEntity(EntityId id) const;
+            std::vector<ReplicatedEntity> getEntities() const;
+            size_t entityCount() const;
+            void reset();
+
+        private:
+            struct Frame {
+                uint32_t tick = 0;
+                std::vector<std::pair<EntityId, QuantizedState>> entities;  // Sorted by id
+            };
+
+            const ReplicationConfig config_;
+
+            mutable std::mutex mutex_;
+            std::vector<Frame> frames_;
+            uint32_t latestTick_ = 0;
+        };
+
+        /**
+         * @brief In-process message queue standing in for a socket in one direction
+         *
+         * Counts traffic so bandwidth can be measured, and can drop every nth
+         * message to exercise recovery from loss.
+         */
+        class LoopbackChannel {
+        public:
+            void send(std::string message);
+            std::optional<std::string> receive();
+
+            void setDropEvery(size_t n);
+            size_t pending() const;
+            size_t messagesSent() const;
+            size_t bytesSent() const;
+
+        private:
+            mutable std::mutex mutex_;
+            std::deque<std::string> queue_;
+            size_t dropEvery_ = 0;
+            size_t messages_ = 0;
+            size_t bytes_ = 0;
+        };
+
+    } // namespace hyperfy
+} // namespace elizaos
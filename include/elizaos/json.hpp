@@ -0,0 +1,324 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace elizaos {
+namespace json {
+
+enum class Type : uint8_t {
+    NUL,
+    BOOLEAN,
+    INTEGER,
+    DOUBLE,
+    STRING,
+    ARRAY,
+    OBJECT
+};
+
+const char* typeName(Type type);
+
+/**
+ * Thrown by the as*() accessors when a value holds a different type
+ */
+class TypeError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+class Value;
+struct Member;
+
+using String = std::pmr::string;
+using Array = std::pmr::vector<Value>;
+using Object = std::pmr::vector<Member>;     // Insertion order
+
+/**
+ * JSON value as a tagged union
+ *
+ * Every value remembers the memory resource it allocates from, and children
+ * created through it (operator[], push_back, parsing) use the same one, so a
+ * tree built inside a Document lives entirely in that document's arena.
+ * Short strings are stored inline. Objects keep members in insertion order
+ * and are searched linearly, which beats hashing at the sizes seen in
+ * action arguments and plugin payloads; when a key repeats, lookups see the
+ * last occurrence.
+ *
+ * Copy construction always copies into the default resource, so values
+ * copied out of a Document outlive it. Assignment keeps the target's
+ * resource.
+ */
+class Value {
+public:
+    Value() noexcept : Value(std::pmr::get_default_resource()) {}
+    Value(std::nullptr_t) noexcept : Value() {}
+    explicit Value(std::pmr::memory_resource* resource) noexcept : resource_(resource) {}
+
+    Value(bool value) noexcept : type_(Type::BOOLEAN) { boolean_ = value; }
+
+    template <typename T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>, int> = 0>
+    Value(T value) noexcept : type_(Type::INTEGER) {
+        integer_ = static_cast<int64_t>(value);
+    }
+
+    template <typename T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+    Value(T value) noexcept : type_(Type::DOUBLE) {
+        double_ = static_cast<double>(value);
+    }
+
+    Value(const char* value, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Value(std::string_view value, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    Value(const std::string& value, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : Value(std::string_view(value), resource) {}
+
+    template <typename T>
+    Value(const std::vector<T>& values, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    Value(const Value& other) : Value(other, std::pmr::get_default_resource()) {}
+    Value(const Value& other, std::pmr::memory_resource* resource);
+    Value(Value&& other) noexcept;
+    ~Value() { reset(); }
+
+    Value& operator=(const Value& other);
+    Value& operator=(Value&& other);
+
+    static Value array(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    static Value object(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::NUL; }
+    bool isBool() const { return type_ == Type::BOOLEAN; }
+    bool isInteger() const { return type_ == Type::INTEGER; }
+    bool isDouble() const { return type_ == Type::DOUBLE; }
+    bool isNumber() const { return type_ == Type::INTEGER || type_ == Type::DOUBLE; }
+    bool isString() const { return type_ == Type::STRING; }
+    bool isArray() const { return type_ == Type::ARRAY; }
+    bool isObject() const { return type_ == Type::OBJECT; }
+
+    // Checked accessors; throw TypeError on a mismatch. Numbers convert
+    // between integer and double.
+    bool asBool() const;
+    int64_t asInt() const;
+    double asDouble() const;
+    std::string_view asString() const;
+    const Array& asArray() const;
+    Array& asArray();
+    const Object& asObject() const;
+    Object& asObject();
+
+    // Object member lookups that fall back when the key is missing or holds
+    // another type
+    std::string getString(std::string_view key, std::string_view fallback = {}) const;
+    bool getBool(std::string_view key, bool fallback = false) const;
+    int64_t getInt(std::string_view key, int64_t fallback = 0) const;
+    double getDouble(std::string_view key, double fallback = 0.0) const;
+
+    /**
+     * Object access; a null value becomes an empty object first and a
+     * missing key is inserted as null
+     */
+    Value& operator[](std::string_view key);
+
+    const Value* find(std::string_view key) const;
+    Value* find(std::string_view key);
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    /**
+     * Throws std::out_of_range when the key is missing
+     */
+    const Value& at(std::string_view key) const;
+    Value& at(std::string_view key);
+    bool erase(std::string_view key);
+
+    /**
+     * Array access; push_back turns a null value into an empty array first
+     */
+    Value& operator[](size_t index) { return asArray()[index]; }
+    const Value& operator[](size_t index) const { return asArray()[index]; }
+    Value& push_back(Value value);
+
+    /**
+     * Element count of arrays and objects; 0 for scalars
+     */
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    void clear();
+
+    std::pmr::memory_resource* getResource() const { return resource_; }
+
+    friend bool operator==(const Value& a, const Value& b);
+    friend bool operator!=(const Value& a, const Value& b) { return !(a == b); }
+
+private:
+    void reset() noexcept;
+    void copyFrom(const Value& other);
+    void moveFrom(Value& other) noexcept;
+    [[noreturn]] void typeMismatch(Type expected) const;
+
+    Type type_ = Type::NUL;
+    std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
+    union {
+        bool boolean_;
+        int64_t integer_;
+        double double_;
+        String string_;
+        Array array_;
+        Object object_;
+    };
+};
+
+struct Member {
+    String key;
+    Value value;
+
+    Member(std::string_view name, Value&& content, std::pmr::memory_resource* resource)
+        : key(name, resource), value(std::move(content)) {}
+    Member(const Member& other, std::pmr::memory_resource* resource)
+        : key(other.key, resource), value(other.value, resource) {}
+    Member(const Member& other) : Member(other, std::pmr::get_default_resource()) {}
+    Member(Member&&) noexcept = default;
+    Member& operator=(Member&&) = default;
+    Member& operator=(const Member&) = default;
+};
+
+template <typename T>
+Value::Value(const std::vector<T>& values, std::pmr::memory_resource* resource) : Value(array(resource)) {
+    array_.reserve(values.size());
+    for (const auto& value : values) {
+        push_back(Value(value));
+    }
+}
+
+struct ParseError {
+    size_t offset = 0;
+    std::string message;
+};
+
+/**
+ * Arena-backed JSON document
+ *
+ * Every node of the tree under root() is allocated from one monotonic
+ * buffer and released at once when the document goes away, so building or
+ * parsing a document never frees individual nodes.
+ */
+class Document {
+public:
+    explicit Document(size_t initialBytes = 1024);
+    Document(const Document&) = delete;
+    Document& operator=(const Document&) = delete;
+
+    Value& root() { return root_; }
+    const Value& root() const { return root_; }
+
+    /**
+     * A null value that allocates from this document, for building subtrees
+     * to attach to root()
+     */
+    Value makeValue() { return Value(&arena_); }
+
+    std::pmr::memory_resource* getResource() { return &arena_; }
+
+    /**
+     * Replaces root() with the parsed text; on failure root() is null
+     */
+    bool parse(std::string_view text, ParseError* error = nullptr);
+
+private:
+    std::pmr::monotonic_buffer_resource arena_;
+    Value root_;
+};
+
+/**
+ * SAX event sink; returning false from any callback stops the parse
+ */
+class Handler {
+public:
+    virtual ~Handler() = default;
+
+    virtual bool onNull() = 0;
+    virtual bool onBool(bool value) = 0;
+    virtual bool onInteger(int64_t value) = 0;
+    virtual bool onDouble(double value) = 0;
+    virtual bool onString(std::string_view value) = 0;
+    virtual bool onStartObject() = 0;
+    virtual bool onKey(std::string_view key) = 0;
+    virtual bool onEndObject() = 0;
+    virtual bool onStartArray() = 0;
+    virtual bool onEndArray() = 0;
+};
+
+constexpr size_t MAX_PARSE_DEPTH = 512;
+
+/**
+ * Streams RFC 8259 text into handler without building a tree. String views
+ * passed to the handler are only valid during the callback. Integers that
+ * do not fit int64_t are reported as doubles; numbers beyond the range of
+ * double, and strings that are not well-formed UTF-8, fail the parse.
+ */
+bool parse(std::string_view text, Handler& handler, ParseError* error = nullptr);
+
+/**
+ * Parses into a tree allocated from resource; nullopt on malformed input
+ */
+std::optional<Value> parse(std::string_view text, ParseError* error = nullptr,
+                           std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+struct WriteOptions {
+    int indent = -1;            // Negative writes compact text
+    bool sortKeys = false;      // Emit object members ordered by key
+};
+
+/**
+ * Streaming writer that appends to a string
+ *
+ * Tracks commas and indentation so callers only emit structure. Non-finite
+ * doubles are written as null. sortKeys applies to value() only.
+ */
+class Writer {
+public:
+    explicit Writer(std::string& out, const WriteOptions& options = {});
+
+    void null();
+    void boolean(bool value);
+    void integer(int64_t value);
+    void number(double value);
+    void string(std::string_view value);
+    void startObject();
+    void key(std::string_view key);
+    void endObject();
+    void startArray();
+    void endArray();
+
+    void value(const Value& value);
+
+private:
+    void beforeValue();
+    void newline();
+    void close(char bracket);
+
+    std::string& out_;
+    WriteOptions options_;
+    std::vector<bool> hasElements_;     // Per open container
+    bool afterKey_ = false;
+};
+
+std::string write(const Value& value, const WriteOptions& options = {});
+void write(const Value& value, std::string& out, const WriteOptions& options = {});
+
+} // namespace json
+
+/**
+ * Document model used for action arguments, plugin payloads, knowledge and
+ * character exports
+ */
+using JsonValue = json::Value;
+
+} // namespace elizaos
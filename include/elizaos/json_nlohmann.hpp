@@ -0,0 +1,97 @@
+#pragma once
+
+#include "elizaos/json.hpp"
+#include <nlohmann/json.hpp>
+#include <limits>
+
+namespace elizaos {
+namespace json {
+
+/**
+ * Conversions between json::Value and nlohmann::basic_json. Header-only, so
+ * only modules that already link nlohmann_json pay for it. Works with both
+ * nlohmann::json and nlohmann::ordered_json.
+ */
+template <typename BasicJson = nlohmann::json>
+BasicJson toNlohmann(const Value& value) {
+    switch (value.type()) {
+        case Type::NUL:
+            return BasicJson(nullptr);
+        case Type::BOOLEAN:
+            return BasicJson(value.asBool());
+        case Type::INTEGER:
+            return BasicJson(value.asInt());
+        case Type::DOUBLE:
+            return BasicJson(value.asDouble());
+        case Type::STRING:
+            return BasicJson(std::string(value.asString()));
+        case Type::ARRAY: {
+            BasicJson result = BasicJson::array();
+            for (const auto& element : value.asArray()) {
+                result.push_back(toNlohmann<BasicJson>(element));
+            }
+            return result;
+        }
+        case Type::OBJECT: {
+            BasicJson result = BasicJson::object();
+            for (const auto& member : value.asObject()) {
+                result[std::string(member.key)] = toNlohmann<BasicJson>(member.value);
+            }
+            return result;
+        }
+    }
+    return BasicJson();
+}
+
+template <typename BasicJson>
+Value fromNlohmann(const BasicJson& source, std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    switch (source.type()) {
+        case nlohmann::json::value_t::null:
+        case nlohmann::json::value_t::discarded:
+            return Value(resource);
+        case nlohmann::json::value_t::boolean:
+            return Value(source.template get<bool>());
+        case nlohmann::json::value_t::number_integer:
+            return Value(source.template get<int64_t>());
+        case nlohmann::json::value_t::number_unsigned: {
+            uint64_t number = source.template get<uint64_t>();
+            if (number > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                return Value(static_cast<double>(number));
+            }
+            return Value(static_cast<int64_t>(number));
+        }
+        case nlohmann::json::value_t::number_float:
+            return Value(source.template get<double>());
+        case nlohmann::json::value_t::string:
+            return Value(source.template get_ref<const typename BasicJson::string_t&>(), resource);
+        case nlohmann::json::value_t::array: {
+            Value result = Value::array(resource);
+            result.asArray().reserve(source.size());
+            for (const auto& element : source) {
+                result.push_back(fromNlohmann(element, resource));
+            }
+            return result;
+        }
+        case nlohmann::json::value_t::object: {
+            Value result = Value::object(resource);
+            result.asObject().reserve(source.size());
+            for (auto it = source.begin(); it != source.end(); ++it) {
+                // Keys are unique already, so append instead of looking up
+                Value& slot = result.asObject().emplace_back(it.key(), Value(resource), resource).value;
+                slot = fromNlohmann(it.value(), resource);
+            }
+            return result;
+        }
+        case nlohmann::json::value_t::binary: {
+            Value result = Value::array(resource);
+            for (uint8_t byte : source.get_binary()) {
+                result.push_back(Value(static_cast<int64_t>(byte)));
+            }
+            return result;
+        }
+    }
+    return Value(resource);
+}
+
+} // namespace json
+} // namespace elizaos
@@ -3,7 +3,7 @@
 #include "elizaos/core.hpp"
 #include "elizaos/agentmemory.hpp"
 #include "elizaos/agentlogger.hpp"
-#include "elizaos/agentaction.hpp"  // For JsonValue definition
+#include "elizaos/json.hpp"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -108,7 +108,7 @@ private:
 };
 
 // Main knowledge base class
-class KnowledgeBase {
+class KnowledgeBase : public Snapshottable {
 public:
     KnowledgeBase();
     ~KnowledgeBase();
@@ -150,6 +150,12 @@ public:
     std::string getStatistics() const;
     void clear();
     
+    // Snapshot support; entries are captured from the backing memory store
+    std::string getSnapshotName() const override { return "knowledge"; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
+    
 private:
     std::shared_ptr<AgentMemoryManager> memory_;
     std::shared_ptr<AgentLogger> logger_;
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * How close the process is to its memory budget
+ */
+enum class MemoryPressure : uint8_t {
+    NONE = 0,
+    MODERATE = 1,       // LOW priority caches are shrunk
+    HIGH = 2,           // NORMAL priority caches are shrunk as well
+    CRITICAL = 3        // Every registered cache is shrunk
+};
+
+/**
+ * Order in which caches give memory back; LOW goes first
+ */
+enum class CachePriority : uint8_t {
+    LOW = 0,
+    NORMAL = 1,
+    HIGH = 2
+};
+
+/**
+ * In-memory structure whose size the governor accounts and can reduce
+ *
+ * getAccountedBytes() is polled from the governor's thread, so it should be
+ * cheap, ideally a running estimate kept as entries come and go.
+ * shrinkMemory() drops the least valuable entries first and returns about
+ * how many bytes it released. Both are called with the governor's lock held
+ * and must not call back into the governor.
+ */
+class MemoryConsumer {
+public:
+    virtual ~MemoryConsumer() = default;
+
+    virtual std::string getConsumerName() const = 0;
+    virtual size_t getAccountedBytes() const = 0;
+    virtual size_t shrinkMemory(size_t bytes) = 0;
+};
+
+/**
+ * Memory budget and the usage ratios at which each pressure level starts
+ *
+ * Shedding aims to bring usage back under moderateRatio. Each pass asks a
+ * cache for at most a fraction of its own size, an eighth under MODERATE
+ * up to half under CRITICAL, so caches shrink progressively over several
+ * polls instead of being emptied at the first spike.
+ */
+struct MemoryBudgetConfig {
+    size_t budgetBytes = 0;                         // 0: the cgroup limit, else physical memory
+    double moderateRatio = 0.70;
+    double highRatio = 0.85;
+    double criticalRatio = 0.95;
+    std::chrono::milliseconds pollInterval{1000};
+};
+
+/**
+ * One registered consumer as the governor last saw it
+ */
+struct MemoryConsumerUsage {
+    std::string name;
+    CachePriority priority = CachePriority::NORMAL;
+    size_t accountedBytes = 0;
+    size_t reclaimedBytes = 0;                      // Released by shrinking since registration
+};
+
+/**
+ * Process-wide memory accounting and pressure-driven cache shedding
+ *
+ * Compares resident set size against a budget and, once usage crosses a
+ * pressure threshold, shrinks registered caches in priority order, largest
+ * first within a priority. Consumers are not owned; components that can
+ * register with the global governor unregister themselves on destruction.
+ */
+class MemoryGovernor {
+public:
+    MemoryGovernor() = default;
+    ~MemoryGovernor();
+    MemoryGovernor(const MemoryGovernor&) = delete;
+    MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+    static MemoryGovernor& global();
+
+    void configure(const MemoryBudgetConfig& config);
+    MemoryBudgetConfig getConfig() const;
+
+    /**
+     * Re-registering a consumer only changes its priority. Unregistering
+     * waits for a shrinkMemory() call already running on the consumer.
+     */
+    void registerConsumer(MemoryConsumer& consumer, CachePriority priority = CachePriority::NORMAL);
+    bool unregisterConsumer(const MemoryConsumer& consumer);
+
+    /**
+     * Samples resident memory, updates the pressure level and sheds caches
+     */
+    MemoryPressure evaluate();
+
+    /**
+     * Same with usage measured elsewhere, e.g. a cgroup's memory.current
+     */
+    MemoryPressure evaluate(size_t usedBytes);
+
+    /**
+     * Polls evaluate() on a background thread every pollInterval
+     */
+    void start();
+    void stop();
+    bool isRunning() const;
+
+    MemoryPressure getPressure() const;
+    size_t getBudgetBytes() const;
+    size_t getUsedBytes() const;
+    size_t getAccountedBytes() const;
+    std::vector<MemoryConsumerUsage> getUsage() const;
+
+    static size_t readResidentBytes();
+    static std::optional<size_t> readCgroupLimit();
+    static size_t readPhysicalBytes();
+
+private:
+    struct Registration {
+        MemoryConsumer* consumer;
+        CachePriority priority;
+        size_t reclaimedBytes = 0;
+    };
+
+    struct ActiveShrink {
+        const MemoryConsumer* consumer;
+        std::thread::id thread;
+    };
+
+    size_t budgetLocked() const;
+    Registration* findLocked(const MemoryConsumer& consumer);
+    size_t shed(MemoryPressure pressure, size_t excess);
+
+    mutable std::mutex mutex_;
+    MemoryBudgetConfig config_;
+    mutable std::optional<size_t> detectedBudget_;          // Cached; limits rarely change
+    std::vector<Registration> consumers_;
+    MemoryPressure pressure_ = MemoryPressure::NONE;
+    size_t usedBytes_ = 0;
+    std::vector<ActiveShrink> shrinking_;                   // Consumers are shrunk without mutex_ held
+    std::condition_variable shrinkDone_;
+
+    mutable std::mutex threadMutex_;
+    std::condition_variable wake_;
+    std::thread thread_;
+    bool running_ = false;
+};
+
+const char* memoryPressureName(MemoryPressure pressure);
+
+} // namespace elizaos
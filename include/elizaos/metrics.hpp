@@ -0,0 +1,334 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace elizaos {
+
+constexpr size_t METRIC_SHARDS = 16;
+
+namespace detail {
+
+size_t assignMetricShard();
+
+// Stable per-thread shard, so concurrent recorders rarely share a cache line
+inline size_t metricShard() {
+    static thread_local size_t shard = assignMetricShard();
+    return shard;
+}
+
+} // namespace detail
+
+inline uint64_t monotonicNanos() {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+}
+
+/**
+ * Monotonic counter sharded across cache lines
+ */
+class Counter {
+public:
+    void increment(uint64_t amount = 1) {
+        shards_[detail::metricShard()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+    Shard shards_[METRIC_SHARDS];
+};
+
+/**
+ * Point-in-time value such as a queue depth
+ */
+class Gauge {
+public:
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    void increment(int64_t amount = 1) { value_.fetch_add(amount, std::memory_order_relaxed); }
+    void decrement(int64_t amount = 1) { value_.fetch_sub(amount, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+/**
+ * Merged view of a histogram at one instant
+ */
+struct HistogramSnapshot {
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    std::vector<uint64_t> buckets;   // Indexed like Histogram::bucketFor
+
+    double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+
+    /**
+     * Upper bound of the bucket holding the q-quantile (0 <= q <= 1), clamped
+     * to the observed range. Relative error is at most 1 / 2^SUB_BUCKET_BITS.
+     */
+    uint64_t percentile(double q) const;
+};
+
+/**
+ * Log-bucketed (HDR-style) histogram of unsigned values
+ *
+ * Each power of two is split into 2^SUB_BUCKET_BITS linear sub-buckets, so
+ * the whole uint64_t range fits in a few hundred buckets at a bounded
+ * relative error. Each thread records into its own lazily allocated shard;
+ * shards are merged only when a snapshot is taken.
+ */
+class Histogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    Histogram() = default;
+    ~Histogram();
+    Histogram(const Histogram&) = delete;
+    Histogram& operator=(const Histogram&) = delete;
+
+    void record(uint64_t value) {
+        Shard* shard = shards_[detail::metricShard()].load(std::memory_order_acquire);
+        if (!shard) shard = allocateShard(detail::metricShard());
+        shard->buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+        shard->sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t seen = shard->max.load(std::memory_order_relaxed);
+        while (value > seen && !shard->max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+        seen = shard->min.load(std::memory_order_relaxed);
+        while (value < seen && !shard->min.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+    }
+
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucketFor(uint64_t value) {
+        if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+        int exponent = 63 - leadingZeros(value);
+        size_t sub = static_cast<size_t>(value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>(exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t bucketLowerBound(size_t bucket);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    struct Shard {
+        std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+        std::atomic<uint64_t> sum{0};
+        std::atomic<uint64_t> min{UINT64_MAX};
+        std::atomic<uint64_t> max{0};
+    };
+
+    static int leadingZeros(uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_clzll(value);
+#else
+        int zeros = 0;
+        for (uint64_t bit = uint64_t(1) << 63; bit && !(value & bit); bit >>= 1) zeros++;
+        return zeros;
+#endif
+    }
+
+    Shard* allocateShard(size_t index);
+
+    std::atomic<Shard*> shards_[METRIC_SHARDS] = {};
+};
+
+/**
+ * Records the lifetime of a scope into a histogram, in nanoseconds
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Histogram& histogram) : histogram_(histogram), start_(monotonicNanos()) {}
+    ~ScopedTimer() { histogram_.record(monotonicNanos() - start_); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Histogram& histogram_;
+    uint64_t start_;
+};
+
+/**
+ * Completed trace span
+ */
+struct SpanRecord {
+    uint64_t id = 0;
+    uint64_t parentId = 0;          // 0 for a root span
+    const char* name = "";
+    uint64_t startNanos = 0;        // monotonicNanos() at entry
+    uint64_t durationNanos = 0;
+    uint64_t threadShard = 0;
+};
+
+/**
+ * Lock-free ring of recently completed spans
+ *
+ * Writers claim a slot with one fetch_add and publish it with a sequence
+ * number; the oldest spans are overwritten once the ring is full. Readers
+ * skip slots that are being rewritten while they copy.
+ */
+class Tracer {
+public:
+    explicit Tracer(size_t capacity = 4096);
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    static Tracer& global();
+
+    void record(const SpanRecord& span);
+
+    /**
+     * Returns up to maxSpans of the most recent spans, oldest first
+     */
+    std::vector<SpanRecord> collect(size_t maxSpans = SIZE_MAX) const;
+
+    uint64_t nextSpanId() { return nextId_.fetch_add(1, std::memory_order_relaxed); }
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    size_t getCapacity() const { return capacity_; }
+    uint64_t getRecordedCount() const { return head_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> id{0};
+        std::atomic<uint64_t> parentId{0};
+        std::atomic<const char*> name{""};
+        std::atomic<uint64_t> startNanos{0};
+        std::atomic<uint64_t> durationNanos{0};
+        std::atomic<uint64_t> threadShard{0};
+    };
+
+    size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<uint64_t> head_{0};
+    std::atomic<uint64_t> nextId_{1};
+    std::atomic<bool> enabled_{true};
+};
+
+/**
+ * RAII trace span
+ *
+ * Spans nest per thread: a span opened while another is active on the same
+ * thread records it as its parent. The name must outlive the tracer (string
+ * literals are the intended use). When a histogram is given the span's
+ * duration is recorded into it as well, even if tracing is disabled.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, Histogram* latency = nullptr, Tracer& tracer = Tracer::global());
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    uint64_t getId() const { return id_; }
+    uint64_t getParentId() const { return parentId_; }
+
+    static uint64_t currentSpanId();
+
+private:
+    Tracer& tracer_;
+    Histogram* latency_;
+    const char* name_;
+    uint64_t id_ = 0;
+    uint64_t parentId_ = 0;
+    uint64_t start_;
+};
+
+enum class MetricType {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+using MetricLabels = std::vector<std::pair<std::string, std::string>>;
+
+/**
+ * One exported series
+ */
+struct MetricSample {
+    MetricType type = MetricType::COUNTER;
+    std::string name;
+    std::string help;
+    MetricLabels labels;
+    int64_t value = 0;              // Counters and gauges
+    double scale = 1.0;             // Histograms: multiplier applied on export
+    HistogramSnapshot histogram;
+};
+
+struct MetricsSnapshot {
+    std::vector<MetricSample> samples;
+
+    const MetricSample* find(const std::string& name, const MetricLabels& labels = {}) const;
+};
+
+/**
+ * Named metrics with Prometheus and binary export
+ *
+ * Registration takes a lock and returns a reference that stays valid for the
+ * registry's lifetime, so hot paths look a metric up once and keep it.
+ * Registering an existing name and label set returns the same metric;
+ * reusing a name with a different type throws std::invalid_argument.
+ */
+class MetricsRegistry {
+public:
+    MetricsRegistry();
+    ~MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    static MetricsRegistry& global();
+
+    Counter& counter(const std::string& name, const std::string& help = "", const MetricLabels& labels = {});
+    Gauge& gauge(const std::string& name, const std::string& help = "", const MetricLabels& labels = {});
+
+    /**
+     * scale converts recorded units to exported ones, e.g. 1e-9 for a
+     * *_seconds histogram fed with nanoseconds
+     */
+    Histogram& histogram(const std::string& name, const std::string& help = "", const MetricLabels& labels = {},
+                         double scale = 1.0);
+
+    MetricsSnapshot snapshot() const;
+    size_t getMetricCount() const;
+
+    std::string exportPrometheus() const { return formatPrometheus(snapshot()); }
+    std::vector<uint8_t> exportBinary() const { return encodeBinary(snapshot()); }
+
+    /**
+     * Prometheus text exposition format 0.0.4; histograms are exported as
+     * summaries with 0.5/0.9/0.99/0.999 quantiles
+     */
+    static std::string formatPrometheus(const MetricsSnapshot& snapshot);
+
+    /**
+     * Compact varint encoding without help texts; decodeBinary returns
+     * nullopt for malformed input
+     */
+    static std::vector<uint8_t> encodeBinary(const MetricsSnapshot& snapshot);
+    static std::optional<MetricsSnapshot> decodeBinary(const std::vector<uint8_t>& data);
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace elizaos
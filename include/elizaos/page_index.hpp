@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Indexed page, keyed by its canonical URL
+ */
+struct PageVisit {
+    std::string url;                    // Canonical form
+    std::string purpose;                // Most recent purpose
+    uint64_t simHash = 0;               // Of the page text, when known
+    bool hasFingerprint = false;
+    uint32_t visits = 0;
+    std::chrono::system_clock::time_point firstVisit;
+    std::chrono::system_clock::time_point lastVisit;
+    std::optional<std::string> duplicateOf;   // Earlier page with near-identical text
+};
+
+/**
+ * Visited-page index for crawling agents
+ *
+ * Pages are keyed by canonical URL, so tracking parameters, fragments,
+ * default ports and case differences in scheme and host are the same page.
+ * Page text is reduced to a 64-bit SimHash of its words; fingerprints
+ * are split into maxDistance + 1 bands and each band is hashed, so any two
+ * pages within maxDistance bits share a bucket in at least one band and a
+ * near-duplicate lookup only compares the few pages found there; larger
+ * distances mean shorter band keys and fuller buckets. Purposes
+ * are indexed by term over distinct purpose strings and ranked by IDF
+ * weighted cosine, so recall cost follows the number of distinct purposes
+ * rather than visits.
+ */
+class PageIndex {
+public:
+    explicit PageIndex(int maxDistance = 3);
+
+    /**
+     * Records a visit and returns the page as now indexed. Empty pageText
+     * keeps any fingerprint from an earlier visit
+     */
+    PageVisit recordVisit(const std::string& url, const std::string& purpose, std::string_view pageText = {});
+
+    bool hasVisited(const std::string& url) const;
+    std::optional<PageVisit> getVisit(const std::string& url) const;
+
+    /**
+     * Canonical URLs of indexed pages whose text fingerprint is within
+     * maxDistance bits, closest first
+     */
+    std::vector<std::string> findNearDuplicates(std::string_view pageText, size_t limit = 10) const;
+    std::vector<std::string> findNearDuplicates(uint64_t simHash, size_t limit = 10) const;
+
+    /**
+     * Canonical URLs of pages remembered for the purposes most similar to
+     * purpose, most recently associated first within a purpose
+     */
+    std::vector<std::string> findByPurpose(const std::string& purpose, size_t limit = 10) const;
+
+    size_t size() const;
+    void clear();
+
+    static uint64_t fingerprint(std::string_view text);
+    static int hammingDistance(uint64_t a, uint64_t b);
+
+    /**
+     * Lowercases scheme and host, drops fragments, default ports and
+     * utm_/click-id tracking parameters, sorts the query, resolves
+     * dot segments and normalizes percent-escapes. Strings without a
+     * scheme://host are returned trimmed
+     */
+    static std::string normalizeUrl(std::string_view url);
+
+private:
+    struct Page {
+        PageVisit visit;
+        std::vector<uint32_t> purposes;
+    };
+
+    struct Purpose {
+        std::string text;
+        std::vector<uint32_t> terms;
+        std::vector<uint32_t> pages;
+    };
+
+    uint64_t bandKey(uint64_t simHash, size_t band) const;
+    void insertFingerprint(uint32_t page);
+    void eraseFingerprint(uint32_t page);
+    uint32_t internPurpose(const std::string& purpose);
+    std::vector<std::string> nearDuplicates(uint64_t simHash, size_t limit, uint32_t exclude) const;
+
+    const int maxDistance_;
+    std::vector<std::pair<int, int>> bands_;     // {shift, width}
+
+    mutable std::mutex mutex_;
+    std::vector<Page> pages_;
+    std::unordered_map<std::string, uint32_t> pageIds_;
+    std::vector<std::unordered_map<uint64_t, std::vector<uint32_t>>> buckets_;
+
+    std::vector<Purpose> purposes_;
+    std::unordered_map<std::string, uint32_t> purposeIds_;
+    std::unordered_map<std::string, uint32_t> termIds_;
+    std::vector<std::vector<uint32_t>> termPurposes_;
+};
+
+} // namespace elizaos
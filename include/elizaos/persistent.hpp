@@ -0,0 +1,267 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Immutable vector with structural sharing
+ *
+ * A 32-way trie of fixed-size leaves plus a separate tail leaf, as in
+ * Clojure's vector: pushBack copies the tail, or at most one path of the
+ * trie when the tail is full, and shares everything else with the original.
+ * Copies are a few reference-count increments, so a version handed to a
+ * reader stays valid and unchanged without locking while writers derive new
+ * versions from it. Iterators share ownership of the nodes they walk, so
+ * they stay valid after the vector they came from is gone.
+ */
+template <typename T>
+class PersistentVector {
+    static constexpr unsigned BITS = 5;
+    static constexpr size_t WIDTH = size_t(1) << BITS;
+    static constexpr size_t MASK = WIDTH - 1;
+
+    struct Node {
+        std::vector<std::shared_ptr<const Node>> children;     // Interior nodes
+        std::vector<T> values;                                  // Leaves
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using const_reference = const T&;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator() = default;
+        const_iterator(const PersistentVector& vector, size_t index)
+            : root_(vector.root_), tail_(vector.tail_), tailOffset_(vector.tailOffset()), shift_(vector.shift_),
+              index_(index) {}
+
+        reference operator*() const {
+            // Leaves are contiguous, so only the first element of each one
+            // needs a trie walk
+            if (!leaf_ || index_ < leafStart_ || index_ >= leafStart_ + leaf_->size()) {
+                leaf_ = &leafFor(root_, tail_, tailOffset_, shift_, index_);
+                leafStart_ = index_ & ~MASK;
+            }
+            return (*leaf_)[index_ - leafStart_];
+        }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        const_iterator& operator++() { ++index_; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index_; return copy; }
+        const_iterator& operator--() { --index_; return *this; }
+        const_iterator operator--(int) { const_iterator copy = *this; --index_; return copy; }
+        const_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        const_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+        friend const_iterator operator+(const_iterator it, difference_type n) { return it += n; }
+        friend const_iterator operator+(difference_type n, const_iterator it) { return it += n; }
+        friend const_iterator operator-(const_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const const_iterator& a, const const_iterator& b) {
+            return static_cast<difference_type>(a.index_) - static_cast<difference_type>(b.index_);
+        }
+
+        friend bool operator==(const const_iterator& a, const const_iterator& b) { return a.index_ == b.index_; }
+        friend bool operator!=(const const_iterator& a, const const_iterator& b) { return a.index_ != b.index_; }
+        friend bool operator<(const const_iterator& a, const const_iterator& b) { return a.index_ < b.index_; }
+        friend bool operator>(const const_iterator& a, const const_iterator& b) { return a.index_ > b.index_; }
+        friend bool operator<=(const const_iterator& a, const const_iterator& b) { return a.index_ <= b.index_; }
+        friend bool operator>=(const const_iterator& a, const const_iterator& b) { return a.index_ >= b.index_; }
+
+    private:
+        NodePtr root_;
+        NodePtr tail_;
+        size_t tailOffset_ = 0;
+        unsigned shift_ = BITS;
+        size_t index_ = 0;
+        mutable const std::vector<T>* leaf_ = nullptr;
+        mutable size_t leafStart_ = 0;
+    };
+    using iterator = const_iterator;
+
+    PersistentVector() = default;
+    PersistentVector(std::initializer_list<T> values) {
+        for (const auto& value : values) *this = pushBack(value);
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    const T& operator[](size_t index) const {
+        // Every leaf, the tail included, starts at a multiple of WIDTH
+        return leafFor(root_, tail_, tailOffset(), shift_, index)[index & MASK];
+    }
+
+    const T& at(size_t index) const {
+        if (index >= size_) throw std::out_of_range("PersistentVector::at");
+        return (*this)[index];
+    }
+
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size_ - 1]; }
+
+    const_iterator begin() const { return const_iterator(*this, 0); }
+    const_iterator end() const { return const_iterator(*this, size_); }
+
+    /**
+     * New version with value appended; this one is unchanged
+     */
+    PersistentVector pushBack(T value) const {
+        PersistentVector next = *this;
+        auto tail = std::make_shared<Node>();
+        if (tail_ && tail_->values.size() < WIDTH) {
+            tail->values.reserve(tail_->values.size() + 1);
+            tail->values.assign(tail_->values.begin(), tail_->values.end());
+        } else if (tail_) {
+            // Full tail moves into the trie, growing a level when the root is full
+            if ((size_ >> BITS) > (size_t(1) << next.shift_)) {
+                auto root = std::make_shared<Node>();
+                root->children.push_back(root_);
+                root->children.push_back(newPath(next.shift_, tail_));
+                next.root_ = std::move(root);
+                next.shift_ += BITS;
+            } else {
+                next.root_ = pushTail(next.shift_, root_, tail_);
+            }
+            tail->values.reserve(WIDTH);
+        }
+        tail->values.push_back(std::move(value));
+        next.tail_ = std::move(tail);
+        next.size_++;
+        return next;
+    }
+
+    /**
+     * New version with the element at index replaced
+     */
+    PersistentVector set(size_t index, T value) const {
+        if (index >= size_) throw std::out_of_range("PersistentVector::set");
+        PersistentVector next = *this;
+        if (index >= tailOffset()) {
+            auto tail = std::make_shared<Node>(*tail_);
+            tail->values[index - tailOffset()] = std::move(value);
+            next.tail_ = std::move(tail);
+        } else {
+            next.root_ = assign(shift_, root_, index, std::move(value));
+        }
+        return next;
+    }
+
+    std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+private:
+    size_t tailOffset() const { return size_ < WIDTH ? 0 : ((size_ - 1) >> BITS) << BITS; }
+
+    static const std::vector<T>& leafFor(const NodePtr& root, const NodePtr& tail, size_t tailOffset, unsigned shift,
+                                         size_t index) {
+        if (index >= tailOffset) return tail->values;
+        const Node* node = root.get();
+        for (unsigned level = shift; level > 0; level -= BITS) {
+            node = node->children[(index >> level) & MASK].get();
+        }
+        return node->values;
+    }
+
+    static NodePtr newPath(unsigned level, NodePtr leaf) {
+        if (level == 0) return leaf;
+        auto node = std::make_shared<Node>();
+        node->children.push_back(newPath(level - BITS, std::move(leaf)));
+        return node;
+    }
+
+    NodePtr pushTail(unsigned level, const NodePtr& parent, NodePtr leaf) const {
+        auto node = parent ? std::make_shared<Node>(*parent) : std::make_shared<Node>();
+        size_t child = ((size_ - 1) >> level) & MASK;
+        if (level == BITS) {
+            node->children.push_back(std::move(leaf));
+        } else if (child < node->children.size()) {
+            node->children[child] = pushTail(level - BITS, node->children[child], std::move(leaf));
+        } else {
+            node->children.push_back(newPath(level - BITS, std::move(leaf)));
+        }
+        return node;
+    }
+
+    static NodePtr assign(unsigned level, const NodePtr& node, size_t index, T value) {
+        auto copy = std::make_shared<Node>(*node);
+        if (level == 0) {
+            copy->values[index & MASK] = std::move(value);
+        } else {
+            size_t child = (index >> level) & MASK;
+            copy->children[child] = assign(level - BITS, node->children[child], index, std::move(value));
+        }
+        return copy;
+    }
+
+    NodePtr root_;          // Levels above the leaves; null until the first tail is pushed down
+    NodePtr tail_;          // Last leaf, never in the trie
+    size_t size_ = 0;
+    unsigned shift_ = BITS;
+};
+
+/**
+ * Immutable fixed-capacity window over the latest values pushed
+ *
+ * Pushing past capacity drops the oldest value. Dropped values stay
+ * referenced until the window has advanced a whole capacity, when it is
+ * rebuilt, so a push costs amortized O(1) and at most 2 * capacity values
+ * are held.
+ */
+template <typename T>
+class PersistentRing {
+public:
+    using value_type = T;
+    using size_type = size_t;
+    using const_iterator = typename PersistentVector<T>::const_iterator;
+    using iterator = const_iterator;
+
+    explicit PersistentRing(size_t capacity = 32) : capacity_(capacity) {}
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return items_.size() - start_; }
+    bool empty() const { return size() == 0; }
+
+    const T& operator[](size_t index) const { return items_[start_ + index]; }
+    const T& front() const { return items_[start_]; }
+    const T& back() const { return items_.back(); }
+
+    const_iterator begin() const { return items_.begin() + static_cast<std::ptrdiff_t>(start_); }
+    const_iterator end() const { return items_.end(); }
+
+    PersistentRing pushBack(T value) const {
+        PersistentRing next = *this;
+        next.items_ = items_.pushBack(std::move(value));
+        if (next.size() > capacity_) next.start_++;
+        if (next.start_ >= capacity_) {
+            PersistentVector<T> window;
+            for (auto it = next.begin(); it != next.end(); ++it) window = window.pushBack(*it);
+            next.items_ = std::move(window);
+            next.start_ = 0;
+        }
+        return next;
+    }
+
+    std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+private:
+    PersistentVector<T> items_;
+    size_t start_ = 0;
+    size_t capacity_;
+};
+
+} // namespace elizaos
@@ -10,17 +10,17 @@
 #include <mutex>
 #include <chrono>
 #include "core.hpp"
+#include "json.hpp"
 #include "agentmemory.hpp"
 
 namespace elizaos {
 
-// JsonValue type definition (compatible with other modules)
-using JsonValue = std::unordered_map<std::string, std::any>;
-
 // Forward declarations
 class PluginInterface;
 class PluginManager;
 class PluginRegistry;
+class Histogram;
+class Counter;
 
 /**
  * Plugin version information
@@ -355,6 +355,15 @@ private:
     std::unordered_map<std::string, size_t> executionCounts_;
     std::unordered_map<std::string, std::chrono::milliseconds> executionTimes_;
     std::unordered_map<std::string, size_t> errorCounts_;
+    
+    // Metric handles resolved once per plugin rather than looked up in the
+    // global registry on every dispatch
+    struct PluginMetrics {
+        Histogram& latency;
+        Counter& errors;
+    };
+    std::unordered_map<std::string, PluginMetrics> pluginMetrics_;
+    PluginMetrics& metricsFor(const std::string& pluginName);  // Requires managerMutex_
 };
 
 /**
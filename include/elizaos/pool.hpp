@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace elizaos {
+
+constexpr size_t SLAB_BYTES = 64 * 1024;
+constexpr size_t POOL_GRANULARITY = 16;          // Block sizes and alignment
+constexpr size_t MAX_POOLED_BYTES = 1024;        // Larger requests go to operator new
+
+/**
+ * Fixed-size block pool with per-thread caches
+ *
+ * Blocks are carved from 64 KiB slabs. Every thread keeps its own free list
+ * per pool and only takes the pool lock to move a batch of blocks between
+ * that list and the shared one, so steady-state allocate/free pairs never
+ * contend. Blocks may be freed on any thread. Slabs stay mapped for the
+ * life of the process and are reused, which keeps long-running agents from
+ * fragmenting the general heap.
+ */
+class SlabPool {
+public:
+    /**
+     * Pool for blocks of at least bytes (1..MAX_POOLED_BYTES), one per
+     * POOL_GRANULARITY size class
+     */
+    static SlabPool& forSize(size_t bytes);
+
+    void* allocate();
+    void deallocate(void* block) noexcept;
+
+    size_t getBlockSize() const { return blockSize_; }
+    size_t getSlabCount() const;
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    /**
+     * Per-thread free list for one pool
+     */
+    struct Cache {
+        FreeBlock* head = nullptr;
+        size_t count = 0;
+    };
+
+private:
+    SlabPool(size_t index, size_t blockSize);
+
+    Cache& threadCache();
+    void refill(Cache& cache);
+    void drain(Cache& cache, size_t keep) noexcept;
+    friend struct PoolThreadCaches;
+
+    const size_t index_;
+    const size_t blockSize_;
+    const size_t batch_;                // Blocks moved per refill or drain
+    mutable std::mutex mutex_;
+    FreeBlock* shared_ = nullptr;       // Blocks drained by threads
+    size_t sharedCount_ = 0;
+    char* carve_ = nullptr;             // Unused tail of the newest slab
+    char* carveEnd_ = nullptr;
+    std::vector<void*> slabs_;
+};
+
+/**
+ * Pooled allocation for any size; falls back to operator new above
+ * MAX_POOLED_BYTES. deallocate must be given the size passed to allocate.
+ */
+void* poolAllocate(size_t bytes);
+void poolDeallocate(void* block, size_t bytes) noexcept;
+
+/**
+ * Standard allocator over the slab pools
+ *
+ * Use with std::allocate_shared to put an object and its control block in
+ * one pooled block, or with node-based containers.
+ */
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        if (count > std::numeric_limits<size_t>::max() / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        if constexpr (alignof(T) > POOL_GRANULARITY) {
+            return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            return static_cast<T*>(poolAllocate(count * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* block, size_t count) noexcept {
+        if constexpr (alignof(T) > POOL_GRANULARITY) {
+            ::operator delete(block, std::align_val_t(alignof(T)));
+        } else {
+            poolDeallocate(block, count * sizeof(T));
+        }
+    }
+
+    template <typename U>
+    friend bool operator==(const PoolAllocator&, const PoolAllocator<U>&) noexcept { return true; }
+    template <typename U>
+    friend bool operator!=(const PoolAllocator&, const PoolAllocator<U>&) noexcept { return false; }
+};
+
+template <typename T>
+class IntrusivePtr;
+
+/**
+ * Base for intrusively reference-counted objects (CRTP)
+ *
+ * The count lives in the object, so an IntrusivePtr is one pointer wide
+ * and needs no separate control block. Instances are allocated from the
+ * slab pools. When the last reference drops, the object is deleted as a T,
+ * so deleting through a base pointer requires a virtual destructor in T.
+ */
+template <typename T>
+class RefCounted {
+public:
+    static void* operator new(size_t bytes) { return poolAllocate(bytes); }
+    static void operator delete(void* block, size_t bytes) noexcept { poolDeallocate(block, bytes); }
+
+    uint32_t getRefCount() const { return refs_.load(std::memory_order_relaxed); }
+
+protected:
+    RefCounted() = default;
+    RefCounted(const RefCounted&) noexcept {}       // Copies start unreferenced
+    RefCounted& operator=(const RefCounted&) noexcept { return *this; }
+    ~RefCounted() = default;
+
+private:
+    template <typename U>
+    friend class IntrusivePtr;
+
+    void addRef() const noexcept { refs_.fetch_add(1, std::memory_order_relaxed); }
+    void release() const noexcept {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete static_cast<const T*>(this);
+        }
+    }
+
+    mutable std::atomic<uint32_t> refs_{0};
+};
+
+template <typename T>
+class IntrusivePtr {
+public:
+    IntrusivePtr() noexcept = default;
+    IntrusivePtr(std::nullptr_t) noexcept {}
+    explicit IntrusivePtr(T* object) noexcept : object_(object) {
+        if (object_) object_->addRef();
+    }
+    IntrusivePtr(const IntrusivePtr& other) noexcept : IntrusivePtr(other.object_) {}
+    IntrusivePtr(IntrusivePtr&& other) noexcept : object_(std::exchange(other.object_, nullptr)) {}
+    template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+    IntrusivePtr(const IntrusivePtr<U>& other) noexcept : IntrusivePtr(other.get()) {}
+    ~IntrusivePtr() {
+        if (object_) object_->release();
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr other) noexcept {
+        std::swap(object_, other.object_);
+        return *this;
+    }
+
+    void reset() noexcept { IntrusivePtr().swap(*this); }
+    void swap(IntrusivePtr& other) noexcept { std::swap(object_, other.object_); }
+
+    T* get() const noexcept { return object_; }
+    T& operator*() const noexcept { return *object_; }
+    T* operator->() const noexcept { return object_; }
+    explicit operator bool() const noexcept { return object_ != nullptr; }
+
+    friend bool operator==(const IntrusivePtr& a, const IntrusivePtr& b) { return a.object_ == b.object_; }
+    friend bool operator!=(const IntrusivePtr& a, const IntrusivePtr& b) { return a.object_ != b.object_; }
+
+private:
+    T* object_ = nullptr;
+};
+
+template <typename T, typename... Args>
+IntrusivePtr<T> makeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+/**
+ * Bump allocator reclaimed a generation at a time
+ *
+ * For data that dies together, such as the strings and embeddings of one
+ * ingest batch: allocation is a pointer bump and nothing is freed on its
+ * own. advance() seals the current generation; retire(g) then reclaims
+ * every chunk filled during sealed generations up to g, keeping them for
+ * reuse instead of returning them to the system. Also a pmr resource, so
+ * pmr containers can live in it. Not thread-safe.
+ */
+class GenerationArena : public std::pmr::memory_resource {
+public:
+    explicit GenerationArena(size_t chunkBytes = 256 * 1024);
+    ~GenerationArena() override;
+
+    GenerationArena(const GenerationArena&) = delete;
+    GenerationArena& operator=(const GenerationArena&) = delete;
+
+    uint64_t getGeneration() const { return generation_; }
+
+    /**
+     * Seals the current generation and returns its number
+     */
+    uint64_t advance();
+
+    /**
+     * Reclaims sealed generations up to and including generation; the open
+     * generation is never reclaimed
+     */
+    void retire(uint64_t generation);
+
+    std::string_view copy(std::string_view text);
+
+    template <typename T>
+    T* copy(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>, "arena copies are raw bytes");
+        T* target = static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+        std::copy(data, data + count, target);
+        return target;
+    }
+
+    size_t getReservedBytes() const { return reservedBytes_; }
+    size_t getUsedBytes() const;
+
+private:
+    struct Chunk {
+        char* data;
+        size_t size;
+        size_t used;
+        uint64_t generation;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    void openChunk(size_t minimum);
+    void releaseChunk(const Chunk& chunk);
+
+    size_t chunkBytes_;
+    uint64_t generation_ = 0;
+    std::deque<Chunk> chunks_;          // Oldest first; back() is being filled
+    std::vector<Chunk> spare_;
+    size_t reservedBytes_ = 0;
+};
+
+} // namespace elizaos
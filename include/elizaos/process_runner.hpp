@@ -0,0 +1,92 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace elizaos {
+
+enum class ProcessStream : uint8_t {
+    STDOUT,
+    STDERR
+};
+
+struct ProcessResult {
+    bool spawned = false;
+    int exitCode = -1;                  // Exit status, or -1 when killed or not spawned
+    int signal = 0;                     // Terminating signal, if any
+    bool timedOut = false;
+    std::string output;                 // Tail of stdout
+    std::string error;                  // Tail of stderr, or why the command did not run
+    size_t outputBytes = 0;             // Totals produced, including dropped bytes
+    size_t errorBytes = 0;
+    std::chrono::milliseconds duration{0};
+
+    bool succeeded() const { return spawned && exitCode == 0 && !timedOut; }
+    bool truncated() const { return outputBytes > output.size() || errorBytes > error.size(); }
+};
+
+/**
+ * Per-command limits and callbacks
+ *
+ * Callbacks run on the runner's I/O thread and must not block; onOutput
+ * sees every byte even when the captured output is truncated, and
+ * onComplete runs before the command's future is ready.
+ */
+struct ProcessOptions {
+    std::string workingDirectory;                   // Empty inherits the runner's
+    std::chrono::milliseconds timeout{0};           // Zero waits indefinitely
+    std::chrono::milliseconds killGrace{500};       // SIGTERM to SIGKILL on timeout
+    size_t maxOutputBytes = 1 << 20;                // Per stream; the last bytes are kept
+    std::function<void(ProcessStream, std::string_view)> onOutput;
+    std::function<void(const ProcessResult&)> onComplete;
+};
+
+/**
+ * Runs child processes without blocking the caller
+ *
+ * Commands are started with posix_spawn in their own process group, with
+ * stdin on /dev/null and stdout/stderr on pipes that a single I/O thread
+ * multiplexes with epoll (poll elsewhere). At most maxConcurrent commands
+ * run at once and the rest wait in submission order. A command past its
+ * deadline has its whole group sent SIGTERM, then SIGKILL after killGrace
+ * or as soon as the group leader exits, whichever comes first, so shells
+ * and their children stop together. Output is captured into a
+ * ring of maxOutputBytes per stream, keeping the end of long output. A
+ * command completes when its process exits; what it wrote is drained from
+ * the pipes then, and anything background children write later is lost.
+ */
+class ProcessRunner {
+public:
+    explicit ProcessRunner(size_t maxConcurrent = 4);
+
+    /**
+     * Kills running commands and fails queued ones
+     */
+    ~ProcessRunner();
+
+    ProcessRunner(const ProcessRunner&) = delete;
+    ProcessRunner& operator=(const ProcessRunner&) = delete;
+
+    std::future<ProcessResult> run(std::vector<std::string> argv, ProcessOptions options = {});
+
+    /**
+     * Runs command with /bin/sh -c
+     */
+    std::future<ProcessResult> runShell(const std::string& command, ProcessOptions options = {});
+
+    size_t runningCount() const;
+    size_t queuedCount() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace elizaos
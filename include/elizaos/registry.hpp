@@ -2,6 +2,7 @@
 
 #include "elizaos/core.hpp"
 #include "elizaos/plugins_automation.hpp"
+#include "elizaos/executor.hpp"
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -88,6 +89,9 @@ private:
     std::string downloadRegistryData(const std::string& url) const;
     std::string expandPath(const std::string& path) const;
     void updateLastRefreshTime();
+
+    // Pending refreshRegistry() calls
+    TaskScope tasks_;
 };
 
 // Global registry instance access
@@ -0,0 +1,162 @@
+#pragma once
+
+#include "elizaos/metrics.hpp"
+#include "elizaos/snapshot.hpp"
+#include "elizaos/virtual_clock.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace elizaos {
+
+class TaskManager;
+
+/**
+ * Kinds of external input captured in a trace
+ */
+enum class TraceEventKind : uint8_t {
+    MESSAGE = 1,        // Message sent into a CommChannel; stream is the channel id
+    TASK = 2,           // Task created in a TaskManager; stream is the room id
+    MEMORY_WRITE = 3,   // Memory created in an AgentMemoryManager; stream is the table
+    CUSTOM = 4          // Application-defined input
+};
+
+/**
+ * One recorded input
+ */
+struct TraceEvent {
+    TraceEventKind kind = TraceEventKind::CUSTOM;
+    std::string stream;
+    std::chrono::system_clock::time_point time;
+    std::string payload;            // Encoded with SnapshotWriter by the recording site
+};
+
+/**
+ * Appends the external inputs an agent receives to a compact binary trace
+ *
+ * While recording, the recorder is the process-wide active one: the input
+ * sites (CommChannel::sendMessage, TaskManager::createTask,
+ * AgentMemoryManager::createMemory) check isActive() and log what they
+ * accept. Uuids are drawn from generators derived from the trace seed, so
+ * a replay driving the same inputs from one thread reproduces the ids.
+ *
+ * stop() appends a digest of every component added with addComponent, which
+ * the replayer compares against the state it reaches.
+ */
+class TraceRecorder {
+public:
+    TraceRecorder() = default;
+    ~TraceRecorder();
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * Fails when another recorder is active or path cannot be written
+     */
+    bool start(const std::string& path, uint64_t seed, std::string* error = nullptr);
+    bool stop(std::string* error = nullptr);
+    bool isRecording() const { return recording_; }
+
+    /**
+     * Component whose final state is digested at stop(); not owned
+     */
+    void addComponent(const Snapshottable& component);
+
+    void record(TraceEventKind kind, std::string_view stream, std::string_view payload);
+
+    /**
+     * Pushes buffered events to the file, so they survive a crash
+     */
+    void flush();
+    size_t getEventCount() const;
+
+    static bool isActive() { return active_.load(std::memory_order_acquire) != nullptr; }
+
+    /**
+     * Records into the active recorder, if any; safe against a concurrent stop()
+     */
+    static void recordActive(TraceEventKind kind, std::string_view stream, std::string_view payload);
+
+private:
+    static std::atomic<TraceRecorder*> active_;
+    static std::atomic<int> inFlight_;          // recordActive calls past the active check
+
+    mutable std::mutex mutex_;
+    std::ofstream out_;
+    std::string path_;
+    bool recording_ = false;
+    size_t eventCount_ = 0;
+    int64_t lastNanos_ = 0;                     // Event times are delta encoded
+    std::vector<const Snapshottable*> components_;
+};
+
+/**
+ * How a trace is re-driven
+ *
+ * speed scales the recorded gaps between inputs (2.0 replays twice as
+ * fast); asFastAsPossible drops the gaps entirely.
+ */
+struct ReplayOptions {
+    double speed = 1.0;
+    bool asFastAsPossible = false;
+};
+
+/**
+ * Outcome of a replay
+ */
+struct ReplayReport {
+    size_t eventCount = 0;
+    size_t unhandledCount = 0;              // Events of a kind with no handler
+    double recordedSeconds = 0.0;           // From the first to the last input
+    double wallSeconds = 0.0;
+    double eventsPerSecond = 0.0;
+    HistogramSnapshot latency;              // Handler time per event, nanoseconds
+    bool complete = false;                  // The trace was stopped cleanly
+    std::vector<std::string> divergedComponents;
+    std::vector<std::string> missingComponents;     // Digested in the trace, not registered here
+};
+
+using ReplayHandler = std::function<void(const TraceEvent&)>;
+
+/**
+ * Re-drives a recorded trace through registered handlers
+ *
+ * The whole trace is decoded before the first handler runs. During the run
+ * the VirtualClock is pinned to each input's recorded time and Uuids come
+ * from the trace seed; both are released afterwards. Handlers run on the
+ * calling thread in recorded order.
+ */
+class TraceReplayer {
+public:
+    /**
+     * Every handler added for a kind sees each event of that kind
+     */
+    void addHandler(TraceEventKind kind, ReplayHandler handler);
+
+    /**
+     * Component compared against the digest recorded under the same name; not owned
+     */
+    void addComponent(const Snapshottable& component);
+
+    std::optional<ReplayReport> run(const std::string& path, const ReplayOptions& options = {},
+                                    std::string* error = nullptr);
+
+private:
+    std::vector<std::pair<TraceEventKind, ReplayHandler>> handlers_;
+    std::vector<const Snapshottable*> components_;
+};
+
+/**
+ * Re-adds recorded tasks to tasks, under their recorded ids
+ */
+void addTaskReplay(TraceReplayer& replayer, TaskManager& tasks);
+
+} // namespace elizaos
@@ -0,0 +1,293 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace elizaos {
+
+class Memory;
+class HypergraphNode;
+class HypergraphEdge;
+class State;
+class Task;
+
+constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 1;
+
+/**
+ * Append-only encoder for snapshot sections
+ *
+ * Integers are LEB128 varints (signed ones zigzagged), doubles and float
+ * arrays are raw little-endian, strings are length-prefixed.
+ */
+class SnapshotWriter {
+public:
+    void writeU8(uint8_t value) { out_.push_back(static_cast<char>(value)); }
+    void writeBool(bool value) { writeU8(value ? 1 : 0); }
+    void writeVarint(uint64_t value);
+    void writeSigned(int64_t value);
+    void writeDouble(double value);
+    void writeString(std::string_view value);
+    void writeTimestamp(const std::chrono::system_clock::time_point& value);
+    void writeFloats(const std::vector<float>& values);
+    void writeStrings(const std::vector<std::string>& values);
+    void writeStringMap(const std::unordered_map<std::string, std::string>& values);
+
+    /**
+     * Appends bytes produced by another writer, e.g. a part encoded while fenced
+     */
+    void writeRaw(std::string_view bytes) { out_.append(bytes.data(), bytes.size()); }
+
+    const std::string& data() const { return out_; }
+    std::string release() { return std::move(out_); }
+    size_t size() const { return out_.size(); }
+
+private:
+    std::string out_;
+};
+
+/**
+ * Bounds-checked decoder over a snapshot section
+ *
+ * Reading past the end or malformed input makes the reader fail: every
+ * further read returns a zero value, so decoders read straight through and
+ * check ok() once at the end.
+ */
+class SnapshotReader {
+public:
+    explicit SnapshotReader(std::string_view data) : data_(data) {}
+
+    uint8_t readU8();
+    bool readBool() { return readU8() != 0; }
+    uint64_t readVarint();
+    int64_t readSigned();
+    double readDouble();
+    std::string readString();
+    std::chrono::system_clock::time_point readTimestamp();
+    std::vector<float> readFloats();
+    std::vector<std::string> readStrings();
+    std::unordered_map<std::string, std::string> readStringMap();
+
+    /**
+     * Element count of a following sequence; fails when it cannot fit in the
+     * remaining bytes, so corrupt counts never drive huge allocations
+     */
+    size_t readCount(size_t minElementBytes = 1);
+
+    bool ok() const { return !failed_; }
+    bool atEnd() const { return pos_ == data_.size(); }
+    size_t remaining() const { return data_.size() - pos_; }
+    void fail() { failed_ = true; }
+
+private:
+    std::string_view data_;
+    size_t pos_ = 0;
+    bool failed_ = false;
+};
+
+// Codecs for the shared record types
+void writeMemory(SnapshotWriter& writer, const Memory& memory);
+std::shared_ptr<Memory> readMemory(SnapshotReader& reader);
+void writeHypergraphNode(SnapshotWriter& writer, const HypergraphNode& node);
+std::shared_ptr<HypergraphNode> readHypergraphNode(SnapshotReader& reader);
+void writeHypergraphEdge(SnapshotWriter& writer, const HypergraphEdge& edge);
+std::shared_ptr<HypergraphEdge> readHypergraphEdge(SnapshotReader& reader);
+void writeTask(SnapshotWriter& writer, const Task& task);
+std::shared_ptr<Task> readTask(SnapshotReader& reader);
+
+/**
+ * Frozen copy of a component's state that encodes itself; runs after the
+ * fence is lifted, so it must only touch data it owns
+ */
+using SnapshotImage = std::function<void(SnapshotWriter&)>;
+
+/**
+ * Installs state decoded from a section; cannot fail. Empty when the section
+ * was malformed.
+ */
+using SnapshotCommit = std::function<void()>;
+
+/**
+ * A component whose state is captured in agent snapshots
+ *
+ * Saving fences every registered component at once, freezes each one and
+ * lifts the fences before any encoding starts. freezeSnapshot therefore
+ * only copies what it needs cheaply (tables of shared_ptr, plain values)
+ * into the image. Objects that can be mutated in place, such as Memory,
+ * are copied while fenced.
+ *
+ * Restoring decodes every section before committing any, so a malformed
+ * section leaves all components as they were.
+ */
+class Snapshottable {
+public:
+    virtual ~Snapshottable() = default;
+
+    /**
+     * Section name, unique among the components of one manager
+     */
+    virtual std::string getSnapshotName() const = 0;
+
+    /**
+     * Layout version of the section; restore is refused for newer versions
+     */
+    virtual uint32_t getSnapshotVersion() const { return 1; }
+
+    /**
+     * Blocks mutation of the component until the returned lock is released
+     */
+    virtual std::unique_lock<std::mutex> fenceSnapshot() const = 0;
+
+    /**
+     * Called while fenced
+     */
+    virtual SnapshotImage freezeSnapshot() const = 0;
+
+    /**
+     * Decodes a section without touching the component; the returned commit
+     * replaces the component's state. Empty when the section is malformed.
+     */
+    virtual SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) = 0;
+
+    /**
+     * Decodes and commits one section; false leaves the component untouched
+     */
+    bool restoreSnapshot(SnapshotReader& reader, uint32_t version) {
+        SnapshotCommit commit = decodeSnapshot(reader, version);
+        if (!commit) return false;
+        commit();
+        return true;
+    }
+};
+
+/**
+ * CRC-32 of the component's encoded state, taken under its fence; equal
+ * states built by the same sequence of operations have equal digests
+ */
+uint32_t snapshotDigest(const Snapshottable& component);
+
+/**
+ * Snapshot support for a State owned elsewhere
+ *
+ * State publishes immutable versions, so it is frozen without a lock. guard,
+ * when given, is a lock its owner holds to keep the State in step with
+ * other components; save and restore take it like any other fence.
+ */
+class StateSnapshot : public Snapshottable {
+public:
+    explicit StateSnapshot(State& state, std::mutex* guard = nullptr, std::string name = "state")
+        : state_(state), guard_(guard), name_(std::move(name)) {}
+
+    std::string getSnapshotName() const override { return name_; }
+    std::unique_lock<std::mutex> fenceSnapshot() const override;
+    SnapshotImage freezeSnapshot() const override;
+    SnapshotCommit decodeSnapshot(SnapshotReader& reader, uint32_t version) override;
+
+private:
+    State& state_;
+    std::mutex* guard_;
+    std::string name_;
+};
+
+/**
+ * Read-only view of a snapshot file
+ *
+ * The file is memory-mapped, so opening only reads the header and section
+ * table; a section's pages are faulted in when it is read, which is also
+ * when its checksum is verified.
+ */
+class SnapshotFile {
+public:
+    struct Section {
+        std::string name;
+        uint32_t version = 0;
+        uint64_t offset = 0;
+        uint64_t length = 0;
+        uint32_t checksum = 0;
+    };
+
+    ~SnapshotFile();
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    /**
+     * Null when the file is missing or its header or table is damaged
+     */
+    static std::unique_ptr<SnapshotFile> open(const std::string& path, std::string* error = nullptr);
+
+    uint64_t getEpoch() const { return epoch_; }
+    std::chrono::system_clock::time_point getCreatedAt() const { return createdAt_; }
+    const std::vector<Section>& getSections() const { return sections_; }
+    const Section* findSection(std::string_view name) const;
+
+    /**
+     * Section payload after verifying its checksum; nullopt on a mismatch
+     */
+    std::optional<std::string_view> readSection(const Section& section) const;
+
+private:
+    SnapshotFile() = default;
+
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::string buffer_;                // Contents when mapping is unavailable
+    uint64_t epoch_ = 0;
+    std::chrono::system_clock::time_point createdAt_;
+    std::vector<Section> sections_;
+};
+
+/**
+ * Consistent whole-agent snapshots
+ *
+ * save() fences all registered components together, freezes them and
+ * releases them before encoding, so the agent only pauses for the copies.
+ * Sections are encoded in parallel on the shared executor and written to a
+ * temporary file, which is synced before it replaces path and the directory
+ * is synced after. The container holds a header, the sections 8-byte
+ * aligned, a section table with a CRC-32 per section, and a footer locating
+ * the table.
+ *
+ * restore() maps the file, then verifies and decodes each section it uses
+ * in parallel, straight from the mapping. Components are committed only
+ * once every section has decoded, so a restore applies entirely or not at
+ * all. Components without a section in the file are left as they are;
+ * sections without a component are ignored.
+ */
+class SnapshotManager {
+public:
+    SnapshotManager() = default;
+    SnapshotManager(const SnapshotManager&) = delete;
+    SnapshotManager& operator=(const SnapshotManager&) = delete;
+
+    /**
+     * Replaces any component with the same name; the reference overload does
+     * not take ownership
+     */
+    void registerComponent(std::shared_ptr<Snapshottable> component);
+    void registerComponent(Snapshottable& component);
+    bool unregisterComponent(const std::string& name);
+    std::vector<std::string> getComponentNames() const;
+
+    bool save(const std::string& path, std::string* error = nullptr);
+    bool restore(const std::string& path, std::string* error = nullptr);
+
+    /**
+     * Number of the last snapshot saved or restored
+     */
+    uint64_t getEpoch() const;
+
+private:
+    mutable std::mutex mutex_;          // Serializes saves, restores and registration
+    std::vector<std::shared_ptr<Snapshottable>> components_;
+    uint64_t epoch_ = 0;
+};
+
+} // namespace elizaos
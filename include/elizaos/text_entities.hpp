@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace elizaos {
+
+enum class TextEntityType : uint8_t {
+    URL,                // scheme://... for http(s), ftp and ws(s), or www.host
+    EMAIL,
+    PHONE,              // 10-15 digits, or 8-15 after a leading +
+    MENTION,            // @name not preceded by a word character
+    HASHTAG,            // #tag with at least one letter
+    CRYPTO_ADDRESS      // 0x + 40 hex, bech32 bc1/tb1, base58 starting with 1 or 3
+};
+
+constexpr uint32_t textEntityBit(TextEntityType type) {
+    return 1u << static_cast<uint32_t>(type);
+}
+
+constexpr uint32_t ALL_TEXT_ENTITIES = (1u << 6) - 1;
+
+/**
+ * Entity found in scanned text, as [start, end) byte offsets into it
+ */
+struct TextEntity {
+    TextEntityType type = TextEntityType::URL;
+    size_t start = 0;
+    size_t end = 0;
+
+    std::string_view in(std::string_view source) const { return source.substr(start, end - start); }
+};
+
+/**
+ * Finds URLs, emails, phone numbers, mentions, hashtags and crypto
+ * addresses in one left-to-right pass
+ *
+ * Candidate positions (':', '@', '#', '+', '(', '.' and digits) are located
+ * sixteen bytes at a time with SSE2 or NEON, or a byte table elsewhere, and
+ * each candidate is confirmed by a small validator for the types it can
+ * start. Entities never overlap and are appended in order of their start.
+ * Trailing sentence punctuation is not part of a URL.
+ */
+void scanTextEntities(std::string_view text, std::vector<TextEntity>& entities,
+                      uint32_t types = ALL_TEXT_ENTITIES);
+std::vector<TextEntity> scanTextEntities(std::string_view text, uint32_t types = ALL_TEXT_ENTITIES);
+
+/**
+ * Views into text of every entity of one type
+ */
+std::vector<std::string_view> extractTextEntities(std::string_view text, TextEntityType type);
+
+/**
+ * Host of an absolute http(s), ftp or ws(s) URL without user info or port;
+ * empty when url is not one
+ */
+std::string_view urlHost(std::string_view url);
+
+/**
+ * Whole string is one http(s) URL with a host and no whitespace
+ */
+bool isHttpUrl(std::string_view url);
+
+const char* textEntityTypeName(TextEntityType type);
+
+/**
+ * "sse2", "neon" or "scalar"
+ */
+const char* textEntityScanKernel();
+
+} // namespace elizaos
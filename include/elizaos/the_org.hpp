@@ -1,12 +1,12 @@
 #pragma once
 
 #include "core.hpp"
+#include "executor.hpp"
 #include <string>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 #include <functional>
-#include <thread>
 #include <atomic>
 #include <chrono>
 #include <optional>
@@ -310,7 +310,9 @@ protected:
     mutable std::mutex settingsMutex_;
     
     // Internal helper methods
-    virtual void processLoop() = 0;
+    // One round of the agent's periodic work; each agent runs it on its
+    // ticker_, declared last so it stops before the agent's state goes
+    virtual void processTick() = 0;
     virtual bool validateMessage(const std::string& message) const;
     virtual std::string formatResponse(const std::string& response, PlatformType platform) const;
 };
@@ -360,7 +362,7 @@ public:
     void trackEventParticipation(const std::string& eventId, const std::string& userId);
 
 private:
-    void processLoop() override;
+    void processTick() override;
     void processNewUserJoin(const std::string& userId, const std::string& serverId);
     void processMessageForModeration(const std::string& message, const std::string& userId, const std::string& channelId);
     void generateDailyReport();
@@ -373,11 +375,12 @@ private:
     std::vector<ModerationEvent> moderationHistory_;
     CommunityMetrics currentMetrics_;
     std::unordered_map<std::string, std::vector<Timestamp>> userActivity_;
-    std::thread processingThread_;
     
     mutable std::mutex rulesMutex_;
     mutable std::mutex metricsMutex_;
     mutable std::mutex activityMutex_;
+    
+    PeriodicTask ticker_;
 };
 
 /**
@@ -429,7 +432,7 @@ public:
     void shareWeeklyTechUpdates(const std::vector<std::string>& channelIds);
 
 private:
-    void processLoop() override;
+    void processTick() override;
     void processQuestion(const std::string& question, const std::string& userId, const std::string& channelId);
     void updateTechnicalKnowledge();
     std::string formatCodeForPlatform(const std::string& code, PlatformType platform) const;
@@ -455,11 +458,12 @@ private:
     std::vector<DocumentationEntry> documentationIndex_;
     std::unordered_map<std::string, KnowledgeEntry> knowledgeBase_;
     std::unordered_map<UUID, std::vector<std::string>> developerProgress_;
-    std::thread processingThread_;
     
     mutable std::mutex docMutex_;
     mutable std::mutex knowledgeMutex_;
     mutable std::mutex progressMutex_;
+    
+    PeriodicTask ticker_;
 };
 
 /**
@@ -512,7 +516,7 @@ public:
     double calculateOrganizationSimilarity(const UUID& org1Id, const UUID& org2Id) const;
 
 private:
-    void processLoop() override;
+    void processTick() override;
     void monitorOrganizations();
     void analyzeCrossOrgPatterns();
     void generatePeriodicReports();
@@ -542,11 +546,12 @@ private:
     std::vector<DiscussionEntry> discussionHistory_;
     std::vector<TopicTrend> topicTrends_;
     std::unordered_map<std::string, std::unordered_map<UUID, double>> topicOrgRelevance_;
-    std::thread processingThread_;
     
     mutable std::mutex orgMutex_;
     mutable std::mutex discussionMutex_;
     mutable std::mutex trendMutex_;
+    
+    PeriodicTask ticker_;
 };
 
 /**
@@ -611,7 +616,7 @@ public:
     void assessProjectRisk(const UUID& projectId);
 
 private:
-    void processLoop() override;
+    void processTick() override;
     void sendDailyCheckins();
     void processCheckinResponses();
     void generateAutomaticReports();
@@ -645,13 +650,14 @@ private:
     std::vector<Blocker> blockers_;
     std::unordered_map<UUID, ProjectMetrics> projectMetrics_;
     std::unordered_map<UUID, std::vector<std::pair<UUID, std::chrono::minutes>>> workHours_; // teamMemberId -> [(projectId, hours)]
-    std::thread processingThread_;
     
     mutable std::mutex projectMutex_;
     mutable std::mutex teamMutex_;
     mutable std::mutex updateMutex_;
     mutable std::mutex blockerMutex_;
     mutable std::mutex metricsMutex_;
+    
+    PeriodicTask ticker_;
 };
 
 /**
@@ -729,7 +735,7 @@ public:
     std::string analyzeCampaignPerformance(const UUID& campaignId) const;
 
 private:
-    void processLoop() override;
+    void processTick() override;
     void publishScheduledContent();
     void monitorEngagement();
     void updateMetrics();
@@ -762,12 +768,13 @@ private:
     std::vector<ContentTemplate> templates_;
     std::unordered_map<PlatformType, SocialMediaMetrics> platformMetrics_;
     std::unordered_map<PlatformType, std::vector<std::string>> postingSchedules_;
-    std::thread processingThread_;
     
     mutable std::mutex contentMutex_;
     mutable std::mutex campaignMutex_;
     mutable std::mutex metricsMutex_;
     mutable std::mutex scheduleMutex_;
+    
+    PeriodicTask ticker_;
 };
 
 /**
@@ -842,7 +849,7 @@ public:
     void setLogLevel(const std::string& level);
 
 private:
-    void coordinationLoop();
+    void coordinationTick();
     void processInterAgentMessages();
     void monitorAgentHealth();
     void executeScheduledTasks();
@@ -872,7 +879,6 @@ private:
     std::unordered_map<std::string, std::string> globalSettings_;
     
     std::atomic<bool> running_{false};
-    std::thread coordinationThread_;
     SystemMetrics currentMetrics_;
     
     mutable std::mutex agentMutex_;
@@ -888,6 +894,8 @@ private:
     std::string logLevel_ = "INFO";
     std::vector<std::string> eventLog_;
     mutable std::mutex logMutex_;
+    
+    PeriodicTask coordinator_;
 };
 
 // Utility functions for the_org system
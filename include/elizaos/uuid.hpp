@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace elizaos {
+
+/**
+ * 128-bit RFC 4122 / RFC 9562 UUID held by value
+ *
+ * The two words hold the bytes in network order, so comparing (hi, lo)
+ * matches comparing the canonical lowercase strings; v7 ids therefore sort
+ * by creation time in either form. Converts implicitly to the canonical
+ * string so it can be passed wherever a UUID string is expected.
+ */
+class Uuid {
+public:
+    static constexpr size_t STRING_LENGTH = 36;
+
+    constexpr Uuid() = default;
+    constexpr Uuid(uint64_t hi, uint64_t lo) : hi_(hi), lo_(lo) {}
+
+    /**
+     * Random UUID. Draws from a per-thread generator, so it never locks.
+     */
+    static Uuid v4();
+
+    /**
+     * Unix-millisecond timestamp followed by random bits. Ids created on the
+     * same thread are strictly increasing; across threads they are ordered
+     * to the millisecond.
+     */
+    static Uuid v7();
+
+    /**
+     * Makes v4 and v7 draw from per-thread generators derived from seed, the
+     * first thread to draw using seed itself, so a run re-driven with the
+     * same inputs reproduces its ids. nullopt returns to the randomly seeded
+     * per-thread generators.
+     */
+    static void seedRandom(std::optional<uint64_t> seed);
+
+    static constexpr Uuid nil() { return Uuid(); }
+
+    /**
+     * Accepts the canonical 8-4-4-4-12 form in either case. Does not allocate.
+     */
+    static bool tryParse(std::string_view text, Uuid& out);
+    static std::optional<Uuid> parse(std::string_view text);
+
+    /**
+     * Writes the 36 canonical lowercase characters to out, without a
+     * terminator
+     */
+    void toChars(char* out) const;
+    std::string toString() const;
+    operator std::string() const { return toString(); }
+
+    uint64_t getHigh() const { return hi_; }
+    uint64_t getLow() const { return lo_; }
+    int getVersion() const { return static_cast<int>((hi_ >> 12) & 0xF); }
+    bool isNil() const { return hi_ == 0 && lo_ == 0; }
+
+    /**
+     * Creation time of a v7 id in Unix milliseconds; 0 for other versions
+     */
+    uint64_t getTimestampMillis() const { return getVersion() == 7 ? hi_ >> 16 : 0; }
+
+    size_t hash() const {
+        // v4 bits are uniformly random already; the multiply spreads the
+        // timestamp-heavy high word of v7 ids across the low bits
+        uint64_t h = lo_ ^ (hi_ * 0x9E3779B97F4A7C15ULL);
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    friend bool operator==(const Uuid& a, const Uuid& b) { return a.hi_ == b.hi_ && a.lo_ == b.lo_; }
+    friend bool operator!=(const Uuid& a, const Uuid& b) { return !(a == b); }
+    friend bool operator<(const Uuid& a, const Uuid& b) { return a.hi_ < b.hi_ || (a.hi_ == b.hi_ && a.lo_ < b.lo_); }
+    friend bool operator>(const Uuid& a, const Uuid& b) { return b < a; }
+    friend bool operator<=(const Uuid& a, const Uuid& b) { return !(b < a); }
+    friend bool operator>=(const Uuid& a, const Uuid& b) { return !(a < b); }
+
+private:
+    uint64_t hi_ = 0;
+    uint64_t lo_ = 0;
+};
+
+std::ostream& operator<<(std::ostream& os, const Uuid& uuid);
+
+/**
+ * Map key for ids that are usually, but not always, canonical UUIDs
+ *
+ * Canonical lowercase UUID text is held as a Uuid, so hashing and comparing
+ * it touch two words instead of 36 characters; any other text, such as
+ * "test-memory-1" or an upper-case UUID, is kept verbatim. Two keys are
+ * equal exactly when their texts are. Converts implicitly from id strings,
+ * so containers keyed by it accept the usual UUID strings.
+ */
+class IdKey {
+public:
+    IdKey(std::string_view text);
+    IdKey(const std::string& text) : IdKey(std::string_view(text)) {}
+    IdKey(const char* text) : IdKey(std::string_view(text)) {}
+    IdKey(const Uuid& uuid) : uuid_(uuid), isUuid_(true) {}
+
+    bool isUuid() const { return isUuid_; }
+    const Uuid& getUuid() const { return uuid_; }     // Nil unless isUuid()
+    std::string toString() const { return isUuid_ ? uuid_.toString() : text_; }
+
+    size_t hash() const { return isUuid_ ? uuid_.hash() : std::hash<std::string>()(text_); }
+
+    friend bool operator==(const IdKey& a, const IdKey& b) {
+        return a.isUuid_ == b.isUuid_ && (a.isUuid_ ? a.uuid_ == b.uuid_ : a.text_ == b.text_);
+    }
+    friend bool operator!=(const IdKey& a, const IdKey& b) { return !(a == b); }
+
+private:
+    Uuid uuid_;
+    std::string text_;
+    bool isUuid_ = false;
+};
+
+} // namespace elizaos
+
+namespace std {
+
+template <>
+struct hash<elizaos::Uuid> {
+    size_t operator()(const elizaos::Uuid& uuid) const noexcept { return uuid.hash(); }
+};
+
+template <>
+struct hash<elizaos::IdKey> {
+    size_t operator()(const elizaos::IdKey& key) const noexcept { return key.hash(); }
+};
+
+} // namespace std
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace elizaos {
+
+/**
+ * Wall clock for timestamps on agent data
+ *
+ * Reads the system clock until a replay pins it. While pinned it reads the
+ * time of the input being re-driven, so objects created by that input carry
+ * its recorded time.
+ */
+class VirtualClock {
+public:
+    static std::chrono::system_clock::time_point now() {
+        int64_t pinned = pinned_.load(std::memory_order_acquire);
+        if (pinned == UNPINNED) return std::chrono::system_clock::now();
+        return std::chrono::system_clock::time_point(std::chrono::system_clock::duration(pinned));
+    }
+
+    static void pin(const std::chrono::system_clock::time_point& time) {
+        pinned_.store(time.time_since_epoch().count(), std::memory_order_release);
+    }
+
+    static void unpin() { pinned_.store(UNPINNED, std::memory_order_release); }
+    static bool isPinned() { return pinned_.load(std::memory_order_acquire) != UNPINNED; }
+
+private:
+    static constexpr int64_t UNPINNED = INT64_MIN;
+    static std::atomic<int64_t> pinned_;
+};
+
+} // namespace elizaos
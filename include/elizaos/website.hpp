@@ -6,6 +6,8 @@
 #include <vector>
 #include <filesystem>
 #include <functional>
+#include <chrono>
+#include <mutex>
 
 namespace elizaos {
 
@@ -17,6 +19,8 @@ namespace elizaos {
 class ContentManager;
 class TemplateEngine;
 class StaticSiteGenerator;
+class FileWatcher;
+class DevServer;
 
 /**
  * Represents a website page with metadata and content
@@ -50,6 +54,7 @@ struct WebsiteConfig {
     std::string site_title;
     std::string site_description;
     std::unordered_map<std::string, std::string> global_vars;
+    std::chrono::milliseconds watch_coalesce_window{20};  // Quiet period before an incremental rebuild
     
     WebsiteConfig() 
         : source_dir("./src"), 
@@ -108,6 +113,9 @@ public:
     
     // Content operations
     bool loadPagesFromDirectory(const std::filesystem::path& directory);
+    std::shared_ptr<WebPage> loadPageFromFile(const std::filesystem::path& file_path);
+    std::string removePageBySource(const std::filesystem::path& source_path);
+    bool isContentFile(const std::filesystem::path& file_path) const;
     bool savePage(const WebPage& page, const std::filesystem::path& output_path) const;
     
     // Metadata operations
@@ -188,7 +196,14 @@ public:
     // Site generation
     bool generateSite();
     bool serveDevelopmentSite(int port = 8080);
+    void stopDevelopmentSite();
     bool watchForChanges(bool enable = true);
+    bool isWatching() const { return watching_; }
+    int getDevelopmentPort() const;
+    
+    // Incremental rebuild of the given source, template or asset paths; a
+    // watched root directory itself, reported when events were lost, rebuilds everything
+    size_t rebuildChangedFiles(const std::vector<std::filesystem::path>& changed);
     
     // Content management
     std::shared_ptr<ContentManager> getContentManager() const { return content_manager_; }
@@ -207,11 +222,15 @@ private:
     std::shared_ptr<ContentManager> content_manager_;
     std::shared_ptr<TemplateEngine> template_engine_;
     std::shared_ptr<StaticSiteGenerator> generator_;
+    std::unique_ptr<FileWatcher> watcher_;
+    std::unique_ptr<DevServer> dev_server_;
+    mutable std::mutex build_mutex_;
     bool initialized_ = false;
     bool watching_ = false;
     
     bool setupDirectories();
     bool loadDefaultTemplates();
+    static bool isWithin(const std::filesystem::path& path, const std::filesystem::path& directory);
 };
 
 } // namespace elizaos
\ No newline at end of file
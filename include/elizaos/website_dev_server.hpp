@@ -0,0 +1,53 @@
+#pragma once
+
+#include "elizaos/file_watcher.hpp"
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace elizaos {
+
+/**
+ * Development HTTP server for generated sites
+ *
+ * Single-threaded epoll server that serves files from a root directory with
+ * sendfile(2). HTML responses get a small live-reload script appended which
+ * subscribes to a server-sent event stream; notifyReload() pushes a reload
+ * to every connected browser.
+ */
+class DevServer {
+public:
+    static constexpr const char* LIVE_RELOAD_PATH = "/__elizaos/livereload";
+
+    explicit DevServer(const std::filesystem::path& root_dir);
+    ~DevServer();
+
+    DevServer(const DevServer&) = delete;
+    DevServer& operator=(const DevServer&) = delete;
+
+    /**
+     * Bind and start serving. Port 0 binds an ephemeral port.
+     */
+    bool start(int port = 8080, const std::string& bind_address = "127.0.0.1");
+    void stop();
+
+    bool isRunning() const;
+    int getPort() const;
+
+    /**
+     * Ask all connected browsers to reload
+     */
+    void notifyReload();
+    size_t getReloadClientCount() const;
+    size_t getRequestsServed() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+} // namespace elizaos